@@ -3,6 +3,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
+
+#include "nexus/core/Message.h"
+#include "nexus/utils/ThreadPlacement.h"
 
 namespace Nexus {
 namespace rpc {
@@ -15,8 +19,19 @@ struct Config {
     struct NodeConfig {
         size_t max_inbound_queues = 32;     // Maximum inbound queues per node
         size_t queue_capacity = 1024;       // Messages per queue - increased from 256
-        size_t num_processing_threads = 4;  // Thread pool size
-        size_t max_queue_size = 25000;      // Max messages per async queue
+        size_t num_processing_threads = 4;  // Dispatch workers per node (1-64, fixed at node creation)
+        size_t max_queue_size = 25000;      // Max pending messages of all subscribed topics (node-wide)
+        size_t per_topic_queue_size = 512;  // Ring of each subscribed topic, fixed at subscribe (capped at the above)
+        std::vector<uint64_t> worker_cpu_sets;  // CPU mask per worker (worker i: entry i % size); empty = unpinned
+        int worker_priority = 0;                // SCHED_FIFO priority of workers (1-99); 0 = default scheduling
+        uint32_t block_timeout_ms = 100;        // QueueOverflowPolicy::BLOCK: max wait for queue space
+        int numa_node = -1;                     // Segments, receive and worker threads bound to this node (-1 = off)
+        std::string discovery_cache;            // File keeping remote services across restarts (empty = off)
+        bool latency_tracing = false;  // Stamp sent DATA frames; keep per-topic latency histograms (getTopicLatency)
+        uint32_t metrics_interval_ms = 0;  // Refresh period of the shared memory metrics segment (0 = off)
+        uint32_t watermark_high_percent = 80;  // Node::setWatermarkCallback: "high" at this fill
+        uint32_t watermark_low_percent = 50;   // ... and "low" again at this fill or below
+        uint32_t watermark_poll_ms = 10;       // Sampling period of shared memory and large data rings
     } node;
 
     // Transport layer configuration
@@ -24,23 +39,73 @@ struct Config {
         bool enable_udp = true;          // Enable UDP transport
         uint16_t udp_port_base = 47200;  // UDP port range start
         uint16_t udp_port_max = 47999;   // UDP port range end
+        ChecksumType udp_checksum = ChecksumType::CRC32C;  // DATA packets sent over UDP (SUM: pre-v2 peers)
+        size_t udp_compress_threshold = 0;  // LZ4-compress UDP datagrams of at least this size (0 = off)
+        uint32_t udp_receive_threads = 1;   // Receive sockets/threads sharing the node's port (SO_REUSEPORT, 1-16)
+        std::vector<uint64_t> udp_receive_cpu_sets;  // CPU mask per receive thread (steers datagrams by RX CPU)
+        bool udp_segmentation_offload = true;  // UDP_SEGMENT/UDP_GRO where the kernel has them (batched sends)
+        bool udp_io_uring = false;          // Receive through io_uring (Linux; socket loop where unavailable)
+        bool udp_multicast = false;         // UDP subscriptions join a multicast group; publishers send once
+        std::string udp_multicast_base = "239.255.73.0";  // First group; topics hash into the next buckets
+        uint32_t udp_multicast_buckets = 64;              // Groups topics are hashed into (1-65536)
+        uint16_t udp_multicast_port = 47100;              // Port shared by every node's multicast socket
+        uint8_t udp_multicast_ttl = 1;                    // Router hops (1 = local subnet only)
+        // Reliable UDP (Node::setTopicReliable)
+        size_t udp_reliable_fragment = 1200;         // Payload bytes per fragment (datagrams fit a 1500-byte MTU)
+        uint32_t udp_reliable_window = 64;           // Unacknowledged fragments in flight per destination
+        uint32_t udp_reliable_retransmit_ms = 20;    // Resend the oldest unacknowledged fragment after this long
+        uint32_t udp_reliable_timeout_ms = 2000;     // No acknowledgement this long: publish fails, stream restarts
+        size_t udp_reliable_max_message = 64 << 20;  // Largest message a receiver reassembles
     } transport;
 
     // Shared memory configuration
     struct SharedMemoryConfig {
-        size_t queue_capacity = 1024;           // Queue capacity (64-1024) - increased from 256
+        // Data queue capacity in message_size units (64-1024, see validate()). Each sender's queue has three
+        // priority lanes; HIGH and NORMAL get this capacity and BULK half of it (at least 256 KB), so a
+        // sender that fills every lane pins about 2.5 × queue_capacity × message_size of resident memory
+        // in the receiver's segment (1.25 MB at the 512 KB cap). Lower it for nodes with many busy peers.
+        size_t queue_capacity = 1024;
         size_t max_inbound_queues = 64;         // Hard limit (max 64)
         uint32_t heartbeat_interval_ms = 1000;  // 1 second
         uint32_t node_timeout_ms = 5000;        // 5 seconds
         size_t message_size = 2048;             // Max message size in bytes
+        uint32_t receive_threads = 1;           // Receive threads sharding inbound queues (1-8)
+        bool non_blocking_send = false;         // publish() never sleeps; full queues return QUEUE_FULL
+        uint32_t send_timeout_ms = 0;           // Blocking send: max wait for receiver credit (0 = one backoff)
+        ChecksumType checksum = ChecksumType::NONE;  // DATA frames sent over shm (SUM: pre-v2 peers)
+        bool lane_round_robin = false;  // Priority lanes: weighted round-robin instead of strict priority
+        std::vector<uint32_t> lane_weights = {16, 16, 16};  // Round-robin frames per round (HIGH, NORMAL, BULK)
+        uint32_t lane_drop_mask = 0x4;  // Lanes (bit = MessagePriority) that drop instead of waiting for credit
+        bool huge_pages = false;        // Node segments: transparent huge pages (fewer TLB misses)
+        bool prefault = false;          // Node segments: fault all pages in at startup
+        bool lock_memory = false;       // Node segments: mlock (needs RLIMIT_MEMLOCK)
+        // Low-rate senders share one MPSC inbox instead of a queue each. A full inbox applies the frame's
+        // lane overflow policy (lane_drop_mask, non_blocking_send, send_timeout_ms) like a dedicated
+        // queue; slots claimed by a sender that crashed are skipped once its PID is gone.
+        bool shared_inbox = false;
+        uint32_t inbox_promote_rate = 200;  // Frames/s after which an inbox sender gets its own queue
+        size_t topic_bus_size = 1024 * 1024;  // Ring of each Node::setTopicBus() topic (its largest message)
     } shm;
 
     // Large data channel configuration
     struct LargeDataConfig {
         size_t buffer_size = 64 * 1024 * 1024;    // 64MB default
         size_t max_block_size = 8 * 1024 * 1024;  // 8MB max
+        bool huge_pages = false;                  // Ring buffers: transparent huge pages
+        bool prefault = false;                    // Ring buffers: fault all pages in when the channel opens
+        bool lock_memory = false;                 // Ring buffers: mlock (needs RLIMIT_MEMLOCK)
     } large_data;
 
+    // Thread placement per role: CPU mask, scheduling policy and priority, applied as each thread starts
+    struct ThreadsConfig {
+        ThreadPlacement shm_receive;  // Shared memory receive threads (NUMA pinning applies when no mask is set)
+        ThreadPlacement udp_receive;  // UDP receive threads (transport.udp_receive_cpu_sets pins each one first)
+        ThreadPlacement worker;       // Dispatch workers (node.worker_cpu_sets / worker_priority take precedence)
+        ThreadPlacement system;       // System message thread (service and node announcements)
+        ThreadPlacement large_data;   // Large data reader threads (subscribeLargeData, bridgeLargeData)
+        ThreadPlacement maintenance;  // Heartbeat/cleanup scheduler (process-wide), shm connector, call timeouts
+    } threads;
+
     /**
      * @brief Get global configuration instance (singleton)
      */
@@ -53,14 +118,53 @@ struct Config {
      * - NEXUS_MAX_INBOUND_QUEUES
      * - NEXUS_QUEUE_CAPACITY
      * - NEXUS_NUM_THREADS
+     * - NEXUS_MAX_QUEUE_SIZE / NEXUS_PER_TOPIC_QUEUE_SIZE
+     * - NEXUS_WORKER_CPUS (CPU set per worker, ';'-separated, e.g. "0-1;2;3,5")
+     * - NEXUS_WORKER_PRIORITY
+     * - NEXUS_BLOCK_TIMEOUT_MS
+     * - NEXUS_NUMA_NODE (NUMA node for segments and threads; -1 = no binding)
+     * - NEXUS_DISCOVERY_CACHE (path of the warm-restart discovery cache)
      * - NEXUS_HEARTBEAT_INTERVAL_MS
      * - NEXUS_NODE_TIMEOUT_MS
+     * - NEXUS_SHM_RECEIVE_THREADS
+     * - NEXUS_SHM_NON_BLOCKING
+     * - NEXUS_SHM_SEND_TIMEOUT_MS
+     * - NEXUS_SHM_CHECKSUM / NEXUS_UDP_CHECKSUM ("none", "sum" or "crc32c")
+     * - NEXUS_UDP_COMPRESS_THRESHOLD (bytes; 0 = off)
+     * - NEXUS_UDP_RECEIVE_THREADS / NEXUS_UDP_RECEIVE_CPUS (CPU set per receive thread, like NEXUS_WORKER_CPUS)
+     * - NEXUS_UDP_OFFLOAD (0 or 1: UDP_SEGMENT / UDP_GRO segmentation offload)
+     * - NEXUS_UDP_IO_URING (0 or 1: io_uring receive backend)
+     * - NEXUS_UDP_MULTICAST (0 or 1) / NEXUS_UDP_MULTICAST_BASE / NEXUS_UDP_MULTICAST_BUCKETS
+     * - NEXUS_UDP_MULTICAST_PORT / NEXUS_UDP_MULTICAST_TTL
+     * - NEXUS_UDP_RELIABLE_FRAGMENT / NEXUS_UDP_RELIABLE_WINDOW / NEXUS_UDP_RELIABLE_RETRANSMIT_MS
+     * - NEXUS_UDP_RELIABLE_TIMEOUT_MS / NEXUS_UDP_RELIABLE_MAX_MESSAGE
+     * - NEXUS_SHM_LANE_SCHEDULING ("strict" or "wrr")
+     * - NEXUS_SHM_LANE_WEIGHTS (frames per round per lane, e.g. "16,4,1")
+     * - NEXUS_SHM_LANE_DROP_MASK
+     * - NEXUS_SHM_HUGE_PAGES / NEXUS_SHM_PREFAULT / NEXUS_SHM_MLOCK (0 or 1)
+     * - NEXUS_SHM_SHARED_INBOX (0 or 1) / NEXUS_SHM_INBOX_PROMOTE_RATE (frames per second)
+     * - NEXUS_SHM_TOPIC_BUS_SIZE (bytes)
      * - NEXUS_BUFFER_SIZE
+     * - NEXUS_LARGE_DATA_HUGE_PAGES / NEXUS_LARGE_DATA_PREFAULT / NEXUS_LARGE_DATA_MLOCK (0 or 1)
+     * - NEXUS_THREADS_SHM_RECEIVE / NEXUS_THREADS_UDP_RECEIVE / NEXUS_THREADS_WORKER / NEXUS_THREADS_SYSTEM /
+     *   NEXUS_THREADS_LARGE_DATA / NEXUS_THREADS_MAINTENANCE ("policy[:priority][@cpus]", e.g. "fifo:80@2-3")
      */
     void loadFromEnv();
 
     /**
-     * @brief Calculate memory footprint based on current config
+     * @brief Raise settings that would break the transports to their smallest working value
+     *
+     * shm.queue_capacity × shm.message_size must fit a full MessagePacket
+     * (SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES, 128 messages of 2 KB).
+     * Called by loadFromEnv(); call it after changing the config in code.
+     */
+    void validate();
+
+    /**
+     * @brief Rough memory estimate from the current config (queues × capacity × message size)
+     *
+     * Not tied to the real segment layouts; use Node::getMemoryUsage() for
+     * the measured mapped and resident bytes of a running node.
      */
     size_t calculateMemoryFootprint() const;
 
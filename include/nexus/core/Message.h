@@ -1,11 +1,15 @@
 #pragma once
 
 #include <stdint.h>
+#include <time.h>
 
+#include <cstddef>
 #include <cstring>
 #include <string>
 #include <vector>
 
+#include "nexus/utils/Crc32c.h"
+
 namespace Nexus {
 namespace rpc {
 
@@ -23,28 +27,49 @@ enum class MessageType : uint8_t {
     NODE_JOIN = 7,            // Node joined notification
     NODE_LEAVE = 8,           // Node leaving notification
     HEARTBEAT = 9,            // Heartbeat (for UDP node liveness detection)
+    REQUEST = 10,             // RPC request (topic = method, payload = CallHeader + request)
+    REPLY = 11,               // RPC reply, point-to-point to the caller (payload = CallHeader + response)
+    RELIABLE_DATA = 12,       // Reliable UDP fragment (payload = ReliableFragment + message bytes)
+    RELIABLE_ACK = 13,        // Reliable UDP acknowledgement, to the fragment's sender (payload = ReliableAck)
+    SERVICE_SNAPSHOT = 14,    // A node's whole service set, point-to-point to the querier (possibly in chunks)
+    TRACED_DATA = 15,         // DATA followed by a TraceStamp (Config::NodeConfig::latency_tracing)
+    DEADLINE_DATA = 16,       // DATA followed by a DeadlineStamp (Node::setTopicTtl(), Node::publishWithTtl())
+};
+
+/**
+ * @brief Packet integrity check, declared by the sender in the packet header
+ *
+ * Version 1 packets always carry SUM (their header byte is reserved and zero);
+ * version 2 packets name their mode in checksum_type, so each transport can
+ * pick its own and receivers verify whatever the sender chose.
+ */
+enum class ChecksumType : uint8_t {
+    SUM = 0,     // Legacy byte sum (version 1 wire format, understood by every peer)
+    NONE = 1,    // No check (trusted same-host shared memory only)
+    CRC32C = 2,  // CRC32C, hardware-accelerated where available
 };
 
 /**
  * @brief Message packet structure for network transmission
  */
 struct MessagePacket {
-    static constexpr uint32_t MAGIC = 0x4C525043;  // "LRPC"
-    static constexpr uint16_t VERSION = 1;
+    static constexpr uint32_t MAGIC = 0x4C525043;    // "LRPC"
+    static constexpr uint16_t VERSION = 1;           // Legacy: checksum is always SUM
+    static constexpr uint16_t VERSION_CHECKSUM = 2;  // checksum_type names the checksum
     static constexpr uint16_t MAX_GROUP_LEN = 128;
     static constexpr uint16_t MAX_TOPIC_LEN = 128;
     static constexpr uint32_t MAX_PAYLOAD_LEN = 65000;  // ~64KB
 
-    uint32_t magic;        // Magic number for validation
-    uint16_t version;      // Protocol version
-    uint8_t msg_type;      // Message type (DATA, SUBSCRIBE, UNSUBSCRIBE)
-    uint8_t reserved;      // Reserved for future use
-    uint16_t group_len;    // Length of group name
-    uint16_t topic_len;    // Length of topic name
-    uint32_t payload_len;  // Length of payload
-    uint32_t checksum;     // Simple checksum
-    char node_id[64];      // Source node ID
-    uint16_t udp_port;     // Sender's UDP port
+    uint32_t magic;         // Magic number for validation
+    uint16_t version;       // Protocol version
+    uint8_t msg_type;       // Message type (DATA, SUBSCRIBE, UNSUBSCRIBE)
+    uint8_t checksum_type;  // ChecksumType (version 2; reserved and 0 in version 1)
+    uint16_t group_len;     // Length of group name
+    uint16_t topic_len;     // Length of topic name
+    uint32_t payload_len;   // Length of payload
+    uint32_t checksum;      // See checksum_type
+    char node_id[64];       // Source node ID
+    uint16_t udp_port;      // Sender's UDP port
     // Variable length data: [group][topic][payload]
     // QNX compatibility: Use array[1] instead of flexible array member on QNX
     // to ensure stable sizeof() behavior and proper memory alignment
@@ -87,8 +112,53 @@ struct MessagePacket {
         return reinterpret_cast<uint8_t*>(data + group_len + topic_len);
     }
 
-    // Calculate checksum
+    // Calculate checksum (mode from checksum_type)
     uint32_t calculateChecksum() const {
+        switch (static_cast<ChecksumType>(checksum_type)) {
+            case ChecksumType::NONE:
+                return 0;
+            case ChecksumType::CRC32C: {
+                // Header up to the checksum field, the rest of the header, then [group][topic][payload]
+                const uint8_t* header = reinterpret_cast<const uint8_t*>(this);
+                const size_t after_checksum = offsetof(MessagePacket, checksum) + sizeof(checksum);
+                const size_t header_end = offsetof(MessagePacket, udp_port) + sizeof(udp_port);
+                uint32_t crc = crc32c(0, header, offsetof(MessagePacket, checksum));
+                crc = crc32c(crc, header + after_checksum, header_end - after_checksum);
+                return crc32c(crc, data, static_cast<size_t>(group_len) + topic_len + payload_len);
+            }
+            case ChecksumType::SUM:
+            default:
+                return legacySum();
+        }
+    }
+
+    // Validate packet; NONE is only accepted where the link is trusted (@p allow_unchecked)
+    bool isValid(bool allow_unchecked = false) const {
+        if (magic != MAGIC)
+            return false;
+        if (version == VERSION) {
+            if (checksum_type != static_cast<uint8_t>(ChecksumType::SUM))
+                return false;
+        } else if (version == VERSION_CHECKSUM) {
+            if (checksum_type > static_cast<uint8_t>(ChecksumType::CRC32C))
+                return false;
+            if (checksum_type == static_cast<uint8_t>(ChecksumType::NONE) && !allow_unchecked)
+                return false;
+        } else {
+            return false;
+        }
+        if (group_len > MAX_GROUP_LEN)
+            return false;
+        if (topic_len > MAX_TOPIC_LEN)
+            return false;
+        if (payload_len > MAX_PAYLOAD_LEN)
+            return false;
+        return checksum == calculateChecksum();
+    }
+
+private:
+    // Version 1 checksum: byte sum of the header fields, node ID and data
+    uint32_t legacySum() const {
         uint32_t sum = 0;
         sum += magic;
         sum += version;
@@ -112,23 +182,231 @@ struct MessagePacket {
 
         return sum;
     }
+};
 
-    // Validate packet
-    bool isValid() const {
-        if (magic != MAGIC)
-            return false;
-        if (version != VERSION)
+/**
+ * @brief Compact DATA frame (version 3, shared memory only)
+ *
+ * Replaces the node ID, group and topic strings of MessagePacket with the
+ * receiver's own topic id, which the receiver advertised in its
+ * SERVICE_REGISTER. The sender is known from the inbound queue the frame
+ * arrives on. A 16-byte sample takes 40 bytes instead of 100+.
+ *
+ * topic_hash (of group and topic) lets the receiver reject ids learned from a
+ * previous instance of itself. Receivers that never advertised an id only ever
+ * get MessagePacket frames, so older peers are unaffected.
+ */
+struct CompactPacket {
+    static constexpr uint16_t VERSION = 3;
+
+    uint32_t magic;          // MessagePacket::MAGIC (shared prefix with MessagePacket)
+    uint16_t version;        // VERSION
+    uint8_t msg_type;        // MessageType::DATA
+    uint8_t checksum_type;   // ChecksumType
+    uint32_t topic_id;       // Receiver's topic id
+    uint32_t topic_hash;     // topicHash(group, topic)
+    uint32_t payload_len;    // Length of payload
+    uint32_t checksum;       // See checksum_type
+
+    static size_t packetSize(size_t payload_len) { return sizeof(CompactPacket) + payload_len; }
+
+    // Identity check for a topic id received from another process
+    static uint32_t topicHash(const std::string& group, const std::string& topic) {
+        const char separator = '\0';
+        uint32_t hash = crc32c(0, group.data(), group.size());
+        hash = crc32c(hash, &separator, 1);
+        return crc32c(hash, topic.data(), topic.size());
+    }
+
+    // True if @p data starts with a compact header (the caller checked size >= sizeof(CompactPacket))
+    static bool isCompact(const uint8_t* data) {
+        const CompactPacket* packet = reinterpret_cast<const CompactPacket*>(data);
+        return packet->magic == MessagePacket::MAGIC && packet->version == VERSION;
+    }
+
+    const uint8_t* getPayload() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+    uint8_t* getPayload() { return reinterpret_cast<uint8_t*>(this + 1); }
+
+    uint32_t calculateChecksum() const {
+        const uint8_t* header = reinterpret_cast<const uint8_t*>(this);
+        switch (static_cast<ChecksumType>(checksum_type)) {
+            case ChecksumType::NONE:
+                return 0;
+            case ChecksumType::CRC32C:
+                return crc32c(crc32c(0, header, offsetof(CompactPacket, checksum)), getPayload(), payload_len);
+            case ChecksumType::SUM:
+            default: {
+                uint32_t sum = 0;
+                for (size_t i = 0; i < offsetof(CompactPacket, checksum); ++i) {
+                    sum += header[i];
+                }
+                const uint8_t* payload = getPayload();
+                for (size_t i = 0; i < payload_len; ++i) {
+                    sum += payload[i];
+                }
+                return sum;
+            }
+        }
+    }
+
+    // Validate a frame of @p size bytes; NONE is only accepted where the link is trusted
+    bool isValid(size_t size, bool allow_unchecked = false) const {
+        if (magic != MessagePacket::MAGIC || version != VERSION)
             return false;
-        if (group_len > MAX_GROUP_LEN)
+        if (checksum_type > static_cast<uint8_t>(ChecksumType::CRC32C))
             return false;
-        if (topic_len > MAX_TOPIC_LEN)
+        if (checksum_type == static_cast<uint8_t>(ChecksumType::NONE) && !allow_unchecked)
             return false;
-        if (payload_len > MAX_PAYLOAD_LEN)
+        if (payload_len > MessagePacket::MAX_PAYLOAD_LEN || packetSize(payload_len) > size)
             return false;
         return checksum == calculateChecksum();
     }
 };
 
+/**
+ * @brief LZ4-compressed datagram (version 4, UDP only)
+ *
+ * Wraps a whole packet (MessagePacket) whose bytes follow as one LZ4 block.
+ * UdpTransport compresses above its threshold, only when the result is
+ * smaller, and expands these before its receive callback runs, so nodes only
+ * ever see the original packet. Shared memory never carries them. Peers
+ * without compression reject the version like any malformed packet.
+ */
+struct CompressedPacket {
+    static constexpr uint16_t VERSION = 4;
+    static constexpr uint32_t MAX_RAW_SIZE = 128 * 1024;  // Largest packet a receiver expands
+
+    uint32_t magic;     // MessagePacket::MAGIC (shared prefix with MessagePacket)
+    uint16_t version;   // VERSION
+    uint16_t reserved;  // 0
+    uint32_t raw_size;  // Size of the packet once expanded
+
+    // True if @p data starts with a compressed header (the caller checked size >= sizeof(CompressedPacket))
+    static bool isCompressed(const uint8_t* data) {
+        const CompressedPacket* packet = reinterpret_cast<const CompressedPacket*>(data);
+        return packet->magic == MessagePacket::MAGIC && packet->version == VERSION;
+    }
+
+    const uint8_t* getBlock() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+    uint8_t* getBlock() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+/**
+ * @brief Trailer of TRACED_DATA frames, right after the payload (not covered by payload_len or the checksum)
+ *
+ * Full packets (MessagePacket) of this type are ignored by receivers that
+ * predate it; compact frames keep their layout up to the payload, so older
+ * receivers deliver them and never look at the trailer.
+ */
+struct TraceStamp {
+    uint64_t send_ns;  // Sender's CLOCK_MONOTONIC: comparable between processes of one host only
+
+    static uint64_t now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    // Write the current time behind a payload (unaligned)
+    static void write(uint8_t* payload_end) {
+        const TraceStamp stamp = {now()};
+        std::memcpy(payload_end, &stamp, sizeof(stamp));
+    }
+
+    /**
+     * @brief Send time of a frame of @p frame_size bytes whose payload ends at @p payload_end
+     * @return 0 if the frame is too short to carry the trailer
+     */
+    static uint64_t read(const uint8_t* frame, size_t frame_size, const uint8_t* payload_end) {
+        if (static_cast<size_t>(payload_end - frame) + sizeof(TraceStamp) > frame_size) {
+            return 0;
+        }
+        TraceStamp stamp;
+        std::memcpy(&stamp, payload_end, sizeof(stamp));
+        return stamp.send_ns;
+    }
+};
+
+/**
+ * @brief Trailer of DEADLINE_DATA frames, right after the payload (not covered by payload_len or the checksum)
+ *
+ * Starts with the send time like a TraceStamp, so latency tracing reads these
+ * frames too. A receiver on the sender's host drops the message once its own
+ * clock passes send_ns + ttl_ns; one on another host, whose clock does not
+ * compare, counts the time-to-live from the frame's arrival instead. Older
+ * receivers ignore full packets of this type and deliver compact frames.
+ */
+struct DeadlineStamp {
+    uint64_t send_ns;  // Sender's CLOCK_MONOTONIC at publish
+    uint64_t ttl_ns;   // Time-to-live from send_ns
+
+    // Write behind a payload (unaligned)
+    static void write(uint8_t* payload_end, uint64_t send_ns, uint64_t ttl_ns) {
+        const DeadlineStamp stamp = {send_ns, ttl_ns};
+        std::memcpy(payload_end, &stamp, sizeof(stamp));
+    }
+
+    /**
+     * @brief Trailer of a frame of @p frame_size bytes whose payload ends at @p payload_end
+     * @return false if the frame is too short to carry it
+     */
+    static bool read(const uint8_t* frame, size_t frame_size, const uint8_t* payload_end, DeadlineStamp& stamp) {
+        if (static_cast<size_t>(payload_end - frame) + sizeof(DeadlineStamp) > frame_size) {
+            return false;
+        }
+        std::memcpy(&stamp, payload_end, sizeof(stamp));
+        return true;
+    }
+};
+
+/**
+ * @brief What a sender appends behind the payload of the DATA frames of one publish
+ */
+struct DataTrailer {
+    bool traced = false;   // TraceStamp (Config::NodeConfig::latency_tracing)
+    uint64_t send_ns = 0;  // Publish time (with a time-to-live only)
+    uint64_t ttl_ns = 0;   // Non-zero: DeadlineStamp instead, which also carries the send time
+
+    size_t size() const { return ttl_ns != 0 ? sizeof(DeadlineStamp) : (traced ? sizeof(TraceStamp) : 0); }
+    uint64_t deadlineNs() const { return ttl_ns != 0 ? send_ns + ttl_ns : 0; }
+};
+
+/**
+ * @brief Prefix of REQUEST/REPLY payloads
+ *
+ * call_id correlates a reply with the caller's pending call; it is chosen by
+ * the caller and echoed unchanged by the server.
+ */
+struct CallHeader {
+    uint64_t call_id;   // Unique per calling node
+    uint32_t status;    // REPLY: Node::Error of the call (NO_ERROR, or NOT_FOUND if not served); REQUEST: 0
+    uint32_t reserved;  // 0
+};
+
+/**
+ * @brief Prefix of RELIABLE_DATA payloads: one fragment of a reliable UDP message
+ *
+ * Each sender numbers the fragments it sends to one receiver in a stream;
+ * the fragments of a message take consecutive sequence numbers, and the
+ * receiver delivers whole messages in sequence order (see ReliableUdpChannel).
+ */
+struct ReliableFragment {
+    uint32_t stream_id;     // Sender's stream to this receiver; a new id restarts the sequence at 0
+    uint32_t seq;           // Fragment sequence number within the stream
+    uint32_t message_size;  // Payload size of the whole message
+    uint32_t offset;        // Byte offset of this fragment within the message
+};
+
+/**
+ * @brief RELIABLE_ACK payload, followed by nack_count missing sequence numbers (uint32_t)
+ */
+struct ReliableAck {
+    uint32_t stream_id;   // Stream being acknowledged
+    uint32_t next_seq;    // Every fragment before this one was received
+    uint16_t nack_count;  // Missing fragments the sender should resend
+    uint16_t reserved;    // 0
+};
+
 /**
  * @brief Subscription key for routing
  */
@@ -149,32 +427,172 @@ struct SubscriptionKey {
     std::string toString() const { return group + "/" + topic; }
 };
 
+/**
+ * @brief Non-owning view of a serialized packet
+ */
+class PacketView {
+public:
+    PacketView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
 /**
  * @brief Message builder for creating packets
+ *
+ * build() returns an owning vector; the send paths use buildView() (per-thread
+ * buffer) or buildInto()/buildHeader() (caller or transport memory) so that
+ * steady-state sending does not allocate.
  */
 class MessageBuilder {
 public:
     static std::vector<uint8_t> build(const std::string& node_id, const std::string& group, const std::string& topic,
                                       const std::string& payload, uint16_t udp_port = 0,
-                                      MessageType msg_type = MessageType::DATA) {
+                                      MessageType msg_type = MessageType::DATA,
+                                      ChecksumType checksum = ChecksumType::SUM) {
         return build(node_id, group, topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), udp_port,
-                     msg_type);
+                     msg_type, checksum);
     }
 
     static std::vector<uint8_t> build(const std::string& node_id, const std::string& group, const std::string& topic,
                                       const uint8_t* payload, size_t payload_len, uint16_t udp_port = 0,
-                                      MessageType msg_type = MessageType::DATA) {
+                                      MessageType msg_type = MessageType::DATA,
+                                      ChecksumType checksum = ChecksumType::SUM) {
         size_t total_size = MessagePacket::packetSize(group.size(), topic.size(), payload_len);
         std::vector<uint8_t> buffer(total_size);
+        buildInto(buffer.data(), node_id, group, topic, payload, payload_len, udp_port, msg_type, checksum);
+        return buffer;
+    }
+
+    /**
+     * @brief Serialize into this thread's packet buffer
+     *
+     * The view stays valid until the next buildView()/threadBuffer() call on
+     * the same thread, so send it before building another packet.
+     */
+    static PacketView buildView(const std::string& node_id, const std::string& group, const std::string& topic,
+                                const uint8_t* payload, size_t payload_len, uint16_t udp_port = 0,
+                                MessageType msg_type = MessageType::DATA, ChecksumType checksum = ChecksumType::SUM) {
+        uint8_t* buffer = threadBuffer(MessagePacket::packetSize(group.size(), topic.size(), payload_len));
+        size_t size = buildInto(buffer, node_id, group, topic, payload, payload_len, udp_port, msg_type, checksum);
+        return PacketView(buffer, size);
+    }
+
+    static PacketView buildView(const std::string& node_id, const std::string& group, const std::string& topic,
+                                const std::string& payload, uint16_t udp_port = 0,
+                                MessageType msg_type = MessageType::DATA, ChecksumType checksum = ChecksumType::SUM) {
+        return buildView(node_id, group, topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                         udp_port, msg_type, checksum);
+    }
+
+    /**
+     * @brief This thread's packet buffer, at least @p size bytes
+     *
+     * Grows to the largest packet built on the thread and is reused afterwards.
+     */
+    static uint8_t* threadBuffer(size_t size) {
+        thread_local std::vector<uint8_t> buffer;
+        if (buffer.size() < size) {
+            buffer.resize(size);
+        }
+        return buffer.data();
+    }
+
+    /**
+     * @brief Serialize a complete packet into caller-provided memory
+     * @param buffer Destination, at least MessagePacket::packetSize() bytes
+     * @return Number of bytes written
+     */
+    static size_t buildInto(uint8_t* buffer, const std::string& node_id, const std::string& group,
+                            const std::string& topic, const uint8_t* payload, size_t payload_len, uint16_t udp_port = 0,
+                            MessageType msg_type = MessageType::DATA, ChecksumType checksum = ChecksumType::SUM) {
+        MessagePacket* packet = buildHeader(buffer, node_id, group, topic, payload_len, udp_port, msg_type, checksum);
+        if (payload_len > 0) {
+            std::memcpy(packet->getPayload(), payload, payload_len);
+        }
+
+        // Calculate checksum
+        packet->checksum = packet->calculateChecksum();
+
+        return MessagePacket::packetSize(group.size(), topic.size(), payload_len);
+    }
 
-        MessagePacket* packet = reinterpret_cast<MessagePacket*>(buffer.data());
+    /**
+     * @brief Write a compact (version 3) DATA header into caller-provided memory
+     *
+     * The payload follows the header (getPayload()); set the checksum afterwards
+     * with calculateChecksum().
+     */
+    static CompactPacket* buildCompactHeader(uint8_t* buffer, uint32_t topic_id, uint32_t topic_hash,
+                                             size_t payload_len, ChecksumType checksum = ChecksumType::SUM) {
+        CompactPacket* packet = reinterpret_cast<CompactPacket*>(buffer);
         packet->magic = MessagePacket::MAGIC;
-        packet->version = MessagePacket::VERSION;
+        packet->version = CompactPacket::VERSION;
+        packet->msg_type = static_cast<uint8_t>(MessageType::DATA);
+        packet->checksum_type = static_cast<uint8_t>(checksum);
+        packet->topic_id = topic_id;
+        packet->topic_hash = topic_hash;
+        packet->payload_len = static_cast<uint32_t>(payload_len);
+        packet->checksum = 0;
+        return packet;
+    }
+
+    /**
+     * @brief Make a DATA frame TRACED_DATA and append the send time behind its payload
+     *
+     * The frame needs sizeof(TraceStamp) bytes past the payload. The type is
+     * covered by the checksum, so call this before calculateChecksum().
+     */
+    static void stampSendTime(MessagePacket* packet) {
+        packet->msg_type = static_cast<uint8_t>(MessageType::TRACED_DATA);
+        TraceStamp::write(packet->getPayload() + packet->payload_len);
+    }
+
+    static void stampSendTime(CompactPacket* packet) {
+        packet->msg_type = static_cast<uint8_t>(MessageType::TRACED_DATA);
+        TraceStamp::write(packet->getPayload() + packet->payload_len);
+    }
+
+    /**
+     * @brief Append @p trailer behind the payload of a DATA frame (and set its type to match)
+     *
+     * The frame needs trailer.size() bytes past the payload; call this before calculateChecksum().
+     */
+    template <typename Packet>
+    static void stampTrailer(Packet* packet, const DataTrailer& trailer) {
+        if (trailer.ttl_ns != 0) {
+            packet->msg_type = static_cast<uint8_t>(MessageType::DEADLINE_DATA);
+            DeadlineStamp::write(packet->getPayload() + packet->payload_len, trailer.send_ns, trailer.ttl_ns);
+        } else if (trailer.traced) {
+            stampSendTime(packet);
+        }
+    }
+
+    /**
+     * @brief Write header, group and topic into caller-provided memory
+     *
+     * The payload area is left for the caller to fill through getPayload();
+     * the checksum must be set afterwards with calculateChecksum().
+     * SUM keeps the version 1 wire format; other modes need version 2 receivers.
+     */
+    static MessagePacket* buildHeader(uint8_t* buffer, const std::string& node_id, const std::string& group,
+                                      const std::string& topic, size_t payload_len, uint16_t udp_port = 0,
+                                      MessageType msg_type = MessageType::DATA,
+                                      ChecksumType checksum = ChecksumType::SUM) {
+        MessagePacket* packet = reinterpret_cast<MessagePacket*>(buffer);
+        packet->magic = MessagePacket::MAGIC;
+        packet->version = checksum == ChecksumType::SUM ? MessagePacket::VERSION : MessagePacket::VERSION_CHECKSUM;
         packet->msg_type = static_cast<uint8_t>(msg_type);
-        packet->reserved = 0;
+        packet->checksum_type = static_cast<uint8_t>(checksum);
         packet->group_len = static_cast<uint16_t>(group.size());
         packet->topic_len = static_cast<uint16_t>(topic.size());
         packet->payload_len = static_cast<uint32_t>(payload_len);
+        packet->checksum = 0;
         packet->udp_port = udp_port;
 
         // Copy node_id (truncate if too long)
@@ -184,12 +602,8 @@ public:
         // Copy data
         std::memcpy(packet->getGroup(), group.data(), group.size());
         std::memcpy(packet->getTopic(), topic.data(), topic.size());
-        std::memcpy(packet->getPayload(), payload, payload_len);
 
-        // Calculate checksum
-        packet->checksum = packet->calculateChecksum();
-
-        return buffer;
+        return packet;
     }
 };
 
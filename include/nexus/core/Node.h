@@ -12,6 +12,7 @@ namespace rpc {
 
 // Forward declaration
 class LargeDataChannel;
+class PollingSubscription;
 
 /**
  * @brief Transport type enumeration
@@ -28,7 +29,24 @@ enum class TransportType {
 enum class ServiceType {
     ALL = 0,         // All service types (for query)
     NORMAL_MESSAGE,  // Normal pub/sub messages (256B-2KB)
-    LARGE_DATA       // Large data channel (1MB-8MB)
+    LARGE_DATA,      // Large data channel (1MB-8MB)
+    RPC_METHOD,      // Request/response method (topic = method name, see Node::serve())
+    TOPIC_BUS        // Shared memory ring of a topic (channel_name, see Node::setTopicBus())
+};
+
+/**
+ * @brief Shared-memory delivery lane of a topic
+ *
+ * Each sender owns one lane of each priority in every receiver's inbound
+ * queue. The receive thread drains the control queue first, then the lanes
+ * in priority order (or weighted round-robin, see Config::shm), so a burst
+ * on a BULK topic never delays a HIGH one. Values are the transport's lane
+ * indices. In-process and UDP delivery are unaffected.
+ */
+enum class MessagePriority : uint8_t {
+    HIGH = 0,    // Commands and other latency-critical messages
+    NORMAL = 1,  // Default
+    BULK = 2     // Telemetry and other high-volume streams (drops instead of blocking by default)
 };
 
 /**
@@ -42,12 +60,26 @@ struct ServiceDescriptor {
     std::string channel_name;  // Large data channel name (empty for normal messages)
     TransportType transport;   // Transport type (INPROCESS/SHARED_MEMORY/UDP)
     std::string udp_address;   // UDP address (IP:port, empty for non-UDP)
-
-    ServiceDescriptor() : type(ServiceType::NORMAL_MESSAGE), transport(TransportType::INPROCESS) {}
+    std::string multicast_address;  // UDP multicast group the subscriber joined (IP:port, empty = unicast only)
+    uint32_t topic_id;         // Provider's topic id for compact shm frames (NO_TOPIC_ID if not advertised)
+    MessagePriority priority;  // Lane the subscriber asked for (shared memory subscriptions)
+    uint32_t min_interval_us;  // Publisher-side rate limit the subscriber asked for (0: every message)
+    uint32_t reader_slot;      // TOPIC_BUS: slot of a subscriber reading the bus (NO_READER_SLOT: the publisher's bus)
+
+    static constexpr uint32_t NO_TOPIC_ID = 0xFFFFFFFF;
+    static constexpr uint32_t NO_READER_SLOT = 0xFFFFFFFF;
+
+    ServiceDescriptor()
+        : type(ServiceType::NORMAL_MESSAGE),
+          transport(TransportType::INPROCESS),
+          topic_id(NO_TOPIC_ID),
+          priority(MessagePriority::NORMAL),
+          min_interval_us(0),
+          reader_slot(NO_READER_SLOT) {}
 
     // Get unique capability identifier
     std::string getCapability() const {
-        if (type == ServiceType::LARGE_DATA) {
+        if (type == ServiceType::LARGE_DATA || type == ServiceType::TOPIC_BUS) {
             return group + "/" + channel_name + "/" + topic;
         } else {
             return group + "/" + topic;
@@ -84,7 +116,9 @@ using ServiceDiscoveryCallback = std::function<void(ServiceEvent event, const Se
 enum class QueueOverflowPolicy {
     DROP_OLDEST,  // Drop oldest message (default, suitable for sensor data)
     DROP_NEWEST,  // Drop newest message (suitable for control commands)
-    BLOCK         // Block until space available (may cause deadlock)
+    BLOCK         // Wait for space up to Config::node.block_timeout_ms, then drop the new message
+                  // (lossless backpressure: stalls the in-process publisher or the receive thread,
+                  // whose full shared-memory queue then holds back inter-process publishers)
 };
 
 /**
@@ -97,6 +131,186 @@ enum class QueueOverflowPolicy {
 using QueueOverflowCallback =
     std::function<void(const std::string& msg_group, const std::string& topic, size_t dropped_count)>;
 
+/**
+ * @brief Queue whose fill crossed a watermark (see Node::setWatermarkCallback)
+ */
+enum class WatermarkSource {
+    WORKER_QUEUE,     // A subscribed topic's dispatch queue in this node (messages)
+    SHM_RING,         // A shared memory data lane this node sends on to another node (bytes)
+    LARGE_DATA_RING,  // A large data channel this node writes (bytes not yet read by its slowest reader)
+};
+
+struct WatermarkEvent {
+    WatermarkSource source;
+    bool high;           // true: rose to the high watermark; false: fell back to the low watermark
+    std::string group;   // WORKER_QUEUE: message group of the topic
+    std::string name;    // WORKER_QUEUE: topic; SHM_RING: destination node; LARGE_DATA_RING: channel
+    uint32_t lane = 0;   // SHM_RING: data lane (0 = high priority)
+    size_t level = 0;    // Fill when the watermark was crossed
+    size_t capacity = 0;
+};
+
+/**
+ * @brief Watermark callback; runs on the thread that noticed the crossing (keep it short)
+ */
+using WatermarkCallback = std::function<void(const WatermarkEvent& event)>;
+
+/**
+ * @brief Large data block callback (see Node::subscribeLargeData)
+ * @param data Points into the channel's shared memory; valid only during the callback
+ */
+using LargeDataCallback = std::function<void(const std::string& channel_name, const std::string& topic,
+                                             const uint8_t* data, size_t size, uint64_t sequence)>;
+
+/**
+ * @brief Where subscriber callbacks run
+ */
+enum class DispatchMode {
+    QUEUED,  // Copied into the node's queue, run on a dispatch worker (default)
+    INLINE,  // Run directly on the receiving thread; the callback must not block
+    LATEST   // Like QUEUED, but only the newest undelivered message of each topic is kept
+};
+
+/**
+ * @brief Per-subscription options
+ *
+ * INLINE skips the dispatch queue, the worker wakeup and the payload copy: for
+ * shared-memory traffic the payload pointer still points into the receive ring
+ * and is only valid during the callback. The callback runs on a transport
+ * receive thread (or, in-process, on the publisher's thread), so a slow or
+ * blocking callback stalls every sender behind it. Queue overflow policies do
+ * not apply to inline subscriptions.
+ *
+ * LATEST (conflation) suits state topics such as poses: each topic has one
+ * slot that a new message overwrites, so a slow callback sees the newest value
+ * and never a backlog. Overwritten messages are not counted as drops.
+ *
+ * max_rate_hz decimates at the source: publishers in other processes send
+ * this subscriber at most one message per 1/max_rate_hz seconds of each topic
+ * and skip the rest, so the surplus never takes ring space, a wakeup or a
+ * worker on either side. It applies to shared memory and unicast UDP
+ * deliveries; in-process publishers and multicast groups deliver every
+ * message.
+ */
+struct SubscribeOptions {
+    DispatchMode dispatch = DispatchMode::QUEUED;
+    MessagePriority priority = MessagePriority::NORMAL;  // Lane publishers use towards this subscriber
+    double max_rate_hz = 0;                              // Messages per second and topic publishers send (0: all)
+};
+
+/**
+ * @brief Traffic and dispatch counters of one (group, topic) in one node
+ *
+ * See Node::getTopicStats(). Counters only grow; diff two snapshots for rates.
+ */
+struct TopicStats {
+    std::string group;
+    std::string topic;
+    uint64_t published = 0;        // Publishes by this node (each publishBatch() payload counts)
+    uint64_t published_bytes = 0;  // Payload bytes of those publishes
+    uint64_t delivered = 0;        // Messages handed to this node's subscriber callback
+    uint64_t delivered_bytes = 0;
+    uint64_t dropped = 0;          // Messages this node's subscription queue dropped (queue overflow policy)
+    uint64_t expired = 0;          // Messages this node dropped past their deadline (see Node::setTopicTtl())
+    uint64_t callback_ns = 0;      // Time spent in the subscriber callback
+};
+
+/**
+ * @brief Latency histograms of one (group, topic) in one receiving node
+ *
+ * See Node::getTopicLatency(). Each stage is a log2 histogram: bucket i holds
+ * samples of [2^i, 2^(i+1)) ns (bucket 0 also holds 0 ns, the last one
+ * everything longer). Stages add up to the time from publish to the end of
+ * the callback, so the largest one shows where a slow topic loses its time.
+ */
+struct TopicLatency {
+    static constexpr size_t BUCKETS = 32;
+
+    struct Histogram {
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+        uint64_t buckets[BUCKETS] = {};
+
+        // Upper bound of the bucket holding the @p fraction quantile (0.5 = median); 0 if empty
+        uint64_t quantileNs(double fraction) const {
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                seen += buckets[i];
+                if (count > 0 && seen >= fraction * count) {
+                    return (uint64_t(2) << i) - 1;
+                }
+            }
+            return 0;
+        }
+    };
+
+    std::string group;
+    std::string topic;
+    Histogram transit;   // Publish -> our receive loop (inter-process; UDP: beyond the fastest frame from that peer)
+    Histogram receive;   // Receive loop -> queued for the callback (inline dispatch: -> callback start)
+    Histogram queue;     // Queued -> callback start (worker dispatch)
+    Histogram callback;  // Callback duration
+};
+
+/**
+ * @brief One shared memory mapping of a node (see Node::getMemoryUsage())
+ */
+struct MappedRegion {
+    std::string name;     // Node id (shm segments) or channel name (large data)
+    size_t mapped = 0;    // Bytes of the segment mapped by this node
+    size_t resident = 0;  // Bytes of it in RAM (mincore), shared with every other process mapping it
+};
+
+/**
+ * @brief Measured memory of one node
+ *
+ * Mapped sizes come from the real segment layouts, resident sizes from
+ * mincore() at the time of the call: a lane or channel ring only costs RAM
+ * once traffic has touched its pages.
+ */
+struct MemoryUsage {
+    MappedRegion shm_segment;                 // This node's inbound segment
+    std::vector<MappedRegion> shm_peers;      // Segments of connected nodes, mapped to send to them
+    std::vector<MappedRegion> large_writers;  // Channels opened with getLargeDataChannel()
+    std::vector<MappedRegion> large_readers;  // Channels mapped by subscribeLargeData() and bridgeLargeData()
+    size_t queued_messages = 0;               // Messages waiting in this node's dispatch queues
+    size_t queue_bytes = 0;                   // Heap of the dispatch queues (entries, not payloads)
+    size_t pool_bytes = 0;                    // Payload slots allocated by the pool all nodes share (high-water mark)
+    size_t process_resident = 0;              // Resident set of the whole process (all nodes, code and heap)
+};
+
+/**
+ * @brief Handle to an interned (group, topic) pair
+ *
+ * Obtained from Node::resolveTopic(). Handles are cheap to copy and stay valid
+ * for the lifetime of the process. Routing and dispatch key on the dense id()
+ * instead of hashing and comparing the group/topic strings.
+ */
+class TopicHandle {
+public:
+    struct Entry {
+        uint32_t id;        // Dense, process-wide (0, 1, 2, ...)
+        std::string group;  // Message group
+        std::string topic;  // Topic name within the group
+        uint32_t hash;      // CompactPacket::topicHash(group, topic)
+    };
+
+    TopicHandle() : entry_(nullptr) {}
+    explicit TopicHandle(const Entry* entry) : entry_(entry) {}
+
+    bool valid() const { return entry_ != nullptr; }
+    uint32_t id() const { return entry_->id; }
+    const std::string& group() const { return entry_->group; }
+    const std::string& topic() const { return entry_->topic; }
+    uint32_t hash() const { return entry_->hash; }
+
+    bool operator==(const TopicHandle& other) const { return entry_ == other.entry_; }
+    bool operator!=(const TopicHandle& other) const { return entry_ != other.entry_; }
+
+private:
+    const Entry* entry_;
+};
+
 /**
  * @brief Node interface for peer-to-peer communication
  *
@@ -112,6 +326,16 @@ public:
     using Property = std::string;
     using Callback =
         std::function<void(const Property& msg_group, const Property& topic, const uint8_t* payload, size_t size)>;
+    using PayloadWriter = std::function<void(uint8_t* payload, size_t size)>;
+    using MethodHandler = std::function<void(const uint8_t* request, size_t size, Property& response)>;
+
+    /**
+     * @brief One piece of a gathered payload (see publishv())
+     */
+    struct PayloadSegment {
+        const void* data;
+        size_t size;
+    };
 
     enum Error {
         NO_ERROR = 0,
@@ -125,6 +349,9 @@ public:
         UNEXPECTED_ERROR = 99,
     };
 
+    // Outcome of callAsync(); @p response is only valid during the callback
+    using ReplyCallback = std::function<void(Error error, const uint8_t* response, size_t size)>;
+
     virtual ~Node() = default;
 
     /**
@@ -132,20 +359,220 @@ public:
      * @param msg_group Message group name
      * @param topic Topic name within the group
      * @param payload Message payload data
-     * @return Error code
+     * @return Error code; QUEUE_FULL if a subscriber had no free space: a
+     *         shared-memory queue without credit, or an in-process queue that
+     *         dropped this message (the other subscribers still receive it).
+     *         getRetryHintUs() suggests when to retry.
      */
     virtual Error publish(const Property& msg_group, const Property& topic, const Property& payload) = 0;
 
+    /**
+     * @brief Publish a binary payload without wrapping it in a Property
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param data Payload bytes (may be null if @p size is 0)
+     * @param size Payload size in bytes
+     * @return Error code, as for publish()
+     */
+    virtual Error publish(const Property& msg_group, const Property& topic, const uint8_t* data, size_t size) = 0;
+
+    /**
+     * @brief Publish a payload gathered from several buffers (e.g. header + body)
+     *
+     * The segments are concatenated in order directly into each outgoing frame,
+     * so the caller never assembles the payload itself.
+     *
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param segments Payload pieces, in order
+     * @param count Number of segments
+     * @return Error code, as for publish()
+     */
+    virtual Error publishv(const Property& msg_group, const Property& topic, const PayloadSegment* segments,
+                           size_t count) = 0;
+
+    /**
+     * @brief Resolve a (group, topic) pair to a handle for the handle-based API
+     *
+     * Resolve once at startup and reuse the handle on the hot path.
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @return Handle, or an invalid handle if either name is empty
+     */
+    virtual TopicHandle resolveTopic(const Property& msg_group, const Property& topic) = 0;
+
+    /**
+     * @brief Publish a message to all subscribers of a resolved topic
+     * @param topic Handle from resolveTopic()
+     * @param payload Message payload data
+     * @return Error code (INVALID_ARG for an invalid handle)
+     */
+    virtual Error publish(const TopicHandle& topic, const Property& payload) = 0;
+
+    /**
+     * @brief Publish a message whose payload is written in place by the caller
+     *
+     * The writer receives a buffer of exactly @p payload_size bytes and fills it.
+     * With a single shared-memory subscriber the buffer lives directly in the
+     * subscriber's receive queue, so the payload is never copied on the send side.
+     * The writer must not publish from within the callback.
+     *
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param payload_size Payload size in bytes
+     * @param writer Callback filling the payload
+     * @return Error code
+     */
+    virtual Error publishInPlace(const Property& msg_group, const Property& topic, size_t payload_size,
+                                 const PayloadWriter& writer) = 0;
+
+    /**
+     * @brief Publish a burst of messages on one topic
+     *
+     * Equivalent to calling publish() for each payload in order, but each
+     * shared-memory subscriber receives the whole burst with a single queue
+     * update and a single wakeup.
+     *
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param payloads Message payloads, delivered in order
+     * @return Error code
+     */
+    virtual Error publishBatch(const Property& msg_group, const Property& topic,
+                               const std::vector<Property>& payloads) = 0;
+
+    /**
+     * @brief Set the shared-memory lane this node publishes a topic on
+     *
+     * Each message goes out on the more urgent of this priority and the one
+     * the subscriber asked for in SubscribeOptions::priority.
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param priority Lane (default NORMAL)
+     * @return Error code
+     */
+    virtual Error setTopicPriority(const Property& msg_group, const Property& topic, MessagePriority priority) = 0;
+
+    /**
+     * @brief Send a topic's UDP traffic over the reliable channel
+     *
+     * Messages of a reliable topic are fragmented, acknowledged and resent
+     * until every UDP subscriber has them, and each subscriber receives them
+     * whole and in order, whatever their size (up to
+     * Config::transport.udp_reliable_max_message). They go point-to-point to
+     * each subscriber, never through a multicast group. Shared-memory and
+     * in-process subscribers are unaffected.
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param reliable true for the reliable channel, false for plain datagrams (default)
+     * @return Error code; publish() of a reliable topic returns TIMEOUT if a
+     *         subscriber stopped acknowledging
+     */
+    virtual Error setTopicReliable(const Property& msg_group, const Property& topic, bool reliable) = 0;
+
+    /**
+     * @brief Fan a topic out to local subscribers through one shared memory ring
+     *
+     * Each message is written once into a ring of the topic's own (a large
+     * data channel of Config::shm.topic_bus_size bytes, oldest messages
+     * overwritten) instead of once into every subscriber's inbound queue, and
+     * a single wake-up reaches all the readers. Subscribers in other processes
+     * on this host attach to the ring as they discover it, each with a reader
+     * thread of its own, and until then (or when the ring has no reader slot
+     * left) are sent to directly as usual. Worth it for topics with many local
+     * subscribers. Messages that carry a trace stamp or a deadline (see
+     * setTopicTtl()), and subscribers with SubscribeOptions::max_rate_hz,
+     * still take the direct path; in-process and UDP subscribers are
+     * unaffected. Messages taking different paths may be reordered while a
+     * subscriber attaches.
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param enable true to publish through the ring, false to send to each subscriber (default)
+     * @return Error code; NOT_INITIALIZED without the shared memory transport
+     */
+    virtual Error setTopicBus(const Property& msg_group, const Property& topic, bool enable) = 0;
+
+    /**
+     * @brief Give every message this node publishes on a topic a deadline
+     *
+     * Messages carry their publish time and time-to-live behind the payload
+     * (DEADLINE_DATA frames). A subscriber drops a message that is past its
+     * deadline instead of running the callback: when it is received, and again
+     * when a dispatch worker takes it from the queue, so a backlog of stale
+     * messages is discarded without delaying the fresh ones behind it. These
+     * drops are counted in TopicStats::expired, apart from overflow drops.
+     * On the publisher's host the deadline is exact; a UDP subscriber on
+     * another host counts the time-to-live from the message's arrival.
+     * Reliable UDP topics carry no deadline.
+     * @param msg_group Message group name
+     * @param topic Topic name within the group
+     * @param ttl_us Time-to-live in microseconds (0: messages never expire, the default)
+     * @return Error code
+     */
+    virtual Error setTopicTtl(const Property& msg_group, const Property& topic, uint32_t ttl_us) = 0;
+
+    /**
+     * @brief Publish one message with its own time-to-live (see setTopicTtl())
+     *
+     * Overrides the topic's time-to-live for this message only.
+     * @param ttl_us Time-to-live in microseconds (0: the topic's)
+     * @return Same as publish()
+     */
+    virtual Error publishWithTtl(const Property& msg_group, const Property& topic, const uint8_t* data, size_t size,
+                                 uint32_t ttl_us) = 0;
+
     /**
      * @brief Subscribe to topics within a message group
+     *
+     * Topics are '/'-separated. A "*" segment matches any one segment and a
+     * trailing "#" segment matches the rest of the topic (e.g. "camera/front/#");
+     * unsubscribe a pattern by passing it unchanged.
      * @param msg_group Message group name
-     * @param topics List of topic names to subscribe
+     * @param topics List of topic names (or patterns) to subscribe
      * @param callback Callback function to receive messages
-     * @return Error code
+     * @return Error code (INVALID_ARG if "#" is not the last segment of a pattern)
      */
     virtual Error subscribe(const Property& msg_group, const std::vector<Property>& topics,
                             const Callback& callback) = 0;
 
+    /**
+     * @brief Subscribe to topics within a message group, with options
+     * @param msg_group Message group name
+     * @param topics List of topic names to subscribe
+     * @param callback Callback function to receive messages (shared by the whole group)
+     * @param options Dispatch mode of the listed topics
+     * @return Error code
+     */
+    virtual Error subscribe(const Property& msg_group, const std::vector<Property>& topics, const Callback& callback,
+                            const SubscribeOptions& options) = 0;
+
+    /**
+     * @brief Subscribe to a resolved topic
+     *
+     * Same as subscribe(topic.group(), {topic.topic()}, callback): the callback
+     * applies to the whole group.
+     * @param topic Handle from resolveTopic()
+     * @param callback Callback function to receive messages
+     * @return Error code (INVALID_ARG for an invalid handle)
+     */
+    virtual Error subscribe(const TopicHandle& topic, const Callback& callback) = 0;
+    virtual Error subscribe(const TopicHandle& topic, const Callback& callback, const SubscribeOptions& options) = 0;
+
+    /**
+     * @brief Subscribe to topics for polling instead of a callback
+     *
+     * Messages are queued for the application, which takes them on its own
+     * thread with PollingSubscription::tryTake()/takeBatch() or waits on its
+     * fd() (epoll/select). Like subscribe(), this replaces the group's
+     * callback; unsubscribe() stops the queueing. Include
+     * "nexus/core/PollingSubscription.h" to use the result.
+     * @param capacity Queue capacity in messages (0: PollingSubscription::DEFAULT_CAPACITY)
+     * @return nullptr on invalid arguments, before initialization, or without a file descriptor
+     */
+    virtual std::shared_ptr<PollingSubscription> subscribePolling(const Property& msg_group,
+                                                                  const std::vector<Property>& topics,
+                                                                  size_t capacity = 0) = 0;
+
     /**
      * @brief Unsubscribe from topics within a message group
      * @param msg_group Message group name
@@ -162,6 +589,63 @@ public:
      */
     virtual bool isSubscribed(const Property& msg_group, const Property& topic) const = 0;
 
+    /**
+     * @brief Serve a request/response method
+     *
+     * Remote requests run on this node's call workers (one per dispatch
+     * worker, started by the first serve()), never on a transport receive
+     * thread; a caller in this process runs the handler on its own thread.
+     * The handler may block and may call() other nodes, but a chain of nested
+     * calls that comes back to this node holds one call worker per level.
+     * Requests arriving while 1024 are waiting are answered with QUEUE_FULL.
+     * What the handler writes to @p response is sent back to the caller only.
+     *
+     * @param msg_group Message group name
+     * @param method Method name within the group
+     * @param handler Request handler
+     * @return Error code (ALREADY_EXISTS if this node already serves the method)
+     */
+    virtual Error serve(const Property& msg_group, const Property& method, const MethodHandler& handler) = 0;
+
+    /**
+     * @brief Stop serving a method
+     * @param msg_group Message group name
+     * @param method Method name within the group
+     * @return Error code (NOT_FOUND if the method was not served)
+     */
+    virtual Error unserve(const Property& msg_group, const Property& method) = 0;
+
+    /**
+     * @brief Call a method and wait for its reply
+     *
+     * A server in this process (this node included) is called directly;
+     * otherwise the request goes point-to-point to one serving node (shared
+     * memory preferred over UDP).
+     *
+     * @param msg_group Message group name
+     * @param method Method name within the group
+     * @param request Request payload
+     * @param response Filled with the reply on success
+     * @param timeout_ms Maximum time to wait for the reply
+     * @return NO_ERROR, NOT_FOUND if no node serves the method, TIMEOUT,
+     *         QUEUE_FULL if the server's queue had no room for the request
+     */
+    virtual Error call(const Property& msg_group, const Property& method, const Property& request,
+                       Property& response, uint32_t timeout_ms) = 0;
+
+    /**
+     * @brief Call a method without waiting for the reply
+     *
+     * If NO_ERROR is returned, @p callback runs exactly once: with the reply
+     * (on the receive thread that got it, or on this thread for a server in
+     * this process), or with TIMEOUT once @p timeout_ms has passed. It must
+     * not block.
+     *
+     * @return Error code, as for call(); the callback is not run on failure
+     */
+    virtual Error callAsync(const Property& msg_group, const Property& method, const Property& request,
+                            uint32_t timeout_ms, const ReplyCallback& callback) = 0;
+
     /**
      * @brief Send large data with simplified API
      *
@@ -192,6 +676,18 @@ public:
     virtual Error sendLargeData(const std::string& msg_group, const std::string& channel_name, const std::string& topic,
                                 const uint8_t* data, size_t size) = 0;
 
+    /**
+     * @brief Write large data without publishing a notification
+     *
+     * Readers that use subscribeLargeData() are woken by the channel itself,
+     * so the block skips the message pipeline (no MessageBuilder, shared-memory
+     * queue space or worker thread per frame).
+     *
+     * @return As for sendLargeData()
+     */
+    virtual Error writeLargeData(const std::string& channel_name, const std::string& topic, const uint8_t* data,
+                                 size_t size) = 0;
+
     /**
      * @brief Get or create a large data channel for reading/writing
      *
@@ -207,6 +703,61 @@ public:
      */
     virtual std::shared_ptr<LargeDataChannel> getLargeDataChannel(const std::string& channel_name) = 0;
 
+    /**
+     * @brief Receive every block written to a large data channel, without notifications
+     *
+     * A dedicated thread blocks on the channel's doorbell (LargeDataChannel::waitForData)
+     * and runs @p callback for each block, in order. It reads through its own
+     * reader slot, independent of getLargeDataChannel(). Works with any writer,
+     * whether or not it also publishes notifications.
+     *
+     * @return ALREADY_EXISTS if this node already reads the channel
+     */
+    virtual Error subscribeLargeData(const std::string& channel_name, LargeDataCallback callback) = 0;
+
+    /**
+     * @brief Stop the reader thread started by subscribeLargeData()
+     * @return NOT_FOUND if the channel is not subscribed
+     */
+    virtual Error unsubscribeLargeData(const std::string& channel_name) = 0;
+
+    /**
+     * @brief Forward every block of a local large data channel to nodes on other hosts
+     *
+     * A reader thread (as for subscribeLargeData()) copies each block, stream
+     * chunks included, out of the ring and publishes it on group
+     * LARGE_DATA_BRIDGE_GROUP, topic @p channel_name, which is made reliable
+     * (see setTopicReliable()). Nodes that called importLargeData() for the
+     * channel receive the blocks; with UDP the channel is also advertised as
+     * a LARGE_DATA service, so findLargeDataChannels() lists it remotely.
+     * Blocks the ring overwrote while they were being copied are skipped.
+     *
+     * @return ALREADY_EXISTS if this node already bridges the channel
+     */
+    virtual Error bridgeLargeData(const std::string& channel_name) = 0;
+
+    /**
+     * @brief Stop the bridge started by bridgeLargeData()
+     * @return NOT_FOUND if the channel is not bridged
+     */
+    virtual Error unbridgeLargeData(const std::string& channel_name) = 0;
+
+    /**
+     * @brief Receive a channel bridged by another node into a local large data channel
+     *
+     * Blocks are written, in the order the bridge sent them, to the local
+     * channel @p local_name (default: @p channel_name), so readers use
+     * getLargeDataChannel()/tryRead() or subscribeLargeData() as for a local
+     * writer. Sequence numbers are those of the local channel. Stop with
+     * unsubscribe(LARGE_DATA_BRIDGE_GROUP, {channel_name}).
+     *
+     * @return ALREADY_EXISTS if this node already imports the channel
+     */
+    virtual Error importLargeData(const std::string& channel_name, const std::string& local_name = "") = 0;
+
+    // Message group bridged large data channels are published on (topic = channel name)
+    static constexpr const char* LARGE_DATA_BRIDGE_GROUP = "_large_data_bridge";
+
     /**
      * @brief Set message queue overflow policy (for normal pub/sub messages)
      * @param policy Overflow policy (default: DROP_OLDEST)
@@ -219,6 +770,68 @@ public:
      */
     virtual void setQueueOverflowCallback(QueueOverflowCallback callback) = 0;
 
+    /**
+     * @brief Set the watermarks of setWatermarkCallback(), in percent of each queue's capacity
+     *
+     * Defaults: Config::node.watermark_high_percent / watermark_low_percent.
+     * A queue reports "high" once when its fill reaches @p high_percent and
+     * "low" once when it is back at @p low_percent or below.
+     * @return INVALID_ARG unless low_percent < high_percent <= 100
+     */
+    virtual Error setWatermarks(uint32_t high_percent, uint32_t low_percent) = 0;
+
+    /**
+     * @brief Report queues that fill up before they overflow
+     *
+     * Covers the dispatch queue of every subscribed topic (checked as messages
+     * are queued and drained), the shared memory lanes this node sends on and
+     * the large data channels it writes (sampled every
+     * Config::node.watermark_poll_ms). Publishers can shed load or lower
+     * quality on "high" instead of finding out from QueueOverflowCallback.
+     * @param callback nullptr turns watermark tracking off
+     */
+    virtual void setWatermarkCallback(WatermarkCallback callback) = 0;
+
+    /**
+     * @brief Suggested delay before retrying after a QUEUE_FULL publish
+     *
+     * Refers to the calling thread's last publish (any node): the time the
+     * slowest full subscriber took to drain its last batch, or the shared-memory
+     * congestion backoff.
+     * @return Microseconds; 0 if that publish did not return QUEUE_FULL
+     */
+    virtual uint32_t getRetryHintUs() const = 0;
+
+    /**
+     * @brief Per-topic counters of this node, for the topics it published or received
+     *
+     * Counting costs the publish and dispatch paths one uncontended atomic add
+     * per counter (per-thread shards); the shards are summed here, on demand.
+     * @return One entry per topic with any non-zero counter
+     */
+    virtual std::vector<TopicStats> getTopicStats() const = 0;
+
+    /**
+     * @brief Per-topic latency histograms of this node's deliveries
+     *
+     * Only collected with Config::NodeConfig::latency_tracing: senders then
+     * stamp DATA frames (TRACED_DATA) with their CLOCK_MONOTONIC send time,
+     * and receivers time each stage of delivery. Reliable UDP topics carry no
+     * stamp (no transit stage). Enable it on every node of a system at once:
+     * receivers older than TRACED_DATA ignore traced UDP and full shm frames.
+     * @return One entry per topic with any sample
+     */
+    virtual std::vector<TopicLatency> getTopicLatency() const = 0;
+
+    /**
+     * @brief Mapped and resident memory of this node's segments and channels, plus its queue heap
+     *
+     * Samples page residency with mincore() over every mapping (a few
+     * microseconds per MB mapped): meant for diagnostics and sizing, not for
+     * a hot path.
+     */
+    virtual MemoryUsage getMemoryUsage() const = 0;
+
     /**
      * @brief Cleanup orphaned shared memory channels
      * Should be called periodically or at startup
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <netinet/in.h>
+
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -9,18 +12,33 @@
 #include <queue>
 #include <set>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "nexus/core/Config.h"
 #include "nexus/core/Message.h"
 #include "nexus/core/Node.h"
+#include "nexus/core/PollingSubscription.h"
 #include "nexus/transport/LargeDataChannel.h"
+#include "nexus/utils/BoundedQueue.h"
+#include "nexus/utils/EpochSnapshot.h"
+#include "nexus/utils/MaintenanceScheduler.h"
+#include "nexus/utils/MessagePool.h"
+#include "nexus/utils/MetricsSegment.h"
+#include "nexus/utils/ShardedCounters.h"
+#include "nexus/utils/StringView.h"
+#include "nexus/utils/TopicTrie.h"
 
 namespace Nexus {
 namespace rpc {
 
 // Forward declarations
 class UdpTransport;
+class ReliableUdpChannel;
 class SharedMemoryTransportV3;
+class RpcServer;
+class TopicBus;
+class TopicBusReaders;
 
 /**
  * @brief Node implementation supporting both in-process and inter-process communication
@@ -28,9 +46,14 @@ class SharedMemoryTransportV3;
 class NodeImpl : public Node, public std::enable_shared_from_this<NodeImpl> {
     // Friend class to allow SharedMemoryTransportV3 to call handleNodeEvent
     friend class SharedMemoryTransportV3;
+    // Sends calls and replies through the node's transports
+    friend class RpcServer;
+    // Topic bus rings and their reader threads (see setTopicBus())
+    friend class TopicBus;
+    friend class TopicBusReaders;
 
 public:
-    static constexpr size_t NUM_PROCESSING_THREADS = 4;  // Thread pool size (for QueueStats)
+    static constexpr size_t MAX_PROCESSING_THREADS = 64;  // Upper bound for Config::node.num_processing_threads
 
     NodeImpl(const std::string& node_id, bool use_udp, uint16_t udp_port,
              TransportMode transport_mode = TransportMode::AUTO);
@@ -42,21 +65,83 @@ public:
     // Node interface implementation
     Error publish(const Property& msg_group, const Property& topic, const Property& payload) override;
 
+    TopicHandle resolveTopic(const Property& msg_group, const Property& topic) override;
+
+    Error publish(const TopicHandle& topic, const Property& payload) override;
+
+    Error publish(const Property& msg_group, const Property& topic, const uint8_t* data, size_t size) override;
+
+    Error publishv(const Property& msg_group, const Property& topic, const PayloadSegment* segments,
+                   size_t count) override;
+
+    Error publishInPlace(const Property& msg_group, const Property& topic, size_t payload_size,
+                         const PayloadWriter& writer) override;
+
+    Error publishBatch(const Property& msg_group, const Property& topic,
+                       const std::vector<Property>& payloads) override;
+
+    Error setTopicPriority(const Property& msg_group, const Property& topic, MessagePriority priority) override;
+
+    Error setTopicReliable(const Property& msg_group, const Property& topic, bool reliable) override;
+
+    Error setTopicBus(const Property& msg_group, const Property& topic, bool enable) override;
+
+    Error setTopicTtl(const Property& msg_group, const Property& topic, uint32_t ttl_us) override;
+
+    Error publishWithTtl(const Property& msg_group, const Property& topic, const uint8_t* data, size_t size,
+                         uint32_t ttl_us) override;
+
     Error subscribe(const Property& msg_group, const std::vector<Property>& topics, const Callback& callback) override;
 
+    Error subscribe(const Property& msg_group, const std::vector<Property>& topics, const Callback& callback,
+                    const SubscribeOptions& options) override;
+
+    Error subscribe(const TopicHandle& topic, const Callback& callback) override;
+
+    Error subscribe(const TopicHandle& topic, const Callback& callback, const SubscribeOptions& options) override;
+
+    std::shared_ptr<PollingSubscription> subscribePolling(const Property& msg_group,
+                                                          const std::vector<Property>& topics,
+                                                          size_t capacity = 0) override;
+
     Error unsubscribe(const Property& msg_group, const std::vector<Property>& topics) override;
 
     bool isSubscribed(const Property& msg_group, const Property& topic) const override;
 
+    // Request/response RPC
+    Error serve(const Property& msg_group, const Property& method, const MethodHandler& handler) override;
+
+    Error unserve(const Property& msg_group, const Property& method) override;
+
+    Error call(const Property& msg_group, const Property& method, const Property& request, Property& response,
+               uint32_t timeout_ms) override;
+
+    Error callAsync(const Property& msg_group, const Property& method, const Property& request, uint32_t timeout_ms,
+                    const ReplyCallback& callback) override;
+
     // Large data channel support
     Error sendLargeData(const std::string& msg_group, const std::string& channel_name, const std::string& topic,
                         const uint8_t* data, size_t size) override;
 
+    Error writeLargeData(const std::string& channel_name, const std::string& topic, const uint8_t* data,
+                         size_t size) override;
     std::shared_ptr<LargeDataChannel> getLargeDataChannel(const std::string& channel_name) override;
+    Error subscribeLargeData(const std::string& channel_name, LargeDataCallback callback) override;
+    Error unsubscribeLargeData(const std::string& channel_name) override;
+    Error bridgeLargeData(const std::string& channel_name) override;
+    Error unbridgeLargeData(const std::string& channel_name) override;
+    Error importLargeData(const std::string& channel_name, const std::string& local_name = "") override;
 
     // Queue overflow management
     void setQueueOverflowPolicy(QueueOverflowPolicy policy) override;
     void setQueueOverflowCallback(QueueOverflowCallback callback) override;
+    Error setWatermarks(uint32_t high_percent, uint32_t low_percent) override;
+    void setWatermarkCallback(WatermarkCallback callback) override;
+    uint32_t getRetryHintUs() const override;
+
+    std::vector<TopicStats> getTopicStats() const override;
+    std::vector<TopicLatency> getTopicLatency() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     // Cleanup orphaned channels
     size_t cleanupOrphanedChannels() override;
@@ -73,19 +158,30 @@ public:
 
     // Performance statistics
     struct QueueStats {
-        size_t queue_depth[NUM_PROCESSING_THREADS];  // Current depth per thread
-        size_t total_dropped;                        // Total dropped messages
+        std::vector<size_t> queue_depth;  // Current depth per dispatch worker (lanes by home worker)
+        size_t total_dropped;             // Total dropped messages
+        size_t total_expired;             // Total messages dropped past their deadline
     };
     QueueStats getQueueStats() const;
 
+    // RPC replies that could not be sent back to their caller (caller gone or its queue full)
+    size_t getFailedReplyCount() const;
+
+    // Number of dispatch workers (Config::node.num_processing_threads at construction)
+    size_t getProcessingThreadCount() const { return run_queues_.size(); }
+
     // Internal methods
     std::string getNodeId() const { return node_id_; }
     uint16_t getUdpPort() const;
 
 private:
-    // Message handling
-    void handleMessage(const std::string& source_node_id, const std::string& group, const std::string& topic,
-                       const uint8_t* payload, size_t payload_len);
+    // Message handling (names point into the received packet)
+    // @p deadline_ns: TraceStamp clock after which the message is dropped undelivered (0: none)
+    void handleMessage(StringView source_node_id, StringView group, StringView topic, const uint8_t* payload,
+                       size_t payload_len, uint64_t deadline_ns = 0);
+    // false if the message was not queued (overflow), see enqueueMessage()
+    bool handleMessage(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                       SharedPayload* shared = nullptr, uint64_t deadline_ns = 0);
 
     void handleSubscribe(const std::string& remote_node_id, uint16_t remote_port, const std::string& remote_addr,
                          const std::string& group, const std::string& topic);
@@ -106,23 +202,104 @@ private:
     // In-process delivery
     void deliverInProcess(const std::string& group, const std::string& topic, const uint8_t* payload,
                           size_t payload_len);
+    // false if a peer's queue had no room for the message (QUEUE_FULL to the publisher)
+    bool deliverInProcess(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                          uint64_t deadline_ns = 0);
+
+    // Unicast UDP peer; datagrams sent to it double as our liveness, so it needs no heartbeat while busy
+    struct UdpPeer {
+        sockaddr_in addr;
+        std::atomic<int64_t> last_sent_ms{0};  // Steady clock (ms) of the last datagram sent to it
+    };
+
+    // Publisher-side decimation towards one subscriber of one topic (SubscribeOptions::max_rate_hz)
+    struct RateLimit {
+        explicit RateLimit(uint32_t interval_us) : interval_ns(static_cast<uint64_t>(interval_us) * 1000) {}
+
+        // true if a message may be sent at @p now_ns; concurrent publishers admit one message per interval
+        bool admit(uint64_t now_ns);
 
-    // Inter-process delivery (via shared memory or UDP)
-    void deliverInterProcess(const std::vector<uint8_t>& packet, const std::string& group, const std::string& topic);
+        const uint64_t interval_ns;
+        std::atomic<uint64_t> next_ns{0};  // TraceStamp clock; a route rebuild starts over
+    };
+
+    // Inter-process subscribers of one topic, split by transport
+    struct InterProcessTargets {
+        struct ShmTarget {
+            std::string node_id;
+            uint32_t handle;    // SharedMemoryTransportV3::NodeHandle (connection resolved at build time)
+            uint32_t topic_id;  // Subscriber's topic id (compact frames), or ServiceDescriptor::NO_TOPIC_ID
+            uint32_t lane;      // Data lane (MessagePriority) of this subscriber's frames
+            std::shared_ptr<RateLimit> rate_limit;  // Null: every message
+        };
+        uint64_t route_version = 0;                       // GlobalRegistry route version this was built from
+        uint32_t topic_hash = 0;                          // CompactPacket::topicHash() of the topic
+        bool reliable = false;                            // UDP subscribers are served by the reliable channel
+        uint64_t ttl_ns = 0;                              // setTopicTtl() (0: messages never expire)
+        std::vector<ShmTarget> shm_subscribers;
+        std::vector<sockaddr_in> udp_subscribers;         // Pre-resolved addresses
+        std::vector<std::shared_ptr<UdpPeer>> udp_peers;  // Unicast entries of udp_subscribers
+        // Per udp_peers entry (null: every message); empty if no UDP subscriber is limited
+        std::vector<std::shared_ptr<RateLimit>> udp_rate_limits;
+        bool rate_limited = false;  // Some subscriber has a rate limit
+        std::shared_ptr<TopicBus> bus;           // setTopicBus() (null: none)
+        std::vector<ShmTarget> bus_subscribers;  // Reading the bus (sent to directly when a frame bypasses it)
+        uint16_t bus_readers = 0;                // Their reader slots (LargeDataHeader::reader_mask)
+
+        bool empty() const { return shm_subscribers.empty() && udp_subscribers.empty() && bus_subscribers.empty(); }
+    };
+    using InterProcessRoute = std::shared_ptr<const InterProcessTargets>;
+
+    // Cached route of a topic; rebuilt only when the GlobalRegistry route version changes
+    // (SERVICE_ADDED/REMOVED, NODE_JOINED/LEFT, lost connection)
+    InterProcessRoute interProcessRoute(const TopicHandle& topic);
+
+    // Resolve inter-process subscribers from the service registry (route rebuild);
+    // false if a shm subscriber could not be connected yet
+    bool collectInterProcessTargets(const std::string& group, const std::string& topic, InterProcessTargets& targets);
+
+    // Trailer of the frames of a publish to @p targets: send time if traced, deadline if the message has a TTL
+    DataTrailer publishTrailer(const InterProcessTargets& targets) const;
+
+    // Inter-process delivery (via shared memory or UDP); QUEUE_FULL if a shm subscriber had no credit,
+    // TIMEOUT if a reliable UDP subscriber stopped acknowledging (reliable frames carry no trailer)
+    Error deliverInterProcess(const InterProcessTargets& targets, const std::string& group, const std::string& topic,
+                              const uint8_t* payload, size_t payload_len, const DataTrailer& trailer);
+    // Gathering variant: segments are copied straight into each frame
+    Error deliverInterProcess(const InterProcessTargets& targets, const std::string& group, const std::string& topic,
+                              const PayloadSegment* segments, size_t count, size_t payload_len,
+                              const DataTrailer& trailer);
+    // UDP subscribers of @p targets a message sent at @p now_ns goes to: all, unless some are rate limited
+    static const std::vector<sockaddr_in>& admittedUdpSubscribers(const InterProcessTargets& targets,
+                                                                  uint64_t now_ns);
+    // Reliable topic: one fragmented message per UDP subscriber
+    Error sendReliable(const std::vector<sockaddr_in>& subscribers, const std::string& group,
+                       const std::string& topic, const uint8_t* payload, size_t payload_len);
+
+    // Common publish path for a contiguous payload (in-process, then inter-process)
+    Error publishPayload(const TopicHandle& topic, const uint8_t* payload, size_t payload_len);
+
+    // Classify a failed shm send: QUEUE_FULL (with retry hint) if out of credit, otherwise the route is stale
+    Error shmSendFailed(uint32_t handle, size_t frame_size, uint32_t lane);
+
+    // True if another node of this process subscribes @p topic (or has a wildcard in its group)
+    bool hasInProcessSubscribers(const TopicHandle& topic) const;
+    static bool listedNode(const std::vector<std::weak_ptr<NodeImpl>>& list, const std::weak_ptr<NodeImpl>& node);
 
     // Send subscription registration to all nodes
     void broadcastSubscription(const std::string& group, const std::string& topic, bool is_subscribe);
 
     // Async message processing
+    // Trivially copyable: strings are interned, payload is one reference to a payloadPool() buffer
     struct PendingMessage {
-        std::string source_node_id;
-        std::string group;
-        std::string topic;
-        std::vector<uint8_t> payload;
+        TopicHandle topic;
+        SharedPayload payload;
+        uint64_t enqueue_ns = 0;   // TraceStamp::now() when queued (latency tracing only)
+        uint64_t deadline_ns = 0;  // TraceStamp clock after which the worker drops it (0: none)
     };
 
     // System message processing (SERVICE_REGISTER/UNREGISTER, NODE_JOIN/LEAVE)
-    enum class SystemMessageType { SERVICE_REGISTER, SERVICE_UNREGISTER, NODE_JOIN, NODE_LEAVE };
+    enum class SystemMessageType { SERVICE_REGISTER, SERVICE_UNREGISTER, SERVICE_SNAPSHOT, NODE_JOIN, NODE_LEAVE };
 
     struct SystemMessage {
         SystemMessageType type;
@@ -134,17 +311,49 @@ private:
 
     void messageProcessingThread(size_t thread_id);
     void systemMessageThread();  // Dedicated thread for system messages
-    void enqueueMessage(const std::string& source_node_id, const std::string& group, const std::string& topic,
-                        const uint8_t* payload, size_t payload_len);
-    void enqueueSystemMessage(SystemMessageType type, const std::string& source_node_id, const std::string& group,
-                              const std::string& topic, const uint8_t* payload, size_t payload_len);
+    // By name, straight from a packet: unsubscribed topics are rejected without allocating
+    void enqueueMessage(StringView source_node_id, StringView group, StringView topic, const uint8_t* payload,
+                        size_t payload_len, uint64_t deadline_ns = 0);
+    // Queue on the topic's lane, or run the callback right away for INLINE subscriptions;
+    // false if the message itself was dropped (DROP_NEWEST, or BLOCK timed out).
+    // @p shared: copy of this message shared with other in-process deliveries (made on first use)
+    // @p deadline_ns: an expired message is dropped here, or by the worker if it expires while queued
+    bool enqueueMessage(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                        SharedPayload* shared = nullptr, uint64_t deadline_ns = 0);
+    // Count a message dropped past its deadline
+    void countExpired(uint32_t topic_id, size_t count = 1);
+    void enqueueSystemMessage(SystemMessageType type, StringView source_node_id, StringView group, StringView topic,
+                              const uint8_t* payload, size_t payload_len);
 
     // Subscription management
+    using TopicMatcher = TopicTrie<DispatchMode>;
     struct SubscriptionInfo {
-        std::set<std::string> topics;  // Topics within this group
-        Callback callback;             // Callback for this group
+        std::set<std::string> topics;                  // Topics within this group
+        std::map<std::string, DispatchMode> patterns;  // Wildcard topics ("a/*", "a/#") and their dispatch mode
+        std::shared_ptr<const TopicMatcher> matcher;   // patterns compiled (nullptr if none)
+        std::shared_ptr<const Callback> callback;      // Callback for this group (shared with the dispatch snapshot)
+        std::shared_ptr<PollingSubscription> polling;  // subscribePolling(): queued for the application instead
     };
 
+    // Per-topic subscription entry (topic_subscriptions_)
+    struct TopicSubscription {
+        SubscriptionInfo* info = nullptr;  // Owning group's entry in subscriptions_ (nullptr if not subscribed)
+        DispatchMode dispatch = DispatchMode::QUEUED;
+        bool matched = false;  // Subscribed by a wildcard pattern, not by name
+    };
+
+    // subscribe() / subscribePolling(): exactly one of @p callback and @p polling is set
+    Error addSubscription(const Property& msg_group, const std::vector<Property>& topics,
+                          std::shared_ptr<const Callback> callback, std::shared_ptr<PollingSubscription> polling,
+                          const SubscribeOptions& options);
+    // Requires subscriptions_mutex_ (exclusive); creates the topic's lane on first use
+    void addTopicSubscription(const TopicHandle& topic, SubscriptionInfo* info, DispatchMode dispatch, bool matched);
+    // Drop the pattern-matched topics of a group that its patterns no longer match (all of them if @p all)
+    void dropMatchedTopics(const SubscriptionInfo* info, bool all);
+    // First message on a topic matching a wildcard subscription: subscribe the topic itself;
+    // false if no pattern matches (any more)
+    bool subscribeMatchedTopic(const TopicHandle& topic);
+
     // Remote node subscription info (UDP nodes)
     struct RemoteNodeInfo {
         std::string node_id;
@@ -152,16 +361,31 @@ private:
         uint16_t port;
         std::set<SubscriptionKey> subscriptions;               // What this remote node subscribed to
         std::chrono::steady_clock::time_point last_heartbeat;  // Last heartbeat time
+        int64_t min_clock_delta_ns = INT64_MAX;  // Smallest receive - send time of its traced frames
     };
 
     // UDP heartbeat management
-    void startUdpHeartbeat();   // Start UDP heartbeat thread
-    void stopUdpHeartbeat();    // Stop UDP heartbeat thread
-    void udpHeartbeatThread();  // UDP heartbeat worker thread
-    void sendUdpHeartbeat();    // Send heartbeat to all UDP nodes
+    void startUdpHeartbeat();  // Schedule the UDP heartbeat / timeout task
+    void stopUdpHeartbeat();   // Cancel it (waits for a run in progress)
+    void sendUdpHeartbeat();    // Send heartbeat to UDP peers we sent nothing else to within the interval
     void handleUdpHeartbeat(const std::string& from_node, const std::string& from_addr, uint16_t from_port);
+    // Any other packet from a UDP node proves it alive as well (one map lookup, no copies)
+    void noteUdpTraffic(StringView from_node, const sockaddr_in& from, uint16_t from_port);
+    // Transit of a traced UDP frame, relative to the fastest one seen from that node (-1: node unknown)
+    int64_t udpTransitNs(StringView from_node, uint64_t send_ns, uint64_t receive_ns);
     void checkUdpTimeouts();  // Check and clean up timed-out UDP nodes
 
+    // Shared peer entry for @p addr (created on first use)
+    std::shared_ptr<UdpPeer> udpPeer(const sockaddr_in& addr);
+    // Stamp the unicast peers of a route after sending to them
+    static void markUdpPeersSent(const InterProcessTargets& targets);
+
+    // UDP multicast (Config::transport.udp_multicast): each topic hashes into one group bucket
+    std::string multicastAddress(const std::string& group, const std::string& topic) const;  // "IP:port" or empty
+    std::string joinTopicMulticast(const std::string& group, const std::string& topic);  // Address joined, or empty
+    void leaveTopicMulticast(const std::string& group, const std::string& topic);
+    void handleMulticastPacket(const uint8_t* data, size_t size);
+
 private:
     std::string node_id_;
     bool use_udp_;
@@ -171,19 +395,82 @@ private:
     // Local subscriptions: group -> SubscriptionInfo
     mutable std::shared_timed_mutex subscriptions_mutex_;
     std::map<std::string, SubscriptionInfo> subscriptions_;
+    // Topic id -> subscription and dispatch mode (source of subscription_snapshot_)
+    std::vector<TopicSubscription> topic_subscriptions_;
+
+    // Served methods and outstanding calls (declared before the transports, which call into it)
+    std::unique_ptr<RpcServer> rpc_server_;
 
     // Remote nodes registry: node_id -> RemoteNodeInfo
     mutable std::mutex remote_nodes_mutex_;
-    std::map<std::string, RemoteNodeInfo> remote_nodes_;
+    std::map<std::string, RemoteNodeInfo, std::less<>> remote_nodes_;
+
+    // UDP peers by address (see udpPeer()); the heartbeat list is rebuilt only when the route version changes
+    std::mutex udp_peers_mutex_;
+    std::map<uint64_t, std::shared_ptr<UdpPeer>> udp_peers_;
+    std::vector<std::shared_ptr<UdpPeer>> udp_heartbeat_peers_;  // Endpoints of all remote UDP services
+    uint64_t udp_heartbeat_version_ = 0;                          // Route version of udp_heartbeat_peers_
 
     // Transport layers
     std::unique_ptr<UdpTransport> udp_transport_;                // For remote communication
+    std::unique_ptr<UdpTransport> multicast_transport_;          // Receives the multicast groups of our topics
+    std::unique_ptr<ReliableUdpChannel> reliable_udp_;           // Reliable topics, over udp_transport_
     std::unique_ptr<SharedMemoryTransportV3> shm_transport_v3_;  // For local communication (dynamic)
+    ChecksumType shm_checksum_;                                  // Checksum of DATA frames sent over shm
+    ChecksumType udp_checksum_;                                  // Checksum of DATA packets sent over UDP
+
+    // Multicast membership: topics joined, and how many of them hash into each group address
+    std::mutex multicast_mutex_;
+    std::set<SubscriptionKey> multicast_topics_;
+    std::map<std::string, int> multicast_groups_;
+
+    // Inter-process route cache: topic id -> route (see interProcessRoute())
+    std::mutex routes_mutex_;
+    std::vector<InterProcessRoute> routes_;
+    std::vector<MessagePriority> publish_priorities_;  // setTopicPriority(), by topic id (guarded by routes_mutex_)
+    std::vector<bool> reliable_topics_;                // setTopicReliable(), by topic id (guarded by routes_mutex_)
+    std::vector<uint64_t> topic_ttls_;                 // setTopicTtl() in ns, by topic id (guarded by routes_mutex_)
+    // setTopicBus(), by topic id (guarded by routes_mutex_)
+    std::vector<std::shared_ptr<TopicBus>> topic_buses_;
 
     // Large data channels: channel_name -> LargeDataChannel
     mutable std::mutex large_channels_mutex_;
     std::map<std::string, std::shared_ptr<LargeDataChannel>> large_channels_;
 
+    // subscribeLargeData() and bridgeLargeData(): one reader thread per channel, woken by the channel doorbell
+    struct LargeDataReader {
+        std::shared_ptr<LargeDataChannel> channel;  // Own reader slot
+        LargeDataCallback callback;
+        // Bridge: handed each block instead of callback, releases it itself
+        std::function<void(LargeDataChannel& channel, const LargeDataChannel::DataBlock& block)> forward;
+        ThreadPlacement placement;  // Config::threads.large_data of the owning node
+        std::atomic<bool> running{true};
+        std::thread thread;
+    };
+    mutable std::mutex large_readers_mutex_;
+    std::map<std::string, std::shared_ptr<LargeDataReader>> large_readers_;  // Shared with the reader thread
+    std::map<std::string, std::shared_ptr<LargeDataReader>> large_bridges_;  // bridgeLargeData() (same mutex)
+    static void largeDataReaderThread(const std::string& channel_name, std::shared_ptr<LargeDataReader> reader);
+    static std::shared_ptr<LargeDataReader> openLargeDataReader(const std::string& channel_name);
+    static void stopLargeDataReader(std::shared_ptr<LargeDataReader> reader);
+
+    // Topic buses of other processes read for our subscriptions (see setTopicBus())
+    std::unique_ptr<TopicBusReaders> topic_bus_readers_;
+
+    // importLargeData(): bridged blocks rewritten into a local channel
+    struct LargeDataImport {
+        std::shared_ptr<LargeDataChannel> channel;
+        std::mutex mutex;  // Blocks may arrive on several receive threads
+    };
+    void forwardLargeBlock(const std::string& channel_name, LargeDataChannel& channel,
+                           const LargeDataChannel::DataBlock& block, std::vector<uint8_t>& buffer);
+    static void importLargeBlock(const std::string& local_name, LargeDataImport& import, const uint8_t* payload,
+                                 size_t size);
+    ServiceDescriptor largeDataBridgeService(const std::string& channel_name) const;
+    static LargeDataChannel::Config largeDataChannelConfig();
+    Error writeLargeBlock(const std::string& channel_name, const std::string& topic, const uint8_t* data, size_t size,
+                          int64_t& seq);  // sendLargeData()/writeLargeData() without the notification
+
     // Service discovery helpers
     void registerService(const ServiceDescriptor& svc);
     void unregisterService(const ServiceDescriptor& svc);
@@ -193,6 +480,10 @@ private:
     void handleServiceUpdate(const std::string& from_node, const ServiceDescriptor& svc, bool is_add);
     void handleServiceMessage(const std::string& from_node, const std::string& group, const std::string& topic,
                               const uint8_t* payload, size_t payload_len, bool is_register);
+    void requestServiceSnapshot(const std::string& to_node, uint32_t known_version);  // Versioned service query
+    void sendServiceSnapshot(const std::string& to_node, uint32_t known_version);
+    void handleServiceSnapshot(const std::string& from_node, const uint8_t* payload, size_t payload_len);
+    bool noteServiceVersion(const std::string& from_node, uint32_t version);  // False if the update is stale
     void handleNodeEvent(const std::string& from_node, bool is_joined);
     void notifyNodeEvent(ServiceEvent event, const std::string& node_id);
 
@@ -200,12 +491,145 @@ private:
     void processPacket(const uint8_t* data, size_t size, const std::string& from);
 
     // Async message processing
+    static constexpr size_t MAX_POOLED_MESSAGES = 8192;  // Fixed 2KB payload slots (16MB high-water mark)
+    // Process-wide (never destroyed): payloads are shared by the queues of several nodes
+    static MessagePool& payloadPool();
     static constexpr size_t MAX_QUEUE_SIZE = 25000;  // Max messages per queue (increased for high throughput)
-    mutable std::mutex message_queue_mutexes_[NUM_PROCESSING_THREADS];
-    std::condition_variable message_queue_cvs_[NUM_PROCESSING_THREADS];
-    std::queue<PendingMessage> message_queues_[NUM_PROCESSING_THREADS];  // One queue per thread
+
+    // Per-topic FIFO of pending messages. A lane is drained by at most one worker at a time
+    // (scheduled flag), so per-topic order holds even when idle workers steal it.
+    // Producers: receive threads and in-process publishers; consumer: the worker (and drop-oldest overflow)
+    struct TopicLane {
+        TopicLane(const TopicHandle& handle, size_t capacity) : topic(handle), messages(capacity) {}
+        ~TopicLane() {
+            // Payload references are manual: return whatever is still queued to the pool
+            PendingMessage msg;
+            while (messages.tryPop(msg)) {
+                msg.payload.release();
+            }
+            latest.payload.release();
+        }
+        TopicHandle topic;
+        BoundedMpmcQueue<PendingMessage> messages;  // Config::node.per_topic_queue_size slots, fixed at creation
+        std::atomic<bool> scheduled{false};         // In a run queue or being drained by a worker
+        EventCount space;                           // BLOCK policy: wakes producers after a batch is drained
+        std::atomic<uint32_t> batch_time_us{0};     // Duration of the last drained batch (retry hint)
+        std::atomic<bool> above_high{false};        // Reported "high" to the watermark callback, not yet "low"
+        // DispatchMode::LATEST: newest undelivered message, overwritten in place
+        std::mutex latest_mutex;
+        PendingMessage latest;  // Guarded by latest_mutex
+        std::atomic<bool> has_latest{false};
+
+        bool hasPending() const { return has_latest.load(std::memory_order_acquire) || !messages.empty(); }
+        bool takeLatest(PendingMessage& msg) {
+            if (!has_latest.load(std::memory_order_acquire)) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(latest_mutex);
+            msg = latest;
+            latest = PendingMessage();
+            has_latest.store(false, std::memory_order_release);
+            return msg.topic.valid();
+        }
+    };
+    // Queue @p msg on @p lane if both the lane's ring and the node-wide limit have room
+    bool tryQueueOnLane(TopicLane& lane, PendingMessage& msg, size_t max_queue_size);
+    // Release the messages still queued on @p lane (unsubscribed topic or shutdown)
+    void discardLane(TopicLane& lane);
+    // BLOCK policy: wait (bounded by Config::node.block_timeout_ms) until @p msg fits into @p lane
+    bool waitForLaneSpace(TopicLane& lane, PendingMessage& msg, size_t max_queue_size);
+    // Messages queued on all lanes (LATEST slots excluded), bounded by Config::node.max_queue_size
+    std::atomic<size_t> pending_messages_{0};
+    EventCount pending_space_;  // BLOCK policy: wakes producers held by the node-wide limit
+    // Topic id -> lane (created on first subscribe, kept until destruction); guarded by subscriptions_mutex_
+    std::vector<std::unique_ptr<TopicLane>> lanes_;
+
+    /**
+     * @brief Immutable per-topic view of the subscriptions (dispatch fast path)
+     *
+     * Rebuilt under subscriptions_mutex_ whenever a subscription changes and
+     * published through subscription_snapshot_. enqueueMessage() and the
+     * workers only read it: no lock, and callbacks are shared, not copied.
+     */
+    struct SubscriptionSnapshot {
+        struct Entry {
+            std::shared_ptr<const Callback> callback;        // nullptr if not subscribed (or polled)
+            std::shared_ptr<PollingSubscription> polling;  // Set instead of callback by subscribePolling()
+            DispatchMode dispatch = DispatchMode::QUEUED;
+            TopicLane* lane = nullptr;
+
+            bool subscribed() const { return callback || polling; }
+        };
+        std::vector<Entry> by_topic;  // Indexed by topic id
+        // group -> topic -> topic id of the subscribed topics; transparent comparators allow lookup by StringView
+        std::map<std::string, std::map<std::string, uint32_t, std::less<>>, std::less<>> ids;
+        // group -> wildcard subscriptions of the group (topics matched by none are not subscribed)
+        std::map<std::string, std::shared_ptr<const TopicMatcher>, std::less<>> patterns;
+
+        const Entry* find(uint32_t topic_id) const {
+            return (topic_id < by_topic.size() && by_topic[topic_id].subscribed()) ? &by_topic[topic_id] : nullptr;
+        }
+
+        const Entry* find(StringView group, StringView topic) const {
+            auto group_it = ids.find(group);
+            if (group_it == ids.end()) {
+                return nullptr;
+            }
+            auto topic_it = group_it->second.find(topic);
+            return topic_it != group_it->second.end() ? find(topic_it->second) : nullptr;
+        }
+
+        bool matchesPattern(StringView group, StringView topic) const {
+            auto group_it = patterns.find(group);
+            return group_it != patterns.end() && group_it->second->match(topic) != nullptr;
+        }
+    };
+    using SubscriptionReader = EpochSnapshot<SubscriptionSnapshot>::Reader;
+    void publishSubscriptionSnapshot();  // Requires subscriptions_mutex_ (exclusive)
+    EpochSnapshot<SubscriptionSnapshot> subscription_snapshot_;
+
+    // Lanes with pending messages, per worker; a lane starts on worker (topic id % workers)
+    // and is put back on the worker that last drained it. Idle workers steal from the others.
+    struct RunQueue {
+        std::mutex mutex;
+        std::deque<TopicLane*> lanes;
+    };
+    std::vector<std::unique_ptr<RunQueue>> run_queues_;  // One per worker, sized at construction
+    std::atomic<size_t> scheduled_lanes_{0};             // Lanes in all run queues (sleep check)
+    EventCount work_ready_;                              // Wakes a sleeping worker when a lane is scheduled
+    void scheduleLane(TopicLane* lane, size_t thread_id);
+    TopicLane* nextLane(size_t thread_id);  // Own run queue first, then steal
     std::vector<std::thread> processing_threads_;
+    std::vector<uint64_t> worker_cpu_sets_;  // Config::node.worker_cpu_sets at construction
+    int worker_priority_ = 0;                // Config::node.worker_priority at construction
+    Config::ThreadsConfig threads_config_;   // Config::threads at construction
+    void applyWorkerScheduling(size_t thread_id);
     std::atomic<size_t> dropped_messages_{0};  // Counter for dropped messages due to queue overflow
+    std::atomic<size_t> expired_messages_{0};  // Dropped past their deadline (not counted as overflow)
+
+    // Per-topic statistics (getTopicStats()), keyed by topic id
+    enum TopicCounter {
+        PUBLISHED,
+        PUBLISHED_BYTES,
+        DELIVERED,
+        DELIVERED_BYTES,
+        DROPPED,
+        EXPIRED,
+        CALLBACK_NS,
+        TOPIC_COUNTERS
+    };
+    ShardedCounters<TOPIC_COUNTERS> topic_stats_;
+    void countPublished(const TopicHandle& topic, size_t bytes) {
+        topic_stats_.add(topic.id(), PUBLISHED);
+        topic_stats_.add(topic.id(), PUBLISHED_BYTES, bytes);
+    }
+
+    // Latency tracing (getTopicLatency()): per stage, TopicLatency::BUCKETS bucket counters then the total
+    enum TraceStage { TRACE_TRANSIT, TRACE_RECEIVE, TRACE_QUEUE, TRACE_CALLBACK, TRACE_STAGES };
+    static constexpr size_t TRACE_STAGE_COUNTERS = TopicLatency::BUCKETS + 1;
+    bool latency_tracing_;  // Config::NodeConfig::latency_tracing, fixed at creation
+    ShardedCounters<TRACE_STAGES * TRACE_STAGE_COUNTERS> trace_stats_;
+    void traceLatency(uint32_t topic_id, TraceStage stage, uint64_t ns);
 
     // System message processing (thread-safe, dedicated thread)
     static constexpr size_t MAX_SYSTEM_QUEUE_SIZE = 1000;  // System messages are rare
@@ -215,19 +639,78 @@ private:
     std::thread system_thread_;
     std::atomic<bool> system_running_{false};
 
+    // Startup service query: shared memory peers that have not finished answering yet
+    std::mutex service_query_mutex_;
+    std::condition_variable service_query_cv_;
+    std::set<std::string> service_query_pending_;
+
+    // Service set versions. Ours is bumped with every service update we broadcast; the bump and the
+    // send happen under service_broadcast_mutex_, so peers see the versions in order
+    std::mutex service_broadcast_mutex_;
+    uint32_t service_version_ = 0;
+    // Per peer (service_query_mutex_): the version our registry matches, if synced; updates that skip
+    // a version trigger a snapshot request, at most once per SERVICE_RESYNC_INTERVAL_MS
+    struct PeerServices {
+        uint32_t version = 0;
+        bool synced = false;
+        int64_t resync_ms = 0;
+    };
+    static constexpr int64_t SERVICE_RESYNC_INTERVAL_MS = 1000;
+    std::map<std::string, PeerServices> peer_services_;
+    // SERVICE_SNAPSHOT chunks received so far, per peer (service_query_mutex_)
+    std::map<std::string, std::vector<ServiceDescriptor>> service_snapshots_;
+
+    // Warm-restart discovery cache (Config::node.discovery_cache): remote services and UDP endpoints,
+    // written by a maintenance task when they change and loaded by initialize(). Loaded services are
+    // provisional until their node re-announces them (SERVICE_REGISTER or a snapshot); whatever is
+    // still unconfirmed after DISCOVERY_CACHE_REVALIDATE_MS is dropped
+    void loadDiscoveryCache();
+    void saveDiscoveryCache();
+    std::vector<uint8_t> buildDiscoveryCache() const;
+    void confirmCachedService(const ServiceDescriptor& svc);
+    void confirmCachedNode(const std::string& node_id);  // The node's services are authoritative (or gone)
+    void expireCachedServices();
+    std::string discovery_cache_path_;
+    std::vector<uint8_t> discovery_cache_written_;  // Last contents written (maintenance task)
+    std::mutex cached_services_mutex_;
+    std::map<std::string, ServiceDescriptor> cached_services_;  // Provisional, by service key
+    std::chrono::steady_clock::time_point cached_services_deadline_;
+    static constexpr int DISCOVERY_CACHE_FLUSH_MS = 1000;
+    static constexpr int DISCOVERY_CACHE_REVALIDATE_MS = 5000;
+
     // Queue overflow policy
     QueueOverflowPolicy overflow_policy_{QueueOverflowPolicy::DROP_OLDEST};
     QueueOverflowCallback overflow_callback_;
     std::mutex overflow_callback_mutex_;
 
-    // Background cleanup thread
-    std::thread cleanup_thread_;
-    std::atomic<bool> cleanup_running_{false};
-    void cleanupThreadFunc();
+    // Watermarks (setWatermarkCallback): topic lanes are checked as they are filled and drained,
+    // shared memory and large data rings sampled by watermark_task_
+    std::atomic<bool> watermarks_enabled_{false};
+    std::atomic<uint32_t> watermark_high_percent_{80};
+    std::atomic<uint32_t> watermark_low_percent_{50};
+    WatermarkCallback watermark_callback_;
+    std::mutex watermark_callback_mutex_;
+    std::mutex watermark_task_mutex_;          // Scheduling of watermark_task_ (never held by the task)
+    std::set<std::string> rings_above_high_;  // Sampled rings reported "high" (watermark task only)
+    void checkLaneWatermark(TopicLane& lane, size_t max_queue_size);  // Capacity: the lane's ring or the node limit
+    bool crossedWatermark(bool above_high, size_t level, size_t capacity) const;
+    void notifyWatermark(const WatermarkEvent& event);
+    void pollWatermarks();
 
-    // UDP heartbeat thread
-    std::thread udp_heartbeat_thread_;
-    std::atomic<bool> udp_heartbeat_running_{false};
+    // Background cleanup thread
+    // Periodic work runs on the process-wide MaintenanceScheduler (no thread of its own per node)
+    MaintenanceScheduler::TaskId cleanup_task_ = MaintenanceScheduler::NO_TASK;          // Orphaned channels
+    MaintenanceScheduler::TaskId discovery_cache_task_ = MaintenanceScheduler::NO_TASK;  // Flush / revalidate
+    MaintenanceScheduler::TaskId udp_heartbeat_task_ = MaintenanceScheduler::NO_TASK;
+    MaintenanceScheduler::TaskId metrics_task_ = MaintenanceScheduler::NO_TASK;  // Config::node.metrics_interval_ms
+    MaintenanceScheduler::TaskId watermark_task_ = MaintenanceScheduler::NO_TASK;  // While a callback is set
+    MaintenanceScheduler::TaskId topic_bus_task_ = MaintenanceScheduler::NO_TASK;  // TopicBusReaders::sync()
+    void runCleanup();
+
+    // Shared memory metrics segment (nexus_top): refreshed from the counters above by metrics_task_,
+    // so the hot path keeps a single relaxed increment per event
+    std::unique_ptr<MetricsSegment> metrics_segment_;
+    void publishMetrics();
     static constexpr int UDP_HEARTBEAT_INTERVAL_MS = 1000;  // 1 second
     static constexpr int UDP_TIMEOUT_MS = 5000;             // 5 seconds
 
@@ -0,0 +1,143 @@
+// Pull-based subscription: messages queued for the application's own thread (Node::subscribePolling)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "nexus/core/Node.h"
+#include "nexus/utils/BoundedQueue.h"
+#include "nexus/utils/MessagePool.h"
+
+namespace Nexus {
+namespace rpc {
+
+class NodeImpl;
+
+/**
+ * @brief A message taken from a PollingSubscription
+ *
+ * Owns its pooled payload (shared with other in-process subscribers of the
+ * same publish) until destroyed or overwritten. Move-only.
+ */
+class PolledMessage {
+public:
+    PolledMessage() = default;
+    ~PolledMessage() { payload_.release(); }
+
+    PolledMessage(PolledMessage&& other) noexcept : topic_(other.topic_), payload_(other.payload_) {
+        other.payload_ = SharedPayload();
+    }
+    PolledMessage& operator=(PolledMessage&& other) noexcept {
+        if (this != &other) {
+            payload_.release();
+            topic_ = other.topic_;
+            payload_ = other.payload_;
+            other.payload_ = SharedPayload();
+        }
+        return *this;
+    }
+    PolledMessage(const PolledMessage&) = delete;
+    PolledMessage& operator=(const PolledMessage&) = delete;
+
+    const TopicHandle& topic() const { return topic_; }
+    const std::string& group() const { return topic_.group(); }
+    const std::string& topicName() const { return topic_.topic(); }
+    const uint8_t* data() const { return payload_.data(); }
+    size_t size() const { return payload_.size(); }
+    explicit operator bool() const { return topic_.valid(); }
+
+private:
+    friend class PollingSubscription;
+
+    TopicHandle topic_;
+    SharedPayload payload_;
+};
+
+/**
+ * @brief Per-subscriber message queue drained by the application (see Node::subscribePolling())
+ *
+ * Receive threads and in-process publishers push into a bounded lock-free
+ * queue; no dispatch worker is involved and nothing runs on another thread on
+ * the application's behalf. The application takes messages at its own cycle
+ * time with tryTake()/takeBatch(), or sleeps on fd() in its epoll/select loop:
+ * the descriptor is readable while messages are waiting (an eventfd on Linux,
+ * a pipe elsewhere) and is only written when the queue turns non-empty, so a
+ * busy queue costs no system call per message.
+ *
+ * A full queue follows the node's QueueOverflowPolicy: DROP_OLDEST makes room
+ * by dropping the oldest message, any other policy drops the new one (a
+ * receive thread never waits for the application). Drops are counted in
+ * dropped() and the topic's TopicStats. Messages with a deadline (see
+ * Node::setTopicTtl()) that expire in the queue are skipped by tryTake() and
+ * counted in expired().
+ *
+ * Several threads may take concurrently, but per-topic order is only kept
+ * with a single consumer. The subscription stays valid after the node
+ * unsubscribes the group (or is destroyed): messages already queued can still
+ * be taken.
+ */
+class PollingSubscription {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    explicit PollingSubscription(size_t capacity);
+    ~PollingSubscription();
+
+    PollingSubscription(const PollingSubscription&) = delete;
+    PollingSubscription& operator=(const PollingSubscription&) = delete;
+
+    /**
+     * @brief Take the oldest queued message without waiting
+     * @return false if the queue is empty (@p message is left empty)
+     */
+    bool tryTake(PolledMessage& message);
+
+    /**
+     * @brief Take up to @p max queued messages into @p messages (without waiting)
+     * @return Number of messages taken
+     */
+    size_t takeBatch(PolledMessage* messages, size_t max);
+
+    /**
+     * @brief Wait until a message is queued or @p timeout_ms passes (-1: no limit)
+     * @return true if a message is waiting
+     */
+    bool wait(int timeout_ms);
+
+    // Readable while messages are queued; owned by the subscription (do not read or close it)
+    int fd() const { return read_fd_; }
+
+    size_t size() const { return queue_.size(); }
+    size_t capacity() const { return queue_.capacity(); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t expired() const { return expired_.load(std::memory_order_relaxed); }
+
+private:
+    friend class NodeImpl;
+
+    struct Item {
+        TopicHandle topic;
+        SharedPayload payload;
+        uint64_t deadline_ns;  // TraceStamp clock (0: none)
+    };
+
+    /**
+     * @brief Queue @p payload (its reference passes to the queue) and signal fd()
+     * @return Messages dropped to make room or refused (the caller counts them)
+     */
+    size_t push(const TopicHandle& topic, SharedPayload payload, bool drop_oldest, uint64_t deadline_ns);
+    void signal();
+    // The queue was found empty: clear fd(), then re-signal if a message raced in
+    void clearSignal();
+
+    BoundedMpmcQueue<Item> queue_;
+    std::atomic<bool> signaled_{false};  // fd() has been made readable and not cleared since
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> expired_{0};
+    int read_fd_ = -1;
+    int write_fd_ = -1;  // Same descriptor as read_fd_ for an eventfd
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,124 @@
+// Record topics and large data channels to a memory-mapped log, and replay recordings through a node
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nexus/core/Node.h"
+#include "nexus/utils/RecordLog.h"
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Records selected topics and large data channels of the host into a RecordLog
+ *
+ * Topics are subscribed INLINE: each message is appended on the receiving
+ * thread, copied once from the shared memory ring (or, in-process, from the
+ * publisher's buffer) into the mapped segment, with no dispatch queue or
+ * per-message allocation. Wildcard topics record each topic they match as its
+ * own stream. Large data channels are read with subscribeLargeData() and each
+ * block is copied straight from the channel's ring.
+ *
+ * Use a node of its own: recordTopics() replaces the node's callback for the
+ * group, and a slow disk stalls the senders (see DispatchMode::INLINE).
+ */
+class Recorder {
+public:
+    explicit Recorder(std::shared_ptr<Node> node);
+    ~Recorder();  // stop()
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /**
+     * @brief Create the recording's first segment (see RecordWriter::open())
+     */
+    bool start(const std::string& base, const RecordWriter::Options& options = RecordWriter::Options());
+
+    // Record @p topics of @p group (wildcards allowed); NOT_INITIALIZED before start()
+    Node::Error recordTopics(const std::string& group, const std::vector<std::string>& topics);
+
+    // Record every block written to large data channel @p channel
+    Node::Error recordLargeData(const std::string& channel);
+
+    // Unsubscribe everything and close the recording
+    void stop();
+
+    RecordWriter::Stats getStats() const { return state_->writer.getStats(); }
+
+private:
+    // Shared with the callbacks, so one still running after stop() finds a closed writer, not a dead one
+    struct State {
+        using StreamTable = std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>;
+
+        // Stream of (name, topic), interned on first use; UINT32_MAX if the recording is full or closed
+        uint32_t streamFor(RecordLayout::StreamKind kind, const std::string& name, const std::string& topic);
+
+        RecordWriter writer;
+        std::mutex mutex;
+        StreamTable message_streams;  // Group -> topic -> stream id
+        StreamTable large_streams;    // Channel -> topic -> stream id
+    };
+
+    std::shared_ptr<Node> node_;
+    std::shared_ptr<State> state_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::string>> groups_;  // Subscribed, for stop()
+    std::vector<std::string> channels_;
+};
+
+/**
+ * @brief Republishes a recording through a node
+ *
+ * Messages are published by name, so they take the node's usual routes:
+ * straight into each subscriber's shared memory ring, into in-process queues,
+ * or over UDP. Large data blocks are written into their channel with
+ * writeLargeData(), waking the channel's subscribeLargeData() readers.
+ * Segments are mapped read-only and payloads copied from the mapping.
+ */
+class Replayer {
+public:
+    struct Options {
+        double speed = 1.0;                   // Relative to the original timing (2: twice as fast); 0: no waits
+        uint64_t start_ns = 0;                // Skip what was recorded before (ns since the recording started)
+        uint32_t large_data_retry_ms = 1000;  // How long a block waits for room in a full channel
+    };
+
+    struct Stats {
+        uint64_t messages = 0;      // Messages published
+        uint64_t large_blocks = 0;  // Large data blocks written
+        uint64_t bytes = 0;
+        uint64_t failed = 0;  // Frames a subscriber queue or channel had no room for
+    };
+
+    explicit Replayer(std::shared_ptr<Node> node);
+
+    /**
+     * @brief Replay recording @p base; returns when it ends or stop() is called
+     * @return false if the recording has no readable segment
+     */
+    bool run(const std::string& base, const Options& options);
+    bool run(const std::string& base) { return run(base, Options()); }
+
+    // Make run() return after the current frame (any thread)
+    void stop() { stopping_.store(true, std::memory_order_relaxed); }
+
+    Stats getStats() const;
+
+private:
+    bool replayFrame(const RecordStream& stream, const RecordReader::Frame& frame, const Options& options);
+
+    std::shared_ptr<Node> node_;
+    std::atomic<bool> stopping_{false};
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,140 @@
+// Request/response RPC of a node: served methods, call workers and outstanding calls (Node::serve, Node::call)
+#pragma once
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "nexus/core/Message.h"
+#include "nexus/core/Node.h"
+#include "nexus/utils/MessagePool.h"
+#include "nexus/utils/StringView.h"
+
+namespace Nexus {
+namespace rpc {
+
+class NodeImpl;
+
+/**
+ * @brief RPC state of one NodeImpl
+ *
+ * Server side: the methods the node serves and the call workers that run
+ * them, so a handler never blocks the receive thread that got its REQUEST.
+ * Caller side: the table of outstanding calls, completed by a REPLY or by
+ * the timeout thread at their deadline, and the per-method route cache.
+ * Frames go out through the node's transports.
+ */
+class RpcServer {
+public:
+    using Property = Node::Property;
+    using Error = Node::Error;
+    using MethodHandler = Node::MethodHandler;
+    using ReplyCallback = Node::ReplyCallback;
+
+    explicit RpcServer(NodeImpl& node);
+    ~RpcServer();
+
+    RpcServer(const RpcServer&) = delete;
+    RpcServer& operator=(const RpcServer&) = delete;
+
+    // Node interface (see Node::serve, Node::call)
+    Error serve(const Property& msg_group, const Property& method, const MethodHandler& handler);
+    Error unserve(const Property& msg_group, const Property& method);
+    Error call(const Property& msg_group, const Property& method, const Property& request, Property& response,
+               uint32_t timeout_ms);
+    Error callAsync(const Property& msg_group, const Property& method, const Property& request, uint32_t timeout_ms,
+                    const ReplyCallback& callback);
+
+    // Server side of a REQUEST: queue it for a call worker (UDP reply if @p udp_caller is set, else shm)
+    void handleCallRequest(StringView source_node_id, StringView group, StringView method, const uint8_t* payload,
+                           size_t payload_len, const sockaddr_in* udp_caller);
+    // Caller side of a REPLY: complete the pending call (inline, on the receiving thread)
+    void handleCallReply(const uint8_t* payload, size_t payload_len);
+
+    // Node shutdown: join the call workers, then fail the calls still outstanding with NOT_INITIALIZED
+    void stop();
+
+    // Replies that could not be sent back to their caller (caller gone or its queue full)
+    size_t getFailedReplyCount() const { return failed_replies_.load(std::memory_order_relaxed); }
+
+private:
+    // The serving node of a method, resolved from the service registry
+    struct CallRoute {
+        uint64_t route_version = 0;  // GlobalRegistry route version this was built from (0: retry next call)
+        uint32_t shm_handle = 0;     // SharedMemoryTransportV3::NodeHandle, or INVALID_NODE_HANDLE
+        bool has_udp = false;        // udp_address is valid (used if shm_handle is not)
+        sockaddr_in udp_address;
+    };
+    CallRoute callRoute(const TopicHandle& method);
+    void collectCallRoute(const std::string& group, const std::string& method, CallRoute& route);
+
+    // Handler of a method served by this node (nullptr if not served)
+    std::shared_ptr<const MethodHandler> findMethod(StringView group, StringView method) const;
+
+    // A received REQUEST waiting for a call worker
+    struct CallRequest {
+        std::string caller;  // Source node: shared memory replies go to its queue
+        std::string group;
+        std::string method;
+        CallHeader header;
+        SharedPayload body;      // Request bytes (NodeImpl::payloadPool() copy)
+        bool udp = false;        // Reply to udp_caller instead
+        sockaddr_in udp_caller;  // Caller's socket (UDP only)
+    };
+    void startCallWorkers();  // First serve(): one call worker per dispatch worker
+    void stopCallWorkers();   // Shutdown: join the workers, drop requests not yet handled
+    void callWorkerThread();
+    // Send @p response (status in request.header) back to the caller; counts and logs a failed send
+    void sendCallReply(const CallRequest& request, const Property& response);
+    // Pending call @p call_id if still waiting (removed from the table), else an empty callback
+    ReplyCallback takePendingCall(uint64_t call_id);
+    void callTimeoutThread();  // Fails pending calls whose deadline passed
+
+    NodeImpl& node_;
+
+    // Served methods: group -> method -> handler
+    mutable std::mutex methods_mutex_;
+    std::map<std::string, std::map<std::string, std::shared_ptr<const MethodHandler>, std::less<>>, std::less<>>
+        methods_;
+
+    // Outstanding remote calls: call id -> completion
+    struct PendingCall {
+        ReplyCallback callback;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    std::mutex calls_mutex_;
+    std::condition_variable calls_cv_;  // Wakes the timeout thread for an earlier deadline or shutdown
+    std::unordered_map<uint64_t, PendingCall> pending_calls_;
+    std::chrono::steady_clock::time_point next_deadline_;  // Deadline the timeout thread sleeps until
+    std::atomic<uint64_t> next_call_id_{1};
+    std::thread call_timeout_thread_;    // Started by the first remote call
+    bool call_timeout_running_ = false;  // Guarded by calls_mutex_
+
+    // Served requests: run by call workers, never on the receive thread that got them
+    static constexpr size_t MAX_CALL_QUEUE_SIZE = 1024;  // Requests beyond this are answered QUEUE_FULL
+    std::mutex call_queue_mutex_;
+    std::condition_variable call_queue_cv_;
+    std::deque<CallRequest> call_queue_;
+    std::vector<std::thread> call_workers_;  // Started by the first serve()
+    bool call_workers_running_ = false;      // Guarded by call_queue_mutex_
+    std::atomic<size_t> failed_replies_{0};
+
+    // Call route cache: method topic id -> route (see callRoute())
+    std::mutex call_routes_mutex_;
+    std::vector<CallRoute> call_routes_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,88 @@
+// Single-write shared memory ring of a topic with many local subscribers (Node::setTopicBus)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "nexus/core/Node.h"
+#include "nexus/transport/LargeDataChannel.h"
+
+namespace Nexus {
+namespace rpc {
+
+class NodeImpl;
+
+/**
+ * @brief Publisher side: the topic's ring, written once per message for every subscriber reading it
+ *
+ * A mirrored LargeDataChannel that drops the oldest blocks when full, so a
+ * slow reader never holds up the publisher. Each block carries the reader
+ * mask of the route that wrote it; readers skip blocks not meant for them.
+ */
+class TopicBus {
+public:
+    // Ring of @p node_id's topic, named so orphan cleanup finds it; nullptr if it could not be created
+    static std::shared_ptr<TopicBus> create(const std::string& node_id, const std::string& group,
+                                            const std::string& topic);
+
+    // Channel configuration shared by the publisher and its readers (Config::shm.topic_bus_size)
+    static LargeDataChannel::Config channelConfig();
+
+    const std::string& channelName() const { return channel_name_; }
+
+    /**
+     * @brief Write one message of @p payload_len bytes for the readers in @p reader_mask
+     * @param writer Fills the payload in place
+     * @return false if it does not fit (larger than a quarter of the ring) or was not committed
+     */
+    bool write(const std::string& topic, size_t payload_len, uint16_t reader_mask, const Node::PayloadWriter& writer);
+
+private:
+    TopicBus() = default;
+
+    std::string channel_name_;
+    std::shared_ptr<LargeDataChannel> channel_;
+    std::mutex mutex_;        // The ring has a single writer: concurrent publishes take turns
+    size_t max_message_ = 0;  // Larger messages bypass the ring
+};
+
+/**
+ * @brief Subscriber side: the buses of other processes a node reads for its subscriptions
+ *
+ * sync() attaches to the buses of subscribed topics as their publishers
+ * advertise them and detaches from the others. Each attached bus gets a
+ * reader thread, and a TOPIC_BUS service of the node telling the publisher
+ * its reader slot, so the publisher's route stops sending to its queue.
+ */
+class TopicBusReaders {
+public:
+    static constexpr int SYNC_MS = 100;  // Registry changes are picked up this often
+
+    explicit TopicBusReaders(NodeImpl& node);
+    ~TopicBusReaders();
+
+    TopicBusReaders(const TopicBusReaders&) = delete;
+    TopicBusReaders& operator=(const TopicBusReaders&) = delete;
+
+    // Attach and detach to match the subscriptions; unless @p force, only after a registry change
+    void sync(bool force);
+    // Node shutdown: stop the reader threads (their services leave with the node)
+    void close();
+
+    bool empty() const;
+
+private:
+    struct Reader;  // Reader thread of one bus and the service advertising its slot
+
+    NodeImpl& node_;
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Reader>> readers_;  // By channel name
+    uint64_t version_ = 0;                                    // Route version of the last sync
+};
+
+}  // namespace rpc
+}  // namespace Nexus
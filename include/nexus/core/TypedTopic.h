@@ -0,0 +1,164 @@
+// Typed publish/subscribe for fixed-layout (trivially copyable) messages
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "nexus/core/Node.h"
+
+namespace Nexus {
+namespace rpc {
+
+namespace detail {
+constexpr uint32_t fnv1a(const char* str) {
+    uint32_t hash = 2166136261u;
+    while (*str) {
+        hash = (hash ^ static_cast<uint8_t>(*str++)) * 16777619u;
+    }
+    return hash;
+}
+}  // namespace detail
+
+/**
+ * @brief Compile-time identity of a message type (qualified name and size)
+ *
+ * Derived from the compiler's function signature, so it is only comparable
+ * between binaries built with the same compiler family.
+ */
+template <typename T>
+constexpr uint32_t typeHash() {
+    return detail::fnv1a(__PRETTY_FUNCTION__) ^ static_cast<uint32_t>(sizeof(T));
+}
+
+/**
+ * @brief Prefix of every typed payload (8 bytes, followed by the raw T)
+ */
+struct TypedHeader {
+    uint32_t type_hash;  // typeHash<T>() of the publisher
+    uint32_t size;       // sizeof(T) of the publisher
+};
+
+/**
+ * @brief Publishes values of T on one topic, without serialization
+ *
+ * The value is gathered into the frame next to a TypedHeader (publishv), so
+ * the only copy is the one into the transport.
+ */
+template <typename T>
+class TypedPublisher {
+    static_assert(std::is_trivially_copyable<T>::value, "TypedPublisher<T> requires a trivially copyable T");
+
+public:
+    TypedPublisher(std::shared_ptr<Node> node, const std::string& msg_group, const std::string& topic)
+        : node_(std::move(node)), group_(msg_group), topic_(topic) {}
+
+    Node::Error publish(const T& value) {
+        constexpr uint32_t type_hash = typeHash<T>();  // Folded at compile time
+        const TypedHeader header = {type_hash, static_cast<uint32_t>(sizeof(T))};
+        const Node::PayloadSegment segments[2] = {{&header, sizeof(header)}, {&value, sizeof(T)}};
+        return node_->publishv(group_, topic_, segments, 2);
+    }
+
+    const std::string& group() const { return group_; }
+    const std::string& topic() const { return topic_; }
+
+private:
+    std::shared_ptr<Node> node_;
+    std::string group_;
+    std::string topic_;
+};
+
+/**
+ * @brief Receives values of T from one topic
+ *
+ * Payloads whose TypedHeader does not match T (other type, other layout, or
+ * an untyped publisher) are dropped and counted in rejected(). The callback
+ * gets a reference into the received buffer when it is suitably aligned for
+ * T, otherwise into an aligned copy on the stack.
+ *
+ * Like Node::subscribe(), a group has one callback per node: subscribing
+ * replaces the callback of other topics of the same group on that node.
+ */
+template <typename T>
+class TypedSubscriber {
+    static_assert(std::is_trivially_copyable<T>::value, "TypedSubscriber<T> requires a trivially copyable T");
+
+public:
+    using Callback = std::function<void(const T& value)>;
+
+    TypedSubscriber(std::shared_ptr<Node> node, const std::string& msg_group, const std::string& topic)
+        : node_(std::move(node)),
+          group_(msg_group),
+          topic_(topic),
+          rejected_(std::make_shared<std::atomic<uint64_t>>(0)) {}
+
+    ~TypedSubscriber() { unsubscribe(); }
+
+    TypedSubscriber(const TypedSubscriber&) = delete;
+    TypedSubscriber& operator=(const TypedSubscriber&) = delete;
+
+    Node::Error subscribe(const Callback& callback, const SubscribeOptions& options = SubscribeOptions()) {
+        if (!callback) {
+            return Node::INVALID_ARG;
+        }
+        std::shared_ptr<std::atomic<uint64_t>> rejected = rejected_;
+        Node::Error result = node_->subscribe(
+            group_, {topic_},
+            [callback, rejected](const Node::Property&, const Node::Property&, const uint8_t* payload, size_t size) {
+                dispatch(callback, *rejected, payload, size);
+            },
+            options);
+        subscribed_ = (result == Node::NO_ERROR);
+        return result;
+    }
+
+    Node::Error unsubscribe() {
+        if (!subscribed_) {
+            return Node::NO_ERROR;
+        }
+        subscribed_ = false;
+        return node_->unsubscribe(group_, {topic_});
+    }
+
+    // Messages dropped because their header did not match T
+    uint64_t rejected() const { return rejected_->load(std::memory_order_relaxed); }
+
+private:
+    static void dispatch(const Callback& callback, std::atomic<uint64_t>& rejected, const uint8_t* payload,
+                         size_t size) {
+        constexpr uint32_t type_hash = typeHash<T>();
+        TypedHeader header;
+        if (size != sizeof(TypedHeader) + sizeof(T)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::memcpy(&header, payload, sizeof(header));
+        if (header.type_hash != type_hash || header.size != sizeof(T)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const uint8_t* body = payload + sizeof(TypedHeader);
+        if (reinterpret_cast<uintptr_t>(body) % alignof(T) == 0) {
+            callback(*reinterpret_cast<const T*>(body));
+        } else {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type aligned;
+            std::memcpy(&aligned, body, sizeof(T));
+            callback(*reinterpret_cast<const T*>(&aligned));
+        }
+    }
+
+    std::shared_ptr<Node> node_;
+    std::string group_;
+    std::string topic_;
+    std::shared_ptr<std::atomic<uint64_t>> rejected_;  // Shared with the subscribed callback
+    bool subscribed_ = false;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -1,16 +1,87 @@
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "nexus/core/Node.h"  // TopicHandle
+
 namespace Nexus {
 namespace rpc {
 // Forward declaration
 class NodeImpl;
 struct ServiceDescriptor;
 
+/**
+ * @brief Immutable snapshot of the service table, indexed for lookups
+ *
+ * GlobalRegistry rebuilds it after every service change and hands it out as
+ * std::shared_ptr<const ServiceIndex>: a lookup neither copies descriptors
+ * nor takes a lock, and the snapshot stays valid while the table moves on.
+ * Lists keep registration order; an unknown key yields an empty list.
+ */
+class ServiceIndex {
+public:
+    using List = std::vector<Nexus::rpc::ServiceDescriptor>;
+
+    const List& all() const { return all_; }
+    const List& group(const std::string& group) const;
+    // Services of a group registered under exactly @p topic (wildcard subscriptions: see patterns())
+    const List& topic(const std::string& group, const std::string& topic) const;
+    // Services of a group whose topic is a wildcard pattern ("sensors/*")
+    const List& patterns(const std::string& group) const;
+    const List& node(const std::string& node_id) const;
+    const List& transport(Nexus::rpc::TransportType transport) const;
+
+    size_t size() const { return all_.size(); }
+    bool empty() const { return all_.empty(); }
+
+private:
+    friend class GlobalRegistry;
+
+    struct GroupIndex {
+        List services;
+        List patterns;
+        std::unordered_map<std::string, List> topics;
+    };
+
+    void add(const Nexus::rpc::ServiceDescriptor& svc);
+
+    List all_;
+    std::unordered_map<std::string, GroupIndex> groups_;
+    std::unordered_map<std::string, List> nodes_;
+    List transports_[3];  // By TransportType
+};
+
+/**
+ * @brief Immutable snapshot of the in-process subscribers of each topic
+ *
+ * Rebuilt by GlobalRegistry whenever a node's subscriptions change, so an
+ * in-process publish reads it without a lock and wakes only the nodes that
+ * subscribed the topic. Nodes are held weakly: one being destroyed simply
+ * fails to lock.
+ */
+class InProcessSubscribers {
+public:
+    using List = std::vector<std::weak_ptr<Nexus::rpc::NodeImpl>>;
+
+    // Nodes subscribed to topic @p id, by name or through a wildcard that already matched it
+    const List& topic(uint32_t id) const;
+    // Nodes with a wildcard subscription in @p group (they match topics not seen yet on delivery)
+    const List& patterns(const std::string& group) const;
+
+private:
+    friend class GlobalRegistry;
+
+    std::vector<List> by_topic_;  // Index: topic id
+    std::unordered_map<std::string, List> patterns_;
+};
+
 /**
  * @brief Global registry for managing nodes and services
  * Replaces scattered static members across multiple files
@@ -28,12 +99,29 @@ public:
     std::vector<std::shared_ptr<Nexus::rpc::NodeImpl>> getAllNodes();
     std::shared_ptr<Nexus::rpc::NodeImpl> findNode(const std::string& node_id);
 
+    // In-process subscriptions: a node reports its full set (topic ids, groups with wildcards) after each change
+    void setSubscriptions(const std::string& node_id, std::vector<uint32_t> topic_ids,
+                          std::vector<std::string> pattern_groups);
+    std::shared_ptr<const InProcessSubscribers> getInProcessSubscribers() const;  // Current snapshot (no lock)
+
     // Service registry
     void registerService(const std::string& group, const Nexus::rpc::ServiceDescriptor& svc);
     void unregisterService(const std::string& group, const Nexus::rpc::ServiceDescriptor& svc);
-    std::vector<Nexus::rpc::ServiceDescriptor> findServices(const std::string& group = "");
+    std::vector<Nexus::rpc::ServiceDescriptor> findServices(const std::string& group = "");  // Copy
+    std::shared_ptr<const ServiceIndex> getServices() const;  // Current snapshot (no copy, no lock)
     void clearServices();
 
+    // Route version: bumped after any node/service change (or explicitly, e.g. on NODE_JOINED/LEFT),
+    // so per-topic route caches rebuild only when something they depend on has changed
+    uint64_t getRouteVersion() const { return route_version_.load(std::memory_order_acquire); }
+    void invalidateRoutes() { route_version_.fetch_add(1, std::memory_order_acq_rel); }
+
+    // Topic table: interned (group, topic) pairs with dense ids, never removed
+    TopicHandle resolveTopic(const std::string& group, const std::string& topic);  // Interns if new
+    TopicHandle findTopic(const std::string& group, const std::string& topic) const;  // Invalid if unknown
+    TopicHandle topicById(uint32_t id) const;                                         // Invalid if unknown
+    size_t getTopicCount() const;
+
     // Statistics
     size_t getNodeCount() const;
     size_t getServiceCount() const;
@@ -50,9 +138,31 @@ private:
     mutable std::mutex nodes_mutex_;
     std::map<std::string, std::weak_ptr<Nexus::rpc::NodeImpl>> nodes_;
 
+    // In-process subscriptions by node id (nodes_mutex_)
+    struct NodeSubscriptions {
+        std::vector<uint32_t> topic_ids;
+        std::vector<std::string> pattern_groups;
+    };
+    std::map<std::string, NodeSubscriptions> subscriptions_;
+    // Rebuilt from nodes_ and subscriptions_ after each change (nodes_mutex_ held)
+    void publishSubscribers();
+    std::shared_ptr<const InProcessSubscribers> subscribers_{
+        std::make_shared<InProcessSubscribers>()};  // std::atomic_load/store
+
     // Service registry: group -> services (C++14: use mutex instead of shared_mutex)
     mutable std::mutex services_mutex_;
     std::map<std::string, std::vector<Nexus::rpc::ServiceDescriptor>> services_;
+    // Rebuilt from services_ after each change (services_mutex_ held)
+    void publishServices();
+    std::shared_ptr<const ServiceIndex> services_index_{std::make_shared<ServiceIndex>()};  // std::atomic_load/store
+
+    std::atomic<uint64_t> route_version_{1};
+
+    // Topic table: group -> topic -> entry (read on every received message)
+    mutable std::shared_timed_mutex topics_mutex_;
+    std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<TopicHandle::Entry>>> topics_;
+    std::vector<const TopicHandle::Entry*> topics_by_id_;  // Index: id -> entry (compact frames)
+    uint32_t next_topic_id_ = 0;
 };
 
 }  // namespace rpc
@@ -42,6 +42,8 @@ public:
     static constexpr size_t MAX_REGISTRY_ENTRIES = 256;  // Support up to 256 nodes
     static constexpr size_t NODE_ID_SIZE = 64;
     static constexpr size_t SHM_NAME_SIZE = 64;
+    static constexpr size_t INDEX_SLOTS = MAX_REGISTRY_ENTRIES * 2;  // Hash index slots: power of two, at most half full
+    static constexpr uint32_t NO_GENERATION = 1;  // Odd: never the generation of a settled registry
 
     SharedMemoryRegistry();
     ~SharedMemoryRegistry();
@@ -76,10 +78,41 @@ public:
 
     /**
      * @brief Get all active nodes
+     *
+     * Lock-free: read under the registry generation (seqlock) and retried if a
+     * writer changed the entry set meanwhile.
      * @return Vector of active node information
      */
     std::vector<NodeInfo> getAllNodes() const;
 
+    /**
+     * @brief Re-read the node list only if the registry changed since @p generation
+     * @param generation In: generation of @p nodes (NO_GENERATION at first); out: generation of the new list
+     * @param nodes Replaced when the registry changed (last_heartbeat is as of that read)
+     * @return true if @p nodes was replaced
+     */
+    bool getAllNodesIfChanged(uint32_t& generation, std::vector<NodeInfo>& nodes) const;
+
+    /**
+     * @brief Block until a node registers, unregisters or is cleaned up
+     *
+     * Writers wake waiters through a futex on the generation (Linux; other
+     * platforms poll it), in every process mapping the registry.
+     * @param generation In: generation already seen (NO_GENERATION returns at once); out: current generation
+     * @param timeout_ms Maximum wait
+     * @param keep_waiting Optional: the wait ends early once it reads false (see wakeWaiters())
+     * @return true if the generation differs from the one passed in
+     */
+    bool waitForChange(uint32_t& generation, int timeout_ms, const std::atomic<bool>* keep_waiting = nullptr) const;
+
+    /**
+     * @brief Wake every waitForChange() caller without changing the generation
+     *
+     * Used at shutdown after clearing a keep_waiting flag. Waiters whose flag
+     * is still set go back to sleep.
+     */
+    void wakeWaiters() const;
+
     /**
      * @brief Find a specific node
      * @param node_id Node identifier to find
@@ -150,7 +183,9 @@ private:
         // shm_name: 64 bytes = 8 * uint64_t
         std::atomic<uint64_t> shm_name_atomic[8];
 
-        char padding[48];  // 🔧 增加padding到48字节，确保每个entry独占cache line（总共224字节）
+        std::atomic<uint64_t> node_hash;  // hashNodeId(node_id): key of the entry in RegistryIndex
+
+        char padding[40];  // 🔧 padding，确保每个entry独占cache line（总共224字节）
     };
 
     static_assert(sizeof(RegistryEntry) <= 256, "RegistryEntry size too large");
@@ -162,25 +197,72 @@ private:
         std::atomic<uint32_t> num_entries;
         std::atomic<uint32_t> capacity;
         std::atomic<uint32_t> ref_count;                       // 🔧 引用计数：有多少进程正在使用
+        std::atomic<uint32_t> generation;                      // 🔧 Seqlock：写者修改节点集合期间为奇数
         std::atomic<uint32_t> ref_pids[MAX_REGISTRY_ENTRIES];  // 🔧 记录正在使用的进程PID，与节点数一致
     };
 
+    static constexpr uint32_t INDEX_EMPTY = 0;
+    static constexpr uint32_t INDEX_REMOVED = 0xFFFFFFFF;  // Tombstone: probing continues past it
+
+    // Open-addressing hash index node_hash -> entry (linear probing); only changed under global_lock
+    struct RegistryIndex {
+        std::atomic<uint32_t> updating;    // Set while a holder of global_lock changes the index (rebuilt if its
+                                           // process died halfway)
+        std::atomic<uint32_t> tombstones;  // INDEX_REMOVED slots; the index is rebuilt past INDEX_SLOTS / 4
+        std::atomic<uint32_t> slots[INDEX_SLOTS];  // INDEX_EMPTY, INDEX_REMOVED or entry index + 1
+    };
+
     struct RegistryRegion {
         RegistryHeader header;
         RegistryEntry entries[MAX_REGISTRY_ENTRIES];
+        RegistryIndex index;
     };
 
     static constexpr uint32_t MAGIC = 0x4C525247;  // "LRRG" = LibRpc ReGistry
-    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t VERSION = 3;         // 2: hash index, 3: seqlock generation
     static constexpr const char* REGISTRY_SHM_NAME = "/librpc_registry";
+    static constexpr int SEQLOCK_READ_ATTEMPTS = 64;  // Lock-free reads before getAllNodes takes global_lock
 
-    // Helper methods
+    // Helper methods (caller holds global_lock)
     int findEntryIndex(const std::string& node_id) const;
 
+    // Read all valid entries; false if a writer changed the entry set meanwhile (unless @p locked)
+    bool readNodes(std::vector<NodeInfo>& nodes, uint32_t& generation, bool locked) const;
+
+    // FNV-1a of the node ID (never 0)
+    static uint64_t hashNodeId(const std::string& node_id);
+
+    // Add / remove entry @p idx under @p hash
+    void indexInsert(uint64_t hash, uint32_t idx);
+    void indexRemove(uint64_t hash, uint32_t idx);
+    // Re-insert every valid entry (also repairs an index left half-updated by a crashed process)
+    void rebuildIndex() const;
+
     uint64_t getCurrentTimeMs() const;
     bool isProcessAlive(pid_t pid) const;
 
     // 🔧 RAII lock helper for registry global lock
+    // 🔧 Seqlock 写区间：持有 global_lock 时修改节点集合（注册/注销/清理）
+    class GenerationWrite {
+    public:
+        explicit GenerationWrite(std::atomic<uint32_t>& generation) : generation_(generation) {
+            uint32_t value = generation_.load(std::memory_order_relaxed);
+            if (value & 1) {
+                ++value;  // 上一个写者在写区间内死亡（锁以 EOWNERDEAD 恢复）
+            }
+            generation_.store(value + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        // 结束写区间并唤醒 waitForChange 的等待者
+        ~GenerationWrite();
+
+    private:
+        std::atomic<uint32_t>& generation_;
+        GenerationWrite(const GenerationWrite&) = delete;
+        GenerationWrite& operator=(const GenerationWrite&) = delete;
+    };
+
     class RegistryLock {
     public:
         explicit RegistryLock(pthread_mutex_t* mutex, int timeout_ms = 5000) : mutex_(mutex), locked_(false) {
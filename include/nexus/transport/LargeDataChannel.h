@@ -12,23 +12,44 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+
+#include "nexus/utils/ShmMapping.h"
 
 namespace Nexus {
 namespace rpc {
 
+// 数据块校验算法（写入LargeDataHeader::crc_type，读者按头部选择算法校验）
+enum class LargeDataCrc : uint8_t {
+    CRC32 = 0,   // IEEE CRC32（旧版本写者，slicing-by-8软件实现）
+    CRC32C = 1,  // CRC32C（SSE4.2 / ARMv8 CRC指令，默认）
+};
+
 // 大数据块头部
 struct LargeDataHeader {
     uint32_t magic;        // 魔数：0x4C444154 ('LDAT')
     uint32_t size;         // 数据大小
     uint64_t sequence;     // 序列号
-    uint32_t crc32;        // CRC32校验
+    uint32_t crc32;        // 校验值（算法见crc_type）
     char topic[64];        // Topic名称
-    uint8_t reserved[44];  // 保留字段（对齐到128字节）
+    uint8_t crc_type;        // LargeDataCrc
+    uint8_t stream_flags;    // STREAM_*（0：普通数据块）
+    uint32_t chunk_index;    // 流内分块序号（从0开始）
+    uint64_t stream_id;      // 流ID（第0个分块的序列号）
+    uint64_t stream_offset;  // 本分块在整个对象中的偏移
+    uint64_t stream_size;    // 对象总大小（beginStream时未知则为0）
+    uint16_t reader_mask;    // 🔧 只交给这些读者槽位（bit i：读者#i），0：所有读者
+    uint8_t reserved[12];    // 保留字段（对齐到128字节）
 
     static constexpr uint32_t MAGIC = 0x4C444154;
+    static constexpr uint32_t PAD_MAGIC = 0x4C444150;  // 'LDAP'：写者环绕时跳过的尾部
+    static constexpr uint8_t STREAM_CHUNK = 1;    // 属于某个流（writeStream）
+    static constexpr uint8_t STREAM_END = 2;      // 流的最后一个分块
+    static constexpr uint8_t STREAM_ABORTED = 4;  // 写者放弃了该流（与STREAM_END一起出现，分块为空）
 } __attribute__((packed));
 
 static_assert(sizeof(LargeDataHeader) == 128, "LargeDataHeader must be 128 bytes");
@@ -56,29 +77,41 @@ struct RingBufferControl {
     std::atomic<uint64_t> sequence;          // 当前序列号 - 8B
     std::atomic<uint64_t> writer_heartbeat;  // 写端心跳时间戳（秒） - 8B
     std::atomic<int32_t> writer_pid;         // 写端进程ID - 4B
-    char padding1[36];                       // 填充到64字节 - 36B
+    std::atomic<uint32_t> data_seq;          // 提交计数（futex word，waitForData等待其变化） - 4B
+    std::atomic<uint32_t> data_waiters;      // 正在waitForData中等待的读者数 - 4B
+    char padding1[28];                       // 填充到64字节 - 28B
 
     // 读者数组（每个读者独立的Cache line）
     ReaderSlot readers[MAX_READERS];  // 16 × 64B = 1024B
 
     // 共享元数据（Cache line对齐）
-    std::atomic<uint32_t> num_readers;  // 当前读者数量 - 4B
-    std::atomic<int32_t> ref_count;     // 引用计数 - 4B
-    uint64_t capacity;                  // 缓冲区容量 - 8B
-    uint32_t max_block_size;            // 单个数据块最大大小 - 4B
-    uint32_t max_readers;               // 最大读者数量 - 4B
-    char padding2[40];                  // 填充到64字节 - 40B
+    std::atomic<uint32_t> num_readers;   // 当前读者数量 - 4B
+    std::atomic<int32_t> ref_count;      // 引用计数 - 4B
+    uint64_t capacity;                   // 缓冲区容量 - 8B
+    uint32_t max_block_size;             // 单个数据块最大大小 - 4B
+    uint32_t max_readers;                // 最大读者数量 - 4B
+    uint32_t data_offset;                // 环形缓冲区在共享内存中的偏移（0：旧版本，紧跟控制块） - 4B
+    uint32_t flags;                      // FLAG_MIRRORED等（创建者写入，连接者按此映射） - 4B
+    std::atomic<uint32_t> reader_epoch;  // 读者注册次数（写者据此使缓存的最小read_pos失效） - 4B
+    char padding2[28];                   // 填充到64字节 - 28B
+
+    static constexpr uint32_t FLAG_MIRRORED = 1;  // 缓冲区双重映射：数据块可跨越末尾连续存放
 
     RingBufferControl()
         : write_pos(0),
           sequence(0),
           writer_heartbeat(0),
           writer_pid(0),
+          data_seq(0),
+          data_waiters(0),
           num_readers(0),
           ref_count(0),
           capacity(0),
           max_block_size(0),
-          max_readers(MAX_READERS) {
+          max_readers(MAX_READERS),
+          data_offset(0),
+          flags(0),
+          reader_epoch(0) {
         memset(padding1, 0, sizeof(padding1));
         memset(padding2, 0, sizeof(padding2));
     }
@@ -86,9 +119,16 @@ struct RingBufferControl {
 
 // 大数据通道溢出策略
 enum class LargeDataOverflowPolicy {
-    DROP_OLDEST,  // 丢弃最老的数据块（默认，适合视频流）
+    DROP_OLDEST,  // 丢弃最老的数据块（默认，适合视频流）：落后的读者被推进，写者从不等待慢读者
     DROP_NEWEST,  // 丢弃最新的数据块（适合传感器数据）
-    BLOCK         // 阻塞直到有空间（可能导致死锁，慎用）
+    BLOCK         // 阻塞直到有空间，最长 block_timeout_ms，超时后写入失败（背压传递给写者）
+};
+
+// 读者校验策略（每个读者独立配置：同一主机上写者已计算过CRC）
+enum class LargeDataVerifyMode {
+    FULL,     // 每个数据块都重新计算CRC（默认）
+    SAMPLED,  // 每verify_interval个数据块校验一次CRC，其余只检查magic和序列号
+    TRUST     // 信任写者：只检查magic和序列号
 };
 
 // 大数据通道溢出回调
@@ -110,6 +150,16 @@ public:
         bool use_mmap_noreserve;                      // 使用MAP_NORESERVE优化
         LargeDataOverflowPolicy overflow_policy;      // 溢出策略（默认DROP_OLDEST）
         LargeDataOverflowCallback overflow_callback;  // 溢出回调
+        uint32_t block_timeout_ms;                    // BLOCK策略：等待读者释放空间的最长时间（默认100ms）
+        LargeDataCrc crc_type;                        // 写入校验算法（默认CRC32C；CRC32兼容旧版本读者）
+        LargeDataVerifyMode verify_mode;              // 读取校验策略（默认FULL）
+        uint32_t verify_interval;                     // SAMPLED策略：每N个数据块校验一次（默认16）
+        bool huge_pages;                              // 缓冲区使用透明大页（减少TLB miss）
+        bool prefault;                                // 映射时预先分配所有页面（启动变慢，消除首轮写入的缺页）
+        bool lock_memory;                             // mlock缓冲区（受RLIMIT_MEMLOCK限制，失败只告警）
+        bool mirrored;  // 双重映射缓冲区：数据块跨越末尾时连续存放，不浪费尾部空间（buffer_size按页对齐；由创建者决定）
+        size_t stream_chunk_size;  // writeStream拆分的分块大小（默认1MB，不超过max_block_size）
+        int numa_node;             // 创建者将缓冲区mbind到该NUMA节点（-1表示不绑定；连接者忽略）
 
         Config()
             : buffer_size(64 * 1024 * 1024),
@@ -117,7 +167,17 @@ public:
               max_readers(8),
               use_mmap_noreserve(true),
               overflow_policy(LargeDataOverflowPolicy::DROP_OLDEST),
-              overflow_callback(nullptr) {}
+              overflow_callback(nullptr),
+              block_timeout_ms(100),
+              crc_type(LargeDataCrc::CRC32C),
+              verify_mode(LargeDataVerifyMode::FULL),
+              verify_interval(16),
+              huge_pages(false),
+              prefault(false),
+              lock_memory(false),
+              mirrored(false),
+              stream_chunk_size(1024 * 1024),
+              numa_node(-1) {}
     };
 
     // 读取结果枚举
@@ -127,7 +187,8 @@ public:
         CRC_ERROR,      // CRC校验失败
         INVALID_MAGIC,  // Magic不匹配（可能数据未写完）
         SIZE_EXCEEDED,  // 数据大小超限
-        INSUFFICIENT    // 数据不完整
+        INSUFFICIENT,   // 数据不完整
+        SEQUENCE_ERROR  // 序列号回退（未校验CRC的数据块头部损坏）
     };
 
     // 数据块句柄（零拷贝访问）
@@ -136,8 +197,9 @@ public:
         const uint8_t* data;
         size_t size;
         ReadResult result;  // 读取结果
+        uint64_t position;  // 数据块在环形缓冲区中的位置（releaseBlock用来检测是否被写者推进）
 
-        DataBlock() : header(nullptr), data(nullptr), size(0), result(ReadResult::NO_DATA) {}
+        DataBlock() : header(nullptr), data(nullptr), size(0), result(ReadResult::NO_DATA), position(0) {}
 
         bool isValid() const {
             return result == ReadResult::SUCCESS && header && header->magic == LargeDataHeader::MAGIC;
@@ -145,6 +207,17 @@ public:
 
         std::string getTopic() const { return header ? std::string(header->topic) : ""; }
 
+        // 流分块（writeStream）：按stream_offset拼接，出现STREAM_END表示对象结束
+        bool isStreamChunk() const { return header && (header->stream_flags & LargeDataHeader::STREAM_CHUNK); }
+        bool isStreamEnd() const { return header && (header->stream_flags & LargeDataHeader::STREAM_END); }
+        bool isStreamAborted() const { return header && (header->stream_flags & LargeDataHeader::STREAM_ABORTED); }
+
+        // 🔧 数据块是否写给读者reader_id（reserveBlock的reader_mask）；不是的话读者直接releaseBlock跳过
+        bool isFor(int32_t reader_id) const {
+            return header && (header->reader_mask == 0 ||
+                              (reader_id >= 0 && reader_id < 16 && (header->reader_mask >> reader_id) & 1));
+        }
+
         const char* getResultString() const {
             switch (result) {
                 case ReadResult::SUCCESS:
@@ -159,6 +232,8 @@ public:
                     return "SIZE_EXCEEDED";
                 case ReadResult::INSUFFICIENT:
                     return "INSUFFICIENT";
+                case ReadResult::SEQUENCE_ERROR:
+                    return "SEQUENCE_ERROR";
                 default:
                     return "UNKNOWN";
             }
@@ -174,12 +249,52 @@ public:
     // 注意：data会被直接写入共享内存，调用者可以在返回后释放原始data
     int64_t write(const std::string& topic, const uint8_t* data, size_t size);
 
+    // 零拷贝写入：在环形缓冲区内预留size字节，返回可写指针（失败返回nullptr，溢出策略同write）
+    // 生产者（DMA读取、编码器等）直接填充共享内存，然后调用commitBlock发布；
+    // 同一时刻只能有一个预留块，commit/abort之前读者看不到该块
+    // 🔧 reader_mask非0时数据块只写给这些读者槽位（见DataBlock::isFor），其他读者照常读到并跳过
+    uint8_t* reserveBlock(const std::string& topic, size_t size, uint16_t reader_mask = 0);
+
+    // 发布预留块：写入CRC、magic并推进write_pos（返回序列号，-1表示没有预留块）
+    // @param size 实际写入的字节数（<= 预留大小，编码器可预留上限后按实际大小提交）
+    int64_t commitBlock();
+    int64_t commitBlock(size_t size);
+
+    // 放弃预留块（不推进write_pos，不占用序列号）
+    void abortBlock();
+
+    // 流式写入：超过max_block_size的对象拆成多个分块（同一stream_id），读者在写者写完之前就能处理前面的分块，
+    // 写者也不需要整个对象常驻内存。同一时刻只能有一个流
+    // @param total_size 对象总大小（未知传0，写入每个分块头部）
+    bool beginStream(const std::string& topic, uint64_t total_size = 0);
+
+    // 追加数据（按stream_chunk_size拆分，溢出策略同write）；last=true时最后一个分块带STREAM_END（size可以为0）
+    // 返回最后一个分块的序列号，-1表示失败：已提交的分块不回退（见getStreamOffset），流保持打开，可重试或abortStream
+    int64_t writeStream(const uint8_t* data, size_t size, bool last = false);
+
+    // 放弃当前流：写入一个带STREAM_END | STREAM_ABORTED的空分块，读者丢弃已收到的分块
+    void abortStream();
+
+    bool inStream() const { return stream_active_; }
+    uint64_t getStreamOffset() const { return stream_offset_; }  // 当前流已提交的字节数
+
+    // 🔧 立即注册为读者，返回读者槽位（-1表示读者已满）；重复调用返回已有槽位
+    // from_latest=true：从当前write_pos开始，只读注册之后写入的数据块（默认从0开始，读取缓冲区中仍有效的旧数据）
+    int32_t attachReader(bool from_latest = false);
+    int32_t getReaderId() const { return reader_id_; }
+
     // 尝试读取一个数据块（非阻塞）
     // 返回的DataBlock指向共享内存，读取完后必须调用releaseBlock
     bool tryRead(DataBlock& block);
 
+    // 阻塞等待本读者有可读数据（返回false表示超时）
+    // Linux上读者在控制块的futex word上睡眠，写者只在有等待者时才发起唤醒系统调用；
+    // 其他平台退化为有界退避轮询。适合专用读线程：waitForData + tryRead循环，无需通知消息
+    bool waitForData(int timeout_ms);
+
     // 释放已读取的数据块（更新read_pos）
-    void releaseBlock(const DataBlock& block);
+    // 返回false：DROP_OLDEST写者在读取期间推进了本读者，数据块可能已被覆盖（已调用overflow_callback）
+    bool releaseBlock(const DataBlock& block);
 
     // 获取统计信息
     struct Stats {
@@ -189,6 +304,10 @@ public:
         uint64_t total_bytes_read;
         uint64_t current_usage;  // 当前占用字节数
         uint64_t capacity;
+        uint64_t reader_lag;              // 🔧 本读者尚未读取的字节数（未注册为读者时为0）
+        LargeDataVerifyMode verify_mode;  // 本读者的校验策略
+        uint64_t blocks_verified;         // 本读者重新计算过CRC的数据块数
+        int numa_node;                    // 控制块所在的NUMA节点（-1表示未知）
 
         double usage_percent() const {
             return capacity > 0 ? (static_cast<double>(current_usage) * 100.0 / static_cast<double>(capacity)) : 0.0;
@@ -197,14 +316,28 @@ public:
 
     Stats getStats() const;
 
+    // 🔧 内存占用：mapped为共享内存对象大小（双重映射的第二个视图不重复计入），resident为其中已在内存中的页（mincore）
+    MappingUsage getMemoryUsage() const;
+
     // 获取可用空间
     size_t getAvailableSpace() const;
 
+    // 获取缓冲区容量
+    size_t getCapacity() const { return control_->capacity; }
+
     // 检查是否可以写入指定大小
     bool canWrite(size_t size) const;
 
     // 设置溢出策略（动态修改）
     void setOverflowPolicy(LargeDataOverflowPolicy policy);
+    LargeDataOverflowPolicy getOverflowPolicy() const { return config_.overflow_policy; }
+
+    // 缓冲区是否双重映射（创建者的Config::mirrored）
+    bool isMirrored() const { return mirrored_; }
+
+    // 设置本读者的校验策略（动态修改；interval仅用于SAMPLED，0按1处理）
+    void setVerifyMode(LargeDataVerifyMode mode, uint32_t interval = 16);
+    LargeDataVerifyMode getVerifyMode() const { return config_.verify_mode; }
 
     // 设置溢出回调（动态修改）
     void setOverflowCallback(LargeDataOverflowCallback callback);
@@ -219,21 +352,28 @@ private:
     LargeDataChannel(const std::string& shm_name, const Config& config);
 
     bool initialize();
-    ReadResult validateBlock(const LargeDataHeader* header, size_t available) const;
-    uint32_t calculateCRC32(const uint8_t* data, size_t size) const;
+    ReadResult validateBlock(const LargeDataHeader* header, size_t available, bool verify_crc) const;
+    static uint32_t calculateCRC(LargeDataCrc type, const uint8_t* data, size_t size);
+    int64_t publishBlock(size_t size, const uint32_t* crc, uint8_t stream_flags = 0);  // crc非空：写入时已计算
+    int64_t writeStreamChunk(const uint8_t* data, size_t size, uint8_t stream_flags);
 
     // SPMC相关私有方法
-    int32_t registerReader();                       // 注册读者，返回reader_id（-1表示失败）
+    int32_t registerReader(bool from_latest);       // 注册读者（from_latest：从write_pos开始），返回reader_id
     void unregisterReader(int32_t reader_id);       // 注销读者
     uint64_t getMinReadPos() const;                 // 获取所有读者中的最小read_pos（用于垃圾回收）
-    void updateReaderHeartbeat(int32_t reader_id);  // 更新读者心跳
-    void cleanupDeadReaders();                      // 清理死亡的读者
+    uint64_t refreshMinReadPos();                   // 扫描读者并更新写端缓存的最小read_pos
+    void updateReaderHeartbeat(int32_t reader_id);  // 更新读者心跳（每秒最多写一次共享内存）
+    void cleanupDeadReaders(bool force = false);    // 清理死亡的读者（force：忽略清理间隔）
+    bool waitForSpace(size_t total_size);           // BLOCK策略：有界等待可用空间
+    size_t evictLaggingReaders(uint64_t required_pos, const std::string& topic);  // DROP_OLDEST：推进落后读者
 
     std::string shm_name_;
     Config config_;
     int shm_fd_;
     void* shm_addr_;
-    size_t shm_size_;
+    size_t shm_size_;  // 共享内存对象大小
+    size_t map_size_;  // shm_addr_处映射的字节数（双重映射时大于shm_size_）
+    bool mirrored_;
 
     RingBufferControl* control_;
     uint8_t* buffer_;
@@ -241,12 +381,43 @@ private:
     // 当前读者ID（每个LargeDataChannel实例）
     int32_t reader_id_;
 
+    // 读端校验状态：下一个数据块的最小序列号、距上次CRC校验的数据块数
+    uint64_t next_sequence_;
+    uint32_t unverified_blocks_;
+
+    // 写端：缓存的最小read_pos及扫描时的reader_epoch。读者只会前进、注销只会让最小值变大，
+    // 所以缓存值偏保守；只有空间看起来不够或有新读者注册时才重新扫描读者数组
+    uint64_t cached_min_read_pos_;
+    uint32_t cached_reader_epoch_;
+
+    // 上次清理死亡读者、上次写入心跳的时间（秒）；心跳值相同时不再写共享内存
+    uint64_t last_cleanup_;
+    uint64_t last_writer_heartbeat_;
+    uint64_t last_reader_heartbeat_;
+
+    // 写端：已提交且可能仍有读者未读的数据块（位置，序列号），DROP_OLDEST用来把读者推进到数据块边界
+    std::deque<std::pair<uint64_t, uint64_t>> committed_blocks_;
+
+    // reserveBlock预留、尚未提交的数据块（nullptr表示没有）
+    LargeDataHeader* reserved_header_;
+    size_t reserved_size_;
+    uint16_t reserved_reader_mask_;
+
+    // 写端：当前流（beginStream）
+    bool stream_active_;
+    std::string stream_topic_;
+    uint64_t stream_id_;
+    uint32_t stream_chunk_;
+    uint64_t stream_offset_;
+    uint64_t stream_size_;
+
     // 统计信息
     mutable std::atomic<uint64_t> total_writes_;
     mutable std::atomic<uint64_t> total_reads_;
     mutable std::atomic<uint64_t> total_bytes_written_;
     mutable std::atomic<uint64_t> total_bytes_read_;
     mutable std::atomic<uint64_t> total_dropped_;  // 总丢弃数量
+    mutable std::atomic<uint64_t> blocks_verified_;
 };
 
 // 通知消息（通过V3队列发送）
@@ -261,5 +432,19 @@ struct LargeDataNotification {
 
 static_assert(sizeof(LargeDataNotification) == 128, "LargeDataNotification must be 128 bytes");
 
+// 网络桥接的数据块（Node::bridgeLargeData）：消息负载为本头部加数据块内容，接收端按头部写入本地通道
+struct LargeDataBridgeHeader {
+    uint64_t sequence;       // 8B - 源通道中的序列号
+    uint64_t stream_id;      // 8B - 流分块：源通道的stream_id
+    uint64_t stream_offset;  // 8B - 流分块：本分块在整个对象中的偏移
+    uint64_t stream_size;    // 8B - 流分块：对象总大小（未知为0）
+    uint32_t size;           // 4B - 数据块大小（头部之后的字节数）
+    uint8_t stream_flags;    // 1B - LargeDataHeader::STREAM_*
+    uint8_t reserved[3];     // 3B - 对齐
+    char topic[64];          // 64B - Topic
+} __attribute__((packed));
+
+static_assert(sizeof(LargeDataBridgeHeader) == 104, "LargeDataBridgeHeader must be 104 bytes");
+
 }  // namespace rpc
 }  // namespace Nexus
@@ -26,8 +26,10 @@ class alignas(64) LockFreeRingBuffer {
 public:
     // Optimized for variable length messages
     // Header: 8 bytes (length + magic)
-    // Payload: Variable
-    static constexpr size_t MAX_MSG_SIZE = 2040;
+    // Payload: Variable, stored contiguously (no fragmentation)
+    // Limit: a quarter of the ring (minus header), so a frame always fits into an
+    // empty queue wherever head happens to be; never below the historical 2040 bytes.
+    static constexpr size_t MAX_MSG_SIZE = (BUFFER_SIZE / 4 > 2048 ? BUFFER_SIZE / 4 : 2048) - 8;
 
     struct FrameHeader {
         uint32_t length; // Total length including header. If 0, it's padding.
@@ -43,84 +45,148 @@ public:
         stats_messages_written_.store(0, std::memory_order_relaxed);
         stats_messages_read_.store(0, std::memory_order_relaxed);
         stats_messages_dropped_.store(0, std::memory_order_relaxed);
+        capacity_ = BUFFER_SIZE;
         // Initialize buffer with zeros to avoid confusion? Not strictly necessary.
         memset(buffer_, 0, BUFFER_SIZE);
     }
 
     /**
-     * @brief Try to write a message (producer side)
-     * @param data Message data
-     * @param size Message size
-     * @return true if written successfully, false if queue is full
+     * @brief Restrict the ring to the first @p bytes of its storage
+     *
+     * Lets shared-memory users size a queue at runtime: pages beyond the
+     * capacity are never touched, so they are never backed by memory.
+     * Must be called before the first write. A ring placed in zero-filled
+     * memory without construction reports the full BUFFER_SIZE.
+     *
+     * @param bytes Requested capacity (rounded down to 8 bytes, clamped to BUFFER_SIZE)
      */
-    bool tryWrite(const uint8_t* data, size_t size) {
-        if (size > MAX_MSG_SIZE || size == 0) {
+    void setCapacity(size_t bytes) {
+        bytes &= ~static_cast<size_t>(7);
+        capacity_ = (bytes == 0 || bytes > BUFFER_SIZE) ? BUFFER_SIZE : bytes;
+    }
+
+    /**
+     * @brief Usable ring size in bytes
+     */
+    size_t capacity() const { return capacity_ ? capacity_ : BUFFER_SIZE; }
+
+    /**
+     * @brief Largest payload accepted by this ring (MAX_MSG_SIZE rule applied to capacity())
+     */
+    size_t maxMessageSize() const {
+        size_t cap = capacity();
+        size_t max_size = (cap / 4 > 2048 ? cap / 4 : 2048) - 8;
+        return max_size < MAX_MSG_SIZE ? max_size : MAX_MSG_SIZE;
+    }
+
+    /**
+     * @brief Frame slot reserved for in-place writing (producer side)
+     *
+     * Obtained from tryReserve(); the producer fills `data` and then calls
+     * commit(). Nothing becomes visible to the consumer before commit().
+     * tryReserveNext() chains further frames behind an uncommitted one, so a
+     * whole batch is published by committing its last reservation.
+     */
+    struct Reservation {
+        uint8_t* data;       // Writable payload area inside the ring
+        size_t size;         // Reserved payload size
+        uint64_t next_head;  // Head position published by commit()
+        uint32_t frames;     // Frames published by commit() (>1 for chained reservations)
+
+        Reservation() : data(nullptr), size(0), next_head(0), frames(0) {}
+    };
+
+    /**
+     * @brief Reserve space for a message without copying (producer side)
+     * @param size Payload size to reserve
+     * @param out Reservation describing the writable span
+     * @return true if reserved, false if queue is full or size is invalid
+     */
+    bool tryReserve(size_t size, Reservation& out) {
+        return reserveAt(head_.load(std::memory_order_acquire), 0, size, out);
+    }
+
+    /**
+     * @brief Reserve a frame directly behind an uncommitted reservation (producer side)
+     * @param prev Last reservation of the batch (not yet committed)
+     * @param size Payload size to reserve
+     * @param out Reservation covering the batch up to and including the new frame
+     * @return true if reserved, false if queue is full or size is invalid
+     */
+    bool tryReserveNext(const Reservation& prev, size_t size, Reservation& out) {
+        return reserveAt(prev.next_head, prev.frames, size, out);
+    }
+
+    /**
+     * @brief Check the consumer's credit without reserving (producer side)
+     * @param size Payload size the producer wants to write
+     * @return true if tryReserve(size) would succeed now
+     *
+     * The consumer advertises free space through its tail; since only the
+     * consumer moves the tail, the answer stays valid (or gets better) until
+     * the producer writes.
+     */
+    bool canReserve(size_t size) const {
+        if (size > maxMessageSize() || size == 0) {
             return false;
         }
 
-        // Calculate required space aligned to 8 bytes
-        // Header (8) + Data (size) + Padding (0-7)
+        const size_t cap = capacity();
         size_t needed = (sizeof(FrameHeader) + size + 7) & ~7;
-
-        // Load indices with acquire semantics
-        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_relaxed);
         uint64_t tail = tail_.load(std::memory_order_acquire);
 
-        // Check space and write
         if (head >= tail) {
-            // Free space: [head, BUFFER_SIZE) and [0, tail)
-            
-            // Try to fit at the end
-            if (head + needed <= BUFFER_SIZE) {
-                writeFrame(head, data, size, needed, MAGIC_VALID);
-                head_.store(head + needed, std::memory_order_release);
-                stats_messages_written_.fetch_add(1, std::memory_order_relaxed);
-                return true;
-            }
-            
-            // Try to wrap around
-            // We need to write padding at [head, BUFFER_SIZE)
-            // And write data at [0, tail)
-            
-            // Check if we have enough space at the beginning
-            // We need 'needed' bytes strictly less than 'tail' to avoid head==tail (empty)
-            if (needed < tail) {
-                // Write padding at the end
-                size_t pad_len = BUFFER_SIZE - head;
-                if (pad_len >= sizeof(FrameHeader)) {
-                    FrameHeader padHdr = {static_cast<uint32_t>(pad_len), MAGIC_PADDING};
-                    memcpy(&buffer_[head], &padHdr, sizeof(padHdr));
-                }
-                
-                // Write data at 0
-                writeFrame(0, data, size, needed, MAGIC_VALID);
-                head_.store(needed, std::memory_order_release);
-                stats_messages_written_.fetch_add(1, std::memory_order_relaxed);
-                return true;
-            }
-        } else {
-            // head < tail
-            // Free space: [head, tail)
-            if (head + needed < tail) {
-                writeFrame(head, data, size, needed, MAGIC_VALID);
-                head_.store(head + needed, std::memory_order_release);
-                stats_messages_written_.fetch_add(1, std::memory_order_relaxed);
-                return true;
-            }
+            return head + needed <= cap || needed < tail;
         }
+        return head + needed < tail;
+    }
 
-        // Queue full
-        stats_messages_dropped_.fetch_add(1, std::memory_order_relaxed);
-        return false;
+    /**
+     * @brief Publish a frame (or a chained batch) previously reserved
+     * @param reservation Last reservation to publish
+     */
+    void commit(const Reservation& reservation) {
+        head_.store(reservation.next_head, std::memory_order_release);
+        stats_messages_written_.fetch_add(reservation.frames, std::memory_order_relaxed);
     }
 
     /**
-     * @brief Try to read a message (consumer side)
-     * @param out_data Output buffer for message data (min MAX_MSG_SIZE bytes)
-     * @param out_size Output message size
-     * @return true if read successfully, false if queue is empty
+     * @brief Try to write a message (producer side)
+     * @param data Message data
+     * @param size Message size
+     * @return true if written successfully, false if queue is full
      */
-    bool tryRead(uint8_t* out_data, size_t& out_size) {
+    bool tryWrite(const uint8_t* data, size_t size) {
+        Reservation reservation;
+        if (!tryReserve(size, reservation)) {
+            return false;
+        }
+        memcpy(reservation.data, data, size);
+        commit(reservation);
+        return true;
+    }
+
+    /**
+     * @brief Read-only view of the next frame (consumer side)
+     *
+     * Obtained from tryPeek(); `data` points into the ring and stays valid
+     * until consume() is called, since the producer cannot reuse the space before.
+     */
+    struct ReadView {
+        const uint8_t* data;  // Payload inside the ring
+        size_t size;          // Payload size
+        uint64_t next_tail;   // Tail position published by consume()
+
+        ReadView() : data(nullptr), size(0), next_tail(0) {}
+    };
+
+    /**
+     * @brief Look at the next message without removing it (consumer side)
+     * @param out View of the message payload
+     * @return true if a message is available, false if queue is empty
+     */
+    bool tryPeek(ReadView& out) {
         // Load indices with acquire semantics
         uint64_t tail = tail_.load(std::memory_order_acquire);
         uint64_t head = head_.load(std::memory_order_acquire);
@@ -131,19 +197,20 @@ public:
 
         // Read header
         FrameHeader header;
-        memcpy(&header, &buffer_[tail], sizeof(header));
+        if (tail + sizeof(FrameHeader) <= capacity()) {
+            memcpy(&header, &buffer_[tail], sizeof(header));
+        } else {
+            // Previous frame ended exactly at the end of the buffer: implicit wrap
+            header.length = 0;
+            header.magic = MAGIC_PADDING;
+        }
 
         // Handle padding
         if (header.magic == MAGIC_PADDING) {
-            // Wrap around
+            // Wrap around: the padding is consumed, release it to the producer
             tail = 0;
-            // Update tail to 0 and re-check
-            // Note: We don't update tail_ yet, we just move our local pointer
-            // But wait, if we don't update tail_, the producer won't see the space freed.
-            // However, we are consuming the padding.
-            // Let's update tail_ to 0.
             tail_.store(0, std::memory_order_release);
-            
+
             if (tail == head) {
                 return false; // Should not happen if padding exists
             }
@@ -156,7 +223,7 @@ public:
         }
 
         size_t payload_len = header.length;
-        if (payload_len > MAX_MSG_SIZE) {
+        if (payload_len > maxMessageSize()) {
              // Corruption
              return false;
         }
@@ -164,13 +231,36 @@ public:
         // Calculate total length (aligned)
         size_t total_len = (sizeof(FrameHeader) + payload_len + 7) & ~7;
 
-        memcpy(out_data, &buffer_[tail + sizeof(FrameHeader)], payload_len);
-        out_size = payload_len;
+        out.data = &buffer_[tail + sizeof(FrameHeader)];
+        out.size = payload_len;
+        out.next_tail = tail + total_len;
+        return true;
+    }
 
+    /**
+     * @brief Release a message previously obtained from tryPeek()
+     * @param view View to release; its data must not be used afterwards
+     */
+    void consume(const ReadView& view) {
         // Advance tail with release semantics
-        tail_.store(tail + total_len, std::memory_order_release);
-
+        tail_.store(view.next_tail, std::memory_order_release);
         stats_messages_read_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Try to read a message (consumer side)
+     * @param out_data Output buffer for message data (min MAX_MSG_SIZE bytes)
+     * @param out_size Output message size
+     * @return true if read successfully, false if queue is empty
+     */
+    bool tryRead(uint8_t* out_data, size_t& out_size) {
+        ReadView view;
+        if (!tryPeek(view)) {
+            return false;
+        }
+        memcpy(out_data, view.data, view.size);
+        out_size = view.size;
+        consume(view);
         return true;
     }
 
@@ -181,7 +271,7 @@ public:
         uint64_t head = head_.load(std::memory_order_acquire);
         uint64_t tail = tail_.load(std::memory_order_acquire);
         if (head >= tail) return head - tail;
-        return BUFFER_SIZE - (tail - head);
+        return capacity() - (tail - head);
     }
 
     /**
@@ -208,22 +298,81 @@ public:
     }
 
 private:
-    void writeFrame(size_t offset, const uint8_t* data, size_t payload_size, size_t total_len, uint32_t magic) {
-        FrameHeader hdr;
-        if (magic == MAGIC_VALID) {
-            hdr.length = static_cast<uint32_t>(payload_size);
+    bool reserveAt(uint64_t head, uint32_t frames, size_t size, Reservation& out) {
+        if (size > maxMessageSize() || size == 0) {
+            return false;
+        }
+
+        const size_t cap = capacity();
+
+        // Calculate required space aligned to 8 bytes
+        // Header (8) + Data (size) + Padding (0-7)
+        size_t needed = (sizeof(FrameHeader) + size + 7) & ~7;
+
+        // Load tail with acquire semantics
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+
+        // Check space and reserve
+        if (head >= tail) {
+            // Free space: [head, cap) and [0, tail)
+
+            // Try to fit at the end
+            if (head + needed <= cap) {
+                reserveFrame(head, size, needed, frames, out);
+                return true;
+            }
+
+            // Try to wrap around
+            // We need to write padding at [head, cap)
+            // And write data at [0, tail)
+
+            // Check if we have enough space at the beginning
+            // We need 'needed' bytes strictly less than 'tail' to avoid head==tail (empty)
+            if (needed < tail) {
+                // Write padding at the end (invisible to the consumer until commit)
+                size_t pad_len = cap - head;
+                if (pad_len >= sizeof(FrameHeader)) {
+                    FrameHeader padHdr = {static_cast<uint32_t>(pad_len), MAGIC_PADDING};
+                    memcpy(&buffer_[head], &padHdr, sizeof(padHdr));
+                }
+
+                // Reserve data at 0
+                reserveFrame(0, size, needed, frames, out);
+                return true;
+            }
         } else {
-            hdr.length = static_cast<uint32_t>(total_len);
+            // head < tail
+            // Free space: [head, tail)
+            if (head + needed < tail) {
+                reserveFrame(head, size, needed, frames, out);
+                return true;
+            }
         }
-        hdr.magic = magic;
+
+        // Queue full
+        stats_messages_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void reserveFrame(size_t offset, size_t payload_size, size_t total_len, uint32_t frames, Reservation& out) {
+        FrameHeader hdr;
+        hdr.length = static_cast<uint32_t>(payload_size);
+        hdr.magic = MAGIC_VALID;
         memcpy(&buffer_[offset], &hdr, sizeof(hdr));
-        memcpy(&buffer_[offset + sizeof(hdr)], data, payload_size);
+
+        out.data = &buffer_[offset + sizeof(hdr)];
+        out.size = payload_size;
+        out.next_head = offset + total_len;
+        out.frames = frames + 1;
     }
 
     // Cache-line aligned atomic indices to avoid false sharing
     alignas(64) std::atomic<uint64_t> head_;  // Write position (byte offset)
     alignas(64) std::atomic<uint64_t> tail_;  // Read position (byte offset)
 
+    // Usable size of buffer_ (0 = BUFFER_SIZE, for zero-filled shared memory)
+    alignas(64) uint64_t capacity_;
+
     // Statistics (relaxed ordering is fine)
     alignas(64) std::atomic<uint64_t> stats_messages_written_;
     alignas(64) std::atomic<uint64_t> stats_messages_read_;
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexus/core/Message.h"
+#include "nexus/utils/StringView.h"
+
+namespace Nexus {
+namespace rpc {
+
+class UdpTransport;
+
+/**
+ * @brief Reliable, fragmented messages over a UdpTransport
+ *
+ * A message is cut into fragments (RELIABLE_DATA packets) that carry
+ * consecutive sequence numbers of the sender's stream to that destination.
+ * At most `window` fragments are unacknowledged at a time; send() waits for
+ * acknowledgements beyond that. The receiver reorders fragments, reassembles
+ * messages and delivers them whole and in order, and answers with
+ * RELIABLE_ACK packets: a cumulative acknowledgement plus the sequence
+ * numbers it is missing (NACKs), which the sender resends. A fragment that
+ * stays unacknowledged for `retransmit_ms` is resent as well, which covers a
+ * lost tail that no later fragment could reveal.
+ *
+ * A stream without any acknowledgement for `timeout_ms` is restarted under a
+ * new stream id; the receiver drops the message it was assembling and
+ * resynchronizes on the next message.
+ */
+class ReliableUdpChannel {
+public:
+    struct Options {
+        size_t fragment_size = 1200;                   // Message bytes per fragment
+        uint32_t window = 64;                          // Unacknowledged fragments per destination
+        uint32_t retransmit_ms = 20;                   // Resend an unacknowledged fragment after this long
+        uint32_t timeout_ms = 2000;                    // Max wait for window space; stream restart after silence
+        size_t max_message_size = 64 * 1024 * 1024;    // Largest message reassembled
+        ChecksumType checksum = ChecksumType::CRC32C;  // Of every packet sent
+    };
+
+    struct Stats {
+        uint64_t messages_sent = 0;       // Messages handed to send()
+        uint64_t fragments_sent = 0;      // First transmissions
+        uint64_t retransmits = 0;         // Fragments resent (NACK or timer)
+        uint64_t messages_delivered = 0;  // Messages reassembled and passed to the callback
+        uint64_t nacks_sent = 0;          // Missing sequence numbers reported to senders
+        uint64_t streams_reset = 0;       // Send streams restarted after timeout_ms without acknowledgement
+    };
+
+    // Reassembled message; @p payload is only valid during the callback
+    using MessageCallback = std::function<void(StringView source_node, StringView group, StringView topic,
+                                               const uint8_t* payload, size_t size)>;
+
+    /**
+     * @param transport Socket fragments and acknowledgements are sent from (must outlive the channel)
+     * @param node_id Node ID written into every packet
+     */
+    ReliableUdpChannel(UdpTransport& transport, const std::string& node_id, const Options& options);
+    ~ReliableUdpChannel();
+
+    ReliableUdpChannel(const ReliableUdpChannel&) = delete;
+    ReliableUdpChannel& operator=(const ReliableUdpChannel&) = delete;
+
+    /**
+     * @brief Send one message, fragmented, to @p dest
+     *
+     * Returns once every fragment has been sent (not acknowledged). Messages
+     * to the same destination are delivered in the order they were sent.
+     * @return false if the message exceeds max_message_size or the window
+     *         stayed full for timeout_ms (the receiver stopped acknowledging)
+     */
+    bool send(const sockaddr_in& dest, const std::string& group, const std::string& topic, const uint8_t* payload,
+              size_t size);
+
+    /**
+     * @brief Handle a RELIABLE_DATA or RELIABLE_ACK packet received on the transport
+     * @param packet Validated packet
+     * @param from Sender's socket address (acknowledgements go to its IP and packet.udp_port)
+     */
+    void handlePacket(const MessagePacket& packet, const sockaddr_in& from);
+
+    void setMessageCallback(MessageCallback callback);
+
+    Stats getStats() const;
+
+    // Receiver-side bound on fragments held out of order per stream (window is clamped to it)
+    static constexpr uint32_t MAX_OUT_OF_ORDER = 8192;
+    // Missing sequence numbers listed in one RELIABLE_ACK
+    static constexpr uint16_t MAX_NACKS = 64;
+    // In-order fragments received between two cumulative acknowledgements
+    static constexpr uint32_t ACK_EVERY = 32;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct SentFragment {
+        uint32_t seq;
+        std::vector<uint8_t> datagram;  // Complete RELIABLE_DATA packet
+        Clock::time_point sent_at;
+    };
+
+    // Sender side: one stream per destination
+    struct SendStream {
+        sockaddr_in dest;
+        uint32_t stream_id = 0;
+        uint32_t next_seq = 0;
+        std::deque<SentFragment> unacked;  // Consecutive sequence numbers from unacked.front().seq
+        Clock::time_point last_ack;        // Last acknowledgement (or first fragment put in flight)
+        bool busy = false;                 // A send() is between the first and last fragment of a message
+    };
+
+    struct HeldFragment {
+        ReliableFragment header;
+        std::string group;  // Only kept for the first fragment of a message
+        std::string topic;
+        std::vector<uint8_t> data;
+    };
+
+    // Receiver side: one stream per sending node
+    struct ReceiveStream {
+        uint32_t stream_id = 0;
+        uint32_t next_seq = 0;                     // Next fragment to deliver
+        uint32_t end_seq = 0;                      // One past the highest fragment seen
+        std::map<uint32_t, HeldFragment> pending;  // Received ahead of next_seq
+        sockaddr_in reply_to{};                    // Sender's socket (acknowledgements)
+        uint32_t since_ack = 0;
+        // Message being reassembled
+        bool assembling = false;
+        std::string group;
+        std::string topic;
+        std::vector<uint8_t> message;
+        size_t filled = 0;
+    };
+
+    struct Completed {
+        std::string group;
+        std::string topic;
+        std::vector<uint8_t> payload;
+    };
+
+    void handleData(const MessagePacket& packet, const sockaddr_in& from);
+    void handleAck(const MessagePacket& packet);
+
+    // Append one in-order fragment to the message being reassembled (caller holds mutex_)
+    void consumeFragment(ReceiveStream& stream, const ReliableFragment& header, StringView group, StringView topic,
+                         const uint8_t* data, size_t size, std::vector<Completed>& completed);
+
+    // Cumulative acknowledgement plus the first MAX_NACKS holes below end_seq (caller holds mutex_)
+    void sendAck(ReceiveStream& stream);
+
+    // Send fragments [first, unacked.end()) of a stream (caller holds mutex_)
+    void flushFragments(SendStream& stream, size_t first);
+
+    void resend(SendStream& stream, SentFragment& fragment, Clock::time_point now);
+
+    // Resend stalled fragments and restart silent streams
+    void retransmitThread();
+
+    uint32_t newStreamId() { return next_stream_id_++; }
+
+    static uint64_t destinationKey(const sockaddr_in& dest);
+
+    UdpTransport& transport_;
+    const std::string node_id_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable window_cv_;                     // Window space freed or stream restarted
+    std::condition_variable retransmit_cv_;                 // Fragments in flight or shutdown
+    std::map<uint64_t, SendStream> send_streams_;           // By destination address and port
+    std::map<std::string, ReceiveStream> receive_streams_;  // By sending node ID
+    size_t in_flight_ = 0;                                  // Unacknowledged fragments over all streams
+    uint32_t next_stream_id_;
+    Stats stats_;
+    bool stopping_ = false;
+
+    MessageCallback callback_;
+    std::mutex callback_mutex_;
+
+    std::thread retransmit_thread_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
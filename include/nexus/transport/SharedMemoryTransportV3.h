@@ -6,17 +6,25 @@
 #include <semaphore.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "nexus/core/Message.h"
 #include "nexus/registry/SharedMemoryRegistry.h"
 #include "nexus/transport/LockFreeQueue.h"
+#include "nexus/utils/MaintenanceScheduler.h"
+#include "nexus/utils/ShmMapping.h"
+#include "nexus/utils/ThreadPlacement.h"
 
 namespace Nexus {
 namespace rpc {
@@ -38,6 +46,14 @@ class NodeImpl;
  * - Memory efficient (only allocate what's needed)
  * - Better isolation (each node manages its own memory)
  * - Same lock-free SPSC performance as V2
+ *
+ * Shared inbox (Config::shared_inbox on the receiver): one multi-producer
+ * ring in the node's memory that every sender can write to, so senders are
+ * no longer capped at MAX_INBOUND_QUEUES. Senders start out on the inbox and
+ * claim a dedicated queue once they send faster than their
+ * Config::inbox_promote_rate (or need frames larger than an inbox slot).
+ * A full inbox applies the frame's lane overflow policy like a dedicated
+ * queue: BLOCK waits for the receiver, DROP fails at once.
  */
 class SharedMemoryTransportV3 {
 public:
@@ -47,24 +63,82 @@ public:
     enum class NotifyMechanism {
         CONDITION_VARIABLE,  // Condition Variable (传统方案，可靠)
         SEMAPHORE,           // POSIX Semaphore (推荐，低CPU高可靠)
-        SMART_POLLING        // 智能轮询 (自旋+指数退避，超低延迟)
+        SMART_POLLING        // 智能轮询 (先自旋spin_budget_us，再阻塞等待，超低延迟)
     };
 
     // Queue capacities in bytes (Variable-length RingBuffer)
     // Control Queue: 128KB (Enough for ~2000 small control messages)
     static constexpr size_t CONTROL_QUEUE_SIZE_BYTES = 16 * 1024;
     // Data Queue: 512KB (Enough for ~256 large 2KB messages or ~8000 small messages)
+    // Frames up to 128KB, so any MessagePacket (payload <= 64KB) fits in a single frame
     static constexpr size_t DATA_QUEUE_SIZE_BYTES = 524288;
+    // Largest data frame: a MessagePacket with full group, topic and payload, plus the longest trailer
+    static constexpr size_t MAX_DATA_FRAME_BYTES = sizeof(MessagePacket) + MessagePacket::MAX_GROUP_LEN +
+                                                   MessagePacket::MAX_TOPIC_LEN + MessagePacket::MAX_PAYLOAD_LEN +
+                                                   sizeof(DeadlineStamp);
+    static_assert(LockFreeRingBuffer<DATA_QUEUE_SIZE_BYTES>::MAX_MSG_SIZE >= MAX_DATA_FRAME_BYTES,
+                  "data queue too small for a full MessagePacket");
+    // Smallest runtime data queue capacity (Config::queue_capacity is clamped to
+    // [MIN_DATA_QUEUE_SIZE_BYTES, DATA_QUEUE_SIZE_BYTES]); pages past the capacity are never touched.
+    // A ring accepts frames up to a quarter of its capacity, so this keeps MAX_DATA_FRAME_BYTES
+    // (plus the 8-byte frame header) within one reservation; rounded up to whole pages
+    static constexpr size_t MIN_DATA_QUEUE_SIZE_BYTES =
+        (4 * (MAX_DATA_FRAME_BYTES + 8) + 4095) & ~static_cast<size_t>(4095);
+    static_assert(MIN_DATA_QUEUE_SIZE_BYTES <= DATA_QUEUE_SIZE_BYTES, "data queue too small for a full MessagePacket");
+
+    // Data priority lanes per inbound queue, each a DATA_QUEUE_SIZE_BYTES ring drained after the control queue.
+    // Lane 0 is the most urgent; Node::MessagePriority values are lane indices (HIGH, NORMAL, BULK)
+    static constexpr uint32_t DATA_LANES = 3;
+    static constexpr uint32_t DEFAULT_DATA_LANE = 1;
+    static constexpr uint32_t BULK_DATA_LANE = 2;
+    // The BULK lane runs at this fraction of the queue capacity (never below MIN_DATA_QUEUE_SIZE_BYTES),
+    // so a busy sender fills at most 2.5 capacities instead of three
+    static constexpr size_t BULK_LANE_CAPACITY_DIVISOR = 2;
+
+    // 🔧 数据lane的调度方式
+    enum class LaneScheduling {
+        STRICT_PRIORITY,      // 高优先级lane有积压时低优先级lane不处理（低优先级可能饿死）
+        WEIGHTED_ROUND_ROBIN  // 每轮每队列每个lane最多处理lane_weights[lane]条
+    };
+
+    // 🔧 数据lane满时发送方的行为
+    enum class LaneOverflow {
+        BLOCK,  // 等待credit（受non_blocking / send_timeout_ms约束，与原数据队列一致）
+        DROP    // 立即失败，从不退避
+    };
 
     static constexpr size_t QUEUE_CAPACITY = DATA_QUEUE_SIZE_BYTES;
     static constexpr size_t MAX_INBOUND_QUEUES = 32;  // Max senders to this node (absolute limit, 降低到64)
+    static constexpr uint32_t DEFAULT_SPIN_BUDGET_US = 50;  // SMART_POLLING default spin before blocking
+    static constexpr uint32_t MAX_RECEIVE_THREADS = 8;      // Upper bound for Config::receive_threads
+
+    // 🔧 共享收件箱（多生产者环）：每个槽位一帧，低速发送方共用，不占用专属队列
+    static constexpr size_t SHARED_INBOX_SLOTS = 128;
+    static constexpr size_t SHARED_INBOX_FRAME_BYTES = 4096;  // Largest frame a slot holds (as the control queue)
+    static constexpr uint32_t DEFAULT_INBOX_PROMOTE_RATE = 200;  // Frames/s before a sender claims its own queue
 
     struct Config {
-        size_t queue_capacity;
+        size_t queue_capacity;      // Data queue capacity in bytes (per sender, runtime sized)
         size_t max_inbound_queues;  // 可配置的队列数上限（不能超过MAX_INBOUND_QUEUES）
         bool enable_stats;
         bool auto_cleanup;
         NotifyMechanism notify_mechanism;  // 🔧 通知机制选择
+        uint32_t spin_budget_us;           // SMART_POLLING: 阻塞前自旋检查pending计数的时间（微秒）
+        int receive_cpu;                   // 接收线程i绑定到CPU receive_cpu + i（-1表示不绑定）
+        uint32_t receive_threads;          // 接收线程数：队列槽位i固定由线程 i % N 处理（保证每个发送方有序）
+        bool non_blocking;                 // 🔧 非阻塞发送：接收方无credit时立即失败，send()从不sleep
+        uint32_t send_timeout_ms;          // 阻塞发送：无credit时最多等待的毫秒数（0表示只退避一次）
+        LaneScheduling lane_scheduling;    // 数据lane调度方式
+        uint32_t lane_weights[DATA_LANES];  // WEIGHTED_ROUND_ROBIN：每轮每队列各lane的最大处理条数（0按1处理）
+        LaneOverflow lane_overflow[DATA_LANES];  // 各lane满时的发送策略
+        bool huge_pages;   // 节点共享内存（本节点及已连接的远端）使用透明大页
+        bool prefault;     // 映射时预先分配所有页面（启动变慢，消除首批消息的缺页）
+        bool lock_memory;  // mlock节点共享内存（受RLIMIT_MEMLOCK限制，失败只告警）
+        bool shared_inbox;            // 接收方：启用共享收件箱（发送方数量不再受MAX_INBOUND_QUEUES限制）
+        uint32_t inbox_promote_rate;  // 发送方：在收件箱上超过该速率（帧/秒）后申请专属队列（0 = 立即申请）
+        int numa_node;  // 本节点共享内存mbind到该NUMA节点，接收线程（receive_cpu < 0时）绑定到其CPU（-1表示不绑定）
+        ThreadPlacement receive_placement;    // 接收线程的CPU掩码与调度策略（receive_cpu优先于其CPU掩码）
+        ThreadPlacement connector_placement;  // connector线程的CPU掩码与调度策略
 
         Config()
             : queue_capacity(QUEUE_CAPACITY),
@@ -72,8 +146,21 @@ public:
               ,
               enable_stats(true),
               auto_cleanup(true),
-              notify_mechanism(NotifyMechanism::CONDITION_VARIABLE)  // 🔧 默认使用CONDITION_VARIABLE（最优方案）
-        {}
+              notify_mechanism(NotifyMechanism::CONDITION_VARIABLE),  // 🔧 默认使用CONDITION_VARIABLE（最优方案）
+              spin_budget_us(DEFAULT_SPIN_BUDGET_US),
+              receive_cpu(-1),
+              receive_threads(1),
+              non_blocking(false),
+              send_timeout_ms(0),
+              lane_scheduling(LaneScheduling::STRICT_PRIORITY),
+              lane_weights{16, 16, 16},
+              lane_overflow{LaneOverflow::BLOCK, LaneOverflow::BLOCK, LaneOverflow::DROP},
+              huge_pages(false),
+              prefault(false),
+              lock_memory(false),
+              shared_inbox(false),
+              inbox_promote_rate(DEFAULT_INBOX_PROMOTE_RATE),
+              numa_node(-1) {}
     };
 
     SharedMemoryTransportV3();
@@ -96,6 +183,153 @@ public:
      */
     bool send(const std::string& dest_node_id, const uint8_t* data, size_t size);
 
+    /**
+     * @brief Stable identifier of a connected destination (never reused)
+     */
+    using NodeHandle = uint32_t;
+    static constexpr NodeHandle INVALID_NODE_HANDLE = 0;
+
+    /**
+     * @brief Resolve a destination to a handle, connecting if needed
+     *
+     * A node that could not be connected is handed to the connector thread
+     * (see connectAsync()); until it is ready, calls fail at once instead of
+     * retrying the connection on the caller's thread.
+     * @param node_id Destination node ID
+     * @return Handle, or INVALID_NODE_HANDLE if the node is unreachable
+     */
+    NodeHandle resolveNode(const std::string& node_id);
+
+    // Readiness event: a connection to @p node_id was established (on the connecting thread)
+    using ConnectionCallback = std::function<void(const std::string& node_id, NodeHandle handle)>;
+
+    /**
+     * @brief Connect to a node on the background connector thread
+     *
+     * Returns immediately. A node that is not ready yet is retried with
+     * backoff for as long as it stays registered; every established
+     * connection is reported through the connection callback.
+     */
+    void connectAsync(const std::string& node_id);
+
+    /**
+     * @brief True while @p node_id waits on the connector thread after a failed attempt
+     */
+    bool isConnectPending(const std::string& node_id) const;
+
+    /**
+     * @brief Set the readiness callback (connections made on any thread)
+     */
+    void setConnectionCallback(ConnectionCallback callback);
+
+    /**
+     * @brief Send to a destination previously resolved with resolveNode()
+     *
+     * Skips the node ID lookup entirely; fails once the connection is gone.
+     * @param handle Destination handle
+     * @param data Data to send
+     * @param size Data size
+     * @return true if sent
+     */
+    bool send(NodeHandle handle, const uint8_t* data, size_t size);
+
+    /**
+     * @brief Check whether a connected destination is out of credit
+     *
+     * The receiver advertises free space through its data queue tail. Use
+     * this after a failed send to tell QUEUE_FULL apart from other failures,
+     * or before sending to avoid the attempt.
+     * @param dest_node_id Destination node ID
+     * @param size Frame size the caller wants to send
+     * @param lane Data lane the frame would go to
+     * @return true if connected and the lane cannot take @p size bytes now
+     */
+    bool isQueueFull(const std::string& dest_node_id, size_t size, uint32_t lane = DEFAULT_DATA_LANE) const;
+
+    /**
+     * @brief Handle-based counterpart of isQueueFull(const std::string&, size_t, uint32_t)
+     * @return true if connected and the lane cannot take @p size bytes now
+     */
+    bool isQueueFull(NodeHandle handle, size_t size, uint32_t lane = DEFAULT_DATA_LANE) const;
+
+    /**
+     * @brief Suggested delay before retrying a send that found the queue full
+     *
+     * Derived from the destination queue's congestion level (the same backoff
+     * a blocking send applies), so callers retrying on QUEUE_FULL pace
+     * themselves like the transport does.
+     * @return Microseconds (at least the base backoff; 0 if not connected)
+     */
+    uint32_t retryHintUs(NodeHandle handle) const;
+
+    /**
+     * @brief Callback filling a reserved frame in place
+     * @param frame Writable frame inside the destination node's shared memory
+     * @param size Frame size (as requested)
+     */
+    using FrameWriter = std::function<void(uint8_t* frame, size_t size)>;
+
+    /**
+     * @brief Send a data frame by serializing it directly into the destination queue
+     *
+     * Zero-copy counterpart of send(): the frame is reserved in the remote
+     * node's data queue, filled by @p writer and only then published.
+     * Intended for normal DATA traffic; control messages keep using send().
+     *
+     * @param dest_node_id Destination node ID
+     * @param size Frame size
+     * @param writer Fills the frame; must not block or call back into the transport
+     * @param lane Data lane (0 = most urgent); indices past the last lane use the last one
+     * @return true if sent
+     */
+    bool sendInPlace(const std::string& dest_node_id, size_t size, const FrameWriter& writer,
+                     uint32_t lane = DEFAULT_DATA_LANE);
+
+    /**
+     * @brief sendInPlace() to a destination previously resolved with resolveNode()
+     *
+     * Fails (without reconnecting) once the connection is gone.
+     */
+    bool sendInPlace(NodeHandle handle, size_t size, const FrameWriter& writer, uint32_t lane = DEFAULT_DATA_LANE);
+
+    /**
+     * @brief Callback filling frame @p index of a batch in place
+     */
+    using BatchWriter = std::function<void(size_t index, uint8_t* frame, size_t size)>;
+
+    /**
+     * @brief Send several data frames to one destination
+     *
+     * All frames are written under a single lookup of the connection, published
+     * with one update of the queue head and announced with one wakeup.
+     * Frames are sent in order; if the queue fills up the remainder is dropped.
+     *
+     * @param dest_node_id Destination node ID
+     * @param frames Frame data pointers
+     * @param sizes Frame sizes
+     * @param count Number of frames
+     * @return Number of frames sent
+     */
+    size_t sendv(const std::string& dest_node_id, const uint8_t* const* frames, const size_t* sizes, size_t count);
+
+    /**
+     * @brief Batched counterpart of sendInPlace()
+     * @param dest_node_id Destination node ID
+     * @param sizes Frame sizes
+     * @param count Number of frames
+     * @param writer Fills each frame; must not block or call back into the transport
+     * @param lane Data lane (as in sendInPlace())
+     * @return Number of frames sent
+     */
+    size_t sendBatchInPlace(const std::string& dest_node_id, const size_t* sizes, size_t count,
+                            const BatchWriter& writer, uint32_t lane = DEFAULT_DATA_LANE);
+
+    /**
+     * @brief sendBatchInPlace() to a destination previously resolved with resolveNode()
+     */
+    size_t sendBatchInPlace(NodeHandle handle, const size_t* sizes, size_t count, const BatchWriter& writer,
+                            uint32_t lane = DEFAULT_DATA_LANE);
+
     /**
      * @brief Broadcast to all nodes
      * @param data Data buffer
@@ -106,6 +340,10 @@ public:
 
     /**
      * @brief Set receive callback
+     *
+     * With Config::receive_threads > 1 the callback runs concurrently on the
+     * receive threads; messages of one sender are always delivered in order
+     * by the same thread.
      */
     void setReceiveCallback(ReceiveCallback callback);
 
@@ -192,12 +430,67 @@ public:
         uint64_t bytes_received;
         int active_connections;
         int inbound_queues;
+        uint64_t inbox_depth;  // Frames waiting in this node's shared inbox
+        int numa_node;         // NUMA node holding this node's inbound segment (-1 = unknown)
         double avg_queue_depth;  // Average depth of inbound queues
+        uint32_t max_congestion_level;  // Highest congestion level (0-100) of the inbound queues
+
+        // Per data lane (index = lane)
+        struct LaneStats {
+            uint64_t messages_sent;     // Frames this node sent on the lane
+            uint64_t messages_dropped;  // Frames this node could not send on the lane (no credit)
+            uint64_t depth;             // Frames waiting in the lane across this node's inbound queues
+        };
+        LaneStats lanes[DATA_LANES];
     };
 
     TransportStats getStats() const;
 
+    // Fill of a data lane this node writes into another node's segment
+    struct RingFill {
+        std::string node_id;  // Destination
+        uint32_t lane;
+        size_t used;      // Bytes
+        size_t capacity;  // Bytes
+    };
+
+    /**
+     * @brief Outbound data lanes of every connected destination (lock-free snapshot read)
+     *
+     * Destinations reached through their shared inbox are left out: the inbox
+     * is shared by all senders, so its fill says little about this one.
+     */
+    std::vector<RingFill> getOutboundFill() const;
+
+    // Memory of one mapped NodeSharedMemory segment
+    struct SegmentUsage {
+        std::string node_id;  // Owner of the segment
+        MappingUsage usage;   // mapped = segmentSize(max_queues); resident from mincore()
+    };
+
+    /**
+     * @brief This node's own (inbound) segment; empty usage before initialize()
+     */
+    SegmentUsage getSegmentUsage() const;
+
+    /**
+     * @brief Segments of the connected nodes, mapped to send to them (lock-free snapshot read)
+     *
+     * Residency is that of the whole segment, touched by its owner and all of
+     * its senders, not just by this node.
+     */
+    std::vector<SegmentUsage> getPeerSegmentUsage() const;
+
 private:
+    using ControlRing = LockFreeRingBuffer<CONTROL_QUEUE_SIZE_BYTES>;
+    using DataRing = LockFreeRingBuffer<DATA_QUEUE_SIZE_BYTES>;
+
+    // One data priority lane of an inbound queue
+    struct DataLane {
+        std::atomic<uint32_t> pending;  // 待处理数据消息计数
+        DataRing ring;
+    };
+
     // Inbound queue (receiving from a sender)
     // 🔧 双队列架构：控制面与数据面分离
     struct InboundQueue {
@@ -207,15 +500,10 @@ private:
 
         // 🔧 控制队列（高优先级）：NODE_JOIN, SERVICE_REGISTER等
         std::atomic<uint32_t> control_pending;  // 待处理控制消息计数
-        sem_t control_sem;                      // SEM模式: POSIX信号量
-        char control_sem_padding[64 - sizeof(sem_t)];
-        LockFreeRingBuffer<CONTROL_QUEUE_SIZE_BYTES> control_queue;
+        ControlRing control_queue;
 
-        // 🔧 数据队列（正常优先级）：普通数据消息
-        std::atomic<uint32_t> data_pending;
-        sem_t data_sem;
-        char data_sem_padding[64 - sizeof(sem_t)];
-        LockFreeRingBuffer<DATA_QUEUE_SIZE_BYTES> data_queue;
+        // 🔧 数据队列：按优先级分为DATA_LANES个lane（lane 0最高），在控制队列之后按lane_scheduling处理
+        DataLane data_lanes[DATA_LANES];
 
         // 🔧 流控：背压机制
         std::atomic<uint32_t> congestion_level;  // 拥塞等级 0-100
@@ -224,6 +512,25 @@ private:
         char padding[64];  // Cache line alignment
     };
 
+    // 🔧 共享收件箱槽位：序号按圈计数（seq - 槽位下标），全零内存即为空闲的第0圈，无需初始化即可使用
+    // seq == lap: 空闲，可由位置 lap + i 的生产者占用；seq == lap + 1: 已发布；接收方取走后置为 lap + SLOTS
+    struct InboxSlot {
+        std::atomic<uint64_t> sequence;
+        uint32_t size;
+        std::atomic<int32_t> claimer_pid;  // 占用该槽位的发送进程（接收方释放时清零）：用于跳过崩溃者的占用
+        std::atomic<uint64_t> sender_id_atomic[8];
+        uint8_t data[SHARED_INBOX_FRAME_BYTES];
+    };
+
+    // 🔧 共享收件箱：多生产者（CAS占用enqueue_pos）单消费者（负责该虚拟队列槽位的接收线程）
+    // 生产者在占用槽位与发布之间崩溃时，接收方在其PID消失后跳过该槽位（见inboxClaimAbandoned()）
+    struct SharedInbox {
+        alignas(64) std::atomic<uint64_t> enqueue_pos;  // Next position producers claim
+        alignas(64) std::atomic<uint64_t> dequeue_pos;  // Receiver's position; senders read it before promoting
+        std::atomic<uint32_t> pending;                  // Published frames not yet delivered
+        alignas(64) InboxSlot slots[SHARED_INBOX_SLOTS];
+    };
+
     // Node's shared memory layout
     struct alignas(64) NodeHeader {
         std::atomic<uint32_t> magic;
@@ -244,39 +551,177 @@ private:
         pthread_mutex_t global_mutex;  // CV模式：全局互斥锁
         pthread_cond_t global_cond;    // CV模式：全局条件变量
 
+        // 🔧 运行时队列容量：由接收方配置，发送方创建队列时应用（0 = DATA_QUEUE_SIZE_BYTES）
+        std::atomic<uint32_t> data_queue_capacity;
+
+        // 🔧 门铃（Linux futex，CV/SMART_POLLING模式）：发送方在 pending 0->1 时置位自己队列的
+        // ready_queues 位，再递增 doorbell；接收方只在 doorbell_waiters > 0 时才需要被 futex 唤醒
+        std::atomic<uint64_t> ready_queues;      // bit i = queues[i] 有待处理消息（INBOX_SLOT位 = 共享收件箱）
+        std::atomic<uint32_t> doorbell;          // futex word
+        std::atomic<uint32_t> doorbell_waiters;  // 正在 futex 上等待的接收线程数
+        std::atomic<uint32_t> receive_shards;    // 接收线程分片数：发送方只唤醒负责自己队列的线程
+        std::atomic<uint32_t> inbox_enabled;     // 接收方启用了共享收件箱
+
+        // 🔧 SEM模式：每个接收分片一个信号量。发送方在 pending 0->1 时post负责该队列（或收件箱）的分片，
+        // 接收线程只需阻塞在自己分片的信号量上
+        sem_t shard_sems[MAX_RECEIVE_THREADS];
+
         char padding[64];  // Cache line alignment
     };
 
+    // 🔧 队列数组放在最后：段只映射到 max_queues 个队列为止（见segmentSize()），未配置的队列不占虚拟地址
     struct NodeSharedMemory {
         NodeHeader header;
+        SharedInbox inbox;  // Sparse: pages are only backed once slots are used
         InboundQueue queues[MAX_INBOUND_QUEUES];
     };
+    static_assert(sizeof(NodeSharedMemory) ==
+                      offsetof(NodeSharedMemory, queues) + MAX_INBOUND_QUEUES * sizeof(InboundQueue),
+                  "queues must end NodeSharedMemory so the segment can be truncated after max_queues");
+
+    // Bytes of a segment holding max_queues inbound queues (clamped to MAX_INBOUND_QUEUES)
+    static constexpr size_t segmentSize(size_t max_queues) {
+        return offsetof(NodeSharedMemory, queues) +
+               (max_queues < MAX_INBOUND_QUEUES ? max_queues : MAX_INBOUND_QUEUES) * sizeof(InboundQueue);
+    }
+    // The inbox is scheduled like one more queue slot (ready_queues bit, receive shard)
+    static constexpr uint32_t INBOX_SLOT = MAX_INBOUND_QUEUES;
+    static_assert(INBOX_SLOT < 64, "ready_queues bitmap holds one bit per inbound queue plus the inbox");
+
+    // Sender side of a connection to a node with a shared inbox (process-local, shared with snapshots)
+    struct InboxRoute {
+        std::atomic<InboundQueue*> queue{nullptr};  // Dedicated queue once promoted
+        std::atomic<uint64_t> last_pos{0};          // Inbox position behind our latest frame
+        std::atomic<int64_t> window_start_ms{0};    // Rate window (1s) for promotion
+        std::atomic<uint32_t> window_frames{0};
+        std::atomic<int64_t> retry_ms{0};           // Receiver had no free queue: no new attempt before this
+        std::mutex promote_mutex;                   // One promotion attempt at a time
+    };
 
     // Connection to a remote node
     struct RemoteConnection {
         std::string node_id;
         std::string shm_name;
         void* shm_ptr;
+        size_t shm_size;  // Mapped bytes (the remote segment's size)
         int shm_fd;
-        InboundQueue* my_queue;  // My queue in remote node's memory
+        InboundQueue* my_queue;  // My queue in remote node's memory (nullptr: on its shared inbox)
+        std::shared_ptr<InboxRoute> inbox;  // Set if the remote node has a shared inbox
         bool connected;
+        NodeHandle handle;
+
+        RemoteConnection()
+            : shm_ptr(nullptr),
+              shm_size(0),
+              shm_fd(-1),
+              my_queue(nullptr),
+              connected(false),
+              handle(INVALID_NODE_HANDLE) {}
+    };
 
-        RemoteConnection() : shm_ptr(nullptr), shm_fd(-1), my_queue(nullptr), connected(false) {}
+    /**
+     * @brief Immutable view of the connected destinations (send fast path)
+     *
+     * Rebuilt under connections_mutex_ whenever a connection is added or removed
+     * and published through connection_snapshot_. Senders only read it, so they
+     * never take connections_mutex_.
+     */
+    struct ConnectionSnapshot {
+        struct Entry {
+            NodeHandle handle;
+            NodeSharedMemory* shm;  // Remote node's segment (doorbell lives in its header)
+            InboundQueue* queue;    // nullptr: see inbox
+            std::shared_ptr<InboxRoute> inbox;
+        };
+
+        std::unordered_map<std::string, Entry> by_id;
+        std::vector<Entry> by_handle;  // Sorted by handle
+
+        const Entry* find(const std::string& node_id) const;
+        const Entry* find(NodeHandle handle) const;
+    };
+
+    /**
+     * @brief RAII read-side section for connection_snapshot_
+     *
+     * The snapshot (and the remote mappings it points into) stays valid for
+     * the lifetime of the reader, even across blocking credit waits: writers
+     * never wait for readers, they retire the old snapshot and free it once
+     * both epochs have drained (reclaimRetiredSnapshots()).
+     */
+    class SnapshotReader {
+    public:
+        explicit SnapshotReader(const SharedMemoryTransportV3& transport);
+        ~SnapshotReader();
+
+        const ConnectionSnapshot* get() const { return snapshot_; }
+
+    private:
+        const SharedMemoryTransportV3& transport_;
+        uint32_t epoch_;
+        const ConnectionSnapshot* snapshot_;
     };
 
     static constexpr uint32_t MAGIC = 0x4C524E33;  // "LRN3" = LibRpc Node v3
-    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t VERSION = 4;  // 2: priority data lanes, 3: shared inbox, 4: per-shard semaphores
+    static constexpr uint32_t CONTROL_LANE = DATA_LANES;  // writeToQueue(): target the control queue
+    static constexpr uint32_t INBOX_LANE = DATA_LANES + 1;  // Tracepoints: frames of the shared inbox
 
     // Helper methods
+    ShmMapOptions mapOptions() const;  // Huge page / prefault / mlock options from config_
     bool createMySharedMemory();
     void destroyMySharedMemory();
     bool connectToNode(const std::string& target_node_id);
+    // Requires connections_mutex_; released connections are unmapped with the retired snapshot
+    void publishConnectionSnapshot(std::vector<RemoteConnection> released = std::vector<RemoteConnection>());
+    void reclaimRetiredSnapshots();  // Requires connections_mutex_; frees what no reader can still see
     InboundQueue* findOrCreateQueue(NodeSharedMemory* remote_shm, const std::string& sender_id);
-    void receiveLoop();
-    void receiveLoop_Semaphore();  // 🔧 Semaphore模式的接收循环
-    void receiveLoop_CV();         // Condition Variable模式的接收循环
-    void heartbeatLoop();
+    size_t sendFrames(const std::string& dest_node_id, const size_t* sizes, size_t count, uint32_t lane,
+                      const BatchWriter& writer);
+    size_t writeToQueue(NodeSharedMemory* shm, InboundQueue* queue, const size_t* sizes, size_t count, uint32_t lane,
+                        const BatchWriter& writer, bool just_connected);
+    // Route frames to the connection's dedicated queue or the remote shared inbox
+    size_t writeToConnection(const ConnectionSnapshot::Entry& conn, const size_t* sizes, size_t count, uint32_t lane,
+                             const BatchWriter& writer, bool just_connected);
+    size_t writeToInbox(NodeSharedMemory* shm, InboxRoute& route, const size_t* sizes, size_t count, uint32_t lane,
+                        const BatchWriter& writer);
+    InboundQueue* inboxQueue(NodeSharedMemory* shm, InboxRoute& route, const size_t* sizes, size_t count);
+    static InboundQueue* dedicatedQueue(const ConnectionSnapshot::Entry& conn);
+    static bool inboxFull(const SharedInbox& inbox);
+    // BLOCK lanes without credit: back off once, or until send_timeout_ms while has_credit() is false
+    void waitForCredit(uint32_t congestion, const std::function<bool()>& has_credit) const;
+    int drainInbox(int max_frames);
+    bool inboxClaimAbandoned(const InboxSlot& slot, uint64_t pos);  // Receive thread owning the inbox only
+    static bool hasPending(const InboundQueue* queue);
+    int drainDataLane(InboundQueue* queue, uint32_t lane, int max_frames);
+    bool drainDataLanes(const std::vector<InboundQueue*>& queues);
+    void receiveLoop(uint32_t shard);
+    void receiveLoop_Semaphore(uint32_t shard);  // 🔧 Semaphore模式的接收循环
+    bool waitShardSemaphore(uint32_t shard, int timeout_ms);
+    void receiveLoop_CV(uint32_t shard);  // Condition Variable模式的接收循环（SMART_POLLING在阻塞前先自旋）
+    bool spinForMessages(const std::vector<InboundQueue*>& queues, uint32_t known_queues, uint64_t shard_mask) const;
+    static void ringDoorbell(NodeSharedMemory* shm, const InboundQueue* queue);
+    static void ringDoorbell(NodeSharedMemory* shm, uint32_t slot);  // Queue slot index (INBOX_SLOT: the inbox)
+    static void postShardSemaphore(NodeSharedMemory* shm, uint32_t slot);  // SEMAPHORE mode counterpart
+    void applyReceivePlacement(uint32_t shard);
+    uint64_t shardQueueMask(uint32_t shard) const;
+    void heartbeatTick();  // One heartbeat round, run by the MaintenanceScheduler
     void cleanupStaleQueues();
+
+    // Connect to registry nodes without a connection yet (heartbeat loop and registry change notifications)
+    void connectToNewNodes(const std::vector<NodeInfo>& nodes);
+
+    // Background connection setup for connectAsync()
+    void connectorLoop();
+
+    // Queue @p node_id on the connector; @p failed marks an attempt that already failed
+    void requestConnect(const std::string& node_id, bool failed);
+
+    // Connect on the caller's thread unless the node already failed and waits on the connector
+    bool connectInline(const std::string& node_id);
+
+    // Registry node list, re-read only when the registry generation changed (shared, never modified)
+    std::shared_ptr<const std::vector<NodeInfo>> registryNodes() const;
     std::string generateShmName();
 
     // Accessor PID tracking helpers
@@ -298,21 +743,54 @@ private:
 
     // Registry
     SharedMemoryRegistry registry_;
+    mutable std::mutex registry_nodes_mutex_;
+    mutable std::shared_ptr<const std::vector<NodeInfo>> registry_nodes_;  // Cached by registryNodes()
+    mutable uint32_t registry_nodes_generation_ = SharedMemoryRegistry::NO_GENERATION;
 
     // My shared memory (for receiving)
     void* my_shm_ptr_;
+    size_t my_shm_size_;  // segmentSize(config_.max_inbound_queues)
     int my_shm_fd_;
     NodeSharedMemory* my_shm_;
 
     // Connections to remote nodes (for sending)
     std::map<std::string, RemoteConnection> remote_connections_;
     mutable std::mutex connections_mutex_;
+    NodeHandle next_node_handle_ = 1;
+
+    // 🔧 异步连接：待连接节点由connector线程按退避重试，连接建立后触发就绪回调
+    struct PendingConnect {
+        std::chrono::steady_clock::time_point next_attempt;
+        uint32_t backoff_ms;
+        uint32_t failures;
+    };
+    std::map<std::string, PendingConnect> pending_connects_;
+    mutable std::mutex connector_mutex_;
+    std::condition_variable connector_cv_;
+    bool connector_stop_ = false;
+    std::thread connector_thread_;
+    ConnectionCallback connection_callback_;  // Guarded by connector_mutex_
+
+    // Published view of remote_connections_ for senders, plus epoch-based reader tracking
+    std::atomic<const ConnectionSnapshot*> connection_snapshot_{nullptr};
+    mutable std::atomic<uint32_t> snapshot_epoch_{0};
+    mutable std::atomic<uint32_t> snapshot_readers_[2];
+    struct RetiredSnapshot {
+        const ConnectionSnapshot* snapshot;
+        std::vector<RemoteConnection> connections;  // munmap/close when freed
+        uint64_t flips;                             // snapshot_flips_ when retired
+    };
+    std::vector<RetiredSnapshot> retired_snapshots_;  // Guarded by connections_mutex_
+    uint64_t snapshot_flips_ = 0;                     // Epoch flips so far, guarded by connections_mutex_
 
     // Receive thread
-    std::thread receive_thread_;
-    std::thread heartbeat_thread_;
+    std::vector<std::thread> receive_threads_;  // 每个分片一个接收线程（config_.receive_threads）
+    MaintenanceScheduler::TaskId heartbeat_task_ = MaintenanceScheduler::NO_TASK;
+    uint64_t heartbeat_count_ = 0;  // Only touched by heartbeatTick()
     std::atomic<bool> receiving_;
     ReceiveCallback receive_callback_;
+    uint64_t inbox_stalled_pos_ = UINT64_MAX;  // Inbox position drainInbox() is waiting on (claimed, unpublished)
+    int64_t inbox_stalled_since_ms_ = 0;
 
     // Condition variable for queue availability (used when active_queues is empty)
     std::mutex queue_wait_mutex_;
@@ -330,6 +808,8 @@ private:
     std::atomic<uint64_t> stats_messages_dropped_{0};
     std::atomic<uint64_t> stats_bytes_sent_{0};
     std::atomic<uint64_t> stats_bytes_received_{0};
+    std::atomic<uint64_t> stats_lane_sent_[DATA_LANES] = {};
+    std::atomic<uint64_t> stats_lane_dropped_[DATA_LANES] = {};
 };
 
 }  // namespace rpc
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <netinet/in.h>
 #include <stdint.h>
+#include <sys/socket.h>
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "nexus/utils/ThreadPlacement.h"
+
 namespace Nexus {
 namespace rpc {
 
@@ -17,7 +22,28 @@ namespace rpc {
  */
 class UdpTransport {
 public:
-    using ReceiveCallback = std::function<void(const uint8_t* data, size_t size, const std::string& from_addr)>;
+    // @p from is the sender's socket address as received (no per-datagram formatting; see formatAddress())
+    using ReceiveCallback = std::function<void(const uint8_t* data, size_t size, const sockaddr_in& from)>;
+
+    struct CompressionStats {
+        uint64_t packets_compressed = 0;  // Datagrams sent compressed
+        uint64_t bytes_saved = 0;         // Original minus sent size, summed over compressed datagrams
+        uint64_t packets_expanded = 0;    // Compressed datagrams received and expanded
+        uint64_t packets_rejected = 0;    // Compressed datagrams dropped (malformed or too large)
+    };
+
+    struct OffloadStats {
+        uint64_t segmented_sends = 0;      // Messages the kernel segmented (UDP_SEGMENT)
+        uint64_t segmented_datagrams = 0;  // Datagrams sent in them
+        uint64_t coalesced_receives = 0;   // Coalesced buffers received (UDP_GRO)
+        uint64_t coalesced_datagrams = 0;  // Datagrams split out of them
+    };
+
+    // One datagram of a sendBatch() to a single destination
+    struct Datagram {
+        const uint8_t* data;
+        size_t size;
+    };
 
     UdpTransport();
     ~UdpTransport();
@@ -25,9 +51,67 @@ public:
     /**
      * @brief Initialize UDP socket
      * @param port Port to bind (0 = auto-select)
-     * @return true if successful
+     * @param shared_port Let other sockets bind the same port (SO_REUSEADDR), as multicast receivers do.
+     *        Such a socket only receives the multicast groups it joined itself, on one receive thread.
+     * @return true if successful (false if another transport holds @p port)
+     */
+    bool initialize(uint16_t port = 0, bool shared_port = false);
+
+    /**
+     * @brief Receive on @p count sockets bound to the same port (SO_REUSEPORT), one thread each
+     *
+     * The kernel hashes each flow (source address and port) to one socket, so
+     * datagrams of one sender keep their order while different senders are
+     * received and handed to the callback in parallel. The callback must then
+     * be thread-safe. The port stays exclusive to this transport.
+     *
+     * With @p cpu_sets, receive thread i is pinned to cpu_sets[i % size] and
+     * each datagram goes to the socket whose set contains the CPU that
+     * received it (matching NIC RX queues to receive threads); datagrams from
+     * other CPUs fall back to the flow hash. Call before initialize().
+     * @param count Receive sockets and threads (1-MAX_RECEIVE_THREADS)
+     * @param cpu_sets CPU mask per receive thread (empty = unpinned, flow hash only)
+     */
+    void setReceiveThreads(size_t count, const std::vector<uint64_t>& cpu_sets = {});
+
+    /**
+     * @brief CPU mask and scheduling of the receive threads; call before initialize()
+     *
+     * The cpu_sets of setReceiveThreads() replace the placement's CPU mask.
+     */
+    void setReceivePlacement(const ThreadPlacement& placement);
+
+    /**
+     * @brief Use UDP segmentation offload where the kernel supports it (default: on)
+     *
+     * Send: sendBatch() to one destination hands each run of equally sized
+     * datagrams to the kernel as one message (UDP_SEGMENT), which the kernel
+     * or NIC cuts into the original datagrams. Receive: the sockets accept
+     * coalesced buffers (UDP_GRO), which the receive threads split back into
+     * datagrams before the callback. Either side falls back to one datagram
+     * per message where the option is missing (QNX, older Linux) or a send
+     * is refused. Call before initialize().
+     */
+    void setSegmentationOffload(bool enabled) { offload_requested_ = enabled; }
+    bool hasSendOffload() const { return gso_enabled_.load(std::memory_order_relaxed); }
+    bool hasReceiveOffload() const { return gro_enabled_; }
+
+    OffloadStats getOffloadStats() const;
+
+    /**
+     * @brief Receive through io_uring instead of the recvmmsg()/poll() loop (Linux; default: off)
+     *
+     * Each receive socket gets a ring with a multishot RECVMSG that keeps
+     * filling buffers from a provided buffer ring: the receive thread waits
+     * for completions and hands each datagram to the callback straight from
+     * the kernel-filled buffer, without a syscall per batch or a poll() in
+     * between. Where io_uring, provided buffer rings or multishot receive are
+     * missing (QNX, older Linux, io_uring disabled) the socket loop is used.
+     * Call before initialize().
      */
-    bool initialize(uint16_t port = 0);
+    void setIoUring(bool enabled) { io_uring_requested_ = enabled; }
+    // Receive sockets currently served through io_uring
+    bool usesIoUring() const { return io_uring_sockets_.load(std::memory_order_relaxed) > 0; }
 
     /**
      * @brief Shutdown UDP socket
@@ -44,6 +128,69 @@ public:
      */
     bool send(const uint8_t* data, size_t size, const std::string& dest_addr = "", uint16_t dest_port = 0);
 
+    /**
+     * @brief Send data to a pre-resolved address (no parsing on the send path)
+     * @param data Data buffer
+     * @param size Data size
+     * @param dest Destination from resolveAddress()
+     * @return true if successful
+     */
+    bool sendTo(const uint8_t* data, size_t size, const struct sockaddr_in& dest);
+
+    /**
+     * @brief Send one datagram to many destinations (sendmmsg: one syscall per SEND_BATCH destinations)
+     * @param data Data buffer (compressed once, not per destination)
+     * @param size Data size
+     * @param dests Destinations from resolveAddress()
+     * @return Number of destinations the datagram was sent to
+     */
+    size_t sendBatch(const uint8_t* data, size_t size, const std::vector<struct sockaddr_in>& dests);
+
+    /**
+     * @brief Send many datagrams to one destination (sendmmsg, in order)
+     * @param datagrams Datagrams to send
+     * @param count Number of datagrams
+     * @param dest Destination from resolveAddress()
+     * @return Number of datagrams sent; sending stops at the first one the socket refuses
+     */
+    size_t sendBatch(const Datagram* datagrams, size_t count, const struct sockaddr_in& dest);
+
+    /**
+     * @brief Parse an IPv4 address and port once, for repeated sendTo() calls
+     * @param addr Dotted IPv4 address
+     * @param port Port number
+     * @param dest Filled on success
+     * @return true if @p addr is a valid IPv4 address
+     */
+    static bool resolveAddress(const std::string& addr, uint16_t port, struct sockaddr_in& dest);
+
+    /**
+     * @brief Dotted IPv4 address of @p addr (the wildcard 0.0.0.0 as 127.0.0.1)
+     */
+    static std::string formatAddress(const sockaddr_in& addr);
+
+    /**
+     * @brief Address to answer a datagram from @p from at its sender's @p port (the wildcard as loopback)
+     */
+    static sockaddr_in replyAddress(const sockaddr_in& from, uint16_t port);
+
+    /**
+     * @brief Join an IPv4 multicast group on the default interface
+     * @param group_addr Dotted multicast address (224.0.0.0/4)
+     * @return true if joined (false if already a member or not a multicast address)
+     */
+    bool joinMulticastGroup(const std::string& group_addr);
+
+    /**
+     * @brief Leave a group joined with joinMulticastGroup()
+     */
+    bool leaveMulticastGroup(const std::string& group_addr);
+
+    /**
+     * @brief Router hops of multicast datagrams sent from this socket (default 1: local subnet)
+     */
+    bool setMulticastTtl(uint8_t ttl);
+
     /**
      * @brief Broadcast data to all nodes
      * @param data Data buffer
@@ -52,8 +199,24 @@ public:
      */
     bool broadcast(const uint8_t* data, size_t size);
 
+    /**
+     * @brief Compress outgoing datagrams of at least @p threshold bytes (LZ4, see CompressedPacket)
+     *
+     * A datagram is only sent compressed if that makes it smaller. Received
+     * compressed datagrams are expanded whatever the local setting.
+     * @param threshold Minimum datagram size in bytes (0 = never compress)
+     */
+    void setCompressionThreshold(size_t threshold) { compression_threshold_ = threshold; }
+    size_t getCompressionThreshold() const { return compression_threshold_; }
+
+    CompressionStats getCompressionStats() const;
+
     /**
      * @brief Set callback for received data
+     *
+     * The receive threads pick up the callback once per batch without a lock,
+     * so replacing it never waits for a running callback; a batch already
+     * being dispatched finishes with the previous one.
      * @param callback Callback function
      */
     void setReceiveCallback(ReceiveCallback callback);
@@ -70,17 +233,96 @@ public:
      */
     bool isInitialized() const { return initialized_; }
 
+    static constexpr size_t SEND_BATCH = 64;  // Datagrams per sendmmsg call
+    static constexpr size_t RECV_BATCH = 16;  // Datagrams drained per recvmmsg call
+    static constexpr size_t MAX_RECEIVE_THREADS = 16;
+    static constexpr size_t MAX_GSO_SEGMENTS = 64;     // Datagrams per segmented message (kernel UDP_MAX_SEGMENTS)
+    static constexpr size_t MAX_GSO_BYTES = 65507;     // Bytes per segmented message (one IPv4 UDP payload)
+
 private:
-    void receiveThread();
+    // io_uring state of one receive socket (defined in the .cpp; empty without io_uring support)
+    class IoUringReceiver;
+
+    void receiveThread(int fd, size_t index, IoUringReceiver* ring);
+
+    // Completion loop of an io_uring receive socket; false if the kernel refused multishot receive
+    // (the thread then falls back to the socket loop)
+    bool receiveWithIoUring(IoUringReceiver& ring, std::vector<uint8_t>& expanded);
+
+    // Bound, non-blocking socket on @p port (SO_REUSEPORT if @p reuse_port); -1 on failure
+    int openSocket(uint16_t port, bool shared_port, bool reuse_port);
+
+    // Port a plain bind() gets (0 if taken): reuse-port sockets must not join another transport's port
+    static uint16_t reservePort(uint16_t port);
+
+    // Attach the classic BPF program that picks a receive socket by the receiving CPU
+    bool steerByCpu();
+
+    // IP_ADD_MEMBERSHIP / IP_DROP_MEMBERSHIP
+    bool changeMembership(const std::string& group_addr, int option);
+
+    // LZ4-compress @p data into @p out if it passes the threshold and shrinks; packet size or 0 (send as is)
+    size_t compressDatagram(const uint8_t* data, size_t size, std::vector<uint8_t>& out) const;
+
+    // sendmmsg until all @p count messages are sent or the socket refuses one; number sent
+    size_t sendMessages(struct mmsghdr* msgs, size_t count);
+
+    // Detect UDP_SEGMENT / enable UDP_GRO on @p fd (offload_requested_)
+    void enableOffload(int fd);
+
+    // Control message space for one UDP_SEGMENT option
+    union SegmentControl {
+        struct cmsghdr header;
+        uint8_t space[CMSG_SPACE(sizeof(uint16_t))];
+    };
+
+    // Group @p count datagrams into messages to @p dest: with send offload, each run of equal sizes (the last
+    // may be shorter) becomes one segmented message. @p runs receives the datagrams per message; number of messages
+    size_t buildMessages(struct iovec* iovs, size_t count, const struct sockaddr_in& dest, struct mmsghdr* msgs,
+                         size_t* runs, SegmentControl* controls);
+
+    // Segment size of a buffer the kernel coalesced (UDP_GRO control message), 0 for a single datagram
+    static size_t coalescedSegment(const struct msghdr& msg);
+
+    // Hand a received buffer to @p callback, split into datagrams if GRO coalesced it (@p segment > 0)
+    void deliverBuffer(const ReceiveCallback& callback, const uint8_t* data, size_t length, size_t segment,
+                       const struct sockaddr_in& from, std::vector<uint8_t>& expanded);
+
+    // Expand (if compressed) and hand one received datagram to @p callback
+    void deliverDatagram(const ReceiveCallback& callback, const uint8_t* data, size_t size,
+                         const struct sockaddr_in& from, std::vector<uint8_t>& expanded);
 
     int socket_fd_;
+    std::vector<int> extra_fds_;  // Further receive sockets on port_ (setReceiveThreads())
+    int wake_fd_;                 // eventfd: shutdown() wakes the receive threads out of poll()
     uint16_t port_;
     std::atomic<bool> initialized_;
     std::atomic<bool> running_;
 
-    std::thread receive_thread_;
-    ReceiveCallback receive_callback_;
-    std::mutex callback_mutex_;
+    std::atomic<size_t> compression_threshold_;
+    std::atomic<uint64_t> stats_compressed_{0};
+    std::atomic<uint64_t> stats_bytes_saved_{0};
+    std::atomic<uint64_t> stats_expanded_{0};
+    std::atomic<uint64_t> stats_rejected_{0};
+
+    bool offload_requested_;
+    std::atomic<bool> gso_enabled_;
+    std::atomic<size_t> gso_max_segment_;  // Largest datagram segmented (lowered when the path MTU refuses one)
+    bool gro_enabled_;
+    std::atomic<uint64_t> stats_segmented_sends_{0};
+    std::atomic<uint64_t> stats_segmented_datagrams_{0};
+    std::atomic<uint64_t> stats_coalesced_receives_{0};
+    std::atomic<uint64_t> stats_coalesced_datagrams_{0};
+
+    bool io_uring_requested_;
+    std::vector<std::unique_ptr<IoUringReceiver>> io_uring_receivers_;  // Per receive socket (null: socket loop)
+    std::atomic<size_t> io_uring_sockets_{0};
+
+    size_t receive_thread_count_;
+    std::vector<uint64_t> receive_cpu_sets_;
+    ThreadPlacement receive_placement_;  // setReceivePlacement()
+    std::vector<std::thread> receive_threads_;
+    std::shared_ptr<const ReceiveCallback> receive_callback_;  // std::atomic_load / std::atomic_store only
 
     static constexpr uint16_t DEFAULT_BROADCAST_PORT = 47120;
     static constexpr const char* BROADCAST_ADDR = "255.255.255.255";
@@ -0,0 +1,259 @@
+// Bounded lock-free MPMC queue and eventcount wakeup (in-process)
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue
+ *
+ * Array-based queue with a per-slot sequence number (D. Vyukov's design).
+ * Producers and consumers each claim a position with one CAS; no locks are
+ * taken and no memory is allocated after construction.
+ *
+ * Key features:
+ * - Any capacity of at least 2 (not only powers of two); smaller requests are
+ *   rounded up, since one slot cannot tell "full" from "free" by sequence
+ * - Element storage is left untouched until used, so a large, mostly idle
+ *   queue only costs its sequence array in resident memory
+ * - Extra consumers are allowed: a producer may pop the oldest element to
+ *   make room (drop-oldest overflow)
+ */
+template <typename T>
+class BoundedMpmcQueue {
+public:
+    explicit BoundedMpmcQueue(size_t capacity)
+        : capacity_(capacity > 2 ? capacity : 2),
+          sequences_(new Sequence[capacity_]),
+          storage_(new Storage[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            sequences_[i].value.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    // Remaining elements are destroyed; owners of manually counted contents release them first
+    ~BoundedMpmcQueue() {
+        T item;
+        while (tryPop(item)) {
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+    /**
+     * @brief Push an element (moved from on success only)
+     * @return false if the queue is full
+     */
+    bool tryPush(T& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Sequence& slot = sequences_[pos % capacity_];
+            size_t seq = slot.value.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (&storage_[pos % capacity_]) T(std::move(item));
+                    slot.value.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full: slot still holds an element from the previous lap
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pop the oldest element
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Sequence& slot = sequences_[pos % capacity_];
+            size_t seq = slot.value.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* stored = reinterpret_cast<T*>(&storage_[pos % capacity_]);
+                    item = std::move(*stored);
+                    stored->~T();
+                    slot.value.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty: slot not yet published by a producer
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Approximate number of queued elements (exact when quiescent)
+     */
+    size_t size() const {
+        size_t dequeued = dequeue_pos_.load(std::memory_order_acquire);
+        size_t enqueued = enqueue_pos_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Sequence {
+        std::atomic<size_t> value;
+    };
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    const size_t capacity_;
+    std::unique_ptr<Sequence[]> sequences_;
+    std::unique_ptr<Storage[]> storage_;
+
+    // Producer and consumer cursors on separate cache lines (avoid false sharing);
+    // padded rather than alignas(64) so heap allocation needs no over-aligned new (C++14)
+    char pad0_[64];
+    std::atomic<size_t> enqueue_pos_;
+    char pad1_[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos_;
+    char pad2_[64 - sizeof(std::atomic<size_t>)];
+};
+
+/**
+ * @brief Eventcount: block a consumer until a producer signals, without a mutex on the fast path
+ *
+ * Consumer:
+ *   uint32_t key = ec.prepareWait();
+ *   if (work available) ec.cancelWait(); else ec.wait(key);  // or waitFor(key, timeout)
+ * Producer (after publishing work):
+ *   ec.notify();
+ *
+ * notify()/notifyAll() are a fence plus one relaxed load while no consumer is blocked;
+ * the epoch is only bumped (and the futex only woken) when someone waits.
+ */
+class EventCount {
+public:
+    EventCount() : epoch_(0), waiters_(0) {}
+
+    EventCount(const EventCount&) = delete;
+    EventCount& operator=(const EventCount&) = delete;
+
+    uint32_t prepareWait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    void cancelWait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void wait(uint32_t key) {
+#ifdef __linux__
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, key] { return epoch_.load(std::memory_order_acquire) != key; });
+#endif
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief wait() with a deadline
+     * @return false if @p timeout elapsed without a notification
+     */
+    bool waitFor(uint32_t key, std::chrono::nanoseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool notified = true;
+#ifdef __linux__
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                notified = false;
+                break;
+            }
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(nanos / 1000000000);
+            ts.tv_nsec = static_cast<long>(nanos % 1000000000);
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, key, &ts, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        notified =
+            cv_.wait_until(lock, deadline, [this, key] { return epoch_.load(std::memory_order_acquire) != key; });
+#endif
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return notified;
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        signal(1);
+    }
+
+    void notifyAll() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        signal(INT_MAX);
+    }
+
+private:
+    void signal(int count) {
+#ifdef __linux__
+        epoch_.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+        if (count == 1) {
+            cv_.notify_one();
+        } else {
+            cv_.notify_all();
+        }
+#endif
+    }
+
+    std::atomic<uint32_t> epoch_;    // futex word
+    std::atomic<uint32_t> waiters_;  // Consumers between prepareWait() and wakeup
+#ifndef __linux__
+    std::mutex mutex_;
+    std::condition_variable cv_;
+#endif
+};
+
+}  // namespace rpc
+}  // namespace Nexus
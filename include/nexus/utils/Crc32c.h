@@ -0,0 +1,44 @@
+// CRC32C (Castagnoli) checksum with hardware acceleration where available, and IEEE CRC32
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Extend a CRC32C over @p size bytes
+ *
+ * Uses the SSE4.2 crc32 instruction on x86-64 (detected at runtime) or the
+ * ARMv8 CRC32 extension when compiled for it; otherwise a table-driven
+ * software loop. All paths produce the same value.
+ *
+ * @param crc Value returned by a previous call, or 0 to start
+ * @return Updated CRC
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+/**
+ * @brief crc32c() of @p src while copying it to @p dst (regions must not overlap)
+ *
+ * Works in L1-sized chunks, so the checksum reads bytes the copy just loaded
+ * and the source is streamed from memory once instead of twice.
+ */
+uint32_t crc32cCopy(uint32_t crc, void* dst, const void* src, size_t size);
+
+/**
+ * @brief Extend an IEEE 802.3 CRC32 (zlib's crc32()) over @p size bytes
+ *
+ * Software slicing-by-8 on every platform; prefer crc32c() for new formats.
+ * @param crc Value returned by a previous call, or 0 to start
+ */
+uint32_t crc32(uint32_t crc, const void* data, size_t size);
+
+/**
+ * @brief True if crc32c() runs on a hardware CRC instruction
+ */
+bool crc32cHardwareAccelerated();
+
+}  // namespace rpc
+}  // namespace Nexus
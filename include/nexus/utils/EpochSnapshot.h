@@ -0,0 +1,115 @@
+// Read-mostly immutable snapshot with epoch-based reclamation (in-process)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Atomically swapped immutable snapshot, read without locks
+ *
+ * Readers enter a short read-side section, use the current snapshot and leave;
+ * a writer publishes a new snapshot and frees the old one only after every
+ * reader that could still see it has left (two-epoch grace period).
+ *
+ * Reader counters are sharded per thread (one cache line each), so readers on
+ * different threads do not write to a shared cache line. Read-side sections
+ * must be short and must not call publish() on the same snapshot.
+ *
+ * Writers must be serialized by the caller.
+ */
+template <typename T>
+class EpochSnapshot {
+public:
+    EpochSnapshot() : current_(nullptr), epoch_(0) {
+        for (auto& epoch_shards : shards_) {
+            for (auto& shard : epoch_shards) {
+                shard.readers.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ~EpochSnapshot() { delete current_.load(std::memory_order_acquire); }
+
+    EpochSnapshot(const EpochSnapshot&) = delete;
+    EpochSnapshot& operator=(const EpochSnapshot&) = delete;
+
+    /**
+     * @brief RAII read-side section; the snapshot stays valid until destruction
+     */
+    class Reader {
+    public:
+        explicit Reader(const EpochSnapshot& owner) : owner_(owner), shard_(shardIndex()) {
+            // Register in the current epoch; retry if a writer flipped it meanwhile
+            while (true) {
+                epoch_ = owner_.epoch_.load();
+                owner_.shards_[epoch_][shard_].readers.fetch_add(1);
+                if (owner_.epoch_.load() == epoch_) {
+                    break;
+                }
+                owner_.shards_[epoch_][shard_].readers.fetch_sub(1);
+            }
+            snapshot_ = owner_.current_.load();
+        }
+
+        ~Reader() { owner_.shards_[epoch_][shard_].readers.fetch_sub(1, std::memory_order_release); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const T* get() const { return snapshot_; }
+
+    private:
+        const EpochSnapshot& owner_;
+        const size_t shard_;
+        uint32_t epoch_;
+        const T* snapshot_;
+    };
+
+    /**
+     * @brief Replace the snapshot; blocks until no reader can see the old one, then frees it
+     */
+    void publish(std::unique_ptr<const T> snapshot) {
+        const T* old_snapshot = current_.exchange(snapshot.release());
+
+        // Grace period: new readers land in the other epoch and see the new snapshot;
+        // wait for readers of the old epoch, which may still use the old one.
+        const uint32_t old_epoch = epoch_.load();
+        epoch_.store(old_epoch ^ 1);
+        for (auto& shard : shards_[old_epoch]) {
+            while (shard.readers.load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        delete old_snapshot;
+    }
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    // Threads are spread round-robin over the shards on first use
+    static size_t shardIndex() {
+        static std::atomic<size_t> next_shard{0};
+        thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return shard;
+    }
+
+    // Padded rather than alignas(64) so heap allocation needs no over-aligned new (C++14)
+    struct Shard {
+        std::atomic<uint32_t> readers;
+        char pad[64 - sizeof(std::atomic<uint32_t>)];
+    };
+
+    std::atomic<const T*> current_;
+    std::atomic<uint32_t> epoch_;
+    mutable Shard shards_[2][SHARDS];
+};
+
+}  // namespace rpc
+}  // namespace Nexus
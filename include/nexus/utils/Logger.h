@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -12,6 +13,11 @@ namespace rpc {
 
 /**
  * @brief Unified logging system for Nexus
+ *
+ * The macros below test enabled() before building their message, so a
+ * disabled level costs one relaxed load and a branch. Lines are written
+ * synchronously under a mutex, or, with setAsync(), handed to a lock-free
+ * ring drained by a background writer thread.
  */
 class Logger {
 public:
@@ -32,6 +38,11 @@ public:
      */
     Level getLevel() const;
 
+    /**
+     * @brief True if messages of @p level are written (checked by the macros before formatting)
+     */
+    bool enabled(Level level) const { return level >= min_level_.load(std::memory_order_relaxed); }
+
     /**
      * @brief Log a message
      */
@@ -47,30 +58,55 @@ public:
      */
     void setShowComponent(bool show);
 
+    /**
+     * @brief Write lines from a background thread instead of the logging thread
+     *
+     * log() then formats the line and pushes it onto a lock-free ring of
+     * @p capacity lines; it never blocks. Lines that find the ring full are
+     * dropped and counted (reported by the writer). Disabling drains the ring
+     * first. Also enabled by NEXUS_LOG_ASYNC=1.
+     */
+    void setAsync(bool async, size_t capacity = 8192);
+
+    /**
+     * @brief Wait until every line logged so far is written (no-op when synchronous)
+     */
+    void flush();
+
 private:
     Logger();
+    ~Logger();
 
-    Level min_level_{Level::INFO};
-    bool show_timestamp_{true};
-    bool show_component_{true};
+    struct AsyncWriter;
+
+    std::atomic<Level> min_level_{Level::INFO};
+    std::atomic<bool> show_timestamp_{true};
+    std::atomic<bool> show_component_{true};
     mutable std::mutex mutex_;
+    std::atomic<bool> async_{false};
+    AsyncWriter* async_writer_{nullptr};  // Created by the first setAsync(true), kept until destruction
 
     const char* levelToString(Level level) const;
     std::string getTimestamp() const;
+    std::string formatLine(Level level, const std::string& component, const std::string& message) const;
+    static void writeLine(Level level, const std::string& line);
 };
 
-// Convenience macros
-#define NEXUS_LOG_DEBUG(component, msg) \
-    Nexus::rpc::Logger::instance().log(Nexus::rpc::Logger::Level::DEBUG, component, msg)
+// Convenience macros (msg is only evaluated if the level is enabled)
+#define NEXUS_LOG_AT(level, component, msg)                            \
+    do {                                                               \
+        if (Nexus::rpc::Logger::instance().enabled(level)) {           \
+            Nexus::rpc::Logger::instance().log(level, component, msg); \
+        }                                                              \
+    } while (0)
+
+#define NEXUS_LOG_DEBUG(component, msg) NEXUS_LOG_AT(Nexus::rpc::Logger::Level::DEBUG, component, msg)
 
-#define NEXUS_LOG_INFO(component, msg) \
-    Nexus::rpc::Logger::instance().log(Nexus::rpc::Logger::Level::INFO, component, msg)
+#define NEXUS_LOG_INFO(component, msg) NEXUS_LOG_AT(Nexus::rpc::Logger::Level::INFO, component, msg)
 
-#define NEXUS_LOG_WARN(component, msg) \
-    Nexus::rpc::Logger::instance().log(Nexus::rpc::Logger::Level::WARN, component, msg)
+#define NEXUS_LOG_WARN(component, msg) NEXUS_LOG_AT(Nexus::rpc::Logger::Level::WARN, component, msg)
 
-#define NEXUS_LOG_ERROR(component, msg) \
-    Nexus::rpc::Logger::instance().log(Nexus::rpc::Logger::Level::ERROR, component, msg)
+#define NEXUS_LOG_ERROR(component, msg) NEXUS_LOG_AT(Nexus::rpc::Logger::Level::ERROR, component, msg)
 
 // Stream-style logging
 class LogStream {
@@ -91,13 +127,19 @@ private:
     std::stringstream ss_;
 };
 
-#define NEXUS_DEBUG(component) Nexus::rpc::LogStream(Nexus::rpc::Logger::Level::DEBUG, component)
+// The stream (and every operand shifted into it) is skipped if the level is disabled
+#define NEXUS_STREAM_AT(level, component)                 \
+    if (!Nexus::rpc::Logger::instance().enabled(level)) { \
+    } else                                                \
+        Nexus::rpc::LogStream(level, component)
+
+#define NEXUS_DEBUG(component) NEXUS_STREAM_AT(Nexus::rpc::Logger::Level::DEBUG, component)
 
-#define NEXUS_INFO(component) Nexus::rpc::LogStream(Nexus::rpc::Logger::Level::INFO, component)
+#define NEXUS_INFO(component) NEXUS_STREAM_AT(Nexus::rpc::Logger::Level::INFO, component)
 
-#define NEXUS_WARN(component) Nexus::rpc::LogStream(Nexus::rpc::Logger::Level::WARN, component)
+#define NEXUS_WARN(component) NEXUS_STREAM_AT(Nexus::rpc::Logger::Level::WARN, component)
 
-#define NEXUS_ERROR(component) Nexus::rpc::LogStream(Nexus::rpc::Logger::Level::ERROR, component)
+#define NEXUS_ERROR(component) NEXUS_STREAM_AT(Nexus::rpc::Logger::Level::ERROR, component)
 
 }  // namespace rpc
 }  // namespace Nexus
@@ -0,0 +1,30 @@
+// LZ4 block compression (raw block format, no frame) for the UDP transport
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Compress @p size bytes into an LZ4 block
+ *
+ * Single-pass greedy matcher over a 4K-entry hash table (LZ4 "fast" level):
+ * a few hundred MB/s, and it gives up early on data that does not compress.
+ * Output is a standard LZ4 block, readable by any LZ4 decoder.
+ *
+ * @param capacity Bytes available at @p dst
+ * @return Compressed size, or 0 if the block does not fit in @p capacity
+ */
+size_t lz4Compress(const void* src, size_t size, void* dst, size_t capacity);
+
+/**
+ * @brief Decompress an LZ4 block, checking every offset and length against the buffers
+ * @param capacity Bytes available at @p dst
+ * @return Decompressed size, or SIZE_MAX if the block is malformed or does not fit
+ */
+size_t lz4Decompress(const void* src, size_t size, void* dst, size_t capacity);
+
+}  // namespace rpc
+}  // namespace Nexus
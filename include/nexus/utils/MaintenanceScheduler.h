@@ -0,0 +1,100 @@
+// Per-process scheduler for periodic maintenance work (heartbeats, timeouts, cleanup)
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "nexus/utils/ThreadPlacement.h"
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief One thread running the periodic tasks of every node in the process
+ *
+ * Nodes and transports register their housekeeping (heartbeats, timeout scans,
+ * orphan cleanup) here instead of each keeping a mostly idle thread that wakes
+ * every second. The thread starts with the first task and sleeps until the
+ * next task is due; with no tasks it does not wake at all.
+ *
+ * Tasks run one at a time on the scheduler thread, so they must be short and
+ * must not block: a slow task delays every other node's heartbeat. A task is
+ * rescheduled interval after its run finished (fixed delay, no catch-up).
+ */
+class MaintenanceScheduler {
+public:
+    using Task = std::function<void()>;
+    using TaskId = uint64_t;
+    static constexpr TaskId NO_TASK = 0;
+
+    static MaintenanceScheduler& instance();
+
+    ~MaintenanceScheduler();
+
+    /**
+     * @brief Run @p task every @p interval, the first time after @p initial_delay
+     * @return Id for cancel() / runSoon()
+     */
+    TaskId schedule(std::chrono::milliseconds interval, Task task, std::chrono::milliseconds initial_delay);
+    TaskId schedule(std::chrono::milliseconds interval, Task task) {
+        return schedule(interval, std::move(task), interval);
+    }
+
+    /**
+     * @brief Remove a task; once this returns the task is not running and never runs again
+     *
+     * Waits for a run in progress, except when called from the task itself.
+     * Unknown ids (and NO_TASK) are ignored.
+     */
+    void cancel(TaskId id);
+
+    /// Bring the next run of a task forward to now (again right after the current run, if it is running)
+    void runSoon(TaskId id);
+
+    size_t taskCount() const;
+
+    /**
+     * @brief CPU mask and scheduling of the scheduler thread, applied before its next task
+     *
+     * The thread is shared by the whole process: the last call wins.
+     */
+    void setThreadPlacement(const ThreadPlacement& placement);
+
+private:
+    MaintenanceScheduler() = default;
+    MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+    MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+
+    void run();
+
+    struct Entry {
+        Task task;
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point next_run;
+        bool rerun = false;  // runSoon() during a run
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cv_;  // New or earlier task, stop
+    std::condition_variable idle_cv_;  // A run finished (cancel() waits on it)
+    std::map<TaskId, Entry> tasks_;    // Few tasks per node: the next due one is found by a scan
+    TaskId next_id_ = 1;
+    TaskId running_ = NO_TASK;
+    bool stopping_ = false;
+    std::thread thread_;
+    pid_t owner_pid_ = 0;  // Process that started thread_ (a forked child must not join it)
+    ThreadPlacement placement_;       // setThreadPlacement()
+    bool placement_pending_ = false;  // Not applied by thread_ yet
+};
+
+}  // namespace rpc
+}  // namespace Nexus
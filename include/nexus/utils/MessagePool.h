@@ -0,0 +1,222 @@
+// Reusable payload storage for queued messages (in-process)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "nexus/utils/BoundedQueue.h"
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Slab pool of payload buffers shared by producers and consumers
+ *
+ * Payloads up to SLOT_SIZE bytes get a fixed-size slot carved from 64-slot
+ * chunks; larger payloads get an overflow buffer (power-of-two capacity)
+ * that is kept for reuse. Both free lists are lock-free, so acquire() on a
+ * receive thread and release() on a dispatch worker never contend on a lock
+ * and, once the pool has warmed up, never call malloc.
+ *
+ * Memory grows to the high-water mark (at most max_slots fixed slots) and is
+ * returned when the pool is destroyed. Past that limit, or when the overflow
+ * free list is full, buffers fall back to plain new/delete.
+ */
+class MessagePool {
+public:
+    static constexpr size_t SLOT_SIZE = 2048;        // Common message size (matches shm message_size)
+    static constexpr size_t SLOTS_PER_CHUNK = 64;    // Fixed slots allocated together (128KB)
+    static constexpr size_t MAX_OVERFLOW_FREE = 64;  // Large buffers kept for reuse
+
+    struct Buffer {
+        uint8_t* data = nullptr;
+        size_t capacity = 0;
+        bool slot = false;  // Fixed slot (owned by a chunk) rather than a heap buffer
+    };
+
+    explicit MessagePool(size_t max_slots)
+        : max_slots_(max_slots), free_slots_(max_slots), free_overflow_(MAX_OVERFLOW_FREE) {}
+
+    ~MessagePool() {
+        Buffer buffer;
+        while (free_overflow_.tryPop(buffer)) {
+            delete[] buffer.data;
+        }
+    }
+
+    MessagePool(const MessagePool&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+
+    /**
+     * @brief Get a buffer able to hold @p size bytes
+     */
+    Buffer acquire(size_t size) {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        Buffer buffer;
+        if (size <= SLOT_SIZE) {
+            if (free_slots_.tryPop(buffer.data) || grow(buffer.data)) {
+                buffer.capacity = SLOT_SIZE;
+                buffer.slot = true;
+                return buffer;
+            }
+        } else if (free_overflow_.tryPop(buffer)) {
+            if (buffer.capacity >= size) {
+                return buffer;
+            }
+            delete[] buffer.data;
+        }
+
+        // Pool exhausted (or no reusable large buffer): heap buffer, kept on release if there is room
+        buffer.capacity = roundUp(size);
+        buffer.data = new uint8_t[buffer.capacity];
+        return buffer;
+    }
+
+    /**
+     * @brief Return a buffer obtained from acquire()
+     */
+    void release(const Buffer& buffer) {
+        if (!buffer.data) {
+            return;
+        }
+        outstanding_.fetch_sub(1, std::memory_order_relaxed);
+        if (buffer.slot) {
+            uint8_t* slot = buffer.data;
+            free_slots_.tryPush(slot);  // Cannot fail: never more free slots than slots
+            return;
+        }
+        Buffer kept = buffer;
+        if (!free_overflow_.tryPush(kept)) {
+            delete[] buffer.data;
+        }
+    }
+
+    /**
+     * @brief Number of fixed slots allocated so far (high-water mark)
+     */
+    size_t allocatedSlots() const {
+        std::lock_guard<std::mutex> lock(chunks_mutex_);
+        return chunks_.size() * SLOTS_PER_CHUNK;
+    }
+
+    /**
+     * @brief Buffers acquired and not yet released (leak checks)
+     */
+    size_t outstanding() const { return outstanding_.load(std::memory_order_relaxed); }
+
+private:
+    static size_t roundUp(size_t size) {
+        size_t capacity = SLOT_SIZE;
+        while (capacity < size) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Allocate a new chunk: hand out its first slot, push the rest onto the free list
+    bool grow(uint8_t*& slot) {
+        std::lock_guard<std::mutex> lock(chunks_mutex_);
+        if ((chunks_.size() + 1) * SLOTS_PER_CHUNK > max_slots_) {
+            return false;
+        }
+
+        std::unique_ptr<uint8_t[]> chunk(new uint8_t[SLOTS_PER_CHUNK * SLOT_SIZE]);
+        uint8_t* base = chunk.get();
+        chunks_.push_back(std::move(chunk));
+        for (size_t i = 1; i < SLOTS_PER_CHUNK; ++i) {
+            uint8_t* free_slot = base + i * SLOT_SIZE;
+            free_slots_.tryPush(free_slot);
+        }
+        slot = base;
+        return true;
+    }
+
+    const size_t max_slots_;
+    BoundedMpmcQueue<uint8_t*> free_slots_;
+    BoundedMpmcQueue<Buffer> free_overflow_;
+    std::atomic<size_t> outstanding_{0};
+
+    mutable std::mutex chunks_mutex_;  // Only taken when growing
+    std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+};
+
+/**
+ * @brief Immutable, reference-counted payload in a MessagePool buffer
+ *
+ * One copy of a message shared by every queue it is delivered to. The
+ * header (reference count, owning pool) sits at the start of the buffer and
+ * the bytes follow it, so a payload of up to SLOT_SIZE - HEADER_SIZE bytes
+ * fits a fixed slot. The handle is a plain pointer, which keeps queue
+ * entries trivially copyable: references are taken with retain() and
+ * dropped with release(), and the last release() returns the buffer to the
+ * pool (which must outlive every payload it holds).
+ */
+class SharedPayload {
+    struct Header {
+        std::atomic<uint32_t> refs;
+        size_t size;
+        MessagePool* pool;
+        MessagePool::Buffer buffer;
+    };
+
+public:
+    static constexpr size_t HEADER_SIZE = (sizeof(Header) + 15) & ~size_t(15);  // Bytes stay 16-byte aligned
+
+    SharedPayload() = default;
+
+    /**
+     * @brief Copy @p size bytes into a buffer of @p pool; the caller holds the only reference
+     */
+    static SharedPayload create(MessagePool& pool, const uint8_t* data, size_t size) {
+        MessagePool::Buffer buffer = pool.acquire(HEADER_SIZE + size);
+        SharedPayload payload;
+        payload.header_ = new (buffer.data) Header();
+        payload.header_->refs.store(1, std::memory_order_relaxed);
+        payload.header_->size = size;
+        payload.header_->pool = &pool;
+        payload.header_->buffer = buffer;
+        if (size > 0) {
+            std::memcpy(buffer.data + HEADER_SIZE, data, size);
+        }
+        return payload;
+    }
+
+    explicit operator bool() const { return header_ != nullptr; }
+    const uint8_t* data() const { return header_ ? header_->buffer.data + HEADER_SIZE : nullptr; }
+    size_t size() const { return header_ ? header_->size : 0; }
+    uint32_t references() const { return header_ ? header_->refs.load(std::memory_order_relaxed) : 0; }
+
+    /**
+     * @brief Take another reference (for one more queued delivery)
+     */
+    void retain() const {
+        if (header_) {
+            header_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Drop this handle's reference and clear it (no-op on an empty handle)
+     */
+    void release() {
+        if (header_ && header_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            MessagePool* pool = header_->pool;
+            const MessagePool::Buffer buffer = header_->buffer;
+            header_->~Header();
+            pool->release(buffer);
+        }
+        header_ = nullptr;
+    }
+
+private:
+    Header* header_ = nullptr;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,170 @@
+// Per-node shared memory metrics segment, readable by external monitors (nexus_top)
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Layout of a node's metrics segment (shared memory "/librpc_metrics_<node id>")
+ *
+ * Counters are relaxed atomics in named arrays (see the *_NAMES tables), so a
+ * monitor or exporter can print every metric without knowing them. The owner
+ * refreshes the whole segment under a sequence counter (odd while a refresh is
+ * in progress); readers retry until they see the same even value before and
+ * after copying. Counters marked "total" only grow: rates come from diffing
+ * two snapshots. The others are levels sampled at refresh time.
+ */
+struct MetricsLayout {
+    static constexpr uint32_t MAGIC = 0x544D584E;  // "NXMT"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t NAME_LEN = 128;
+    static constexpr size_t MAX_TOPICS = 256;
+    static constexpr size_t MAX_LARGE_READERS = 16;
+
+    enum NodeMetric : uint32_t {
+        WORKER_QUEUE_DEPTH,    // Messages waiting for a subscriber callback
+        WORKER_DROPPED,        // Total: messages dropped by the subscription queues
+        SHM_SENT,              // Total: frames sent over shared memory
+        SHM_RECEIVED,          // Total
+        SHM_DROPPED,           // Total: frames that found no credit
+        SHM_BYTES_SENT,        // Total
+        SHM_BYTES_RECEIVED,    // Total
+        SHM_INBOUND_QUEUES,    // Senders with a queue into this node
+        SHM_INBOX_DEPTH,       // Frames waiting in the shared inbox
+        SHM_DEPTH_HIGH,        // Frames waiting per data lane, across inbound queues
+        SHM_DEPTH_NORMAL,
+        SHM_DEPTH_BULK,
+        SHM_DROPPED_HIGH,      // Total, per data lane
+        SHM_DROPPED_NORMAL,
+        SHM_DROPPED_BULK,
+        SHM_MAX_CONGESTION,    // Highest congestion level (0-100) of the inbound queues
+        NODE_METRICS
+    };
+
+    enum TopicMetric : uint32_t {
+        TOPIC_PUBLISHED,        // Total
+        TOPIC_PUBLISHED_BYTES,  // Total
+        TOPIC_DELIVERED,        // Total
+        TOPIC_DELIVERED_BYTES,  // Total
+        TOPIC_DROPPED,          // Total
+        TOPIC_CALLBACK_NS,      // Total
+        TOPIC_QUEUE_DEPTH,      // Messages waiting for the topic's callback
+        TOPIC_METRICS
+    };
+
+    enum LargeReaderMetric : uint32_t {
+        READER_LAG_BYTES,    // Written but not yet read by this node's reader
+        READER_CAPACITY,     // Channel ring size
+        READER_BYTES_READ,   // Total
+        LARGE_READER_METRICS
+    };
+
+    static const char* const NODE_NAMES[NODE_METRICS];
+    static const char* const TOPIC_NAMES[TOPIC_METRICS];
+    static const char* const LARGE_READER_NAMES[LARGE_READER_METRICS];
+
+    struct Entry {
+        char name[NAME_LEN];  // Topic: "group/topic"; large data reader: channel name (truncated, NUL-terminated)
+    };
+
+    struct TopicEntry : Entry {
+        std::atomic<uint64_t> values[TOPIC_METRICS];
+    };
+
+    struct LargeReaderEntry : Entry {
+        std::atomic<uint64_t> values[LARGE_READER_METRICS];
+    };
+
+    uint32_t magic;
+    uint32_t version;
+    int32_t pid;  // Owner process
+    uint32_t reserved;
+    char node_id[NAME_LEN];
+    std::atomic<uint32_t> sequence;  // Odd while the owner rewrites the segment
+    std::atomic<uint32_t> topic_count;
+    std::atomic<uint32_t> large_reader_count;
+    std::atomic<uint32_t> interval_ms;  // Refresh period
+    std::atomic<uint64_t> update_ms;    // Wall clock (ms since the epoch) of the last refresh
+    std::atomic<uint64_t> node[NODE_METRICS];
+    TopicEntry topics[MAX_TOPICS];
+    LargeReaderEntry large_readers[MAX_LARGE_READERS];
+};
+
+/**
+ * @brief Plain copy of a metrics segment (MetricsSegment::read())
+ */
+struct MetricsSnapshot {
+    struct Row {
+        std::string name;
+        std::vector<uint64_t> values;  // Indexed by the layout's metric enum
+    };
+
+    std::string segment;  // Shared memory name
+    std::string node_id;
+    pid_t pid = 0;
+    bool alive = false;  // Owner process still exists
+    uint32_t interval_ms = 0;
+    uint64_t update_ms = 0;
+    uint64_t node[MetricsLayout::NODE_METRICS] = {};
+    std::vector<Row> topics;
+    std::vector<Row> large_readers;
+};
+
+/**
+ * @brief A node's metrics segment (owner side), plus discovery and reading for monitors
+ *
+ * The owner creates the segment, then brackets each refresh with
+ * beginUpdate()/endUpdate(). The segment is unlinked on destruction; segments
+ * of processes that died without it are removed by removeOrphaned().
+ */
+class MetricsSegment {
+public:
+    static constexpr const char* PREFIX = "librpc_metrics_";
+
+    MetricsSegment() = default;
+    ~MetricsSegment();
+
+    MetricsSegment(const MetricsSegment&) = delete;
+    MetricsSegment& operator=(const MetricsSegment&) = delete;
+
+    // Shared memory name of a node's segment
+    static std::string segmentName(const std::string& node_id);
+
+    /**
+     * @brief Create (or take over) the segment of @p node_id
+     * @return false if it cannot be created (the node runs without one)
+     */
+    bool create(const std::string& node_id, uint32_t interval_ms);
+
+    MetricsLayout* layout() { return layout_; }
+
+    void beginUpdate();
+    void endUpdate();
+
+    // Names of every metrics segment on this host
+    static std::vector<std::string> list();
+
+    /**
+     * @brief Consistent copy of segment @p name
+     * @return false if it does not exist, is not a metrics segment, or stayed busy
+     */
+    static bool read(const std::string& name, MetricsSnapshot& snapshot);
+
+    // Unlink the segments whose owner process is gone; returns how many
+    static size_t removeOrphaned();
+
+private:
+    MetricsLayout* layout_ = nullptr;
+    std::string name_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
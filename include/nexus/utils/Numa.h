@@ -0,0 +1,39 @@
+// NUMA placement of shared memory and threads (Linux; no-ops elsewhere)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief CPUs of NUMA node @p node as a mask (CPUs >= 64 are ignored, like the other CPU masks)
+ *
+ * Read from /sys/devices/system/node/node<N>/cpulist.
+ *
+ * @return The mask, or 0 when the node does not exist or the platform has no NUMA information
+ */
+uint64_t numaNodeCpus(int node);
+
+/**
+ * @brief Bind the pages of [addr, addr + size) to NUMA node @p node (mbind MPOL_BIND)
+ *
+ * For a shared mapping of a shm_open segment the policy belongs to the segment
+ * itself, so pages faulted in later by any process land on @p node. Pages that
+ * already exist are migrated. Best effort: failure (no NUMA support, unknown
+ * node, seccomp) only logs a warning.
+ *
+ * @return true if the policy was applied
+ */
+bool bindMemoryToNumaNode(void* addr, size_t size, int node);
+
+/**
+ * @brief NUMA node holding the page at @p addr (get_mempolicy MPOL_F_NODE | MPOL_F_ADDR)
+ *
+ * @return The node, or -1 when it cannot be determined
+ */
+int numaNodeOf(const void* addr);
+
+}  // namespace rpc
+}  // namespace Nexus
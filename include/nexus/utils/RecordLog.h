@@ -0,0 +1,228 @@
+// Append-only, memory-mapped log of recorded messages and large data blocks (Recorder / Replayer)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief On-disk layout of a record segment ("<base>.<index>.nxrec")
+ *
+ * A recording is a numbered series of segment files. Each one is a header
+ * followed by frames, every frame 8-byte aligned:
+ *
+ *   STREAM  interns a stream: payload = StreamRecord + name + topic
+ *   DATA    one message or large data block of a stream
+ *   INDEX   sparse time index: payload = IndexEntry[]
+ *
+ * A segment is self-contained: it repeats the STREAM frames of every stream
+ * seen so far before its first DATA frame. Closing a segment appends a
+ * trailer (all STREAM frames again, then the INDEX frame) and records its
+ * offset in the header, so a reader finds streams and index without a scan.
+ * A segment left open by a crash has no trailer; it ends at the first frame
+ * whose type is still 0, and readers rebuild the index by scanning it.
+ *
+ * Times are nanoseconds of a monotonic clock since the recording started
+ * (start_wall_ns gives the wall clock of that instant).
+ */
+struct RecordLayout {
+    static constexpr uint32_t MAGIC = 0x4345524E;  // "NREC"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t ALIGN = 8;
+
+    enum FrameType : uint16_t { FRAME_NONE = 0, FRAME_STREAM = 1, FRAME_DATA = 2, FRAME_INDEX = 3 };
+    enum StreamKind : uint16_t { STREAM_MESSAGE = 1, STREAM_LARGE_DATA = 2 };
+
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t segment;        // Position in the recording (0, 1, ...)
+        uint32_t reserved;
+        uint64_t start_wall_ns;  // Wall clock (ns since the epoch) at time 0 of the recording
+        uint64_t index_interval_ns;
+        uint64_t trailer_offset;  // First trailer frame (0: segment not closed)
+        uint64_t end_offset;      // Bytes used, trailer included (0: segment not closed)
+        uint64_t reserved2[2];
+    };
+
+    struct FrameHeader {
+        uint32_t size;  // Payload bytes (the frame takes frameSize(size))
+        uint16_t type;  // FrameType, stored last (0 = not written yet)
+        uint16_t reserved;
+        uint32_t stream;  // DATA, STREAM: stream id
+        uint32_t reserved2;
+        uint64_t time_ns;
+    };
+
+    // Payload of a STREAM frame, followed by the name and the topic (not NUL-terminated)
+    struct StreamRecord {
+        uint16_t kind;  // StreamKind
+        uint16_t name_len;
+        uint16_t topic_len;
+        uint16_t reserved;
+    };
+
+    struct IndexEntry {
+        uint64_t time_ns;
+        uint64_t offset;  // Of the first DATA frame at or after time_ns
+    };
+
+    static size_t frameSize(size_t payload) { return (sizeof(FrameHeader) + payload + ALIGN - 1) & ~(ALIGN - 1); }
+
+    // "<base>.000003.nxrec"
+    static std::string segmentPath(const std::string& base, uint32_t segment);
+};
+
+/**
+ * @brief A recorded stream: a topic of a message group, or a topic of a large data channel
+ */
+struct RecordStream {
+    RecordLayout::StreamKind kind = RecordLayout::STREAM_MESSAGE;
+    std::string name;   // Message group, or large data channel
+    std::string topic;
+};
+
+/**
+ * @brief Appends frames to a recording, rolling to a new segment when one is full
+ *
+ * Each segment file is reserved at full size (posix_fallocate, so a full disk
+ * fails open() rather than a write through the mapping) and mapped shared;
+ * append() is one memcpy into the mapping and the kernel writes the pages
+ * back. On close the file is truncated to the bytes used. All methods are
+ * thread-safe; frames are timestamped and ordered under one lock.
+ */
+class RecordWriter {
+public:
+    struct Options {
+        size_t segment_size = size_t(1) << 30;          // Bytes per segment file
+        uint64_t index_interval_ns = 100 * 1000 * 1000;  // Time between two index entries
+    };
+
+    RecordWriter() = default;
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    /**
+     * @brief Start a recording: segments are "<base>.<index>.nxrec"
+     * @return false if the first segment cannot be created
+     */
+    bool open(const std::string& base, const Options& options);
+    bool open(const std::string& base) { return open(base, Options()); }
+    bool isOpen() const;
+
+    /**
+     * @brief Id of a stream, interned (and a STREAM frame written) on first use
+     * @return UINT32_MAX if the recording is closed or out of space
+     */
+    uint32_t addStream(const RecordStream& stream);
+
+    /**
+     * @brief Append one DATA frame of stream @p stream, timestamped now
+     * @return false if the frame was not recorded (closed, larger than a segment, or no disk space)
+     */
+    bool append(uint32_t stream, const uint8_t* data, size_t size);
+
+    // Write the trailer of the current segment and stop
+    void close();
+
+    struct Stats {
+        uint64_t frames = 0;   // DATA frames recorded
+        uint64_t bytes = 0;    // Their payload bytes
+        uint64_t dropped = 0;  // DATA frames append() refused
+        uint32_t segments = 0;
+    };
+    Stats getStats() const;
+
+private:
+    // Callers hold mutex_
+    bool openSegment();   // Create segment_ and repeat the streams
+    void closeSegment();  // Trailer, unmap, truncate to the bytes used
+    // Room for a frame in the current segment (rolling to the next if needed), keeping the trailer's room
+    uint8_t* reserve(size_t frame_size, size_t trailer_growth);
+    // Header and payload (@p data nullptr: payload already in place)
+    void writeFrame(uint8_t* frame, RecordLayout::FrameType type, uint32_t stream, uint64_t time_ns,
+                    const void* data, size_t size);
+    void writeStream(uint8_t* frame, uint32_t id, uint64_t time_ns);
+    uint64_t now() const;
+
+    mutable std::mutex mutex_;
+    std::string base_;
+    Options options_;
+    uint64_t start_ns_ = 0;  // Monotonic clock at time 0
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t used_ = 0;  // Bytes of the current segment, header included
+    uint32_t segment_ = 0;
+    bool open_ = false;
+
+    std::vector<RecordStream> streams_;
+    std::unordered_map<std::string, uint32_t> stream_ids_;  // kind, name and topic -> id
+    size_t streams_bytes_ = 0;                              // STREAM frames of all streams
+    std::vector<RecordLayout::IndexEntry> index_;          // Current segment
+    Stats stats_;
+};
+
+/**
+ * @brief Reads one segment of a recording (mapped read-only)
+ */
+class RecordReader {
+public:
+    struct Frame {
+        uint32_t stream = 0;
+        uint64_t time_ns = 0;
+        const uint8_t* data = nullptr;  // Into the mapping: valid until the reader is closed
+        size_t size = 0;
+    };
+
+    RecordReader() = default;
+    ~RecordReader();
+
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+
+    // Segment files of recording @p base, in order
+    static std::vector<std::string> segments(const std::string& base);
+
+    /**
+     * @brief Map segment @p path and load its streams and index (scanning it if it was not closed)
+     */
+    bool open(const std::string& path);
+    void close();
+
+    const RecordLayout::SegmentHeader& header() const { return *header_; }
+    const std::vector<RecordStream>& streams() const { return streams_; }  // Indexed by stream id
+    const std::vector<RecordLayout::IndexEntry>& index() const { return index_; }
+    bool closedCleanly() const { return header_ && header_->trailer_offset != 0; }
+
+    // Next DATA frame; false at the end of the segment
+    bool next(Frame& frame);
+
+    // Continue at the first DATA frame at or after @p time_ns (from the closest index entry before it)
+    void seek(uint64_t time_ns);
+
+private:
+    const RecordLayout::FrameHeader* frameAt(size_t offset) const;  // nullptr past the end
+    void addStream(const RecordLayout::FrameHeader& frame);
+
+    int fd_ = -1;
+    const uint8_t* map_ = nullptr;
+    size_t size_ = 0;
+    size_t end_ = 0;  // End of the data frames (trailer or first unwritten frame)
+    size_t offset_ = 0;
+    uint64_t skip_before_ns_ = 0;  // Set by seek()
+    const RecordLayout::SegmentHeader* header_ = nullptr;
+    std::vector<RecordStream> streams_;
+    std::vector<RecordLayout::IndexEntry> index_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
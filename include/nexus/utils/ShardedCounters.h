@@ -0,0 +1,139 @@
+// Per-key statistics counters sharded per thread (in-process)
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief N counters per dense key (topic id), written without contention
+ *
+ * Each thread adds into its own shard (threads are spread round-robin over
+ * SHARDS), and every key's counters fill their own cache line(s), so writers
+ * on different threads or keys never share a line. A writer does one relaxed
+ * fetch_add; read() sums the shards on demand and is only as consistent as
+ * relaxed counters are (a concurrent add may or may not be included).
+ *
+ * Storage grows in chunks of KEYS_PER_CHUNK keys per shard, allocated on a
+ * thread's first add to a chunk and kept until destruction. Keys at or above
+ * MAX_KEYS are not counted.
+ */
+template <size_t N>
+class ShardedCounters {
+public:
+    static constexpr size_t SHARDS = 16;
+    static constexpr size_t KEYS_PER_CHUNK = 64;
+    static constexpr size_t MAX_CHUNKS = 256;
+    static constexpr size_t MAX_KEYS = KEYS_PER_CHUNK * MAX_CHUNKS;
+
+    ShardedCounters() : key_limit_(0) {
+        for (auto& shard : chunks_) {
+            for (auto& chunk : shard) {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ~ShardedCounters() {
+        for (auto& shard : chunks_) {
+            for (auto& chunk : shard) {
+                delete chunk.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    ShardedCounters(const ShardedCounters&) = delete;
+    ShardedCounters& operator=(const ShardedCounters&) = delete;
+
+    void add(uint32_t key, size_t counter, uint64_t value = 1) {
+        if (key >= MAX_KEYS || counter >= N) {
+            return;
+        }
+        std::atomic<Chunk*>& slot = chunks_[shardIndex()][key / KEYS_PER_CHUNK];
+        Chunk* chunk = slot.load(std::memory_order_acquire);
+        if (!chunk) {
+            chunk = install(slot, key);
+        }
+        chunk->blocks[key % KEYS_PER_CHUNK].values[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum of every shard's counters for @p key
+     * @return false if nothing was ever added for the key's chunk (@p out is zeroed)
+     */
+    bool read(uint32_t key, uint64_t (&out)[N]) const {
+        std::fill(out, out + N, 0);
+        if (key >= MAX_KEYS) {
+            return false;
+        }
+        bool found = false;
+        for (const auto& shard : chunks_) {
+            const Chunk* chunk = shard[key / KEYS_PER_CHUNK].load(std::memory_order_acquire);
+            if (!chunk) {
+                continue;
+            }
+            found = true;
+            const Block& block = chunk->blocks[key % KEYS_PER_CHUNK];
+            for (size_t i = 0; i < N; ++i) {
+                out[i] += block.values[i].load(std::memory_order_relaxed);
+            }
+        }
+        return found;
+    }
+
+    /// One past the highest key whose chunk exists (keys below it may still read as zero)
+    uint32_t keyLimit() const { return key_limit_.load(std::memory_order_acquire); }
+
+private:
+    // Padded rather than alignas(64) so heap allocation needs no over-aligned new (C++14)
+    struct Block {
+        std::atomic<uint64_t> values[N];
+        char pad[64 - (N * sizeof(uint64_t)) % 64];
+    };
+
+    struct Chunk {
+        Block blocks[KEYS_PER_CHUNK];
+    };
+
+    // Threads are spread round-robin over the shards on first use
+    static size_t shardIndex() {
+        static std::atomic<size_t> next_shard{0};
+        thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return shard;
+    }
+
+    Chunk* install(std::atomic<Chunk*>& slot, uint32_t key) {
+        Chunk* fresh = new Chunk();  // Value-initialized: counters start at zero
+        Chunk* expected = nullptr;
+        if (!slot.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+            delete fresh;  // Another thread of this shard installed it first
+            return expected;
+        }
+        const uint32_t limit = static_cast<uint32_t>((key / KEYS_PER_CHUNK + 1) * KEYS_PER_CHUNK);
+        uint32_t current = key_limit_.load(std::memory_order_relaxed);
+        while (current < limit &&
+               !key_limit_.compare_exchange_weak(current, limit, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+        return fresh;
+    }
+
+    std::atomic<Chunk*> chunks_[SHARDS][MAX_CHUNKS];
+    std::atomic<uint32_t> key_limit_;
+};
+
+template <size_t N>
+constexpr size_t ShardedCounters<N>::SHARDS;
+template <size_t N>
+constexpr size_t ShardedCounters<N>::KEYS_PER_CHUNK;
+template <size_t N>
+constexpr size_t ShardedCounters<N>::MAX_CHUNKS;
+template <size_t N>
+constexpr size_t ShardedCounters<N>::MAX_KEYS;
+
+}  // namespace rpc
+}  // namespace Nexus
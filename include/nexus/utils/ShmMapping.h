@@ -0,0 +1,75 @@
+// mmap() of shared memory segments with optional huge pages, prefaulting and locking
+#pragma once
+
+#include <cstddef>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief How a shared memory segment is mapped
+ *
+ * The defaults reproduce the plain MAP_SHARED | MAP_NORESERVE mapping. The
+ * other options trade startup time and resident memory for fewer page faults
+ * and TLB misses once traffic flows.
+ */
+struct ShmMapOptions {
+    bool noreserve = true;    // MAP_NORESERVE (ignored on QNX)
+    bool huge_pages = false;  // madvise(MADV_HUGEPAGE): transparent huge pages for the shmem mapping
+    bool prefault = false;    // Fault every page in at map time (MAP_POPULATE) instead of on first access
+    bool lock = false;        // mlock(): keep the pages resident (subject to RLIMIT_MEMLOCK)
+    int numa_node = -1;       // mbind() the segment to this NUMA node before any page is touched (-1 = none)
+};
+
+/**
+ * @brief Map @p size bytes of @p fd, then apply the optional advice
+ *
+ * Huge pages, NUMA binding and locking are best effort: a kernel without shmem
+ * THP or NUMA support, or a too-small RLIMIT_MEMLOCK only logs a warning and
+ * keeps the mapping. The NUMA policy is set on the segment itself, so only the
+ * process that creates (owns) a segment should pass numa_node. The
+ * segment comes from shm_open (tmpfs), which rejects MAP_HUGETLB, so huge
+ * pages come from the shmem THP policy (/sys/kernel/mm/transparent_hugepage/
+ * shmem_enabled set to "advise" or "always").
+ *
+ * @return The mapping, or MAP_FAILED (errno set by mmap)
+ */
+void* mapSharedMemory(int fd, size_t size, int prot, const ShmMapOptions& options);
+
+/**
+ * @brief Map a segment whose ring area is mapped twice, back to back
+ *
+ * Maps [0, data_offset + capacity) of @p fd, then maps the ring area
+ * [data_offset, data_offset + capacity) again right behind it, so a record
+ * that runs past the end of the ring continues contiguously at its start.
+ * Both offsets must be multiples of the page size. The mapping spans
+ * data_offset + 2 * capacity bytes (pass that to munmap).
+ *
+ * @return The mapping, or MAP_FAILED
+ */
+void* mapSharedMemoryMirrored(int fd, size_t data_offset, size_t capacity, int prot, const ShmMapOptions& options);
+
+/**
+ * @brief Address space and RAM taken by one mapping
+ */
+struct MappingUsage {
+    size_t mapped = 0;    // Bytes mapped
+    size_t resident = 0;  // Bytes of those whose pages are in RAM
+};
+
+/**
+ * @brief mincore() sampling of [@p addr, @p addr + @p size)
+ *
+ * For a shared segment a page counts as resident once any process has touched
+ * it, so every process mapping the segment sees the same figure. @p addr must
+ * be page aligned. A failed mincore() reports resident = 0.
+ */
+MappingUsage mappingUsage(const void* addr, size_t size);
+
+/**
+ * @brief Resident set size of the calling process (/proc/self/statm), 0 if unavailable
+ */
+size_t processResidentBytes();
+
+}  // namespace rpc
+}  // namespace Nexus
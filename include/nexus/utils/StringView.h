@@ -0,0 +1,66 @@
+// Non-owning string reference for the receive path (C++14 stand-in for std::string_view)
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace Nexus {
+namespace rpc {
+
+/**
+ * @brief Read-only view of characters owned by someone else
+ *
+ * Used to pass group/topic/node names straight out of a received packet
+ * without copying them into std::string. Compares with std::string, so
+ * containers with a transparent comparator (std::less<>) can be searched
+ * by view. The viewed memory must outlive the view.
+ */
+class StringView {
+public:
+    StringView() : data_(""), size_(0) {}
+    StringView(const char* data, size_t size) : data_(data), size_(size) {}
+    StringView(const char* str) : data_(str), size_(std::strlen(str)) {}  // Implicit, like string_view
+    StringView(const std::string& str) : data_(str.data()), size_(str.size()) {}
+
+    // Bounded C string, e.g. a fixed-size header field that may lack a terminator
+    static StringView fromField(const char* field, size_t max_len) {
+        const void* end = std::memchr(field, '\0', max_len);
+        return StringView(field, end ? static_cast<size_t>(static_cast<const char*>(end) - field) : max_len);
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    std::string str() const { return std::string(data_, size_); }
+
+    int compare(StringView other) const {
+        const size_t common = size_ < other.size_ ? size_ : other.size_;
+        const int result = common > 0 ? std::memcmp(data_, other.data_, common) : 0;
+        if (result != 0) {
+            return result;
+        }
+        return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+};
+
+inline bool operator==(StringView a, StringView b) {
+    return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+inline bool operator!=(StringView a, StringView b) { return !(a == b); }
+inline bool operator<(StringView a, StringView b) { return a.compare(b) < 0; }
+
+// Mixed comparisons for heterogeneous lookup in std::map/std::set<std::string, std::less<>>
+inline bool operator<(const std::string& a, StringView b) { return StringView(a).compare(b) < 0; }
+inline bool operator<(StringView a, const std::string& b) { return a.compare(StringView(b)) < 0; }
+
+inline std::ostream& operator<<(std::ostream& os, StringView view) { return os.write(view.data(), view.size()); }
+
+}  // namespace rpc
+}  // namespace Nexus
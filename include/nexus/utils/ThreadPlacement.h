@@ -0,0 +1,60 @@
+// CPU affinity and scheduling policy of the calling thread (Linux and QNX)
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nexus {
+namespace rpc {
+
+enum class SchedPolicy {
+    INHERIT,  // Keep the scheduling the thread was created with
+    OTHER,    // SCHED_OTHER (time sharing)
+    FIFO,     // SCHED_FIFO
+    RR,       // SCHED_RR
+};
+
+/**
+ * @brief Where and how one thread role runs (see Config::threads)
+ */
+struct ThreadPlacement {
+    uint64_t cpu_mask = 0;                      // CPUs the thread may run on (CPU i = bit i; 0 = any)
+    SchedPolicy policy = SchedPolicy::INHERIT;  // Scheduling policy
+    int priority = 0;                           // FIFO/RR priority (Linux 1-99, QNX 1-255); ignored otherwise
+};
+
+/**
+ * @brief Restrict the calling thread to the CPUs of @p mask
+ *
+ * pthread_setaffinity_np() on Linux, ThreadCtl(_NTO_TCTL_RUNMASK) on QNX.
+ * Failure only logs a warning naming @p role.
+ * @return true if the mask was applied
+ */
+bool pinCurrentThread(uint64_t mask, const std::string& role);
+
+/**
+ * @brief Apply @p placement to the calling thread
+ *
+ * The CPU mask goes first, then the policy and priority. Real-time policies
+ * need CAP_SYS_NICE or an RLIMIT_RTPRIO at least as high as the priority on
+ * Linux; without it the thread keeps its scheduling and a warning is logged.
+ * @return true if everything requested was applied (nothing requested: true)
+ */
+bool applyThreadPlacement(const ThreadPlacement& placement, const std::string& role);
+
+/**
+ * @brief CPU mask of "0-1,3" (CPUs >= 64 are ignored; 0 for an empty set)
+ */
+uint64_t parseCpuSet(const std::string& set);
+
+/**
+ * @brief Parse "policy[:priority][@cpus]", e.g. "fifo:80@2-3", "rr:10", "@4,6" or "other"
+ *
+ * Policies: inherit, other, fifo, rr. A spec of only "@cpus" keeps the
+ * policy inherited.
+ * @return false (and @p placement unchanged) for an unknown policy
+ */
+bool parseThreadPlacement(const std::string& spec, ThreadPlacement& placement);
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,149 @@
+// Segment trie for wildcard topic subscriptions ("sensors/*", "camera/front/#")
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "nexus/utils/StringView.h"
+
+namespace Nexus {
+namespace rpc {
+
+// End of the topic segment starting at @p begin (index of the next '/' or the size)
+inline size_t topicSegmentEnd(StringView topic, size_t begin) {
+    const void* slash =
+        begin < topic.size() ? std::memchr(topic.data() + begin, '/', topic.size() - begin) : nullptr;
+    return slash ? static_cast<size_t>(static_cast<const char*>(slash) - topic.data()) : topic.size();
+}
+
+/**
+ * @brief True if @p topic contains a '*' or '#' segment (a wildcard subscription)
+ */
+inline bool isTopicPattern(StringView topic) {
+    size_t begin = 0;
+    while (begin <= topic.size()) {
+        size_t end = topicSegmentEnd(topic, begin);
+        if (end - begin == 1 && (topic.data()[begin] == '*' || topic.data()[begin] == '#')) {
+            return true;
+        }
+        begin = end + 1;
+    }
+    return false;
+}
+
+/**
+ * @brief Match one pattern without building a trie (see TopicTrie; plain topics compare equal)
+ */
+inline bool topicMatches(StringView pattern, StringView topic) {
+    size_t p = 0;
+    size_t t = 0;
+    while (p <= pattern.size()) {
+        size_t p_end = topicSegmentEnd(pattern, p);
+        StringView segment(pattern.data() + p, p_end - p);
+        if (segment == StringView("#")) {
+            return true;
+        }
+        if (t > topic.size()) {
+            return false;
+        }
+        size_t t_end = topicSegmentEnd(topic, t);
+        if (segment != StringView("*") && segment != StringView(topic.data() + t, t_end - t)) {
+            return false;
+        }
+        p = p_end + 1;
+        t = t_end + 1;
+    }
+    return t > topic.size();
+}
+
+/**
+ * @brief Topic patterns compiled into a trie over '/'-separated segments
+ *
+ * A '*' segment matches exactly one segment; a trailing '#' segment matches
+ * the rest of the topic (zero or more segments). Any other segment matches
+ * itself. Matching walks the topic once and visits at most the literal, '*'
+ * and '#' child per level, so its cost follows the topic depth, not the number
+ * of patterns. Each pattern carries a value of type T.
+ *
+ * Built once and then only read (share it as std::shared_ptr<const TopicTrie>).
+ */
+template <typename T>
+class TopicTrie {
+public:
+    TopicTrie() : root_(new Node()) {}
+
+    TopicTrie(const TopicTrie&) = delete;
+    TopicTrie& operator=(const TopicTrie&) = delete;
+
+    /**
+     * @brief Add a pattern (or plain topic); a repeated pattern replaces its value
+     * @return false if '#' is not the last segment
+     */
+    bool insert(StringView pattern, const T& value) {
+        Node* node = root_.get();
+        size_t begin = 0;
+        while (begin <= pattern.size()) {
+            size_t end = topicSegmentEnd(pattern, begin);
+            StringView segment(pattern.data() + begin, end - begin);
+            if (segment == StringView("#") && end != pattern.size()) {
+                return false;
+            }
+            std::unique_ptr<Node>& child = segment == StringView("*")   ? node->any_one
+                                           : segment == StringView("#") ? node->any_rest
+                                                                        : node->children[segment.str()];
+            if (!child) {
+                child.reset(new Node());
+            }
+            node = child.get();
+            begin = end + 1;
+        }
+        node->has_value = true;
+        node->value = value;
+        return true;
+    }
+
+    /**
+     * @brief Value of a pattern matching @p topic (literal segments take precedence), or nullptr
+     */
+    const T* match(StringView topic) const { return match(root_.get(), topic, 0); }
+
+private:
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children;  // Literal segments
+        std::unique_ptr<Node> any_one;                                        // '*'
+        std::unique_ptr<Node> any_rest;                                       // '#'
+        bool has_value = false;
+        T value = T();
+    };
+
+    // Match the topic from segment offset @p begin (past the end: every segment consumed)
+    static const T* match(const Node* node, StringView topic, size_t begin) {
+        const T* rest = (node->any_rest && node->any_rest->has_value) ? &node->any_rest->value : nullptr;
+        if (begin > topic.size()) {
+            return node->has_value ? &node->value : rest;  // '#' also matches zero segments
+        }
+
+        size_t end = topicSegmentEnd(topic, begin);
+        auto it = node->children.find(StringView(topic.data() + begin, end - begin));
+        if (it != node->children.end()) {
+            if (const T* value = match(it->second.get(), topic, end + 1)) {
+                return value;
+            }
+        }
+        if (node->any_one) {
+            if (const T* value = match(node->any_one.get(), topic, end + 1)) {
+                return value;
+            }
+        }
+        return rest;
+    }
+
+    std::unique_ptr<Node> root_;
+};
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,105 @@
+// Static tracepoints on the send, receive and dispatch paths (USDT on Linux, QNX kernel trace events)
+#pragma once
+
+/**
+ * Probes of provider "nexus", with their arguments:
+ *
+ *   shm_send       (handle, frames, lane)          Frames handed to a shared memory connection
+ *   shm_ring_write (queue, frames, lane)           Frames written into a receiver's ring
+ *   shm_ring_read  (queue, bytes, lane)            One frame read from this node's rings
+ *   shm_wakeup     (shard, signalled)              Receive thread back from its wait (0: timed out)
+ *   node_enqueue   (topic_id, bytes, queued)       Message queued for dispatch (0: dropped by the policy)
+ *   callback_begin (topic_id, bytes, inline)       Subscriber callback about to run
+ *   callback_end   (topic_id, bytes, inline)
+ *   large_write    (channel, bytes, sequence)      Block committed to a large data channel
+ *   large_read     (channel, bytes, sequence)      Block returned by LargeDataChannel::tryRead()
+ *   udp_send       (port, bytes)                   Datagram (or GSO batch) sent (port: destination)
+ *   udp_recv       (port, bytes)                   Datagram delivered (port: source)
+ *
+ * shm lanes are the data lanes (0 = high priority), then the control queue
+ * (DATA_LANES) and the shared inbox (DATA_LANES + 1). Channel names are C
+ * strings (bpftrace: str(arg0)).
+ *
+ * Linux: built with <sys/sdt.h> (systemtap-sdt-dev), every probe is one nop
+ * plus an ELF note. Tracers (bpftrace, perf probe, SystemTap) enable it in a
+ * running process:
+ *
+ *     bpftrace -e 'usdt:/usr/lib/librpc.so:nexus:shm_ring_read { @bytes = hist(arg1); }'
+ *
+ * Arguments are evaluated even while no tracer is attached, so they must stay
+ * plain values. Without the header the probes compile to nothing.
+ *
+ * QNX: each probe is a trace_logi() user event (_NTO_TRACE_USERFIRST + probe
+ * id, first two arguments). That is a kernel call per probe, so the CMake
+ * option ENABLE_TRACEPOINTS defaults to OFF there. ENABLE_TRACEPOINTS=OFF
+ * (NEXUS_NO_TRACEPOINTS) removes the probes on every platform.
+ */
+
+#if defined(NEXUS_NO_TRACEPOINTS)
+// Probes removed
+#elif defined(__QNXNTO__)
+#define NEXUS_TRACEPOINTS_QNX 1
+#elif defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define NEXUS_TRACEPOINTS_USDT 1
+#endif
+#endif
+
+#if defined(NEXUS_TRACEPOINTS_USDT)
+
+#include <sys/sdt.h>
+
+#define NEXUS_TRACE2(probe, a, b) DTRACE_PROBE2(nexus, probe, a, b)
+#define NEXUS_TRACE3(probe, a, b, c) DTRACE_PROBE3(nexus, probe, a, b, c)
+
+#elif defined(NEXUS_TRACEPOINTS_QNX)
+
+#include <sys/trace.h>
+
+#include <cstdint>
+
+namespace Nexus {
+namespace rpc {
+namespace tracepoint {
+
+// User event code offsets (_NTO_TRACE_USERFIRST + id); append only, tools decode by number
+enum Probe : int {
+    shm_send = 1,
+    shm_ring_write,
+    shm_ring_read,
+    shm_wakeup,
+    node_enqueue,
+    callback_begin,
+    callback_end,
+    large_write,
+    large_read,
+    udp_send,
+    udp_recv,
+};
+
+template <typename T>
+inline unsigned word(T value) {
+    return static_cast<unsigned>(value);
+}
+
+template <typename T>
+inline unsigned word(T* value) {
+    return static_cast<unsigned>(reinterpret_cast<uintptr_t>(value));
+}
+
+}  // namespace tracepoint
+}  // namespace rpc
+}  // namespace Nexus
+
+#define NEXUS_TRACE2(probe, a, b)                                                                            \
+    trace_logi(_NTO_TRACE_USERFIRST + ::Nexus::rpc::tracepoint::probe, ::Nexus::rpc::tracepoint::word(a), \
+               ::Nexus::rpc::tracepoint::word(b))
+#define NEXUS_TRACE3(probe, a, b, c) (NEXUS_TRACE2(probe, a, b), (void)sizeof(c))
+
+#else
+
+// Arguments stay "used" (unevaluated) so values kept only for a probe raise no warning
+#define NEXUS_TRACE2(probe, a, b) ((void)sizeof(a), (void)sizeof(b))
+#define NEXUS_TRACE3(probe, a, b, c) ((void)sizeof(a), (void)sizeof(b), (void)sizeof(c))
+
+#endif
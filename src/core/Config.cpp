@@ -2,6 +2,10 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <sstream>
+#include <utility>
+
+#include "nexus/transport/SharedMemoryTransportV3.h"
 
 namespace Nexus {
 namespace rpc {
@@ -12,6 +16,34 @@ template <typename T>
 constexpr const T& clamp(const T& val, const T& min, const T& max) {
     return val < min ? min : (val > max ? max : val);
 }
+
+// Parse "0-1;2;3,5" into one CPU mask per set (CPUs >= 64 are ignored)
+std::vector<uint64_t> parseCpuSets(const std::string& spec) {
+    std::vector<uint64_t> sets;
+    std::istringstream sets_stream(spec);
+    std::string set;
+    while (std::getline(sets_stream, set, ';')) {
+        const uint64_t mask = parseCpuSet(set);
+        if (mask != 0) {
+            sets.push_back(mask);
+        }
+    }
+    return sets;
+}
+
+// Parse "none" / "sum" / "crc32c"; unknown names keep @p fallback
+ChecksumType parseChecksumType(const std::string& name, ChecksumType fallback) {
+    if (name == "none") {
+        return ChecksumType::NONE;
+    }
+    if (name == "sum") {
+        return ChecksumType::SUM;
+    }
+    if (name == "crc32c") {
+        return ChecksumType::CRC32C;
+    }
+    return fallback;
+}
 }  // namespace
 
 Config& Config::instance() {
@@ -37,6 +69,50 @@ void Config::loadFromEnv() {
         node.max_queue_size = static_cast<size_t>(std::atoi(val));
     }
 
+    if (const char* val = std::getenv("NEXUS_PER_TOPIC_QUEUE_SIZE")) {
+        node.per_topic_queue_size = static_cast<size_t>(std::max(std::atoi(val), 2));
+    }
+
+    if (const char* val = std::getenv("NEXUS_WORKER_CPUS")) {
+        node.worker_cpu_sets = parseCpuSets(val);
+    }
+
+    if (const char* val = std::getenv("NEXUS_WORKER_PRIORITY")) {
+        node.worker_priority = clamp(std::atoi(val), 0, 99);
+    }
+
+    if (const char* val = std::getenv("NEXUS_NUMA_NODE")) {
+        node.numa_node = clamp(std::atoi(val), -1, 63);
+    }
+
+    if (const char* val = std::getenv("NEXUS_DISCOVERY_CACHE")) {
+        node.discovery_cache = val;
+    }
+
+    if (const char* val = std::getenv("NEXUS_LATENCY_TRACING")) {
+        node.latency_tracing = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_METRICS_INTERVAL_MS")) {
+        node.metrics_interval_ms = static_cast<uint32_t>(std::atoi(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_WATERMARK_HIGH_PERCENT")) {
+        node.watermark_high_percent = static_cast<uint32_t>(clamp(std::atoi(val), 1, 100));
+    }
+
+    if (const char* val = std::getenv("NEXUS_WATERMARK_LOW_PERCENT")) {
+        node.watermark_low_percent = static_cast<uint32_t>(clamp(std::atoi(val), 0, 99));
+    }
+
+    if (const char* val = std::getenv("NEXUS_WATERMARK_POLL_MS")) {
+        node.watermark_poll_ms = static_cast<uint32_t>(clamp(std::atoi(val), 1, 60000));
+    }
+
+    if (const char* val = std::getenv("NEXUS_BLOCK_TIMEOUT_MS")) {
+        node.block_timeout_ms = static_cast<uint32_t>(std::atoi(val));
+    }
+
     // Shared memory configuration
     if (const char* val = std::getenv("NEXUS_SHM_QUEUE_CAPACITY")) {
         shm.queue_capacity = clamp(static_cast<size_t>(std::atoi(val)), size_t(64), size_t(1024));
@@ -50,6 +126,127 @@ void Config::loadFromEnv() {
         shm.node_timeout_ms = static_cast<uint32_t>(std::atoi(val));
     }
 
+    if (const char* val = std::getenv("NEXUS_SHM_RECEIVE_THREADS")) {
+        shm.receive_threads = static_cast<uint32_t>(clamp(std::atoi(val), 1, 8));
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_NON_BLOCKING")) {
+        shm.non_blocking_send = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_SEND_TIMEOUT_MS")) {
+        shm.send_timeout_ms = static_cast<uint32_t>(std::atoi(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_CHECKSUM")) {
+        shm.checksum = parseChecksumType(val, shm.checksum);
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_LANE_SCHEDULING")) {
+        shm.lane_round_robin = std::string(val) == "wrr";
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_LANE_WEIGHTS")) {
+        shm.lane_weights.clear();
+        std::istringstream weights_stream(val);
+        std::string weight;
+        while (std::getline(weights_stream, weight, ',')) {
+            shm.lane_weights.push_back(static_cast<uint32_t>(std::max(std::atoi(weight.c_str()), 1)));
+        }
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_LANE_DROP_MASK")) {
+        shm.lane_drop_mask = static_cast<uint32_t>(std::strtoul(val, nullptr, 0));
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_HUGE_PAGES")) {
+        shm.huge_pages = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_PREFAULT")) {
+        shm.prefault = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_MLOCK")) {
+        shm.lock_memory = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_SHARED_INBOX")) {
+        shm.shared_inbox = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_INBOX_PROMOTE_RATE")) {
+        shm.inbox_promote_rate = static_cast<uint32_t>(std::atoi(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_SHM_TOPIC_BUS_SIZE")) {
+        shm.topic_bus_size = static_cast<size_t>(std::atoll(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_CHECKSUM")) {
+        transport.udp_checksum = parseChecksumType(val, transport.udp_checksum);
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_COMPRESS_THRESHOLD")) {
+        transport.udp_compress_threshold = static_cast<size_t>(std::atoll(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RECEIVE_THREADS")) {
+        transport.udp_receive_threads = static_cast<uint32_t>(clamp(std::atoi(val), 1, 16));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RECEIVE_CPUS")) {
+        transport.udp_receive_cpu_sets = parseCpuSets(val);
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_OFFLOAD")) {
+        transport.udp_segmentation_offload = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_IO_URING")) {
+        transport.udp_io_uring = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_MULTICAST")) {
+        transport.udp_multicast = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_MULTICAST_BASE")) {
+        transport.udp_multicast_base = val;
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_MULTICAST_BUCKETS")) {
+        transport.udp_multicast_buckets = static_cast<uint32_t>(clamp(std::atoi(val), 1, 65536));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_MULTICAST_PORT")) {
+        transport.udp_multicast_port = static_cast<uint16_t>(std::atoi(val));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_MULTICAST_TTL")) {
+        transport.udp_multicast_ttl = static_cast<uint8_t>(clamp(std::atoi(val), 0, 255));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RELIABLE_FRAGMENT")) {
+        transport.udp_reliable_fragment = static_cast<size_t>(clamp(std::atoi(val), 256, 60000));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RELIABLE_WINDOW")) {
+        transport.udp_reliable_window = static_cast<uint32_t>(clamp(std::atoi(val), 1, 8192));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RELIABLE_RETRANSMIT_MS")) {
+        transport.udp_reliable_retransmit_ms = static_cast<uint32_t>(clamp(std::atoi(val), 1, 10000));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RELIABLE_TIMEOUT_MS")) {
+        transport.udp_reliable_timeout_ms = static_cast<uint32_t>(clamp(std::atoi(val), 10, 600000));
+    }
+
+    if (const char* val = std::getenv("NEXUS_UDP_RELIABLE_MAX_MESSAGE")) {
+        transport.udp_reliable_max_message = static_cast<size_t>(std::atoll(val));
+    }
+
     // Large data configuration
     if (const char* val = std::getenv("NEXUS_BUFFER_SIZE")) {
         large_data.buffer_size = static_cast<size_t>(std::atoll(val));
@@ -58,6 +255,42 @@ void Config::loadFromEnv() {
     if (const char* val = std::getenv("NEXUS_MAX_BLOCK_SIZE")) {
         large_data.max_block_size = static_cast<size_t>(std::atoll(val));
     }
+
+    if (const char* val = std::getenv("NEXUS_LARGE_DATA_HUGE_PAGES")) {
+        large_data.huge_pages = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_LARGE_DATA_PREFAULT")) {
+        large_data.prefault = std::atoi(val) != 0;
+    }
+
+    if (const char* val = std::getenv("NEXUS_LARGE_DATA_MLOCK")) {
+        large_data.lock_memory = std::atoi(val) != 0;
+    }
+
+    // Thread placement per role; a spec with an unknown policy leaves the role unchanged
+    const std::pair<const char*, ThreadPlacement*> thread_roles[] = {
+        {"NEXUS_THREADS_SHM_RECEIVE", &threads.shm_receive}, {"NEXUS_THREADS_UDP_RECEIVE", &threads.udp_receive},
+        {"NEXUS_THREADS_WORKER", &threads.worker},           {"NEXUS_THREADS_SYSTEM", &threads.system},
+        {"NEXUS_THREADS_LARGE_DATA", &threads.large_data},   {"NEXUS_THREADS_MAINTENANCE", &threads.maintenance},
+    };
+    for (const auto& role : thread_roles) {
+        if (const char* val = std::getenv(role.first)) {
+            parseThreadPlacement(val, *role.second);
+        }
+    }
+
+    validate();
+}
+
+void Config::validate() {
+    // Data queues below MIN_DATA_QUEUE_SIZE_BYTES cannot take the largest MessagePacket
+    if (shm.message_size == 0) {
+        shm.message_size = SharedMemoryConfig().message_size;
+    }
+    const size_t min_queue_capacity =
+        (SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES + shm.message_size - 1) / shm.message_size;
+    shm.queue_capacity = std::max(shm.queue_capacity, min_queue_capacity);
 }
 
 size_t Config::calculateMemoryFootprint() const {
@@ -1,26 +1,340 @@
 #include "nexus/core/NodeImpl.h"
 
+#include <arpa/inet.h>
 #include <unistd.h>  // For getpid()
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <iostream>
 #include <sstream>
 
 #include "nexus/core/Config.h"
+#include "nexus/core/RpcServer.h"
+#include "nexus/core/TopicBus.h"
 #include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/ReliableUdpChannel.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include "nexus/transport/UdpTransport.h"
 #include "nexus/utils/Logger.h"
+#include "nexus/utils/Numa.h"
+#include "nexus/utils/Tracepoints.h"
 
 namespace Nexus {
 namespace rpc {
 
 // Static member definitions for C++14 compatibility
-constexpr size_t NodeImpl::NUM_PROCESSING_THREADS;
+constexpr size_t NodeImpl::MAX_PROCESSING_THREADS;
+constexpr size_t NodeImpl::MAX_POOLED_MESSAGES;
+constexpr size_t NodeImpl::TRACE_STAGE_COUNTERS;
+constexpr size_t TopicLatency::BUCKETS;
+
+namespace {
+// Retry hint of the calling thread's last publish (see Node::getRetryHintUs())
+thread_local uint32_t t_retry_hint_us = 0;
+constexpr uint32_t MIN_RETRY_HINT_US = 50;
+
+// publishWithTtl(): time-to-live of the message this thread is publishing (0: the topic's, see setTopicTtl())
+thread_local uint64_t t_message_ttl_ns = 0;
+
+// Several full subscribers: wait for the slowest
+void noteRetryHint(uint32_t hint_us) {
+    t_retry_hint_us = std::max(t_retry_hint_us, std::max(hint_us, MIN_RETRY_HINT_US));
+}
+
+// Receive-side timing of the traced frame being handled on this thread (consumed by enqueueMessage())
+struct TraceContext {
+    uint64_t receive_ns = 0;  // Receive loop picked the frame up (0: not traced)
+    int64_t transit_ns = -1;  // Publish -> receive (-1: unknown)
+};
+thread_local TraceContext t_trace;
+
+// Sets t_trace for one handleMessage() call
+class TraceScope {
+public:
+    TraceScope(uint64_t receive_ns, int64_t transit_ns) {
+        t_trace.receive_ns = receive_ns;
+        t_trace.transit_ns = transit_ns;
+    }
+    ~TraceScope() { t_trace = TraceContext(); }
+};
+
+// DATA frame types that carry the sender's send time behind the payload (TraceStamp or DeadlineStamp)
+bool hasSendTime(uint8_t msg_type) {
+    return msg_type == static_cast<uint8_t>(MessageType::TRACED_DATA) ||
+           msg_type == static_cast<uint8_t>(MessageType::DEADLINE_DATA);
+}
+
+// Deadline of a DEADLINE_DATA frame on our clock, 0 if it has none. From our own host the send time compares
+// directly; from another host the time-to-live counts from @p receive_ns, the frame's arrival.
+uint64_t frameDeadlineNs(uint8_t msg_type, const uint8_t* frame, size_t size, const uint8_t* payload_end,
+                         bool same_host, uint64_t receive_ns) {
+    DeadlineStamp stamp;
+    if (msg_type != static_cast<uint8_t>(MessageType::DEADLINE_DATA) ||
+        !DeadlineStamp::read(frame, size, payload_end, stamp) || stamp.ttl_ns == 0) {
+        return 0;
+    }
+    return (same_host ? stamp.send_ns : receive_ns) + stamp.ttl_ns;
+}
+
+// ServiceDescriptor::min_interval_us of SubscribeOptions::max_rate_hz (0: no limit)
+uint32_t rateIntervalUs(double max_rate_hz) {
+    if (!(max_rate_hz > 0)) {
+        return 0;
+    }
+    const double interval_us = 1e6 / max_rate_hz;
+    return interval_us >= UINT32_MAX ? UINT32_MAX : std::max<uint32_t>(1, static_cast<uint32_t>(interval_us + 0.5));
+}
+
+// Transit of a traced shm frame (same host: the clocks compare directly); -1 if the stamp is missing
+int64_t shmTransitNs(const uint8_t* frame, size_t size, const uint8_t* payload_end, uint64_t receive_ns) {
+    const uint64_t send_ns = TraceStamp::read(frame, size, payload_end);
+    return send_ns != 0 && receive_ns >= send_ns ? static_cast<int64_t>(receive_ns - send_ns) : -1;
+}
+
+// Concatenate payload segments into dst
+void gatherPayload(uint8_t* dst, const Node::PayloadSegment* segments, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].size > 0) {
+            std::memcpy(dst, segments[i].data, segments[i].size);
+            dst += segments[i].size;
+        }
+    }
+}
+
+// MessageBuilder::buildInto() for a gathered payload, followed by @p trailer (TRACED_DATA / DEADLINE_DATA)
+void buildGatheredPacket(uint8_t* frame, const std::string& node_id, const std::string& group,
+                         const std::string& topic, const Node::PayloadSegment* segments, size_t count,
+                         size_t payload_len, uint16_t udp_port, ChecksumType checksum, const DataTrailer& trailer) {
+    MessagePacket* packet =
+        MessageBuilder::buildHeader(frame, node_id, group, topic, payload_len, udp_port, MessageType::DATA, checksum);
+    gatherPayload(packet->getPayload(), segments, count);
+    MessageBuilder::stampTrailer(packet, trailer);
+    packet->checksum = packet->calculateChecksum();
+}
+
+// Size of a packet from buildGatheredPacket()
+size_t gatheredPacketSize(const std::string& group, const std::string& topic, size_t payload_len,
+                          const DataTrailer& trailer) {
+    return MessagePacket::packetSize(group.size(), topic.size(), payload_len) + trailer.size();
+}
+
+// SERVICE_REGISTER/UNREGISTER payload:
+// type(1byte) + transport(1byte) + channel_name_len(1byte) + udp_addr_len(2bytes) + channel_name + udp_address
+// [+ topic_id(4bytes) + priority(1byte), shared memory services only; older parsers ignore trailing bytes]
+// [+ multicast_len(1byte) + multicast_address, UDP services in a multicast group only]
+// [+ version(4bytes), the sender's service set version after this update; the optional fields above are
+//    then always present (NO_TOPIC_ID / empty multicast group) so the version sits at a known offset]
+// [+ min_interval_us(4bytes), rate-limited subscribers only; the version is then always present (0: none)]
+// [+ reader_slot(4bytes), topic bus readers only; version and min_interval_us are then always present]
+// A query (empty payload) is answered with the services, then SERVICE_QUERY_DONE as a 1-byte payload
+// (shorter than any descriptor: older nodes ignore it)
+constexpr uint8_t SERVICE_QUERY_DONE = 0xFF;
+
+// A versioned query carries the version of the peer's services we hold (0: none) as a 4-byte payload,
+// too short for older nodes to parse; it is answered with SERVICE_SNAPSHOT frames:
+// version(4bytes) + flags(1byte) + count(2bytes), then count entries of
+// group_len(1byte) + topic_len(1byte) + descriptor_len(2bytes) + group + topic + descriptor (as above)
+constexpr size_t SERVICE_QUERY_VERSIONED_LEN = 4;
+constexpr size_t SNAPSHOT_HEADER_SIZE = 7;
+constexpr size_t SNAPSHOT_ENTRY_HEADER_SIZE = 4;
+constexpr size_t SNAPSHOT_CHUNK_BYTES = 2048;  // Payload per frame: within a control queue's largest frame
+constexpr int SNAPSHOT_SEND_TIMEOUT_MS = 100;   // Control queues do not block: wait for the querier to drain
+constexpr uint8_t SNAPSHOT_FIRST = 0x01;
+constexpr uint8_t SNAPSHOT_LAST = 0x02;
+constexpr uint8_t SNAPSHOT_UNCHANGED = 0x04;  // The querier's version is current: no entries follow
+
+// Discovery cache file: magic(4bytes) + format(4bytes) + service_count(4bytes), then per service
+// node_len(1byte) + group_len(1byte) + topic_len(1byte) + descriptor_len(2bytes) + node + group + topic +
+// descriptor (as above, unversioned), then endpoint_count(4bytes) and per UDP endpoint
+// node_len(1byte) + address_len(1byte) + port(2bytes) + node + address
+constexpr uint32_t DISCOVERY_CACHE_MAGIC = 0x4344584E;  // "NXDC"
+constexpr uint32_t DISCOVERY_CACHE_FORMAT = 1;
+
+void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+    out.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>((value >> shift) & 0xFF));
+    }
+}
+
+uint16_t getU16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0]) | (static_cast<uint16_t>(in[1]) << 8);
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) | (static_cast<uint32_t>(in[2]) << 16) |
+           (static_cast<uint32_t>(in[3]) << 24);
+}
+
+// Written to a per-thread buffer, valid until the next call on the same thread
+const std::vector<uint8_t>& serializeService(const ServiceDescriptor& svc, uint32_t version = 0) {
+    thread_local std::vector<uint8_t> payload;
+    payload.clear();
+    payload.push_back(static_cast<uint8_t>(svc.type));
+    payload.push_back(static_cast<uint8_t>(svc.transport));
+
+    uint8_t channel_len = static_cast<uint8_t>(svc.channel_name.size());
+    payload.push_back(channel_len);
+
+    uint16_t udp_addr_len = static_cast<uint16_t>(svc.udp_address.size());
+    putU16(payload, udp_addr_len);
+
+    if (channel_len > 0) {
+        payload.insert(payload.end(), svc.channel_name.begin(), svc.channel_name.end());
+    }
+    if (udp_addr_len > 0) {
+        payload.insert(payload.end(), svc.udp_address.begin(), svc.udp_address.end());
+    }
+
+    // Fields at fixed positions: everything optional up to the version is written
+    const bool reader = svc.reader_slot != ServiceDescriptor::NO_READER_SLOT;
+    const bool full = version != 0 || svc.min_interval_us != 0 || reader;
+    if (svc.transport == TransportType::SHARED_MEMORY && (svc.topic_id != ServiceDescriptor::NO_TOPIC_ID || full)) {
+        putU32(payload, svc.topic_id);
+        payload.push_back(static_cast<uint8_t>(svc.priority));
+    }
+
+    if (svc.transport == TransportType::UDP && (!svc.multicast_address.empty() || full)) {
+        payload.push_back(static_cast<uint8_t>(svc.multicast_address.size()));
+        payload.insert(payload.end(), svc.multicast_address.begin(), svc.multicast_address.end());
+    }
+
+    if (full) {
+        putU32(payload, version);
+    }
+    if (svc.min_interval_us != 0 || reader) {
+        putU32(payload, svc.min_interval_us);
+    }
+    if (reader) {
+        putU32(payload, svc.reader_slot);
+    }
+    return payload;
+}
+
+// Parse a descriptor from serializeService() into svc (node, group and topic are the caller's);
+// false if malformed. version: the trailing service set version, 0 if absent
+bool parseService(const uint8_t* payload, size_t payload_len, ServiceDescriptor& svc, uint32_t& version) {
+    version = 0;
+    if (payload_len < 5) {
+        return false;
+    }
+    svc.type = static_cast<ServiceType>(payload[0]);
+    svc.transport = static_cast<TransportType>(payload[1]);
+
+    uint8_t channel_len = payload[2];
+    uint16_t udp_addr_len = getU16(payload + 3);
 
+    if (payload_len < static_cast<size_t>(5 + channel_len + udp_addr_len)) {
+        return false;
+    }
+
+    if (channel_len > 0) {
+        svc.channel_name = std::string(reinterpret_cast<const char*>(payload + 5), channel_len);
+    }
+    if (udp_addr_len > 0) {
+        svc.udp_address = std::string(reinterpret_cast<const char*>(payload + 5 + channel_len), udp_addr_len);
+    }
+
+    // Optional trailing topic id (compact shm frames); absent from older nodes
+    const size_t topic_id_offset = 5 + channel_len + udp_addr_len;
+    size_t version_offset = topic_id_offset;
+    if (svc.transport == TransportType::SHARED_MEMORY && payload_len >= topic_id_offset + 4) {
+        const uint8_t* id = payload + topic_id_offset;
+        svc.topic_id = getU32(id);
+        if (payload_len > topic_id_offset + 4 && id[4] <= static_cast<uint8_t>(MessagePriority::BULK)) {
+            svc.priority = static_cast<MessagePriority>(id[4]);
+        }
+        version_offset = topic_id_offset + 5;
+    }
+
+    // Optional trailing multicast group (UDP services); absent from older nodes
+    if (svc.transport == TransportType::UDP && payload_len > topic_id_offset &&
+        payload_len >= topic_id_offset + 1 + payload[topic_id_offset]) {
+        svc.multicast_address =
+            std::string(reinterpret_cast<const char*>(payload + topic_id_offset + 1), payload[topic_id_offset]);
+        version_offset = topic_id_offset + 1 + payload[topic_id_offset];
+    }
+
+    if (payload_len >= version_offset + 4) {
+        version = getU32(payload + version_offset);
+    }
+    if (payload_len >= version_offset + 8) {
+        svc.min_interval_us = getU32(payload + version_offset + 4);
+    }
+    if (payload_len >= version_offset + 12) {
+        svc.reader_slot = getU32(payload + version_offset + 8);
+    }
+    return true;
+}
+
+// Size of a shm DATA frame: compact if the subscriber advertised its topic id; @p trailer follows the payload
+size_t shmFrameSize(uint32_t topic_id, const std::string& group, const std::string& topic, size_t payload_len,
+                    const DataTrailer& trailer) {
+    const size_t size = topic_id != ServiceDescriptor::NO_TOPIC_ID
+                            ? CompactPacket::packetSize(payload_len)
+                            : MessagePacket::packetSize(group.size(), topic.size(), payload_len);
+    return size + trailer.size();
+}
+
+// Header of a shm DATA frame (layout chosen as in shmFrameSize()); returns where the payload goes
+uint8_t* buildShmHeader(uint8_t* frame, uint32_t topic_id, uint32_t topic_hash, const std::string& node_id,
+                        const std::string& group, const std::string& topic, size_t payload_len, uint16_t udp_port,
+                        ChecksumType checksum) {
+    if (topic_id != ServiceDescriptor::NO_TOPIC_ID) {
+        return MessageBuilder::buildCompactHeader(frame, topic_id, topic_hash, payload_len, checksum)->getPayload();
+    }
+    return MessageBuilder::buildHeader(frame, node_id, group, topic, payload_len, udp_port, MessageType::DATA,
+                                       checksum)
+        ->getPayload();
+}
+
+// Fill in the trailer and checksum of a frame from buildShmHeader() once its payload is written
+void sealShmFrame(uint8_t* frame, const DataTrailer& trailer) {
+    if (CompactPacket::isCompact(frame)) {
+        CompactPacket* packet = reinterpret_cast<CompactPacket*>(frame);
+        MessageBuilder::stampTrailer(packet, trailer);
+        packet->checksum = packet->calculateChecksum();
+    } else {
+        MessagePacket* packet = reinterpret_cast<MessagePacket*>(frame);
+        MessageBuilder::stampTrailer(packet, trailer);
+        packet->checksum = packet->calculateChecksum();
+    }
+}
+
+// Parse "IP:port" (0.0.0.0 means this host); false if malformed
+bool parseUdpAddress(const std::string& address, sockaddr_in& addr) {
+    const size_t colon_pos = address.find(':');
+    if (colon_pos == std::string::npos || colon_pos == 0 || colon_pos == address.length() - 1) {
+        return false;
+    }
+    const std::string ip = address.substr(0, colon_pos);
+    const int port = std::atoi(address.c_str() + colon_pos + 1);
+    if (port <= 0 || port > 65535) {
+        return false;
+    }
+    return UdpTransport::resolveAddress(ip == "0.0.0.0" ? "127.0.0.1" : ip, static_cast<uint16_t>(port), addr);
+}
+
+// Key of a UDP peer: address and port
+uint64_t udpPeerKey(const sockaddr_in& addr) {
+    return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+}
+
+int64_t steadyMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
 
 // Port range constants for node discovery
 static constexpr uint16_t PORT_BASE = 47200;
@@ -53,25 +367,93 @@ NodeImpl::NodeImpl(const std::string& node_id, bool use_udp, [[maybe_unused]] ui
     : node_id_(node_id.empty() ? generateNodeId() : node_id),
       use_udp_(use_udp),
       transport_mode_(transport_mode),
-      running_(true) {
+      running_(true),
+      rpc_server_(std::make_unique<RpcServer>(*this)),
+      topic_bus_readers_(std::make_unique<TopicBusReaders>(*this)) {
+    // Worker queues exist before initialize() so messages can be enqueued right away
+    // Dispatch pool: size and scheduling are fixed for the node's lifetime
+    const auto& node_config = Nexus::rpc::Config::instance().node;
+    const size_t num_workers =
+        std::min(std::max(node_config.num_processing_threads, size_t(1)), MAX_PROCESSING_THREADS);
+    run_queues_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        run_queues_.emplace_back(new RunQueue());
+    }
+    threads_config_ = Nexus::rpc::Config::instance().threads;
+    worker_cpu_sets_ = node_config.worker_cpu_sets;
+    if (worker_cpu_sets_.empty() && threads_config_.worker.cpu_mask == 0 && node_config.numa_node >= 0) {
+        // Explicit worker CPU sets win; otherwise workers float within the NUMA node
+        const uint64_t numa_cpus = numaNodeCpus(node_config.numa_node);
+        if (numa_cpus != 0) {
+            worker_cpu_sets_.push_back(numa_cpus);
+        }
+    }
+    worker_priority_ = node_config.worker_priority;
+    discovery_cache_path_ = node_config.discovery_cache;
+
+    // Integrity mode of outgoing DATA packets, per transport (receivers accept every mode)
+    shm_checksum_ = Nexus::rpc::Config::instance().shm.checksum;
+    udp_checksum_ = Nexus::rpc::Config::instance().transport.udp_checksum;
+    if (udp_checksum_ == ChecksumType::NONE) {
+        udp_checksum_ = ChecksumType::CRC32C;  // Receivers only accept unchecked frames from shared memory
+    }
+    latency_tracing_ = node_config.latency_tracing;
+    setWatermarks(node_config.watermark_high_percent, node_config.watermark_low_percent);  // Invalid: 80/50
+
     // UDP transport initialization will be done in a separate init method
 }
 
 NodeImpl::~NodeImpl() {
     running_ = false;
 
+    // The metrics, watermark and topic bus tasks read the transports and large data channels torn down below
+    MaintenanceScheduler::instance().cancel(metrics_task_);
+    MaintenanceScheduler::instance().cancel(topic_bus_task_);
+    {
+        std::lock_guard<std::mutex> lock(watermark_task_mutex_);
+        MaintenanceScheduler::instance().cancel(watermark_task_);
+    }
+    metrics_segment_.reset();
+
     // 🔧 CRITICAL: 先 unregister，广播 NODE_LEAVE
     // 这样其他节点可以在本节点完全退出前收到通知
     // 必须在停止线程之前，因为 broadcastNodeEvent 需要 shm_transport_v3_
     unregisterNode();
 
-    // Stop UDP heartbeat thread
+    // Stop the UDP heartbeat task
     stopUdpHeartbeat();
 
-    // Stop cleanup thread
-    cleanup_running_ = false;
-    if (cleanup_thread_.joinable()) {
-        cleanup_thread_.join();
+    // Stop large data reader threads
+    std::vector<std::string> large_reader_channels;
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        for (const auto& entry : large_readers_) {
+            large_reader_channels.push_back(entry.first);
+        }
+    }
+    for (const auto& channel_name : large_reader_channels) {
+        unsubscribeLargeData(channel_name);
+    }
+    // Bridges: the node's services are already unregistered
+    std::map<std::string, std::shared_ptr<LargeDataReader>> large_bridges;
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        large_bridges.swap(large_bridges_);
+    }
+    for (auto& entry : large_bridges) {
+        stopLargeDataReader(std::move(entry.second));
+    }
+    topic_bus_readers_->close();  // Their services left with the node
+
+    // Stop the call workers and the call timeout thread; calls still outstanding complete now
+    rpc_server_->stop();
+
+    // Stop the cleanup tasks; the discovery cache keeps the last known state for the next start
+    auto& scheduler = MaintenanceScheduler::instance();
+    scheduler.cancel(cleanup_task_);
+    scheduler.cancel(discovery_cache_task_);
+    if (discovery_cache_task_ != MaintenanceScheduler::NO_TASK) {
+        saveDiscoveryCache();
     }
 
     // Stop system message thread
@@ -82,9 +464,7 @@ NodeImpl::~NodeImpl() {
     }
 
     // Wake up all processing threads
-    for (auto& cv : message_queue_cvs_) {
-        cv.notify_all();
-    }
+    work_ready_.notifyAll();
 
     // Wait for processing threads
     for (auto& thread : processing_threads_) {
@@ -93,10 +473,21 @@ NodeImpl::~NodeImpl() {
         }
     }
 
+    // Return payloads still queued (overflow buffers are heap-owned)
+    for (auto& lane : lanes_) {
+        if (lane) {
+            discardLane(*lane);
+        }
+    }
+
     // Shutdown UDP transport (only if enabled)
+    if (multicast_transport_) {
+        multicast_transport_->shutdown();
+    }
     if (use_udp_ && udp_transport_) {
         udp_transport_->shutdown();
     }
+    reliable_udp_.reset();  // After the receive thread: no more packets are handed to it
 
     // shm_transport_v3_ 会在成员变量析构时自动清理
 }
@@ -106,18 +497,19 @@ void NodeImpl::initialize(uint16_t udp_port) {
     // Register this node in global registry
     registerNode();
 
-    // Verify config matches compile-time constants
     auto& config = Nexus::rpc::Config::instance();
-    if (config.node.num_processing_threads != NUM_PROCESSING_THREADS) {
-        NEXUS_WARN("IMPL") << "Config thread count (" << config.node.num_processing_threads
-                           << ") doesn't match compile-time NUM_PROCESSING_THREADS (" << NUM_PROCESSING_THREADS << ")";
-    }
 
-    // Start message processing threads
-    for (size_t i = 0; i < NUM_PROCESSING_THREADS; ++i) {
+    // Start message processing threads (one per run queue)
+    for (size_t i = 0; i < run_queues_.size(); ++i) {
         processing_threads_.emplace_back(&NodeImpl::messageProcessingThread, this, i);
     }
 
+    // The maintenance thread (heartbeats, cleanup) is shared: only a configured placement is applied
+    const ThreadPlacement& maintenance = threads_config_.maintenance;
+    if (maintenance.cpu_mask != 0 || maintenance.policy != SchedPolicy::INHERIT) {
+        MaintenanceScheduler::instance().setThreadPlacement(maintenance);
+    }
+
     // Start system message processing thread
     system_running_.store(true);
     system_thread_ = std::thread(&NodeImpl::systemMessageThread, this);
@@ -125,7 +517,31 @@ void NodeImpl::initialize(uint16_t udp_port) {
     // Initialize lock-free shared memory transport
     if (transport_mode_ == TransportMode::AUTO || transport_mode_ == TransportMode::LOCK_FREE_SHM) {
         shm_transport_v3_ = std::make_unique<SharedMemoryTransportV3>();
-        if (!shm_transport_v3_->initialize(node_id_)) {
+        SharedMemoryTransportV3::Config shm_config;
+        shm_config.queue_capacity = config.shm.queue_capacity * config.shm.message_size;
+        shm_config.receive_threads = config.shm.receive_threads;
+        shm_config.receive_placement = threads_config_.shm_receive;
+        shm_config.connector_placement = threads_config_.maintenance;
+        shm_config.non_blocking = config.shm.non_blocking_send;
+        shm_config.send_timeout_ms = config.shm.send_timeout_ms;
+        shm_config.huge_pages = config.shm.huge_pages;
+        shm_config.prefault = config.shm.prefault;
+        shm_config.lock_memory = config.shm.lock_memory;
+        shm_config.shared_inbox = config.shm.shared_inbox;
+        shm_config.inbox_promote_rate = config.shm.inbox_promote_rate;
+        shm_config.numa_node = config.node.numa_node;
+        shm_config.lane_scheduling = config.shm.lane_round_robin
+                                         ? SharedMemoryTransportV3::LaneScheduling::WEIGHTED_ROUND_ROBIN
+                                         : SharedMemoryTransportV3::LaneScheduling::STRICT_PRIORITY;
+        for (uint32_t lane = 0; lane < SharedMemoryTransportV3::DATA_LANES; ++lane) {
+            if (lane < config.shm.lane_weights.size()) {
+                shm_config.lane_weights[lane] = config.shm.lane_weights[lane];
+            }
+            shm_config.lane_overflow[lane] = (config.shm.lane_drop_mask & (1u << lane))
+                                                 ? SharedMemoryTransportV3::LaneOverflow::DROP
+                                                 : SharedMemoryTransportV3::LaneOverflow::BLOCK;
+        }
+        if (!shm_transport_v3_->initialize(node_id_, shm_config)) {
             NEXUS_LOG_ERROR("IMPL", "Lock-free shared memory initialization failed");
             shm_transport_v3_.reset();
         } else {
@@ -146,17 +562,20 @@ void NodeImpl::initialize(uint16_t udp_port) {
             // Subscriptions are synchronized via SUBSCRIBE broadcast messages
             // This eliminates ~70% of startup messages and speeds up initialization
 
+            // A node that was not connectable when a route was built becomes reachable: rebuild routes
+            shm_transport_v3_->setConnectionCallback([](const std::string&, SharedMemoryTransportV3::NodeHandle) {
+                Nexus::rpc::GlobalRegistry::instance().invalidateRoutes();
+            });
+
             // 🔧 CRITICAL: Proactively connect to all existing nodes in registry
             // This solves the race condition where concurrent node startups miss each other
             // because registry writes happen out of order with NODE_JOIN broadcasts
+            // (on the connector thread: startup does not wait for slow or half-initialized peers)
             auto existing_nodes = shm_transport_v3_->getLocalNodes();
             for (const auto& node_id : existing_nodes) {
                 if (node_id != node_id_) {
                     NEXUS_DEBUG("IMPL") << "Proactively connecting to existing node: " << node_id;
-                    // This will trigger lazy connection and queue creation
-                    // Send empty message just to establish connection
-                    std::vector<uint8_t> dummy(1, 0);
-                    shm_transport_v3_->send(node_id, dummy.data(), 0);
+                    shm_transport_v3_->connectAsync(node_id);
                 }
             }
 
@@ -168,10 +587,13 @@ void NodeImpl::initialize(uint16_t udp_port) {
         }
     }
 
+    // Warm restart: route to the services known before the restart until discovery catches up
+    loadDiscoveryCache();
+
     // Initialize UDP transport if enabled
     if (use_udp_) {
         // Create callback handler (shared between both sockets)
-        auto receiveCallback = [this](const uint8_t* data, size_t size, const std::string& from_addr) {
+        auto receiveCallback = [this](const uint8_t* data, size_t size, const sockaddr_in& from) {
             // Parse and handle received message
             if (size < sizeof(MessagePacket)) {
                 return;
@@ -182,10 +604,10 @@ void NodeImpl::initialize(uint16_t udp_port) {
                 return;
             }
 
-            // Extract message components
-            std::string source_node(packet->node_id);
-            std::string group(packet->getGroup(), packet->group_len);
-            std::string topic(packet->getTopic(), packet->topic_len);
+            // Extract message components (views into the datagram; copied only for control messages)
+            StringView source_node = StringView::fromField(packet->node_id, sizeof(packet->node_id));
+            StringView group(packet->getGroup(), packet->group_len);
+            StringView topic(packet->getTopic(), packet->topic_len);
             uint16_t sender_port = packet->udp_port;
             MessageType msg_type = static_cast<MessageType>(packet->msg_type);
 
@@ -194,12 +616,36 @@ void NodeImpl::initialize(uint16_t udp_port) {
                 return;
             }
 
+            // Every packet from a node refreshes its liveness; heartbeats only cover the idle ones
+            if (msg_type != MessageType::HEARTBEAT && msg_type != MessageType::NODE_LEAVE) {
+                noteUdpTraffic(source_node, from, sender_port);
+            }
+
             // Handle based on message type
             switch (msg_type) {
                 case MessageType::DATA:
                     handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len);
                     break;
 
+                case MessageType::TRACED_DATA:
+                case MessageType::DEADLINE_DATA: {
+                    const uint8_t* payload_end = packet->getPayload() + packet->payload_len;
+                    const uint64_t now = TraceStamp::now();
+                    // From another host: the time-to-live counts from arrival
+                    const uint64_t deadline_ns =
+                        frameDeadlineNs(packet->msg_type, data, size, payload_end, false, now);
+                    if (latency_tracing_) {
+                        const uint64_t send_ns = TraceStamp::read(data, size, payload_end);
+                        TraceScope trace(now, send_ns != 0 ? udpTransitNs(source_node, send_ns, now) : -1);
+                        handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len,
+                                      deadline_ns);
+                    } else {
+                        handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len,
+                                      deadline_ns);
+                    }
+                    break;
+                }
+
                 case MessageType::SERVICE_REGISTER:
                     // Enqueue to system message thread (avoid blocking receive thread)
                     enqueueSystemMessage(SystemMessageType::SERVICE_REGISTER, source_node, group, topic,
@@ -223,17 +669,39 @@ void NodeImpl::initialize(uint16_t udp_port) {
                     break;
 
                 case MessageType::HEARTBEAT:
-                    handleUdpHeartbeat(source_node, from_addr, sender_port);
+                    handleUdpHeartbeat(source_node.str(), UdpTransport::formatAddress(from), sender_port);
+                    break;
+
+                case MessageType::REQUEST: {
+                    // Reply to the caller's socket, not to the datagram's source port
+                    if (sender_port != 0) {
+                        sockaddr_in caller = UdpTransport::replyAddress(from, sender_port);
+                        rpc_server_->handleCallRequest(source_node, group, topic, packet->getPayload(),
+                                                       packet->payload_len, &caller);
+                    }
+                    break;
+                }
+
+                case MessageType::REPLY:
+                    rpc_server_->handleCallReply(packet->getPayload(), packet->payload_len);
+                    break;
+
+                case MessageType::RELIABLE_DATA:
+                case MessageType::RELIABLE_ACK:
+                    if (reliable_udp_) {
+                        reliable_udp_->handlePacket(*packet, from);
+                    }
                     break;
 
                 case MessageType::QUERY_SUBSCRIPTIONS:
                     // Reply with all our services (UDP service discovery)
-                    handleQuerySubscriptions(source_node, sender_port, from_addr);
+                    handleQuerySubscriptions(source_node.str(), sender_port, UdpTransport::formatAddress(from));
                     break;
 
                 case MessageType::SUBSCRIBE:
                 case MessageType::UNSUBSCRIBE:
                 case MessageType::SUBSCRIPTION_REPLY:
+                case MessageType::SERVICE_SNAPSHOT:  // Shared memory only
                     // These message types are not used in current implementation
                     // Reserved for future subscription management features
                     NEXUS_DEBUG("IMPL") << "Ignoring unused message type: " << static_cast<int>(msg_type);
@@ -244,6 +712,13 @@ void NodeImpl::initialize(uint16_t udp_port) {
         // Initialize main UDP socket (for all messages)
         // Use a fixed base port range (47200-47999) for easier discovery (800 ports)
         udp_transport_ = std::make_unique<UdpTransport>();
+        udp_transport_->setCompressionThreshold(Nexus::rpc::Config::instance().transport.udp_compress_threshold);
+        // Several receive threads: the callback below runs concurrently for different senders
+        udp_transport_->setReceiveThreads(config.transport.udp_receive_threads,
+                                          config.transport.udp_receive_cpu_sets);
+        udp_transport_->setReceivePlacement(threads_config_.udp_receive);
+        udp_transport_->setSegmentationOffload(config.transport.udp_segmentation_offload);
+        udp_transport_->setIoUring(config.transport.udp_io_uring);
 
         // Try ports in our scan range first
         uint16_t target_port = udp_port;
@@ -290,19 +765,70 @@ void NodeImpl::initialize(uint16_t udp_port) {
             // Failed to initialize
             return;
         }
+        // Reliable topics: fragments and acknowledgements share the main socket
+        ReliableUdpChannel::Options reliable_options;
+        reliable_options.fragment_size = config.transport.udp_reliable_fragment;
+        reliable_options.window = config.transport.udp_reliable_window;
+        reliable_options.retransmit_ms = config.transport.udp_reliable_retransmit_ms;
+        reliable_options.timeout_ms = config.transport.udp_reliable_timeout_ms;
+        reliable_options.max_message_size = config.transport.udp_reliable_max_message;
+        reliable_options.checksum = udp_checksum_;
+        reliable_udp_.reset(new ReliableUdpChannel(*udp_transport_, node_id_, reliable_options));
+        reliable_udp_->setMessageCallback(
+            [this](StringView source_node, StringView group, StringView topic, const uint8_t* payload, size_t size) {
+                handleMessage(source_node, group, topic, payload, size);
+            });
         udp_transport_->setReceiveCallback(receiveCallback);
 
+        // Multicast socket: every node binds the same port and receives only the groups its topics joined
+        if (config.transport.udp_multicast) {
+            udp_transport_->setMulticastTtl(config.transport.udp_multicast_ttl);
+            multicast_transport_ = std::make_unique<UdpTransport>();
+            if (multicast_transport_->initialize(config.transport.udp_multicast_port, true)) {
+                multicast_transport_->setReceiveCallback(
+                    [this](const uint8_t* data, size_t size, const sockaddr_in&) { handleMulticastPacket(data, size); });
+            } else {
+                NEXUS_WARN("IMPL") << "UDP multicast port " << config.transport.udp_multicast_port
+                                   << " unavailable, UDP subscriptions stay unicast";
+                multicast_transport_.reset();
+            }
+        }
+
         // After UDP transport is ready, query existing nodes for their subscriptions
         // Use port scanning to discover nodes on localhost
         queryExistingSubscriptions();
 
-        // Start UDP heartbeat thread
+        // Start UDP heartbeats
         startUdpHeartbeat();
     }
 
-    // Start background cleanup thread (runs every 5 minutes)
-    cleanup_running_ = true;
-    cleanup_thread_ = std::thread(&NodeImpl::cleanupThreadFunc, this);
+    // Background cleanup (every CLEANUP_INTERVAL_SECONDS) and the discovery cache flush
+    auto& scheduler = MaintenanceScheduler::instance();
+    cleanup_task_ = scheduler.schedule(std::chrono::seconds(CLEANUP_INTERVAL_SECONDS), [this] { runCleanup(); });
+    if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+        // Topic buses come and go with the services of other processes (see setTopicBus())
+        topic_bus_task_ = scheduler.schedule(std::chrono::milliseconds(TopicBusReaders::SYNC_MS),
+                                             [this] { topic_bus_readers_->sync(false); });
+    }
+    if (!discovery_cache_path_.empty()) {
+        discovery_cache_task_ = scheduler.schedule(std::chrono::milliseconds(DISCOVERY_CACHE_FLUSH_MS), [this] {
+            expireCachedServices();
+            saveDiscoveryCache();
+        });
+    }
+
+    // Shared memory metrics segment for external monitors (nexus_top)
+    const uint32_t metrics_interval_ms = Nexus::rpc::Config::instance().node.metrics_interval_ms;
+    if (metrics_interval_ms > 0) {
+        metrics_segment_ = std::make_unique<MetricsSegment>();
+        if (metrics_segment_->create(node_id_, metrics_interval_ms)) {
+            publishMetrics();
+            metrics_task_ =
+                scheduler.schedule(std::chrono::milliseconds(metrics_interval_ms), [this] { publishMetrics(); });
+        } else {
+            metrics_segment_.reset();
+        }
+    }
 }
 
 Node::Error NodeImpl::publish(const Property& msg_group, const Property& topic, const Property& payload) {
@@ -314,21 +840,31 @@ Node::Error NodeImpl::publish(const Property& msg_group, const Property& topic,
         return Error::NOT_INITIALIZED;
     }
 
-    // Build message packet
-    auto packet = MessageBuilder::build(node_id_, msg_group, topic, payload, getUdpPort(), MessageType::DATA);
+    // Same path as publishing by handle (one topic table lookup)
+    return publish(Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic), payload);
+}
 
-    // Deliver to in-process subscribers
-    deliverInProcess(msg_group, topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+TopicHandle NodeImpl::resolveTopic(const Property& msg_group, const Property& topic) {
+    if (msg_group.empty() || topic.empty()) {
+        return TopicHandle();
+    }
+    return Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic);
+}
 
-    // Deliver to inter-process subscribers (via shared memory or UDP)
-    deliverInterProcess(packet, msg_group, topic);
+Node::Error NodeImpl::publish(const TopicHandle& topic, const Property& payload) {
+    if (!topic.valid()) {
+        return Error::INVALID_ARG;
+    }
 
-    return Error::NO_ERROR;
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    return publishPayload(topic, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
 }
 
-Node::Error NodeImpl::subscribe(const Property& msg_group, const std::vector<Property>& topics,
-                                const Callback& callback) {
-    if (msg_group.empty() || topics.empty() || !callback) {
+Node::Error NodeImpl::publish(const Property& msg_group, const Property& topic, const uint8_t* data, size_t size) {
+    if (msg_group.empty() || topic.empty() || (!data && size > 0)) {
         return Error::INVALID_ARG;
     }
 
@@ -336,61 +872,114 @@ Node::Error NodeImpl::subscribe(const Property& msg_group, const std::vector<Pro
         return Error::NOT_INITIALIZED;
     }
 
-    std::unique_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+    return publishPayload(Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic), data, size);
+}
 
-    // Get or create subscription info for this group
-    auto& sub_info = subscriptions_[msg_group];
+Node::Error NodeImpl::publishv(const Property& msg_group, const Property& topic, const PayloadSegment* segments,
+                               size_t count) {
+    if (msg_group.empty() || topic.empty() || (!segments && count > 0)) {
+        return Error::INVALID_ARG;
+    }
 
-    // Add topics
-    for (const auto& topic : topics) {
-        if (!topic.empty()) {
-            sub_info.topics.insert(topic);
+    size_t payload_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].data && segments[i].size > 0) {
+            return Error::INVALID_ARG;
         }
+        payload_size += segments[i].size;
     }
 
-    // Update callback
-    sub_info.callback = callback;
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
 
-    // Auto-register services (service discovery)
-    for (const auto& topic : topics) {
-        if (!topic.empty()) {
-            // Register for shared memory transport (if available)
-            if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
-                ServiceDescriptor svc;
-                svc.node_id = node_id_;
-                svc.group = msg_group;
-                svc.topic = topic;
-                svc.type = ServiceType::NORMAL_MESSAGE;
-                svc.channel_name = "";  // Not a large data channel
-                svc.transport = TransportType::SHARED_MEMORY;
-                svc.udp_address = "";
+    const TopicHandle handle = Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic);
+    if (count == 1) {
+        return publishPayload(handle, static_cast<const uint8_t*>(segments[0].data), payload_size);
+    }
 
-                registerService(svc);
-            }
+    const InterProcessRoute route = interProcessRoute(handle);
+    const DataTrailer trailer = publishTrailer(*route);
+    t_retry_hint_us = 0;
+    countPublished(handle, payload_size);
+
+    // In-process queues take a contiguous copy; only build it if someone can receive it
+    bool queued = true;
+    if (hasInProcessSubscribers(handle)) {
+        thread_local std::vector<uint8_t> scratch;
+        scratch.resize(payload_size);
+        gatherPayload(scratch.data(), segments, count);
+        queued = deliverInProcess(handle, scratch.data(), payload_size, trailer.deadlineNs());
+    }
 
-            // Register for UDP transport (if enabled)
-            if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
-                ServiceDescriptor svc;
-                svc.node_id = node_id_;
-                svc.group = msg_group;
-                svc.topic = topic;
-                svc.type = ServiceType::NORMAL_MESSAGE;
-                svc.channel_name = "";
-                svc.transport = TransportType::UDP;
-                svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
+    Error result = deliverInterProcess(*route, msg_group, topic, segments, count, payload_size, trailer);
+    return queued ? result : Error::QUEUE_FULL;
+}
 
-                registerService(svc);
-            }
+Node::Error NodeImpl::publishPayload(const TopicHandle& topic, const uint8_t* payload, size_t payload_len) {
+    t_retry_hint_us = 0;
+    countPublished(topic, payload_len);
+    const InterProcessRoute route = interProcessRoute(topic);
+    const DataTrailer trailer = publishTrailer(*route);
+
+    // Deliver to in-process subscribers (by topic id, no string lookups)
+    bool queued = deliverInProcess(topic, payload, payload_len, trailer.deadlineNs());
+
+    // Deliver to inter-process subscribers (via shared memory or UDP, cached route)
+    Error result = deliverInterProcess(*route, topic.group(), topic.topic(), payload, payload_len, trailer);
+    return queued ? result : Error::QUEUE_FULL;
+}
+
+Node::Error NodeImpl::publishInPlace(const Property& msg_group, const Property& topic, size_t payload_size,
+                                     const PayloadWriter& writer) {
+    if (msg_group.empty() || topic.empty() || !writer) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    const TopicHandle handle = Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic);
+    const InterProcessRoute route = interProcessRoute(handle);
+    const InterProcessTargets& targets = *route;
+    const DataTrailer trailer = publishTrailer(targets);
+    t_retry_hint_us = 0;
+    countPublished(handle, payload_size);
+
+    // Zero-copy path: exactly one consumer, and it reads from shared memory.
+    // The payload is written straight into the subscriber's receive queue.
+    if (targets.shm_subscribers.size() == 1 && targets.udp_subscribers.empty() && targets.bus_subscribers.empty() &&
+        !hasInProcessSubscribers(handle)) {
+        const uint16_t udp_port = getUdpPort();
+        const InterProcessTargets::ShmTarget& subscriber = targets.shm_subscribers.front();
+        if (subscriber.rate_limit && !subscriber.rate_limit->admit(TraceStamp::now())) {
+            return Error::NO_ERROR;  // Decimated: the payload is not even written
         }
+        size_t packet_size = shmFrameSize(subscriber.topic_id, msg_group, topic, payload_size, trailer);
+        auto fill = [&](uint8_t* frame, size_t) {
+            writer(buildShmHeader(frame, subscriber.topic_id, targets.topic_hash, node_id_, msg_group, topic,
+                                  payload_size, udp_port, shm_checksum_),
+                   payload_size);
+            sealShmFrame(frame, trailer);
+        };
+        bool sent = shm_transport_v3_->sendInPlace(subscriber.handle, packet_size, fill, subscriber.lane);
+        return sent ? Error::NO_ERROR : shmSendFailed(subscriber.handle, packet_size, subscriber.lane);
     }
 
-    // No need to broadcast SUBSCRIBE - service registration handles discovery
+    // Fan-out: the payload is needed by several consumers, materialize it once
+    thread_local std::vector<uint8_t> scratch;
+    scratch.resize(payload_size);
+    writer(scratch.data(), payload_size);
 
-    return Error::NO_ERROR;
+    bool queued = deliverInProcess(handle, scratch.data(), payload_size, trailer.deadlineNs());
+    Error result = deliverInterProcess(targets, msg_group, topic, scratch.data(), payload_size, trailer);
+    return queued ? result : Error::QUEUE_FULL;
 }
 
-Node::Error NodeImpl::unsubscribe(const Property& msg_group, const std::vector<Property>& topics) {
-    if (msg_group.empty()) {
+Node::Error NodeImpl::publishBatch(const Property& msg_group, const Property& topic,
+                                   const std::vector<Property>& payloads) {
+    if (msg_group.empty() || topic.empty()) {
         return Error::INVALID_ARG;
     }
 
@@ -398,42 +987,437 @@ Node::Error NodeImpl::unsubscribe(const Property& msg_group, const std::vector<P
         return Error::NOT_INITIALIZED;
     }
 
-    // Collect topics to broadcast unsubscribe (avoid broadcasting inside lock)
-    std::vector<std::string> topics_to_broadcast;
+    if (payloads.empty()) {
+        return Error::NO_ERROR;
+    }
 
-    {
-        std::unique_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+    const TopicHandle handle = Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, topic);
+    t_retry_hint_us = 0;
+    Error result = Error::NO_ERROR;
 
-        auto it = subscriptions_.find(msg_group);
-        if (it == subscriptions_.end()) {
-            return Error::NOT_FOUND;
+    // Resolve inter-process subscribers once for the whole burst (one publish time for its deadlines)
+    const InterProcessRoute route = interProcessRoute(handle);
+    const InterProcessTargets& targets = *route;
+    const DataTrailer trailer = publishTrailer(targets);
+
+    // Deliver to in-process subscribers
+    for (const auto& payload : payloads) {
+        countPublished(handle, payload.size());
+        if (!deliverInProcess(handle, reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                              trailer.deadlineNs())) {
+            result = Error::QUEUE_FULL;
         }
+    }
 
-        if (topics.empty()) {
-            // Remove entire group - collect all topics
-            topics_to_broadcast.assign(it->second.topics.begin(), it->second.topics.end());
-            subscriptions_.erase(it);
-        } else {
-            // Remove specific topics
-            for (const auto& topic : topics) {
-                auto topic_it = it->second.topics.find(topic);
-                if (topic_it != it->second.topics.end()) {
-                    topics_to_broadcast.push_back(topic);
-                    it->second.topics.erase(topic_it);
-                }
-            }
+    if (targets.empty()) {
+        return result;
+    }
 
-            // Remove group if no topics left
-            if (it->second.topics.empty()) {
-                subscriptions_.erase(it);
+    // Rate-limited subscribers take single messages, admitted one by one; bus readers one block per message
+    if (targets.rate_limited || !targets.bus_subscribers.empty()) {
+        for (const auto& payload : payloads) {
+            const Error sent = deliverInterProcess(targets, msg_group, topic,
+                                                   reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                                                   trailer);
+            if (sent != Error::NO_ERROR) {
+                result = sent;
             }
         }
+        return result;
     }
 
-    // Auto-unregister services for collected topics (outside of lock)
-    for (const auto& topic : topics_to_broadcast) {
-        // Auto-unregister services (both SHM and UDP)
-        if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+    const uint16_t udp_port = getUdpPort();
+
+    // 1. Shared memory: one batch (one queue update, one wakeup) per subscriber
+    if (!targets.shm_subscribers.empty() && shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+        std::vector<size_t> sizes(payloads.size());
+        for (const auto& subscriber : targets.shm_subscribers) {
+            // Frame layout depends on the subscriber (compact or full header)
+            for (size_t i = 0; i < payloads.size(); ++i) {
+                sizes[i] = shmFrameSize(subscriber.topic_id, msg_group, topic, payloads[i].size(), trailer);
+            }
+            size_t sent = shm_transport_v3_->sendBatchInPlace(
+                subscriber.handle, sizes.data(), sizes.size(), [&](size_t index, uint8_t* frame, size_t) {
+                    const auto& payload = payloads[index];
+                    uint8_t* dst = buildShmHeader(frame, subscriber.topic_id, targets.topic_hash, node_id_, msg_group,
+                                                  topic, payload.size(), udp_port, shm_checksum_);
+                    if (!payload.empty()) {
+                        std::memcpy(dst, payload.data(), payload.size());
+                    }
+                    sealShmFrame(frame, trailer);
+                },
+                subscriber.lane);
+            if (sent < sizes.size() &&
+                shmSendFailed(subscriber.handle, sizes[sent], subscriber.lane) == Error::QUEUE_FULL) {
+                result = Error::QUEUE_FULL;
+            }
+        }
+    }
+
+    // 2. UDP: one datagram per payload, fanned out to all subscribers in one sendmmsg
+    if (!targets.udp_subscribers.empty() && targets.reliable) {
+        for (const auto& payload : payloads) {
+            const Error sent = sendReliable(targets.udp_subscribers, msg_group, topic,
+                                            reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+            if (sent != Error::NO_ERROR) {
+                result = sent;
+            }
+        }
+        markUdpPeersSent(targets);
+    } else if (!targets.udp_subscribers.empty()) {
+        for (const auto& payload : payloads) {
+            const PayloadSegment segment = {payload.data(), payload.size()};
+            const size_t packet_size = gatheredPacketSize(msg_group, topic, payload.size(), trailer);
+            uint8_t* packet = MessageBuilder::threadBuffer(packet_size);
+            buildGatheredPacket(packet, node_id_, msg_group, topic, &segment, 1, payload.size(), udp_port,
+                                udp_checksum_, trailer);
+            udp_transport_->sendBatch(packet, packet_size, targets.udp_subscribers);
+        }
+        markUdpPeersSent(targets);
+    }
+
+    return result;
+}
+
+Node::Error NodeImpl::setTopicPriority(const Property& msg_group, const Property& topic, MessagePriority priority) {
+    if (msg_group.empty() || topic.empty() || priority > MessagePriority::BULK) {
+        return Error::INVALID_ARG;
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const TopicHandle handle = registry.resolveTopic(msg_group, topic);
+    {
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        if (handle.id() >= publish_priorities_.size()) {
+            publish_priorities_.resize(handle.id() + 1, MessagePriority::NORMAL);
+        }
+        publish_priorities_[handle.id()] = priority;
+    }
+    // Cached routes carry the lane: rebuild them on next publish
+    registry.invalidateRoutes();
+    return Error::NO_ERROR;
+}
+
+Node::Error NodeImpl::setTopicReliable(const Property& msg_group, const Property& topic, bool reliable) {
+    if (msg_group.empty() || topic.empty()) {
+        return Error::INVALID_ARG;
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const TopicHandle handle = registry.resolveTopic(msg_group, topic);
+    {
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        if (handle.id() >= reliable_topics_.size()) {
+            reliable_topics_.resize(handle.id() + 1, false);
+        }
+        reliable_topics_[handle.id()] = reliable;
+    }
+    // Reliable routes address subscribers point-to-point: rebuild them on next publish
+    registry.invalidateRoutes();
+    return Error::NO_ERROR;
+}
+
+Node::Error NodeImpl::setTopicBus(const Property& msg_group, const Property& topic, bool enable) {
+    if (msg_group.empty() || topic.empty() || isTopicPattern(topic)) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!running_ || !shm_transport_v3_ || !shm_transport_v3_->isInitialized()) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const TopicHandle handle = registry.resolveTopic(msg_group, topic);
+    ServiceDescriptor svc;
+    svc.node_id = node_id_;
+    svc.group = msg_group;
+    svc.topic = topic;
+    svc.type = ServiceType::TOPIC_BUS;
+    svc.transport = TransportType::SHARED_MEMORY;
+    {
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        if (handle.id() >= topic_buses_.size()) {
+            topic_buses_.resize(handle.id() + 1);
+        }
+        std::shared_ptr<TopicBus>& bus = topic_buses_[handle.id()];
+        if (enable == static_cast<bool>(bus)) {
+            return Error::NO_ERROR;
+        }
+        if (enable) {
+            bus = TopicBus::create(node_id_, msg_group, topic);
+            if (!bus) {
+                return Error::UNEXPECTED_ERROR;
+            }
+        }
+        svc.channel_name = bus->channelName();
+        if (!enable) {
+            bus.reset();  // Routes still holding it finish their writes
+        }
+    }
+    // Subscribers in other processes attach when they see the service; routes then skip their queues
+    if (enable) {
+        registerService(svc);
+    } else {
+        unregisterService(svc);
+    }
+    registry.invalidateRoutes();
+    return Error::NO_ERROR;
+}
+
+Node::Error NodeImpl::setTopicTtl(const Property& msg_group, const Property& topic, uint32_t ttl_us) {
+    if (msg_group.empty() || topic.empty()) {
+        return Error::INVALID_ARG;
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const TopicHandle handle = registry.resolveTopic(msg_group, topic);
+    {
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        if (handle.id() >= topic_ttls_.size()) {
+            topic_ttls_.resize(handle.id() + 1, 0);
+        }
+        topic_ttls_[handle.id()] = static_cast<uint64_t>(ttl_us) * 1000;
+    }
+    // Cached routes carry the time-to-live: rebuild them on next publish
+    registry.invalidateRoutes();
+    return Error::NO_ERROR;
+}
+
+Node::Error NodeImpl::publishWithTtl(const Property& msg_group, const Property& topic, const uint8_t* data,
+                                     size_t size, uint32_t ttl_us) {
+    // Picked up by publishTrailer() for this one publish
+    t_message_ttl_ns = static_cast<uint64_t>(ttl_us) * 1000;
+    const Error result = publish(msg_group, topic, data, size);
+    t_message_ttl_ns = 0;
+    return result;
+}
+
+DataTrailer NodeImpl::publishTrailer(const InterProcessTargets& targets) const {
+    DataTrailer trailer;
+    trailer.traced = latency_tracing_;
+    trailer.ttl_ns = t_message_ttl_ns != 0 ? t_message_ttl_ns : targets.ttl_ns;
+    if (trailer.ttl_ns != 0) {
+        trailer.send_ns = TraceStamp::now();
+    }
+    return trailer;
+}
+
+Node::Error NodeImpl::subscribe(const Property& msg_group, const std::vector<Property>& topics,
+                                const Callback& callback) {
+    return subscribe(msg_group, topics, callback, SubscribeOptions());
+}
+
+Node::Error NodeImpl::subscribe(const Property& msg_group, const std::vector<Property>& topics,
+                                const Callback& callback, const SubscribeOptions& options) {
+    if (!callback) {
+        return Error::INVALID_ARG;
+    }
+    return addSubscription(msg_group, topics, std::make_shared<const Callback>(callback), nullptr, options);
+}
+
+std::shared_ptr<PollingSubscription> NodeImpl::subscribePolling(const Property& msg_group,
+                                                                const std::vector<Property>& topics, size_t capacity) {
+    // Pushed from the receiving thread (INLINE), taken by the application: no dispatch worker involved
+    auto polling = std::make_shared<PollingSubscription>(capacity);
+    if (polling->fd() < 0) {
+        return nullptr;
+    }
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    if (addSubscription(msg_group, topics, nullptr, polling, options) != Error::NO_ERROR) {
+        return nullptr;
+    }
+    return polling;
+}
+
+Node::Error NodeImpl::addSubscription(const Property& msg_group, const std::vector<Property>& topics,
+                                      std::shared_ptr<const Callback> callback,
+                                      std::shared_ptr<PollingSubscription> polling, const SubscribeOptions& options) {
+    if (msg_group.empty() || topics.empty() || options.max_rate_hz < 0) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    // Wildcards: '#' may only be the last segment
+    for (const auto& topic : topics) {
+        if (isTopicPattern(topic) && !TopicMatcher().insert(topic, options.dispatch)) {
+            return Error::INVALID_ARG;
+        }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+
+    // Get or create subscription info for this group
+    auto& sub_info = subscriptions_[msg_group];
+
+    // Add topics (by process-wide topic id for the dispatch path); patterns subscribe the topics
+    // they match on first use (subscribeMatchedTopic())
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    bool patterns_changed = false;
+    for (const auto& topic : topics) {
+        if (topic.empty()) {
+            continue;
+        }
+        if (isTopicPattern(topic)) {
+            sub_info.patterns[topic] = options.dispatch;
+            patterns_changed = true;
+            continue;
+        }
+        sub_info.topics.insert(topic);
+        addTopicSubscription(registry.resolveTopic(msg_group, topic), &sub_info, options.dispatch, false);
+    }
+    if (patterns_changed) {
+        std::unique_ptr<TopicMatcher> matcher(new TopicMatcher());
+        for (const auto& pattern : sub_info.patterns) {
+            matcher->insert(pattern.first, pattern.second);
+        }
+        sub_info.matcher = std::move(matcher);
+    }
+
+    // Update callback or polling queue (workers still running the old callback keep it alive)
+    sub_info.callback = std::move(callback);
+    sub_info.polling = std::move(polling);
+    publishSubscriptionSnapshot();
+
+    // Auto-register services (service discovery)
+    for (const auto& topic : topics) {
+        if (!topic.empty()) {
+            // Register for shared memory transport (if available)
+            if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+                ServiceDescriptor svc;
+                svc.node_id = node_id_;
+                svc.group = msg_group;
+                svc.topic = topic;
+                svc.type = ServiceType::NORMAL_MESSAGE;
+                svc.channel_name = "";  // Not a large data channel
+                svc.transport = TransportType::SHARED_MEMORY;
+                svc.udp_address = "";
+                if (!isTopicPattern(topic)) {
+                    svc.topic_id = registry.findTopic(msg_group, topic).id();  // Peers may send compact frames
+                }
+                svc.priority = options.priority;
+                svc.min_interval_us = rateIntervalUs(options.max_rate_hz);
+
+                registerService(svc);
+            }
+
+            // Register for UDP transport (if enabled)
+            if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
+                ServiceDescriptor svc;
+                svc.node_id = node_id_;
+                svc.group = msg_group;
+                svc.topic = topic;
+                svc.type = ServiceType::NORMAL_MESSAGE;
+                svc.channel_name = "";
+                svc.transport = TransportType::UDP;
+                svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
+                svc.multicast_address = joinTopicMulticast(msg_group, topic);
+                svc.min_interval_us = rateIntervalUs(options.max_rate_hz);
+
+                registerService(svc);
+            }
+        }
+    }
+
+    // No need to broadcast SUBSCRIBE - service registration handles discovery
+
+    // Attach to buses the new topics are already published on (see setTopicBus())
+    lock.unlock();
+    topic_bus_readers_->sync(true);
+
+    return Error::NO_ERROR;
+}
+
+Node::Error NodeImpl::subscribe(const TopicHandle& topic, const Callback& callback) {
+    return subscribe(topic, callback, SubscribeOptions());
+}
+
+Node::Error NodeImpl::subscribe(const TopicHandle& topic, const Callback& callback, const SubscribeOptions& options) {
+    if (!topic.valid()) {
+        return Error::INVALID_ARG;
+    }
+    return subscribe(topic.group(), {topic.topic()}, callback, options);
+}
+
+Node::Error NodeImpl::unsubscribe(const Property& msg_group, const std::vector<Property>& topics) {
+    if (msg_group.empty()) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    // Collect topics to broadcast unsubscribe (avoid broadcasting inside lock)
+    std::vector<std::string> topics_to_broadcast;
+
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+
+        auto it = subscriptions_.find(msg_group);
+        if (it == subscriptions_.end()) {
+            return Error::NOT_FOUND;
+        }
+
+        auto& registry = Nexus::rpc::GlobalRegistry::instance();
+        SubscriptionInfo& sub_info = it->second;
+        if (topics.empty()) {
+            // Remove entire group - collect all topics and patterns
+            topics_to_broadcast.assign(sub_info.topics.begin(), sub_info.topics.end());
+            for (const auto& pattern : sub_info.patterns) {
+                topics_to_broadcast.push_back(pattern.first);
+            }
+            dropMatchedTopics(&sub_info, true);
+            subscriptions_.erase(it);
+        } else {
+            // Remove specific topics
+            bool patterns_changed = false;
+            for (const auto& topic : topics) {
+                auto topic_it = sub_info.topics.find(topic);
+                if (topic_it != sub_info.topics.end()) {
+                    topics_to_broadcast.push_back(topic);
+                    sub_info.topics.erase(topic_it);
+                    topic_subscriptions_[registry.findTopic(msg_group, topic).id()] = TopicSubscription();
+                } else if (sub_info.patterns.erase(topic) > 0) {
+                    topics_to_broadcast.push_back(topic);
+                    patterns_changed = true;
+                }
+            }
+            if (patterns_changed) {
+                std::unique_ptr<TopicMatcher> matcher;
+                if (!sub_info.patterns.empty()) {
+                    matcher.reset(new TopicMatcher());
+                    for (const auto& pattern : sub_info.patterns) {
+                        matcher->insert(pattern.first, pattern.second);
+                    }
+                }
+                sub_info.matcher = std::move(matcher);
+                dropMatchedTopics(&sub_info, false);
+            }
+
+            // Remove group if no topics left
+            if (sub_info.topics.empty() && sub_info.patterns.empty()) {
+                dropMatchedTopics(&sub_info, true);
+                subscriptions_.erase(it);
+            }
+        }
+        publishSubscriptionSnapshot();
+
+        // Lanes are kept for a later subscribe, their backlog is not: give the payloads back now
+        for (size_t id = 0; id < lanes_.size(); ++id) {
+            if (lanes_[id] && (id >= topic_subscriptions_.size() || !topic_subscriptions_[id].info)) {
+                discardLane(*lanes_[id]);
+            }
+        }
+    }
+
+    // Auto-unregister services for collected topics (outside of lock)
+    for (const auto& topic : topics_to_broadcast) {
+        // Auto-unregister services (both SHM and UDP)
+        if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
             ServiceDescriptor svc;
             svc.node_id = node_id_;
             svc.group = msg_group;
@@ -457,8 +1441,10 @@ Node::Error NodeImpl::unsubscribe(const Property& msg_group, const std::vector<P
             svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
 
             unregisterService(svc);
+            leaveTopicMulticast(msg_group, topic);
         }
     }
+    topic_bus_readers_->sync(true);  // Detach from buses of topics no longer subscribed
 
     return Error::NO_ERROR;
 }
@@ -476,83 +1462,379 @@ Node::Error NodeImpl::sendLargeData(const std::string& msg_group, const std::str
 
     // Auto-register large data service (first send only)
 
+    int64_t seq = -1;
+    Error write_err = writeLargeBlock(channel_name, topic, data, size, seq);
+    if (write_err != NO_ERROR) {
+        return write_err;
+    }
+
+    // Send notification via V3 message queue (only 128 bytes)
+    LargeDataNotification notif{};
+    notif.sequence = static_cast<uint64_t>(seq);
+    notif.size = static_cast<uint32_t>(size);
+    notif.reserved1 = 0;
+
+    // Copy channel name and topic (with bounds checking)
+    strncpy(notif.channel_name, channel_name.c_str(), sizeof(notif.channel_name) - 1);
+    notif.channel_name[sizeof(notif.channel_name) - 1] = '\0';
+
+    strncpy(notif.topic, topic.c_str(), sizeof(notif.topic) - 1);
+    notif.topic[sizeof(notif.topic) - 1] = '\0';
+
+    memset(notif.reserved2, 0, sizeof(notif.reserved2));
+
+    // Use user-specified msg_group and topic for the notification (published as raw bytes)
+    Error err = publish(msg_group, topic, reinterpret_cast<const uint8_t*>(&notif), sizeof(notif));
+    if (err != NO_ERROR) {
+        return err;
+    }
+
+    return NO_ERROR;
+}
+
+Node::Error NodeImpl::writeLargeData(const std::string& channel_name, const std::string& topic,
+                                     const uint8_t* data, size_t size) {
+    if (channel_name.empty() || topic.empty() || !data || size == 0) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    // No notification: the commit rings the channel doorbell for subscribeLargeData() readers
+    int64_t seq = -1;
+    return writeLargeBlock(channel_name, topic, data, size, seq);
+}
+
+Node::Error NodeImpl::writeLargeBlock(const std::string& channel_name, const std::string& topic, const uint8_t* data,
+                                      size_t size, int64_t& seq) {
     // Get or create the large data channel
     auto channel = getLargeDataChannel(channel_name);
     if (!channel) {
         return Error::UNEXPECTED_ERROR;
     }
 
-    // Check if there's enough space
+    // Check if there's enough space (BLOCK: write() waits for readers instead)
     size_t required = sizeof(LargeDataHeader) + size;
-    if (!channel->canWrite(required)) {
+    const bool block = channel->getOverflowPolicy() == LargeDataOverflowPolicy::BLOCK;
+    if (!block && !channel->canWrite(required)) {
         return Error::TIMEOUT;  // Buffer full
     }
 
     // Write data to the channel
-    int64_t seq = channel->write(topic, data, size);
+    seq = channel->write(topic, data, size);
     if (seq < 0) {
+        return (block && !channel->canWrite(required)) ? Error::TIMEOUT : Error::UNEXPECTED_ERROR;
+    }
+    return NO_ERROR;
+}
+
+std::shared_ptr<LargeDataChannel> NodeImpl::getLargeDataChannel(const std::string& channel_name) {
+    if (channel_name.empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(large_channels_mutex_);
+
+    // Check if channel already exists
+    auto it = large_channels_.find(channel_name);
+    if (it != large_channels_.end()) {
+        return it->second;
+    }
+
+    // Create new channel with default optimized configuration
+    LargeDataChannel::Config config = largeDataChannelConfig();
+
+    // Create channel (mmap with MAP_NORESERVE, actual pages allocated on write)
+    auto channel = LargeDataChannel::create(channel_name, config);
+    if (channel) {
+        large_channels_[channel_name] = channel;
+
+        NEXUS_INFO("LargeData") << "Created large data channel: " << channel_name
+                                << ", size: " << (config.buffer_size / 1024 / 1024) << " MB"
+                                << ", MAP_NORESERVE: yes (lazy allocation)";
+    }
+
+    return channel;
+}
+
+LargeDataChannel::Config NodeImpl::largeDataChannelConfig() {
+    // Note: Using MAP_NORESERVE means 64MB is reserved but not allocated until used
+    // Actual memory usage depends on real data written
+    LargeDataChannel::Config config;
+    config.use_mmap_noreserve = true;         // Memory-efficient: only allocates when written
+    config.buffer_size = 64 * 1024 * 1024;    // 64MB virtual address space
+    config.max_block_size = 8 * 1024 * 1024;  // 8MB max block
+    const auto& large_data_config = Nexus::rpc::Config::instance().large_data;
+    config.huge_pages = large_data_config.huge_pages;
+    config.prefault = large_data_config.prefault;  // Trades startup time for no page faults on the first frames
+    config.lock_memory = large_data_config.lock_memory;
+    config.numa_node = Nexus::rpc::Config::instance().node.numa_node;
+    return config;
+}
+
+Node::Error NodeImpl::subscribeLargeData(const std::string& channel_name, LargeDataCallback callback) {
+    if (channel_name.empty() || !callback) {
+        return Error::INVALID_ARG;
+    }
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    std::lock_guard<std::mutex> lock(large_readers_mutex_);
+    if (large_readers_.count(channel_name)) {
+        return Error::ALREADY_EXISTS;
+    }
+
+    auto reader = openLargeDataReader(channel_name);
+    if (!reader) {
         return Error::UNEXPECTED_ERROR;
     }
+    reader->callback = std::move(callback);
+    reader->placement = threads_config_.large_data;
+    reader->thread = std::thread(&NodeImpl::largeDataReaderThread, channel_name, reader);
+    large_readers_[channel_name] = reader;
+    return NO_ERROR;
+}
 
-    // Send notification via V3 message queue (only 128 bytes)
-    LargeDataNotification notif{};
-    notif.sequence = static_cast<uint64_t>(seq);
-    notif.size = static_cast<uint32_t>(size);
-    notif.reserved1 = 0;
+Node::Error NodeImpl::unsubscribeLargeData(const std::string& channel_name) {
+    std::shared_ptr<LargeDataReader> reader;
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        auto it = large_readers_.find(channel_name);
+        if (it == large_readers_.end()) {
+            return Error::NOT_FOUND;
+        }
+        reader = std::move(it->second);
+        large_readers_.erase(it);
+    }
 
-    // Copy channel name and topic (with bounds checking)
-    strncpy(notif.channel_name, channel_name.c_str(), sizeof(notif.channel_name) - 1);
-    notif.channel_name[sizeof(notif.channel_name) - 1] = '\0';
+    stopLargeDataReader(std::move(reader));
+    return NO_ERROR;
+}
 
-    strncpy(notif.topic, topic.c_str(), sizeof(notif.topic) - 1);
-    notif.topic[sizeof(notif.topic) - 1] = '\0';
+Node::Error NodeImpl::bridgeLargeData(const std::string& channel_name) {
+    if (channel_name.empty() || channel_name.size() > MessagePacket::MAX_TOPIC_LEN) {
+        return Error::INVALID_ARG;
+    }
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
 
-    memset(notif.reserved2, 0, sizeof(notif.reserved2));
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        if (large_bridges_.count(channel_name)) {
+            return Error::ALREADY_EXISTS;
+        }
 
-    // Publish notification as a string (convert struct to string)
-    std::string notif_str(reinterpret_cast<const char*>(&notif), sizeof(notif));
+        auto reader = openLargeDataReader(channel_name);
+        if (!reader) {
+            return Error::UNEXPECTED_ERROR;
+        }
+        // Blocks leave the ring before they are sent: the bridge thread reuses one buffer
+        auto buffer = std::make_shared<std::vector<uint8_t>>();
+        reader->forward = [this, channel_name, buffer](LargeDataChannel& channel,
+                                                       const LargeDataChannel::DataBlock& block) {
+            forwardLargeBlock(channel_name, channel, block, *buffer);
+        };
+        reader->placement = threads_config_.large_data;
+        reader->thread = std::thread(&NodeImpl::largeDataReaderThread, channel_name, reader);
+        large_bridges_[channel_name] = reader;
+    }
 
-    // Use user-specified msg_group and topic for the notification
-    Error err = publish(msg_group, topic, notif_str);
-    if (err != NO_ERROR) {
-        return err;
+    // Fragmented and acknowledged over UDP, never multicast
+    setTopicReliable(LARGE_DATA_BRIDGE_GROUP, channel_name, true);
+    if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
+        registerService(largeDataBridgeService(channel_name));
+    }
+    return NO_ERROR;
+}
+
+Node::Error NodeImpl::unbridgeLargeData(const std::string& channel_name) {
+    std::shared_ptr<LargeDataReader> reader;
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        auto it = large_bridges_.find(channel_name);
+        if (it == large_bridges_.end()) {
+            return Error::NOT_FOUND;
+        }
+        reader = std::move(it->second);
+        large_bridges_.erase(it);
+    }
+
+    stopLargeDataReader(std::move(reader));
+    if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
+        unregisterService(largeDataBridgeService(channel_name));
+    }
+    return NO_ERROR;
+}
+
+ServiceDescriptor NodeImpl::largeDataBridgeService(const std::string& channel_name) const {
+    ServiceDescriptor svc;
+    svc.node_id = node_id_;
+    svc.group = LARGE_DATA_BRIDGE_GROUP;
+    svc.topic = channel_name;
+    svc.type = ServiceType::LARGE_DATA;
+    svc.channel_name = channel_name;
+    svc.transport = TransportType::UDP;
+    svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
+    return svc;
+}
+
+void NodeImpl::forwardLargeBlock(const std::string& channel_name, LargeDataChannel& channel,
+                                 const LargeDataChannel::DataBlock& block, std::vector<uint8_t>& buffer) {
+    // Copy out of the ring first: a reliable send can wait for acknowledgements while the writer reuses the slot
+    LargeDataBridgeHeader header{};
+    header.sequence = block.header->sequence;
+    header.stream_id = block.header->stream_id;
+    header.stream_offset = block.header->stream_offset;
+    header.stream_size = block.header->stream_size;
+    header.size = static_cast<uint32_t>(block.size);
+    header.stream_flags = block.header->stream_flags;
+    std::memcpy(header.topic, block.header->topic, sizeof(header.topic));
+    header.topic[sizeof(header.topic) - 1] = '\0';
+
+    buffer.resize(sizeof(header) + block.size);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (block.size > 0) {
+        std::memcpy(buffer.data() + sizeof(header), block.data, block.size);
+    }
+    if (!channel.releaseBlock(block)) {
+        // The writer overwrote the block while it was copied (DROP_OLDEST): the copy may be torn
+        NEXUS_WARN("IMPL") << "Large data bridge " << channel_name << " skipped overwritten block "
+                           << header.sequence;
+        return;
+    }
+
+    const Error sent = publish(LARGE_DATA_BRIDGE_GROUP, channel_name, buffer.data(), buffer.size());
+    if (sent != NO_ERROR) {
+        NEXUS_WARN("IMPL") << "Large data bridge " << channel_name << " failed to forward block " << header.sequence
+                           << " (error " << sent << ")";
+    }
+}
+
+Node::Error NodeImpl::importLargeData(const std::string& channel_name, const std::string& local_name) {
+    if (channel_name.empty() || channel_name.size() > MessagePacket::MAX_TOPIC_LEN) {
+        return Error::INVALID_ARG;
+    }
+    if (!running_) {
+        return Error::NOT_INITIALIZED;
+    }
+    if (isSubscribed(LARGE_DATA_BRIDGE_GROUP, channel_name)) {
+        return Error::ALREADY_EXISTS;
+    }
+
+    const std::string target = local_name.empty() ? channel_name : local_name;
+    auto import = std::make_shared<LargeDataImport>();
+    import->channel = getLargeDataChannel(target);
+    if (!import->channel) {
+        return Error::UNEXPECTED_ERROR;
+    }
+
+    // Inline: a block is written straight from the received message, without a copy into the node's queue
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    return subscribe(
+        LARGE_DATA_BRIDGE_GROUP, {channel_name},
+        [target, import](const Property&, const Property&, const uint8_t* payload, size_t size) {
+            importLargeBlock(target, *import, payload, size);
+        },
+        options);
+}
+
+void NodeImpl::importLargeBlock(const std::string& local_name, LargeDataImport& import, const uint8_t* payload,
+                                size_t size) {
+    LargeDataBridgeHeader header;
+    if (size < sizeof(header)) {
+        return;
+    }
+    std::memcpy(&header, payload, sizeof(header));
+    if (header.size != size - sizeof(header)) {
+        return;
+    }
+    const std::string topic(header.topic, strnlen(header.topic, sizeof(header.topic)));
+    const uint8_t* data = payload + sizeof(header);
+
+    std::lock_guard<std::mutex> lock(import.mutex);
+    LargeDataChannel& channel = *import.channel;
+    if (!(header.stream_flags & LargeDataHeader::STREAM_CHUNK)) {
+        if (channel.write(topic, data, header.size) < 0) {
+            NEXUS_WARN("IMPL") << "Large data import " << local_name << " dropped block " << header.sequence;
+        }
+        return;
+    }
+
+    // Stream chunk: replay beginStream/writeStream locally (chunk sizes may differ from the source)
+    if (header.stream_flags & LargeDataHeader::STREAM_ABORTED) {
+        if (channel.inStream()) {
+            channel.abortStream();
+        }
+        return;
+    }
+    if (!channel.inStream()) {
+        // Joined (or failed) in the middle of a stream: wait for the next one
+        if (header.stream_offset != 0 || !channel.beginStream(topic, header.stream_size)) {
+            return;
+        }
+    }
+    const bool last = (header.stream_flags & LargeDataHeader::STREAM_END) != 0;
+    if (channel.writeStream(data, header.size, last) < 0) {
+        NEXUS_WARN("IMPL") << "Large data import " << local_name << " dropped stream " << header.stream_id;
+        channel.abortStream();
     }
-
-    return NO_ERROR;
 }
 
-std::shared_ptr<LargeDataChannel> NodeImpl::getLargeDataChannel(const std::string& channel_name) {
-    if (channel_name.empty()) {
+std::shared_ptr<NodeImpl::LargeDataReader> NodeImpl::openLargeDataReader(const std::string& channel_name) {
+    auto reader = std::make_shared<LargeDataReader>();
+    reader->channel = LargeDataChannel::create(channel_name, largeDataChannelConfig());
+    if (!reader->channel) {
         return nullptr;
     }
+    // Register the reader slot now: blocks written after the caller returns are delivered
+    LargeDataChannel::DataBlock block;
+    if (reader->channel->tryRead(block)) {
+        reader->channel->releaseBlock(block);
+    }
+    return reader;
+}
 
-    std::lock_guard<std::mutex> lock(large_channels_mutex_);
-
-    // Check if channel already exists
-    auto it = large_channels_.find(channel_name);
-    if (it != large_channels_.end()) {
-        return it->second;
+void NodeImpl::stopLargeDataReader(std::shared_ptr<LargeDataReader> reader) {
+    reader->running.store(false);
+    if (reader->thread.joinable() && reader->thread.get_id() != std::this_thread::get_id()) {
+        reader->thread.join();
+    } else if (reader->thread.joinable()) {
+        reader->thread.detach();  // Stopped from its own callback; the thread holds the last reference
     }
+}
 
-    // Create new channel with default optimized configuration
-    // Note: Using MAP_NORESERVE means 64MB is reserved but not allocated until used
-    // Actual memory usage depends on real data written
-    LargeDataChannel::Config config;
-    config.use_mmap_noreserve = true;         // Memory-efficient: only allocates when written
-    config.buffer_size = 64 * 1024 * 1024;    // 64MB virtual address space
-    config.max_block_size = 8 * 1024 * 1024;  // 8MB max block
+void NodeImpl::largeDataReaderThread(const std::string& channel_name, std::shared_ptr<LargeDataReader> reader) {
+    static constexpr int WAIT_SLICE_MS = 100;  // Bounds how long unsubscribe/shutdown waits for the thread
+    applyThreadPlacement(reader->placement, "large data reader");
 
-    // Create channel (mmap with MAP_NORESERVE, actual pages allocated on write)
-    auto channel = LargeDataChannel::create(channel_name, config);
-    if (channel) {
-        large_channels_[channel_name] = channel;
+    LargeDataChannel& channel = *reader->channel;
+    while (reader->running.load(std::memory_order_relaxed)) {
+        if (!channel.waitForData(WAIT_SLICE_MS)) {
+            continue;
+        }
 
-        NEXUS_INFO("LargeData") << "Created large data channel: " << channel_name
-                                << ", size: " << (config.buffer_size / 1024 / 1024) << " MB"
-                                << ", MAP_NORESERVE: yes (lazy allocation)";
+        LargeDataChannel::DataBlock block;
+        if (!channel.tryRead(block)) {
+            // Header not complete yet or a corrupt block was skipped: retry shortly
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        if (reader->forward) {
+            reader->forward(channel, block);  // Releases the block itself
+            continue;
+        }
+        try {
+            reader->callback(channel_name, block.getTopic(), block.data, block.size, block.header->sequence);
+        } catch (...) {
+            NEXUS_LOG_ERROR("IMPL", "Large data callback threw for channel " + channel_name);
+        }
+        channel.releaseBlock(block);
     }
-
-    return channel;
 }
 
 bool NodeImpl::isSubscribed(const Property& msg_group, const Property& topic) const {
@@ -563,9 +1845,31 @@ bool NodeImpl::isSubscribed(const Property& msg_group, const Property& topic) co
         return false;
     }
 
-    return it->second.topics.find(topic) != it->second.topics.end();
+    const SubscriptionInfo& sub_info = it->second;
+    return sub_info.topics.count(topic) > 0 || sub_info.patterns.count(topic) > 0 ||
+           (sub_info.matcher && sub_info.matcher->match(topic));
+}
+
+Node::Error NodeImpl::serve(const Property& msg_group, const Property& method, const MethodHandler& handler) {
+    return rpc_server_->serve(msg_group, method, handler);
+}
+
+Node::Error NodeImpl::unserve(const Property& msg_group, const Property& method) {
+    return rpc_server_->unserve(msg_group, method);
+}
+
+Node::Error NodeImpl::call(const Property& msg_group, const Property& method, const Property& request,
+                           Property& response, uint32_t timeout_ms) {
+    return rpc_server_->call(msg_group, method, request, response, timeout_ms);
+}
+
+Node::Error NodeImpl::callAsync(const Property& msg_group, const Property& method, const Property& request,
+                                uint32_t timeout_ms, const ReplyCallback& callback) {
+    return rpc_server_->callAsync(msg_group, method, request, timeout_ms, callback);
 }
 
+size_t NodeImpl::getFailedReplyCount() const { return rpc_server_->getFailedReplyCount(); }
+
 uint16_t NodeImpl::getUdpPort() const {
     if (use_udp_ && udp_transport_) {
         return udp_transport_->getPort();
@@ -573,36 +1877,132 @@ uint16_t NodeImpl::getUdpPort() const {
     return 0;
 }
 
-void NodeImpl::handleMessage(const std::string& source_node_id, const std::string& group, const std::string& topic,
-                             const uint8_t* payload, size_t payload_len) {
+void NodeImpl::handleMessage(StringView source_node_id, StringView group, StringView topic, const uint8_t* payload,
+                             size_t payload_len, uint64_t deadline_ns) {
     // Enqueue message for async processing instead of blocking receive thread
-    enqueueMessage(source_node_id, group, topic, payload, payload_len);
+    enqueueMessage(source_node_id, group, topic, payload, payload_len, deadline_ns);
+}
+
+bool NodeImpl::handleMessage(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                             SharedPayload* shared, uint64_t deadline_ns) {
+    return enqueueMessage(topic, payload, payload_len, shared, deadline_ns);
 }
 
 void NodeImpl::deliverInProcess(const std::string& group, const std::string& topic, const uint8_t* payload,
                                 size_t payload_len) {
-    // Get all registered nodes
-    auto nodes = getAllNodes();
+    // Interned even if nobody subscribed it by name: wildcard subscribers may match it
+    TopicHandle handle = Nexus::rpc::GlobalRegistry::instance().resolveTopic(group, topic);
+    if (handle.valid()) {
+        deliverInProcess(handle, payload, payload_len);
+    }
+}
+
+bool NodeImpl::deliverInProcess(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                                uint64_t deadline_ns) {
+    // Only the topic's subscribers, plus nodes whose wildcards may match it (no registry lock)
+    const auto subscribers = Nexus::rpc::GlobalRegistry::instance().getInProcessSubscribers();
+    const Nexus::rpc::InProcessSubscribers::List& exact = subscribers->topic(topic.id());
+
+    // Deliver to each node (excluding ourselves to prevent loops); queued copies share one pooled payload
+    SharedPayload shared;
+    bool queued = true;
+    for (const auto& subscriber : exact) {
+        auto node = subscriber.lock();
+        if (node && node.get() != this && !node->handleMessage(topic, payload, payload_len, &shared, deadline_ns)) {
+            queued = false;
+        }
+    }
+    for (const auto& subscriber : subscribers->patterns(topic.group())) {
+        if (listedNode(exact, subscriber)) {
+            continue;  // Already matched (or also subscribed by name): delivered above
+        }
+        auto node = subscriber.lock();
+        if (node && node.get() != this && !node->handleMessage(topic, payload, payload_len, &shared, deadline_ns)) {
+            queued = false;
+        }
+    }
+    shared.release();
+    return queued;
+}
+
+bool NodeImpl::hasInProcessSubscribers(const TopicHandle& topic) const {
+    const auto subscribers = Nexus::rpc::GlobalRegistry::instance().getInProcessSubscribers();
+    for (const auto* list : {&subscribers->topic(topic.id()), &subscribers->patterns(topic.group())}) {
+        for (const auto& subscriber : *list) {
+            auto node = subscriber.lock();
+            if (node && node.get() != this) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool NodeImpl::listedNode(const std::vector<std::weak_ptr<NodeImpl>>& list, const std::weak_ptr<NodeImpl>& node) {
+    for (const auto& listed : list) {
+        if (!listed.owner_before(node) && !node.owner_before(listed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+NodeImpl::InterProcessRoute NodeImpl::interProcessRoute(const TopicHandle& topic) {
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    std::lock_guard<std::mutex> lock(routes_mutex_);
+    if (topic.id() >= routes_.size()) {
+        routes_.resize(topic.id() + 1);
+    }
 
-    // Deliver to each node (excluding ourselves to prevent loops)
-    for (const auto& node : nodes) {
-        if (node && node.get() != this) {
-            node->handleMessage(node_id_, group, topic, payload, payload_len);
+    InterProcessRoute& route = routes_[topic.id()];
+    // Read the version before collecting: a change during the rebuild leaves the route stale, never wrong
+    const uint64_t version = registry.getRouteVersion();
+    if (!route || route->route_version != version) {
+        auto targets = std::make_shared<InterProcessTargets>();
+        targets->reliable = topic.id() < reliable_topics_.size() && reliable_topics_[topic.id()];
+        targets->ttl_ns = topic.id() < topic_ttls_.size() ? topic_ttls_[topic.id()] : 0;
+        targets->bus = topic.id() < topic_buses_.size() ? topic_buses_[topic.id()] : nullptr;
+        // Incomplete (a subscriber not connectable yet): version 0 retries on next publish
+        if (collectInterProcessTargets(topic.group(), topic.topic(), *targets)) {
+            targets->route_version = version;
+        }
+        // Publish on the more urgent of our priority for the topic and the one each subscriber asked for
+        if (topic.id() < publish_priorities_.size()) {
+            const uint32_t lane = static_cast<uint32_t>(publish_priorities_[topic.id()]);
+            for (auto* subscribers : {&targets->shm_subscribers, &targets->bus_subscribers}) {
+                for (auto& subscriber : *subscribers) {
+                    subscriber.lane = std::min(subscriber.lane, lane);
+                }
+            }
         }
+        route = targets;
     }
+    return route;
 }
 
-void NodeImpl::deliverInterProcess(const std::vector<uint8_t>& packet, const std::string& group,
-                                   const std::string& topic) {
+bool NodeImpl::collectInterProcessTargets(const std::string& group, const std::string& topic,
+                                          InterProcessTargets& targets) {
     // ✅ Optimization 2: Query services first, then build node sets only if needed
     // This avoids unnecessary getAllNodes() calls when there are no inter-process subscribers
     auto& registry = Nexus::rpc::GlobalRegistry::instance();
-    auto services = registry.findServices(group);
+    const auto services = registry.getServices();
+    const ServiceIndex::List& exact = services->topic(group, topic);
+    const ServiceIndex::List& patterns = services->patterns(group);
 
-    // Quick check: if no services for this group, return early
-    if (services.empty()) {
-        return;
+    // Quick check: if no services for this topic, return early
+    if (exact.empty() && patterns.empty()) {
+        return true;
     }
+    targets.topic_hash = CompactPacket::topicHash(group, topic);
+
+    // Subscribers that asked for a maximum rate (SubscribeOptions::max_rate_hz) are decimated per topic
+    auto rate_limit = [&targets](uint32_t interval_us) -> std::shared_ptr<RateLimit> {
+        if (interval_us == 0) {
+            return nullptr;
+        }
+        targets.rate_limited = true;
+        return std::make_shared<RateLimit>(interval_us);
+    };
 
     // Build a set of local node IDs (in-process nodes) - only if we have services
     std::set<std::string> local_node_ids;
@@ -623,82 +2023,266 @@ void NodeImpl::deliverInterProcess(const std::vector<uint8_t>& packet, const std
         shm_node_ids.insert(shm_nodes.begin(), shm_nodes.end());
     }
 
+    // Subscribers reading our topic bus advertise their reader slot in a TOPIC_BUS service of the bus
+    std::map<std::string, uint32_t> bus_slots;
+    if (targets.bus) {
+        for (const auto& svc : exact) {
+            if (svc.type == ServiceType::TOPIC_BUS && svc.channel_name == targets.bus->channelName() &&
+                svc.reader_slot < MAX_READERS) {
+                bus_slots[svc.node_id] = svc.reader_slot;
+            }
+        }
+    }
+
     // ✅ Optimization 3: Reserve capacity to avoid reallocation
     // Separate subscribers by transport type
-    std::vector<std::string> shm_subscribers;
-    std::vector<std::pair<std::string, uint16_t>> udp_subscribers;  // (address, port)
-    std::set<std::string> delivered_nodes;                          // Avoid duplicate delivery
+    std::vector<InterProcessTargets::ShmTarget>& shm_subscribers = targets.shm_subscribers;
+    std::vector<sockaddr_in>& udp_subscribers = targets.udp_subscribers;
+    std::set<std::string> delivered_nodes;  // Avoid duplicate delivery
+    std::vector<const ServiceDescriptor*> multicast_services;  // Resolved after shm: a local node takes that path
+    bool complete = true;
 
     shm_subscribers.reserve(8);  // Reserve space for typical case (避免多次realloc)
     udp_subscribers.reserve(8);
 
-    for (const auto& svc : services) {
-        // Skip services that don't match this topic
-        if (svc.topic != topic) {
-            continue;
-        }
+    for (const ServiceIndex::List* list : {&exact, &patterns}) {
+        for (const auto& svc : *list) {
+            // Skip services that don't match this topic (wildcard subscriptions match by pattern)
+            if (svc.topic != topic && !topicMatches(svc.topic, topic)) {
+                continue;
+            }
 
-        // Skip LARGE_DATA services - they don't receive normal pub/sub messages
-        if (svc.type != ServiceType::NORMAL_MESSAGE) {
-            continue;
-        }
+            // Skip LARGE_DATA services - they don't receive normal pub/sub messages
+            if (svc.type != ServiceType::NORMAL_MESSAGE) {
+                continue;
+            }
 
-        // Skip ourselves
-        if (svc.node_id == node_id_) {
-            continue;
-        }
+            // Skip ourselves
+            if (svc.node_id == node_id_) {
+                continue;
+            }
 
-        // Skip in-process nodes - they are already handled by deliverInProcess
-        if (local_node_ids.count(svc.node_id) > 0) {
-            continue;
-        }
+            // Skip in-process nodes - they are already handled by deliverInProcess
+            if (local_node_ids.count(svc.node_id) > 0) {
+                continue;
+            }
 
-        // Skip if already delivered to this node (avoid duplicate via different transports)
-        if (delivered_nodes.count(svc.node_id) > 0) {
-            continue;
-        }
+            // Skip if already delivered to this node (avoid duplicate via different transports)
+            if (delivered_nodes.count(svc.node_id) > 0) {
+                continue;
+            }
 
-        // Choose transport based on service registration
-        if (svc.transport == TransportType::SHARED_MEMORY) {
-            // Verify node is actually in shared memory
-            if (shm_node_ids.count(svc.node_id) > 0) {
-                shm_subscribers.push_back(svc.node_id);
-                delivered_nodes.insert(svc.node_id);
-            }
-        } else if (svc.transport == TransportType::UDP) {
-            // ✅ Optimization 4: Parse UDP address with validation (avoid exceptions in hot path)
-            if (!svc.udp_address.empty()) {
-                const size_t colon_pos = svc.udp_address.find(':');
-                if (colon_pos != std::string::npos && colon_pos > 0 && colon_pos < svc.udp_address.length() - 1) {
-                    const std::string& ip_str = svc.udp_address.substr(0, colon_pos);
-                    const std::string& ip = (ip_str == "0.0.0.0") ? "127.0.0.1" : ip_str;
-
-                    try {
-                        uint16_t port = static_cast<uint16_t>(std::stoi(svc.udp_address.substr(colon_pos + 1)));
-                        udp_subscribers.emplace_back(ip, port);
-                        delivered_nodes.insert(svc.node_id);
-                    } catch (const std::exception&) {
-                        // Skip invalid port number
+            // Choose transport based on service registration
+            if (svc.transport == TransportType::SHARED_MEMORY) {
+                // Verify node is actually in shared memory
+                if (shm_node_ids.count(svc.node_id) > 0) {
+                    // Connect once here; publishes then address the queue by handle
+                    uint32_t handle = shm_transport_v3_->resolveNode(svc.node_id);
+                    if (handle == SharedMemoryTransportV3::INVALID_NODE_HANDLE) {
+                        // Left to the connector: its readiness event invalidates the route, no retry per publish
+                        if (!shm_transport_v3_->isConnectPending(svc.node_id)) {
+                            complete = false;
+                        }
+                        continue;
+                    }
+                    InterProcessTargets::ShmTarget target = {svc.node_id, handle, svc.topic_id,
+                                                             static_cast<uint32_t>(svc.priority),
+                                                             rate_limit(svc.min_interval_us)};
+                    // Bus readers take every message from the ring; a rate-limited one keeps its own frames
+                    auto slot = bus_slots.find(svc.node_id);
+                    if (slot != bus_slots.end() && !target.rate_limit) {
+                        targets.bus_readers |= static_cast<uint16_t>(1u << slot->second);
+                        targets.bus_subscribers.push_back(std::move(target));
+                    } else {
+                        shm_subscribers.push_back(std::move(target));
+                    }
+                    delivered_nodes.insert(svc.node_id);
+                }
+            } else if (svc.transport == TransportType::UDP && !svc.multicast_address.empty() && !targets.reliable) {
+                multicast_services.push_back(&svc);
+            } else if (svc.transport == TransportType::UDP) {
+                // ✅ Optimization 4: Parse UDP address with validation (avoid exceptions in hot path)
+                if (!svc.udp_address.empty()) {
+                    const size_t colon_pos = svc.udp_address.find(':');
+                    if (colon_pos != std::string::npos && colon_pos > 0 && colon_pos < svc.udp_address.length() - 1) {
+                        const std::string& ip_str = svc.udp_address.substr(0, colon_pos);
+                        const std::string& ip = (ip_str == "0.0.0.0") ? "127.0.0.1" : ip_str;
+
+                        try {
+                            uint16_t port = static_cast<uint16_t>(std::stoi(svc.udp_address.substr(colon_pos + 1)));
+                            sockaddr_in addr;
+                            if (UdpTransport::resolveAddress(ip, port, addr)) {
+                                udp_subscribers.push_back(addr);
+                                targets.udp_peers.push_back(udpPeer(addr));
+                                if (svc.min_interval_us != 0) {
+                                    targets.udp_rate_limits.resize(targets.udp_peers.size());
+                                    targets.udp_rate_limits.back() = rate_limit(svc.min_interval_us);
+                                }
+                                delivered_nodes.insert(svc.node_id);
+                            }
+                        } catch (const std::exception&) {
+                            // Skip invalid port number
+                        }
                     }
                 }
             }
         }
     }
 
+    // Multicast subscribers: one datagram per group, however many subscribers joined it
+    std::set<std::string> multicast_groups;
+    for (const ServiceDescriptor* svc : multicast_services) {
+        if (!delivered_nodes.insert(svc->node_id).second || !multicast_groups.insert(svc->multicast_address).second) {
+            continue;
+        }
+        sockaddr_in addr;
+        if (parseUdpAddress(svc->multicast_address, addr)) {
+            udp_subscribers.push_back(addr);
+        }
+    }
+
+    // UDP subscribers are unreachable without a UDP transport
+    if (!use_udp_ || !udp_transport_ || !udp_transport_->isInitialized() || (targets.reliable && !reliable_udp_)) {
+        udp_subscribers.clear();
+        targets.udp_peers.clear();
+        targets.udp_rate_limits.clear();
+    }
+    if (!targets.udp_rate_limits.empty()) {
+        targets.udp_rate_limits.resize(targets.udp_peers.size());  // Aligned with udp_peers
+    }
+    return complete;
+}
+
+Node::Error NodeImpl::deliverInterProcess(const InterProcessTargets& targets, const std::string& group,
+                                          const std::string& topic, const uint8_t* payload, size_t payload_len,
+                                          const DataTrailer& trailer) {
+    const PayloadSegment segment = {payload, payload_len};
+    return deliverInterProcess(targets, group, topic, &segment, 1, payload_len, trailer);
+}
+
+Node::Error NodeImpl::deliverInterProcess(const InterProcessTargets& targets, const std::string& group,
+                                          const std::string& topic, const PayloadSegment* segments, size_t count,
+                                          size_t payload_len, const DataTrailer& trailer) {
+    if (targets.empty()) {
+        return Error::NO_ERROR;
+    }
+
+    const uint16_t udp_port = getUdpPort();
+    const uint64_t now_ns = targets.rate_limited ? TraceStamp::now() : 0;
+    Error result = Error::NO_ERROR;
+
     // ✅ Optimized: Point-to-point send to each subscriber
-    // 1. Send via shared memory
+    // 1. Send via shared memory (packet is serialized directly into the receiver's queue)
     if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
-        for (const auto& subscriber_id : shm_subscribers) {
-            shm_transport_v3_->send(subscriber_id, packet.data(), packet.size());
+        // Bus readers: one write and one wake-up for all of them. The ring carries no trailer, so traced
+        // frames and frames with a deadline go to each of them directly, like messages too large for it
+        const bool via_bus = !targets.bus_subscribers.empty() && trailer.size() == 0 &&
+                             targets.bus->write(topic, payload_len, targets.bus_readers, [&](uint8_t* payload, size_t) {
+                                 gatherPayload(payload, segments, count);
+                             });
+        for (const auto* subscribers : {&targets.shm_subscribers, &targets.bus_subscribers}) {
+            if (via_bus && subscribers == &targets.bus_subscribers) {
+                break;
+            }
+            for (const auto& subscriber : *subscribers) {
+                if (subscriber.rate_limit && !subscriber.rate_limit->admit(now_ns)) {
+                    continue;  // Decimated: the subscriber asked for fewer messages
+                }
+                size_t packet_size = shmFrameSize(subscriber.topic_id, group, topic, payload_len, trailer);
+                auto fill = [&](uint8_t* frame, size_t) {
+                    gatherPayload(buildShmHeader(frame, subscriber.topic_id, targets.topic_hash, node_id_, group,
+                                                 topic, payload_len, udp_port, shm_checksum_),
+                                  segments, count);
+                    sealShmFrame(frame, trailer);
+                };
+                bool sent = shm_transport_v3_->sendInPlace(subscriber.handle, packet_size, fill, subscriber.lane);
+                // No credit: the receiver has not freed enough space (other subscribers are still served)
+                if (!sent && shmSendFailed(subscriber.handle, packet_size, subscriber.lane) == Error::QUEUE_FULL) {
+                    result = Error::QUEUE_FULL;
+                }
+            }
         }
     }
 
     // 2. Send via UDP
-    if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
-        for (const auto& addr_port : udp_subscribers) {
-            udp_transport_->send(packet.data(), packet.size(), addr_port.first, addr_port.second);
+    const std::vector<sockaddr_in>& udp_subscribers = admittedUdpSubscribers(targets, now_ns);
+    if (!udp_subscribers.empty() && targets.reliable) {
+        const uint8_t* payload = count == 1 ? static_cast<const uint8_t*>(segments[0].data) : nullptr;
+        if (count != 1) {
+            thread_local std::vector<uint8_t> scratch;
+            scratch.resize(payload_len);
+            gatherPayload(scratch.data(), segments, count);
+            payload = scratch.data();
+        }
+        const Error sent = sendReliable(udp_subscribers, group, topic, payload, payload_len);
+        if (sent != Error::NO_ERROR) {
+            result = sent;
+        }
+        markUdpPeersSent(targets);
+    } else if (!udp_subscribers.empty()) {
+        const size_t packet_size = gatheredPacketSize(group, topic, payload_len, trailer);
+        uint8_t* packet = MessageBuilder::threadBuffer(packet_size);
+        buildGatheredPacket(packet, node_id_, group, topic, segments, count, payload_len, udp_port, udp_checksum_,
+                            trailer);
+        udp_transport_->sendBatch(packet, packet_size, udp_subscribers);
+        markUdpPeersSent(targets);
+    }
+
+    return result;
+}
+
+bool NodeImpl::RateLimit::admit(uint64_t now_ns) {
+    uint64_t next = next_ns.load(std::memory_order_relaxed);
+    if (now_ns < next) {
+        return false;
+    }
+    // Keep the cadence while messages come often enough, restart it after a pause
+    const uint64_t following = now_ns - next < interval_ns ? next + interval_ns : now_ns + interval_ns;
+    return next_ns.compare_exchange_strong(next, following, std::memory_order_relaxed);
+}
+
+const std::vector<sockaddr_in>& NodeImpl::admittedUdpSubscribers(const InterProcessTargets& targets,
+                                                                 uint64_t now_ns) {
+    if (targets.udp_rate_limits.empty()) {
+        return targets.udp_subscribers;
+    }
+    // Rate-limited entries are unicast, so they line up with the front of udp_subscribers
+    thread_local std::vector<sockaddr_in> admitted;
+    admitted.clear();
+    for (size_t i = 0; i < targets.udp_subscribers.size(); ++i) {
+        RateLimit* limit = i < targets.udp_rate_limits.size() ? targets.udp_rate_limits[i].get() : nullptr;
+        if (!limit || limit->admit(now_ns)) {
+            admitted.push_back(targets.udp_subscribers[i]);
         }
     }
+    return admitted;
+}
+
+Node::Error NodeImpl::sendReliable(const std::vector<sockaddr_in>& subscribers, const std::string& group,
+                                   const std::string& topic, const uint8_t* payload, size_t payload_len) {
+    if (payload_len > Nexus::rpc::Config::instance().transport.udp_reliable_max_message) {
+        return Error::INVALID_ARG;
+    }
+
+    Error result = Error::NO_ERROR;
+    for (const sockaddr_in& subscriber : subscribers) {
+        if (!reliable_udp_->send(subscriber, group, topic, payload, payload_len)) {
+            NEXUS_WARN("IMPL") << "Reliable UDP send of " << payload_len << " bytes on " << group << "/" << topic
+                               << " failed";
+            result = Error::TIMEOUT;
+        }
+    }
+    return result;
+}
+
+Node::Error NodeImpl::shmSendFailed(uint32_t handle, size_t frame_size, uint32_t lane) {
+    if (shm_transport_v3_->isQueueFull(handle, frame_size, lane)) {
+        noteRetryHint(shm_transport_v3_->retryHintUs(handle));
+        return Error::QUEUE_FULL;
+    }
+    // Connection gone (or handle reused after reconnect): rebuild routes on next publish
+    Nexus::rpc::GlobalRegistry::instance().invalidateRoutes();
+    return Error::NO_ERROR;
 }
 
 // SUBSCRIBE/UNSUBSCRIBE handlers (deprecated - kept for interface compatibility)
@@ -714,7 +2298,8 @@ void NodeImpl::handleUnsubscribe(const std::string&, const std::string&, const s
 }
 
 void NodeImpl::queryExistingSubscriptions() {
-    auto packet = MessageBuilder::build(node_id_, "", "", "", getUdpPort(), MessageType::QUERY_SUBSCRIPTIONS);
+    PacketView packet =
+        MessageBuilder::buildView(node_id_, "", "", nullptr, 0, getUdpPort(), MessageType::QUERY_SUBSCRIPTIONS);
 
     // Query UDP nodes
     if (!use_udp_ || !udp_transport_ || !udp_transport_->isInitialized()) {
@@ -781,137 +2366,441 @@ std::vector<std::shared_ptr<NodeImpl>> NodeImpl::getAllNodes() {
     return Nexus::rpc::GlobalRegistry::instance().getAllNodes();
 }
 
-void NodeImpl::enqueueMessage(const std::string& source_node_id, const std::string& group, const std::string& topic,
-                              const uint8_t* payload, size_t payload_len) {
-    // Quick check if we're subscribed (avoid copying unnecessary data)
+MessagePool& NodeImpl::payloadPool() {
+    // Leaked on purpose: queues of nodes destroyed during static destruction still release into it
+    static MessagePool* pool = new MessagePool(MAX_POOLED_MESSAGES);
+    return *pool;
+}
+
+void NodeImpl::enqueueMessage([[maybe_unused]] StringView source_node_id, StringView group, StringView topic,
+                              const uint8_t* payload, size_t payload_len, uint64_t deadline_ns) {
+    // Resolve the name against our own subscriptions (lock-free, no strings built)
+    TopicHandle handle;
     {
-        std::shared_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
-        auto it = subscriptions_.find(group);
-        if (it == subscriptions_.end() || it->second.topics.find(topic) == it->second.topics.end()) {
+        SubscriptionReader reader(subscription_snapshot_);
+        const SubscriptionSnapshot::Entry* entry = reader.get() ? reader.get()->find(group, topic) : nullptr;
+        if (entry) {
+            handle = entry->lane->topic;
+        } else if (!reader.get() || !reader.get()->matchesPattern(group, topic)) {
             return;  // Not subscribed
         }
     }
+    if (!handle.valid()) {
+        // Matched by a wildcard subscription: intern the topic (once) and continue by handle
+        handle = Nexus::rpc::GlobalRegistry::instance().resolveTopic(group.str(), topic.str());
+    }
+    enqueueMessage(handle, payload, payload_len, nullptr, deadline_ns);
+}
+
+bool NodeImpl::enqueueMessage(const TopicHandle& topic, const uint8_t* payload, size_t payload_len,
+                              SharedPayload* shared, uint64_t deadline_ns) {
+    // Timing of a traced frame, taken here so publishes from an inline callback are not attributed to it
+    const TraceContext trace = t_trace;
+    t_trace = TraceContext();
+
+    // Quick check if we're subscribed (avoid copying unnecessary data); lock-free snapshot read
+    std::shared_ptr<const Callback> inline_callback;
+    std::shared_ptr<PollingSubscription> polling;
+    TopicLane* lane = nullptr;
+    bool conflate = false;
+    {
+        SubscriptionReader reader(subscription_snapshot_);
+        const SubscriptionSnapshot::Entry* entry = reader.get() ? reader.get()->find(topic.id()) : nullptr;
+        if (entry) {
+            polling = entry->polling;
+            if (entry->dispatch == DispatchMode::INLINE) {
+                inline_callback = entry->callback;
+            }
+            conflate = entry->dispatch == DispatchMode::LATEST;
+            lane = entry->lane;  // Lanes live until destruction
+        } else if (!reader.get() || !reader.get()->matchesPattern(topic.group(), topic.topic())) {
+            return true;  // Not subscribed
+        }
+    }
+    if (!lane) {
+        // First message on a topic matched by a wildcard: subscribe it by id, then take the fast path
+        if (!subscribeMatchedTopic(topic)) {
+            return true;
+        }
+        t_trace = trace;
+        return enqueueMessage(topic, payload, payload_len, shared, deadline_ns);
+    }
+
+    // Past its deadline already (a backlog in the receive ring): drop it before any copy or callback
+    if (deadline_ns != 0 && TraceStamp::now() > deadline_ns) {
+        countExpired(topic.id());
+        return true;
+    }
+
+    const uint64_t enqueue_ns = latency_tracing_ ? TraceStamp::now() : 0;
+    if (trace.receive_ns != 0) {
+        if (trace.transit_ns >= 0) {
+            traceLatency(topic.id(), TRACE_TRANSIT, static_cast<uint64_t>(trace.transit_ns));
+        }
+        traceLatency(topic.id(), TRACE_RECEIVE, enqueue_ns - trace.receive_ns);
+    }
+
+    // Inline dispatch: run on this (receive) thread, payload used in place (no copy, no worker hop)
+    if (inline_callback) {
+        const auto start = std::chrono::steady_clock::now();
+        NEXUS_TRACE3(callback_begin, topic.id(), payload_len, 1);
+        try {
+            (*inline_callback)(topic.group(), topic.topic(), payload, payload_len);
+        } catch (...) {
+            // Ignore callback exceptions to prevent receive thread crash
+        }
+        NEXUS_TRACE3(callback_end, topic.id(), payload_len, 1);
+        const uint64_t callback_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        topic_stats_.add(topic.id(), DELIVERED);
+        topic_stats_.add(topic.id(), DELIVERED_BYTES, payload_len);
+        topic_stats_.add(topic.id(), CALLBACK_NS, callback_ns);
+        if (latency_tracing_) {
+            traceLatency(topic.id(), TRACE_CALLBACK, callback_ns);
+        }
+        return true;
+    }
 
-    // Prepare message
+    // Prepare message (pooled payload, copied once per publish however many nodes queue it)
     PendingMessage msg;
-    msg.source_node_id = source_node_id;
-    msg.group = group;
     msg.topic = topic;
-    msg.payload.assign(payload, payload + payload_len);
+    msg.enqueue_ns = enqueue_ns;
+    msg.deadline_ns = deadline_ns;
+    if (!shared) {
+        msg.payload = SharedPayload::create(payloadPool(), payload, payload_len);
+    } else {
+        if (!*shared) {
+            *shared = SharedPayload::create(payloadPool(), payload, payload_len);
+        }
+        shared->retain();
+        msg.payload = *shared;
+    }
+
+    // Polling subscription: hand the payload to the application's queue (no lane, no worker)
+    if (polling) {
+        const bool drop_oldest = overflow_policy_ == QueueOverflowPolicy::DROP_OLDEST;
+        const size_t dropped = polling->push(topic, msg.payload, drop_oldest, deadline_ns);
+        const bool queued = dropped == 0 || drop_oldest;
+        if (queued) {
+            topic_stats_.add(topic.id(), DELIVERED);
+            topic_stats_.add(topic.id(), DELIVERED_BYTES, payload_len);
+        }
+        if (dropped > 0) {
+            dropped_messages_.fetch_add(dropped, std::memory_order_relaxed);
+            topic_stats_.add(topic.id(), DROPPED, dropped);
+        }
+        NEXUS_TRACE3(node_enqueue, topic.id(), payload_len, queued);
+        return queued;
+    }
 
-    // 负载均衡策略：同一个 group:topic 必须映射到同一个线程，保证消息顺序
-    // 使用哈希确保同topic消息的顺序性，同时实现不同topic的负载均衡
-    std::hash<std::string> hasher;
-    std::string routing_key = group + ":" + topic;
-    size_t thread_id = hasher(routing_key) % NUM_PROCESSING_THREADS;
+    // Latest-value dispatch: overwrite the lane's slot (never blocks, never grows)
+    if (conflate) {
+        PendingMessage stale;
+        {
+            std::lock_guard<std::mutex> slot_lock(lane->latest_mutex);
+            stale = lane->latest;
+            lane->latest = msg;
+            lane->has_latest.store(true, std::memory_order_release);
+        }
+        stale.payload.release();
+        if (!lane->scheduled.exchange(true, std::memory_order_acq_rel)) {
+            scheduleLane(lane, topic.id() % run_queues_.size());
+        }
+        return true;
+    }
 
-    // Get max queue size from config
+    // Node-wide limit from config (read per message); each lane's ring bounds its own topic
     auto& config = Nexus::rpc::Config::instance();
     const size_t max_queue_size = config.node.max_queue_size;
 
-    // Enqueue to specific thread's queue (with overflow protection)
-    {
-        std::lock_guard<std::mutex> lock(message_queue_mutexes_[thread_id]);
-        auto& queue = message_queues_[thread_id];
-
-        if (queue.size() >= max_queue_size) {
-            // Queue full - apply overflow policy
-            bool message_dropped = false;
-            PendingMessage* dropped_msg = nullptr;
-
-            switch (overflow_policy_) {
-                case QueueOverflowPolicy::DROP_OLDEST:
-                    // Drop oldest message to make room for new one
-                    dropped_msg = &queue.front();
-                    queue.pop();
-                    queue.push(std::move(msg));
-                    message_dropped = true;
-                    break;
+    // Enqueue to the topic's lane (lock-free, with overflow protection)
+    BoundedMpmcQueue<PendingMessage>& queue = lane->messages;
+    size_t dropped_count = 0;
+    PendingMessage dropped_msg;
+    bool queued = true;
 
-                case QueueOverflowPolicy::DROP_NEWEST:
-                    // Drop the new message
-                    dropped_msg = &msg;
-                    message_dropped = true;
-                    // Don't add to queue
-                    break;
+    if (tryQueueOnLane(*lane, msg, max_queue_size)) {
+        // Fast path: queued
+    } else {
+        // Queue full - apply overflow policy
+        const QueueOverflowPolicy policy = overflow_policy_;
+        switch (policy) {
+            case QueueOverflowPolicy::DROP_OLDEST:
+                // Drop this lane's oldest messages to make room (the worker may drain concurrently)
+                while (!tryQueueOnLane(*lane, msg, max_queue_size)) {
+                    PendingMessage oldest;
+                    if (queue.tryPop(oldest)) {
+                        pending_messages_.fetch_sub(1, std::memory_order_relaxed);
+                        dropped_msg.payload.release();  // Keep only the last one for the callback
+                        dropped_msg = oldest;
+                        dropped_count++;
+                    } else if (queue.empty() && pending_messages_.load(std::memory_order_relaxed) >= max_queue_size) {
+                        // Node-wide limit held by other topics: nothing of ours to drop, drop the new one
+                        dropped_msg.payload.release();
+                        dropped_msg = msg;
+                        dropped_count++;
+                        queued = false;
+                        break;
+                    }
+                }
+                break;
 
-                case QueueOverflowPolicy::BLOCK:
-                    // This should not happen in practice with current design
-                    // But if it does, drop oldest to prevent deadlock
-                    queue.pop();
-                    queue.push(std::move(msg));
+            case QueueOverflowPolicy::BLOCK:
+                // Backpressure: wait for the worker to drain the lane; drop the new message on timeout
+                if (waitForLaneSpace(*lane, msg, max_queue_size)) {
                     break;
-            }
+                }
+                dropped_msg = msg;
+                dropped_count = 1;
+                queued = false;
+                break;
 
-            if (message_dropped) {
-                size_t total_dropped = dropped_messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+            case QueueOverflowPolicy::DROP_NEWEST:
+                // Drop the new message
+                dropped_msg = msg;
+                dropped_count = 1;
+                queued = false;
+                // Don't add to queue
+                break;
+        }
+    }
+    NEXUS_TRACE3(node_enqueue, topic.id(), payload_len, queued);
 
-                // Call overflow callback if set
-                {
-                    std::lock_guard<std::mutex> cb_lock(overflow_callback_mutex_);
-                    if (overflow_callback_) {
-                        try {
-                            overflow_callback_(dropped_msg->group, dropped_msg->topic, total_dropped);
-                        } catch (...) {
-                            // Ignore callback exceptions
-                        }
-                    }
+    if (!queued) {
+        noteRetryHint(lane->batch_time_us.load(std::memory_order_relaxed));
+    }
+    if (watermarks_enabled_.load(std::memory_order_relaxed)) {
+        checkLaneWatermark(*lane, max_queue_size);
+    }
+
+    if (dropped_count > 0) {
+        size_t total_dropped = dropped_messages_.fetch_add(dropped_count, std::memory_order_relaxed) + dropped_count;
+        topic_stats_.add(topic.id(), DROPPED, dropped_count);
+
+        // Call overflow callback if set
+        {
+            std::lock_guard<std::mutex> cb_lock(overflow_callback_mutex_);
+            if (overflow_callback_) {
+                try {
+                    overflow_callback_(dropped_msg.topic.group(), dropped_msg.topic.topic(), total_dropped);
+                } catch (...) {
+                    // Ignore callback exceptions
                 }
             }
-        } else {
-            queue.push(std::move(msg));  // Add to queue
+        }
+        dropped_msg.payload.release();
+    }
+
+    // 负载均衡策略：lane 首次调度到 topic id % workers 对应的线程；
+    // 空闲线程可以整条窃取（同一时刻只有一个线程处理该lane，保证消息顺序）
+    if (!lane->scheduled.exchange(true, std::memory_order_acq_rel)) {
+        scheduleLane(lane, topic.id() % run_queues_.size());
+    }
+    return queued;
+}
+
+void NodeImpl::countExpired(uint32_t topic_id, size_t count) {
+    expired_messages_.fetch_add(count, std::memory_order_relaxed);
+    topic_stats_.add(topic_id, EXPIRED, count);
+}
+
+void NodeImpl::discardLane(TopicLane& lane) {
+    // Safe next to a draining worker: both pop, each message is released once
+    PendingMessage pending;
+    while (lane.messages.tryPop(pending)) {
+        pending_messages_.fetch_sub(1, std::memory_order_relaxed);
+        pending.payload.release();
+    }
+    while (lane.takeLatest(pending)) {
+        pending.payload.release();
+    }
+    lane.space.notifyAll();  // BLOCK producers waiting on either bound
+    pending_space_.notifyAll();
+}
+
+bool NodeImpl::tryQueueOnLane(TopicLane& lane, PendingMessage& msg, size_t max_queue_size) {
+    // Claim a node-wide slot first; give it back if the lane's own ring is full
+    if (pending_messages_.fetch_add(1, std::memory_order_acq_rel) < max_queue_size && lane.messages.tryPush(msg)) {
+        return true;
+    }
+    pending_messages_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool NodeImpl::waitForLaneSpace(TopicLane& lane, PendingMessage& msg, size_t max_queue_size) {
+    const auto timeout = std::chrono::milliseconds(Nexus::rpc::Config::instance().node.block_timeout_ms);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        // Wait on whichever bound is holding us: this lane's ring (drained by its worker) or the node limit
+        EventCount& space = lane.messages.size() < lane.messages.capacity() ? pending_space_ : lane.space;
+        uint32_t key = space.prepareWait();
+        if (tryQueueOnLane(lane, msg, max_queue_size)) {
+            space.cancelWait();
+            return true;
+        }
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (!running_ || remaining <= std::chrono::steady_clock::duration::zero()) {
+            space.cancelWait();
+            return false;
+        }
+        space.waitFor(key, remaining);
+    }
+}
+
+void NodeImpl::scheduleLane(TopicLane* lane, size_t thread_id) {
+    RunQueue& run_queue = *run_queues_[thread_id];
+    {
+        std::lock_guard<std::mutex> lock(run_queue.mutex);
+        run_queue.lanes.push_back(lane);
+    }
+    scheduled_lanes_.fetch_add(1, std::memory_order_release);
+
+    // Wake a sleeping worker (no syscall unless one is sleeping); it steals if the lane is not its own
+    work_ready_.notify();
+}
+
+NodeImpl::TopicLane* NodeImpl::nextLane(size_t thread_id) {
+    if (scheduled_lanes_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    // Own run queue first, then steal the oldest lane of the next busy worker
+    const size_t num_workers = run_queues_.size();
+    for (size_t i = 0; i < num_workers; ++i) {
+        RunQueue& run_queue = *run_queues_[(thread_id + i) % num_workers];
+        std::lock_guard<std::mutex> lock(run_queue.mutex);
+        if (!run_queue.lanes.empty()) {
+            TopicLane* lane = run_queue.lanes.front();
+            run_queue.lanes.pop_front();
+            scheduled_lanes_.fetch_sub(1, std::memory_order_relaxed);
+            return lane;
         }
     }
+    return nullptr;
+}
 
-    // Notify the specific thread
-    message_queue_cvs_[thread_id].notify_one();
+void NodeImpl::applyWorkerScheduling(size_t thread_id) {
+    // Per-worker CPU sets and worker_priority take precedence over Config::threads.worker
+    ThreadPlacement placement = threads_config_.worker;
+    if (!worker_cpu_sets_.empty()) {
+        placement.cpu_mask = worker_cpu_sets_[thread_id % worker_cpu_sets_.size()];
+    }
+    if (worker_priority_ > 0) {
+        placement.policy = SchedPolicy::FIFO;
+        placement.priority = worker_priority_;
+    }
+    applyThreadPlacement(placement, "worker " + std::to_string(thread_id));
 }
 
 void NodeImpl::messageProcessingThread(size_t thread_id) {
     static constexpr size_t MAX_BATCH_SIZE = MAX_MESSAGE_BATCH_SIZE;
+    applyWorkerScheduling(thread_id);
+
     std::vector<PendingMessage> batch;
     batch.reserve(MAX_BATCH_SIZE);
 
     while (running_) {
-        batch.clear();
+        // Pick a lane with pending messages (sleep on the eventcount only when there is none)
+        TopicLane* lane = nextLane(thread_id);
+        if (!lane) {
+            uint32_t key = work_ready_.prepareWait();
+            if (!running_ || scheduled_lanes_.load(std::memory_order_acquire) != 0) {
+                work_ready_.cancelWait();
+            } else {
+                work_ready_.wait(key);
+            }
+            continue;
+        }
 
-        // Fetch a batch of messages (reduces lock contention)
-        {
-            std::unique_lock<std::mutex> lock(message_queue_mutexes_[thread_id]);
-            message_queue_cvs_[thread_id].wait(
-                lock, [this, thread_id] { return !running_ || !message_queues_[thread_id].empty(); });
+        // Fetch a batch of the lane's messages (lock-free; only this worker drains the lane now)
+        batch.clear();
+        PendingMessage pending;
+        while (batch.size() < MAX_BATCH_SIZE && lane->messages.tryPop(pending)) {
+            batch.push_back(std::move(pending));
+        }
+        if (!batch.empty()) {
+            pending_messages_.fetch_sub(batch.size(), std::memory_order_relaxed);
+        }
+        if (batch.size() < MAX_BATCH_SIZE && lane->takeLatest(pending)) {
+            batch.push_back(std::move(pending));  // After anything queued before a switch to LATEST
+        }
 
-            if (!running_) {
-                break;
-            }
+        const auto batch_start = std::chrono::steady_clock::now();
 
-            // Extract multiple messages at once
-            auto& queue = message_queues_[thread_id];
-            while (!queue.empty() && batch.size() < MAX_BATCH_SIZE) {
-                batch.push_back(std::move(queue.front()));
-                queue.pop();
+        // Get callback once per batch (all messages share the lane's topic); lock-free snapshot read
+        std::shared_ptr<const Callback> callback;
+        if (!batch.empty()) {
+            SubscriptionReader reader(subscription_snapshot_);
+            const SubscriptionSnapshot::Entry* entry = reader.get() ? reader.get()->find(lane->topic.id()) : nullptr;
+            if (entry) {
+                callback = entry->callback;
             }
         }
 
-        // Process all messages in batch (outside of queue lock)
-        for (const auto& msg : batch) {
-            // Get callback (subscription already verified in enqueueMessage)
-            Callback callback;
-            {
-                std::shared_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
-                const auto it = subscriptions_.find(msg.group);
-                if (it != subscriptions_.end()) {
-                    callback = it->second.callback;
-                }
+        // Process all messages in batch
+        size_t batch_bytes = 0;
+        size_t expired = 0;
+        for (auto& msg : batch) {
+            // Expired while queued: drop it rather than delay the fresh messages behind it
+            if (msg.deadline_ns != 0 && TraceStamp::now() > msg.deadline_ns) {
+                msg.payload.release();
+                expired++;
+                continue;
             }
-
+            const size_t payload_len = msg.payload.size();
+            batch_bytes += payload_len;
             // Invoke callback outside of lock
             if (callback) {
+                const uint64_t start_ns = msg.enqueue_ns != 0 ? TraceStamp::now() : 0;
+                NEXUS_TRACE3(callback_begin, msg.topic.id(), payload_len, 0);
                 try {
-                    callback(msg.group, msg.topic, msg.payload.data(), msg.payload.size());
+                    (*callback)(msg.topic.group(), msg.topic.topic(), msg.payload.data(), payload_len);
                 } catch (...) {
                     // Ignore callback exceptions to prevent thread crash
                 }
+                NEXUS_TRACE3(callback_end, msg.topic.id(), payload_len, 0);
+                if (start_ns != 0) {
+                    traceLatency(msg.topic.id(), TRACE_QUEUE, start_ns - msg.enqueue_ns);
+                    traceLatency(msg.topic.id(), TRACE_CALLBACK, TraceStamp::now() - start_ns);
+                }
+            }
+
+            // Buffer goes back to the pool once the last node sharing it is done
+            msg.payload.release();
+        }
+
+        if (!batch.empty()) {
+            auto elapsed = std::chrono::steady_clock::now() - batch_start;
+            if (expired > 0) {
+                countExpired(lane->topic.id(), expired);
+            }
+            if (callback && batch.size() > expired) {
+                const uint32_t topic_id = lane->topic.id();
+                topic_stats_.add(topic_id, DELIVERED, batch.size() - expired);
+                topic_stats_.add(topic_id, DELIVERED_BYTES, batch_bytes);
+                topic_stats_.add(topic_id, CALLBACK_NS,
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+            lane->batch_time_us.store(
+                static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+            lane->space.notifyAll();  // BLOCK producers (no syscall unless one is waiting)
+            pending_space_.notifyAll();
+            if (lane->above_high.load(std::memory_order_relaxed) &&
+                watermarks_enabled_.load(std::memory_order_relaxed)) {
+                checkLaneWatermark(*lane, Nexus::rpc::Config::instance().node.max_queue_size);
+            }
+        }
+
+        // Hand the lane back: still busy -> back of our run queue (other lanes get a turn, idle
+        // workers may steal it); drained -> release, re-taking it if a producer raced the release
+        if (lane->hasPending()) {
+            scheduleLane(lane, thread_id);
+        } else {
+            // RMW (not a store): synchronizes with producers that found the flag still set
+            lane->scheduled.exchange(false, std::memory_order_acq_rel);
+            if (lane->hasPending() && !lane->scheduled.exchange(true, std::memory_order_acq_rel)) {
+                scheduleLane(lane, thread_id);
             }
         }
     }
@@ -920,6 +2809,7 @@ void NodeImpl::messageProcessingThread(size_t thread_id) {
 // System message processing thread (dedicated, thread-safe)
 void NodeImpl::systemMessageThread() {
     NEXUS_DEBUG("IMPL") << "System message thread started for " << node_id_;
+    applyThreadPlacement(threads_config_.system, "system");
 
     while (system_running_.load()) {
         SystemMessage msg;
@@ -955,6 +2845,10 @@ void NodeImpl::systemMessageThread() {
                                          msg.payload.size(), false);
                     break;
 
+                case SystemMessageType::SERVICE_SNAPSHOT:
+                    handleServiceSnapshot(msg.source_node_id, msg.payload.data(), msg.payload.size());
+                    break;
+
                 case SystemMessageType::NODE_JOIN:
                     NEXUS_DEBUG("IMPL") << "Processing NODE_JOIN from " << msg.source_node_id;
                     handleNodeEvent(msg.source_node_id, true);
@@ -976,13 +2870,13 @@ void NodeImpl::systemMessageThread() {
 }
 
 // Enqueue system message (called from receive callback)
-void NodeImpl::enqueueSystemMessage(SystemMessageType type, const std::string& source_node_id, const std::string& group,
-                                    const std::string& topic, const uint8_t* payload, size_t payload_len) {
+void NodeImpl::enqueueSystemMessage(SystemMessageType type, StringView source_node_id, StringView group,
+                                    StringView topic, const uint8_t* payload, size_t payload_len) {
     SystemMessage msg;
     msg.type = type;
-    msg.source_node_id = source_node_id;
-    msg.group = group;
-    msg.topic = topic;
+    msg.source_node_id = source_node_id.str();
+    msg.group = group.str();
+    msg.topic = topic.str();
 
     if (payload && payload_len > 0) {
         msg.payload.assign(payload, payload + payload_len);
@@ -1005,17 +2899,106 @@ void NodeImpl::enqueueSystemMessage(SystemMessageType type, const std::string& s
     system_queue_cv_.notify_one();
 }
 
+void NodeImpl::addTopicSubscription(const TopicHandle& topic, SubscriptionInfo* info, DispatchMode dispatch,
+                                    bool matched) {
+    if (topic.id() >= topic_subscriptions_.size()) {
+        topic_subscriptions_.resize(topic.id() + 1);
+    }
+    topic_subscriptions_[topic.id()].info = info;
+    topic_subscriptions_[topic.id()].dispatch = dispatch;
+    topic_subscriptions_[topic.id()].matched = matched;
+
+    if (topic.id() >= lanes_.size()) {
+        lanes_.resize(topic.id() + 1);
+    }
+    if (!lanes_[topic.id()]) {
+        const auto& node_config = Nexus::rpc::Config::instance().node;
+        lanes_[topic.id()].reset(
+            new TopicLane(topic, std::min(node_config.per_topic_queue_size, node_config.max_queue_size)));
+    }
+}
+
+void NodeImpl::dropMatchedTopics(const SubscriptionInfo* info, bool all) {
+    for (size_t id = 0; id < topic_subscriptions_.size(); ++id) {
+        TopicSubscription& subscription = topic_subscriptions_[id];
+        if (subscription.info != info || (!all && !subscription.matched)) {
+            continue;
+        }
+        if (all || !info->matcher || !info->matcher->match(lanes_[id]->topic.topic())) {
+            subscription = TopicSubscription();
+        }
+    }
+}
+
+bool NodeImpl::subscribeMatchedTopic(const TopicHandle& topic) {
+    std::unique_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+    auto it = subscriptions_.find(topic.group());
+    if (it == subscriptions_.end() || !it->second.matcher) {
+        return false;
+    }
+    const DispatchMode* dispatch = it->second.matcher->match(topic.topic());
+    if (!dispatch) {
+        return false;
+    }
+    // Another thread may have got here first
+    if (topic.id() >= topic_subscriptions_.size() || !topic_subscriptions_[topic.id()].info) {
+        addTopicSubscription(topic, &it->second, *dispatch, true);
+        publishSubscriptionSnapshot();
+    }
+    return true;
+}
+
+void NodeImpl::publishSubscriptionSnapshot() {
+    // Caller holds subscriptions_mutex_ exclusively, so writers are serialized
+    std::unique_ptr<SubscriptionSnapshot> snapshot(new SubscriptionSnapshot());
+    snapshot->by_topic.resize(topic_subscriptions_.size());
+    for (size_t id = 0; id < topic_subscriptions_.size(); ++id) {
+        const TopicSubscription& subscription = topic_subscriptions_[id];
+        if (subscription.info) {
+            SubscriptionSnapshot::Entry& entry = snapshot->by_topic[id];
+            entry.callback = subscription.info->callback;
+            entry.polling = subscription.info->polling;
+            entry.dispatch = subscription.dispatch;
+            entry.lane = lanes_[id].get();  // Every subscribed topic has a lane
+            snapshot->ids[entry.lane->topic.group()][entry.lane->topic.topic()] = static_cast<uint32_t>(id);
+        }
+    }
+    std::vector<std::string> pattern_groups;
+    for (const auto& group : subscriptions_) {
+        if (group.second.matcher) {
+            snapshot->patterns[group.first] = group.second.matcher;
+            pattern_groups.push_back(group.first);
+        }
+    }
+
+    // Same set for other in-process nodes, so their publishes reach us without visiting every node
+    std::vector<uint32_t> topic_ids;
+    for (size_t id = 0; id < snapshot->by_topic.size(); ++id) {
+        if (snapshot->by_topic[id].subscribed()) {
+            topic_ids.push_back(static_cast<uint32_t>(id));
+        }
+    }
+    subscription_snapshot_.publish(std::move(snapshot));
+    Nexus::rpc::GlobalRegistry::instance().setSubscriptions(node_id_, std::move(topic_ids), std::move(pattern_groups));
+}
+
 NodeImpl::QueueStats NodeImpl::getQueueStats() const {
     QueueStats stats = {};
 
-    // Get current queue depth for each thread
-    for (size_t i = 0; i < NUM_PROCESSING_THREADS; ++i) {
-        std::lock_guard<std::mutex> lock(message_queue_mutexes_[i]);
-        stats.queue_depth[i] = message_queues_[i].size();
+    // Get current queue depth for each thread (lanes counted on their home worker)
+    stats.queue_depth.assign(run_queues_.size(), 0);
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+        for (const auto& lane : lanes_) {
+            if (lane) {
+                stats.queue_depth[lane->topic.id() % run_queues_.size()] += lane->messages.size();
+            }
+        }
     }
 
     // Get total dropped messages
     stats.total_dropped = dropped_messages_.load(std::memory_order_relaxed);
+    stats.total_expired = expired_messages_.load(std::memory_order_relaxed);
 
     return stats;
 }
@@ -1029,6 +3012,256 @@ void NodeImpl::setQueueOverflowCallback(QueueOverflowCallback callback) {
     overflow_callback_ = callback;
 }
 
+Node::Error NodeImpl::setWatermarks(uint32_t high_percent, uint32_t low_percent) {
+    if (low_percent >= high_percent || high_percent > 100) {
+        return INVALID_ARG;
+    }
+    watermark_high_percent_.store(high_percent, std::memory_order_relaxed);
+    watermark_low_percent_.store(low_percent, std::memory_order_relaxed);
+    return NO_ERROR;
+}
+
+void NodeImpl::setWatermarkCallback(WatermarkCallback callback) {
+    const bool enabled = static_cast<bool>(callback);
+    {
+        std::lock_guard<std::mutex> cb_lock(watermark_callback_mutex_);
+        watermark_callback_ = std::move(callback);
+    }
+    watermarks_enabled_.store(enabled, std::memory_order_relaxed);
+
+    // Ring sampling runs only while someone listens; cancel() waits for a run in progress
+    std::lock_guard<std::mutex> lock(watermark_task_mutex_);
+    auto& scheduler = MaintenanceScheduler::instance();
+    if (enabled && watermark_task_ == MaintenanceScheduler::NO_TASK) {
+        rings_above_high_.clear();
+        const auto interval = std::chrono::milliseconds(Nexus::rpc::Config::instance().node.watermark_poll_ms);
+        watermark_task_ = scheduler.schedule(interval, [this] { pollWatermarks(); });
+    } else if (!enabled && watermark_task_ != MaintenanceScheduler::NO_TASK) {
+        scheduler.cancel(watermark_task_);
+        watermark_task_ = MaintenanceScheduler::NO_TASK;
+    }
+}
+
+bool NodeImpl::crossedWatermark(bool above_high, size_t level, size_t capacity) const {
+    if (capacity == 0) {
+        return false;
+    }
+    return above_high ? level * 100 <= capacity * watermark_low_percent_.load(std::memory_order_relaxed)
+                      : level * 100 >= capacity * watermark_high_percent_.load(std::memory_order_relaxed);
+}
+
+void NodeImpl::checkLaneWatermark(TopicLane& lane, size_t max_queue_size) {
+    const size_t capacity = std::min(lane.messages.capacity(), max_queue_size);
+    const size_t depth = lane.messages.size();
+    const bool above_high = lane.above_high.load(std::memory_order_relaxed);
+    // The exchange settles producers and the draining worker racing on the same crossing
+    if (!crossedWatermark(above_high, depth, capacity) ||
+        lane.above_high.exchange(!above_high, std::memory_order_relaxed) != above_high) {
+        return;
+    }
+    WatermarkEvent event;
+    event.source = WatermarkSource::WORKER_QUEUE;
+    event.high = !above_high;
+    event.group = lane.topic.group();
+    event.name = lane.topic.topic();
+    event.level = depth;
+    event.capacity = capacity;
+    notifyWatermark(event);
+}
+
+void NodeImpl::notifyWatermark(const WatermarkEvent& event) {
+    std::lock_guard<std::mutex> cb_lock(watermark_callback_mutex_);
+    if (watermark_callback_) {
+        try {
+            watermark_callback_(event);
+        } catch (...) {
+            // Ignore callback exceptions
+        }
+    }
+}
+
+void NodeImpl::pollWatermarks() {
+    std::vector<WatermarkEvent> events;
+    auto sample = [&](const std::string& key, WatermarkEvent event) {
+        const bool above_high = rings_above_high_.count(key) != 0;
+        if (!crossedWatermark(above_high, event.level, event.capacity)) {
+            return;
+        }
+        if (above_high) {
+            rings_above_high_.erase(key);
+        } else {
+            rings_above_high_.insert(key);
+        }
+        event.high = !above_high;
+        events.push_back(std::move(event));
+    };
+
+    std::set<std::string> present;
+    if (shm_transport_v3_) {
+        for (const auto& ring : shm_transport_v3_->getOutboundFill()) {
+            const std::string key = "shm/" + ring.node_id + "/" + std::to_string(ring.lane);
+            present.insert(key);
+            WatermarkEvent event;
+            event.source = WatermarkSource::SHM_RING;
+            event.name = ring.node_id;
+            event.lane = ring.lane;
+            event.level = ring.used;
+            event.capacity = ring.capacity;
+            sample(key, std::move(event));
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(large_channels_mutex_);
+        for (const auto& entry : large_channels_) {
+            const std::string key = "large/" + entry.first;
+            present.insert(key);
+            WatermarkEvent event;
+            event.source = WatermarkSource::LARGE_DATA_RING;
+            event.name = entry.first;
+            event.capacity = entry.second->getCapacity();
+            event.level = event.capacity - std::min(event.capacity, entry.second->getAvailableSpace());
+            sample(key, std::move(event));
+        }
+    }
+    // Rings that went away (peer left, channel removed) report nothing more
+    for (auto it = rings_above_high_.begin(); it != rings_above_high_.end();) {
+        it = present.count(*it) ? std::next(it) : rings_above_high_.erase(it);
+    }
+
+    for (const auto& event : events) {
+        notifyWatermark(event);
+    }
+}
+
+uint32_t NodeImpl::getRetryHintUs() const {
+    return t_retry_hint_us;
+}
+
+std::vector<TopicStats> NodeImpl::getTopicStats() const {
+    std::vector<TopicStats> result;
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const uint32_t limit = topic_stats_.keyLimit();
+    uint64_t counters[TOPIC_COUNTERS];
+    for (uint32_t id = 0; id < limit; ++id) {
+        if (!topic_stats_.read(id, counters) ||
+            std::all_of(counters, counters + TOPIC_COUNTERS, [](uint64_t value) { return value == 0; })) {
+            continue;
+        }
+        const TopicHandle topic = registry.topicById(id);
+        if (!topic.valid()) {
+            continue;
+        }
+        TopicStats stats;
+        stats.group = topic.group();
+        stats.topic = topic.topic();
+        stats.published = counters[PUBLISHED];
+        stats.published_bytes = counters[PUBLISHED_BYTES];
+        stats.delivered = counters[DELIVERED];
+        stats.delivered_bytes = counters[DELIVERED_BYTES];
+        stats.dropped = counters[DROPPED];
+        stats.expired = counters[EXPIRED];
+        stats.callback_ns = counters[CALLBACK_NS];
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void NodeImpl::traceLatency(uint32_t topic_id, TraceStage stage, uint64_t ns) {
+    // Bucket i: [2^i, 2^(i+1)) ns
+    const size_t bucket = ns > 1 ? std::min<size_t>(63 - __builtin_clzll(ns), TopicLatency::BUCKETS - 1) : 0;
+    const size_t base = stage * TRACE_STAGE_COUNTERS;
+    trace_stats_.add(topic_id, base + bucket);
+    trace_stats_.add(topic_id, base + TopicLatency::BUCKETS, ns);
+}
+
+std::vector<TopicLatency> NodeImpl::getTopicLatency() const {
+    std::vector<TopicLatency> result;
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const uint32_t limit = trace_stats_.keyLimit();
+    uint64_t counters[TRACE_STAGES * TRACE_STAGE_COUNTERS];
+    for (uint32_t id = 0; id < limit; ++id) {
+        if (!trace_stats_.read(id, counters)) {
+            continue;
+        }
+        const TopicHandle topic = registry.topicById(id);
+        if (!topic.valid()) {
+            continue;
+        }
+        TopicLatency latency;
+        TopicLatency::Histogram* stages[TRACE_STAGES] = {&latency.transit, &latency.receive, &latency.queue,
+                                                         &latency.callback};
+        uint64_t samples = 0;
+        for (size_t stage = 0; stage < TRACE_STAGES; ++stage) {
+            const uint64_t* values = counters + stage * TRACE_STAGE_COUNTERS;
+            TopicLatency::Histogram& histogram = *stages[stage];
+            for (size_t i = 0; i < TopicLatency::BUCKETS; ++i) {
+                histogram.buckets[i] = values[i];
+                histogram.count += values[i];
+            }
+            histogram.total_ns = values[TopicLatency::BUCKETS];
+            samples += histogram.count;
+        }
+        if (samples == 0) {
+            continue;
+        }
+        latency.group = topic.group();
+        latency.topic = topic.topic();
+        result.push_back(std::move(latency));
+    }
+    return result;
+}
+
+MemoryUsage NodeImpl::getMemoryUsage() const {
+    MemoryUsage usage;
+    auto region = [](const std::string& name, const MappingUsage& mapping) {
+        MappedRegion out;
+        out.name = name;
+        out.mapped = mapping.mapped;
+        out.resident = mapping.resident;
+        return out;
+    };
+
+    if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+        const SharedMemoryTransportV3::SegmentUsage own = shm_transport_v3_->getSegmentUsage();
+        usage.shm_segment = region(own.node_id, own.usage);
+        for (const auto& peer : shm_transport_v3_->getPeerSegmentUsage()) {
+            usage.shm_peers.push_back(region(peer.node_id, peer.usage));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(large_channels_mutex_);
+        for (const auto& entry : large_channels_) {
+            usage.large_writers.push_back(region(entry.first, entry.second->getMemoryUsage()));
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        for (const auto* readers : {&large_readers_, &large_bridges_}) {
+            for (const auto& entry : *readers) {
+                if (entry.second->channel) {
+                    usage.large_readers.push_back(region(entry.first, entry.second->channel->getMemoryUsage()));
+                }
+            }
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+        for (const auto& lane : lanes_) {
+            if (lane) {
+                usage.queued_messages += lane->messages.size() + (lane->has_latest.load() ? 1 : 0);
+                // Each queue slot is an entry plus its sequence counter
+                const size_t slot_bytes = sizeof(PendingMessage) + sizeof(std::atomic<size_t>);
+                usage.queue_bytes += sizeof(TopicLane) + lane->messages.capacity() * slot_bytes;
+            }
+        }
+    }
+    usage.pool_bytes = payloadPool().allocatedSlots() * MessagePool::SLOT_SIZE;
+    usage.process_resident = processResidentBytes();
+    return usage;
+}
+
 size_t NodeImpl::cleanupOrphanedChannels() {
     size_t total_cleaned = 0;
 
@@ -1054,70 +3287,461 @@ size_t NodeImpl::cleanupOrphanedChannels() {
             i_am_cleanup_master = true;
         }
     }
-
-    if (!i_am_cleanup_master) {
-        // Not my turn to cleanup, skip
-        NEXUS_DEBUG("IMPL") << "Cleanup skipped: not the cleanup master (PID " << my_pid << ")";
-        return 0;
+
+    if (!i_am_cleanup_master) {
+        // Not my turn to cleanup, skip
+        NEXUS_DEBUG("IMPL") << "Cleanup skipped: not the cleanup master (PID " << my_pid << ")";
+        return 0;
+    }
+
+    NEXUS_DEBUG("IMPL") << "I am the cleanup master (PID " << my_pid << "), performing cleanup...";
+
+    // 1. Cleanup LargeDataChannel orphaned shared memory
+    size_t channel_cleaned = LargeDataChannel::cleanupOrphanedChannels(CLEANUP_ORPHAN_TIMEOUT_SECONDS);
+    total_cleaned += channel_cleaned;
+
+    // 2. Cleanup SharedMemoryTransportV3 orphaned node shared memory
+    if (SharedMemoryTransportV3::cleanupOrphanedMemory()) {
+        NEXUS_DEBUG("IMPL") << "Cleaned up orphaned transport memory";
+    }
+
+    return total_cleaned;
+}
+
+void NodeImpl::runCleanup() {
+    size_t cleaned = cleanupOrphanedChannels();
+    if (cleaned > 0) {
+        NEXUS_INFO("IMPL") << "Background cleanup: removed " << cleaned << " orphaned channel(s)";
+    }
+    // Metrics segments are owned by one process each: any node may remove those of dead processes
+    size_t metrics_cleaned = MetricsSegment::removeOrphaned();
+    if (metrics_cleaned > 0) {
+        NEXUS_DEBUG("IMPL") << "Background cleanup: removed " << metrics_cleaned << " orphaned metrics segment(s)";
+    }
+}
+
+void NodeImpl::publishMetrics() {
+    MetricsLayout& out = *metrics_segment_->layout();
+    uint64_t node[MetricsLayout::NODE_METRICS] = {};
+
+    // Worker queues, and the queue depth per topic
+    std::unordered_map<uint32_t, uint64_t> topic_depth;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(subscriptions_mutex_);
+        for (const auto& lane : lanes_) {
+            if (lane) {
+                const uint64_t depth = lane->messages.size();
+                topic_depth[lane->topic.id()] += depth;
+                node[MetricsLayout::WORKER_QUEUE_DEPTH] += depth;
+            }
+        }
+    }
+    node[MetricsLayout::WORKER_DROPPED] = dropped_messages_.load(std::memory_order_relaxed);
+
+    if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+        const SharedMemoryTransportV3::TransportStats shm = shm_transport_v3_->getStats();
+        node[MetricsLayout::SHM_SENT] = shm.messages_sent;
+        node[MetricsLayout::SHM_RECEIVED] = shm.messages_received;
+        node[MetricsLayout::SHM_DROPPED] = shm.messages_dropped;
+        node[MetricsLayout::SHM_BYTES_SENT] = shm.bytes_sent;
+        node[MetricsLayout::SHM_BYTES_RECEIVED] = shm.bytes_received;
+        node[MetricsLayout::SHM_INBOUND_QUEUES] = static_cast<uint64_t>(std::max(shm.inbound_queues, 0));
+        node[MetricsLayout::SHM_INBOX_DEPTH] = shm.inbox_depth;
+        for (uint32_t lane = 0; lane < SharedMemoryTransportV3::DATA_LANES; ++lane) {
+            node[MetricsLayout::SHM_DEPTH_HIGH + lane] = shm.lanes[lane].depth;
+            node[MetricsLayout::SHM_DROPPED_HIGH + lane] = shm.lanes[lane].messages_dropped;
+        }
+        node[MetricsLayout::SHM_MAX_CONGESTION] = shm.max_congestion_level;
+    }
+
+    // Large data readers
+    struct ReaderRow {
+        std::string name;
+        LargeDataChannel::Stats stats;
+    };
+    std::vector<ReaderRow> readers;
+    {
+        std::lock_guard<std::mutex> lock(large_readers_mutex_);
+        for (const auto& entry : large_readers_) {
+            if (readers.size() == MetricsLayout::MAX_LARGE_READERS) {
+                break;
+            }
+            if (entry.second->channel) {
+                readers.push_back({entry.first, entry.second->channel->getStats()});
+            }
+        }
+    }
+
+    metrics_segment_->beginUpdate();
+    for (size_t i = 0; i < MetricsLayout::NODE_METRICS; ++i) {
+        out.node[i].store(node[i], std::memory_order_relaxed);
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const uint32_t limit = topic_stats_.keyLimit();
+    uint64_t counters[TOPIC_COUNTERS];
+    uint32_t topics = 0;
+    for (uint32_t id = 0; id < limit && topics < MetricsLayout::MAX_TOPICS; ++id) {
+        if (!topic_stats_.read(id, counters)) {
+            continue;
+        }
+        const auto depth = topic_depth.find(id);
+        const uint64_t queued = depth != topic_depth.end() ? depth->second : 0;
+        if (queued == 0 && std::all_of(counters, counters + TOPIC_COUNTERS, [](uint64_t v) { return v == 0; })) {
+            continue;
+        }
+        const TopicHandle topic = registry.topicById(id);
+        if (!topic.valid()) {
+            continue;
+        }
+        MetricsLayout::TopicEntry& entry = out.topics[topics++];
+        std::snprintf(entry.name, sizeof(entry.name), "%s/%s", topic.group().c_str(), topic.topic().c_str());
+        entry.values[MetricsLayout::TOPIC_PUBLISHED].store(counters[PUBLISHED], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_PUBLISHED_BYTES].store(counters[PUBLISHED_BYTES], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_DELIVERED].store(counters[DELIVERED], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_DELIVERED_BYTES].store(counters[DELIVERED_BYTES], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_DROPPED].store(counters[DROPPED], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_CALLBACK_NS].store(counters[CALLBACK_NS], std::memory_order_relaxed);
+        entry.values[MetricsLayout::TOPIC_QUEUE_DEPTH].store(queued, std::memory_order_relaxed);
+    }
+    out.topic_count.store(topics, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < readers.size(); ++i) {
+        MetricsLayout::LargeReaderEntry& entry = out.large_readers[i];
+        std::snprintf(entry.name, sizeof(entry.name), "%s", readers[i].name.c_str());
+        entry.values[MetricsLayout::READER_LAG_BYTES].store(readers[i].stats.reader_lag, std::memory_order_relaxed);
+        entry.values[MetricsLayout::READER_CAPACITY].store(readers[i].stats.capacity, std::memory_order_relaxed);
+        entry.values[MetricsLayout::READER_BYTES_READ].store(readers[i].stats.total_bytes_read,
+                                                             std::memory_order_relaxed);
+    }
+    out.large_reader_count.store(static_cast<uint32_t>(readers.size()), std::memory_order_relaxed);
+
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    out.update_ms.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count()),
+                        std::memory_order_relaxed);
+    metrics_segment_->endUpdate();
+}
+
+// ==================== Discovery Cache ====================
+
+std::vector<uint8_t> NodeImpl::buildDiscoveryCache() const {
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const auto services = registry.getServices();
+
+    // Services of other processes only: nodes in this process register their own again at startup
+    std::vector<uint8_t> entries;
+    uint32_t service_count = 0;
+    for (const auto& svc : services->all()) {
+        if ((svc.transport != TransportType::SHARED_MEMORY && svc.transport != TransportType::UDP) ||
+            svc.node_id == node_id_ || svc.node_id.size() > 0xFF || svc.group.size() > 0xFF ||
+            svc.topic.size() > 0xFF || registry.findNode(svc.node_id)) {
+            continue;
+        }
+        const std::vector<uint8_t>& desc = serializeService(svc);
+        entries.push_back(static_cast<uint8_t>(svc.node_id.size()));
+        entries.push_back(static_cast<uint8_t>(svc.group.size()));
+        entries.push_back(static_cast<uint8_t>(svc.topic.size()));
+        putU16(entries, static_cast<uint16_t>(desc.size()));
+        entries.insert(entries.end(), svc.node_id.begin(), svc.node_id.end());
+        entries.insert(entries.end(), svc.group.begin(), svc.group.end());
+        entries.insert(entries.end(), svc.topic.begin(), svc.topic.end());
+        entries.insert(entries.end(), desc.begin(), desc.end());
+        ++service_count;
+    }
+
+    std::vector<uint8_t> out;
+    putU32(out, DISCOVERY_CACHE_MAGIC);
+    putU32(out, DISCOVERY_CACHE_FORMAT);
+    putU32(out, service_count);
+    out.insert(out.end(), entries.begin(), entries.end());
+
+    std::lock_guard<std::mutex> lock(remote_nodes_mutex_);
+    size_t count_offset = out.size();
+    putU32(out, 0);
+    uint32_t endpoint_count = 0;
+    for (const auto& entry : remote_nodes_) {
+        const RemoteNodeInfo& info = entry.second;
+        if (info.node_id.size() > 0xFF || info.address.size() > 0xFF) {
+            continue;
+        }
+        out.push_back(static_cast<uint8_t>(info.node_id.size()));
+        out.push_back(static_cast<uint8_t>(info.address.size()));
+        putU16(out, info.port);
+        out.insert(out.end(), info.node_id.begin(), info.node_id.end());
+        out.insert(out.end(), info.address.begin(), info.address.end());
+        ++endpoint_count;
+    }
+    for (int shift = 0; shift < 32; shift += 8) {
+        out[count_offset + shift / 8] = static_cast<uint8_t>((endpoint_count >> shift) & 0xFF);
+    }
+    return out;
+}
+
+void NodeImpl::saveDiscoveryCache() {
+    std::vector<uint8_t> contents = buildDiscoveryCache();
+    if (contents == discovery_cache_written_) {
+        return;
+    }
+
+    // Write aside and rename: a crash never leaves a torn file, and nodes sharing the path do not interleave
+    const std::string tmp_path = discovery_cache_path_ + "." + node_id_ + "." + std::to_string(getpid());
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+        if (!file) {
+            NEXUS_WARN("IMPL") << "Failed to write discovery cache " << tmp_path;
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp_path.c_str(), discovery_cache_path_.c_str()) != 0) {
+        NEXUS_WARN("IMPL") << "Failed to replace discovery cache " << discovery_cache_path_ << ": "
+                           << strerror(errno);
+        std::remove(tmp_path.c_str());
+        return;
+    }
+    discovery_cache_written_.swap(contents);
+}
+
+void NodeImpl::loadDiscoveryCache() {
+    if (discovery_cache_path_.empty()) {
+        return;
+    }
+    std::ifstream file(discovery_cache_path_, std::ios::binary);
+    if (!file) {
+        return;  // First start
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 12 || getU32(data.data()) != DISCOVERY_CACHE_MAGIC ||
+        getU32(data.data() + 4) != DISCOVERY_CACHE_FORMAT) {
+        NEXUS_WARN("IMPL") << "Ignoring discovery cache " << discovery_cache_path_ << " (unknown format)";
+        return;
+    }
+
+    std::vector<ServiceDescriptor> services;
+    const uint32_t service_count = getU32(data.data() + 8);
+    size_t offset = 12;
+    for (uint32_t i = 0; i < service_count; ++i) {
+        if (data.size() < offset + 5) {
+            return;  // Truncated: use none of it
+        }
+        const uint8_t node_len = data[offset];
+        const uint8_t group_len = data[offset + 1];
+        const uint8_t topic_len = data[offset + 2];
+        const uint16_t desc_len = getU16(data.data() + offset + 3);
+        offset += 5;
+        if (data.size() < offset + node_len + group_len + topic_len + desc_len) {
+            return;
+        }
+        const char* text = reinterpret_cast<const char*>(data.data() + offset);
+        ServiceDescriptor svc;
+        svc.node_id.assign(text, node_len);
+        svc.group.assign(text + node_len, group_len);
+        svc.topic.assign(text + node_len + group_len, topic_len);
+        offset += node_len + group_len + topic_len;
+        uint32_t unused_version = 0;
+        if (parseService(data.data() + offset, desc_len, svc, unused_version)) {
+            services.push_back(std::move(svc));
+        }
+        offset += desc_len;
+    }
+
+    std::map<std::string, RemoteNodeInfo> endpoints;
+    if (data.size() >= offset + 4) {
+        const uint32_t endpoint_count = getU32(data.data() + offset);
+        offset += 4;
+        for (uint32_t i = 0; i < endpoint_count && data.size() >= offset + 4; ++i) {
+            const uint8_t node_len = data[offset];
+            const uint8_t address_len = data[offset + 1];
+            RemoteNodeInfo info;
+            info.port = getU16(data.data() + offset + 2);
+            offset += 4;
+            if (data.size() < offset + node_len + address_len) {
+                break;
+            }
+            const char* text = reinterpret_cast<const char*>(data.data() + offset);
+            info.node_id.assign(text, node_len);
+            info.address.assign(text + node_len, address_len);
+            offset += node_len + address_len;
+            endpoints[info.node_id] = info;
+        }
+    }
+
+    // Only nodes that may still be there: shm nodes still in the registry, and UDP nodes with a known
+    // endpoint (its heartbeat timeout drops them if they are gone). Peers that already answered our
+    // service query are current and keep what they sent
+    std::set<std::string> live_shm_nodes;
+    if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+        for (auto& node_id : shm_transport_v3_->getLocalNodes()) {
+            live_shm_nodes.insert(std::move(node_id));
+        }
+    }
+    std::set<std::string> synced_nodes;
+    {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        for (const auto& peer : peer_services_) {
+            if (peer.second.synced) {
+                synced_nodes.insert(peer.first);
+            }
+        }
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    std::vector<ServiceDescriptor> loaded;
+    std::map<std::string, RemoteNodeInfo> udp_nodes;
+    for (auto& svc : services) {
+        if (svc.node_id == node_id_ || synced_nodes.count(svc.node_id) > 0 || registry.findNode(svc.node_id)) {
+            continue;
+        }
+        if (svc.transport == TransportType::SHARED_MEMORY) {
+            if (live_shm_nodes.count(svc.node_id) == 0) {
+                continue;
+            }
+        } else if (svc.transport == TransportType::UDP && use_udp_) {
+            auto endpoint = endpoints.find(svc.node_id);
+            if (endpoint != endpoints.end()) {
+                udp_nodes[svc.node_id] = endpoint->second;
+            } else {
+                // No heartbeat seen before the restart: the service's own address stands in
+                const size_t colon = svc.udp_address.rfind(':');
+                if (colon == std::string::npos) {
+                    continue;
+                }
+                RemoteNodeInfo info;
+                info.node_id = svc.node_id;
+                info.address = svc.udp_address.substr(0, colon);
+                info.port = static_cast<uint16_t>(std::atoi(svc.udp_address.c_str() + colon + 1));
+                udp_nodes.emplace(svc.node_id, info);
+            }
+        } else {
+            continue;
+        }
+        loaded.push_back(std::move(svc));
+    }
+    if (loaded.empty()) {
+        return;
     }
 
-    NEXUS_DEBUG("IMPL") << "I am the cleanup master (PID " << my_pid << "), performing cleanup...";
-
-    // 1. Cleanup LargeDataChannel orphaned shared memory
-    size_t channel_cleaned = LargeDataChannel::cleanupOrphanedChannels(CLEANUP_ORPHAN_TIMEOUT_SECONDS);
-    total_cleaned += channel_cleaned;
-
-    // 2. Cleanup SharedMemoryTransportV3 orphaned node shared memory
-    if (SharedMemoryTransportV3::cleanupOrphanedMemory()) {
-        NEXUS_DEBUG("IMPL") << "Cleaned up orphaned transport memory";
+    // UDP nodes count as just heard from: the heartbeat timeout revalidates them
+    {
+        std::lock_guard<std::mutex> lock(remote_nodes_mutex_);
+        for (auto& entry : udp_nodes) {
+            entry.second.last_heartbeat = std::chrono::steady_clock::now();
+            remote_nodes_.emplace(entry.first, entry.second);
+        }
     }
-
-    return total_cleaned;
+    {
+        std::lock_guard<std::mutex> lock(cached_services_mutex_);
+        for (const auto& svc : loaded) {
+            cached_services_[svc.getServiceKey()] = svc;
+        }
+        cached_services_deadline_ =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(DISCOVERY_CACHE_REVALIDATE_MS);
+    }
+    for (const auto& svc : loaded) {
+        registry.registerService(svc.group, svc);
+        handleServiceUpdate(svc.node_id, svc, true);
+    }
+    NEXUS_INFO("IMPL") << "Loaded " << loaded.size() << " service(s) from discovery cache " << discovery_cache_path_;
 }
 
-void NodeImpl::cleanupThreadFunc() {
-    NEXUS_LOG_INFO("IMPL", "Background cleanup thread started for node " + node_id_);
-
-    while (cleanup_running_) {
-        // Sleep for 5 minutes
-        for (int i = 0; i < CLEANUP_INTERVAL_SECONDS && cleanup_running_; ++i) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+void NodeImpl::confirmCachedService(const ServiceDescriptor& svc) {
+    // Same match as GlobalRegistry::unregisterService(): expiring the entry would remove this one too
+    std::lock_guard<std::mutex> lock(cached_services_mutex_);
+    for (auto it = cached_services_.begin(); it != cached_services_.end();) {
+        const ServiceDescriptor& cached = it->second;
+        if (cached.node_id == svc.node_id && cached.group == svc.group && cached.topic == svc.topic) {
+            it = cached_services_.erase(it);
+        } else {
+            ++it;
         }
+    }
+}
 
-        if (!cleanup_running_) {
-            break;
+void NodeImpl::confirmCachedNode(const std::string& node_id) {
+    std::lock_guard<std::mutex> lock(cached_services_mutex_);
+    for (auto it = cached_services_.begin(); it != cached_services_.end();) {
+        if (it->second.node_id == node_id) {
+            it = cached_services_.erase(it);
+        } else {
+            ++it;
         }
+    }
+}
 
-        // Perform cleanup
-        size_t cleaned = cleanupOrphanedChannels();
-        if (cleaned > 0) {
-            NEXUS_INFO("IMPL") << "Background cleanup: removed " << cleaned << " orphaned channel(s)";
+void NodeImpl::expireCachedServices() {
+    std::vector<ServiceDescriptor> expired;
+    {
+        std::lock_guard<std::mutex> lock(cached_services_mutex_);
+        if (cached_services_.empty() || std::chrono::steady_clock::now() < cached_services_deadline_) {
+            return;
         }
+        for (auto& entry : cached_services_) {
+            expired.push_back(std::move(entry.second));
+        }
+        cached_services_.clear();
     }
 
-    NEXUS_LOG_INFO("IMPL", "Background cleanup thread stopped for node " + node_id_);
+    // Not re-announced by a node that is otherwise alive: it dropped the service while we were down
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    for (const auto& svc : expired) {
+        registry.unregisterService(svc.group, svc);
+        handleServiceUpdate(svc.node_id, svc, false);
+    }
+    NEXUS_DEBUG("IMPL") << "Dropped " << expired.size() << " unconfirmed service(s) from the discovery cache";
 }
 
 // ==================== Service Discovery Implementation ====================
 
 void NodeImpl::queryRemoteServices() {
     //  Query existing services from other processes via shared memory
-    // Strategy: Broadcast a special request, and existing nodes will reply with their services
+    // Strategy: ask each node for a snapshot of its services (SERVICE_SNAPSHOT frames)
 
     if (!shm_transport_v3_ || !shm_transport_v3_->isInitialized()) {
         return;
     }
 
-    // Send empty SERVICE_REGISTER message as a query (payload_len = 0 means "query")
-    // Other nodes will respond by re-broadcasting their services
-    std::vector<uint8_t> query_packet =
-        MessageBuilder::build(node_id_, "", "", nullptr, 0, 0, MessageType::SERVICE_REGISTER);
+    std::vector<std::string> peers;
+    for (auto& node_id : shm_transport_v3_->getLocalNodes()) {
+        if (node_id != node_id_) {
+            peers.push_back(std::move(node_id));
+        }
+    }
+    std::unique_lock<std::mutex> lock(service_query_mutex_);
+    service_query_pending_.clear();
+    service_query_pending_.insert(peers.begin(), peers.end());
+    std::vector<uint32_t> known_versions;
+    for (const auto& node_id : peers) {
+        auto it = peer_services_.find(node_id);
+        known_versions.push_back(it != peer_services_.end() && it->second.synced ? it->second.version : 0);
+    }
+    lock.unlock();
+
+    // Point-to-point rather than broadcast: connections to existing nodes are still being set up
+    // asynchronously, and send() connects on demand
+    for (size_t i = 0; i < peers.size(); ++i) {
+        requestServiceSnapshot(peers[i], known_versions[i]);
+    }
 
-    shm_transport_v3_->broadcast(query_packet.data(), query_packet.size());
+    // Wait until every peer has answered (last snapshot frame), so the caller starts out knowing the
+    // existing services; peers that never answer (older versions) cost 100ms
+    lock.lock();
+    service_query_cv_.wait_for(lock, std::chrono::milliseconds(100), [this] { return service_query_pending_.empty(); });
+    service_query_pending_.clear();
+}
 
-    // Note: No sleep here - let the receive loop handle incoming service registrations
-    // The test application should wait before starting to send data messages
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+void NodeImpl::requestServiceSnapshot(const std::string& to_node, uint32_t known_version) {
+    std::vector<uint8_t> query;
+    putU32(query, known_version);
+    PacketView packet = MessageBuilder::buildView(node_id_, "", "", query.data(), query.size(), getUdpPort(),
+                                                  MessageType::SERVICE_REGISTER);
+    if (!shm_transport_v3_ || !shm_transport_v3_->isInitialized() ||
+        !shm_transport_v3_->send(to_node, packet.data(), packet.size())) {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        if (service_query_pending_.erase(to_node) > 0 && service_query_pending_.empty()) {
+            service_query_cv_.notify_all();
+        }
+    }
 }
 
 void NodeImpl::registerService(const ServiceDescriptor& svc) {
@@ -1164,7 +3788,7 @@ void NodeImpl::broadcastNodeEvent(bool is_joined) {
     NEXUS_DEBUG("IMPL") << "Broadcasting " << (is_joined ? "NODE_JOIN" : "NODE_LEAVE") << " event from " << node_id_;
 
     // Node event message has empty payload (node_id is in message header)
-    auto packet = MessageBuilder::build(node_id_, "", "", nullptr, 0, getUdpPort(), msg_type);
+    PacketView packet = MessageBuilder::buildView(node_id_, "", "", nullptr, 0, getUdpPort(), msg_type);
 
     int sent_count = shm_transport_v3_->broadcast(packet.data(), packet.size());
 
@@ -1184,19 +3808,28 @@ void NodeImpl::handleNodeEvent(const std::string& from_node, bool is_joined) {
     // Notify all listeners in this node
     notifyNodeEvent(event, from_node);
 
+    // Cached inter-process routes may point at (or miss) this node
+    Nexus::rpc::GlobalRegistry::instance().invalidateRoutes();
+
+    // A (re)joining node counts its service versions from the start again
+    {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        peer_services_.erase(from_node);
+        service_snapshots_.erase(from_node);
+    }
+
     if (!is_joined) {
         // Node left: Clean up its services from global registry
         // For cross-process nodes, we need to manually clean up services
         // because GlobalRegistry doesn't know about remote node disconnections
         auto& registry = Nexus::rpc::GlobalRegistry::instance();
-        auto all_services = registry.findServices();
+        const auto services = registry.getServices();
 
         // Remove all services registered by the departed node
-        for (const auto& svc : all_services) {
-            if (svc.node_id == from_node) {
-                registry.unregisterService(svc.group, svc);
-            }
+        for (const auto& svc : services->node(from_node)) {
+            registry.unregisterService(svc.group, svc);
         }
+        confirmCachedNode(from_node);
 
         // 🔧 修复: 断开与离开节点的共享内存连接
         // 当节点重新加入时,需要重新建立连接(新的共享内存地址)
@@ -1207,30 +3840,14 @@ void NodeImpl::handleNodeEvent(const std::string& from_node, bool is_joined) {
 }
 
 void NodeImpl::broadcastServiceUpdate(const ServiceDescriptor& svc, bool is_add) {
-    // Serialize service descriptor to payload
-    // Format: type(1byte) + transport(1byte) + channel_name_len(1byte) + udp_addr_len(2bytes) + channel_name +
-    // udp_address
-    std::vector<uint8_t> payload;
-    payload.push_back(static_cast<uint8_t>(svc.type));
-    payload.push_back(static_cast<uint8_t>(svc.transport));
-
-    uint8_t channel_len = static_cast<uint8_t>(svc.channel_name.size());
-    payload.push_back(channel_len);
-
-    uint16_t udp_addr_len = static_cast<uint16_t>(svc.udp_address.size());
-    payload.push_back(static_cast<uint8_t>(udp_addr_len & 0xFF));
-    payload.push_back(static_cast<uint8_t>((udp_addr_len >> 8) & 0xFF));
+    std::lock_guard<std::mutex> lock(service_broadcast_mutex_);
 
-    if (channel_len > 0) {
-        payload.insert(payload.end(), svc.channel_name.begin(), svc.channel_name.end());
-    }
-    if (udp_addr_len > 0) {
-        payload.insert(payload.end(), svc.udp_address.begin(), svc.udp_address.end());
-    }
+    // Serialize service descriptor to payload, with the version of our service set it leads to
+    const std::vector<uint8_t>& payload = serializeService(svc, ++service_version_);
 
     MessageType msg_type = is_add ? MessageType::SERVICE_REGISTER : MessageType::SERVICE_UNREGISTER;
-    auto packet =
-        MessageBuilder::build(node_id_, svc.group, svc.topic, payload.data(), payload.size(), getUdpPort(), msg_type);
+    PacketView packet = MessageBuilder::buildView(node_id_, svc.group, svc.topic, payload.data(), payload.size(),
+                                                  getUdpPort(), msg_type);
 
     // Broadcast via shared memory to local inter-process nodes
     if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
@@ -1241,12 +3858,11 @@ void NodeImpl::broadcastServiceUpdate(const ServiceDescriptor& svc, bool is_add)
     if (use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
         // Get all known UDP endpoints
         auto& registry = Nexus::rpc::GlobalRegistry::instance();
-        auto all_services = registry.findServices();
+        const auto services = registry.getServices();
 
         std::set<std::string> udp_endpoints;
-        for (const auto& remote_svc : all_services) {
-            if (remote_svc.transport == TransportType::UDP && remote_svc.node_id != node_id_ &&
-                !remote_svc.udp_address.empty()) {
+        for (const auto& remote_svc : services->transport(TransportType::UDP)) {
+            if (remote_svc.node_id != node_id_ && !remote_svc.udp_address.empty()) {
                 udp_endpoints.insert(remote_svc.udp_address);
             }
         }
@@ -1324,72 +3940,62 @@ void NodeImpl::handleServiceMessage(const std::string& from_node, const std::str
     if (is_register && payload_len == 0) {
         // Another node is asking for our services, send them point-to-point
         auto& registry = Nexus::rpc::GlobalRegistry::instance();
-        auto services = registry.findServices();
+        const auto services = registry.getServices();
 
         // Reply with each of our services (point-to-point send to requesting node)
-        for (const auto& svc : services) {
+        for (const auto& svc : services->node(node_id_)) {
             // ✅ 修复风险2: 发送所有类型的服务（不只是 SHARED_MEMORY）
             // 这样即使 SHM 初始化失败，UDP 服务仍能被发现
-            if (svc.node_id == node_id_) {
-                // Serialize service descriptor to payload
-                std::vector<uint8_t> svc_payload;
-                svc_payload.push_back(static_cast<uint8_t>(svc.type));
-                svc_payload.push_back(static_cast<uint8_t>(svc.transport));
-
-                uint8_t channel_len = static_cast<uint8_t>(svc.channel_name.size());
-                svc_payload.push_back(channel_len);
-
-                uint16_t udp_addr_len = static_cast<uint16_t>(svc.udp_address.size());
-                svc_payload.push_back(static_cast<uint8_t>(udp_addr_len & 0xFF));
-                svc_payload.push_back(static_cast<uint8_t>((udp_addr_len >> 8) & 0xFF));
-
-                if (channel_len > 0) {
-                    svc_payload.insert(svc_payload.end(), svc.channel_name.begin(), svc.channel_name.end());
-                }
-                if (udp_addr_len > 0) {
-                    svc_payload.insert(svc_payload.end(), svc.udp_address.begin(), svc.udp_address.end());
-                }
+            // Serialize service descriptor to payload
+            const std::vector<uint8_t>& svc_payload = serializeService(svc);
 
-                // Build SERVICE_REGISTER packet
-                auto packet = MessageBuilder::build(node_id_, svc.group, svc.topic, svc_payload.data(),
-                                                    svc_payload.size(), getUdpPort(), MessageType::SERVICE_REGISTER);
+            // Build SERVICE_REGISTER packet
+            PacketView packet =
+                MessageBuilder::buildView(node_id_, svc.group, svc.topic, svc_payload.data(), svc_payload.size(),
+                                          getUdpPort(), MessageType::SERVICE_REGISTER);
 
-                // Send directly to the requesting node (point-to-point via shared memory)
-                if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
-                    shm_transport_v3_->send(from_node, packet.data(), packet.size());
-                }
+            // Send directly to the requesting node (point-to-point via shared memory)
+            if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+                shm_transport_v3_->send(from_node, packet.data(), packet.size());
             }
         }
+
+        // Tell the requesting node we are done (same lane: it arrives after the services)
+        if (shm_transport_v3_ && shm_transport_v3_->isInitialized()) {
+            PacketView done = MessageBuilder::buildView(node_id_, "", "", &SERVICE_QUERY_DONE, 1, getUdpPort(),
+                                                        MessageType::SERVICE_REGISTER);
+            shm_transport_v3_->send(from_node, done.data(), done.size());
+        }
         return;
     }
 
-    // Deserialize service descriptor from payload
-    // Format: type(1byte) + transport(1byte) + channel_name_len(1byte) + udp_addr_len(2bytes) + channel_name +
-    // udp_address
-    if (payload_len < 5) {
-        return;  // Invalid payload
+    // Versioned query: answered with a snapshot, or just "unchanged" if the querier is up to date
+    if (is_register && payload_len == SERVICE_QUERY_VERSIONED_LEN) {
+        sendServiceSnapshot(from_node, getU32(payload));
+        return;
     }
 
+    if (is_register && payload_len == 1 && payload[0] == SERVICE_QUERY_DONE) {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        if (service_query_pending_.erase(from_node) > 0 && service_query_pending_.empty()) {
+            service_query_cv_.notify_all();
+        }
+        return;
+    }
+
+    // Deserialize service descriptor from payload (format: see serializeService())
     ServiceDescriptor svc;
     svc.node_id = from_node;
     svc.group = group;
     svc.topic = topic;
-    svc.type = static_cast<ServiceType>(payload[0]);
-    svc.transport = static_cast<TransportType>(payload[1]);
-
-    uint8_t channel_len = payload[2];
-    uint16_t udp_addr_len = static_cast<uint16_t>(payload[3]) | (static_cast<uint16_t>(payload[4]) << 8);
-
-    if (payload_len < static_cast<size_t>(5 + channel_len + udp_addr_len)) {
+    uint32_t version = 0;
+    if (!parseService(payload, payload_len, svc, version)) {
         return;  // Invalid payload
     }
-
-    if (channel_len > 0) {
-        svc.channel_name = std::string(reinterpret_cast<const char*>(payload + 5), channel_len);
-    }
-    if (udp_addr_len > 0) {
-        svc.udp_address = std::string(reinterpret_cast<const char*>(payload + 5 + channel_len), udp_addr_len);
+    if (!noteServiceVersion(from_node, version)) {
+        return;  // Already covered by a snapshot
     }
+    confirmCachedService(svc);
 
     auto& registry = Nexus::rpc::GlobalRegistry::instance();
 
@@ -1408,13 +4014,202 @@ void NodeImpl::handleServiceMessage(const std::string& from_node, const std::str
     }
 }
 
+void NodeImpl::sendServiceSnapshot(const std::string& to_node, uint32_t known_version) {
+    if (!shm_transport_v3_ || !shm_transport_v3_->isInitialized()) {
+        return;
+    }
+
+    // Held while reading the registry: the snapshot and its version match, and no update is sent meanwhile
+    std::lock_guard<std::mutex> lock(service_broadcast_mutex_);
+    const uint32_t version = service_version_;
+
+    std::vector<uint8_t> chunk;
+    uint8_t flags = SNAPSHOT_FIRST;
+    uint16_t count = 0;
+    auto flush = [&](bool last) {
+        // The header goes in front now that the entry count is known
+        std::vector<uint8_t> header;
+        putU32(header, version);
+        header.push_back(static_cast<uint8_t>(flags | (last ? SNAPSHOT_LAST : 0)));
+        putU16(header, count);
+        std::copy(header.begin(), header.end(), chunk.begin());
+
+        PacketView packet = MessageBuilder::buildView(node_id_, "", "", chunk.data(), chunk.size(), getUdpPort(),
+                                                      MessageType::SERVICE_SNAPSHOT);
+        const int64_t deadline = steadyMillis() + SNAPSHOT_SEND_TIMEOUT_MS;
+        while (!shm_transport_v3_->send(to_node, packet.data(), packet.size()) && steadyMillis() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        chunk.assign(SNAPSHOT_HEADER_SIZE, 0);
+        flags = 0;
+        count = 0;
+    };
+    chunk.assign(SNAPSHOT_HEADER_SIZE, 0);
+
+    if (known_version != 0 && known_version == version) {
+        flags |= SNAPSHOT_UNCHANGED;
+        flush(true);
+        return;
+    }
+
+    const auto services = Nexus::rpc::GlobalRegistry::instance().getServices();
+    for (const auto& svc : services->node(node_id_)) {
+        if (svc.group.size() > UINT8_MAX || svc.topic.size() > UINT8_MAX) {
+            continue;  // Not representable; registration limits keep names well below this
+        }
+        const std::vector<uint8_t>& desc = serializeService(svc);
+        const size_t entry_size = SNAPSHOT_ENTRY_HEADER_SIZE + svc.group.size() + svc.topic.size() + desc.size();
+        if (count > 0 && (chunk.size() + entry_size > SNAPSHOT_CHUNK_BYTES || count == UINT16_MAX)) {
+            flush(false);
+        }
+        chunk.push_back(static_cast<uint8_t>(svc.group.size()));
+        chunk.push_back(static_cast<uint8_t>(svc.topic.size()));
+        putU16(chunk, static_cast<uint16_t>(desc.size()));
+        chunk.insert(chunk.end(), svc.group.begin(), svc.group.end());
+        chunk.insert(chunk.end(), svc.topic.begin(), svc.topic.end());
+        chunk.insert(chunk.end(), desc.begin(), desc.end());
+        ++count;
+    }
+    flush(true);
+}
+
+void NodeImpl::handleServiceSnapshot(const std::string& from_node, const uint8_t* payload, size_t payload_len) {
+    if (from_node == node_id_ || payload_len < SNAPSHOT_HEADER_SIZE) {
+        return;
+    }
+    const uint32_t version = getU32(payload);
+    const uint8_t flags = payload[4];
+    const uint16_t count = getU16(payload + 5);
+
+    // Parse this chunk's entries
+    std::vector<ServiceDescriptor> entries;
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (payload_len < offset + SNAPSHOT_ENTRY_HEADER_SIZE) {
+            return;  // Truncated
+        }
+        const uint8_t group_len = payload[offset];
+        const uint8_t topic_len = payload[offset + 1];
+        const uint16_t desc_len = getU16(payload + offset + 2);
+        offset += SNAPSHOT_ENTRY_HEADER_SIZE;
+        if (payload_len < offset + group_len + topic_len + desc_len) {
+            return;
+        }
+
+        ServiceDescriptor svc;
+        svc.node_id = from_node;
+        svc.group.assign(reinterpret_cast<const char*>(payload + offset), group_len);
+        svc.topic.assign(reinterpret_cast<const char*>(payload + offset + group_len), topic_len);
+        offset += group_len + topic_len;
+        uint32_t unused_version = 0;
+        if (parseService(payload + offset, desc_len, svc, unused_version)) {
+            entries.push_back(std::move(svc));
+        }
+        offset += desc_len;
+    }
+
+    const bool unchanged = (flags & SNAPSHOT_UNCHANGED) != 0;
+    std::vector<ServiceDescriptor> snapshot;  // The node's whole service set, once the last chunk is in
+    {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        if (!unchanged) {
+            std::vector<ServiceDescriptor>& assembly = service_snapshots_[from_node];
+            if (flags & SNAPSHOT_FIRST) {
+                assembly.clear();
+            }
+            std::move(entries.begin(), entries.end(), std::back_inserter(assembly));
+            if (!(flags & SNAPSHOT_LAST)) {
+                return;
+            }
+            snapshot.swap(assembly);
+            service_snapshots_.erase(from_node);
+        }
+
+        if (flags & SNAPSHOT_LAST) {
+            PeerServices& peer = peer_services_[from_node];
+            peer.version = version;
+            peer.synced = true;
+            peer.resync_ms = 0;
+            if (service_query_pending_.erase(from_node) > 0 && service_query_pending_.empty()) {
+                service_query_cv_.notify_all();
+            }
+        }
+    }
+    if (flags & SNAPSHOT_LAST) {
+        confirmCachedNode(from_node);  // The snapshot replaces whatever the cache had for the node
+    }
+    if (unchanged) {
+        return;
+    }
+
+    // Replace what we hold for the node; callbacks only for services that come or go
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    std::set<std::string> current;
+    std::set<std::string> latest;
+    for (const auto& svc : snapshot) {
+        latest.insert(svc.getCapability());
+    }
+    const auto services = registry.getServices();
+    for (const auto& svc : services->node(from_node)) {
+        current.insert(svc.getCapability());
+        if (latest.count(svc.getCapability()) == 0) {
+            registry.unregisterService(svc.group, svc);
+            handleServiceUpdate(from_node, svc, false);
+        }
+    }
+    for (const auto& svc : snapshot) {
+        registry.registerService(svc.group, svc);
+        if (current.count(svc.getCapability()) == 0) {
+            handleServiceUpdate(from_node, svc, true);
+        }
+    }
+}
+
+bool NodeImpl::noteServiceVersion(const std::string& from_node, uint32_t version) {
+    if (version == 0) {
+        return true;  // Older node: no versions, apply as it comes
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(service_query_mutex_);
+        PeerServices& peer = peer_services_[from_node];
+        if (peer.synced) {
+            if (version <= peer.version) {
+                return false;
+            }
+            if (version == peer.version + 1) {
+                peer.version = version;
+                return true;
+            }
+            peer.synced = false;  // Missed an update
+        } else if (version == 1) {
+            peer.version = version;  // The node's first update: nothing missed
+            peer.synced = true;
+            return true;
+        }
+
+        // Out of step: apply this update, and ask for the whole set (local nodes only, rate-limited
+        // while unanswered) to pick up whatever we missed
+        const int64_t now = steadyMillis();
+        if (peer.resync_ms != 0 && now - peer.resync_ms < SERVICE_RESYNC_INTERVAL_MS) {
+            return true;
+        }
+        peer.resync_ms = now;
+    }
+
+    if (shm_transport_v3_ && shm_transport_v3_->isInitialized() && shm_transport_v3_->isLocalNode(from_node)) {
+        NEXUS_DEBUG("IMPL") << "Service updates from " << from_node << " skipped a version, resyncing";
+        requestServiceSnapshot(from_node, 0);
+    }
+    return true;
+}
+
 std::vector<ServiceDescriptor> NodeImpl::discoverServices(const std::string& group, ServiceType type) {
     std::vector<ServiceDescriptor> result;
 
-    // Get all services from GlobalRegistry
-    auto all_services = Nexus::rpc::GlobalRegistry::instance().findServices(group);
+    const auto services = Nexus::rpc::GlobalRegistry::instance().getServices();
 
-    for (const auto& svc : all_services) {
+    for (const auto& svc : group.empty() ? services->all() : services->group(group)) {
         // Filter by type
         if (type != ServiceType::ALL && svc.type != type) {
             continue;
@@ -1429,10 +4224,9 @@ std::vector<ServiceDescriptor> NodeImpl::discoverServices(const std::string& gro
 std::vector<std::string> NodeImpl::findNodesByCapability(const std::string& capability) {
     std::vector<std::string> result;
 
-    // Get all services from GlobalRegistry
-    auto all_services = Nexus::rpc::GlobalRegistry::instance().findServices();
+    const auto services = Nexus::rpc::GlobalRegistry::instance().getServices();
 
-    for (const auto& svc : all_services) {
+    for (const auto& svc : services->all()) {
         if (svc.getCapability() == capability) {
             // Check if already in result
             if (std::find(result.begin(), result.end(), svc.node_id) == result.end()) {
@@ -1462,34 +4256,19 @@ void NodeImpl::startUdpHeartbeat() {
         return;
     }
 
-    udp_heartbeat_running_ = true;
-    udp_heartbeat_thread_ = std::thread(&NodeImpl::udpHeartbeatThread, this);
+    // Heartbeat to the known UDP nodes, then drop the ones that went quiet; the first run is immediate
+    udp_heartbeat_task_ = MaintenanceScheduler::instance().schedule(
+        std::chrono::milliseconds(UDP_HEARTBEAT_INTERVAL_MS),
+        [this] {
+            sendUdpHeartbeat();
+            checkUdpTimeouts();
+        },
+        std::chrono::milliseconds(0));
 }
 
 void NodeImpl::stopUdpHeartbeat() {
-    udp_heartbeat_running_ = false;
-    if (udp_heartbeat_thread_.joinable()) {
-        udp_heartbeat_thread_.join();
-    }
-}
-
-void NodeImpl::udpHeartbeatThread() {
-    NEXUS_LOG_INFO("IMPL", "UDP heartbeat thread started for node " + node_id_);
-
-    while (udp_heartbeat_running_) {
-        // Send heartbeat to all known UDP nodes
-        sendUdpHeartbeat();
-
-        // Check for timeouts and clean up dead nodes
-        checkUdpTimeouts();
-
-        // Sleep for heartbeat interval
-        for (int i = 0; i < UDP_HEARTBEAT_INTERVAL_MS / 100 && udp_heartbeat_running_; ++i) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-    }
-
-    NEXUS_LOG_INFO("IMPL", "UDP heartbeat thread stopped for node " + node_id_);
+    MaintenanceScheduler::instance().cancel(udp_heartbeat_task_);
+    udp_heartbeat_task_ = MaintenanceScheduler::NO_TASK;
 }
 
 void NodeImpl::sendUdpHeartbeat() {
@@ -1497,38 +4276,72 @@ void NodeImpl::sendUdpHeartbeat() {
         return;
     }
 
-    // Build heartbeat packet (empty payload)
-    auto packet = MessageBuilder::build(node_id_, "", "", nullptr, 0, getUdpPort(), MessageType::HEARTBEAT);
-
-    // Get all UDP services from GlobalRegistry
     auto& registry = Nexus::rpc::GlobalRegistry::instance();
-    auto all_services = registry.findServices();
+    const uint64_t route_version = registry.getRouteVersion();
+    const int64_t now = steadyMillis();
+    std::vector<sockaddr_in> idle_peers;
+    {
+        std::lock_guard<std::mutex> lock(udp_peers_mutex_);
+
+        // Collect unique UDP endpoints, only when a service came or went since the last pass
+        if (route_version != udp_heartbeat_version_) {
+            std::map<uint64_t, std::shared_ptr<UdpPeer>> peers;
+            const auto services = registry.getServices();
+            for (const auto& svc : services->transport(TransportType::UDP)) {
+                sockaddr_in addr;
+                if (svc.node_id == node_id_ || svc.udp_address.empty() || !parseUdpAddress(svc.udp_address, addr)) {
+                    continue;
+                }
+                const uint64_t key = udpPeerKey(addr);
+                std::shared_ptr<UdpPeer>& peer = peers[key];
+                if (!peer) {
+                    auto existing = udp_peers_.find(key);
+                    peer = existing != udp_peers_.end() ? existing->second : std::make_shared<UdpPeer>();
+                    peer->addr = addr;
+                }
+            }
+            udp_peers_.swap(peers);
+            udp_heartbeat_peers_.clear();
+            for (const auto& entry : udp_peers_) {
+                udp_heartbeat_peers_.push_back(entry.second);
+            }
+            udp_heartbeat_version_ = route_version;
+        }
 
-    // Collect unique UDP endpoints
-    std::set<std::string> udp_endpoints;  // Format: "ip:port"
-    for (const auto& svc : all_services) {
-        if (svc.transport == TransportType::UDP && svc.node_id != node_id_ && !svc.udp_address.empty()) {
-            udp_endpoints.insert(svc.udp_address);
+        // Peers that received data within the interval already know we are alive
+        for (const auto& peer : udp_heartbeat_peers_) {
+            if (now - peer->last_sent_ms.load(std::memory_order_relaxed) >= UDP_HEARTBEAT_INTERVAL_MS) {
+                peer->last_sent_ms.store(now, std::memory_order_relaxed);
+                idle_peers.push_back(peer->addr);
+            }
         }
     }
 
-    // Send heartbeat to each endpoint
-    for (const auto& endpoint : udp_endpoints) {
-        const size_t colon_pos = endpoint.find(':');
-        if (colon_pos == std::string::npos || colon_pos == 0 || colon_pos == endpoint.length() - 1) {
-            continue;  // Invalid endpoint format
-        }
+    if (!idle_peers.empty()) {
+        // Build heartbeat packet (empty payload), one sendmmsg for all idle peers
+        PacketView packet =
+            MessageBuilder::buildView(node_id_, "", "", nullptr, 0, getUdpPort(), MessageType::HEARTBEAT);
+        udp_transport_->sendBatch(packet.data(), packet.size(), idle_peers);
+    }
+}
 
-        const std::string ip_str = endpoint.substr(0, colon_pos);
-        const std::string& ip = (ip_str == "0.0.0.0") ? "127.0.0.1" : ip_str;
+std::shared_ptr<NodeImpl::UdpPeer> NodeImpl::udpPeer(const sockaddr_in& addr) {
+    std::lock_guard<std::mutex> lock(udp_peers_mutex_);
+    std::shared_ptr<UdpPeer>& peer = udp_peers_[udpPeerKey(addr)];
+    if (!peer) {
+        peer = std::make_shared<UdpPeer>();
+        peer->addr = addr;
+    }
+    return peer;
+}
 
-        try {
-            const uint16_t port = static_cast<uint16_t>(std::stoi(endpoint.substr(colon_pos + 1)));
-            udp_transport_->send(packet.data(), packet.size(), ip, port);
-        } catch (const std::exception&) {
-            // Skip invalid port number
-            continue;
-        }
+void NodeImpl::markUdpPeersSent(const InterProcessTargets& targets) {
+    if (targets.udp_peers.empty()) {
+        return;
+    }
+    const int64_t now = steadyMillis();
+    for (const auto& peer : targets.udp_peers) {
+        peer->last_sent_ms.store(now, std::memory_order_relaxed);
     }
 }
 
@@ -1551,58 +4364,132 @@ void NodeImpl::handleQuerySubscriptions([[maybe_unused]] const std::string& from
 
     // Get all services registered by this node from GlobalRegistry
     auto& registry = Nexus::rpc::GlobalRegistry::instance();
-    auto all_services = registry.findServices();
+    const auto services = registry.getServices();
 
     NEXUS_DEBUG("IMPL") << "Handling QUERY_SUBSCRIPTIONS from " << from_node << ":" << from_port 
-                        << ". Found " << all_services.size() << " total services.";
+                        << ". Found " << services->node(node_id_).size() << " own services.";
 
     // Reply with each of our services via SERVICE_REGISTER (point-to-point send)
-    for (const auto& svc : all_services) {
-        if (svc.node_id == node_id_) {
-            ServiceDescriptor response_svc = svc;
-            bool send_response = false;
-
-            if (svc.transport == TransportType::UDP) {
-                send_response = true;
-            } else if (svc.transport == TransportType::SHARED_MEMORY && use_udp_ && udp_transport_ && udp_transport_->isInitialized()) {
-                // Convert to UDP descriptor for the remote node
-                response_svc.transport = TransportType::UDP;
-                response_svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
-                send_response = true;
-            }
-
-            if (send_response) {
-                NEXUS_DEBUG("IMPL") << "Sending service info for " << response_svc.group << "/" << response_svc.topic;
-                // Serialize service descriptor to payload
-                std::vector<uint8_t> payload;
-                payload.push_back(static_cast<uint8_t>(response_svc.type));
-                payload.push_back(static_cast<uint8_t>(response_svc.transport));
-
-                uint8_t channel_len = static_cast<uint8_t>(response_svc.channel_name.size());
-                payload.push_back(channel_len);
-
-                uint16_t udp_addr_len = static_cast<uint16_t>(response_svc.udp_address.size());
-                payload.push_back(static_cast<uint8_t>(udp_addr_len & 0xFF));
-                payload.push_back(static_cast<uint8_t>((udp_addr_len >> 8) & 0xFF));
-
-                if (channel_len > 0) {
-                    payload.insert(payload.end(), response_svc.channel_name.begin(), response_svc.channel_name.end());
-                }
-                if (udp_addr_len > 0) {
-                    payload.insert(payload.end(), response_svc.udp_address.begin(), response_svc.udp_address.end());
+    for (const auto& svc : services->node(node_id_)) {
+        ServiceDescriptor response_svc = svc;
+        bool send_response = false;
+
+        if (svc.transport == TransportType::UDP) {
+            send_response = true;
+        } else if (svc.transport == TransportType::SHARED_MEMORY && use_udp_ && udp_transport_ &&
+                   udp_transport_->isInitialized()) {
+            // Convert to UDP descriptor for the remote node
+            response_svc.transport = TransportType::UDP;
+            response_svc.udp_address = "0.0.0.0:" + std::to_string(getUdpPort());
+            if (svc.type == ServiceType::NORMAL_MESSAGE) {
+                std::lock_guard<std::mutex> lock(multicast_mutex_);
+                if (multicast_topics_.count(SubscriptionKey(svc.group, svc.topic)) > 0) {
+                    response_svc.multicast_address = multicastAddress(svc.group, svc.topic);
                 }
+            }
+            send_response = true;
+        }
 
-                // Build SERVICE_REGISTER packet
-                auto packet = MessageBuilder::build(node_id_, response_svc.group, response_svc.topic, payload.data(), payload.size(),
-                                                    getUdpPort(), MessageType::SERVICE_REGISTER);
+        if (send_response) {
+            NEXUS_DEBUG("IMPL") << "Sending service info for " << response_svc.group << "/" << response_svc.topic;
+            // Serialize service descriptor to payload
+            const std::vector<uint8_t>& payload = serializeService(response_svc);
 
-                // Send directly to the querying node (point-to-point)
-                udp_transport_->send(packet.data(), packet.size(), target_ip, from_port);
-            }
+            // Build SERVICE_REGISTER packet
+            PacketView packet = MessageBuilder::buildView(node_id_, response_svc.group, response_svc.topic,
+                                                          payload.data(), payload.size(), getUdpPort(),
+                                                          MessageType::SERVICE_REGISTER);
+
+            // Send directly to the querying node (point-to-point)
+            udp_transport_->send(packet.data(), packet.size(), target_ip, from_port);
         }
     }
 }
 
+std::string NodeImpl::multicastAddress(const std::string& group, const std::string& topic) const {
+    const auto& config = Nexus::rpc::Config::instance().transport;
+    in_addr base;
+    if (!multicast_transport_ || isTopicPattern(topic) ||
+        inet_pton(AF_INET, config.udp_multicast_base.c_str(), &base) <= 0) {
+        return std::string();
+    }
+
+    // Topics hash into buckets after the base address; a node joins the bucket of each topic it subscribes to
+    const uint32_t bucket = CompactPacket::topicHash(group, topic) % std::max<uint32_t>(config.udp_multicast_buckets, 1);
+    in_addr addr;
+    addr.s_addr = htonl(ntohl(base.s_addr) + bucket);
+    char text[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, text, sizeof(text));
+    return std::string(text) + ":" + std::to_string(config.udp_multicast_port);
+}
+
+std::string NodeImpl::joinTopicMulticast(const std::string& group, const std::string& topic) {
+    const std::string address = multicastAddress(group, topic);
+    if (address.empty()) {
+        return address;
+    }
+
+    std::lock_guard<std::mutex> lock(multicast_mutex_);
+    if (multicast_topics_.insert(SubscriptionKey(group, topic)).second && multicast_groups_[address]++ == 0 &&
+        !multicast_transport_->joinMulticastGroup(address.substr(0, address.find(':')))) {
+        multicast_groups_.erase(address);
+        multicast_topics_.erase(SubscriptionKey(group, topic));
+        return std::string();
+    }
+    return address;
+}
+
+void NodeImpl::leaveTopicMulticast(const std::string& group, const std::string& topic) {
+    std::lock_guard<std::mutex> lock(multicast_mutex_);
+    if (multicast_topics_.erase(SubscriptionKey(group, topic)) == 0) {
+        return;
+    }
+    const std::string address = multicastAddress(group, topic);
+    auto it = multicast_groups_.find(address);
+    if (it != multicast_groups_.end() && --it->second == 0) {
+        multicast_transport_->leaveMulticastGroup(address.substr(0, address.find(':')));
+        multicast_groups_.erase(it);
+    }
+}
+
+void NodeImpl::handleMulticastPacket(const uint8_t* data, size_t size) {
+    if (size < sizeof(MessagePacket)) {
+        return;
+    }
+    const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
+    const MessageType msg_type = static_cast<MessageType>(packet->msg_type);
+    if (!packet->isValid() || (msg_type != MessageType::DATA && !hasSendTime(packet->msg_type))) {
+        return;
+    }
+
+    // Senders in this process or on our shared memory already delivered directly; a group that also has
+    // remote subscribers must not hand us a second copy
+    StringView source_node = StringView::fromField(packet->node_id, sizeof(packet->node_id));
+    if (source_node == node_id_) {
+        return;
+    }
+    const std::string sender = source_node.str();
+    if (Nexus::rpc::GlobalRegistry::instance().findNode(sender) ||
+        (shm_transport_v3_ && shm_transport_v3_->isLocalNode(sender))) {
+        return;
+    }
+
+    const uint8_t* payload_end = packet->getPayload() + packet->payload_len;
+    const uint64_t now = msg_type != MessageType::DATA ? TraceStamp::now() : 0;
+    const uint64_t deadline_ns = frameDeadlineNs(packet->msg_type, data, size, payload_end, false, now);
+    uint64_t receive_ns = 0;
+    int64_t transit_ns = -1;
+    if (latency_tracing_ && now != 0) {
+        receive_ns = now;
+        const uint64_t send_ns = TraceStamp::read(data, size, payload_end);
+        transit_ns = send_ns != 0 ? udpTransitNs(source_node, send_ns, receive_ns) : -1;
+    }
+    TraceScope trace(receive_ns, transit_ns);
+    handleMessage(source_node, StringView(packet->getGroup(), packet->group_len),
+                  StringView(packet->getTopic(), packet->topic_len), packet->getPayload(), packet->payload_len,
+                  deadline_ns);
+}
+
 void NodeImpl::handleUdpHeartbeat(const std::string& from_node, const std::string& from_addr, uint16_t from_port) {
     if (from_node == node_id_) {
         return;  // Ignore self heartbeat
@@ -1627,6 +4514,33 @@ void NodeImpl::handleUdpHeartbeat(const std::string& from_node, const std::strin
     }
 }
 
+void NodeImpl::noteUdpTraffic(StringView from_node, const sockaddr_in& from, uint16_t from_port) {
+    {
+        std::lock_guard<std::mutex> lock(remote_nodes_mutex_);
+        auto it = remote_nodes_.find(from_node);
+        if (it != remote_nodes_.end()) {
+            it->second.last_heartbeat = std::chrono::steady_clock::now();
+            return;
+        }
+    }
+    // First packet of a node that is busy sending to us: it may never need to heartbeat
+    if (from_port != 0) {
+        handleUdpHeartbeat(from_node.str(), UdpTransport::formatAddress(from), from_port);
+    }
+}
+
+int64_t NodeImpl::udpTransitNs(StringView from_node, uint64_t send_ns, uint64_t receive_ns) {
+    // Clocks of different hosts are unrelated: the fastest frame seen so far stands for zero transit
+    const int64_t delta = static_cast<int64_t>(receive_ns - send_ns);
+    std::lock_guard<std::mutex> lock(remote_nodes_mutex_);
+    auto it = remote_nodes_.find(from_node);
+    if (it == remote_nodes_.end()) {
+        return -1;
+    }
+    it->second.min_clock_delta_ns = std::min(it->second.min_clock_delta_ns, delta);
+    return delta - it->second.min_clock_delta_ns;
+}
+
 void NodeImpl::checkUdpTimeouts() {
     std::vector<std::string> timed_out_nodes;
 
@@ -1649,23 +4563,25 @@ void NodeImpl::checkUdpTimeouts() {
         }
     }
 
-    // Clean up services from timed-out nodes
+    // Clean up services from timed-out nodes (one registry pass for all of them)
     if (!timed_out_nodes.empty()) {
         auto& registry = Nexus::rpc::GlobalRegistry::instance();
+        const auto services = registry.getServices();
 
         for (const auto& node_id : timed_out_nodes) {
-            // Remove all services from this node
-            auto all_services = registry.findServices();
-            for (const auto& svc : all_services) {
-                if (svc.node_id == node_id && svc.transport == TransportType::UDP) {
+            confirmCachedNode(node_id);
+            for (const auto& svc : services->node(node_id)) {
+                if (svc.transport == TransportType::UDP) {
                     registry.unregisterService(svc.group, svc);
 
                     // Trigger SERVICE_REMOVED callback
-                    handleServiceUpdate(node_id, svc, false);
+                    handleServiceUpdate(svc.node_id, svc, false);
                 }
             }
+        }
 
-            // Trigger NODE_LEFT callback
+        // Trigger NODE_LEFT callbacks
+        for (const auto& node_id : timed_out_nodes) {
             notifyNodeEvent(ServiceEvent::NODE_LEFT, node_id);
         }
     }
@@ -1674,35 +4590,77 @@ void NodeImpl::checkUdpTimeouts() {
 // ==================== End UDP Heartbeat ====================
 
 void NodeImpl::processPacket(const uint8_t* data, size_t size, [[maybe_unused]] const std::string& from) {
+    // Compact DATA frame: addressed by our own topic id, the sender is implied by the queue
+    if (size >= sizeof(CompactPacket) && CompactPacket::isCompact(data)) {
+        const CompactPacket* packet = reinterpret_cast<const CompactPacket*>(data);
+        if (!packet->isValid(size, true)) {
+            NEXUS_ERROR("IMPL") << "Received invalid compact packet";
+            return;
+        }
+        // Unknown id or hash mismatch: sender used an id from a previous instance of this process
+        TopicHandle handle = Nexus::rpc::GlobalRegistry::instance().topicById(packet->topic_id);
+        if (!handle.valid() || handle.hash() != packet->topic_hash) {
+            return;
+        }
+        const uint8_t* payload_end = packet->getPayload() + packet->payload_len;
+        // Same host: the sender's deadline compares directly with our clock
+        const uint64_t deadline_ns = frameDeadlineNs(packet->msg_type, data, size, payload_end, true, 0);
+        if (latency_tracing_ && hasSendTime(packet->msg_type)) {
+            const uint64_t now = TraceStamp::now();
+            TraceScope trace(now, shmTransitNs(data, size, payload_end, now));
+            handleMessage(handle, packet->getPayload(), packet->payload_len, nullptr, deadline_ns);
+        } else {
+            handleMessage(handle, packet->getPayload(), packet->payload_len, nullptr, deadline_ns);
+        }
+        return;
+    }
+
     // Data should be in MessagePacket format
     if (size < sizeof(MessagePacket)) {
         return;
     }
 
     const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
-    if (!packet->isValid()) {
+    if (!packet->isValid(true)) {  // Same-host shared memory: unchecked (NONE) frames are trusted
         NEXUS_ERROR("IMPL") << "Received invalid packet";
         return;
     }
 
-    std::string source_node(packet->node_id);
-    NEXUS_INFO("IMPL") << "Received message type " << (int)packet->msg_type << " from " << source_node;
+    // Views into the frame; strings are only built for control messages
+    StringView source_node = StringView::fromField(packet->node_id, sizeof(packet->node_id));
+    MessageType msg_type = static_cast<MessageType>(packet->msg_type);
+    if (msg_type != MessageType::DATA && !hasSendTime(packet->msg_type) && msg_type != MessageType::REQUEST &&
+        msg_type != MessageType::REPLY) {  // Not per data message or call: the log line itself allocates
+        NEXUS_DEBUG("IMPL") << "Received message type " << (int)packet->msg_type << " from " << source_node;
+    }
 
     // Skip our own messages (critical: avoid self-reception)
     if (source_node == node_id_) {
         return;
     }
 
-    std::string group = packet->group_len > 0 ? std::string(packet->getGroup(), packet->group_len) : "";
-    std::string topic = packet->topic_len > 0 ? std::string(packet->getTopic(), packet->topic_len) : "";
-
-    MessageType msg_type = static_cast<MessageType>(packet->msg_type);
+    StringView group(packet->getGroup(), packet->group_len);
+    StringView topic(packet->getTopic(), packet->topic_len);
 
     switch (msg_type) {
         case MessageType::DATA:
             handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len);
             break;
 
+        case MessageType::TRACED_DATA:
+        case MessageType::DEADLINE_DATA: {
+            const uint8_t* payload_end = packet->getPayload() + packet->payload_len;
+            const uint64_t deadline_ns = frameDeadlineNs(packet->msg_type, data, size, payload_end, true, 0);
+            if (latency_tracing_) {
+                const uint64_t now = TraceStamp::now();
+                TraceScope trace(now, shmTransitNs(data, size, payload_end, now));
+                handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len, deadline_ns);
+            } else {
+                handleMessage(source_node, group, topic, packet->getPayload(), packet->payload_len, deadline_ns);
+            }
+            break;
+        }
+
         case MessageType::SERVICE_REGISTER:
             enqueueSystemMessage(SystemMessageType::SERVICE_REGISTER, source_node, group, topic,
                                  packet->getPayload(), packet->payload_len);
@@ -1713,6 +4671,11 @@ void NodeImpl::processPacket(const uint8_t* data, size_t size, [[maybe_unused]]
                                  packet->getPayload(), packet->payload_len);
             break;
 
+        case MessageType::SERVICE_SNAPSHOT:
+            enqueueSystemMessage(SystemMessageType::SERVICE_SNAPSHOT, source_node, group, topic,
+                                 packet->getPayload(), packet->payload_len);
+            break;
+
         case MessageType::NODE_JOIN:
             NEXUS_DEBUG("IMPL") << "Received NODE_JOIN message from " << source_node;
             enqueueSystemMessage(SystemMessageType::NODE_JOIN, source_node, group, topic, nullptr, 0);
@@ -1726,9 +4689,20 @@ void NodeImpl::processPacket(const uint8_t* data, size_t size, [[maybe_unused]]
         case MessageType::UNSUBSCRIBE:
         case MessageType::QUERY_SUBSCRIPTIONS:
         case MessageType::SUBSCRIPTION_REPLY:
+        case MessageType::RELIABLE_DATA:  // UDP only
+        case MessageType::RELIABLE_ACK:
             NEXUS_DEBUG("IMPL") << "Ignoring unused message type: " << static_cast<int>(msg_type);
             break;
 
+        case MessageType::REQUEST:
+            rpc_server_->handleCallRequest(source_node, group, topic, packet->getPayload(), packet->payload_len,
+                                           nullptr);
+            break;
+
+        case MessageType::REPLY:
+            rpc_server_->handleCallReply(packet->getPayload(), packet->payload_len);
+            break;
+
         case MessageType::HEARTBEAT:
             break;
     }
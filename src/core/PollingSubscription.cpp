@@ -0,0 +1,144 @@
+#include "nexus/core/PollingSubscription.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "nexus/core/Message.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace Nexus {
+namespace rpc {
+
+PollingSubscription::PollingSubscription(size_t capacity) : queue_(capacity > 0 ? capacity : DEFAULT_CAPACITY) {
+#ifdef __linux__
+    read_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    write_fd_ = read_fd_;
+#else
+    int fds[2];
+    if (pipe(fds) == 0) {
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        read_fd_ = fds[0];
+        write_fd_ = fds[1];
+    }
+#endif
+}
+
+PollingSubscription::~PollingSubscription() {
+    Item item;
+    while (queue_.tryPop(item)) {
+        item.payload.release();
+    }
+    if (write_fd_ >= 0 && write_fd_ != read_fd_) {
+        ::close(write_fd_);
+    }
+    if (read_fd_ >= 0) {
+        ::close(read_fd_);
+    }
+}
+
+bool PollingSubscription::tryTake(PolledMessage& message) {
+    Item item;
+    for (;;) {
+        if (!queue_.tryPop(item)) {
+            clearSignal();
+            if (!queue_.tryPop(item)) {
+                message = PolledMessage();
+                return false;
+            }
+        }
+        if (item.deadline_ns == 0 || TraceStamp::now() <= item.deadline_ns) {
+            break;
+        }
+        item.payload.release();  // Expired while queued
+        expired_.fetch_add(1, std::memory_order_relaxed);
+    }
+    message.payload_.release();
+    message.topic_ = item.topic;
+    message.payload_ = item.payload;
+    return true;
+}
+
+size_t PollingSubscription::takeBatch(PolledMessage* messages, size_t max) {
+    size_t taken = 0;
+    while (taken < max && tryTake(messages[taken])) {
+        ++taken;
+    }
+    return taken;
+}
+
+bool PollingSubscription::wait(int timeout_ms) {
+    if (!queue_.empty()) {
+        return true;
+    }
+    pollfd pfd = {read_fd_, POLLIN, 0};
+    while (poll(&pfd, 1, timeout_ms) < 0 && errno == EINTR) {
+    }
+    return !queue_.empty();
+}
+
+size_t PollingSubscription::push(const TopicHandle& topic, SharedPayload payload, bool drop_oldest,
+                                 uint64_t deadline_ns) {
+    Item item{topic, payload, deadline_ns};
+    size_t dropped = 0;
+    if (!queue_.tryPush(item)) {
+        if (!drop_oldest) {
+            payload.release();
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return 1;
+        }
+        // Drop-oldest: the application may drain concurrently, so pop until ours fits
+        while (!queue_.tryPush(item)) {
+            Item oldest;
+            if (queue_.tryPop(oldest)) {
+                oldest.payload.release();
+                dropped++;
+            }
+        }
+        dropped_.fetch_add(dropped, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with clearSignal(): one side sees the other
+    signal();
+    return dropped;
+}
+
+void PollingSubscription::signal() {
+    // Only the push that finds the descriptor clear writes it: no system call while the queue stays non-empty
+    if (!signaled_.exchange(true, std::memory_order_acq_rel) && write_fd_ >= 0) {
+#ifdef __linux__
+        const uint64_t one = 1;
+        ssize_t written = ::write(write_fd_, &one, sizeof(one));
+#else
+        const char one = 1;
+        ssize_t written = ::write(write_fd_, &one, sizeof(one));
+#endif
+        (void)written;
+    }
+}
+
+void PollingSubscription::clearSignal() {
+    if (!signaled_.load(std::memory_order_acquire) || read_fd_ < 0) {
+        return;
+    }
+    // Drain first, then clear the flag: a push after the drain either sees the flag clear and writes,
+    // or set, in which case the re-check below finds its message
+    uint64_t buffer;
+    while (::read(read_fd_, &buffer, sizeof(buffer)) > 0) {
+    }
+    signaled_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!queue_.empty()) {
+        signal();
+    }
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,200 @@
+#include "nexus/core/Recorder.h"
+
+#include <chrono>
+#include <thread>
+
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+Recorder::Recorder(std::shared_ptr<Node> node) : node_(std::move(node)), state_(std::make_shared<State>()) {}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+bool Recorder::start(const std::string& base, const RecordWriter::Options& options) {
+    return node_ && state_->writer.open(base, options);
+}
+
+Node::Error Recorder::recordTopics(const std::string& group, const std::vector<std::string>& topics) {
+    if (!state_->writer.isOpen()) {
+        return Node::NOT_INITIALIZED;
+    }
+
+    // Inline: the payload is appended on the receive thread, straight from the ring
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    std::shared_ptr<State> state = state_;
+    Node::Error error = node_->subscribe(
+        group, topics,
+        [state](const std::string& msg_group, const std::string& topic, const uint8_t* payload, size_t size) {
+            const uint32_t stream = state->streamFor(RecordLayout::STREAM_MESSAGE, msg_group, topic);
+            if (stream != UINT32_MAX) {
+                state->writer.append(stream, payload, size);
+            }
+        },
+        options);
+    if (error == Node::NO_ERROR) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& subscribed = groups_[group];
+        subscribed.insert(subscribed.end(), topics.begin(), topics.end());
+    }
+    return error;
+}
+
+Node::Error Recorder::recordLargeData(const std::string& channel) {
+    if (!state_->writer.isOpen()) {
+        return Node::NOT_INITIALIZED;
+    }
+
+    std::shared_ptr<State> state = state_;
+    Node::Error error = node_->subscribeLargeData(
+        channel, [state](const std::string& channel_name, const std::string& topic, const uint8_t* data, size_t size,
+                         uint64_t) {
+            const uint32_t stream = state->streamFor(RecordLayout::STREAM_LARGE_DATA, channel_name, topic);
+            if (stream != UINT32_MAX) {
+                state->writer.append(stream, data, size);
+            }
+        });
+    if (error == Node::NO_ERROR) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channels_.push_back(channel);
+    }
+    return error;
+}
+
+void Recorder::stop() {
+    std::unordered_map<std::string, std::vector<std::string>> groups;
+    std::vector<std::string> channels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        groups.swap(groups_);
+        channels.swap(channels_);
+    }
+    for (const auto& group : groups) {
+        node_->unsubscribe(group.first, group.second);
+    }
+    for (const auto& channel : channels) {
+        node_->unsubscribeLargeData(channel);
+    }
+    state_->writer.close();  // A callback racing with the unsubscribe now fails to append
+}
+
+uint32_t Recorder::State::streamFor(RecordLayout::StreamKind kind, const std::string& name, const std::string& topic) {
+    std::lock_guard<std::mutex> lock(mutex);
+    StreamTable& table = kind == RecordLayout::STREAM_MESSAGE ? message_streams : large_streams;
+    auto& topics = table[name];
+    auto it = topics.find(topic);
+    if (it != topics.end()) {
+        return it->second;
+    }
+
+    RecordStream stream;
+    stream.kind = kind;
+    stream.name = name;
+    stream.topic = topic;
+    const uint32_t id = writer.addStream(stream);
+    if (id != UINT32_MAX) {
+        topics[topic] = id;
+    }
+    return id;
+}
+
+// ============================================================================
+// Replayer
+// ============================================================================
+
+Replayer::Replayer(std::shared_ptr<Node> node) : node_(std::move(node)) {}
+
+bool Replayer::run(const std::string& base, const Options& options) {
+    const std::vector<std::string> segments = RecordReader::segments(base);
+    if (segments.empty() || !node_) {
+        return false;
+    }
+    stopping_.store(false, std::memory_order_relaxed);
+
+    // Original timing: frame times are mapped onto the clock from the first frame replayed
+    bool opened = false;
+    bool first = true;
+    uint64_t first_ns = 0;
+    std::chrono::steady_clock::time_point started;
+    RecordReader reader;
+    for (const auto& path : segments) {
+        if (!reader.open(path)) {
+            NEXUS_WARN("Replayer") << "Skipping unreadable segment " << path;
+            continue;
+        }
+        opened = true;
+        if (options.start_ns > 0) {
+            reader.seek(options.start_ns);
+        }
+
+        RecordReader::Frame frame;
+        while (!stopping_.load(std::memory_order_relaxed) && reader.next(frame)) {
+            if (frame.stream >= reader.streams().size()) {
+                continue;
+            }
+            if (options.speed > 0) {
+                if (first) {
+                    first_ns = frame.time_ns;
+                    started = std::chrono::steady_clock::now();
+                    first = false;
+                }
+                const auto offset = std::chrono::nanoseconds(
+                    static_cast<int64_t>(static_cast<double>(frame.time_ns - first_ns) / options.speed));
+                std::this_thread::sleep_until(started + offset);
+            }
+            if (!replayFrame(reader.streams()[frame.stream], frame, options)) {
+                return true;  // Node shut down
+            }
+        }
+        if (stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    return opened;
+}
+
+Replayer::Stats Replayer::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+bool Replayer::replayFrame(const RecordStream& stream, const RecordReader::Frame& frame, const Options& options) {
+    Node::Error error = Node::NO_ERROR;
+    if (stream.kind == RecordLayout::STREAM_LARGE_DATA) {
+        // A full channel refuses the whole block: wait for its readers rather than lose it
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.large_data_retry_ms);
+        while ((error = node_->writeLargeData(stream.name, stream.topic, frame.data, frame.size)) == Node::TIMEOUT &&
+               std::chrono::steady_clock::now() < deadline && !stopping_.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    } else {
+        // QUEUE_FULL: some subscriber dropped it, the others have it (not retried)
+        error = node_->publish(stream.name, stream.topic, frame.data, frame.size);
+    }
+    if (error == Node::NOT_INITIALIZED) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (error != Node::NO_ERROR) {
+        stats_.failed++;
+    } else if (stream.kind == RecordLayout::STREAM_LARGE_DATA) {
+        stats_.large_blocks++;
+        stats_.bytes += frame.size;
+    } else {
+        stats_.messages++;
+        stats_.bytes += frame.size;
+    }
+    return true;
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,517 @@
+#include "nexus/core/RpcServer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "nexus/core/NodeImpl.h"
+#include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
+#include "nexus/transport/UdpTransport.h"
+#include "nexus/utils/Logger.h"
+#include "nexus/utils/ThreadPlacement.h"
+
+namespace Nexus {
+namespace rpc {
+
+namespace {
+// REQUEST/REPLY packet: CallHeader + body as the payload; returns the packet size
+size_t buildCallPacket(uint8_t* frame, const std::string& node_id, const std::string& group,
+                       const std::string& method, MessageType msg_type, const CallHeader& header, const uint8_t* body,
+                       size_t body_len, uint16_t udp_port, ChecksumType checksum) {
+    MessagePacket* packet = MessageBuilder::buildHeader(frame, node_id, group, method, sizeof(CallHeader) + body_len,
+                                                        udp_port, msg_type, checksum);
+    std::memcpy(packet->getPayload(), &header, sizeof(header));
+    if (body_len > 0) {
+        std::memcpy(packet->getPayload() + sizeof(header), body, body_len);
+    }
+    packet->checksum = packet->calculateChecksum();
+    return MessagePacket::packetSize(group.size(), method.size(), sizeof(CallHeader) + body_len);
+}
+
+// Service advertising a served method on one transport
+ServiceDescriptor methodService(const std::string& node_id, const std::string& group, const std::string& method,
+                                TransportType transport, uint16_t udp_port) {
+    ServiceDescriptor svc;
+    svc.node_id = node_id;
+    svc.group = group;
+    svc.topic = method;
+    svc.type = ServiceType::RPC_METHOD;
+    svc.transport = transport;
+    if (transport == TransportType::UDP) {
+        svc.udp_address = "0.0.0.0:" + std::to_string(udp_port);
+    }
+    return svc;
+}
+}  // namespace
+
+RpcServer::RpcServer(NodeImpl& node) : node_(node) {}
+
+RpcServer::~RpcServer() { stop(); }
+
+void RpcServer::stop() {
+    // Stop serving before the timeout thread: a handler waiting in call() is released by it
+    stopCallWorkers();
+
+    // Stop the call timeout thread; calls still outstanding complete now
+    std::unordered_map<uint64_t, PendingCall> abandoned_calls;
+    {
+        std::lock_guard<std::mutex> lock(calls_mutex_);
+        call_timeout_running_ = false;
+        abandoned_calls.swap(pending_calls_);
+    }
+    calls_cv_.notify_all();
+    if (call_timeout_thread_.joinable()) {
+        call_timeout_thread_.join();
+    }
+    for (auto& entry : abandoned_calls) {
+        entry.second.callback(Error::NOT_INITIALIZED, nullptr, 0);
+    }
+}
+
+RpcServer::Error RpcServer::serve(const Property& msg_group, const Property& method, const MethodHandler& handler) {
+    if (msg_group.empty() || method.empty() || !handler) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!node_.running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        auto& group_methods = methods_[msg_group];
+        if (group_methods.count(method) > 0) {
+            return Error::ALREADY_EXISTS;
+        }
+        group_methods[method] = std::make_shared<const MethodHandler>(handler);
+    }
+    startCallWorkers();
+
+    // Advertise the method (in-process callers find it through findMethod())
+    if (node_.shm_transport_v3_ && node_.shm_transport_v3_->isInitialized()) {
+        node_.registerService(methodService(node_.node_id_, msg_group, method, TransportType::SHARED_MEMORY, 0));
+    }
+    if (node_.use_udp_ && node_.udp_transport_ && node_.udp_transport_->isInitialized()) {
+        node_.registerService(methodService(node_.node_id_, msg_group, method, TransportType::UDP, node_.getUdpPort()));
+    }
+    return Error::NO_ERROR;
+}
+
+RpcServer::Error RpcServer::unserve(const Property& msg_group, const Property& method) {
+    if (msg_group.empty() || method.empty()) {
+        return Error::INVALID_ARG;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        auto group_it = methods_.find(msg_group);
+        if (group_it == methods_.end() || group_it->second.erase(method) == 0) {
+            return Error::NOT_FOUND;
+        }
+        if (group_it->second.empty()) {
+            methods_.erase(group_it);
+        }
+    }
+
+    if (node_.shm_transport_v3_ && node_.shm_transport_v3_->isInitialized()) {
+        node_.unregisterService(methodService(node_.node_id_, msg_group, method, TransportType::SHARED_MEMORY, 0));
+    }
+    if (node_.use_udp_ && node_.udp_transport_ && node_.udp_transport_->isInitialized()) {
+        node_.unregisterService(
+            methodService(node_.node_id_, msg_group, method, TransportType::UDP, node_.getUdpPort()));
+    }
+    return Error::NO_ERROR;
+}
+
+std::shared_ptr<const RpcServer::MethodHandler> RpcServer::findMethod(StringView group, StringView method) const {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto group_it = methods_.find(group);
+    if (group_it == methods_.end()) {
+        return nullptr;
+    }
+    auto method_it = group_it->second.find(method);
+    return method_it != group_it->second.end() ? method_it->second : nullptr;
+}
+
+RpcServer::Error RpcServer::call(const Property& msg_group, const Property& method, const Property& request,
+                                 Property& response, uint32_t timeout_ms) {
+    // Completion shared with the reply callback (which may outlive this frame only until it returns)
+    struct CallWaiter {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+        Error error = Error::NO_ERROR;
+        Property response;
+    };
+    auto waiter = std::make_shared<CallWaiter>();
+
+    Error result = callAsync(msg_group, method, request, timeout_ms,
+                             [waiter](Error error, const uint8_t* data, size_t size) {
+                                 std::lock_guard<std::mutex> lock(waiter->mutex);
+                                 if (error == Error::NO_ERROR && size > 0) {
+                                     waiter->response.assign(reinterpret_cast<const char*>(data), size);
+                                 }
+                                 waiter->error = error;
+                                 waiter->done = true;
+                                 waiter->done_cv.notify_one();
+                             });
+    if (result != Error::NO_ERROR) {
+        return result;
+    }
+
+    // The timeout thread completes the call at its deadline, so this wait is bounded
+    std::unique_lock<std::mutex> lock(waiter->mutex);
+    waiter->done_cv.wait(lock, [&waiter] { return waiter->done; });
+    if (waiter->error == Error::NO_ERROR) {
+        response.swap(waiter->response);
+    }
+    return waiter->error;
+}
+
+RpcServer::Error RpcServer::callAsync(const Property& msg_group, const Property& method, const Property& request,
+                                      uint32_t timeout_ms, const ReplyCallback& callback) {
+    if (msg_group.empty() || method.empty() || !callback ||
+        request.size() > MessagePacket::MAX_PAYLOAD_LEN - sizeof(CallHeader)) {
+        return Error::INVALID_ARG;
+    }
+
+    if (!node_.running_) {
+        return Error::NOT_INITIALIZED;
+    }
+
+    const uint8_t* request_data = reinterpret_cast<const uint8_t*>(request.data());
+
+    // Served in this process (this node included): call the handler directly on this thread
+    for (const auto& node : NodeImpl::getAllNodes()) {
+        if (!node) {
+            continue;
+        }
+        std::shared_ptr<const MethodHandler> handler = node->rpc_server_->findMethod(msg_group, method);
+        if (handler) {
+            Property response;
+            try {
+                (*handler)(request_data, request.size(), response);
+            } catch (...) {
+                callback(Error::UNEXPECTED_ERROR, nullptr, 0);
+                return Error::NO_ERROR;
+            }
+            callback(Error::NO_ERROR, reinterpret_cast<const uint8_t*>(response.data()), response.size());
+            return Error::NO_ERROR;
+        }
+    }
+
+    const CallRoute route = callRoute(Nexus::rpc::GlobalRegistry::instance().resolveTopic(msg_group, method));
+    if (route.shm_handle == SharedMemoryTransportV3::INVALID_NODE_HANDLE && !route.has_udp) {
+        return Error::NOT_FOUND;
+    }
+
+    // Register before sending: the reply can arrive before the send returns
+    CallHeader header = {};
+    header.call_id = next_call_id_.fetch_add(1, std::memory_order_relaxed);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    {
+        std::lock_guard<std::mutex> lock(calls_mutex_);
+        pending_calls_[header.call_id] = PendingCall{callback, deadline};
+        if (!call_timeout_running_) {
+            call_timeout_running_ = true;
+            next_deadline_ = deadline;
+            call_timeout_thread_ = std::thread(&RpcServer::callTimeoutThread, this);
+        } else if (deadline < next_deadline_) {
+            next_deadline_ = deadline;
+            calls_cv_.notify_one();  // Only an earlier deadline needs the timeout thread
+        }
+    }
+
+    Error result = Error::NO_ERROR;
+    if (route.shm_handle != SharedMemoryTransportV3::INVALID_NODE_HANDLE) {
+        // Data queue (not the small control queue), serialized in place
+        const size_t packet_size = MessagePacket::packetSize(msg_group.size(), method.size(),
+                                                             sizeof(CallHeader) + request.size());
+        bool sent = node_.shm_transport_v3_->sendInPlace(route.shm_handle, packet_size, [&](uint8_t* frame, size_t) {
+            buildCallPacket(frame, node_.node_id_, msg_group, method, MessageType::REQUEST, header, request_data,
+                            request.size(), 0, node_.shm_checksum_);
+        });
+        if (!sent) {
+            Error failure =
+                node_.shmSendFailed(route.shm_handle, packet_size, SharedMemoryTransportV3::DEFAULT_DATA_LANE);
+            result = failure == Error::QUEUE_FULL ? Error::QUEUE_FULL : Error::NETWORK_ERROR;
+        }
+    } else {
+        uint8_t* packet = MessageBuilder::threadBuffer(
+            MessagePacket::packetSize(msg_group.size(), method.size(), sizeof(CallHeader) + request.size()));
+        size_t packet_size = buildCallPacket(packet, node_.node_id_, msg_group, method, MessageType::REQUEST, header,
+                                             request_data, request.size(), node_.getUdpPort(), node_.udp_checksum_);
+        if (!node_.udp_transport_->sendTo(packet, packet_size, route.udp_address)) {
+            result = Error::NETWORK_ERROR;
+        }
+    }
+
+    if (result != Error::NO_ERROR) {
+        takePendingCall(header.call_id);  // Never sent: no callback
+    }
+    return result;
+}
+
+RpcServer::CallRoute RpcServer::callRoute(const TopicHandle& method) {
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    std::lock_guard<std::mutex> lock(call_routes_mutex_);
+    if (method.id() >= call_routes_.size()) {
+        call_routes_.resize(method.id() + 1);
+    }
+
+    CallRoute& route = call_routes_[method.id()];
+    const uint64_t version = registry.getRouteVersion();
+    if (route.route_version != version) {
+        route = CallRoute();
+        collectCallRoute(method.group(), method.topic(), route);
+        // Not found: version 0 looks the method up again on the next call
+        if (route.shm_handle != SharedMemoryTransportV3::INVALID_NODE_HANDLE || route.has_udp) {
+            route.route_version = version;
+        }
+    }
+    return route;
+}
+
+void RpcServer::collectCallRoute(const std::string& group, const std::string& method, CallRoute& route) {
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    const bool shm_ready = node_.shm_transport_v3_ && node_.shm_transport_v3_->isInitialized();
+    const bool udp_ready = node_.use_udp_ && node_.udp_transport_ && node_.udp_transport_->isInitialized();
+
+    const auto services = registry.getServices();
+    for (const auto& svc : services->topic(group, method)) {
+        if (svc.type != ServiceType::RPC_METHOD || svc.node_id == node_.node_id_) {
+            continue;
+        }
+
+        // First reachable shared-memory server wins; a UDP server is kept as fallback
+        if (svc.transport == TransportType::SHARED_MEMORY && shm_ready) {
+            route.shm_handle = node_.shm_transport_v3_->resolveNode(svc.node_id);
+            if (route.shm_handle != SharedMemoryTransportV3::INVALID_NODE_HANDLE) {
+                return;
+            }
+        } else if (svc.transport == TransportType::UDP && udp_ready && !route.has_udp) {
+            const size_t colon_pos = svc.udp_address.find(':');
+            if (colon_pos == std::string::npos || colon_pos == 0 || colon_pos == svc.udp_address.length() - 1) {
+                continue;
+            }
+            const std::string ip_str = svc.udp_address.substr(0, colon_pos);
+            try {
+                const uint16_t port = static_cast<uint16_t>(std::stoi(svc.udp_address.substr(colon_pos + 1)));
+                route.has_udp =
+                    UdpTransport::resolveAddress(ip_str == "0.0.0.0" ? "127.0.0.1" : ip_str, port, route.udp_address);
+            } catch (const std::exception&) {
+                // Skip invalid port number
+            }
+        }
+    }
+}
+
+void RpcServer::handleCallRequest(StringView source_node_id, StringView group, StringView method,
+                                  const uint8_t* payload, size_t payload_len, const sockaddr_in* udp_caller) {
+    if (payload_len < sizeof(CallHeader)) {
+        return;
+    }
+    CallRequest request;
+    std::memcpy(&request.header, payload, sizeof(request.header));
+    request.caller = source_node_id.str();
+    request.group = group.str();
+    request.method = method.str();
+    if (udp_caller) {
+        request.udp = true;
+        request.udp_caller = *udp_caller;
+    }
+
+    // Handlers may block or call() other nodes: hand the request to a call worker, never run it here
+    request.body =
+        SharedPayload::create(NodeImpl::payloadPool(), payload + sizeof(CallHeader), payload_len - sizeof(CallHeader));
+    Error refused = Error::NO_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(call_queue_mutex_);
+        if (!call_workers_running_) {
+            refused = Error::NOT_FOUND;  // Nothing served yet
+        } else if (call_queue_.size() >= MAX_CALL_QUEUE_SIZE) {
+            refused = Error::QUEUE_FULL;
+        } else {
+            call_queue_.push_back(request);
+        }
+    }
+    if (refused == Error::NO_ERROR) {
+        call_queue_cv_.notify_one();
+        return;
+    }
+    request.body.release();
+    request.header.status = static_cast<uint32_t>(refused);
+    sendCallReply(request, Property());
+}
+
+void RpcServer::startCallWorkers() {
+    std::lock_guard<std::mutex> lock(call_queue_mutex_);
+    if (call_workers_running_) {
+        return;
+    }
+    call_workers_running_ = true;
+    // As many as dispatch workers: a chain of nested calls coming back here needs a free one per level
+    for (size_t i = 0; i < node_.getProcessingThreadCount(); ++i) {
+        call_workers_.emplace_back(&RpcServer::callWorkerThread, this);
+    }
+}
+
+void RpcServer::stopCallWorkers() {
+    std::deque<CallRequest> unhandled;
+    {
+        std::lock_guard<std::mutex> lock(call_queue_mutex_);
+        call_workers_running_ = false;
+    }
+    call_queue_cv_.notify_all();
+    for (auto& thread : call_workers_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    call_workers_.clear();
+    {
+        std::lock_guard<std::mutex> lock(call_queue_mutex_);
+        unhandled.swap(call_queue_);
+    }
+    // Callers time out: the node is leaving
+    for (auto& request : unhandled) {
+        request.body.release();
+    }
+}
+
+void RpcServer::callWorkerThread() {
+    applyThreadPlacement(node_.threads_config_.worker, "call worker");
+    Property response;  // Reused across requests
+    for (;;) {
+        CallRequest request;
+        {
+            std::unique_lock<std::mutex> lock(call_queue_mutex_);
+            call_queue_cv_.wait(lock, [this] { return !call_workers_running_ || !call_queue_.empty(); });
+            if (!call_workers_running_) {
+                return;
+            }
+            request = call_queue_.front();
+            call_queue_.pop_front();
+        }
+
+        response.clear();
+        request.header.status = static_cast<uint32_t>(Error::NOT_FOUND);
+        std::shared_ptr<const MethodHandler> handler = findMethod(request.group, request.method);
+        if (handler) {
+            try {
+                (*handler)(request.body.data(), request.body.size(), response);
+                request.header.status = static_cast<uint32_t>(Error::NO_ERROR);
+            } catch (...) {
+                response.clear();
+                request.header.status = static_cast<uint32_t>(Error::UNEXPECTED_ERROR);
+            }
+        }
+        request.body.release();
+        if (response.size() > MessagePacket::MAX_PAYLOAD_LEN - sizeof(CallHeader)) {
+            response.clear();
+            request.header.status = static_cast<uint32_t>(Error::UNEXPECTED_ERROR);
+        }
+        sendCallReply(request, response);
+    }
+}
+
+void RpcServer::sendCallReply(const CallRequest& request, const Property& response) {
+    // Echo the group and method so the reply stays a well-formed packet
+    const uint8_t* body = reinterpret_cast<const uint8_t*>(response.data());
+    const size_t packet_size =
+        MessagePacket::packetSize(request.group.size(), request.method.size(), sizeof(CallHeader) + response.size());
+
+    bool sent = false;
+    if (request.udp) {
+        if (node_.udp_transport_ && node_.udp_transport_->isInitialized()) {
+            uint8_t* packet = MessageBuilder::threadBuffer(packet_size);
+            buildCallPacket(packet, node_.node_id_, request.group, request.method, MessageType::REPLY,
+                            request.header, body, response.size(), node_.getUdpPort(), node_.udp_checksum_);
+            sent = node_.udp_transport_->sendTo(packet, packet_size, request.udp_caller);
+        }
+    } else if (node_.shm_transport_v3_ && node_.shm_transport_v3_->isInitialized()) {
+        // Point-to-point to the caller's queue
+        const uint32_t handle = node_.shm_transport_v3_->resolveNode(request.caller);
+        if (handle != SharedMemoryTransportV3::INVALID_NODE_HANDLE) {
+            sent = node_.shm_transport_v3_->sendInPlace(handle, packet_size, [&](uint8_t* frame, size_t) {
+                buildCallPacket(frame, node_.node_id_, request.group, request.method, MessageType::REPLY,
+                                request.header, body, response.size(), 0, node_.shm_checksum_);
+            });
+        }
+    }
+    if (!sent) {
+        // The caller times out instead
+        const size_t failed = failed_replies_.fetch_add(1, std::memory_order_relaxed) + 1;
+        NEXUS_WARN("IMPL") << "Reply to " << request.caller << " for " << request.group << "/" << request.method
+                           << " not sent (" << failed << " failed replies)";
+    }
+}
+
+void RpcServer::handleCallReply(const uint8_t* payload, size_t payload_len) {
+    if (payload_len < sizeof(CallHeader)) {
+        return;
+    }
+    CallHeader header;
+    std::memcpy(&header, payload, sizeof(header));
+
+    // Late replies (call already timed out) find nothing
+    ReplyCallback callback = takePendingCall(header.call_id);
+    if (callback) {
+        try {
+            callback(static_cast<Error>(header.status), payload + sizeof(CallHeader), payload_len - sizeof(CallHeader));
+        } catch (...) {
+            // Ignore callback exceptions to prevent receive thread crash
+        }
+    }
+}
+
+RpcServer::ReplyCallback RpcServer::takePendingCall(uint64_t call_id) {
+    std::lock_guard<std::mutex> lock(calls_mutex_);
+    auto it = pending_calls_.find(call_id);
+    if (it == pending_calls_.end()) {
+        return ReplyCallback();
+    }
+    ReplyCallback callback = std::move(it->second.callback);
+    pending_calls_.erase(it);
+    return callback;
+}
+
+void RpcServer::callTimeoutThread() {
+    applyThreadPlacement(node_.threads_config_.maintenance, "call timeout");
+    std::unique_lock<std::mutex> lock(calls_mutex_);
+    while (call_timeout_running_) {
+        calls_cv_.wait_until(lock, next_deadline_);
+        if (!call_timeout_running_) {
+            break;
+        }
+
+        // Few calls are outstanding at once: a scan is cheaper than keeping a deadline index
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<ReplyCallback> expired;
+        next_deadline_ = now + std::chrono::hours(1);
+        for (auto it = pending_calls_.begin(); it != pending_calls_.end();) {
+            if (it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.callback));
+                it = pending_calls_.erase(it);
+            } else {
+                next_deadline_ = std::min(next_deadline_, it->second.deadline);
+                ++it;
+            }
+        }
+
+        if (!expired.empty()) {
+            lock.unlock();
+            for (auto& callback : expired) {
+                try {
+                    callback(Error::TIMEOUT, nullptr, 0);
+                } catch (...) {
+                    // Ignore exceptions from user callback
+                }
+            }
+            lock.lock();
+        }
+    }
+}
+
+}  // namespace rpc
+}  // namespace Nexus
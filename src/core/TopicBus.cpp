@@ -0,0 +1,170 @@
+#include "nexus/core/TopicBus.h"
+
+#include <unistd.h>  // For getpid()
+
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <thread>
+
+#include "nexus/core/Config.h"
+#include "nexus/core/NodeImpl.h"
+#include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
+
+namespace Nexus {
+namespace rpc {
+
+constexpr int TopicBusReaders::SYNC_MS;
+
+std::shared_ptr<TopicBus> TopicBus::create(const std::string& node_id, const std::string& group,
+                                           const std::string& topic) {
+    // One ring per publishing node and topic; "channel" in the name lets orphan cleanup find it
+    const size_t key = std::hash<std::string>()(node_id + "/" + group + "/" + topic);
+    char name[64];
+    snprintf(name, sizeof(name), "nexus_bus_channel_%016llx_%d", static_cast<unsigned long long>(key),
+             static_cast<int>(getpid()));
+    const LargeDataChannel::Config config = channelConfig();
+    auto channel = LargeDataChannel::create(name, config);
+    if (!channel) {
+        return nullptr;
+    }
+    std::shared_ptr<TopicBus> bus(new TopicBus());
+    bus->channel_name_ = name;
+    bus->channel_ = std::move(channel);
+    bus->max_message_ = config.max_block_size;
+    return bus;
+}
+
+LargeDataChannel::Config TopicBus::channelConfig() {
+    LargeDataChannel::Config config = NodeImpl::largeDataChannelConfig();
+    config.buffer_size = Nexus::rpc::Config::instance().shm.topic_bus_size;
+    config.max_block_size = config.buffer_size / 4;  // Room for a few messages however large
+    config.mirrored = true;                          // Readers take the ring size from the publisher
+    // A slow reader never holds up the publisher; blocks are written by the library on this host, not rehashed
+    config.overflow_policy = LargeDataOverflowPolicy::DROP_OLDEST;
+    config.verify_mode = LargeDataVerifyMode::TRUST;
+    return config;
+}
+
+bool TopicBus::write(const std::string& topic, size_t payload_len, uint16_t reader_mask,
+                     const Node::PayloadWriter& writer) {
+    if (payload_len > max_message_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Readers attached but not in this route (yet) skip the block: they still get their own frames
+    uint8_t* block = channel_->reserveBlock(topic, payload_len, reader_mask);
+    if (!block) {
+        return false;
+    }
+    writer(block, payload_len);
+    return channel_->commitBlock() >= 0;
+}
+
+struct TopicBusReaders::Reader {
+    std::shared_ptr<NodeImpl::LargeDataReader> reader;
+    ServiceDescriptor service;  // Tells the publisher our reader slot
+};
+
+TopicBusReaders::TopicBusReaders(NodeImpl& node) : node_(node) {}
+
+TopicBusReaders::~TopicBusReaders() { close(); }
+
+void TopicBusReaders::sync(bool force) {
+    if (!node_.running_ || !node_.shm_transport_v3_ || !node_.shm_transport_v3_->isInitialized()) {
+        return;
+    }
+
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t version = registry.getRouteVersion();
+    if (!force && version == version_) {
+        return;
+    }
+    version_ = version;
+
+    // Buses of nodes in other processes (in-process subscribers are delivered to directly) for our topics;
+    // the publisher's own service has no reader slot, the readers' services do
+    std::set<std::string> local_node_ids;
+    for (const auto& node : registry.getAllNodes()) {
+        if (node) {
+            local_node_ids.insert(node->getNodeId());
+        }
+    }
+    const auto services = registry.getServices();
+    std::map<std::string, const ServiceDescriptor*> buses;
+    for (const auto& svc : services->transport(TransportType::SHARED_MEMORY)) {
+        if (svc.type == ServiceType::TOPIC_BUS && svc.reader_slot == ServiceDescriptor::NO_READER_SLOT &&
+            !svc.channel_name.empty() && local_node_ids.count(svc.node_id) == 0 &&
+            node_.isSubscribed(svc.group, svc.topic)) {
+            buses[svc.channel_name] = &svc;
+        }
+    }
+
+    for (auto it = readers_.begin(); it != readers_.end();) {
+        if (buses.count(it->first) > 0) {
+            ++it;
+            continue;
+        }
+        node_.unregisterService(it->second->service);
+        NodeImpl::stopLargeDataReader(std::move(it->second->reader));
+        it = readers_.erase(it);
+    }
+
+    for (const auto& entry : buses) {
+        if (readers_.count(entry.first) > 0) {
+            continue;
+        }
+        const ServiceDescriptor& bus = *entry.second;
+        auto reader = std::make_shared<NodeImpl::LargeDataReader>();
+        reader->channel = LargeDataChannel::create(bus.channel_name, TopicBus::channelConfig());
+        // Only blocks written from now on; with no reader slot left the publisher keeps sending directly
+        const int32_t slot = reader->channel ? reader->channel->attachReader(true) : -1;
+        if (slot < 0) {
+            continue;
+        }
+        const TopicHandle handle = registry.resolveTopic(bus.group, bus.topic);
+        NodeImpl* node = &node_;
+        reader->forward = [node, handle](LargeDataChannel& channel, const LargeDataChannel::DataBlock& block) {
+            // Written before the publisher saw our slot: it sent us the message directly
+            if (block.isFor(channel.getReaderId())) {
+                node->handleMessage(handle, block.data, block.size);
+            }
+            channel.releaseBlock(block);
+        };
+        reader->placement = node_.threads_config_.shm_receive;
+        reader->thread = std::thread(&NodeImpl::largeDataReaderThread, bus.channel_name, reader);
+
+        std::unique_ptr<Reader> attached(new Reader());
+        attached->reader = std::move(reader);
+        attached->service.node_id = node_.node_id_;
+        attached->service.group = bus.group;
+        attached->service.topic = bus.topic;
+        attached->service.type = ServiceType::TOPIC_BUS;
+        attached->service.channel_name = bus.channel_name;
+        attached->service.transport = TransportType::SHARED_MEMORY;
+        attached->service.reader_slot = static_cast<uint32_t>(slot);
+        node_.registerService(attached->service);
+        readers_[bus.channel_name] = std::move(attached);
+    }
+}
+
+void TopicBusReaders::close() {
+    std::map<std::string, std::unique_ptr<Reader>> readers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readers.swap(readers_);
+    }
+    for (auto& entry : readers) {
+        NodeImpl::stopLargeDataReader(std::move(entry.second->reader));
+    }
+}
+
+bool TopicBusReaders::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readers_.empty();
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -1,13 +1,75 @@
 #include "nexus/registry/GlobalRegistry.h"
 
 #include <algorithm>
+#include <set>
 
+#include "nexus/core/Message.h"
 #include "nexus/core/Node.h"
 #include "nexus/core/NodeImpl.h"  // Nexus::rpc namespace
+#include "nexus/utils/TopicTrie.h"
 
 namespace Nexus {
 namespace rpc {
 
+namespace {
+const ServiceIndex::List kNoServices;
+const InProcessSubscribers::List kNoSubscribers;
+}  // namespace
+
+const ServiceIndex::List& ServiceIndex::group(const std::string& group) const {
+    auto it = groups_.find(group);
+    return it != groups_.end() ? it->second.services : kNoServices;
+}
+
+const ServiceIndex::List& ServiceIndex::topic(const std::string& group, const std::string& topic) const {
+    auto group_it = groups_.find(group);
+    if (group_it == groups_.end()) {
+        return kNoServices;
+    }
+    auto topic_it = group_it->second.topics.find(topic);
+    return topic_it != group_it->second.topics.end() ? topic_it->second : kNoServices;
+}
+
+const ServiceIndex::List& ServiceIndex::patterns(const std::string& group) const {
+    auto it = groups_.find(group);
+    return it != groups_.end() ? it->second.patterns : kNoServices;
+}
+
+const ServiceIndex::List& ServiceIndex::node(const std::string& node_id) const {
+    auto it = nodes_.find(node_id);
+    return it != nodes_.end() ? it->second : kNoServices;
+}
+
+const ServiceIndex::List& ServiceIndex::transport(Nexus::rpc::TransportType transport) const {
+    const size_t index = static_cast<size_t>(transport);
+    return index < sizeof(transports_) / sizeof(transports_[0]) ? transports_[index] : kNoServices;
+}
+
+void ServiceIndex::add(const Nexus::rpc::ServiceDescriptor& svc) {
+    all_.push_back(svc);
+    GroupIndex& group = groups_[svc.group];
+    group.services.push_back(svc);
+    if (isTopicPattern(svc.topic)) {
+        group.patterns.push_back(svc);
+    } else {
+        group.topics[svc.topic].push_back(svc);
+    }
+    nodes_[svc.node_id].push_back(svc);
+    const size_t transport = static_cast<size_t>(svc.transport);
+    if (transport < sizeof(transports_) / sizeof(transports_[0])) {
+        transports_[transport].push_back(svc);
+    }
+}
+
+const InProcessSubscribers::List& InProcessSubscribers::topic(uint32_t id) const {
+    return id < by_topic_.size() ? by_topic_[id] : kNoSubscribers;
+}
+
+const InProcessSubscribers::List& InProcessSubscribers::patterns(const std::string& group) const {
+    auto it = patterns_.find(group);
+    return it != patterns_.end() ? it->second : kNoSubscribers;
+}
+
 GlobalRegistry& GlobalRegistry::instance() {
     static GlobalRegistry registry;
     return registry;
@@ -16,6 +78,10 @@ GlobalRegistry& GlobalRegistry::instance() {
 void GlobalRegistry::registerNode(const std::string& node_id, std::weak_ptr<Nexus::rpc::NodeImpl> node) {
     std::lock_guard<std::mutex> lock(nodes_mutex_);
     nodes_[node_id] = node;
+    if (subscriptions_.count(node_id) > 0) {
+        publishSubscribers();  // Re-registered under the same id: list the new instance
+    }
+    invalidateRoutes();
 }
 
 void GlobalRegistry::unregisterNode(const std::string& node_id) {
@@ -23,13 +89,25 @@ void GlobalRegistry::unregisterNode(const std::string& node_id) {
     {
         std::lock_guard<std::mutex> lock(nodes_mutex_);
         nodes_.erase(node_id);
+        if (subscriptions_.erase(node_id) > 0) {
+            publishSubscribers();
+        }
     }
 
     // Then, clean up all services registered by this node
     // This prevents "zombie services" from remaining after node destruction
     {
         std::lock_guard<std::mutex> lock(services_mutex_);
-        for (auto it = services_.begin(); it != services_.end();) {
+        // Only the groups the node has services in (node index of the current snapshot)
+        std::set<std::string> groups;
+        for (const auto& svc : services_index_->node(node_id)) {
+            groups.insert(svc.group);
+        }
+        for (const auto& group : groups) {
+            auto it = services_.find(group);
+            if (it == services_.end()) {
+                continue;
+            }
             auto& vec = it->second;
 
             // Remove all services from this node
@@ -40,12 +118,15 @@ void GlobalRegistry::unregisterNode(const std::string& node_id) {
 
             // Remove empty groups
             if (vec.empty()) {
-                it = services_.erase(it);
-            } else {
-                ++it;
+                services_.erase(it);
             }
         }
+        if (!groups.empty()) {
+            publishServices();
+        }
     }
+
+    invalidateRoutes();
 }
 
 std::vector<std::shared_ptr<Nexus::rpc::NodeImpl>> GlobalRegistry::getAllNodes() {
@@ -74,6 +155,45 @@ std::shared_ptr<Nexus::rpc::NodeImpl> GlobalRegistry::findNode(const std::string
     return nullptr;
 }
 
+void GlobalRegistry::setSubscriptions(const std::string& node_id, std::vector<uint32_t> topic_ids,
+                                      std::vector<std::string> pattern_groups) {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    if (topic_ids.empty() && pattern_groups.empty()) {
+        if (subscriptions_.erase(node_id) == 0) {
+            return;
+        }
+    } else {
+        NodeSubscriptions& subscriptions = subscriptions_[node_id];
+        subscriptions.topic_ids = std::move(topic_ids);
+        subscriptions.pattern_groups = std::move(pattern_groups);
+    }
+    publishSubscribers();
+}
+
+std::shared_ptr<const InProcessSubscribers> GlobalRegistry::getInProcessSubscribers() const {
+    return std::atomic_load(&subscribers_);
+}
+
+void GlobalRegistry::publishSubscribers() {
+    auto snapshot = std::make_shared<InProcessSubscribers>();
+    for (const auto& node : subscriptions_) {
+        auto it = nodes_.find(node.first);
+        if (it == nodes_.end()) {
+            continue;  // Listed once it registers
+        }
+        for (uint32_t id : node.second.topic_ids) {
+            if (id >= snapshot->by_topic_.size()) {
+                snapshot->by_topic_.resize(id + 1);
+            }
+            snapshot->by_topic_[id].push_back(it->second);
+        }
+        for (const auto& group : node.second.pattern_groups) {
+            snapshot->patterns_[group].push_back(it->second);
+        }
+    }
+    std::atomic_store(&subscribers_, std::shared_ptr<const InProcessSubscribers>(std::move(snapshot)));
+}
+
 void GlobalRegistry::registerService(const std::string& group, const Nexus::rpc::ServiceDescriptor& svc) {
     std::lock_guard<std::mutex> lock(services_mutex_);
     auto& vec = services_[group];
@@ -93,7 +213,16 @@ void GlobalRegistry::registerService(const std::string& group, const Nexus::rpc:
             // Same service from same node
 
             if (existing.transport == svc.transport) {
-                // Exact duplicate (same transport) - ignore
+                // Exact duplicate (same transport) - only refresh the advertised topic id (node restarted)
+                // or the requested lane or rate (resubscribed with other options) or multicast group (config changed)
+                // or the bus reader slot (reattached to a topic bus)
+                if (existing.topic_id != svc.topic_id || existing.priority != svc.priority ||
+                    existing.min_interval_us != svc.min_interval_us || existing.reader_slot != svc.reader_slot ||
+                    existing.multicast_address != svc.multicast_address) {
+                    *it = svc;
+                    publishServices();
+                    invalidateRoutes();
+                }
                 return;
             }
 
@@ -106,6 +235,8 @@ void GlobalRegistry::registerService(const std::string& group, const Nexus::rpc:
             if (svc.transport == Nexus::rpc::TransportType::SHARED_MEMORY) {
                 // New registration is SHARED_MEMORY, replace existing UDP/INPROCESS
                 *it = svc;
+                publishServices();
+                invalidateRoutes();
                 return;
             }
 
@@ -116,6 +247,8 @@ void GlobalRegistry::registerService(const std::string& group, const Nexus::rpc:
 
     // No conflict found, add new service
     vec.push_back(svc);
+    publishServices();
+    invalidateRoutes();
 }
 
 void GlobalRegistry::unregisterService(const std::string& group, const Nexus::rpc::ServiceDescriptor& svc) {
@@ -133,33 +266,35 @@ void GlobalRegistry::unregisterService(const std::string& group, const Nexus::rp
         if (vec.empty()) {
             services_.erase(it);
         }
+        publishServices();
+        invalidateRoutes();
     }
 }
 
 std::vector<Nexus::rpc::ServiceDescriptor> GlobalRegistry::findServices(const std::string& group) {
-    std::lock_guard<std::mutex> lock(services_mutex_);
-    std::vector<Nexus::rpc::ServiceDescriptor> result;
+    const auto services = getServices();
+    return group.empty() ? services->all() : services->group(group);
+}
 
-    if (group.empty()) {
-        // Return all services - C++14 compatible iteration
-        for (auto it = services_.begin(); it != services_.end(); ++it) {
-            const auto& svcs = it->second;
-            result.insert(result.end(), svcs.begin(), svcs.end());
-        }
-    } else {
-        // Return services for specific group
-        auto it = services_.find(group);
-        if (it != services_.end()) {
-            result = it->second;
+std::shared_ptr<const ServiceIndex> GlobalRegistry::getServices() const {
+    return std::atomic_load(&services_index_);
+}
+
+void GlobalRegistry::publishServices() {
+    auto index = std::make_shared<ServiceIndex>();
+    for (const auto& group : services_) {
+        for (const auto& svc : group.second) {
+            index->add(svc);
         }
     }
-
-    return result;
+    std::atomic_store(&services_index_, std::shared_ptr<const ServiceIndex>(std::move(index)));
 }
 
 void GlobalRegistry::clearServices() {
     std::lock_guard<std::mutex> lock(services_mutex_);
     services_.clear();
+    publishServices();
+    invalidateRoutes();
 }
 
 size_t GlobalRegistry::getNodeCount() const {
@@ -168,12 +303,48 @@ size_t GlobalRegistry::getNodeCount() const {
 }
 
 size_t GlobalRegistry::getServiceCount() const {
-    std::lock_guard<std::mutex> lock(services_mutex_);
-    size_t count = 0;
-    for (auto it = services_.begin(); it != services_.end(); ++it) {
-        count += it->second.size();
+    return getServices()->size();
+}
+
+TopicHandle GlobalRegistry::resolveTopic(const std::string& group, const std::string& topic) {
+    TopicHandle handle = findTopic(group, topic);
+    if (handle.valid()) {
+        return handle;
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(topics_mutex_);
+    auto& entry = topics_[group][topic];
+    if (!entry) {
+        entry.reset(new TopicHandle::Entry{next_topic_id_++, group, topic, CompactPacket::topicHash(group, topic)});
+        topics_by_id_.push_back(entry.get());
+    }
+    return TopicHandle(entry.get());
+}
+
+TopicHandle GlobalRegistry::findTopic(const std::string& group, const std::string& topic) const {
+    std::shared_lock<std::shared_timed_mutex> lock(topics_mutex_);
+    auto group_it = topics_.find(group);
+    if (group_it == topics_.end()) {
+        return TopicHandle();
+    }
+    auto topic_it = group_it->second.find(topic);
+    if (topic_it == group_it->second.end()) {
+        return TopicHandle();
+    }
+    return TopicHandle(topic_it->second.get());
+}
+
+TopicHandle GlobalRegistry::topicById(uint32_t id) const {
+    std::shared_lock<std::shared_timed_mutex> lock(topics_mutex_);
+    if (id >= topics_by_id_.size()) {
+        return TopicHandle();
     }
-    return count;
+    return TopicHandle(topics_by_id_[id]);
+}
+
+size_t GlobalRegistry::getTopicCount() const {
+    std::shared_lock<std::shared_timed_mutex> lock(topics_mutex_);
+    return next_topic_id_;
 }
 
 }  // namespace rpc
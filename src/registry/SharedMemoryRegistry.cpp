@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>  // For errno
 #include <chrono>
 #include <cstring>
@@ -22,6 +23,15 @@
 #include <sys/neutrino.h>
 #endif
 
+// Linux：waitForChange使用futex（generation位于共享内存，必须使用非PRIVATE操作以支持跨进程唤醒）
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <climits>
+#define NEXUS_REGISTRY_FUTEX 1
+#endif
+
 namespace Nexus {
 namespace rpc {
 
@@ -185,6 +195,7 @@ bool SharedMemoryRegistry::initialize() {
         registry_->header.version.store(VERSION, std::memory_order_relaxed);
         registry_->header.num_entries.store(0, std::memory_order_relaxed);
         registry_->header.capacity.store(MAX_REGISTRY_ENTRIES, std::memory_order_relaxed);
+        registry_->header.generation.store(0, std::memory_order_relaxed);
 
         // 🔧 初始化 ref_pids 数组（但不记录创建者 PID，等 magic 设置后再记录）
         for (size_t i = 0; i < MAX_REGISTRY_ENTRIES; ++i) {
@@ -204,6 +215,14 @@ bool SharedMemoryRegistry::initialize() {
             }
             registry_->entries[i].pid.store(0, std::memory_order_relaxed);
             registry_->entries[i].last_heartbeat.store(0, std::memory_order_relaxed);
+            registry_->entries[i].node_hash.store(0, std::memory_order_relaxed);
+        }
+
+        // Empty hash index
+        registry_->index.updating.store(0, std::memory_order_relaxed);
+        registry_->index.tombstones.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < INDEX_SLOTS; ++i) {
+            registry_->index.slots[i].store(INDEX_EMPTY, std::memory_order_relaxed);
         }
 
         // 🔧 CRITICAL: 在设置magic之前先记录ref_count=1，防止窗口期被误判为无人使用
@@ -328,6 +347,7 @@ bool SharedMemoryRegistry::registerNode(const std::string& node_id, const std::s
         NEXUS_LOG_ERROR("Registry", "Failed to acquire lock for registerNode");
         return false;
     }
+    GenerationWrite write(registry_->header.generation);
 
     // Check if already registered
     int existing_idx = findEntryIndex(node_id);
@@ -377,8 +397,10 @@ bool SharedMemoryRegistry::registerNode(const std::string& node_id, const std::s
     RegistryEntry& entry = registry_->entries[idx];
 
     // 🔧 CRITICAL: Write all fields using atomic operations for cross-process safety
+    const uint64_t hash = hashNodeId(node_id);
     writeAtomicString(entry.node_id_atomic, node_id, NODE_ID_SIZE);
     writeAtomicString(entry.shm_name_atomic, shm_name, SHM_NAME_SIZE);
+    entry.node_hash.store(hash, std::memory_order_relaxed);
     entry.pid.store(getpid(), std::memory_order_seq_cst);
     uint64_t init_ts = getCurrentTimeMs();
     entry.last_heartbeat.store(init_ts, std::memory_order_seq_cst);
@@ -390,6 +412,7 @@ bool SharedMemoryRegistry::registerNode(const std::string& node_id, const std::s
 
     // 🔧 CRITICAL: Set flags last to publish the entry atomically
     entry.flags.store(0x3, std::memory_order_seq_cst);  // valid | active
+    indexInsert(hash, static_cast<uint32_t>(idx));
 
     // 🔧 Update num_entries with release so other processes see the new entry
     registry_->header.num_entries.fetch_add(1, std::memory_order_release);
@@ -418,7 +441,9 @@ bool SharedMemoryRegistry::unregisterNode(const std::string& node_id) {
     }
 
     // Clear entry
+    GenerationWrite write(registry_->header.generation);
     RegistryEntry& entry = registry_->entries[idx];
+    indexRemove(entry.node_hash.load(std::memory_order_relaxed), static_cast<uint32_t>(idx));
 
     // 🔧 CRITICAL: Decrement with release to ensure visibility
     registry_->header.num_entries.fetch_sub(1, std::memory_order_release);
@@ -437,6 +462,7 @@ bool SharedMemoryRegistry::unregisterNode(const std::string& node_id) {
     }
     entry.pid.store(0, std::memory_order_release);
     entry.last_heartbeat.store(0, std::memory_order_release);
+    entry.node_hash.store(0, std::memory_order_relaxed);
 
     NEXUS_LOG_INFO("Registry", "Unregistered node: " + node_id +
                                    " (remaining: " + std::to_string(registry_->header.num_entries.load()) + ")");
@@ -481,18 +507,113 @@ bool SharedMemoryRegistry::updateHeartbeat(const std::string& node_id) {
 
 std::vector<NodeInfo> SharedMemoryRegistry::getAllNodes() const {
     std::vector<NodeInfo> nodes;
+    uint32_t generation = NO_GENERATION;
+    getAllNodesIfChanged(generation, nodes);
+    return nodes;
+}
 
+bool SharedMemoryRegistry::getAllNodesIfChanged(uint32_t& generation, std::vector<NodeInfo>& nodes) const {
     if (!initialized_) {
-        return nodes;
+        return false;
     }
 
-    // 🔧 CRITICAL: 使用锁保护遍历操作
+    // 🔧 无锁读取：写者持锁修改期间 generation 为奇数，读到一半被修改则重读
+    const std::atomic<uint32_t>& current = registry_->header.generation;
+    std::vector<NodeInfo> fresh;
+    for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; ++attempt) {
+        const uint32_t before = current.load(std::memory_order_acquire);
+        if (before == generation) {
+            return false;
+        }
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t after = before;
+        if (readNodes(fresh, after, false)) {
+            nodes.swap(fresh);
+            generation = after;
+            return true;
+        }
+    }
+
+    // 🔧 写者长时间未完成（或已死亡）：退回到持锁读取
     RegistryLock lock(const_cast<pthread_mutex_t*>(&registry_->header.global_lock));
     if (!lock.isLocked()) {
         NEXUS_LOG_ERROR("Registry", "Failed to acquire lock for getAllNodes");
-        return nodes;
+        return false;
+    }
+    uint32_t locked_generation = current.load(std::memory_order_relaxed);
+    if (locked_generation & 1) {
+        // 持锁时仍为奇数：写者死在写区间内，下一个写者会修正
+        locked_generation = NO_GENERATION;
+    }
+    readNodes(fresh, locked_generation, true);
+    nodes.swap(fresh);
+    generation = locked_generation;
+    return true;
+}
+
+bool SharedMemoryRegistry::waitForChange(uint32_t& generation, int timeout_ms,
+                                         const std::atomic<bool>* keep_waiting) const {
+    if (!initialized_) {
+        return false;
     }
 
+    std::atomic<uint32_t>& current = registry_->header.generation;
+    const uint32_t seen = generation;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+#ifndef NEXUS_REGISTRY_FUTEX
+    int backoff_ms = 1;
+#endif
+    while (true) {
+        // 写区间（奇数）结束前不返回：调用方随后读取的是完整的节点集合
+        uint32_t value = current.load(std::memory_order_acquire);
+        if (value != seen && (value & 1) == 0) {
+            generation = value;
+            return true;
+        }
+        if (keep_waiting && !keep_waiting->load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+#ifdef NEXUS_REGISTRY_FUTEX
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000L);
+        ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000L);
+        // 相对超时；generation已变化时立即返回EAGAIN
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&current), FUTEX_WAIT, value, &ts, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::min(std::chrono::milliseconds(backoff_ms),
+                                             std::chrono::duration_cast<std::chrono::milliseconds>(remaining)));
+        backoff_ms = std::min(backoff_ms * 2, 50);
+#endif
+    }
+}
+
+void SharedMemoryRegistry::wakeWaiters() const {
+    if (!initialized_) {
+        return;
+    }
+#ifdef NEXUS_REGISTRY_FUTEX
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&registry_->header.generation), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+#endif
+}
+
+SharedMemoryRegistry::GenerationWrite::~GenerationWrite() {
+    generation_.store(generation_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+#ifdef NEXUS_REGISTRY_FUTEX
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&generation_), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+bool SharedMemoryRegistry::readNodes(std::vector<NodeInfo>& nodes, uint32_t& generation, bool locked) const {
+    nodes.clear();
     for (size_t i = 0; i < MAX_REGISTRY_ENTRIES; ++i) {
         const RegistryEntry& entry = registry_->entries[i];
         // 🔧 Use seq_cst for shared memory visibility
@@ -513,7 +634,12 @@ std::vector<NodeInfo> SharedMemoryRegistry::getAllNodes() const {
         nodes.push_back(info);
     }
 
-    return nodes;
+    if (locked) {
+        return true;
+    }
+    // 🔧 Seqlock 校验：读取期间 generation 未变化才算一致快照
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return registry_->header.generation.load(std::memory_order_relaxed) == generation;
 }
 
 bool SharedMemoryRegistry::findNode(const std::string& node_id, NodeInfo& info) const {
@@ -646,6 +772,8 @@ int SharedMemoryRegistry::cleanupStaleNodes(uint64_t timeout_ms) {
             }
 
             // 🔧 Clear flags to invalidate entry
+            GenerationWrite write(registry_->header.generation);
+            indexRemove(entry.node_hash.load(std::memory_order_relaxed), static_cast<uint32_t>(i));
             entry.flags.store(0, std::memory_order_seq_cst);
 
             // 🔧 Increment version to prevent ABA problem
@@ -658,6 +786,7 @@ int SharedMemoryRegistry::cleanupStaleNodes(uint64_t timeout_ms) {
                 entry.node_id_atomic[j].store(0, std::memory_order_release);
                 entry.shm_name_atomic[j].store(0, std::memory_order_release);
             }
+            entry.node_hash.store(0, std::memory_order_relaxed);
 
             // 🔧 Decrement count (use release)
             registry_->header.num_entries.fetch_sub(1, std::memory_order_release);
@@ -892,25 +1021,106 @@ bool SharedMemoryRegistry::forceRemoveRegistry() {
 // Private helper methods
 
 int SharedMemoryRegistry::findEntryIndex(const std::string& node_id) const {
-    for (size_t i = 0; i < MAX_REGISTRY_ENTRIES; ++i) {
-        const RegistryEntry& entry = registry_->entries[i];
-        // 🔧 For shared memory across processes, use seq_cst for cache coherence
-        uint32_t flags = entry.flags.load(std::memory_order_seq_cst);
+    RegistryIndex& index = registry_->index;
+    if (index.updating.load(std::memory_order_acquire) != 0) {
+        // The previous holder of global_lock died while changing the index (EOWNERDEAD recovery)
+        NEXUS_LOG_WARN("Registry", "Rebuilding registry index left half-updated");
+        rebuildIndex();
+    }
 
-        if ((flags & 0x1) == 0) {  // Not valid
+    // Probe from the hash; the 64-bit hash is compared before the entry's node ID is read
+    const uint64_t hash = hashNodeId(node_id);
+    for (size_t probe = 0; probe < INDEX_SLOTS; ++probe) {
+        const uint32_t slot = index.slots[(hash + probe) & (INDEX_SLOTS - 1)].load(std::memory_order_relaxed);
+        if (slot == INDEX_EMPTY) {
+            break;
+        }
+        if (slot == INDEX_REMOVED || slot > MAX_REGISTRY_ENTRIES) {
             continue;
         }
+        const RegistryEntry& entry = registry_->entries[slot - 1];
+        if ((entry.flags.load(std::memory_order_seq_cst) & 0x1) == 0 ||
+            entry.node_hash.load(std::memory_order_relaxed) != hash) {
+            continue;
+        }
+        if (readAtomicString(entry.node_id_atomic, NODE_ID_SIZE) == node_id) {
+            return static_cast<int>(slot - 1);
+        }
+    }
+    return -1;
+}
 
-        // 🔧 Read node_id atomically
-        std::string entry_node_id = readAtomicString(entry.node_id_atomic, NODE_ID_SIZE);
+uint64_t SharedMemoryRegistry::hashNodeId(const std::string& node_id) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : node_id) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash != 0 ? hash : 1;
+}
 
-        if (entry_node_id == node_id) {
-            return static_cast<int>(i);
+void SharedMemoryRegistry::indexInsert(uint64_t hash, uint32_t idx) {
+    RegistryIndex& index = registry_->index;
+    index.updating.store(1, std::memory_order_release);
+    for (size_t probe = 0; probe < INDEX_SLOTS; ++probe) {
+        std::atomic<uint32_t>& slot = index.slots[(hash + probe) & (INDEX_SLOTS - 1)];
+        const uint32_t value = slot.load(std::memory_order_relaxed);
+        if (value == INDEX_EMPTY || value == INDEX_REMOVED) {
+            if (value == INDEX_REMOVED) {
+                index.tombstones.fetch_sub(1, std::memory_order_relaxed);
+            }
+            slot.store(idx + 1, std::memory_order_relaxed);
+            break;
         }
     }
-    return -1;
+    index.updating.store(0, std::memory_order_release);
+}
+
+void SharedMemoryRegistry::indexRemove(uint64_t hash, uint32_t idx) {
+    RegistryIndex& index = registry_->index;
+    index.updating.store(1, std::memory_order_release);
+    for (size_t probe = 0; probe < INDEX_SLOTS; ++probe) {
+        std::atomic<uint32_t>& slot = index.slots[(hash + probe) & (INDEX_SLOTS - 1)];
+        const uint32_t value = slot.load(std::memory_order_relaxed);
+        if (value == INDEX_EMPTY) {
+            break;
+        }
+        if (value == idx + 1) {
+            slot.store(INDEX_REMOVED, std::memory_order_relaxed);
+            index.tombstones.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    index.updating.store(0, std::memory_order_release);
+
+    // Tombstones lengthen every probe that crosses them: start over once they pile up
+    if (index.tombstones.load(std::memory_order_relaxed) > INDEX_SLOTS / 4) {
+        rebuildIndex();
+    }
 }
 
+void SharedMemoryRegistry::rebuildIndex() const {
+    RegistryIndex& index = registry_->index;
+    index.updating.store(1, std::memory_order_release);
+    for (size_t i = 0; i < INDEX_SLOTS; ++i) {
+        index.slots[i].store(INDEX_EMPTY, std::memory_order_relaxed);
+    }
+    index.tombstones.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < MAX_REGISTRY_ENTRIES; ++i) {
+        const RegistryEntry& entry = registry_->entries[i];
+        const uint64_t hash = entry.node_hash.load(std::memory_order_relaxed);
+        if ((entry.flags.load(std::memory_order_seq_cst) & 0x1) == 0 || hash == 0) {
+            continue;
+        }
+        for (size_t probe = 0; probe < INDEX_SLOTS; ++probe) {
+            std::atomic<uint32_t>& slot = index.slots[(hash + probe) & (INDEX_SLOTS - 1)];
+            if (slot.load(std::memory_order_relaxed) == INDEX_EMPTY) {
+                slot.store(i + 1, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    index.updating.store(0, std::memory_order_release);
+}
 
 uint64_t SharedMemoryRegistry::getCurrentTimeMs() const {
     // 🔧 CRITICAL: 使用steady_clock避免NTP时钟回退影响
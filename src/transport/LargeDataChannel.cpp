@@ -11,15 +11,31 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <ctime>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
 
+#include "nexus/utils/Crc32c.h"
 #include "nexus/utils/Logger.h"
+#include "nexus/utils/Numa.h"
+#include "nexus/utils/ShmMapping.h"
+#include "nexus/utils/Tracepoints.h"
+
+// Linux：waitForData使用futex（控制块位于共享内存，必须使用非PRIVATE操作以支持跨进程唤醒）
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <climits>
+#define NEXUS_LARGE_DATA_FUTEX 1
+#endif
 
 // ============ LargeDataChannel Constants ============
 #define LARGE_DATA_CLEANUP_INTERVAL_S 30  // Dead reader cleanup interval (seconds)
@@ -33,45 +49,9 @@ namespace rpc {
 static std::atomic<bool> g_cleanup_done{false};
 static std::mutex g_cleanup_mutex;
 
-// CRC32查找表
-static const uint32_t crc32_table[256] = {
-    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3, 0x0edb8832,
-    0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
-    0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7, 0x136c9856, 0x646ba8c0, 0xfd62f97a,
-    0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3,
-    0x45df5c75, 0xdcd60dcf, 0xabd13d59, 0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
-    0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab,
-    0xb6662d3d, 0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01, 0x6b6b51f4,
-    0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
-    0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65, 0x4db26158, 0x3ab551ce, 0xa3bc0074,
-    0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525,
-    0x206f85b3, 0xb966d409, 0xce61e49f, 0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
-    0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615,
-    0x73dc1683, 0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7, 0xfed41b76,
-    0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
-    0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b, 0xd80d2bda, 0xaf0a1b4c, 0x36034af6,
-    0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7,
-    0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d, 0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
-    0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7,
-    0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45, 0xa00ae278,
-    0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
-    0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9, 0xbdbdf21c, 0xcabac28a, 0x53b39330,
-    0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
-
-// 计算CRC32
-uint32_t LargeDataChannel::calculateCRC32(const uint8_t* data, size_t size) const {
-    uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = 0; i < size; i++) {
-        crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
-    }
-    return ~crc;
+// 计算数据块校验值
+uint32_t LargeDataChannel::calculateCRC(LargeDataCrc type, const uint8_t* data, size_t size) {
+    return type == LargeDataCrc::CRC32C ? crc32c(0, data, size) : crc32(0, data, size);
 }
 
 // 创建或连接到大数据通道
@@ -107,14 +87,32 @@ LargeDataChannel::LargeDataChannel(const std::string& shm_name, const Config& co
       shm_fd_(-1),
       shm_addr_(nullptr),
       shm_size_(0),
+      map_size_(0),
+      mirrored_(false),
       control_(nullptr),
       buffer_(nullptr),
       reader_id_(-1),  // 初始化为-1（未注册）
+      next_sequence_(0),
+      unverified_blocks_(0),
+      cached_min_read_pos_(0),
+      cached_reader_epoch_(0),
+      last_cleanup_(0),
+      last_writer_heartbeat_(0),
+      last_reader_heartbeat_(0),
+      reserved_header_(nullptr),
+      reserved_size_(0),
+      reserved_reader_mask_(0),
+      stream_active_(false),
+      stream_id_(0),
+      stream_chunk_(0),
+      stream_offset_(0),
+      stream_size_(0),
       total_writes_(0),
       total_reads_(0),
       total_bytes_written_(0),
       total_bytes_read_(0),
-      total_dropped_(0) {}
+      total_dropped_(0),
+      blocks_verified_(0) {}
 
 LargeDataChannel::~LargeDataChannel() {
     // 如果是读者，注销读者槽位
@@ -135,7 +133,7 @@ LargeDataChannel::~LargeDataChannel() {
 
             // 取消映射
             if (shm_addr_ != nullptr && shm_addr_ != MAP_FAILED) {
-                munmap(shm_addr_, shm_size_);
+                munmap(shm_addr_, map_size_);
                 shm_addr_ = nullptr;
             }
 
@@ -158,7 +156,7 @@ LargeDataChannel::~LargeDataChannel() {
 
     // 不是最后一个引用，只取消映射和关闭fd
     if (shm_addr_ != nullptr && shm_addr_ != MAP_FAILED) {
-        munmap(shm_addr_, shm_size_);
+        munmap(shm_addr_, map_size_);
     }
     if (shm_fd_ >= 0) {
         close(shm_fd_);
@@ -167,10 +165,17 @@ LargeDataChannel::~LargeDataChannel() {
 
 bool LargeDataChannel::initialize() {
     // 计算共享内存大小（控制块 + 缓冲区）
-    shm_size_ = sizeof(RingBufferControl) + config_.buffer_size;
+    // 双重映射：缓冲区的偏移和大小都必须按页对齐
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t data_offset = sizeof(RingBufferControl);
+    size_t capacity = config_.buffer_size;
+    if (config_.mirrored) {
+        data_offset = ((data_offset + page_size - 1) / page_size) * page_size;
+        capacity = ((capacity + page_size - 1) / page_size) * page_size;
+    }
+    shm_size_ = data_offset + capacity;
 
     // 对齐到页大小
-    size_t page_size = sysconf(_SC_PAGESIZE);
     shm_size_ = ((shm_size_ + page_size - 1) / page_size) * page_size;
 
     std::string shm_path = "/dev/shm/" + shm_name_;
@@ -203,13 +208,36 @@ bool LargeDataChannel::initialize() {
         }
     }
 
-    // 映射共享内存（使用MAP_NORESERVE优化）
-    int mmap_flags = MAP_SHARED;
-    if (config_.use_mmap_noreserve) {
-        mmap_flags |= MAP_NORESERVE;
+    // 映射共享内存（MAP_NORESERVE优化；可选大页、预分配、mlock）
+    ShmMapOptions map_options;
+    map_options.noreserve = config_.use_mmap_noreserve;
+    map_options.huge_pages = config_.huge_pages;
+    map_options.prefault = config_.prefault;
+    map_options.lock = config_.lock_memory;
+    map_options.numa_node = is_creator ? config_.numa_node : -1;  // NUMA策略属于段本身，由创建者决定
+
+    // 连接者：布局（是否双重映射、缓冲区偏移和大小）由创建者决定
+    mirrored_ = config_.mirrored;
+    if (!is_creator) {
+        void* peek = mmap(nullptr, sizeof(RingBufferControl), PROT_READ, MAP_SHARED, shm_fd_, 0);
+        if (peek != MAP_FAILED) {
+            const RingBufferControl* existing = static_cast<const RingBufferControl*>(peek);
+            mirrored_ = (existing->flags & RingBufferControl::FLAG_MIRRORED) != 0;
+            if (mirrored_) {
+                data_offset = existing->data_offset;
+                capacity = existing->capacity;
+            }
+            munmap(peek, sizeof(RingBufferControl));
+        }
     }
 
-    shm_addr_ = mmap(nullptr, shm_size_, PROT_READ | PROT_WRITE, mmap_flags, shm_fd_, 0);
+    if (mirrored_) {
+        map_size_ = data_offset + 2 * capacity;
+        shm_addr_ = mapSharedMemoryMirrored(shm_fd_, data_offset, capacity, PROT_READ | PROT_WRITE, map_options);
+    } else {
+        map_size_ = shm_size_;
+        shm_addr_ = mapSharedMemory(shm_fd_, shm_size_, PROT_READ | PROT_WRITE, map_options);
+    }
 
     if (shm_addr_ == MAP_FAILED) {
         NEXUS_ERROR("LargeData") << "Failed to mmap shared memory";
@@ -220,16 +248,20 @@ bool LargeDataChannel::initialize() {
 
     // 设置控制块和缓冲区指针
     control_ = reinterpret_cast<RingBufferControl*>(shm_addr_);
-    buffer_ = reinterpret_cast<uint8_t*>(shm_addr_) + sizeof(RingBufferControl);
+    buffer_ = reinterpret_cast<uint8_t*>(shm_addr_) + (mirrored_ ? data_offset : sizeof(RingBufferControl));
 
     // 如果是创建者，初始化控制块
     if (is_creator) {
         control_->write_pos.store(0);
         control_->sequence.store(0);
+        control_->data_seq.store(0);
+        control_->data_waiters.store(0);
         control_->ref_count.store(1, std::memory_order_release);          // 初始引用计数为1
         control_->writer_pid.store(getpid(), std::memory_order_release);  // 记录写端PID
         control_->num_readers.store(0, std::memory_order_release);        // 读者数量初始化为0
-        control_->capacity = config_.buffer_size;
+        control_->capacity = capacity;
+        control_->data_offset = static_cast<uint32_t>(data_offset);
+        control_->flags = mirrored_ ? RingBufferControl::FLAG_MIRRORED : 0;
         // Safe cast: config values are validated and fit in uint32_t
         control_->max_block_size = static_cast<uint32_t>(config_.max_block_size);
         control_->max_readers = static_cast<uint32_t>(config_.max_readers);
@@ -246,7 +278,7 @@ bool LargeDataChannel::initialize() {
                                  << " MB"
                                  << ", max_readers: " << control_->max_readers
                                  << ", MAP_NORESERVE: " << (config_.use_mmap_noreserve ? "yes" : "no")
-                                 << ", PID: " << getpid();
+                                 << ", mirrored: " << (mirrored_ ? "yes" : "no") << ", PID: " << getpid();
     } else {
         // 连接者：递增引用计数
         int32_t new_count = control_->ref_count.fetch_add(1, std::memory_order_acq_rel) + 1;
@@ -259,29 +291,82 @@ bool LargeDataChannel::initialize() {
 
 // 写入大数据
 int64_t LargeDataChannel::write(const std::string& topic, const uint8_t* data, size_t size) {
+    uint8_t* data_ptr = reserveBlock(topic, size);
+    if (!data_ptr) {
+        return -1;
+    }
+
+    // 写入数据（CRC32C：拷贝与校验融合，源数据只从内存读取一次）
+    if (config_.crc_type == LargeDataCrc::CRC32C) {
+        const uint32_t crc = crc32cCopy(0, data_ptr, data, size);
+        return publishBlock(size, &crc);
+    }
+    memcpy(data_ptr, data, size);
+    return publishBlock(size, nullptr);
+}
+
+// 预留数据块（零拷贝写入）
+uint8_t* LargeDataChannel::reserveBlock(const std::string& topic, size_t size, uint16_t reader_mask) {
+    if (reserved_header_) {
+        NEXUS_ERROR("LargeData") << "reserveBlock: previous block not committed";
+        return nullptr;
+    }
+
     if (size > config_.max_block_size) {
         NEXUS_ERROR("LargeData") << "Data size " << size << " exceeds max block size " << config_.max_block_size;
-        return -1;
+        return nullptr;
     }
 
     // 总大小 = 头部 + 数据
     size_t total_size = sizeof(LargeDataHeader) + size;
 
-    // 清理死亡的读者（定期执行）
-    cleanupDeadReaders();
-
-    // 检查可用空间（基于所有读者中的最小read_pos）
-    uint64_t min_read_pos = getMinReadPos();
+    // 检查可用空间（先用缓存的最小read_pos，有新读者注册时重新扫描）
+    uint64_t min_read_pos = cached_min_read_pos_;
+    if (control_->reader_epoch.load(std::memory_order_acquire) != cached_reader_epoch_) {
+        min_read_pos = refreshMinReadPos();
+    }
     uint64_t write_pos = control_->write_pos.load(std::memory_order_acquire);
     uint64_t used = write_pos - min_read_pos;
 
+    // 需要的空间：环绕时还包括尾部浪费的空间（双重映射没有浪费）
+    uint64_t offset = write_pos % control_->capacity;
+    size_t needed =
+        total_size + ((!mirrored_ && offset + total_size > control_->capacity) ? control_->capacity - offset : 0);
+
+    // 缓存显示空间不够：清理死亡的读者（定期执行），重新扫描读者数组
+    if (used + needed > control_->capacity) {
+        cleanupDeadReaders();
+        min_read_pos = refreshMinReadPos();
+        used = write_pos - min_read_pos;
+    }
+
+    // 所有读者都已读过的数据块不再需要记录
+    while (!committed_blocks_.empty() && committed_blocks_.front().first < min_read_pos) {
+        committed_blocks_.pop_front();
+    }
+
+    // DROP_OLDEST策略：把阻碍写入的读者推进到足够新的数据块，然后重新计算
+    if (used + needed > control_->capacity && config_.overflow_policy == LargeDataOverflowPolicy::DROP_OLDEST) {
+        if (evictLaggingReaders(write_pos + needed - control_->capacity, topic) > 0) {
+            min_read_pos = refreshMinReadPos();
+            used = write_pos - min_read_pos;
+        }
+    }
+
+    // BLOCK策略：等待最慢的读者释放空间（有界），然后重新计算
+    if (used + needed > control_->capacity && config_.overflow_policy == LargeDataOverflowPolicy::BLOCK &&
+        waitForSpace(needed)) {
+        min_read_pos = refreshMinReadPos();
+        write_pos = control_->write_pos.load(std::memory_order_acquire);
+        used = write_pos - min_read_pos;
+    }
+
     // 缓冲区满时的处理策略
-    if (used + total_size > control_->capacity) {
+    if (used + needed > control_->capacity) {
         switch (config_.overflow_policy) {
             case LargeDataOverflowPolicy::DROP_OLDEST:
-                // 不实现：SPMC模式下无法安全丢弃（会影响所有读者）
-                // 返回失败，由上层决定是否重试
-                NEXUS_ERROR("LargeData") << "Buffer full (DROP_OLDEST not supported in SPMC mode)";
+                // 推进读者后仍放不下（数据块大于整个缓冲区）
+                NEXUS_ERROR("LargeData") << "Block of " << total_size << " bytes does not fit into the buffer";
                 break;
 
             case LargeDataOverflowPolicy::DROP_NEWEST:
@@ -300,31 +385,40 @@ int64_t LargeDataChannel::write(const std::string& topic, const uint8_t* data, s
                         }
                     }
                 }
-                return -1;
+                return nullptr;
 
             case LargeDataOverflowPolicy::BLOCK:
-                // 阻塞等待（不推荐，可能死锁）
-                NEXUS_ERROR("LargeData") << "Buffer full (BLOCK policy not recommended)";
+                // 等待超时：读者未能及时释放空间
+                NEXUS_ERROR("LargeData") << "Buffer full after waiting " << config_.block_timeout_ms << " ms";
                 break;
         }
 
-        return -1;
+        return nullptr;
     }
 
-    // 更新写端心跳
+    // 更新写端心跳（秒变化时才写共享内存）
     uint64_t current_time = static_cast<uint64_t>(time(nullptr));
-    control_->writer_heartbeat.store(current_time, std::memory_order_relaxed);
-
-    // 获取序列号
-    uint64_t seq = control_->sequence.fetch_add(1);
+    if (current_time != last_writer_heartbeat_) {
+        last_writer_heartbeat_ = current_time;
+        control_->writer_heartbeat.store(current_time, std::memory_order_relaxed);
+    }
 
     // 计算写入位置（环形缓冲区）
     uint64_t write_offset = write_pos % control_->capacity;
 
-    // 检查是否需要环绕
-    if (write_offset + total_size > control_->capacity) {
+    // 检查是否需要环绕（双重映射时数据块跨越末尾连续写入，读者同样连续读取）
+    if (!mirrored_ && write_offset + total_size > control_->capacity) {
         // 环绕到开头（浪费剩余空间）
         uint64_t skip_size = control_->capacity - write_offset;
+        uint64_t skip_start = write_pos;
+
+        // 填充标记：落后的读者读到这里时跳到缓冲区开头（放不下头部时读者按剩余长度判断）
+        if (skip_size >= sizeof(LargeDataHeader)) {
+            LargeDataHeader* pad = reinterpret_cast<LargeDataHeader*>(buffer_ + write_offset);
+            pad->size = static_cast<uint32_t>(skip_size - sizeof(LargeDataHeader));
+            reinterpret_cast<std::atomic<uint32_t>*>(&pad->magic)->store(LargeDataHeader::PAD_MAGIC,
+                                                                         std::memory_order_release);
+        }
         control_->write_pos.fetch_add(skip_size);
         write_pos = control_->write_pos.load();
         write_offset = 0;
@@ -333,8 +427,8 @@ int64_t LargeDataChannel::write(const std::string& topic, const uint8_t* data, s
         for (size_t i = 0; i < MAX_READERS; ++i) {
             if (control_->readers[i].active.load(std::memory_order_acquire)) {
                 uint64_t reader_pos = control_->readers[i].read_pos.load(std::memory_order_acquire);
-                // 如果读者还在旧的环内，需要跳过浪费的空间
-                if (reader_pos < write_pos && (reader_pos % control_->capacity) >= write_offset) {
+                // 只移动位于浪费空间内的读者（已读完所有数据块）；落后的读者稍后读到浪费空间时再跳过
+                if (reader_pos >= skip_start && reader_pos < write_pos) {
                     control_->readers[i].read_pos.store(write_pos, std::memory_order_release);
                     NEXUS_WARN("LargeData")
                         << "Reader #" << i << " skipped " << skip_size << " bytes due to ring wrap (from " << reader_pos
@@ -348,16 +442,55 @@ int64_t LargeDataChannel::write(const std::string& topic, const uint8_t* data, s
     LargeDataHeader* header = reinterpret_cast<LargeDataHeader*>(buffer_ + write_offset);
     header->magic = 0;  // 暂时设为0，最后才写入作为"完成标志"
     header->size = static_cast<uint32_t>(size);
-    header->sequence = seq;
     strncpy(header->topic, topic.c_str(), sizeof(header->topic) - 1);
     header->topic[sizeof(header->topic) - 1] = '\0';
 
-    // 写入数据
-    uint8_t* data_ptr = buffer_ + write_offset + sizeof(LargeDataHeader);
-    memcpy(data_ptr, data, size);
+    reserved_header_ = header;
+    reserved_size_ = size;
+    reserved_reader_mask_ = reader_mask;
+    return buffer_ + write_offset + sizeof(LargeDataHeader);
+}
 
-    // 计算CRC32
-    header->crc32 = calculateCRC32(data, size);
+int64_t LargeDataChannel::commitBlock() {
+    return commitBlock(reserved_size_);
+}
+
+int64_t LargeDataChannel::commitBlock(size_t size) {
+    return publishBlock(size, nullptr);
+}
+
+int64_t LargeDataChannel::publishBlock(size_t size, const uint32_t* crc, uint8_t stream_flags) {
+    LargeDataHeader* header = reserved_header_;
+    if (!header || size > reserved_size_) {
+        NEXUS_ERROR("LargeData") << "commitBlock: no reserved block of " << size << " bytes";
+        return -1;
+    }
+    reserved_header_ = nullptr;
+
+    // 获取序列号（提交时分配：放弃的预留块不占用序列号）
+    uint64_t seq = control_->sequence.fetch_add(1);
+    header->size = static_cast<uint32_t>(size);
+    header->sequence = seq;
+
+    // 计算校验值（数据已由生产者直接写入共享内存）
+    const uint8_t* data_ptr = reinterpret_cast<const uint8_t*>(header) + sizeof(LargeDataHeader);
+    header->crc_type = static_cast<uint8_t>(config_.crc_type);
+    header->stream_flags = stream_flags;
+    if (stream_flags) {
+        stream_id_ = stream_chunk_ == 0 ? seq : stream_id_;
+        header->chunk_index = stream_chunk_;
+        header->stream_id = stream_id_;
+        header->stream_offset = stream_offset_;
+        header->stream_size = stream_size_;
+    } else {
+        header->chunk_index = 0;
+        header->stream_id = 0;
+        header->stream_offset = 0;
+        header->stream_size = 0;
+    }
+    header->reader_mask = reserved_reader_mask_;
+    memset(header->reserved, 0, sizeof(header->reserved));
+    header->crc32 = crc ? *crc : calculateCRC(config_.crc_type, data_ptr, size);
 
     // 内存屏障：确保所有数据写入对其他进程可见
     std::atomic_thread_fence(std::memory_order_release);
@@ -367,20 +500,122 @@ int64_t LargeDataChannel::write(const std::string& topic, const uint8_t* data, s
     reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->store(LargeDataHeader::MAGIC, std::memory_order_release);
 
     // 更新写指针（使用release语义）
-    control_->write_pos.fetch_add(total_size, std::memory_order_release);
+    const uint64_t block_pos = control_->write_pos.fetch_add(sizeof(LargeDataHeader) + size, std::memory_order_release);
+    committed_blocks_.emplace_back(block_pos, seq);
+
+    // 唤醒waitForData：与读者 data_waiters++ 后重查write_pos配对，二者至少有一方看到对方
+    control_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+#ifdef NEXUS_LARGE_DATA_FUTEX
+    if (control_->data_waiters.load(std::memory_order_seq_cst) != 0) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&control_->data_seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+                0);
+    }
+#endif
 
     // 更新统计
     total_writes_.fetch_add(1);
     total_bytes_written_.fetch_add(size);
+    NEXUS_TRACE3(large_write, shm_name_.c_str(), size, seq);
+
+    return seq;
+}
+
+void LargeDataChannel::abortBlock() {
+    reserved_header_ = nullptr;
+    reserved_size_ = 0;
+    reserved_reader_mask_ = 0;
+}
+
+// 开始流式写入
+bool LargeDataChannel::beginStream(const std::string& topic, uint64_t total_size) {
+    if (stream_active_) {
+        NEXUS_ERROR("LargeData") << "beginStream: previous stream not finished";
+        return false;
+    }
+    stream_active_ = true;
+    stream_topic_ = topic;
+    stream_id_ = 0;
+    stream_chunk_ = 0;
+    stream_offset_ = 0;
+    stream_size_ = total_size;
+    return true;
+}
+
+// 追加流数据（拆分为分块，每个分块提交后读者即可读取）
+int64_t LargeDataChannel::writeStream(const uint8_t* data, size_t size, bool last) {
+    if (!stream_active_) {
+        NEXUS_ERROR("LargeData") << "writeStream: no stream";
+        return -1;
+    }
+
+    const size_t chunk_size = std::max<size_t>(std::min(config_.stream_chunk_size, config_.max_block_size), 1);
+    int64_t seq = -1;
+    size_t written = 0;
+    do {
+        size_t chunk = std::min(chunk_size, size - written);
+        bool final_chunk = last && written + chunk == size;
+        uint8_t flags = LargeDataHeader::STREAM_CHUNK | (final_chunk ? LargeDataHeader::STREAM_END : 0);
+        seq = writeStreamChunk(data + written, chunk, flags);
+        if (seq < 0) {
+            return -1;
+        }
+        written += chunk;
+    } while (written < size);
+
+    if (last) {
+        stream_active_ = false;
+    }
+    return seq;
+}
 
+void LargeDataChannel::abortStream() {
+    if (!stream_active_) {
+        return;
+    }
+    // 还没有写入分块时读者什么都没收到，不需要结束标记
+    if (stream_chunk_ > 0) {
+        writeStreamChunk(nullptr, 0,
+                         LargeDataHeader::STREAM_CHUNK | LargeDataHeader::STREAM_END | LargeDataHeader::STREAM_ABORTED);
+    }
+    stream_active_ = false;
+}
+
+int64_t LargeDataChannel::writeStreamChunk(const uint8_t* data, size_t size, uint8_t stream_flags) {
+    uint8_t* data_ptr = reserveBlock(stream_topic_, size);
+    if (!data_ptr) {
+        return -1;
+    }
+
+    int64_t seq;
+    if (config_.crc_type == LargeDataCrc::CRC32C) {
+        const uint32_t crc = crc32cCopy(0, data_ptr, data, size);
+        seq = publishBlock(size, &crc, stream_flags);
+    } else {
+        if (size > 0) {
+            memcpy(data_ptr, data, size);
+        }
+        seq = publishBlock(size, nullptr, stream_flags);
+    }
+    if (seq >= 0) {
+        ++stream_chunk_;
+        stream_offset_ += size;
+    }
     return seq;
 }
 
+// 🔧 立即注册为读者（tryRead/waitForData会在第一次调用时注册，但总是从0开始）
+int32_t LargeDataChannel::attachReader(bool from_latest) {
+    if (reader_id_ < 0) {
+        reader_id_ = registerReader(from_latest);
+    }
+    return reader_id_;
+}
+
 // 尝试读取数据块
 bool LargeDataChannel::tryRead(DataBlock& block) {
     // 如果还未注册为读者，先注册
     if (reader_id_ < 0) {
-        reader_id_ = registerReader();
+        reader_id_ = registerReader(false);
         if (reader_id_ < 0) {
             NEXUS_ERROR("LargeData") << "Failed to register as reader (max readers exceeded)";
             return false;
@@ -394,17 +629,6 @@ bool LargeDataChannel::tryRead(DataBlock& block) {
     uint64_t read_pos = control_->readers[reader_id_].read_pos.load(std::memory_order_acquire);
     uint64_t write_pos = control_->write_pos.load(std::memory_order_acquire);
 
-    // 🔧 关键优化：检查read_pos是否指向已被覆盖的数据
-    // 在环形缓冲区中，有效数据范围是 [min_read_pos, write_pos)
-    uint64_t min_read_pos = getMinReadPos();
-    if (read_pos < min_read_pos) {
-        // read_pos指向的数据已被覆盖，跳到当前可读的最早位置
-        control_->readers[reader_id_].read_pos.store(min_read_pos, std::memory_order_release);
-        read_pos = min_read_pos;
-        NEXUS_WARN("LargeData") << "Reader #" << reader_id_ << " read_pos was behind, adjusted from 0 to "
-                                << min_read_pos;
-    }
-
     // 检查是否有数据
     if (read_pos >= write_pos) {
         return false;
@@ -415,6 +639,20 @@ bool LargeDataChannel::tryRead(DataBlock& block) {
 
     // 计算读取位置
     uint64_t read_offset = read_pos % control_->capacity;
+
+    // 写者环绕时跳过的尾部（剩余空间放不下头部，或写者留下了填充标记）
+    if (!mirrored_) {
+        uint64_t tail = control_->capacity - read_offset;
+        if (tail < sizeof(LargeDataHeader) ||
+            reinterpret_cast<const std::atomic<uint32_t>*>(buffer_ + read_offset)->load(std::memory_order_acquire) ==
+                LargeDataHeader::PAD_MAGIC) {
+            // CAS：DROP_OLDEST写者可能同时推进了本读者
+            uint64_t expected = read_pos;
+            control_->readers[reader_id_].read_pos.compare_exchange_strong(expected, read_pos + tail,
+                                                                           std::memory_order_acq_rel);
+            return tryRead(block);
+        }
+    }
     size_t available = write_pos - read_pos;
 
     // 检查是否有足够的数据读取头部
@@ -425,8 +663,19 @@ bool LargeDataChannel::tryRead(DataBlock& block) {
     // 读取头部
     const LargeDataHeader* header = reinterpret_cast<const LargeDataHeader*>(buffer_ + read_offset);
 
+    // 校验策略：FULL每块都算CRC；SAMPLED每verify_interval块算一次；TRUST只检查magic和序列号
+    bool verify_crc = true;
+    if (config_.verify_mode == LargeDataVerifyMode::TRUST) {
+        verify_crc = false;
+    } else if (config_.verify_mode == LargeDataVerifyMode::SAMPLED) {
+        verify_crc = unverified_blocks_ + 1 >= std::max<uint32_t>(config_.verify_interval, 1);
+    }
+
     // 验证数据块（包括检查magic是否已写入）
-    ReadResult validation_result = validateBlock(header, available);
+    ReadResult validation_result = validateBlock(header, available, verify_crc);
+    if (validation_result == ReadResult::SUCCESS && !verify_crc && header->sequence < next_sequence_) {
+        validation_result = ReadResult::SEQUENCE_ERROR;
+    }
 
     if (validation_result != ReadResult::SUCCESS) {
         // 根据错误类型决定是否跳过
@@ -435,39 +684,114 @@ bool LargeDataChannel::tryRead(DataBlock& block) {
             block.result = validation_result;
             return false;
         } else {
-            // SIZE_EXCEEDED或CRC_ERROR，跳过这个数据块
+            // SIZE_EXCEEDED、CRC_ERROR或SEQUENCE_ERROR，跳过这个数据块
             control_->readers[reader_id_].read_pos.fetch_add(sizeof(LargeDataHeader), std::memory_order_release);
             block.result = validation_result;
             return false;
         }
     }
 
+    if (verify_crc) {
+        unverified_blocks_ = 0;
+        blocks_verified_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        ++unverified_blocks_;
+    }
+
     // 填充DataBlock
     block.header = header;
     block.data = buffer_ + read_offset + sizeof(LargeDataHeader);
     block.size = header->size;
     block.result = ReadResult::SUCCESS;
+    block.position = read_pos;
+    NEXUS_TRACE3(large_read, shm_name_.c_str(), block.size, header->sequence);
+
+    return true;
+}
+
+// 阻塞等待数据
+bool LargeDataChannel::waitForData(int timeout_ms) {
+    if (reader_id_ < 0) {
+        reader_id_ = registerReader(false);
+        if (reader_id_ < 0) {
+            NEXUS_ERROR("LargeData") << "Failed to register as reader (max readers exceeded)";
+            return false;
+        }
+    }
+
+    updateReaderHeartbeat(reader_id_);
+
+    std::atomic<uint64_t>& read_pos = control_->readers[reader_id_].read_pos;
+    auto hasData = [&]() {
+        return read_pos.load(std::memory_order_acquire) < control_->write_pos.load(std::memory_order_seq_cst);
+    };
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+#ifdef NEXUS_LARGE_DATA_FUTEX
+    while (!hasData()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
 
+        uint32_t seq = control_->data_seq.load(std::memory_order_acquire);
+        control_->data_waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (!hasData()) {
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000L);
+            ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000L);
+            // 相对超时；seq已变化时立即返回EAGAIN
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&control_->data_seq), FUTEX_WAIT, seq, &ts, nullptr, 0);
+        }
+        control_->data_waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
     return true;
+#else
+    int backoff_us = 50;
+    while (!hasData()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+        backoff_us = std::min(backoff_us * 2, 1000);
+    }
+    return true;
+#endif
 }
 
 // 释放数据块
-void LargeDataChannel::releaseBlock(const DataBlock& block) {
+bool LargeDataChannel::releaseBlock(const DataBlock& block) {
     if (!block.isValid() || reader_id_ < 0) {
-        return;
+        return false;
     }
 
-    // 更新当前读者的read_pos（使用release语义）
+    // 更新当前读者的read_pos（CAS：DROP_OLDEST写者可能已在读取期间推进了本读者）
     size_t total_size = sizeof(LargeDataHeader) + block.size;
-    control_->readers[reader_id_].read_pos.fetch_add(total_size, std::memory_order_release);
+    uint64_t expected = block.position;
+    if (!control_->readers[reader_id_].read_pos.compare_exchange_strong(expected, block.position + total_size,
+                                                                         std::memory_order_acq_rel)) {
+        size_t dropped = total_dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+        NEXUS_WARN("LargeData") << "Reader #" << reader_id_ << " was overrun while reading block at " << block.position;
+        if (config_.overflow_callback) {
+            try {
+                config_.overflow_callback(shm_name_, block.getTopic(), block.header->sequence, dropped);
+            } catch (...) {
+                // 忽略回调异常
+            }
+        }
+        return false;
+    }
+    next_sequence_ = block.header->sequence + 1;
 
     // 更新统计
     total_reads_.fetch_add(1, std::memory_order_relaxed);
     total_bytes_read_.fetch_add(block.size, std::memory_order_relaxed);
+    return true;
 }
 
 // 验证数据块（返回详细错误）
-LargeDataChannel::ReadResult LargeDataChannel::validateBlock(const LargeDataHeader* header, size_t available) const {
+LargeDataChannel::ReadResult LargeDataChannel::validateBlock(const LargeDataHeader* header, size_t available,
+                                                             bool verify_crc) const {
     // 检查魔数（可能数据还未写完）
     // 必须使用atomic load确保跨进程可见性
     uint32_t magic = reinterpret_cast<const std::atomic<uint32_t>*>(&header->magic)->load(std::memory_order_acquire);
@@ -487,12 +811,18 @@ LargeDataChannel::ReadResult LargeDataChannel::validateBlock(const LargeDataHead
         return ReadResult::INSUFFICIENT;
     }
 
-    // 验证CRC32
+    if (!verify_crc) {
+        return ReadResult::SUCCESS;
+    }
+
+    // 验证校验值（算法由写者在头部声明；未知值按旧版本的CRC32处理）
     const uint8_t* data = reinterpret_cast<const uint8_t*>(header) + sizeof(LargeDataHeader);
-    uint32_t calculated_crc = calculateCRC32(data, header->size);
+    const LargeDataCrc crc_type =
+        header->crc_type == static_cast<uint8_t>(LargeDataCrc::CRC32C) ? LargeDataCrc::CRC32C : LargeDataCrc::CRC32;
+    uint32_t calculated_crc = calculateCRC(crc_type, data, header->size);
 
     if (calculated_crc != header->crc32) {
-        NEXUS_ERROR("LargeData") << "CRC32 mismatch: expected " << header->crc32 << ", got " << calculated_crc;
+        NEXUS_ERROR("LargeData") << "CRC mismatch: expected " << header->crc32 << ", got " << calculated_crc;
         return ReadResult::CRC_ERROR;
     }
 
@@ -511,10 +841,23 @@ LargeDataChannel::Stats LargeDataChannel::getStats() const {
     uint64_t min_read_pos = getMinReadPos();
     stats.current_usage = (write_pos > min_read_pos) ? (write_pos - min_read_pos) : 0;
     stats.capacity = control_->capacity;
+    stats.reader_lag = 0;
+    if (reader_id_ >= 0) {
+        uint64_t read_pos = control_->readers[reader_id_].read_pos.load(std::memory_order_acquire);
+        stats.reader_lag = (write_pos > read_pos) ? (write_pos - read_pos) : 0;
+    }
+    stats.verify_mode = config_.verify_mode;
+    stats.blocks_verified = blocks_verified_.load(std::memory_order_relaxed);
+    stats.numa_node = numaNodeOf(control_);
 
     return stats;
 }
 
+MappingUsage LargeDataChannel::getMemoryUsage() const {
+    // 第一个视图[0, shm_size_)已覆盖整个对象，双重映射的环形区页面相同
+    return mappingUsage(shm_addr_, shm_size_);
+}
+
 // 获取可用空间
 size_t LargeDataChannel::getAvailableSpace() const {
     uint64_t write_pos = control_->write_pos.load();
@@ -534,7 +877,30 @@ bool LargeDataChannel::canWrite(size_t size) const {
     return getAvailableSpace() >= size;
 }
 
+// BLOCK策略：读者在其他进程中，没有唤醒通道，按指数退避轮询min_read_pos
+bool LargeDataChannel::waitForSpace(size_t total_size) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.block_timeout_ms);
+    int backoff_us = 50;
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+        backoff_us = std::min(backoff_us * 2, 1000);
+
+        cleanupDeadReaders();  // 死亡的读者不能无限期占用空间
+        uint64_t used = control_->write_pos.load(std::memory_order_acquire) - getMinReadPos();
+        if (used + total_size <= control_->capacity) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // 设置溢出策略
+void LargeDataChannel::setVerifyMode(LargeDataVerifyMode mode, uint32_t interval) {
+    config_.verify_mode = mode;
+    config_.verify_interval = std::max<uint32_t>(interval, 1);
+    unverified_blocks_ = 0;
+}
+
 void LargeDataChannel::setOverflowPolicy(LargeDataOverflowPolicy policy) {
     config_.overflow_policy = policy;
     NEXUS_DEBUG("LargeData") << "Overflow policy set to: "
@@ -712,25 +1078,35 @@ size_t LargeDataChannel::cleanupOrphanedChannels(uint32_t timeout_seconds) {
 // ============ SPMC辅助方法 ============
 
 // 注册读者，返回reader_id（-1表示失败）
-int32_t LargeDataChannel::registerReader() {
-    // 查找空闲槽位
-    for (size_t i = 0; i < MAX_READERS; ++i) {
-        bool expected = false;
-        if (control_->readers[i].active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-            // 成功占用槽位，初始化
-            // 🔧 策略：从0开始读取，但在tryRead时会检查并跳过已被覆盖的数据
-            // 这样可以读取注册前已写入的所有数据（如果还在缓冲区中）
-            control_->readers[i].read_pos.store(0, std::memory_order_release);
-            control_->readers[i].pid.store(getpid(), std::memory_order_release);
-            control_->readers[i].heartbeat.store(static_cast<uint64_t>(time(nullptr)), std::memory_order_release);
-
-            // 递增读者计数
-            uint32_t new_count = control_->num_readers.fetch_add(1, std::memory_order_acq_rel) + 1;
-
-            NEXUS_DEBUG("LargeData") << "Registered as reader #" << i << ", total readers: " << new_count
-                                     << ", PID: " << getpid();
-
-            return static_cast<int32_t>(i);
+int32_t LargeDataChannel::registerReader(bool from_latest) {
+    // 查找空闲槽位；没有空闲槽位时立即清理一次死亡的读者再找（写端只在空间不够时才清理）
+    for (size_t attempt = 0; attempt < 2; ++attempt) {
+        if (attempt > 0) {
+            cleanupDeadReaders(true);
+        }
+        for (size_t i = 0; i < MAX_READERS; ++i) {
+            bool expected = false;
+            if (control_->readers[i].active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                // 成功占用槽位，初始化
+                // 🔧 策略：从0开始读取，已被覆盖的数据由validateBlock识别
+                // 这样可以读取注册前已写入的所有数据（如果还在缓冲区中）；from_latest时从write_pos开始
+                // （write_pos总是落在数据块边界上）
+                const uint64_t start = from_latest ? control_->write_pos.load(std::memory_order_acquire) : 0;
+                control_->readers[i].read_pos.store(start, std::memory_order_release);
+                control_->readers[i].pid.store(getpid(), std::memory_order_release);
+                control_->readers[i].heartbeat.store(static_cast<uint64_t>(time(nullptr)), std::memory_order_release);
+
+                // 通知写者：缓存的最小read_pos已失效
+                control_->reader_epoch.fetch_add(1, std::memory_order_acq_rel);
+
+                // 递增读者计数
+                uint32_t new_count = control_->num_readers.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+                NEXUS_DEBUG("LargeData") << "Registered as reader #" << i << ", total readers: " << new_count
+                                         << ", PID: " << getpid();
+
+                return static_cast<int32_t>(i);
+            }
         }
     }
 
@@ -755,7 +1131,68 @@ void LargeDataChannel::unregisterReader(int32_t reader_id) {
                              << (prev_count - 1);
 }
 
+// DROP_OLDEST：把read_pos < required_pos的读者推进到第一个不早于required_pos的数据块，返回推进的读者数量
+size_t LargeDataChannel::evictLaggingReaders(uint64_t required_pos, const std::string& topic) {
+    // 目标位置取自写端记录的数据块边界；没有记录（写者重启过）时推进到write_pos
+    uint64_t target = control_->write_pos.load(std::memory_order_acquire);
+    for (const auto& committed : committed_blocks_) {
+        if (committed.first >= required_pos) {
+            target = committed.first;
+            break;
+        }
+    }
+
+    size_t evicted = 0;
+    for (size_t i = 0; i < MAX_READERS; ++i) {
+        ReaderSlot& reader = control_->readers[i];
+        if (!reader.active.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        // CAS：读者可能同时在释放数据块（它自己跟上了就不再推进）
+        uint64_t pos = reader.read_pos.load(std::memory_order_acquire);
+        bool moved = false;
+        while (pos < required_pos && !moved) {
+            moved = reader.read_pos.compare_exchange_weak(pos, target, std::memory_order_acq_rel);
+        }
+        if (!moved) {
+            continue;
+        }
+
+        // 统计被该读者跳过的数据块
+        size_t skipped = 0;
+        uint64_t first_sequence = control_->sequence.load(std::memory_order_relaxed);
+        for (const auto& committed : committed_blocks_) {
+            if (committed.first >= pos && committed.first < target) {
+                first_sequence = skipped == 0 ? committed.second : first_sequence;
+                ++skipped;
+            }
+        }
+        size_t dropped = total_dropped_.fetch_add(skipped, std::memory_order_relaxed) + skipped;
+        ++evicted;
+        NEXUS_WARN("LargeData") << "Reader #" << i << " lagging, skipped " << skipped << " block(s) (from " << pos
+                                << " to " << target << ")";
+
+        // 调用溢出回调
+        if (config_.overflow_callback) {
+            try {
+                config_.overflow_callback(shm_name_, topic, first_sequence, dropped);
+            } catch (...) {
+                // 忽略回调异常
+            }
+        }
+    }
+    return evicted;
+}
+
 // 获取所有读者中的最小read_pos（用于垃圾回收）
+uint64_t LargeDataChannel::refreshMinReadPos() {
+    // 先读epoch再扫描：扫描期间注册的读者会让下次检查再扫描一次
+    cached_reader_epoch_ = control_->reader_epoch.load(std::memory_order_acquire);
+    cached_min_read_pos_ = getMinReadPos();
+    return cached_min_read_pos_;
+}
+
 uint64_t LargeDataChannel::getMinReadPos() const {
     uint64_t min_pos = control_->write_pos.load(std::memory_order_acquire);
 
@@ -778,19 +1215,21 @@ void LargeDataChannel::updateReaderHeartbeat(int32_t reader_id) {
     }
 
     uint64_t current_time = static_cast<uint64_t>(time(nullptr));
-    control_->readers[reader_id].heartbeat.store(current_time, std::memory_order_relaxed);
+    if (current_time != last_reader_heartbeat_) {
+        last_reader_heartbeat_ = current_time;
+        control_->readers[reader_id].heartbeat.store(current_time, std::memory_order_relaxed);
+    }
 }
 
 // 清理死亡的读者
-void LargeDataChannel::cleanupDeadReaders() {
+void LargeDataChannel::cleanupDeadReaders(bool force) {
     uint64_t current_time = static_cast<uint64_t>(time(nullptr));
-    static uint64_t last_cleanup = 0;
 
     // 定期清理（每30秒）
-    if (current_time - last_cleanup < LARGE_DATA_CLEANUP_INTERVAL_S) {
+    if (!force && current_time - last_cleanup_ < LARGE_DATA_CLEANUP_INTERVAL_S) {
         return;
     }
-    last_cleanup = current_time;
+    last_cleanup_ = current_time;
 
     // 辅助函数：检查进程是否存活
     auto isProcessAlive = [](int32_t pid) -> bool {
@@ -0,0 +1,408 @@
+#include "nexus/transport/ReliableUdpChannel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "nexus/transport/UdpTransport.h"
+
+namespace Nexus {
+namespace rpc {
+
+constexpr uint32_t ReliableUdpChannel::MAX_OUT_OF_ORDER;
+constexpr uint16_t ReliableUdpChannel::MAX_NACKS;
+constexpr uint32_t ReliableUdpChannel::ACK_EVERY;
+
+namespace {
+// Signed distance between sequence numbers (correct across wrap-around)
+int32_t seqDistance(uint32_t to, uint32_t from) {
+    return static_cast<int32_t>(to - from);
+}
+}  // namespace
+
+ReliableUdpChannel::ReliableUdpChannel(UdpTransport& transport, const std::string& node_id, const Options& options)
+    : transport_(transport), node_id_(node_id), options_(options), next_stream_id_(std::random_device{}()) {
+    // Room for the packet header, group and topic in the first fragment
+    const size_t max_fragment = MessagePacket::MAX_PAYLOAD_LEN - sizeof(ReliableFragment) -
+                                MessagePacket::MAX_GROUP_LEN - MessagePacket::MAX_TOPIC_LEN;
+    options_.fragment_size = std::max<size_t>(1, std::min(options_.fragment_size, max_fragment));
+    options_.window = std::max<uint32_t>(1, std::min(options_.window, MAX_OUT_OF_ORDER));
+    options_.retransmit_ms = std::max<uint32_t>(1, options_.retransmit_ms);
+    options_.max_message_size = std::min<size_t>(options_.max_message_size, UINT32_MAX);
+    retransmit_thread_ = std::thread(&ReliableUdpChannel::retransmitThread, this);
+}
+
+ReliableUdpChannel::~ReliableUdpChannel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    window_cv_.notify_all();
+    retransmit_cv_.notify_all();
+    if (retransmit_thread_.joinable()) {
+        retransmit_thread_.join();
+    }
+}
+
+void ReliableUdpChannel::setMessageCallback(MessageCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    callback_ = std::move(callback);
+}
+
+ReliableUdpChannel::Stats ReliableUdpChannel::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+uint64_t ReliableUdpChannel::destinationKey(const sockaddr_in& dest) {
+    return (static_cast<uint64_t>(dest.sin_addr.s_addr) << 16) | dest.sin_port;
+}
+
+bool ReliableUdpChannel::send(const sockaddr_in& dest, const std::string& group, const std::string& topic,
+                              const uint8_t* payload, size_t size) {
+    if (size > options_.max_message_size || (!payload && size > 0) || group.size() > MessagePacket::MAX_GROUP_LEN ||
+        topic.size() > MessagePacket::MAX_TOPIC_LEN) {
+        return false;
+    }
+
+    const auto timeout = std::chrono::milliseconds(options_.timeout_ms);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto inserted = send_streams_.emplace(destinationKey(dest), SendStream());
+    SendStream& stream = inserted.first->second;
+    if (inserted.second) {
+        stream.dest = dest;
+        stream.stream_id = newStreamId();
+    }
+
+    // The fragments of a message take consecutive sequence numbers: one message at a time per stream
+    if (!window_cv_.wait_for(lock, timeout, [&] { return !stream.busy || stopping_; }) || stopping_) {
+        return false;
+    }
+    stream.busy = true;
+    const uint32_t stream_id = stream.stream_id;
+    ++stats_.messages_sent;
+
+    const uint16_t udp_port = transport_.getPort();
+    const std::string no_name;
+    size_t first_unsent = stream.unacked.size();
+    size_t offset = 0;
+    bool sent = true;
+    do {
+        if (stream.unacked.size() - first_unsent >= UdpTransport::SEND_BATCH) {
+            flushFragments(stream, first_unsent);  // One sendmmsg per batch while the window has room
+            first_unsent = stream.unacked.size();
+        }
+        if (stream.unacked.size() >= options_.window) {
+            flushFragments(stream, first_unsent);
+            const bool space = window_cv_.wait_for(
+                lock, timeout, [&] { return stream.unacked.size() < options_.window || stopping_; });
+            // A restarted stream dropped the beginning of this message
+            if (!space || stopping_ || stream.stream_id != stream_id) {
+                sent = false;
+                break;
+            }
+            first_unsent = stream.unacked.size();
+        }
+
+        const size_t chunk = std::min(options_.fragment_size, size - offset);
+        // Group and topic only travel with the first fragment
+        const std::string& fragment_group = offset == 0 ? group : no_name;
+        const std::string& fragment_topic = offset == 0 ? topic : no_name;
+        const size_t payload_len = sizeof(ReliableFragment) + chunk;
+
+        if (stream.unacked.empty()) {
+            stream.last_ack = Clock::now();  // Silence is measured from the first fragment in flight
+        }
+        stream.unacked.emplace_back();
+        SentFragment& fragment = stream.unacked.back();
+        fragment.seq = stream.next_seq++;
+        fragment.datagram.resize(MessagePacket::packetSize(fragment_group.size(), fragment_topic.size(), payload_len));
+        MessagePacket* packet =
+            MessageBuilder::buildHeader(fragment.datagram.data(), node_id_, fragment_group, fragment_topic,
+                                        payload_len, udp_port, MessageType::RELIABLE_DATA, options_.checksum);
+        const ReliableFragment header = {stream_id, fragment.seq, static_cast<uint32_t>(size),
+                                         static_cast<uint32_t>(offset)};
+        std::memcpy(packet->getPayload(), &header, sizeof(header));
+        if (chunk > 0) {
+            std::memcpy(packet->getPayload() + sizeof(header), payload + offset, chunk);
+        }
+        packet->checksum = packet->calculateChecksum();
+
+        ++in_flight_;
+        ++stats_.fragments_sent;
+        offset += chunk;
+    } while (offset < size);
+
+    if (sent) {
+        flushFragments(stream, first_unsent);
+    }
+    stream.busy = false;
+    window_cv_.notify_all();
+    return sent;
+}
+
+void ReliableUdpChannel::flushFragments(SendStream& stream, size_t first) {
+    if (first >= stream.unacked.size()) {
+        return;
+    }
+    thread_local std::vector<UdpTransport::Datagram> datagrams;
+    datagrams.clear();
+    const Clock::time_point now = Clock::now();
+    for (size_t i = first; i < stream.unacked.size(); ++i) {
+        SentFragment& fragment = stream.unacked[i];
+        fragment.sent_at = now;
+        datagrams.push_back({fragment.datagram.data(), fragment.datagram.size()});
+    }
+    // Datagrams the socket refuses are resent by the retransmit timer
+    transport_.sendBatch(datagrams.data(), datagrams.size(), stream.dest);
+    retransmit_cv_.notify_one();
+}
+
+void ReliableUdpChannel::resend(SendStream& stream, SentFragment& fragment, Clock::time_point now) {
+    transport_.sendTo(fragment.datagram.data(), fragment.datagram.size(), stream.dest);
+    fragment.sent_at = now;
+    ++stats_.retransmits;
+}
+
+void ReliableUdpChannel::handlePacket(const MessagePacket& packet, const sockaddr_in& from) {
+    switch (static_cast<MessageType>(packet.msg_type)) {
+        case MessageType::RELIABLE_DATA:
+            handleData(packet, from);
+            break;
+        case MessageType::RELIABLE_ACK:
+            handleAck(packet);
+            break;
+        default:
+            break;
+    }
+}
+
+void ReliableUdpChannel::handleAck(const MessagePacket& packet) {
+    ReliableAck ack;
+    if (packet.payload_len < sizeof(ack)) {
+        return;
+    }
+    std::memcpy(&ack, packet.getPayload(), sizeof(ack));
+    if (packet.payload_len < sizeof(ack) + ack.nack_count * sizeof(uint32_t)) {
+        return;
+    }
+    const uint8_t* nacks = packet.getPayload() + sizeof(ack);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(send_streams_.begin(), send_streams_.end(),
+                           [&](const std::pair<const uint64_t, SendStream>& entry) {
+                               return entry.second.stream_id == ack.stream_id;
+                           });
+    if (it == send_streams_.end()) {
+        return;
+    }
+    SendStream& stream = it->second;
+    const Clock::time_point now = Clock::now();
+    stream.last_ack = now;
+
+    bool freed = false;
+    while (!stream.unacked.empty() && seqDistance(ack.next_seq, stream.unacked.front().seq) > 0) {
+        stream.unacked.pop_front();
+        --in_flight_;
+        freed = true;
+    }
+    if (freed) {
+        window_cv_.notify_all();
+    }
+
+    // Every ACK the receiver sends repeats its holes: resend each at most once per quarter timer period
+    const auto holdoff = std::chrono::milliseconds(std::max<uint32_t>(1, options_.retransmit_ms / 4));
+    for (uint16_t i = 0; i < ack.nack_count && !stream.unacked.empty(); ++i) {
+        uint32_t seq;
+        std::memcpy(&seq, nacks + i * sizeof(seq), sizeof(seq));
+        const uint32_t index = seq - stream.unacked.front().seq;
+        if (index < stream.unacked.size() && now - stream.unacked[index].sent_at >= holdoff) {
+            resend(stream, stream.unacked[index], now);
+        }
+    }
+}
+
+void ReliableUdpChannel::handleData(const MessagePacket& packet, const sockaddr_in& from) {
+    ReliableFragment header;
+    if (packet.payload_len < sizeof(header)) {
+        return;
+    }
+    std::memcpy(&header, packet.getPayload(), sizeof(header));
+    const uint8_t* data = packet.getPayload() + sizeof(header);
+    const size_t size = packet.payload_len - sizeof(header);
+    if (static_cast<uint64_t>(header.offset) + size > header.message_size) {
+        return;
+    }
+
+    StringView source_node = StringView::fromField(packet.node_id, sizeof(packet.node_id));
+    StringView group(packet.getGroup(), packet.group_len);
+    StringView topic(packet.getTopic(), packet.topic_len);
+    std::vector<Completed> completed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ReceiveStream& stream = receive_streams_[source_node.str()];
+        if (stream.stream_id != header.stream_id || stream.reply_to.sin_port == 0) {
+            // New sender, or the sender restarted its stream: start over at sequence 0
+            if (packet.udp_port == 0) {
+                receive_streams_.erase(source_node.str());
+                return;
+            }
+            stream = ReceiveStream();
+            stream.stream_id = header.stream_id;
+            stream.reply_to = UdpTransport::replyAddress(from, packet.udp_port);
+        }
+
+        const int32_t ahead = seqDistance(header.seq, stream.next_seq);
+        if (ahead < 0) {
+            sendAck(stream);  // Duplicate: our acknowledgement was lost or is late
+            return;
+        }
+        if (static_cast<uint32_t>(ahead) >= MAX_OUT_OF_ORDER) {
+            return;
+        }
+        if (ahead > 0) {
+            // Out of order: hold it, and report the hole when it first opens
+            const bool new_hole = seqDistance(header.seq, stream.end_seq) > 0;
+            if (seqDistance(header.seq + 1, stream.end_seq) > 0) {
+                stream.end_seq = header.seq + 1;
+            }
+            if (stream.pending.count(header.seq) == 0) {
+                HeldFragment& held = stream.pending[header.seq];
+                held.header = header;
+                if (header.offset == 0) {
+                    held.group = group.str();
+                    held.topic = topic.str();
+                }
+                held.data.assign(data, data + size);
+            }
+            if (new_hole) {
+                sendAck(stream);
+            }
+            return;
+        }
+
+        consumeFragment(stream, header, group, topic, data, size, completed);
+        ++stream.next_seq;
+        bool drained = false;
+        for (auto it = stream.pending.find(stream.next_seq); it != stream.pending.end();
+             it = stream.pending.find(stream.next_seq)) {
+            const HeldFragment& held = it->second;
+            consumeFragment(stream, held.header, held.group, held.topic, held.data.data(), held.data.size(),
+                            completed);
+            stream.pending.erase(it);
+            ++stream.next_seq;
+            drained = true;
+        }
+        if (seqDistance(stream.next_seq, stream.end_seq) > 0) {
+            stream.end_seq = stream.next_seq;
+        }
+        if (++stream.since_ack >= ACK_EVERY || drained || !completed.empty()) {
+            sendAck(stream);
+        }
+        stats_.messages_delivered += completed.size();
+    }
+
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (callback_) {
+        for (const Completed& message : completed) {
+            callback_(source_node, message.group, message.topic, message.payload.data(), message.payload.size());
+        }
+    }
+}
+
+void ReliableUdpChannel::consumeFragment(ReceiveStream& stream, const ReliableFragment& header, StringView group,
+                                         StringView topic, const uint8_t* data, size_t size,
+                                         std::vector<Completed>& completed) {
+    if (header.offset == 0) {
+        stream.assembling = header.message_size <= options_.max_message_size;
+        stream.group = group.str();
+        stream.topic = topic.str();
+        stream.message.resize(stream.assembling ? header.message_size : 0);
+        stream.filled = 0;
+    }
+    // A fragment of a message whose beginning was lost (stream restart) or that is too large
+    if (!stream.assembling || header.offset != stream.filled || header.message_size != stream.message.size()) {
+        stream.assembling = false;
+        return;
+    }
+
+    if (size > 0) {
+        std::memcpy(stream.message.data() + header.offset, data, size);
+    }
+    stream.filled += size;
+    if (stream.filled == header.message_size) {
+        completed.push_back({std::move(stream.group), std::move(stream.topic), std::move(stream.message)});
+        stream.message.clear();
+        stream.assembling = false;
+    }
+}
+
+void ReliableUdpChannel::sendAck(ReceiveStream& stream) {
+    uint8_t payload[sizeof(ReliableAck) + MAX_NACKS * sizeof(uint32_t)];
+    ReliableAck ack = {stream.stream_id, stream.next_seq, 0, 0};
+    for (uint32_t seq = stream.next_seq; seq != stream.end_seq && ack.nack_count < MAX_NACKS; ++seq) {
+        if (stream.pending.count(seq) == 0) {
+            std::memcpy(payload + sizeof(ack) + ack.nack_count * sizeof(seq), &seq, sizeof(seq));
+            ++ack.nack_count;
+        }
+    }
+    std::memcpy(payload, &ack, sizeof(ack));
+
+    PacketView packet =
+        MessageBuilder::buildView(node_id_, "", "", payload, sizeof(ack) + ack.nack_count * sizeof(uint32_t),
+                                  transport_.getPort(), MessageType::RELIABLE_ACK, options_.checksum);
+    transport_.sendTo(packet.data(), packet.size(), stream.reply_to);
+    stream.since_ack = 0;
+    stats_.nacks_sent += ack.nack_count;
+}
+
+void ReliableUdpChannel::retransmitThread() {
+    const auto period = std::chrono::milliseconds(std::max<uint32_t>(1, options_.retransmit_ms / 2));
+    const auto retransmit = std::chrono::milliseconds(options_.retransmit_ms);
+    const auto timeout = std::chrono::milliseconds(options_.timeout_ms);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (in_flight_ == 0) {
+            retransmit_cv_.wait(lock, [&] { return stopping_ || in_flight_ > 0; });
+            continue;
+        }
+        retransmit_cv_.wait_for(lock, period);
+        if (stopping_) {
+            break;
+        }
+
+        const Clock::time_point now = Clock::now();
+        for (auto& entry : send_streams_) {
+            SendStream& stream = entry.second;
+            if (stream.unacked.empty()) {
+                continue;
+            }
+            if (now - stream.last_ack >= timeout) {
+                // Receiver gone or unreachable: drop what is in flight and resynchronize on a new stream
+                in_flight_ -= stream.unacked.size();
+                stream.unacked.clear();
+                stream.stream_id = newStreamId();
+                stream.next_seq = 0;
+                ++stats_.streams_reset;
+                window_cv_.notify_all();
+                continue;
+            }
+            // Lost tail fragments are never NACKed (nothing after them arrives): resend what stalled
+            uint16_t resent = 0;
+            for (SentFragment& fragment : stream.unacked) {
+                if (resent == MAX_NACKS) {
+                    break;
+                }
+                if (now - fragment.sent_at < retransmit) {
+                    continue;
+                }
+                resend(stream, fragment, now);
+                ++resent;
+            }
+        }
+    }
+}
+
+}  // namespace rpc
+}  // namespace Nexus
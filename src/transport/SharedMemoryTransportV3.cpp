@@ -11,27 +11,46 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>  // For errno
 #include <chrono>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <sstream>  // For std::ostringstream
 #include <thread>   // For std::this_thread::sleep_for
 
 #include "nexus/core/NodeImpl.h"  // For handleNodeEvent callback
 #include "nexus/utils/Logger.h"
+#include "nexus/utils/Numa.h"
+#include "nexus/utils/ShmMapping.h"
+#include "nexus/utils/Tracepoints.h"
 
 // Static member definitions for C++14 compatibility
 constexpr size_t Nexus::rpc::SharedMemoryTransportV3::QUEUE_CAPACITY;
 constexpr size_t Nexus::rpc::SharedMemoryTransportV3::MAX_INBOUND_QUEUES;
+constexpr size_t Nexus::rpc::SharedMemoryTransportV3::MAX_DATA_FRAME_BYTES;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::DEFAULT_SPIN_BUDGET_US;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::MAX_RECEIVE_THREADS;
+constexpr size_t Nexus::rpc::SharedMemoryTransportV3::SHARED_INBOX_SLOTS;
+constexpr size_t Nexus::rpc::SharedMemoryTransportV3::SHARED_INBOX_FRAME_BYTES;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::DEFAULT_INBOX_PROMOTE_RATE;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::INBOX_SLOT;
+constexpr size_t Nexus::rpc::SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES;
 constexpr int Nexus::rpc::SharedMemoryTransportV3::NodeHeader::MAX_ACCESSORS;
 constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::MAGIC;
 constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::VERSION;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::DATA_LANES;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::DEFAULT_DATA_LANE;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::BULK_DATA_LANE;
+constexpr size_t Nexus::rpc::SharedMemoryTransportV3::BULK_LANE_CAPACITY_DIVISOR;
+constexpr uint32_t Nexus::rpc::SharedMemoryTransportV3::CONTROL_LANE;
 constexpr uint64_t Nexus::rpc::SharedMemoryTransportV3::HEARTBEAT_INTERVAL_MS;
 constexpr uint64_t Nexus::rpc::SharedMemoryTransportV3::NODE_TIMEOUT_MS;
 constexpr uint64_t Nexus::rpc::SharedMemoryTransportV3::QUEUE_TIMEOUT_MS;
+constexpr Nexus::rpc::SharedMemoryTransportV3::NodeHandle Nexus::rpc::SharedMemoryTransportV3::INVALID_NODE_HANDLE;
 
 
 // QNX specific includes
@@ -40,6 +59,15 @@ constexpr uint64_t Nexus::rpc::SharedMemoryTransportV3::QUEUE_TIMEOUT_MS;
 #include <sys/procfs.h>
 #endif
 
+// 🔧 Linux：CV/SMART_POLLING模式使用futex门铃代替全局pthread_cond（QNX等平台保留global_cond）
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <climits>
+#define NEXUS_SHM_FUTEX_DOORBELL 1
+#endif
+
 // ============ SharedMemoryTransportV3 Constants ============
 // Flow control and congestion management
 #define SHM_BACKOFF_BASE_US 10      // Congestion backoff base (microseconds)
@@ -67,10 +95,114 @@ constexpr uint64_t Nexus::rpc::SharedMemoryTransportV3::QUEUE_TIMEOUT_MS;
 
 // Node discovery and initialization
 #define SHM_STARTUP_WAIT_MS 300  // Wait time for remote nodes to respond (queryRemoteServices)
+#define SHM_CONNECT_RETRY_MIN_MS 1    // Connector: first retry of a node that is not ready yet
+#define SHM_CONNECT_RETRY_MAX_MS 100  // Connector: retry backoff cap
+#define SHM_SHUTDOWN_GRACE_MS 300     // Destructor: max wait for peers to detach before unlinking
+#define SHM_INBOX_DRAIN_WAIT_MS 10    // Promoted sender: max wait for its inbox frames before a large frame
+#define SHM_INBOX_FRAMES_PER_ROUND 64  // Receiver: inbox frames delivered per round
+#define SHM_INBOX_CLAIM_CHECK_MS 100     // Receiver: stall on a claimed inbox slot before checking its claimer
+#define SHM_INBOX_CLAIM_TIMEOUT_MS 1000  // Receiver: a claim whose claimer PID was never written is abandoned
 
 namespace Nexus {
 namespace rpc {
 
+// 🔧 进程内唯一的注册表监视线程：注册表变化（节点注册/注销）时提前运行被监视节点的心跳任务，
+// 使新节点立即被连接，而不是每个节点各自保留一个阻塞在注册表上的心跳线程
+namespace {
+
+class RegistryWatcher {
+public:
+    static RegistryWatcher& instance() {
+        // 与MaintenanceScheduler相同：fork()出的子进程退出时不销毁（复制来的条件变量仍记着父进程的等待者）
+        static RegistryWatcher* watcher = new RegistryWatcher();
+        static struct Shutdown {
+            ~Shutdown() {
+                if (watcher->owner_pid_ == 0 || watcher->owner_pid_ == getpid()) {
+                    delete watcher;
+                }
+            }
+        } shutdown;
+        return *watcher;
+    }
+
+    ~RegistryWatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // 所有实例映射同一个注册表：等待任一被监视实例的generation即可
+    void watch(const SharedMemoryRegistry* registry, MaintenanceScheduler::TaskId task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watched_[registry] = task;
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this]() { run(); });
+            owner_pid_ = getpid();
+        }
+        cv_.notify_all();
+    }
+
+    // 返回后监视线程不再访问 @p registry
+    void unwatch(const SharedMemoryRegistry* registry) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        watched_.erase(registry);
+        while (waiting_on_ == registry) {
+            keep_waiting_.store(false, std::memory_order_release);
+            registry->wakeWaiters();  // 单次唤醒可能早于它进入等待：反复唤醒直到它离开
+            cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    RegistryWatcher() = default;
+
+    void run() {
+        uint32_t generation = SharedMemoryRegistry::NO_GENERATION;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stopping_ || !watched_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            const SharedMemoryRegistry* registry = watched_.begin()->first;
+            waiting_on_ = registry;
+            keep_waiting_.store(true, std::memory_order_relaxed);
+            lock.unlock();
+
+            bool changed = registry->waitForChange(generation, WAIT_SLICE_MS, &keep_waiting_);
+
+            lock.lock();
+            waiting_on_ = nullptr;
+            cv_.notify_all();
+            if (changed) {
+                for (const auto& entry : watched_) {
+                    MaintenanceScheduler::instance().runSoon(entry.second);
+                }
+            }
+        }
+    }
+
+    static constexpr int WAIT_SLICE_MS = 1000;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;  // watched_ non-empty, stop, waiting_on_ cleared
+    std::map<const SharedMemoryRegistry*, MaintenanceScheduler::TaskId> watched_;
+    const SharedMemoryRegistry* waiting_on_ = nullptr;
+    std::atomic<bool> keep_waiting_{true};
+    bool stopping_ = false;
+    std::thread thread_;
+    pid_t owner_pid_ = 0;
+};
+
+constexpr int RegistryWatcher::WAIT_SLICE_MS;
+
+}  // namespace
+
 // 🔧 辅助函数：判断消息是否为控制消息（需要高优先级处理）
 static inline bool isControlMessage(const uint8_t* data, size_t size) {
     if (size < sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t)) {
@@ -82,27 +214,79 @@ static inline bool isControlMessage(const uint8_t* data, size_t size) {
 
     // 控制消息类型：SUBSCRIBE(1), UNSUBSCRIBE(2), QUERY_SUBSCRIPTIONS(3),
     // SUBSCRIPTION_REPLY(4), SERVICE_REGISTER(5), SERVICE_UNREGISTER(6),
-    // NODE_JOIN(7), NODE_LEAVE(8), HEARTBEAT(9)
+    // NODE_JOIN(7), NODE_LEAVE(8), HEARTBEAT(9), SERVICE_SNAPSHOT(14) ...
     // 数据消息：DATA(0)
     return msg_type != 0;  // 非DATA消息都是控制消息
 }
 
+// 🔧 自旋等待提示：降低功耗并让出超线程兄弟核的流水线
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+// futex word 位于共享内存中，必须使用非PRIVATE操作以支持跨进程唤醒
+// bitset：每个接收分片占一位，发送方只唤醒负责其队列的线程
+static inline void futexWake(std::atomic<uint32_t>* word, uint32_t bitset) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_BITSET, INT_MAX, nullptr, nullptr, bitset);
+}
+
+// 返回false表示超时（FUTEX_WAIT_BITSET使用CLOCK_MONOTONIC绝对时间）
+static inline bool futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms, uint32_t bitset) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    long nsec_add = static_cast<long>(timeout_ms) * 1000000L;
+    ts.tv_sec += nsec_add / 1000000000L;
+    ts.tv_nsec += nsec_add % 1000000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_BITSET, expected, &ts, nullptr,
+                      bitset);
+    return !(rc == -1 && errno == ETIMEDOUT);
+}
+#endif
+
 SharedMemoryTransportV3::SharedMemoryTransportV3()
     : initialized_(false),
       notify_mechanism_(NotifyMechanism::CONDITION_VARIABLE)  // Must match declaration order in header
       ,
       node_impl_(nullptr),
       my_shm_ptr_(nullptr),
+      my_shm_size_(0),
       my_shm_fd_(-1),
       my_shm_(nullptr),
-      receiving_(false) {}
+      receiving_(false) {
+    snapshot_readers_[0].store(0, std::memory_order_relaxed);
+    snapshot_readers_[1].store(0, std::memory_order_relaxed);
+}
 
 SharedMemoryTransportV3::~SharedMemoryTransportV3() {
+    // 🔧 先停止connector线程：它可能正在映射远端共享内存
+    {
+        std::lock_guard<std::mutex> lock(connector_mutex_);
+        connector_stop_ = true;
+    }
+    connector_cv_.notify_all();
+    if (connector_thread_.joinable()) {
+        connector_thread_.join();
+    }
+
     stopReceiving();
 
     // 🔧 CRITICAL: 先收集需要清理的资源，再在锁外清理
     // 避免在持有锁时进行系统调用，减少死锁和内存损坏的风险
-    std::vector<std::pair<void*, int>> resources_to_cleanup;
+    struct MappedSegment {
+        void* ptr;
+        size_t size;
+        int fd;
+    };
+    std::vector<MappedSegment> resources_to_cleanup;
     {
         std::lock_guard<std::mutex> lock(connections_mutex_);
         resources_to_cleanup.reserve(remote_connections_.size());
@@ -118,11 +302,11 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
             int shm_fd = pair.second.shm_fd;
 
             if (shm_ptr && shm_ptr != MAP_FAILED) {
-                resources_to_cleanup.push_back({shm_ptr, shm_fd});
+                resources_to_cleanup.push_back({shm_ptr, pair.second.shm_size, shm_fd});
                 pair.second.shm_ptr = nullptr;
                 pair.second.shm_fd = -1;
             } else if (shm_fd >= 0) {
-                resources_to_cleanup.push_back({nullptr, shm_fd});
+                resources_to_cleanup.push_back({nullptr, 0, shm_fd});
                 pair.second.shm_fd = -1;
             }
 
@@ -131,14 +315,17 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
 
         // 清空 map（在锁内，但不进行系统调用）
         remote_connections_.clear();
+
+        // 🔧 发布空快照：所有发送者离开后才能 munmap（见下方等待）
+        publishConnectionSnapshot();
     }
 
     // CRITICAL: Remove my PID from all remote nodes' accessor lists
     // Do this BEFORE munmap to ensure atomic visibility
     pid_t my_pid = getpid();
     for (const auto& res : resources_to_cleanup) {
-        if (res.first && res.first != MAP_FAILED) {
-            NodeSharedMemory* remote_shm = static_cast<NodeSharedMemory*>(res.first);
+        if (res.ptr && res.ptr != MAP_FAILED) {
+            NodeSharedMemory* remote_shm = static_cast<NodeSharedMemory*>(res.ptr);
 
             // Remove my PID from accessor list
             for (int i = 0; i < NodeHeader::MAX_ACCESSORS; ++i) {
@@ -146,6 +333,9 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
                 if (remote_shm->header.accessor_pids[i].compare_exchange_strong(expected, 0, std::memory_order_acq_rel,
                                                                                 std::memory_order_acquire)) {
                     remote_shm->header.num_accessors.fetch_sub(1, std::memory_order_release);
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+                    futexWake(&remote_shm->header.num_accessors, FUTEX_BITSET_MATCH_ANY);  // 对端析构可能在等待
+#endif
                     NEXUS_DEBUG("SHM-V3")
                         << "Removed PID " << my_pid << " from remote node accessor list (slot " << i << ")";
                     break;
@@ -154,13 +344,25 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
         }
     }
 
+    // 🔧 发送者可能仍持有旧快照（例如阻塞在credit等待中）：等它们离开，释放所有退役快照
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            reclaimRetiredSnapshots();
+            if (retired_snapshots_.empty()) {
+                break;
+            }
+        }
+        std::this_thread::yield();
+    }
+
     // Now safe to munmap and close
     for (const auto& res : resources_to_cleanup) {
-        if (res.first && res.first != MAP_FAILED) {
-            munmap(res.first, sizeof(NodeSharedMemory));
+        if (res.ptr && res.ptr != MAP_FAILED) {
+            munmap(res.ptr, res.size);
         }
-        if (res.second >= 0) {
-            close(res.second);
+        if (res.fd >= 0) {
+            close(res.fd);
         }
     }
     NEXUS_DEBUG("SHM-V3") << "Disconnected from all remote nodes";
@@ -183,15 +385,36 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
         registry_.unregisterNode(node_id_);
     }
 
-    // Strategy: Delayed cleanup after grace period
+    // Strategy: Delayed cleanup once peers acknowledged
     // 1. Remove accessor PID (already done above)
-    // 2. Sleep briefly to let other nodes detect and disconnect
+    // 2. Wait for other nodes to disconnect: each removes its PID from our accessor list (on NODE_LEAVE or
+    //    when it notices we left) and wakes us; at most SHM_SHUTDOWN_GRACE_MS
     // 3. Then unlink - safe because:
     //    - Not in registry anymore (no new connections)
-    //    - Other nodes had time to disconnect
+    //    - Other nodes have disconnected (or had the grace period to)
     //    - Existing mmaps continue to work
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    if (my_shm_) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SHM_SHUTDOWN_GRACE_MS);
+        while (true) {
+            uint32_t accessors = my_shm_->header.num_accessors.load(std::memory_order_acquire);
+            if (!hasActiveAccessors(&my_shm_->header)) {
+                break;
+            }
+            auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                break;
+            }
+            // 短超时：死亡的访问者不会唤醒，由hasActiveAccessors()清理
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+            futexWait(&my_shm_->header.num_accessors, accessors,
+                      static_cast<int>(std::min<int64_t>(remaining.count(), 10)), FUTEX_BITSET_MATCH_ANY);
+#else
+            (void)accessors;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+        }
+    }
 
     bool has_unlink = false;
     // Now safe to unlink: not in registry, grace period passed
@@ -201,7 +424,7 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
         }
     }
     if (my_shm_ptr_ && my_shm_ptr_ != MAP_FAILED) {
-        munmap(my_shm_ptr_, sizeof(NodeSharedMemory));
+        munmap(my_shm_ptr_, my_shm_size_);
         my_shm_ptr_ = nullptr;
         my_shm_ = nullptr;
     }
@@ -217,6 +440,8 @@ SharedMemoryTransportV3::~SharedMemoryTransportV3() {
         }
     }
 
+    delete connection_snapshot_.exchange(nullptr);
+
     NEXUS_DEBUG("SHM-V3") << "Node " << node_id_ << " destroyed";
 }
 
@@ -239,6 +464,22 @@ bool SharedMemoryTransportV3::initialize(const std::string& node_id, const Confi
 
     node_id_ = node_id;
     config_ = config;
+
+    // 🔧 运行时队列容量：限制在 [MIN_DATA_QUEUE_SIZE_BYTES, DATA_QUEUE_SIZE_BYTES]，8字节对齐
+    if (config_.queue_capacity < MIN_DATA_QUEUE_SIZE_BYTES) {
+        NEXUS_WARN("SHM-V3") << "queue_capacity " << config_.queue_capacity
+                             << " bytes cannot hold a full MessagePacket (" << MAX_DATA_FRAME_BYTES
+                             << " bytes), raised to " << MIN_DATA_QUEUE_SIZE_BYTES;
+        config_.queue_capacity = MIN_DATA_QUEUE_SIZE_BYTES;
+    } else if (config_.queue_capacity > DATA_QUEUE_SIZE_BYTES) {
+        config_.queue_capacity = DATA_QUEUE_SIZE_BYTES;
+    }
+    config_.queue_capacity &= ~static_cast<size_t>(7);
+    if (config_.receive_threads == 0) {
+        config_.receive_threads = 1;
+    } else if (config_.receive_threads > MAX_RECEIVE_THREADS) {
+        config_.receive_threads = MAX_RECEIVE_THREADS;
+    }
     notify_mechanism_ = config.notify_mechanism;  // 保存通知机制配置
 
     // Initialize registry
@@ -246,6 +487,12 @@ bool SharedMemoryTransportV3::initialize(const std::string& node_id, const Confi
         NEXUS_ERROR("SHM-V3") << "Failed to initialize registry";
         return false;
     }
+    {
+        // 注册表可能是重新创建的：generation 从头计数，缓存的节点列表作废
+        std::lock_guard<std::mutex> lock(registry_nodes_mutex_);
+        registry_nodes_.reset();
+        registry_nodes_generation_ = SharedMemoryRegistry::NO_GENERATION;
+    }
 
     // Generate unique shared memory name
     my_shm_name_ = generateShmName();
@@ -256,6 +503,10 @@ bool SharedMemoryTransportV3::initialize(const std::string& node_id, const Confi
         return false;
     }
 
+    // 🔧 两阶段提交：设置ready标志
+    // 在注册之前：注册会立即唤醒其他节点连接过来（waitForChange），此时共享内存必须已可用
+    my_shm_->header.ready.store(true, std::memory_order_release);
+
     // Register in registry
     if (!registry_.registerNode(node_id_, my_shm_name_)) {
         NEXUS_ERROR("SHM-V3") << "Failed to register node";
@@ -263,10 +514,8 @@ bool SharedMemoryTransportV3::initialize(const std::string& node_id, const Confi
         return false;
     }
 
-    // 🔧 两阶段提交：设置ready标志
-    my_shm_->header.ready.store(true, std::memory_order_release);
-
     initialized_ = true;
+    connector_thread_ = std::thread(&SharedMemoryTransportV3::connectorLoop, this);
 
     const char* mechanism_name = "Unknown";
     if (notify_mechanism_ == NotifyMechanism::CONDITION_VARIABLE) {
@@ -274,105 +523,177 @@ bool SharedMemoryTransportV3::initialize(const std::string& node_id, const Confi
     } else if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
         mechanism_name = "POSIX Semaphore";
     } else if (notify_mechanism_ == NotifyMechanism::SMART_POLLING) {
-        mechanism_name = "Smart Polling";
+        mechanism_name = "Smart Polling (spin-then-block)";
     }
 
     NEXUS_INFO("SHM-V3") << "Node " << node_id_ << " initialized"
                           << "\n  Notify mechanism: " << mechanism_name << "\n  Shared memory: " << my_shm_name_
                           << "\n  Queue capacity: " << config_.queue_capacity
-                          << "\n  Max inbound queues: " << MAX_INBOUND_QUEUES;
+                          << "\n  Max inbound queues: " << MAX_INBOUND_QUEUES
+                          << "\n  Receive threads: " << config_.receive_threads;
 
     return true;
 }
 
 bool SharedMemoryTransportV3::send(const std::string& dest_node_id, const uint8_t* data, size_t size) {
+    // 🔧 双队列架构：根据消息类型选择队列
+    uint32_t lane = isControlMessage(data, size) ? CONTROL_LANE : DEFAULT_DATA_LANE;
+
+    return sendFrames(dest_node_id, &size, 1, lane,
+                      [data](size_t, uint8_t* frame, size_t frame_size) { memcpy(frame, data, frame_size); }) == 1;
+}
+
+SharedMemoryTransportV3::NodeHandle SharedMemoryTransportV3::resolveNode(const std::string& node_id) {
+    if (!initialized_ || node_id == node_id_) {
+        return INVALID_NODE_HANDLE;
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        {
+            SnapshotReader reader(*this);
+            const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(node_id) : nullptr;
+            if (conn) {
+                return conn->handle;
+            }
+        }
+        if (attempt == 0 && !connectInline(node_id)) {
+            break;
+        }
+    }
+    return INVALID_NODE_HANDLE;
+}
+
+bool SharedMemoryTransportV3::send(NodeHandle handle, const uint8_t* data, size_t size) {
+    if (!initialized_ || handle == INVALID_NODE_HANDLE) {
+        return false;
+    }
+
+    uint32_t lane = isControlMessage(data, size) ? CONTROL_LANE : DEFAULT_DATA_LANE;
+
+    SnapshotReader reader(*this);
+    const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(handle) : nullptr;
+    if (!conn) {
+        stats_messages_dropped_++;
+        return false;
+    }
+    return writeToConnection(*conn, &size, 1, lane,
+                             [data](size_t, uint8_t* frame, size_t frame_size) { memcpy(frame, data, frame_size); },
+                             false) == 1;
+}
+
+bool SharedMemoryTransportV3::isQueueFull(const std::string& dest_node_id, size_t size, uint32_t lane) const {
     if (!initialized_) {
         return false;
     }
 
-    if (dest_node_id == node_id_) {
-        return false;  // Don't send to self
+    SnapshotReader reader(*this);
+    const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(dest_node_id) : nullptr;
+    if (!conn) {
+        return false;
     }
+    InboundQueue* queue = dedicatedQueue(*conn);
+    return queue ? !queue->data_lanes[std::min(lane, DATA_LANES - 1)].ring.canReserve(size)
+                 : inboxFull(conn->shm->inbox);
+}
 
-    // 🔧 双队列架构：根据消息类型选择队列
-    bool is_control = isControlMessage(data, size);
+bool SharedMemoryTransportV3::isQueueFull(NodeHandle handle, size_t size, uint32_t lane) const {
+    if (!initialized_) {
+        return false;
+    }
 
-    // Fast path: check if already connected
-    {
-        std::lock_guard<std::mutex> lock(connections_mutex_);
-        auto it = remote_connections_.find(dest_node_id);
-        if (it != remote_connections_.end() && it->second.connected && it->second.my_queue) {
-            InboundQueue* queue = it->second.my_queue;
-
-            // 🔧 单CV方案：统一的mutex/cond_var，根据消息类型选择队列
-            sem_t* target_sem = nullptr;
-            std::atomic<uint32_t>* target_pending = nullptr;
-            bool success = false;
-
-            if (is_control) {
-                success = queue->control_queue.tryWrite(data, size);
-                if (success) {
-                    target_sem = &queue->control_sem;
-                    target_pending = &queue->control_pending;
-                }
-            } else {
-                // 🔧 流控：检查拥塞等级（仅数据队列）
-                uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
-                if (congestion > 0 && congestion <= SHM_CONGESTION_MAX) {
-                    int backoff_us = static_cast<int>(congestion) * SHM_BACKOFF_BASE_US;
-                    if (backoff_us > 0 && backoff_us <= SHM_BACKOFF_MAX_US) {
-                        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
-                    }
-                }
-                
-                success = queue->data_queue.tryWrite(data, size);
-                if (success) {
-                    target_sem = &queue->data_sem;
-                    target_pending = &queue->data_pending;
-                }
-            }
+    SnapshotReader reader(*this);
+    const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(handle) : nullptr;
+    if (!conn) {
+        return false;
+    }
+    InboundQueue* queue = dedicatedQueue(*conn);
+    return queue ? !queue->data_lanes[std::min(lane, DATA_LANES - 1)].ring.canReserve(size)
+                 : inboxFull(conn->shm->inbox);
+}
 
-            // 尝试发送
-            if (success) {
-                stats_messages_sent_++;
-                stats_bytes_sent_ += size;
+uint32_t SharedMemoryTransportV3::retryHintUs(NodeHandle handle) const {
+    if (!initialized_) {
+        return 0;
+    }
 
-                // 🔧 统一CV通知：无论control还是data都signal同一个cond_var
-                if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
-                    uint32_t prev = target_pending->fetch_add(1, std::memory_order_release);
-                    if (prev == 0) {
-                        sem_post(target_sem);
-                    }
-                } else {
-                    uint32_t prev = target_pending->fetch_add(1, std::memory_order_release);
-                    if (prev == 0) {
-                        // 🔧 全局CV：从queue指针计算remote_shm地址
-                        NodeSharedMemory* remote_shm = reinterpret_cast<NodeSharedMemory*>(
-                            reinterpret_cast<char*>(queue) - offsetof(NodeSharedMemory, queues));
-                        pthread_cond_signal(&remote_shm->header.global_cond);
-                    }
-                }
+    SnapshotReader reader(*this);
+    const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(handle) : nullptr;
+    InboundQueue* queue = conn ? dedicatedQueue(*conn) : nullptr;
+    if (!queue) {
+        return conn ? SHM_BACKOFF_BASE_US : 0;  // Shared inbox: no congestion tracking
+    }
+    uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
+    uint32_t hint_us = std::max(congestion, 1u) * SHM_BACKOFF_BASE_US;
+    return std::min(hint_us, static_cast<uint32_t>(SHM_BACKOFF_MAX_US));
+}
 
-                // 🔧 流控：成功发送，降低拥塞等级（仅数据队列）
-                if (!is_control) {
-                    uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
-                    if (congestion > 0) {
-                        queue->congestion_level.fetch_sub(SHM_CONGESTION_DECREMENT, std::memory_order_relaxed);
-                    }
-                }
-            } else {
-                stats_messages_dropped_++;
-
-                // 🔧 流控：发送失败，提高拥塞等级（仅数据队列）
-                if (!is_control) {
-                    queue->drop_count.fetch_add(1, std::memory_order_relaxed);
-                    uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
-                    if (congestion < SHM_CONGESTION_MAX) {
-                        queue->congestion_level.fetch_add(SHM_CONGESTION_INCREMENT, std::memory_order_relaxed);
-                    }
-                }
-            }
-            return success;
+bool SharedMemoryTransportV3::sendInPlace(NodeHandle handle, size_t size, const FrameWriter& writer, uint32_t lane) {
+    if (!writer) {
+        return false;
+    }
+    return sendBatchInPlace(
+               handle, &size, 1,
+               [&writer](size_t, uint8_t* frame, size_t frame_size) { writer(frame, frame_size); }, lane) == 1;
+}
+
+size_t SharedMemoryTransportV3::sendBatchInPlace(NodeHandle handle, const size_t* sizes, size_t count,
+                                                 const BatchWriter& writer, uint32_t lane) {
+    if (!initialized_ || handle == INVALID_NODE_HANDLE || !sizes || count == 0 || !writer) {
+        return 0;
+    }
+
+    SnapshotReader reader(*this);
+    const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(handle) : nullptr;
+    if (!conn) {
+        stats_messages_dropped_ += count;
+        return 0;
+    }
+    return writeToConnection(*conn, sizes, count, std::min(lane, DATA_LANES - 1), writer, false);
+}
+
+bool SharedMemoryTransportV3::sendInPlace(const std::string& dest_node_id, size_t size, const FrameWriter& writer,
+                                          uint32_t lane) {
+    if (!writer) {
+        return false;
+    }
+    return sendFrames(dest_node_id, &size, 1, std::min(lane, DATA_LANES - 1),
+                      [&writer](size_t, uint8_t* frame, size_t frame_size) { writer(frame, frame_size); }) == 1;
+}
+
+size_t SharedMemoryTransportV3::sendv(const std::string& dest_node_id, const uint8_t* const* frames,
+                                      const size_t* sizes, size_t count) {
+    if (!frames || !sizes) {
+        return 0;
+    }
+    return sendBatchInPlace(dest_node_id, sizes, count, [frames](size_t index, uint8_t* frame, size_t frame_size) {
+        memcpy(frame, frames[index], frame_size);
+    });
+}
+
+size_t SharedMemoryTransportV3::sendBatchInPlace(const std::string& dest_node_id, const size_t* sizes, size_t count,
+                                                 const BatchWriter& writer, uint32_t lane) {
+    if (!sizes || count == 0 || !writer) {
+        return 0;
+    }
+    return sendFrames(dest_node_id, sizes, count, std::min(lane, DATA_LANES - 1), writer);
+}
+
+size_t SharedMemoryTransportV3::sendFrames(const std::string& dest_node_id, const size_t* sizes, size_t count,
+                                           uint32_t lane, const BatchWriter& writer) {
+    if (!initialized_) {
+        return 0;
+    }
+
+    if (dest_node_id == node_id_) {
+        return 0;  // Don't send to self
+    }
+
+    // Fast path: already connected (lock-free snapshot lookup)
+    {
+        SnapshotReader reader(*this);
+        const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(dest_node_id) : nullptr;
+        if (conn) {
+            return writeToConnection(*conn, sizes, count, lane, writer, false);
         }
     }
 
@@ -380,72 +701,315 @@ bool SharedMemoryTransportV3::send(const std::string& dest_node_id, const uint8_
     NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Not connected to " << dest_node_id
                           << ", attempting lazy connection...";
 
-    if (!connectToNode(dest_node_id)) {
-        stats_messages_dropped_++;
+    if (!connectInline(dest_node_id)) {
+        stats_messages_dropped_ += count;
         NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Failed to connect to " << dest_node_id;
-        return false;
+        return 0;
     }
 
     NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Successfully connected to " << dest_node_id;
 
     // Retry send after connection
     {
-        std::lock_guard<std::mutex> lock(connections_mutex_);
-        auto it = remote_connections_.find(dest_node_id);
-        if (it != remote_connections_.end() && it->second.connected && it->second.my_queue) {
-            InboundQueue* queue = it->second.my_queue;
-
-            // 🔧 单CV方案：统一的cond_var，根据消息类型选择队列
-            sem_t* target_sem = nullptr;
-            std::atomic<uint32_t>* target_pending = nullptr;
-            bool success = false;
-
-            if (is_control) {
-                success = queue->control_queue.tryWrite(data, size);
-                if (success) {
-                    target_sem = &queue->control_sem;
-                    target_pending = &queue->control_pending;
+        SnapshotReader reader(*this);
+        const ConnectionSnapshot::Entry* conn = reader.get() ? reader.get()->find(dest_node_id) : nullptr;
+        if (conn) {
+            return writeToConnection(*conn, sizes, count, lane, writer, true);
+        }
+    }
+
+    stats_messages_dropped_ += count;
+    return 0;
+}
+
+// Reserve and fill up to `count` frames back to back, then publish them with a single commit
+template <typename Ring>
+static size_t writeFrames(Ring& ring, const size_t* sizes, size_t count,
+                          const SharedMemoryTransportV3::BatchWriter& writer) {
+    typename Ring::Reservation last;
+    size_t written = 0;
+
+    while (written < count) {
+        typename Ring::Reservation reservation;
+        bool reserved = (written == 0) ? ring.tryReserve(sizes[written], reservation)
+                                       : ring.tryReserveNext(last, sizes[written], reservation);
+        if (!reserved) {
+            break;
+        }
+        writer(written, reservation.data, reservation.size);
+        last = reservation;
+        written++;
+    }
+
+    if (written > 0) {
+        ring.commit(last);
+    }
+    return written;
+}
+
+size_t SharedMemoryTransportV3::writeToQueue(NodeSharedMemory* shm, InboundQueue* queue, const size_t* sizes,
+                                             size_t count, uint32_t lane, const BatchWriter& writer,
+                                             bool just_connected) {
+    // 🔧 单CV方案：统一的mutex/cond_var，根据消息类型（及数据lane）选择队列
+    const bool is_control = lane == CONTROL_LANE;
+    std::atomic<uint32_t>* target_pending = nullptr;
+    size_t written = 0;
+
+    if (is_control) {
+        written = writeFrames(queue->control_queue, sizes, count, writer);
+        target_pending = &queue->control_pending;
+    } else {
+        DataLane& data_lane = queue->data_lanes[lane];
+
+        // 🔧 流控（credit）：接收方通过队列tail公布可用空间，有credit时直接写入不退避；
+        // 无credit且拥塞时，阻塞模式整批只退避一次，非阻塞模式或DROP策略的lane立即失败
+        if (!just_connected && !config_.non_blocking && config_.lane_overflow[lane] == LaneOverflow::BLOCK &&
+            !data_lane.ring.canReserve(sizes[0])) {
+            const size_t first_size = sizes[0];
+            waitForCredit(queue->congestion_level.load(std::memory_order_relaxed),
+                          [&data_lane, first_size]() { return data_lane.ring.canReserve(first_size); });
+        }
+
+        written = writeFrames(data_lane.ring, sizes, count, writer);
+        target_pending = &data_lane.pending;
+    }
+
+    NEXUS_TRACE3(shm_ring_write, queue, written, lane);
+
+    // 尝试发送
+    if (written > 0) {
+        stats_messages_sent_ += written;
+        for (size_t i = 0; i < written; ++i) {
+            stats_bytes_sent_ += sizes[i];
+        }
+
+        // 🔧 统一CV通知：无论control还是data都signal同一个cond_var（每批只通知一次）
+        uint32_t prev = target_pending->fetch_add(static_cast<uint32_t>(written), std::memory_order_release);
+        if (prev == 0) {
+            if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
+                postShardSemaphore(shm, static_cast<uint32_t>(queue - shm->queues));
+            } else {
+                ringDoorbell(shm, queue);
+            }
+        }
+
+        // 🔧 流控：成功发送，降低拥塞等级（仅数据队列）
+        if (!is_control) {
+            stats_lane_sent_[lane] += written;
+            if (!just_connected) {
+                uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
+                if (congestion > 0) {
+                    queue->congestion_level.fetch_sub(SHM_CONGESTION_DECREMENT, std::memory_order_relaxed);
                 }
+            }
+        }
+    }
+
+    if (written < count) {
+        stats_messages_dropped_ += count - written;
+
+        // 🔧 流控：发送失败，提高拥塞等级（仅数据队列）
+        if (!is_control) {
+            stats_lane_dropped_[lane] += count - written;
+            queue->drop_count.fetch_add(static_cast<uint32_t>(count - written), std::memory_order_relaxed);
+            if (just_connected) {
+                queue->congestion_level.store(SHM_CONGESTION_INITIAL, std::memory_order_relaxed);
             } else {
-                success = queue->data_queue.tryWrite(data, size);
-                if (success) {
-                    target_sem = &queue->data_sem;
-                    target_pending = &queue->data_pending;
+                uint32_t congestion = queue->congestion_level.load(std::memory_order_relaxed);
+                if (congestion < SHM_CONGESTION_MAX) {
+                    queue->congestion_level.fetch_add(SHM_CONGESTION_INCREMENT, std::memory_order_relaxed);
                 }
             }
+        }
+    }
+    return written;
+}
 
-            if (success) {
-                stats_messages_sent_++;
-                stats_bytes_sent_ += size;
+void SharedMemoryTransportV3::waitForCredit(uint32_t congestion, const std::function<bool()>& has_credit) const {
+    if (config_.send_timeout_ms > 0) {
+        // 🔧 有界等待：接收方释放空间（credit）前反复退避，直到超时（背压传递到发送方）
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.send_timeout_ms);
+        int backoff_us = std::max(static_cast<int>(congestion), 1) * SHM_BACKOFF_BASE_US;
+        backoff_us = std::min(backoff_us, SHM_BACKOFF_MAX_US);
+        while (!has_credit() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+            backoff_us = std::min(backoff_us * 2, SHM_BACKOFF_MAX_US);
+        }
+    } else if (congestion > 0 && congestion <= SHM_CONGESTION_MAX) {
+        int backoff_us = static_cast<int>(congestion) * SHM_BACKOFF_BASE_US;
+        if (backoff_us > 0 && backoff_us <= SHM_BACKOFF_MAX_US) {
+            std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+        }
+    }
+}
 
-                // 🔧 统一CV通知：无论control还是data都signal同一个cond_var
-                if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
-                    uint32_t prev = target_pending->fetch_add(1, std::memory_order_release);
-                    if (prev == 0) {
-                        sem_post(target_sem);
-                    }
-                } else {
-                    uint32_t prev = target_pending->fetch_add(1, std::memory_order_release);
-                    if (prev == 0) {
-                        // 🔧 全局CV：signal远程节点的global_cond
-                        NodeSharedMemory* remote_shm = reinterpret_cast<NodeSharedMemory*>(
-                            reinterpret_cast<char*>(queue) - offsetof(NodeSharedMemory, queues));
-                        pthread_cond_signal(&remote_shm->header.global_cond);
-                    }
+size_t SharedMemoryTransportV3::writeToConnection(const ConnectionSnapshot::Entry& conn, const size_t* sizes,
+                                                  size_t count, uint32_t lane, const BatchWriter& writer,
+                                                  bool just_connected) {
+    NEXUS_TRACE3(shm_send, conn.handle, count, lane);
+    if (conn.queue) {
+        return writeToQueue(conn.shm, conn.queue, sizes, count, lane, writer, just_connected);
+    }
+    InboundQueue* queue = inboxQueue(conn.shm, *conn.inbox, sizes, count);
+    if (queue) {
+        return writeToQueue(conn.shm, queue, sizes, count, lane, writer, just_connected);
+    }
+    return writeToInbox(conn.shm, *conn.inbox, sizes, count, lane, writer);
+}
+
+SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::dedicatedQueue(const ConnectionSnapshot::Entry& conn) {
+    return conn.queue ? conn.queue : conn.inbox->queue.load(std::memory_order_acquire);
+}
+
+bool SharedMemoryTransportV3::inboxFull(const SharedInbox& inbox) {
+    uint64_t pos = inbox.enqueue_pos.load(std::memory_order_relaxed);
+    uint64_t lap = pos - pos % SHARED_INBOX_SLOTS;
+    return inbox.slots[pos % SHARED_INBOX_SLOTS].sequence.load(std::memory_order_acquire) < lap;
+}
+
+// 🔧 共享收件箱上的连接：速率超过inbox_promote_rate或帧放不进槽位时申请专属队列（升级）；
+// 返回nullptr表示继续写收件箱。仍在收件箱中的早先帧先投递，保证同一发送方的顺序
+SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::inboxQueue(NodeSharedMemory* shm, InboxRoute& route,
+                                                                           const size_t* sizes, size_t count) {
+    bool oversized = false;
+    for (size_t i = 0; i < count; ++i) {
+        oversized = oversized || sizes[i] > SHARED_INBOX_FRAME_BYTES;
+    }
+
+    InboundQueue* queue = route.queue.load(std::memory_order_acquire);
+    if (!queue) {
+        // 按1秒窗口统计速率
+        const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count();
+        if (now - route.window_start_ms.load(std::memory_order_relaxed) >= 1000) {
+            route.window_start_ms.store(now, std::memory_order_relaxed);
+            route.window_frames.store(0, std::memory_order_relaxed);
+        }
+        uint32_t frames = route.window_frames.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed) +
+                          static_cast<uint32_t>(count);
+        const bool backing_off = now < route.retry_ms.load(std::memory_order_relaxed);
+        if (!oversized && (frames <= config_.inbox_promote_rate || backing_off)) {
+            return nullptr;
+        }
+
+        // 同一时刻只有一个线程申请；其他线程本次继续使用收件箱（超大帧除外，必须等待结果）
+        std::unique_lock<std::mutex> lock(route.promote_mutex, std::defer_lock);
+        if (oversized) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            return nullptr;
+        }
+        queue = route.queue.load(std::memory_order_acquire);
+        if (!queue) {
+            queue = findOrCreateQueue(shm, node_id_);
+            if (!queue) {
+                // 接收方队列已满：留在收件箱，1秒后再试
+                route.retry_ms.store(now + 1000, std::memory_order_relaxed);
+                return nullptr;
+            }
+            route.queue.store(queue, std::memory_order_release);
+            NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Promoted from shared inbox to a dedicated queue";
+        }
+    }
+
+    // 保序：本发送方仍有帧在收件箱中时继续写收件箱；超大帧放不进去，最多等待接收方取走
+    const SharedInbox& inbox = shm->inbox;
+    if (route.last_pos.load(std::memory_order_acquire) > inbox.dequeue_pos.load(std::memory_order_acquire)) {
+        if (!oversized) {
+            return nullptr;
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SHM_INBOX_DRAIN_WAIT_MS);
+        while (route.last_pos.load(std::memory_order_acquire) > inbox.dequeue_pos.load(std::memory_order_acquire) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(SHM_BACKOFF_BASE_US));
+        }
+    }
+    return queue;
+}
+
+size_t SharedMemoryTransportV3::writeToInbox(NodeSharedMemory* shm, InboxRoute& route, const size_t* sizes,
+                                             size_t count, uint32_t lane, const BatchWriter& writer) {
+    SharedInbox& inbox = shm->inbox;
+    size_t written = 0;
+    uint64_t last_pos = 0;
+
+    // 🔧 收件箱满：与专属队列相同的lane溢出策略（BLOCK等待接收方取走，DROP/非阻塞立即失败）
+    if (lane != CONTROL_LANE && !config_.non_blocking && config_.lane_overflow[lane] == LaneOverflow::BLOCK &&
+        inboxFull(inbox)) {
+        waitForCredit(1, [&inbox]() { return !inboxFull(inbox); });
+    }
+
+    while (written < count) {
+        const size_t size = sizes[written];
+        if (size == 0 || size > SHARED_INBOX_FRAME_BYTES) {
+            break;
+        }
+
+        // 🔧 CAS占用位置pos：槽位序号等于pos所在圈时空闲；小于说明上一圈尚未被取走（满）
+        uint64_t pos = inbox.enqueue_pos.load(std::memory_order_relaxed);
+        InboxSlot* slot = nullptr;
+        while (true) {
+            InboxSlot& candidate = inbox.slots[pos % SHARED_INBOX_SLOTS];
+            const uint64_t lap = pos - pos % SHARED_INBOX_SLOTS;
+            const uint64_t seq = candidate.sequence.load(std::memory_order_acquire);
+            if (seq == lap) {
+                if (inbox.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot = &candidate;
+                    break;
                 }
+            } else if (seq < lap) {
+                break;
             } else {
-                stats_messages_dropped_++;
-                if (!is_control) {
-                    queue->drop_count.fetch_add(1, std::memory_order_relaxed);
-                    queue->congestion_level.store(SHM_CONGESTION_INITIAL, std::memory_order_relaxed);
-                }
+                pos = inbox.enqueue_pos.load(std::memory_order_relaxed);
             }
-            return success;
         }
+        if (!slot) {
+            break;
+        }
+
+        slot->claimer_pid.store(getpid(), std::memory_order_relaxed);
+        writer(written, slot->data, size);
+        slot->size = static_cast<uint32_t>(size);
+        SharedMemoryRegistry::writeAtomicString(slot->sender_id_atomic, node_id_, 64);
+        slot->sequence.store(pos - pos % SHARED_INBOX_SLOTS + 1, std::memory_order_release);  // 发布
+        last_pos = pos + 1;
+        written++;
     }
 
-    stats_messages_dropped_++;
-    return false;
+    NEXUS_TRACE3(shm_ring_write, &inbox, written, INBOX_LANE);
+
+    if (written > 0) {
+        // 多个线程可能乱序发布：last_pos只增不减
+        uint64_t prev = route.last_pos.load(std::memory_order_relaxed);
+        while (prev < last_pos && !route.last_pos.compare_exchange_weak(prev, last_pos, std::memory_order_release,
+                                                                         std::memory_order_relaxed)) {
+        }
+
+        stats_messages_sent_ += written;
+        for (size_t i = 0; i < written; ++i) {
+            stats_bytes_sent_ += sizes[i];
+        }
+        if (lane != CONTROL_LANE) {
+            stats_lane_sent_[lane] += written;
+        }
+
+        if (inbox.pending.fetch_add(static_cast<uint32_t>(written), std::memory_order_release) == 0) {
+            if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
+                postShardSemaphore(shm, INBOX_SLOT);
+            } else {
+                ringDoorbell(shm, INBOX_SLOT);
+            }
+        }
+    }
+
+    if (written < count) {
+        stats_messages_dropped_ += count - written;
+        if (lane != CONTROL_LANE) {
+            stats_lane_dropped_[lane] += count - written;
+        }
+    }
+    return written;
 }
 
 int SharedMemoryTransportV3::broadcast(const uint8_t* data, size_t size) {
@@ -454,12 +1018,12 @@ int SharedMemoryTransportV3::broadcast(const uint8_t* data, size_t size) {
     }
 
     // Get all nodes from registry
-    std::vector<NodeInfo> nodes = registry_.getAllNodes();
+    const auto nodes = registryNodes();
     int sent_count = 0;
 
-    NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Broadcasting to " << nodes.size() << " nodes in registry";
+    NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Broadcasting to " << nodes->size() << " nodes in registry";
 
-    for (const auto& node : nodes) {
+    for (const auto& node : *nodes) {
         if (node.node_id == node_id_) {
             continue;  // Skip self
         }
@@ -489,14 +1053,20 @@ void SharedMemoryTransportV3::startReceiving() {
 
     receiving_.store(true);
 
-    // 🔧 立即更新心跳，防止在心跳线程启动前被误判超时
+    // 🔧 立即更新心跳，防止在心跳任务首次运行前被误判超时
     registry_.updateHeartbeat(node_id_);
 
-    // Start receive thread
-    receive_thread_ = std::thread([this]() { receiveLoop(); });
+    // Start receive threads (one per shard)
+    receive_threads_.reserve(config_.receive_threads);
+    for (uint32_t shard = 0; shard < config_.receive_threads; ++shard) {
+        receive_threads_.emplace_back([this, shard]() { receiveLoop(shard); });
+    }
 
-    // Start heartbeat thread
-    heartbeat_thread_ = std::thread([this]() { heartbeatLoop(); });
+    // Heartbeat on the shared maintenance thread; registry changes bring it forward
+    heartbeat_task_ = MaintenanceScheduler::instance().schedule(std::chrono::milliseconds(HEARTBEAT_INTERVAL_MS),
+                                                                [this]() { heartbeatTick(); },
+                                                                std::chrono::milliseconds(0));
+    RegistryWatcher::instance().watch(&registry_, heartbeat_task_);
 
     NEXUS_DEBUG("SHM-V3") << "Started receiving threads for " << node_id_;
 }
@@ -520,7 +1090,12 @@ void SharedMemoryTransportV3::stopReceiving() {
         queue_wait_cv_.notify_all();
     }
 
-    // 2. Wake up threads waiting on queue-specific condition variables
+    // 2. Wake up threads waiting on the doorbell / global condition variable
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+    if (my_shm_ && my_shm_ptr_ && my_shm_ptr_ != MAP_FAILED) {
+        ringDoorbell(my_shm_, nullptr);
+    }
+#else
     // 🔧 使用 trylock 避免永久阻塞
     if (my_shm_ && my_shm_ptr_ && my_shm_ptr_ != MAP_FAILED) {
         int ret = pthread_mutex_trylock(&my_shm_->header.global_mutex);
@@ -535,18 +1110,29 @@ void SharedMemoryTransportV3::stopReceiving() {
                                  << "), threads may take longer to exit";
         }
     }
+#endif
 
-    NEXUS_DEBUG("SHM-V3") << "Waiting for receive thread to join...";
-    if (receive_thread_.joinable()) {
-        receive_thread_.join();
+    // 3. Wake up threads blocked on their shard semaphore (Semaphore mode)
+    if (notify_mechanism_ == NotifyMechanism::SEMAPHORE && my_shm_ && my_shm_ptr_ && my_shm_ptr_ != MAP_FAILED) {
+        for (uint32_t shard = 0; shard < config_.receive_threads; ++shard) {
+            sem_post(&my_shm_->header.shard_sems[shard]);
+        }
     }
-    NEXUS_DEBUG("SHM-V3") << "Receive thread joined";
 
-    NEXUS_DEBUG("SHM-V3") << "Waiting for heartbeat thread to join...";
-    if (heartbeat_thread_.joinable()) {
-        heartbeat_thread_.join();
+    NEXUS_DEBUG("SHM-V3") << "Waiting for " << receive_threads_.size() << " receive thread(s) to join...";
+    for (auto& thread : receive_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
-    NEXUS_DEBUG("SHM-V3") << "Heartbeat thread joined";
+    receive_threads_.clear();
+    NEXUS_DEBUG("SHM-V3") << "Receive threads joined";
+
+    // 先停止监视再取消任务：cancel() 返回后心跳不再运行
+    RegistryWatcher::instance().unwatch(&registry_);
+    MaintenanceScheduler::instance().cancel(heartbeat_task_);
+    heartbeat_task_ = MaintenanceScheduler::NO_TASK;
+    NEXUS_DEBUG("SHM-V3") << "Heartbeat task cancelled";
 
     // 🔧 CRITICAL: 线程已退出，现在可以安全清空 callback
     // 必须在线程 join 之后，确保没有线程还在访问
@@ -562,8 +1148,9 @@ std::vector<std::string> SharedMemoryTransportV3::getLocalNodes() const {
         return node_ids;
     }
 
-    std::vector<NodeInfo> nodes = registry_.getAllNodes();
-    for (const auto& node : nodes) {
+    const auto nodes = registryNodes();
+    node_ids.reserve(nodes->size());
+    for (const auto& node : *nodes) {
         if (node.active) {
             node_ids.push_back(node.node_id);
         }
@@ -596,10 +1183,10 @@ void SharedMemoryTransportV3::warmupConnections() {
         return;
     }
 
-    std::vector<NodeInfo> nodes = registry_.getAllNodes();
+    const auto nodes = registryNodes();
     int connected = 0;
 
-    for (const auto& node : nodes) {
+    for (const auto& node : *nodes) {
         if (node.node_id != node_id_ && node.active) {
             if (connectToNode(node.node_id)) {
                 connected++;
@@ -619,9 +1206,18 @@ SharedMemoryTransportV3::TransportStats SharedMemoryTransportV3::getStats() cons
     stats.bytes_received = stats_bytes_received_.load();
     stats.active_connections = getConnectionCount();
     stats.inbound_queues = my_shm_ ? my_shm_->header.num_queues.load() : 0;
+    stats.inbox_depth = my_shm_ ? my_shm_->inbox.pending.load(std::memory_order_relaxed) : 0;
+    stats.numa_node = my_shm_ ? numaNodeOf(&my_shm_->header) : -1;
+
+    for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+        stats.lanes[lane].messages_sent = stats_lane_sent_[lane].load();
+        stats.lanes[lane].messages_dropped = stats_lane_dropped_[lane].load();
+        stats.lanes[lane].depth = 0;
+    }
 
     // Calculate average queue depth
     stats.avg_queue_depth = 0.0;
+    stats.max_congestion_level = 0;
     if (my_shm_) {
         uint32_t num_queues = my_shm_->header.num_queues.load();
         if (num_queues > 0) {
@@ -631,8 +1227,14 @@ SharedMemoryTransportV3::TransportStats SharedMemoryTransportV3::getStats() cons
                 InboundQueue& q = my_shm_->queues[i];
                 // 🔧 Use acquire to ensure we see complete queue state
                 if ((q.flags.load(std::memory_order_acquire) & 0x3) == 0x3) {
-                    // 🔧 双队列架构：统计两个队列的深度
-                    total_depth += q.control_queue.size() + q.data_queue.size();
+                    // 🔧 统计控制队列与所有数据lane的深度
+                    total_depth += q.control_queue.size();
+                    for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+                        total_depth += q.data_lanes[lane].ring.size();
+                        stats.lanes[lane].depth += q.data_lanes[lane].pending.load(std::memory_order_relaxed);
+                    }
+                    stats.max_congestion_level =
+                        std::max(stats.max_congestion_level, q.congestion_level.load(std::memory_order_relaxed));
                     active_queues++;
                 }
             }
@@ -645,6 +1247,57 @@ SharedMemoryTransportV3::TransportStats SharedMemoryTransportV3::getStats() cons
     return stats;
 }
 
+std::vector<SharedMemoryTransportV3::RingFill> SharedMemoryTransportV3::getOutboundFill() const {
+    std::vector<RingFill> fill;
+    if (!initialized_) {
+        return fill;
+    }
+
+    SnapshotReader reader(*this);
+    if (!reader.get()) {
+        return fill;
+    }
+    for (const auto& entry : reader.get()->by_id) {
+        InboundQueue* queue = dedicatedQueue(entry.second);
+        if (!queue) {
+            continue;
+        }
+        for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+            const DataRing& ring = queue->data_lanes[lane].ring;
+            fill.push_back({entry.first, lane, ring.size(), ring.capacity()});
+        }
+    }
+    return fill;
+}
+
+SharedMemoryTransportV3::SegmentUsage SharedMemoryTransportV3::getSegmentUsage() const {
+    SegmentUsage segment;
+    segment.node_id = node_id_;
+    if (initialized_ && my_shm_) {
+        segment.usage = mappingUsage(my_shm_, my_shm_size_);
+    }
+    return segment;
+}
+
+std::vector<SharedMemoryTransportV3::SegmentUsage> SharedMemoryTransportV3::getPeerSegmentUsage() const {
+    std::vector<SegmentUsage> segments;
+    if (!initialized_) {
+        return segments;
+    }
+
+    SnapshotReader reader(*this);
+    if (!reader.get()) {
+        return segments;
+    }
+    for (const auto& entry : reader.get()->by_id) {
+        if (entry.second.shm) {
+            size_t size = segmentSize(entry.second.shm->header.max_queues.load(std::memory_order_relaxed));
+            segments.push_back({entry.first, mappingUsage(entry.second.shm, size)});
+        }
+    }
+    return segments;
+}
+
 bool SharedMemoryTransportV3::cleanupOrphanedMemory() {
     NEXUS_DEBUG("SHM-V3") << "Cleaning up orphaned shared memory...";
 
@@ -790,6 +1443,14 @@ int SharedMemoryTransportV3::getActiveNodeCount() {
 
 // Private helper methods
 
+ShmMapOptions SharedMemoryTransportV3::mapOptions() const {
+    ShmMapOptions options;
+    options.huge_pages = config_.huge_pages;
+    options.prefault = config_.prefault;
+    options.lock = config_.lock_memory;
+    return options;
+}
+
 bool SharedMemoryTransportV3::createMySharedMemory() {
     // Create shared memory
     my_shm_fd_ = shm_open(my_shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
@@ -804,7 +1465,8 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
     }
 
     // Set size
-    size_t shm_size = sizeof(NodeSharedMemory);
+    // 🔧 只映射配置的队列数：max_inbound_queues之后的队列槽位不在段内
+    size_t shm_size = segmentSize(config_.max_inbound_queues);
     if (ftruncate(my_shm_fd_, shm_size) < 0) {
         NEXUS_ERROR("SHM-V3") << "Failed to set size: " << strerror(errno);
         close(my_shm_fd_);
@@ -813,13 +1475,11 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
         return false;
     }
 
-// Map memory
-// Note: MAP_NORESERVE may not be supported on QNX, use MAP_SHARED only
-#ifdef __QNXNTO__
-    my_shm_ptr_ = mmap(nullptr, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, my_shm_fd_, 0);
-#else
-    my_shm_ptr_ = mmap(nullptr, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, my_shm_fd_, 0);
-#endif
+    // Map memory (MAP_NORESERVE is skipped on QNX)
+    // 🔧 NUMA策略只设置在自己的段上：远端段的放置由其所有者决定
+    ShmMapOptions options = mapOptions();
+    options.numa_node = config_.numa_node;
+    my_shm_ptr_ = mapSharedMemory(my_shm_fd_, shm_size, PROT_READ | PROT_WRITE, options);
     if (my_shm_ptr_ == MAP_FAILED) {
         NEXUS_ERROR("SHM-V3") << "Failed to map memory: " << strerror(errno);
         close(my_shm_fd_);
@@ -828,6 +1488,7 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
         return false;
     }
 
+    my_shm_size_ = shm_size;
     my_shm_ = static_cast<NodeSharedMemory*>(my_shm_ptr_);
 
     // Initialize header
@@ -843,6 +1504,8 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
         std::memory_order_relaxed);
     my_shm_->header.ready.store(false, std::memory_order_relaxed);
     my_shm_->header.owner_pid.store(getpid(), std::memory_order_relaxed);
+    my_shm_->header.data_queue_capacity.store(static_cast<uint32_t>(config_.queue_capacity),
+                                              std::memory_order_relaxed);
 
     // CRITICAL: Initialize accessor tracking
     my_shm_->header.num_accessors.store(0, std::memory_order_relaxed);
@@ -865,8 +1528,31 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
     pthread_mutexattr_destroy(&mattr);
     pthread_condattr_destroy(&cattr);
 
+    my_shm_->header.ready_queues.store(0, std::memory_order_relaxed);
+    my_shm_->header.doorbell.store(0, std::memory_order_relaxed);
+    my_shm_->header.doorbell_waiters.store(0, std::memory_order_relaxed);
+    my_shm_->header.receive_shards.store(config_.receive_threads, std::memory_order_relaxed);
+    for (uint32_t shard = 0; shard < MAX_RECEIVE_THREADS; ++shard) {
+        if (sem_init(&my_shm_->header.shard_sems[shard], 1, 0) != 0) {
+            NEXUS_ERROR("SHM-V3") << "sem_init failed: " << strerror(errno);
+            munmap(my_shm_ptr_, my_shm_size_);
+            my_shm_ptr_ = nullptr;
+            my_shm_ = nullptr;
+            close(my_shm_fd_);
+            my_shm_fd_ = -1;
+            shm_unlink(my_shm_name_.c_str());
+            return false;
+        }
+    }
+    my_shm_->header.inbox_enabled.store(config_.shared_inbox ? 1 : 0, std::memory_order_relaxed);
+
+    // 🔧 共享收件箱：槽位序号全零即为空闲（见InboxSlot），只需清零位置计数
+    my_shm_->inbox.enqueue_pos.store(0, std::memory_order_relaxed);
+    my_shm_->inbox.dequeue_pos.store(0, std::memory_order_relaxed);
+    my_shm_->inbox.pending.store(0, std::memory_order_relaxed);
+
     // Initialize all queues
-    for (size_t i = 0; i < MAX_INBOUND_QUEUES; ++i) {
+    for (size_t i = 0; i < config_.max_inbound_queues; ++i) {
         my_shm_->queues[i].flags.store(0, std::memory_order_relaxed);
         // 🔧 Initialize atomic sender_id array
         for (int j = 0; j < 8; ++j) {
@@ -874,15 +1560,24 @@ bool SharedMemoryTransportV3::createMySharedMemory() {
         }
         // 🔧 双队列架构：初始化两个pending计数器
         my_shm_->queues[i].control_pending.store(0, std::memory_order_relaxed);
-        my_shm_->queues[i].data_pending.store(0, std::memory_order_relaxed);
+        for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+            my_shm_->queues[i].data_lanes[lane].pending.store(0, std::memory_order_relaxed);
+        }
         // 🔧 初始化流控字段
         my_shm_->queues[i].congestion_level.store(0, std::memory_order_relaxed);
         my_shm_->queues[i].drop_count.store(0, std::memory_order_relaxed);
     }
 
-    size_t mb = shm_size / (1024 * 1024);
+    // 🔧 段是稀疏的：只有已连接发送方的队列（且只在容量范围内）才会占用物理内存
+    size_t mb = (shm_size + 1024 * 1024 - 1) / (1024 * 1024);
+    size_t per_sender_kb = (CONTROL_QUEUE_SIZE_BYTES + config_.queue_capacity) / 1024;  // Per lane in use
+    size_t busy_sender_kb = (CONTROL_QUEUE_SIZE_BYTES + config_.queue_capacity * (DATA_LANES - 1) +
+                             std::max(config_.queue_capacity / BULK_LANE_CAPACITY_DIVISOR, MIN_DATA_QUEUE_SIZE_BYTES)) /
+                            1024;
     NEXUS_DEBUG("SHM-V3") << "Created shared memory: " << my_shm_name_ << " (" << mb
-                          << " MB, max_queues=" << config_.max_inbound_queues << ")";
+                          << " MB virtual, ~" << per_sender_kb << " KB per connected sender (~" << busy_sender_kb
+                          << " KB with every lane full), max_queues="
+                          << config_.max_inbound_queues << ")";
 
     return true;
 }
@@ -893,7 +1588,7 @@ void SharedMemoryTransportV3::destroyMySharedMemory() {
     // 这里我们只是unmap，让操作系统在shm被删除时清理
 
     if (my_shm_ptr_ && my_shm_ptr_ != MAP_FAILED) {
-        munmap(my_shm_ptr_, sizeof(NodeSharedMemory));
+        munmap(my_shm_ptr_, my_shm_size_);
         my_shm_ptr_ = nullptr;
         my_shm_ = nullptr;
     }
@@ -910,7 +1605,7 @@ void SharedMemoryTransportV3::destroyMySharedMemory() {
 }
 
 bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
-    std::lock_guard<std::mutex> lock(connections_mutex_);
+    std::unique_lock<std::mutex> lock(connections_mutex_);
 
     // Check if already connected
     auto it = remote_connections_.find(target_node_id);
@@ -919,23 +1614,9 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
     }
 
     // Get target node info from registry
+    // 注册表写入在global_lock内完成，findNode看到的总是完整条目：未找到即未注册，无需重试
     NodeInfo target_info;
-    bool found = false;
-
-    // 🔧 CRITICAL: Retry mechanism for cross-process registry lookup
-    // Due to timing issues in shared memory synchronization, retry a few times
-    for (int retry = 0; retry < 5 && !found; ++retry) {
-        if (registry_.findNode(target_node_id, target_info)) {
-            found = true;
-            break;
-        }
-        if (retry < 4) {
-            // Short delay before retry (microseconds)
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
-        }
-    }
-
-    if (!found) {
+    if (!registry_.findNode(target_node_id, target_info)) {
         NEXUS_ERROR("SHM-V3") << "Node not found in registry: " << target_node_id;
         return false;
     }
@@ -952,14 +1633,17 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
         return false;
     }
 
-// Map remote memory
-// Note: MAP_NORESERVE may not be supported on QNX, use MAP_SHARED only
-#ifdef __QNXNTO__
-    conn.shm_ptr = mmap(nullptr, sizeof(NodeSharedMemory), PROT_READ | PROT_WRITE, MAP_SHARED, conn.shm_fd, 0);
-#else
-    conn.shm_ptr =
-        mmap(nullptr, sizeof(NodeSharedMemory), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, conn.shm_fd, 0);
-#endif
+    // 🔧 段大小由接收方的max_queues决定：按文件实际大小映射，版本校验后再确认其覆盖全部队列
+    struct stat st;
+    if (fstat(conn.shm_fd, &st) < 0 || static_cast<size_t>(st.st_size) < offsetof(NodeSharedMemory, queues)) {
+        NEXUS_DEBUG("SHM-V3") << "Remote shm too small or not sized yet: " << target_info.shm_name;
+        close(conn.shm_fd);
+        return false;
+    }
+    conn.shm_size = static_cast<size_t>(st.st_size);
+
+    // Map remote memory (same options as our own segment: the sender faults in its page tables too)
+    conn.shm_ptr = mapSharedMemory(conn.shm_fd, conn.shm_size, PROT_READ | PROT_WRITE, mapOptions());
     if (conn.shm_ptr == MAP_FAILED) {
         NEXUS_ERROR("SHM-V3") << "Failed to map remote shm: " << strerror(errno);
         close(conn.shm_fd);
@@ -972,7 +1656,24 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
     uint32_t magic = remote_shm->header.magic.load(std::memory_order_acquire);
     if (magic != MAGIC) {
         NEXUS_ERROR("SHM-V3") << "Invalid magic in remote shm: 0x" << std::hex << magic;
-        munmap(conn.shm_ptr, sizeof(NodeSharedMemory));
+        munmap(conn.shm_ptr, conn.shm_size);
+        close(conn.shm_fd);
+        return false;
+    }
+
+    // 🔧 队列布局随版本变化（v2新增数据lane），不同版本的节点不能互相写入
+    uint32_t version = remote_shm->header.version.load(std::memory_order_acquire);
+    if (version != VERSION) {
+        NEXUS_ERROR("SHM-V3") << "Incompatible shm layout version " << version << " (expected " << VERSION
+                              << ") for node: " << target_node_id;
+        munmap(conn.shm_ptr, conn.shm_size);
+        close(conn.shm_fd);
+        return false;
+    }
+    if (conn.shm_size < segmentSize(remote_shm->header.max_queues.load(std::memory_order_acquire))) {
+        NEXUS_ERROR("SHM-V3") << "Remote shm smaller than its queue array (" << conn.shm_size
+                              << " bytes) for node: " << target_node_id;
+        munmap(conn.shm_ptr, conn.shm_size);
         close(conn.shm_fd);
         return false;
     }
@@ -982,7 +1683,7 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
     if (!is_ready) {
         // 节点正在初始化中，不是错误，直接返回 false 等待下次重试
         NEXUS_DEBUG("SHM-V3") << "Remote node not ready yet: " << target_node_id << ", will retry later";
-        munmap(conn.shm_ptr, sizeof(NodeSharedMemory));
+        munmap(conn.shm_ptr, conn.shm_size);
         close(conn.shm_fd);
         return false;
     }
@@ -994,7 +1695,7 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
         // 进程不存在，不要连接
         NEXUS_WARN("SHM-V3") << "Remote node process is dead (pid=" << owner_pid
                              << "), skipping connection to: " << target_node_id;
-        munmap(conn.shm_ptr, sizeof(NodeSharedMemory));
+        munmap(conn.shm_ptr, conn.shm_size);
         close(conn.shm_fd);
         // 注意：不在这里删除共享内存文件，避免 Bus error
         // 其他节点可能正在访问，由心跳系统统一清理
@@ -1022,8 +1723,13 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
     }
 
     // Find or create queue for me in target node's memory
-    conn.my_queue = findOrCreateQueue(remote_shm, node_id_);
-    if (!conn.my_queue) {
+    // 🔧 对方启用了共享收件箱：先走收件箱，速率上来后再申请专属队列（见inboxQueue()）
+    if (remote_shm->header.inbox_enabled.load(std::memory_order_acquire)) {
+        conn.inbox = std::make_shared<InboxRoute>();
+    } else {
+        conn.my_queue = findOrCreateQueue(remote_shm, node_id_);
+    }
+    if (!conn.my_queue && !conn.inbox) {
         NEXUS_ERROR("SHM-V3") << "Failed to create queue in remote node";
 
         // Remove my PID if queue allocation failed
@@ -1038,20 +1744,130 @@ bool SharedMemoryTransportV3::connectToNode(const std::string& target_node_id) {
             }
         }
 
-        munmap(conn.shm_ptr, sizeof(NodeSharedMemory));
+        munmap(conn.shm_ptr, conn.shm_size);
         close(conn.shm_fd);
         return false;
     }
 
     conn.connected = true;
+    conn.handle = next_node_handle_++;
 
     remote_connections_[target_node_id] = conn;
+    publishConnectionSnapshot();
+    lock.unlock();
 
     NEXUS_INFO("SHM-V3") << "Connected to node: " << target_node_id << " (shm: " << target_info.shm_name << ")";
 
+    // 🔧 就绪事件（锁外回调）
+    ConnectionCallback callback;
+    {
+        std::lock_guard<std::mutex> connector_lock(connector_mutex_);
+        pending_connects_.erase(target_node_id);
+        callback = connection_callback_;
+    }
+    if (callback) {
+        callback(target_node_id, conn.handle);
+    }
     return true;
 }
 
+void SharedMemoryTransportV3::connectAsync(const std::string& node_id) {
+    if (!initialized_ || node_id == node_id_) {
+        return;
+    }
+    {
+        SnapshotReader reader(*this);
+        if (reader.get() && reader.get()->find(node_id)) {
+            return;  // Already connected
+        }
+    }
+    requestConnect(node_id, false);
+}
+
+bool SharedMemoryTransportV3::isConnectPending(const std::string& node_id) const {
+    std::lock_guard<std::mutex> lock(connector_mutex_);
+    auto it = pending_connects_.find(node_id);
+    return it != pending_connects_.end() && it->second.failures > 0;
+}
+
+void SharedMemoryTransportV3::setConnectionCallback(ConnectionCallback callback) {
+    std::lock_guard<std::mutex> lock(connector_mutex_);
+    connection_callback_ = std::move(callback);
+}
+
+void SharedMemoryTransportV3::requestConnect(const std::string& node_id, bool failed) {
+    {
+        std::lock_guard<std::mutex> lock(connector_mutex_);
+        auto result = pending_connects_.emplace(
+            node_id, PendingConnect{std::chrono::steady_clock::now(), SHM_CONNECT_RETRY_MIN_MS, 0});
+        if (failed) {
+            PendingConnect& pending = result.first->second;
+            pending.failures++;
+            pending.next_attempt = std::chrono::steady_clock::now() + std::chrono::milliseconds(pending.backoff_ms);
+        }
+    }
+    connector_cv_.notify_one();
+}
+
+bool SharedMemoryTransportV3::connectInline(const std::string& node_id) {
+    // 已失败并交给connector的节点：发送线程不再重复尝试（shm_open/mmap），等待就绪事件
+    if (isConnectPending(node_id)) {
+        return false;
+    }
+    if (connectToNode(node_id)) {
+        return true;
+    }
+    requestConnect(node_id, true);
+    return false;
+}
+
+void SharedMemoryTransportV3::connectorLoop() {
+    applyThreadPlacement(config_.connector_placement, "shm connector");
+    std::unique_lock<std::mutex> lock(connector_mutex_);
+    while (!connector_stop_) {
+        if (pending_connects_.empty()) {
+            connector_cv_.wait(lock);
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto next_due = std::chrono::steady_clock::time_point::max();
+        std::vector<std::string> due;
+        for (const auto& pair : pending_connects_) {
+            if (pair.second.next_attempt <= now) {
+                due.push_back(pair.first);
+            } else {
+                next_due = std::min(next_due, pair.second.next_attempt);
+            }
+        }
+        if (due.empty()) {
+            connector_cv_.wait_until(lock, next_due);
+            continue;
+        }
+
+        lock.unlock();
+        for (const auto& node_id : due) {
+            // 节点已注销：放弃；否则连接（新连接由connectToNode触发就绪事件）
+            const bool registered = registry_.nodeExists(node_id);
+            const bool connected = registered && connectToNode(node_id);
+            std::lock_guard<std::mutex> retry_lock(connector_mutex_);
+            auto it = pending_connects_.find(node_id);
+            if (it == pending_connects_.end()) {
+                continue;
+            }
+            if (connected || !registered) {
+                pending_connects_.erase(it);
+                continue;
+            }
+            PendingConnect& pending = it->second;
+            pending.failures++;
+            pending.next_attempt = std::chrono::steady_clock::now() + std::chrono::milliseconds(pending.backoff_ms);
+            pending.backoff_ms = std::min<uint32_t>(pending.backoff_ms * 2, SHM_CONNECT_RETRY_MAX_MS);
+        }
+        lock.lock();
+    }
+}
+
 void SharedMemoryTransportV3::disconnectFromNode(const std::string& target_node_id) {
     std::lock_guard<std::mutex> lock(connections_mutex_);
 
@@ -1060,23 +1876,106 @@ void SharedMemoryTransportV3::disconnectFromNode(const std::string& target_node_
         return;
     }
 
-    RemoteConnection& conn = it->second;
+    RemoteConnection conn = it->second;
+    remote_connections_.erase(it);
 
     // Remove our PID from the remote node's accessor list before disconnecting
     if (conn.shm_ptr && conn.shm_ptr != MAP_FAILED) {
         NodeSharedMemory* remote_shm = static_cast<NodeSharedMemory*>(conn.shm_ptr);
         removeAccessorFromNode(&remote_shm->header, getpid());
+    }
+
+    // 🔧 发布不含该连接的快照；正在发送的线程可能仍在使用映射，随旧快照一起延后解除映射
+    std::vector<RemoteConnection> released;
+    released.push_back(conn);
+    publishConnectionSnapshot(std::move(released));
+
+    NEXUS_DEBUG("SHM-V3") << "Disconnected from node: " << target_node_id;
+}
+
+const SharedMemoryTransportV3::ConnectionSnapshot::Entry* SharedMemoryTransportV3::ConnectionSnapshot::find(
+    const std::string& node_id) const {
+    auto it = by_id.find(node_id);
+    return it != by_id.end() ? &it->second : nullptr;
+}
+
+const SharedMemoryTransportV3::ConnectionSnapshot::Entry* SharedMemoryTransportV3::ConnectionSnapshot::find(
+    NodeHandle handle) const {
+    auto it = std::lower_bound(by_handle.begin(), by_handle.end(), handle,
+                               [](const Entry& entry, NodeHandle h) { return entry.handle < h; });
+    return (it != by_handle.end() && it->handle == handle) ? &*it : nullptr;
+}
+
+SharedMemoryTransportV3::SnapshotReader::SnapshotReader(const SharedMemoryTransportV3& transport)
+    : transport_(transport), epoch_(0), snapshot_(nullptr) {
+    // Register in the current epoch; retry if a writer flipped it meanwhile
+    while (true) {
+        epoch_ = transport_.snapshot_epoch_.load();
+        transport_.snapshot_readers_[epoch_].fetch_add(1);
+        if (transport_.snapshot_epoch_.load() == epoch_) {
+            break;
+        }
+        transport_.snapshot_readers_[epoch_].fetch_sub(1);
+    }
+    snapshot_ = transport_.connection_snapshot_.load();
+}
+
+SharedMemoryTransportV3::SnapshotReader::~SnapshotReader() {
+    transport_.snapshot_readers_[epoch_].fetch_sub(1, std::memory_order_release);
+}
+
+void SharedMemoryTransportV3::publishConnectionSnapshot(std::vector<RemoteConnection> released) {
+    // Caller holds connections_mutex_, so writers are serialized
+    ConnectionSnapshot* snapshot = new ConnectionSnapshot();
+    snapshot->by_id.reserve(remote_connections_.size());
+    snapshot->by_handle.reserve(remote_connections_.size());
+    for (const auto& pair : remote_connections_) {
+        const RemoteConnection& conn = pair.second;
+        if (conn.connected && (conn.my_queue || conn.inbox)) {
+            ConnectionSnapshot::Entry entry = {conn.handle, static_cast<NodeSharedMemory*>(conn.shm_ptr), conn.my_queue,
+                                               conn.inbox};
+            snapshot->by_id.emplace(pair.first, entry);
+            snapshot->by_handle.push_back(entry);
+        }
+    }
+    std::sort(snapshot->by_handle.begin(), snapshot->by_handle.end(),
+              [](const ConnectionSnapshot::Entry& a, const ConnectionSnapshot::Entry& b) { return a.handle < b.handle; });
+
+    const ConnectionSnapshot* old_snapshot = connection_snapshot_.exchange(snapshot);
 
-        munmap(conn.shm_ptr, sizeof(NodeSharedMemory));
+    // Readers may block (credit wait, inbox drain) while holding the old snapshot,
+    // so never wait for them here: retire it and free it once they are gone
+    retired_snapshots_.push_back({old_snapshot, std::move(released), snapshot_flips_});
+    reclaimRetiredSnapshots();
+}
+
+void SharedMemoryTransportV3::reclaimRetiredSnapshots() {
+    // An epoch is only re-entered once its readers have left. A reader that saw a
+    // retired snapshot registered in one of the two epochs before it was retired,
+    // so two flips after the retirement nobody can still use it.
+    for (int i = 0; i < 2 && !retired_snapshots_.empty(); ++i) {
+        uint32_t next_epoch = snapshot_epoch_.load() ^ 1;
+        if (snapshot_readers_[next_epoch].load(std::memory_order_acquire) != 0) {
+            break;
+        }
+        snapshot_epoch_.store(next_epoch);
+        ++snapshot_flips_;
     }
 
-    if (conn.shm_fd >= 0) {
-        close(conn.shm_fd);
+    size_t freed = 0;
+    while (freed < retired_snapshots_.size() && retired_snapshots_[freed].flips + 2 <= snapshot_flips_) {
+        RetiredSnapshot& retired = retired_snapshots_[freed++];
+        delete retired.snapshot;
+        for (const RemoteConnection& conn : retired.connections) {
+            if (conn.shm_ptr && conn.shm_ptr != MAP_FAILED) {
+                munmap(conn.shm_ptr, conn.shm_size);
+            }
+            if (conn.shm_fd >= 0) {
+                close(conn.shm_fd);
+            }
+        }
     }
-
-    remote_connections_.erase(it);
-
-    NEXUS_DEBUG("SHM-V3") << "Disconnected from node: " << target_node_id;
+    retired_snapshots_.erase(retired_snapshots_.begin(), retired_snapshots_.begin() + freed);
 }
 
 SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueue(NodeSharedMemory* remote_shm,
@@ -1103,8 +2002,8 @@ SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueu
         return nullptr;
     }
 
-    // Find free slot
-    for (size_t i = 0; i < MAX_INBOUND_QUEUES; ++i) {
+    // Find free slot (only the first max_queues slots are mapped)
+    for (size_t i = 0; i < max_queues && i < MAX_INBOUND_QUEUES; ++i) {
         InboundQueue& q = remote_shm->queues[i];
         uint32_t expected = 0;
         // 🔧 使用acquire-release语义的CAS保证原子性
@@ -1113,16 +2012,33 @@ SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueu
             // 🔧 Write sender_id atomically
             SharedMemoryRegistry::writeAtomicString(q.sender_id_atomic, sender_id, 64);
 
+            // 🔧 运行时队列容量：采用接收方配置（在 flags 置为 active 之前写入）
+            // 接收方公布的容量若小于 MIN_DATA_QUEUE_SIZE_BYTES 则抬高，保证完整 MessagePacket 可写入
+            // （存储区总是 DATA_QUEUE_SIZE_BYTES，capacity_ 位于共享内存，读写双方看到同一值）
+            // BULK lane 只用 1/BULK_LANE_CAPACITY_DIVISOR 的容量，降低繁忙发送方的常驻内存
+            size_t data_capacity = remote_shm->header.data_queue_capacity.load(std::memory_order_acquire);
+            if (data_capacity != 0 && data_capacity < MIN_DATA_QUEUE_SIZE_BYTES) {
+                data_capacity = MIN_DATA_QUEUE_SIZE_BYTES;
+            }
+            if (data_capacity == 0) {
+                data_capacity = DATA_QUEUE_SIZE_BYTES;
+            }
+            for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+                size_t lane_capacity = data_capacity;
+                if (lane == BULK_DATA_LANE) {
+                    lane_capacity = std::max(data_capacity / BULK_LANE_CAPACITY_DIVISOR, MIN_DATA_QUEUE_SIZE_BYTES);
+                    lane_capacity = std::min(lane_capacity, data_capacity);
+                }
+                q.data_lanes[lane].ring.setCapacity(lane_capacity);
+            }
+
             // 🔧 双队列架构：初始化控制队列和数据队列
             if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
-                // Semaphore模式
-                if (sem_init(&q.control_sem, 1, 0) != 0 || sem_init(&q.data_sem, 1, 0) != 0) {
-                    NEXUS_ERROR("SHM-V3") << "sem_init failed: " << strerror(errno);
-                    q.flags.store(0, std::memory_order_release);
-                    return nullptr;
-                }
+                // Semaphore模式：接收方的分片信号量在其创建共享内存时已初始化
                 q.control_pending.store(0, std::memory_order_relaxed);
-                q.data_pending.store(0, std::memory_order_relaxed);
+                for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+                    q.data_lanes[lane].pending.store(0, std::memory_order_relaxed);
+                }
 
                 // 🔧 CRITICAL: CPU-level fence for cross-process visibility
                 std::atomic_thread_fence(std::memory_order_release);
@@ -1134,7 +2050,9 @@ SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueu
             } else {
                 // Condition Variable模式：使用全局共享的cond_var
                 q.control_pending.store(0, std::memory_order_relaxed);
-                q.data_pending.store(0, std::memory_order_relaxed);
+                for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+                    q.data_lanes[lane].pending.store(0, std::memory_order_relaxed);
+                }
                 q.congestion_level.store(0, std::memory_order_relaxed);
                 q.drop_count.store(0, std::memory_order_relaxed);
 
@@ -1144,18 +2062,18 @@ SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueu
                 // 🔧 Use seq_cst for cross-process immediate visibility
                 q.flags.store(0x3, std::memory_order_seq_cst);  // valid | active
 
-                NEXUS_DEBUG("SHM-V3") << "Created dual queues (global CV) for sender: " << sender_id
+                NEXUS_DEBUG("SHM-V3") << "Created dual queues (doorbell) for sender: " << sender_id
                                       << " (control: 64, data: 256)";
-
-                // 🔧 立即通知远程节点有新队列
-                pthread_mutex_lock(&remote_shm->header.global_mutex);
-                pthread_cond_signal(&remote_shm->header.global_cond);
-                pthread_mutex_unlock(&remote_shm->header.global_mutex);
             }
 
             // 🔧 Use seq_cst to ensure queue is visible before count increases
             remote_shm->header.num_queues.fetch_add(1, std::memory_order_seq_cst);
 
+            // 🔧 立即通知远程节点有新队列（num_queues已更新，接收方醒来即可刷新队列列表）
+            if (notify_mechanism_ != NotifyMechanism::SEMAPHORE) {
+                ringDoorbell(remote_shm, nullptr);
+            }
+
             NEXUS_DEBUG("SHM-V3") << "Created queue in remote node, num_queues now: "
                                   << remote_shm->header.num_queues.load();
 
@@ -1166,20 +2084,293 @@ SharedMemoryTransportV3::InboundQueue* SharedMemoryTransportV3::findOrCreateQueu
     return nullptr;
 }
 
-void SharedMemoryTransportV3::receiveLoop() {
+// 🔧 门铃：置位队列在ready_queues中的位并唤醒接收方（queue为nullptr时只唤醒，用于新队列/停止）
+void SharedMemoryTransportV3::ringDoorbell(NodeSharedMemory* shm, const InboundQueue* queue) {
+    ringDoorbell(shm, queue ? static_cast<uint32_t>(queue - shm->queues) : UINT32_MAX);
+}
+
+// 🔧 SEM模式：post负责该槽位（队列下标或INBOX_SLOT）的接收分片的信号量
+void SharedMemoryTransportV3::postShardSemaphore(NodeSharedMemory* shm, uint32_t slot) {
+    uint32_t shards = shm->header.receive_shards.load(std::memory_order_relaxed);
+    uint32_t shard = shards > 1 ? slot % shards : 0;
+    sem_post(&shm->header.shard_sems[std::min(shard, MAX_RECEIVE_THREADS - 1)]);
+}
+
+// 🔧 按槽位敲门铃：slot为队列下标或INBOX_SLOT（共享收件箱），UINT32_MAX时只唤醒
+void SharedMemoryTransportV3::ringDoorbell(NodeSharedMemory* shm, uint32_t slot) {
+    NodeHeader& header = shm->header;
+    uint32_t shards = header.receive_shards.load(std::memory_order_relaxed);
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+    uint32_t wake_bits = FUTEX_BITSET_MATCH_ANY;
+    if (slot != UINT32_MAX) {
+        uint64_t bit = uint64_t{1} << slot;
+        // 位已置位：之前的发送方已经（或即将）敲过门铃，接收方尚未取走
+        if (header.ready_queues.fetch_or(bit, std::memory_order_seq_cst) & bit) {
+            return;
+        }
+        if (shards > 1) {
+            wake_bits = 1u << (slot % shards);
+        }
+    }
+    header.doorbell.fetch_add(1, std::memory_order_seq_cst);
+    // 与接收方 doorbell_waiters++ 后重查 ready_queues 配对：二者至少有一方看到对方
+    if (header.doorbell_waiters.load(std::memory_order_seq_cst) != 0) {
+        futexWake(&header.doorbell, wake_bits);
+    }
+#else
+    (void)slot;
+    // 多个接收线程共享global_cond：必须广播，否则可能唤醒不负责该队列的线程
+    if (shards > 1) {
+        pthread_cond_broadcast(&header.global_cond);
+    } else {
+        pthread_cond_signal(&header.global_cond);
+    }
+#endif
+}
+
+// 🔧 接收线程放置：receive_cpu（每个线程一个CPU）优先，其次receive_placement的CPU掩码，最后是段所在NUMA节点的全部CPU
+void SharedMemoryTransportV3::applyReceivePlacement(uint32_t shard) {
+    ThreadPlacement placement = config_.receive_placement;
+    if (config_.receive_cpu >= 0) {
+        const int cpu = config_.receive_cpu + static_cast<int>(shard);
+        placement.cpu_mask = cpu < 64 ? uint64_t(1) << cpu : 0;
+    } else if (placement.cpu_mask == 0 && config_.numa_node >= 0) {
+        placement.cpu_mask = numaNodeCpus(config_.numa_node);
+        if (placement.cpu_mask == 0) {
+            NEXUS_WARN("SHM-V3") << "NUMA node " << config_.numa_node << " has no CPUs; receive thread " << shard
+                                 << " left unpinned";
+        }
+    }
+    if (applyThreadPlacement(placement, "shm receive " + std::to_string(shard)) && placement.cpu_mask != 0) {
+        NEXUS_DEBUG("SHM-V3") << "Receive thread " << shard << " pinned to CPU mask 0x" << std::hex
+                              << placement.cpu_mask << std::dec;
+    }
+}
+
+// 🔧 固定映射：队列槽位i由分片 i % receive_threads 处理，同一发送方的消息始终由同一线程按序投递
+// （共享收件箱视为槽位INBOX_SLOT）
+uint64_t SharedMemoryTransportV3::shardQueueMask(uint32_t shard) const {
+    uint64_t mask = 0;
+    for (uint32_t i = shard; i <= INBOX_SLOT; i += config_.receive_threads) {
+        if (i < config_.max_inbound_queues || (i == INBOX_SLOT && config_.shared_inbox)) {
+            mask |= uint64_t{1} << i;
+        }
+    }
+    return mask;
+}
+
+bool SharedMemoryTransportV3::hasPending(const InboundQueue* queue) {
+    if (queue->control_pending.load(std::memory_order_acquire) != 0) {
+        return true;
+    }
+    for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+        if (queue->data_lanes[lane].pending.load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Deliver up to max_frames frames of one data lane; returns the number delivered
+int SharedMemoryTransportV3::drainDataLane(InboundQueue* queue, uint32_t lane, int max_frames) {
+    DataLane& data_lane = queue->data_lanes[lane];
+    if (data_lane.pending.load(std::memory_order_acquire) == 0) {
+        return 0;
+    }
+
+    // 🔧 Use acquire to ensure we see all queue fields
+    uint32_t flags = queue->flags.load(std::memory_order_acquire);
+    if ((flags & 0x3) != 0x3) {
+        return 0;
+    }
+
+    int processed = 0;
+    // 🔧 Read sender ID once from queue metadata
+    std::string from_node = SharedMemoryRegistry::readAtomicString(queue->sender_id_atomic, 64);
+
+    while (processed < max_frames) {
+        // 🔧 零拷贝：回调直接读取环形缓冲区中的消息，返回后才释放空间
+        DataRing::ReadView view;
+        if (!data_lane.ring.tryPeek(view)) {
+            break;
+        }
+
+        processed++;
+        stats_bytes_received_ += view.size;
+        NEXUS_TRACE3(shm_ring_read, queue, view.size, lane);
+
+        // 🔧 检查 callback 是否有效（可能在析构时被清空）
+        auto callback = receive_callback_;
+        if (callback) {
+            callback(view.data, view.size, from_node);
+        }
+        data_lane.ring.consume(view);
+    }
+
+    if (processed > 0) {
+        stats_messages_received_ += processed;
+        data_lane.pending.fetch_sub(processed, std::memory_order_release);
+    }
+    return processed;
+}
+
+// Deliver up to max_frames frames from the shared inbox; returns the number delivered
+int SharedMemoryTransportV3::drainInbox(int max_frames) {
+    SharedInbox& inbox = my_shm_->inbox;
+    if (inbox.pending.load(std::memory_order_acquire) == 0) {
+        return 0;
+    }
+
+    uint64_t pos = inbox.dequeue_pos.load(std::memory_order_relaxed);
+    int processed = 0;
+    while (processed < max_frames) {
+        InboxSlot& slot = inbox.slots[pos % SHARED_INBOX_SLOTS];
+        const uint64_t lap = pos - pos % SHARED_INBOX_SLOTS;
+        const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != lap + 1) {
+            // 空，或发送方仍在写入（按位置顺序投递）；已被占用但占用者崩溃时跳过该位置
+            if (seq != lap || pos >= inbox.enqueue_pos.load(std::memory_order_acquire) ||
+                !inboxClaimAbandoned(slot, pos)) {
+                break;
+            }
+            NEXUS_WARN("SHM-V3") << "Skipping shared inbox slot " << pos << " abandoned by PID "
+                                 << slot.claimer_pid.load(std::memory_order_relaxed);
+            slot.claimer_pid.store(0, std::memory_order_relaxed);
+            slot.sequence.store(lap + SHARED_INBOX_SLOTS, std::memory_order_release);
+            inbox.dequeue_pos.store(++pos, std::memory_order_release);
+            continue;
+        }
+
+        processed++;
+        const size_t size = std::min<size_t>(slot.size, SHARED_INBOX_FRAME_BYTES);
+        stats_bytes_received_ += size;
+        NEXUS_TRACE3(shm_ring_read, &inbox, size, INBOX_LANE);
+
+        auto callback = receive_callback_;
+        if (callback) {
+            callback(slot.data, size, SharedMemoryRegistry::readAtomicString(slot.sender_id_atomic, 64));
+        }
+
+        // 释放槽位给下一圈的生产者
+        slot.claimer_pid.store(0, std::memory_order_relaxed);
+        slot.sequence.store(lap + SHARED_INBOX_SLOTS, std::memory_order_release);
+        inbox.dequeue_pos.store(++pos, std::memory_order_release);
+    }
+
+    if (processed > 0) {
+        stats_messages_received_ += processed;
+        inbox.pending.fetch_sub(static_cast<uint32_t>(processed), std::memory_order_release);
+    }
+    return processed;
+}
+
+// 已占用未发布的槽位：停留超过SHM_INBOX_CLAIM_CHECK_MS后检查占用者，进程已退出
+// （或占用后始终未写入PID超过SHM_INBOX_CLAIM_TIMEOUT_MS）视为放弃
+bool SharedMemoryTransportV3::inboxClaimAbandoned(const InboxSlot& slot, uint64_t pos) {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+    if (inbox_stalled_pos_ != pos) {
+        inbox_stalled_pos_ = pos;
+        inbox_stalled_since_ms_ = now;
+        return false;
+    }
+    const int64_t stalled_ms = now - inbox_stalled_since_ms_;
+    if (stalled_ms < SHM_INBOX_CLAIM_CHECK_MS) {
+        return false;
+    }
+    int32_t pid = slot.claimer_pid.load(std::memory_order_relaxed);
+    if (pid <= 0) {
+        return stalled_ms >= SHM_INBOX_CLAIM_TIMEOUT_MS;
+    }
+    return kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+// 🔧 数据lane调度：STRICT_PRIORITY下本轮只处理有积压的最高lane（下一轮先回到控制队列）；
+// WEIGHTED_ROUND_ROBIN下每个lane每队列最多处理lane_weights[lane]条
+bool SharedMemoryTransportV3::drainDataLanes(const std::vector<InboundQueue*>& queues) {
+    // 限流：每轮每队列每lane最多处理N条数据消息，避免阻塞下一轮控制消息处理
+    const int MAX_DATA_PER_QUEUE = 16;
+    bool has_messages = false;
+
+    for (uint32_t lane = 0; lane < DATA_LANES; ++lane) {
+        const bool weighted = config_.lane_scheduling == LaneScheduling::WEIGHTED_ROUND_ROBIN;
+        const int budget = weighted ? static_cast<int>(std::max(config_.lane_weights[lane], 1u)) : MAX_DATA_PER_QUEUE;
+
+        bool lane_had_messages = false;
+        for (auto* q : queues) {
+            if (drainDataLane(q, lane, budget) > 0) {
+                lane_had_messages = true;
+            }
+        }
+        has_messages = has_messages || lane_had_messages;
+        if (lane_had_messages && !weighted) {
+            break;
+        }
+    }
+    return has_messages;
+}
+
+// 🔧 SMART_POLLING：在阻塞前自旋检查pending计数，命中即返回，避免调度器唤醒延迟
+bool SharedMemoryTransportV3::spinForMessages(const std::vector<InboundQueue*>& queues, uint32_t known_queues,
+                                              uint64_t shard_mask) const {
+    if (config_.spin_budget_us == 0) {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(config_.spin_budget_us);
+    uint32_t iterations = 0;
+
+    while (receiving_.load(std::memory_order_relaxed)) {
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+        (void)queues;
+        if ((my_shm_->header.ready_queues.load(std::memory_order_acquire) & shard_mask) != 0) {
+            return true;
+        }
+#else
+        for (auto* q : queues) {
+            if (hasPending(q)) {
+                return true;
+            }
+        }
+        if (((shard_mask >> INBOX_SLOT) & 1) && my_shm_->inbox.pending.load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+#endif
+        // 新发送者加入时也立即返回，让主循环刷新队列列表
+        if (my_shm_->header.num_queues.load(std::memory_order_acquire) != known_queues) {
+            return true;
+        }
+
+        cpuRelax();
+
+        // 每64次迭代才读一次时钟，降低自旋开销
+        if ((++iterations & 63) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+    return false;
+}
+
+void SharedMemoryTransportV3::receiveLoop(uint32_t shard) {
+    applyReceivePlacement(shard);
+
     if (notify_mechanism_ == NotifyMechanism::SEMAPHORE) {
-        receiveLoop_Semaphore();
+        receiveLoop_Semaphore(shard);
     } else {
-        receiveLoop_CV();
+        receiveLoop_CV(shard);
     }
 }
 
 // Condition Variable模式的接收循环（优化版）
-void SharedMemoryTransportV3::receiveLoop_CV() {
-    NEXUS_DEBUG("SHM-V3") << "Receive loop started for " << node_id_ << " (Condition Variable mode - optimized)";
+void SharedMemoryTransportV3::receiveLoop_CV(uint32_t shard) {
+    NEXUS_DEBUG("SHM-V3") << "Receive loop " << shard << " started for " << node_id_
+                          << " (Condition Variable mode - optimized)";
 
-    static constexpr size_t MESSAGE_SIZE = 2048;
-    uint8_t buffer[MESSAGE_SIZE];
+    // 🔧 本线程负责的队列槽位（可能包括共享收件箱）
+    const uint64_t shard_mask = shardQueueMask(shard);
+    const uint64_t inbox_bit = uint64_t{1} << INBOX_SLOT;
+    const bool owns_inbox = (shard_mask & inbox_bit) != 0;
 
     // 缓存活跃队列列表，减少遍历开销
     std::vector<InboundQueue*> active_queues;
@@ -1189,6 +2380,14 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
     // 自适应超时：根据消息流量动态调整
     int consecutive_empty_loops = 0;
 
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+    // 🔧 门铃位图：本轮需要扫描的队列（本地保留未处理完的队列位）
+    uint64_t ready_mask = 0;
+    bool full_sweep = true;  // 启动或等待超时后全量检查一次，兜底门铃之前已写入的消息
+    std::vector<InboundQueue*> ready_queues;
+    ready_queues.reserve(MAX_INBOUND_QUEUES);
+#endif
+
     while (receiving_.load()) {
         if (!my_shm_) {
             // 🔧 Wait for shared memory - use longer sleep since this is rare
@@ -1217,7 +2416,7 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
                 active_queues.clear();
                 active_queues.reserve(current_num_queues);  // ✅ 预留空间避免realloc
 
-                for (uint32_t i = 0; i < MAX_INBOUND_QUEUES; ++i) {
+                for (uint32_t i = shard; i < config_.max_inbound_queues; i += config_.receive_threads) {
                     InboundQueue& q = my_shm_->queues[i];
                     // 🔧 Use acquire to see all queue fields initialized by sender
                     uint32_t flags = q.flags.load(std::memory_order_acquire);
@@ -1237,25 +2436,58 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
             queue_refresh_counter = 0;
         }
 
-        if (active_queues.empty()) {
+        if (active_queues.empty() && !owns_inbox) {
             // 🔧 No queues available - use condition variable to wait efficiently
             // This avoids busy-wait and reduces CPU to 0% when idle
             has_active_queues_.store(false, std::memory_order_release);
 
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+            // 🔧 发送方创建队列后会敲门铃：在门铃上等待，第一个队列出现时立即醒来（而非等满空闲超时）
+            NodeHeader& header = my_shm_->header;
+            uint32_t seq = header.doorbell.load(std::memory_order_acquire);
+            header.doorbell_waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (header.num_queues.load(std::memory_order_seq_cst) == cached_num_queues && receiving_.load()) {
+                const bool signalled =
+                    futexWait(&header.doorbell, seq, SHM_TIMEOUT_IDLE_MS, FUTEX_BITSET_MATCH_ANY);
+                NEXUS_TRACE2(shm_wakeup, shard, signalled);
+            }
+            header.doorbell_waiters.fetch_sub(1, std::memory_order_seq_cst);
+#else
             std::unique_lock<std::mutex> lock(queue_wait_mutex_);
             queue_wait_cv_.wait_for(lock, std::chrono::milliseconds(SHM_TIMEOUT_IDLE_MS),
-                                    [this]() { return !receiving_.load() || has_active_queues_.load(); });
+                                    [this]() { return !receiving_.load(); });
+#endif
             continue;
         }
 
         // Mark that we have active queues
         has_active_queues_.store(true, std::memory_order_relaxed);
 
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+        // 🔧 只扫描门铃置位的队列，取代每次唤醒O(queues)的全量扫描
+        ready_mask |= my_shm_->header.ready_queues.fetch_and(~shard_mask, std::memory_order_acq_rel) & shard_mask;
+        if (full_sweep || need_refresh) {
+            for (auto* q : active_queues) {
+                if (hasPending(q)) {
+                    ready_mask |= uint64_t{1} << static_cast<uint32_t>(q - my_shm_->queues);
+                }
+            }
+            full_sweep = false;
+        }
+        ready_queues.clear();
+        for (uint64_t bits = ready_mask & ~inbox_bit; bits != 0; bits &= bits - 1) {
+            ready_queues.push_back(&my_shm_->queues[__builtin_ctzll(bits)]);
+        }
+        const std::vector<InboundQueue*>& scan_queues = ready_queues;
+#else
+        const std::vector<InboundQueue*>& scan_queues = active_queues;
+#endif
+
         // 🔧 双队列架构：优先处理控制队列，确保服务发现不受数据流量影响
         bool has_messages = false;
 
         // === 第一遍：优先处理所有队列的控制消息 ===
-        for (auto* q : active_queues) {
+        for (auto* q : scan_queues) {
             uint32_t control_pending = q->control_pending.load(std::memory_order_acquire);
             if (control_pending == 0) {
                 continue;
@@ -1273,12 +2505,14 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
             std::string from_node = SharedMemoryRegistry::readAtomicString(q->sender_id_atomic, 64);
 
             while (true) {
-                size_t msg_size = MESSAGE_SIZE;
-
-                // 🔧 直接使用control_queue（LockFreeRingBuffer<64>）
-                if (!q->control_queue.tryRead(buffer, msg_size)) {
+                // 🔧 零拷贝：回调直接读取环形缓冲区中的消息，返回后才释放空间
+                ControlRing::ReadView view;
+                if (!q->control_queue.tryPeek(view)) {
                     break;
                 }
+                const uint8_t* buffer = view.data;
+                size_t msg_size = view.size;
+                NEXUS_TRACE3(shm_ring_read, q, msg_size, CONTROL_LANE);
 
                 processed++;
                 has_messages = true;
@@ -1286,12 +2520,13 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
                 // 🔧 检查 callback 是否有效（可能在析构时被清空）
                 auto callback = receive_callback_;
                 if (callback) {
-                    NEXUS_INFO("SHM-V3")
+                    NEXUS_DEBUG("SHM-V3")
                         << "[CTRL] Received control message from " << from_node << " (" << msg_size << " bytes)";
                     callback(buffer, msg_size, from_node);
                 } else {
                     NEXUS_WARN("SHM-V3") << "Callback is null!";
                 }
+                q->control_queue.consume(view);
             }
 
             if (processed > 0) {
@@ -1300,54 +2535,38 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
             }
         }
 
-        // === 第二遍：处理数据队列（限流） ===
-        for (auto* q : active_queues) {
-            uint32_t data_pending = q->data_pending.load(std::memory_order_acquire);
-            if (data_pending == 0) {
-                continue;
-            }
-
-            // 🔧 Use acquire to ensure we see all queue fields
-            uint32_t flags = q->flags.load(std::memory_order_acquire);
-            if ((flags & 0x3) != 0x3) {
-                continue;
-            }
-
-            // 限流：每轮每队列最多处理N条数据消息，避免阻塞下一轮控制消息处理
-            int processed = 0;
-            const int MAX_DATA_PER_QUEUE = 16;
-            // 🔧 Read sender ID once from queue metadata
-            std::string from_node = SharedMemoryRegistry::readAtomicString(q->sender_id_atomic, 64);
-
-            while (processed < MAX_DATA_PER_QUEUE) {
-                size_t msg_size = MESSAGE_SIZE;
-
-                if (!q->data_queue.tryRead(buffer, msg_size)) {
-                    break;
-                }
+        // === 共享收件箱：控制与数据帧混合，按到达顺序投递（限流） ===
+        if (owns_inbox && drainInbox(SHM_INBOX_FRAMES_PER_ROUND) > 0) {
+            has_messages = true;
+        }
 
-                processed++;
-                has_messages = true;
+        // === 第二遍：按优先级处理数据lane（限流） ===
+        if (drainDataLanes(scan_queues)) {
+            has_messages = true;
+        }
 
-                // 🔧 检查 callback 是否有效（可能在析构时被清空）
-                auto callback = receive_callback_;
-                if (callback) {
-                    callback(buffer, msg_size, from_node);
-                }
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+        // 🔧 限流后仍有积压的队列保留在本地位图中；pending已清零的队列由发送方下次0->1时重新置位
+        ready_mask = 0;
+        for (auto* q : ready_queues) {
+            if ((q->flags.load(std::memory_order_acquire) & 0x3) == 0x3 && hasPending(q)) {
+                ready_mask |= uint64_t{1} << static_cast<uint32_t>(q - my_shm_->queues);
             }
+        }
+#endif
 
-            if (processed > 0) {
-                stats_messages_received_ += processed;
-                q->data_pending.fetch_sub(processed, std::memory_order_release);
-            }
+        // 🔧 步骤2：如果没有消息，SMART_POLLING先自旋，仍无消息再使用condition variable等待
+        if (!has_messages && notify_mechanism_ == NotifyMechanism::SMART_POLLING &&
+            spinForMessages(active_queues, cached_num_queues, shard_mask)) {
+            consecutive_empty_loops = 0;
+            continue;
         }
 
-        // 🔧 步骤2：如果没有消息，使用condition variable等待
-        if (!has_messages && !active_queues.empty()) {
+        if (!has_messages && (!active_queues.empty() || owns_inbox)) {
             consecutive_empty_loops++;
 
-            // 🔧 全局CV方案：所有队列共享my_shm_->header.global_cond
-            // 任何队列收到消息都会signal这个统一的cond_var
+            // 🔧 Linux：等待NodeHeader门铃（futex），发送方只置位自己队列的ready_queues位
+            // 其他平台：所有队列共享my_shm_->header.global_cond
 
             int timeout_ms;
             if (consecutive_empty_loops > SHM_EMPTY_LOOP_THRESHOLD_LONG) {
@@ -1358,6 +2577,20 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
                 timeout_ms = 10;  // 刚开始空闲：10ms
             }
 
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+            // 🔧 等待门铃：先登记等待者再重查ready_queues，与发送方ringDoorbell配对避免丢失唤醒
+            NodeHeader& header = my_shm_->header;
+            uint32_t seq = header.doorbell.load(std::memory_order_acquire);
+            header.doorbell_waiters.fetch_add(1, std::memory_order_seq_cst);
+            if ((header.ready_queues.load(std::memory_order_seq_cst) & shard_mask) == 0 && receiving_.load()) {
+                const bool signalled = futexWait(&header.doorbell, seq, timeout_ms, 1u << shard);
+                NEXUS_TRACE2(shm_wakeup, shard, signalled);
+                if (!signalled) {
+                    full_sweep = true;
+                }
+            }
+            header.doorbell_waiters.fetch_sub(1, std::memory_order_seq_cst);
+#else
             // 等待全局cond_var
             pthread_mutex_lock(&my_shm_->header.global_mutex);
 
@@ -1373,8 +2606,11 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
             }
 
             // 等待统一的global_cond，任何消息（control或data）都会唤醒
-            pthread_cond_timedwait(&my_shm_->header.global_cond, &my_shm_->header.global_mutex, &ts);
+            const int wait_result =
+                pthread_cond_timedwait(&my_shm_->header.global_cond, &my_shm_->header.global_mutex, &ts);
             pthread_mutex_unlock(&my_shm_->header.global_mutex);
+            NEXUS_TRACE2(shm_wakeup, shard, wait_result == 0);
+#endif
 
         } else {
             // 🔧 有消息时重置计数器，保持短超时以降低延迟
@@ -1382,15 +2618,15 @@ void SharedMemoryTransportV3::receiveLoop_CV() {
         }
     }
 
-    NEXUS_DEBUG("SHM-V3") << "Receive loop stopped for " << node_id_ << " (CV mode)";
+    NEXUS_DEBUG("SHM-V3") << "Receive loop " << shard << " stopped for " << node_id_ << " (CV mode)";
 }
 
 // 🔧 Semaphore模式的接收循环（优化版：真正利用sem_timedwait阻塞等待）
-void SharedMemoryTransportV3::receiveLoop_Semaphore() {
-    NEXUS_DEBUG("SHM-V3") << "Receive loop started for " << node_id_ << " (Semaphore mode - optimized)";
+void SharedMemoryTransportV3::receiveLoop_Semaphore(uint32_t shard) {
+    NEXUS_DEBUG("SHM-V3") << "Receive loop " << shard << " started for " << node_id_ << " (Semaphore mode - optimized)";
 
-    static constexpr size_t MESSAGE_SIZE = 2048;
-    uint8_t buffer[MESSAGE_SIZE];
+    // 🔧 共享收件箱的发送方也post分片信号量：由负责INBOX_SLOT的线程处理
+    const bool owns_inbox = (shardQueueMask(shard) >> INBOX_SLOT) & 1;
 
     // 🔧 缓存活跃队列列表，定期更新以降低开销
     std::vector<InboundQueue*> active_queues;
@@ -1416,7 +2652,8 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
         if (current_num_queues != cached_num_queues || queue_refresh_counter >= QUEUE_REFRESH_INTERVAL ||
             active_queues.empty()) {
             active_queues.clear();
-            for (uint32_t i = 0; i < MAX_INBOUND_QUEUES; ++i) {
+            // 🔧 只收集本分片负责的队列（槽位 i % receive_threads == shard）
+            for (uint32_t i = shard; i < config_.max_inbound_queues; i += config_.receive_threads) {
                 InboundQueue& q = my_shm_->queues[i];
                 // 🔧 Use acquire to see complete queue initialization
                 uint32_t flags = q.flags.load(std::memory_order_acquire);
@@ -1429,7 +2666,11 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
         }
 
         if (active_queues.empty()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(SHM_IDLE_SLEEP_MS));
+            if (!owns_inbox) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(SHM_IDLE_SLEEP_MS));
+            } else if (drainInbox(SHM_INBOX_FRAMES_PER_ROUND) == 0) {
+                waitShardSemaphore(shard, SHM_TIMEOUT_LONG_MS);
+            }
             continue;
         }
 
@@ -1452,12 +2693,14 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
             std::string from_node = SharedMemoryRegistry::readAtomicString(q->sender_id_atomic, 64);
 
             while (true) {
-                size_t msg_size = MESSAGE_SIZE;
-
-                // 🔧 直接使用control_queue（LockFreeRingBuffer<64>）
-                if (!q->control_queue.tryRead(buffer, msg_size)) {
+                // 🔧 零拷贝：回调直接读取环形缓冲区中的消息，返回后才释放空间
+                ControlRing::ReadView view;
+                if (!q->control_queue.tryPeek(view)) {
                     break;
                 }
+                const uint8_t* buffer = view.data;
+                size_t msg_size = view.size;
+                NEXUS_TRACE3(shm_ring_read, q, msg_size, CONTROL_LANE);
 
                 stats_messages_received_++;
                 stats_bytes_received_ += msg_size;
@@ -1470,6 +2713,7 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
                     NEXUS_DEBUG("SHM-V3") << "[CTRL] Received control message from " << from_node;
                     callback(buffer, msg_size, from_node);
                 }
+                q->control_queue.consume(view);
             }
 
             if (processed > 0) {
@@ -1477,41 +2721,13 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
             }
         }
 
-        // === 第二遍：处理数据队列（限流） ===
-        for (auto* q : active_queues) {
-            // 🔧 Use acquire to ensure we see all queue fields
-            uint32_t flags = q->flags.load(std::memory_order_acquire);
-            if ((flags & 0x3) != 0x3) {
-                continue;
-            }
-
-            int processed = 0;
-            const int MAX_DATA_PER_QUEUE = 16;
-            // 🔧 Read sender ID once from queue metadata
-            std::string from_node = SharedMemoryRegistry::readAtomicString(q->sender_id_atomic, 64);
-
-            while (processed < MAX_DATA_PER_QUEUE) {
-                size_t msg_size = MESSAGE_SIZE;
-
-                if (!q->data_queue.tryRead(buffer, msg_size)) {
-                    break;
-                }
-
-                stats_messages_received_++;
-                stats_bytes_received_ += msg_size;
-                has_messages = true;
-                processed++;
-
-                // 🔧 检查 callback 是否有效（可能在析构时被清空）
-                auto callback = receive_callback_;
-                if (callback) {
-                    callback(buffer, msg_size, from_node);
-                }
-            }
+        if (owns_inbox && drainInbox(SHM_INBOX_FRAMES_PER_ROUND) > 0) {
+            has_messages = true;
+        }
 
-            if (processed > 0) {
-                q->data_pending.fetch_sub(processed, std::memory_order_release);
-            }
+        // === 第二遍：按优先级处理数据lane（限流） ===
+        if (drainDataLanes(active_queues)) {
+            has_messages = true;
         }
 
         // 🔧 步骤2：如果没有消息，使用sem_timedwait阻塞等待
@@ -1521,156 +2737,131 @@ void SharedMemoryTransportV3::receiveLoop_Semaphore() {
             int timeout_ms =
                 (consecutive_empty_loops > ADAPTIVE_THRESHOLD) ? SHM_TIMEOUT_LONG_MS : SHM_TIMEOUT_SHORT_MS;
 
-            struct timespec timeout;
-            clock_gettime(CLOCK_REALTIME, &timeout);
-            long timeout_ns = timeout_ms * 1000000L;
-            timeout.tv_nsec += timeout_ns;
-            if (timeout.tv_nsec >= 1000000000) {
-                timeout.tv_sec++;
-                timeout.tv_nsec -= 1000000000;
-            }
-
-            // 🔧 优先等待控制信号量
-            bool got_signal = false;
-            for (auto* q : active_queues) {
-                if (sem_trywait(&q->control_sem) == 0) {
-                    got_signal = true;
-                    break;
-                }
-            }
-
-            // 如果没有控制信号，尝试数据信号量
-            if (!got_signal) {
-                for (auto* q : active_queues) {
-                    if (sem_trywait(&q->data_sem) == 0) {
-                        got_signal = true;
-                        break;
-                    }
-                }
-            }
-
-            // 如果都没有立即可用的信号，等待第一个队列的控制信号量
-            if (!got_signal) {
-                sem_timedwait(&active_queues[0]->control_sem, &timeout);
-            }
+            // 🔧 本分片所有队列（及收件箱）的发送方都post同一个信号量：任一队列的新消息都能唤醒
+            bool woken = waitShardSemaphore(shard, timeout_ms);
+            NEXUS_TRACE2(shm_wakeup, shard, woken);
         } else {
             // 有消息时重置空循环计数
             consecutive_empty_loops = 0;
         }
     }
 
-    NEXUS_DEBUG("SHM-V3") << "Receive loop stopped for " << node_id_ << " (Semaphore mode)";
+    NEXUS_DEBUG("SHM-V3") << "Receive loop " << shard << " stopped for " << node_id_ << " (Semaphore mode)";
 }
 
-void SharedMemoryTransportV3::heartbeatLoop() {
-    NEXUS_DEBUG("SHM-V3") << "Heartbeat loop started for " << node_id_;
+// Block on the shard's semaphore for up to timeout_ms; true if a sender posted it
+bool SharedMemoryTransportV3::waitShardSemaphore(uint32_t shard, int timeout_ms) {
+    struct timespec timeout;
+    clock_gettime(CLOCK_REALTIME, &timeout);
+    timeout.tv_nsec += timeout_ms * 1000000L;
+    if (timeout.tv_nsec >= 1000000000) {
+        timeout.tv_sec += timeout.tv_nsec / 1000000000;
+        timeout.tv_nsec %= 1000000000;
+    }
+    return sem_timedwait(&my_shm_->header.shard_sems[shard], &timeout) == 0;
+}
 
-    int heartbeat_count = 0;
-    while (receiving_.load()) {
-        // Update my heartbeat in registry
-        bool updated = registry_.updateHeartbeat(node_id_);
-        heartbeat_count++;
+void SharedMemoryTransportV3::heartbeatTick() {
+    // Update my heartbeat in registry
+    bool updated = registry_.updateHeartbeat(node_id_);
+    heartbeat_count_++;
 
-        // 🔧 每10次心跳打印一次日志，确保heartbeat loop没有卡住
-        if (heartbeat_count % 10 == 0) {
-            NEXUS_DEBUG("SHM-V3") << "Heartbeat #" << heartbeat_count << " for " << node_id_ << " (updated: " << updated
-                                  << ")";
-        }
+    // 🔧 每10次心跳打印一次日志，确保心跳任务没有卡住
+    if (heartbeat_count_ % 10 == 0) {
+        NEXUS_DEBUG("SHM-V3") << "Heartbeat #" << heartbeat_count_ << " for " << node_id_ << " (updated: " << updated
+                              << ")";
+    }
 
-        // Update my heartbeat in my shared memory
-        if (my_shm_) {
-            // 🔧 Use system_clock for cross-process timestamp consistency
-            auto now = std::chrono::system_clock::now();
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
-            // 🔧 使用release语义更新heartbeat，确保对其他进程可见
-            my_shm_->header.last_heartbeat.store(ms.count(), std::memory_order_release);
+    // Update my heartbeat in my shared memory
+    if (my_shm_) {
+        // 🔧 Use system_clock for cross-process timestamp consistency
+        auto now = std::chrono::system_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+        // 🔧 使用release语义更新heartbeat，确保对其他进程可见
+        my_shm_->header.last_heartbeat.store(ms.count(), std::memory_order_release);
+    }
+
+    // 🔧 CRITICAL: Periodically discover new nodes from registry
+    // This ensures 100% reliability even when nodes start simultaneously
+    // Solves race condition: node2 and node3 both register at ~same time
+    // 注册表每轮只扫描一次：同一份快照也用于下面的超时节点检测
+    const auto all_nodes = registryNodes();
+    connectToNewNodes(*all_nodes);
+
+    // Clean up stale nodes from registry
+    int cleaned = registry_.cleanupStaleNodes(NODE_TIMEOUT_MS);
+
+    // Notify NodeImpl about removed nodes (trigger NODE_LEFT events)
+    if (cleaned > 0 && node_impl_) {
+        std::set<std::string> nodes_after;
+        for (const auto& node : *registryNodes()) {
+            nodes_after.insert(node.node_id);
         }
 
-        // 🔧 CRITICAL: Periodically discover new nodes from registry
-        // This ensures 100% reliability even when nodes start simultaneously
-        // Solves race condition: node2 and node3 both register at ~same time
-        {
-            auto all_nodes = registry_.getAllNodes();
-            std::vector<std::string> new_nodes;
-
-            // Find new nodes (check outside of lock to avoid deadlock)
-            {
-                std::lock_guard<std::mutex> lock(connections_mutex_);
-                for (const auto& node : all_nodes) {
-                    // Skip self
-                    if (node.node_id == node_id_) {
-                        continue;
-                    }
-
-                    // Skip if already connected
-                    auto it = remote_connections_.find(node.node_id);
-                    if (it != remote_connections_.end() && it->second.connected) {
-                        continue;
-                    }
-
-                    // New node detected
-                    new_nodes.push_back(node.node_id);
-                }
+        // Find which nodes were removed (all_nodes is the snapshot taken before cleanup)
+        for (const auto& node : *all_nodes) {
+            // Skip self
+            if (node.node_id == node_id_) {
+                continue;
             }
 
-            // Connect to new nodes (outside of lock)
-            for (const auto& new_node_id : new_nodes) {
-                NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Discovered new node in registry: " << new_node_id
-                                      << " - establishing connection";
-
-                bool connected = connectToNode(new_node_id);
-
-                if (connected) {
-                    NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Successfully connected to new node: " << new_node_id;
-                }
+            // Node was removed - trigger NODE_LEFT event
+            if (nodes_after.count(node.node_id) == 0) {
+                NEXUS_DEBUG("SHM-V3") << "Heartbeat timeout detected for node: " << node.node_id
+                                      << ", triggering NODE_LEFT event";
+                node_impl_->handleNodeEvent(node.node_id, false);
             }
         }
+    }
 
-        // Get nodes before cleanup (for detecting removed nodes)
-        std::vector<NodeInfo> nodes_before;
-        if (node_impl_) {
-            nodes_before = registry_.getAllNodes();
-        }
-
-        // Clean up stale nodes from registry
-        int cleaned = registry_.cleanupStaleNodes(NODE_TIMEOUT_MS);
+    // Clean up stale inbound queues
+    cleanupStaleQueues();
 
-        // Notify NodeImpl about removed nodes (trigger NODE_LEFT events)
-        if (cleaned > 0 && node_impl_) {
-            auto nodes_after = registry_.getAllNodes();
+    // Free retired connection snapshots (and unmap removed peers) once no sender holds them
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        reclaimRetiredSnapshots();
+    }
+}
 
-            // Find which nodes were removed
-            for (const auto& node : nodes_before) {
-                // Skip self
-                if (node.node_id == node_id_) {
-                    continue;
-                }
+void SharedMemoryTransportV3::connectToNewNodes(const std::vector<NodeInfo>& nodes) {
+    std::vector<std::string> new_nodes;
 
-                // Check if node still exists
-                bool found = false;
-                for (const auto& n : nodes_after) {
-                    if (n.node_id == node.node_id) {
-                        found = true;
-                        break;
-                    }
-                }
+    // Find new nodes (check outside of lock to avoid deadlock)
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (const auto& node : nodes) {
+            // Skip self
+            if (node.node_id == node_id_) {
+                continue;
+            }
 
-                // Node was removed - trigger NODE_LEFT event
-                if (!found) {
-                    NEXUS_DEBUG("SHM-V3")
-                        << "Heartbeat timeout detected for node: " << node.node_id << ", triggering NODE_LEFT event";
-                    node_impl_->handleNodeEvent(node.node_id, false);
-                }
+            // Skip if already connected
+            auto it = remote_connections_.find(node.node_id);
+            if (it != remote_connections_.end() && it->second.connected) {
+                continue;
             }
-        }
 
-        // Clean up stale inbound queues
-        cleanupStaleQueues();
+            // New node detected
+            new_nodes.push_back(node.node_id);
+        }
+    }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_INTERVAL_MS));
+    // Connect to new nodes on the connector thread (heartbeats are not held up by a slow peer)
+    for (const auto& new_node_id : new_nodes) {
+        NEXUS_DEBUG("SHM-V3") << "[" << node_id_ << "] Discovered new node in registry: " << new_node_id
+                              << " - establishing connection";
+        connectAsync(new_node_id);
     }
+}
 
-    NEXUS_DEBUG("SHM-V3") << "Heartbeat loop stopped for " << node_id_;
+std::shared_ptr<const std::vector<NodeInfo>> SharedMemoryTransportV3::registryNodes() const {
+    std::lock_guard<std::mutex> lock(registry_nodes_mutex_);
+    std::vector<NodeInfo> nodes;
+    if (registry_.getAllNodesIfChanged(registry_nodes_generation_, nodes) || !registry_nodes_) {
+        registry_nodes_ = std::make_shared<const std::vector<NodeInfo>>(std::move(nodes));
+    }
+    return registry_nodes_;
 }
 
 void SharedMemoryTransportV3::cleanupStaleQueues() {
@@ -1754,6 +2945,9 @@ void SharedMemoryTransportV3::removeAccessorFromNode(NodeHeader* header, pid_t p
         if (header->accessor_pids[i].compare_exchange_strong(expected, 0, std::memory_order_release,
                                                              std::memory_order_relaxed)) {
             header->num_accessors.fetch_sub(1, std::memory_order_release);
+#ifdef NEXUS_SHM_FUTEX_DOORBELL
+            futexWake(&header->num_accessors, FUTEX_BITSET_MATCH_ANY);  // 节点析构在等待访问者断开
+#endif
             NEXUS_DEBUG("SHM-V3") << "Removed accessor PID " << pid
                                   << " from node (count=" << header->num_accessors.load() << ")";
             return;
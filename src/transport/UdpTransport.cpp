@@ -2,43 +2,410 @@
 
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <linux/filter.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
+#include <memory>
 
+#include "nexus/core/Message.h"
 #include "nexus/utils/Logger.h"
+#include "nexus/utils/Lz4.h"
+#include "nexus/utils/Tracepoints.h"
+
+// Linux: io_uring receive backend (raw syscalls; headers from kernels with multishot RECVMSG)
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_RECV_MULTISHOT)
+#define NEXUS_UDP_IO_URING 1
+#endif
+#endif
+#endif
 
 namespace Nexus {
 namespace rpc {
 
-UdpTransport::UdpTransport() : socket_fd_(-1), port_(0), initialized_(false), running_(false) {}
+#ifdef NEXUS_UDP_IO_URING
+class UdpTransport::IoUringReceiver {
+public:
+    static constexpr uint64_t RECEIVE_TAG = 1;          // user_data of the multishot RECVMSG
+    static constexpr uint64_t WAKE_TAG = 2;             // user_data of the POLL_ADD on the wakeup eventfd
+    static constexpr uint32_t BUFFERS = 32;             // Provided buffers (power of two)
+    static constexpr size_t BUFFER_SIZE = 65536 + 256;  // io_uring_recvmsg_out, address and control ahead of 64 KiB
+    static constexpr uint16_t BUFFER_GROUP = 0;
+
+    IoUringReceiver() = default;
+    ~IoUringReceiver();
+
+    IoUringReceiver(const IoUringReceiver&) = delete;
+    IoUringReceiver& operator=(const IoUringReceiver&) = delete;
+
+    // Set up the ring and its buffers and queue the receive and the wakeup poll; false without kernel support
+    bool open(int fd, int wake_fd, bool gro);
+
+    // Queue the multishot receive again (it ends on CQ overflow or when no buffer was free)
+    bool armReceive();
+
+    // Submit what is queued and wait for at least one completion
+    bool submitAndWait();
+
+    // Pass every available completion to @p handler, then release them to the kernel
+    template <typename Handler>
+    void forEachCompletion(Handler&& handler) {
+        uint32_t head = *cq_head_;
+        const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            handler(cqes_[head & *cq_mask_]);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    const uint8_t* buffer(uint16_t bid) const { return buffers_ + static_cast<size_t>(bid) * BUFFER_SIZE; }
+
+    // Give buffer @p bid back to the kernel for the next datagrams
+    void recycle(uint16_t bid);
+
+    // Template the kernel lays out every received buffer by (name and control space)
+    const struct msghdr& layout() const { return msg_; }
+
+private:
+    bool push(const struct io_uring_sqe& entry);
+
+    int ring_fd_ = -1;
+    int socket_fd_ = -1;
+    int wake_fd_ = -1;
+    void* sq_ring_ = MAP_FAILED;
+    size_t sq_ring_size_ = 0;
+    void* cq_ring_ = MAP_FAILED;  // Same mapping as sq_ring_ with IORING_FEAT_SINGLE_MMAP
+    size_t cq_ring_size_ = 0;
+    void* sqes_ = MAP_FAILED;
+    size_t sqes_size_ = 0;
+    uint32_t* sq_head_ = nullptr;
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t* sq_mask_ = nullptr;
+    uint32_t* sq_array_ = nullptr;
+    uint32_t sq_entries_ = 0;
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t* cq_mask_ = nullptr;
+    struct io_uring_cqe* cqes_ = nullptr;
+    uint32_t queued_ = 0;  // Entries pushed but not submitted yet
+
+    void* buf_ring_ = MAP_FAILED;  // Provided buffer ring: io_uring_buf entries
+    uint8_t* buffers_ = nullptr;
+    struct msghdr msg_;
+};
+
+constexpr uint64_t UdpTransport::IoUringReceiver::RECEIVE_TAG;
+constexpr uint64_t UdpTransport::IoUringReceiver::WAKE_TAG;
+constexpr uint32_t UdpTransport::IoUringReceiver::BUFFERS;
+constexpr size_t UdpTransport::IoUringReceiver::BUFFER_SIZE;
+constexpr uint16_t UdpTransport::IoUringReceiver::BUFFER_GROUP;
+
+UdpTransport::IoUringReceiver::~IoUringReceiver() {
+    // Closing the ring cancels the pending requests and unregisters the buffer ring
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+    }
+    if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+        munmap(sq_ring_, sq_ring_size_);
+    }
+    if (buf_ring_ != MAP_FAILED) {
+        munmap(buf_ring_, BUFFERS * sizeof(struct io_uring_buf));
+    }
+    if (buffers_) {
+        munmap(buffers_, BUFFERS * BUFFER_SIZE);
+    }
+}
+
+bool UdpTransport::IoUringReceiver::open(int fd, int wake_fd, bool gro) {
+    // Completion queue deep enough for one completion per buffer plus the wakeup
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = BUFFERS * 2;
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, 4, &params));
+    if (ring_fd_ < 0) {
+        return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+        return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t* sq = static_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    uint8_t* cq = static_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Provided buffer ring (page aligned); the payload buffers only become resident once datagrams land there
+    buf_ring_ = mmap(nullptr, BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring_ == MAP_FAILED) {
+        return false;
+    }
+    void* buffers = mmap(nullptr, BUFFERS * BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        return false;
+    }
+    buffers_ = static_cast<uint8_t*>(buffers);
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = BUFFERS;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return false;
+    }
+    for (uint32_t bid = 0; bid < BUFFERS; ++bid) {
+        recycle(static_cast<uint16_t>(bid));
+    }
+
+    // Every buffer starts with io_uring_recvmsg_out, then the sender's address, then the GRO control message
+    std::memset(&msg_, 0, sizeof(msg_));
+    msg_.msg_namelen = sizeof(struct sockaddr_in);
+    msg_.msg_controllen = gro ? sizeof(SegmentControl) : 0;
+    socket_fd_ = fd;
+    wake_fd_ = wake_fd;
+
+    struct io_uring_sqe wake;
+    std::memset(&wake, 0, sizeof(wake));
+    wake.opcode = IORING_OP_POLL_ADD;
+    wake.fd = wake_fd_;
+    wake.poll32_events = POLLIN;
+    wake.user_data = WAKE_TAG;
+    return push(wake) && armReceive();
+}
+
+bool UdpTransport::IoUringReceiver::armReceive() {
+    struct io_uring_sqe receive;
+    std::memset(&receive, 0, sizeof(receive));
+    receive.opcode = IORING_OP_RECVMSG;
+    receive.fd = socket_fd_;
+    receive.addr = reinterpret_cast<uint64_t>(&msg_);
+    receive.len = 1;
+    receive.ioprio = IORING_RECV_MULTISHOT;
+    receive.flags = IOSQE_BUFFER_SELECT;
+    receive.buf_group = BUFFER_GROUP;
+    receive.user_data = RECEIVE_TAG;
+    return push(receive);
+}
+
+bool UdpTransport::IoUringReceiver::push(const struct io_uring_sqe& entry) {
+    const uint32_t tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        return false;
+    }
+    const uint32_t index = tail & *sq_mask_;
+    static_cast<struct io_uring_sqe*>(sqes_)[index] = entry;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++queued_;
+    return true;
+}
+
+bool UdpTransport::IoUringReceiver::submitAndWait() {
+    for (;;) {
+        const long submitted =
+            syscall(__NR_io_uring_enter, ring_fd_, queued_, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (submitted >= 0) {
+            queued_ -= static_cast<uint32_t>(submitted);
+            return true;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+void UdpTransport::IoUringReceiver::recycle(uint16_t bid) {
+    // Plain io_uring_buf entries (io_uring_buf_ring's flexible array is padded differently in C++);
+    // the ring tail overlays bufs[0].resv, so entries are filled field by field
+    struct io_uring_buf* bufs = static_cast<struct io_uring_buf*>(buf_ring_);
+    uint16_t* ring_tail = &bufs[0].resv;
+    const uint16_t tail = *ring_tail;
+    struct io_uring_buf& entry = bufs[tail & (BUFFERS - 1)];
+    entry.addr = reinterpret_cast<uint64_t>(buffer(bid));
+    entry.len = static_cast<uint32_t>(BUFFER_SIZE);
+    entry.bid = bid;
+    __atomic_store_n(ring_tail, static_cast<uint16_t>(tail + 1), __ATOMIC_RELEASE);
+}
+#else
+// No io_uring on this platform: every socket uses the recvmmsg()/poll() loop
+class UdpTransport::IoUringReceiver {};
+#endif
+
+constexpr size_t UdpTransport::SEND_BATCH;
+constexpr size_t UdpTransport::RECV_BATCH;
+constexpr size_t UdpTransport::MAX_RECEIVE_THREADS;
+constexpr size_t UdpTransport::MAX_GSO_SEGMENTS;
+constexpr size_t UdpTransport::MAX_GSO_BYTES;
+
+UdpTransport::UdpTransport()
+    : socket_fd_(-1),
+      wake_fd_(-1),
+      port_(0),
+      initialized_(false),
+      running_(false),
+      compression_threshold_(0),
+      offload_requested_(true),
+      gso_enabled_(false),
+      gso_max_segment_(MAX_GSO_BYTES),
+      gro_enabled_(false),
+      io_uring_requested_(false),
+      receive_thread_count_(1) {}
 
 UdpTransport::~UdpTransport() {
     shutdown();
 }
 
-bool UdpTransport::initialize(uint16_t port) {
+bool UdpTransport::initialize(uint16_t port, bool shared_port) {
     if (initialized_) {
         return true;
     }
 
-    // Create UDP socket
-    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    // Several receive sockets share the port through SO_REUSEPORT, which would also let them join another
+    // transport's sockets: take the port with a plain bind first, so ports stay one per transport
+    const size_t sockets = shared_port ? 1 : receive_thread_count_;
+    if (sockets > 1) {
+        port = reservePort(port);
+        if (port == 0) {
+            return false;
+        }
+    }
+
+    socket_fd_ = openSocket(port, shared_port, sockets > 1);
     if (socket_fd_ < 0) {
         return false;
     }
 
-    // Enable broadcast
-    int broadcast_enable = 1;
-    if (setsockopt(socket_fd_, SOL_SOCKET, SO_BROADCAST, &broadcast_enable, sizeof(broadcast_enable)) < 0) {
+    // Get actual port (if auto-selected)
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(socket_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    } else {
+        port_ = port;
+    }
+
+    // The other receive sockets join the port (the kernel hashes flows across the group)
+    for (size_t i = 1; i < sockets; ++i) {
+        const int fd = openSocket(port_, false, true);
+        if (fd < 0) {
+            for (int extra : extra_fds_) {
+                close(extra);
+            }
+            extra_fds_.clear();
+            close(socket_fd_);
+            socket_fd_ = -1;
+            return false;
+        }
+        extra_fds_.push_back(fd);
+    }
+    if (sockets > 1 && !receive_cpu_sets_.empty() && !steerByCpu()) {
+        NEXUS_WARN("Udp") << "CPU steering unavailable on port " << port_ << ": " << strerror(errno)
+                          << " (datagrams are spread by flow hash)";
+    }
+
+    // Wakeup fd for shutdown()
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        for (int extra : extra_fds_) {
+            close(extra);
+        }
+        extra_fds_.clear();
         close(socket_fd_);
         socket_fd_ = -1;
         return false;
     }
 
+    // io_uring rings, set up before the threads start so usesIoUring() holds once initialize() returns
+    std::vector<int> fds(1, socket_fd_);
+    fds.insert(fds.end(), extra_fds_.begin(), extra_fds_.end());
+    io_uring_receivers_.resize(fds.size());
+#ifdef NEXUS_UDP_IO_URING
+    if (io_uring_requested_) {
+        for (size_t i = 0; i < fds.size(); ++i) {
+            std::unique_ptr<IoUringReceiver> ring(new IoUringReceiver());
+            if (!ring->open(fds[i], wake_fd_, gro_enabled_)) {
+                NEXUS_WARN("Udp") << "io_uring receive unavailable on port " << port_ << ": " << strerror(errno)
+                                  << " (using the socket loop)";
+                break;
+            }
+            io_uring_receivers_[i] = std::move(ring);
+            io_uring_sockets_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    // Start receive threads
+    initialized_ = true;
+    running_ = true;
+    for (size_t i = 0; i < fds.size(); ++i) {
+        receive_threads_.emplace_back(&UdpTransport::receiveThread, this, fds[i], i, io_uring_receivers_[i].get());
+    }
+
+    return true;
+}
+
+int UdpTransport::openSocket(uint16_t port, bool shared_port, bool reuse_port) {
+    // Create UDP socket
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // Enable broadcast
+    int broadcast_enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &broadcast_enable, sizeof(broadcast_enable)) < 0) {
+        close(fd);
+        return -1;
+    }
+
     // Don't allow address/port reuse for inter-process isolation
     // SO_REUSEADDR can allow multiple processes to bind to the same port on some systems
     // We want each node to have a unique port for proper identification
@@ -52,16 +419,28 @@ bool UdpTransport::initialize(uint16_t port) {
     }
     */
 
-    // Don't allow port reuse - each process should get its own port
-    // This ensures proper process isolation
-    /*
-#ifdef SO_REUSEPORT
-    int reuse_port = 1;
-    setsockopt(socket_fd_, SOL_SOCKET, SO_REUSEPORT,
-               &reuse_port, sizeof(reuse_port));
-    // Don't fail if SO_REUSEPORT is not available
+    // SO_REUSEPORT only groups this transport's own receive sockets (initialize() reserved the port first)
+    if (reuse_port) {
+        int reuse = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    // Shared port (multicast receivers): every socket on the port gets its own copy of the groups it joined,
+    // and only those (without IP_MULTICAST_ALL=0 Linux delivers any group joined on the host)
+    if (shared_port) {
+        int reuse = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
+            close(fd);
+            return -1;
+        }
+#ifdef IP_MULTICAST_ALL
+        int all = 0;
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
 #endif
-    */
+    }
 
     // Bind to port
     struct sockaddr_in addr;
@@ -70,30 +449,112 @@ bool UdpTransport::initialize(uint16_t port) {
     addr.sin_addr.s_addr = INADDR_ANY;
     addr.sin_port = htons(port);
 
-    if (bind(socket_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
-        close(socket_fd_);
-        socket_fd_ = -1;
-        return false;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
     }
 
-    // Get actual port (if auto-selected)
+    // Set non-blocking: the receive thread drains the socket, then waits in poll()
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    enableOffload(fd);
+    return fd;
+}
+
+void UdpTransport::enableOffload(int fd) {
+    if (!offload_requested_) {
+        return;
+    }
+#ifdef UDP_SEGMENT
+    // Kernels with GSO know the option (segment size 0 = off until a message asks for it)
+    int segment = 0;
+    socklen_t segment_len = sizeof(segment);
+    if (getsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, &segment, &segment_len) == 0) {
+        gso_enabled_.store(true, std::memory_order_relaxed);
+    }
+#endif
+#ifdef UDP_GRO
+    int gro = 1;
+    if (setsockopt(fd, IPPROTO_UDP, UDP_GRO, &gro, sizeof(gro)) == 0) {
+        gro_enabled_ = true;
+    }
+#endif
+}
+
+uint16_t UdpTransport::reservePort(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
     socklen_t addr_len = sizeof(addr);
-    if (getsockname(socket_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
-        port_ = ntohs(addr.sin_port);
-    } else {
-        port_ = port;
+    uint16_t reserved = 0;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
+        reserved = ntohs(addr.sin_port);
     }
+    // Released right away: another transport could only take it in the gap before our sockets bind
+    close(fd);
+    return reserved;
+}
 
-    // Set non-blocking
-    int flags = fcntl(socket_fd_, F_GETFL, 0);
-    fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
+bool UdpTransport::steerByCpu() {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    // Receiving CPU -> socket index (order of bind() within the group); each CPU goes to its first set
+    const size_t sockets = 1 + extra_fds_.size();
+    std::vector<std::pair<uint32_t, uint32_t>> routes;
+    uint64_t assigned = 0;
+    for (size_t i = 0; i < sockets; ++i) {
+        const uint64_t mask = receive_cpu_sets_[i % receive_cpu_sets_.size()] & ~assigned;
+        for (uint32_t cpu = 0; cpu < 64; ++cpu) {
+            if (mask & (uint64_t(1) << cpu)) {
+                routes.emplace_back(cpu, static_cast<uint32_t>(i));
+            }
+        }
+        assigned |= mask;
+    }
 
-    // Start receive thread
-    initialized_ = true;
-    running_ = true;
-    receive_thread_ = std::thread(&UdpTransport::receiveThread, this);
+    // A = CPU; one jeq per routed CPU to its "ret index"; no match returns an out-of-range index,
+    // which makes the kernel fall back to the flow hash
+    std::vector<struct sock_filter> code;
+    code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+    const size_t first_ret = 1 + routes.size() + 1;
+    for (size_t r = 0; r < routes.size(); ++r) {
+        const size_t next = 1 + r + 1;
+        code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, routes[r].first,
+                                static_cast<uint8_t>(first_ret + routes[r].second - next), 0));
+    }
+    code.push_back(BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(sockets)));
+    for (size_t i = 0; i < sockets; ++i) {
+        code.push_back(BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(i)));
+    }
 
-    return true;
+    struct sock_fprog program;
+    program.len = static_cast<unsigned short>(code.size());
+    program.filter = code.data();
+    return setsockopt(socket_fd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0;
+#else
+    errno = ENOTSUP;
+    return false;
+#endif
+}
+
+void UdpTransport::setReceivePlacement(const ThreadPlacement& placement) {
+    receive_placement_ = placement;
+}
+
+void UdpTransport::setReceiveThreads(size_t count, const std::vector<uint64_t>& cpu_sets) {
+    receive_thread_count_ = std::max<size_t>(1, std::min(count, MAX_RECEIVE_THREADS));
+    receive_cpu_sets_.clear();
+    for (uint64_t mask : cpu_sets) {
+        if (mask != 0) {
+            receive_cpu_sets_.push_back(mask);
+        }
+    }
 }
 
 void UdpTransport::shutdown() {
@@ -103,16 +564,33 @@ void UdpTransport::shutdown() {
 
     running_ = false;
 
-    // Wait for receive thread
-    if (receive_thread_.joinable()) {
-        receive_thread_.join();
+    // Wake the receive threads out of poll() (the eventfd stays readable for all of them) and wait for them
+    const uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) != static_cast<ssize_t>(sizeof(one))) {
+        NEXUS_WARN("Udp") << "Failed to wake receive thread: " << strerror(errno);
+    }
+    for (auto& thread : receive_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
+    receive_threads_.clear();
+    io_uring_receivers_.clear();
+    io_uring_sockets_.store(0, std::memory_order_relaxed);
 
-    // Close socket
+    // Close sockets and wakeup fd
     if (socket_fd_ >= 0) {
         close(socket_fd_);
         socket_fd_ = -1;
     }
+    for (int fd : extra_fds_) {
+        close(fd);
+    }
+    extra_fds_.clear();
+    close(wake_fd_);
+    wake_fd_ = -1;
+    gso_enabled_.store(false, std::memory_order_relaxed);
+    gro_enabled_ = false;
 
     initialized_ = false;
 }
@@ -128,18 +606,313 @@ bool UdpTransport::send(const uint8_t* data, size_t size, const std::string& des
 
     // Setup destination address
     struct sockaddr_in dest;
+    if (!resolveAddress(addr, port, dest)) {
+        return false;
+    }
+
+    return sendTo(data, size, dest);
+}
+
+bool UdpTransport::sendTo(const uint8_t* data, size_t size, const struct sockaddr_in& dest) {
+    if (!initialized_ || socket_fd_ < 0 || !data || size == 0) {
+        return false;
+    }
+
+    // Compress large datagrams when that pays off (per-thread buffer: no allocation once grown)
+    thread_local std::vector<uint8_t> compressed;
+    const size_t packet_size = compressDatagram(data, size, compressed);
+    if (packet_size > 0) {
+        const ssize_t sent = sendto(socket_fd_, compressed.data(), packet_size, 0,
+                                    reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest));
+        if (sent != static_cast<ssize_t>(packet_size)) {
+            return false;
+        }
+        NEXUS_TRACE2(udp_send, ntohs(dest.sin_port), packet_size);
+        stats_compressed_.fetch_add(1, std::memory_order_relaxed);
+        stats_bytes_saved_.fetch_add(size - packet_size, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Send data
+    const ssize_t sent =
+        sendto(socket_fd_, data, size, 0, reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest));
+
+    if (sent != static_cast<ssize_t>(size)) {
+        return false;
+    }
+    NEXUS_TRACE2(udp_send, ntohs(dest.sin_port), size);
+    return true;
+}
+
+size_t UdpTransport::sendBatch(const uint8_t* data, size_t size, const std::vector<struct sockaddr_in>& dests) {
+    if (!initialized_ || socket_fd_ < 0 || !data || size == 0) {
+        return 0;
+    }
+
+    // Compressed once, then the same iovec goes to every destination
+    thread_local std::vector<uint8_t> compressed;
+    const size_t packet_size = compressDatagram(data, size, compressed);
+    struct iovec iov;
+    iov.iov_base = const_cast<uint8_t*>(packet_size > 0 ? compressed.data() : data);
+    iov.iov_len = packet_size > 0 ? packet_size : size;
+
+    struct mmsghdr msgs[SEND_BATCH];
+    size_t total_sent = 0;
+    for (size_t begin = 0; begin < dests.size(); begin += SEND_BATCH) {
+        const size_t count = std::min(SEND_BATCH, dests.size() - begin);
+        std::memset(msgs, 0, sizeof(struct mmsghdr) * count);
+        for (size_t i = 0; i < count; ++i) {
+            msgs[i].msg_hdr.msg_name = const_cast<struct sockaddr_in*>(&dests[begin + i]);
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            msgs[i].msg_hdr.msg_iov = &iov;
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        size_t next = 0;
+        while (next < count) {
+            const size_t sent = sendMessages(msgs + next, count - next);
+            total_sent += sent;
+            next += sent + 1;  // Skip the refused destination (if any), the rest still get the datagram
+        }
+    }
+
+    if (packet_size > 0) {
+        stats_compressed_.fetch_add(total_sent, std::memory_order_relaxed);
+        stats_bytes_saved_.fetch_add(total_sent * (size - packet_size), std::memory_order_relaxed);
+    }
+    return total_sent;
+}
+
+size_t UdpTransport::sendBatch(const Datagram* datagrams, size_t count, const struct sockaddr_in& dest) {
+    if (!initialized_ || socket_fd_ < 0 || !datagrams) {
+        return 0;
+    }
+
+    // One compression buffer per datagram of a batch (per thread: no allocation once grown)
+    thread_local std::vector<std::vector<uint8_t>> compressed(SEND_BATCH);
+    struct iovec iovs[SEND_BATCH];
+    struct mmsghdr msgs[SEND_BATCH];
+    SegmentControl controls[SEND_BATCH];
+    size_t runs[SEND_BATCH];
+    size_t raw_sizes[SEND_BATCH];
+    size_t total_sent = 0;
+    while (total_sent < count) {
+        const size_t begin = total_sent;
+        const size_t batch = std::min(SEND_BATCH, count - begin);
+        for (size_t i = 0; i < batch; ++i) {
+            const Datagram& datagram = datagrams[begin + i];
+            if (!datagram.data || datagram.size == 0) {
+                return total_sent;
+            }
+            const size_t packet_size = compressDatagram(datagram.data, datagram.size, compressed[i]);
+            iovs[i].iov_base = const_cast<uint8_t*>(packet_size > 0 ? compressed[i].data() : datagram.data);
+            iovs[i].iov_len = packet_size > 0 ? packet_size : datagram.size;
+            raw_sizes[i] = datagram.size;
+        }
+
+        const size_t messages = buildMessages(iovs, batch, dest, msgs, runs, controls);
+        const size_t sent = sendMessages(msgs, messages);
+        const int error = errno;
+        size_t sent_datagrams = 0;
+        for (size_t m = 0; m < sent; ++m) {
+            sent_datagrams += runs[m];
+            if (runs[m] > 1) {
+                stats_segmented_sends_.fetch_add(1, std::memory_order_relaxed);
+                stats_segmented_datagrams_.fetch_add(runs[m], std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < sent_datagrams; ++i) {
+            if (iovs[i].iov_base != datagrams[begin + i].data) {
+                stats_compressed_.fetch_add(1, std::memory_order_relaxed);
+                stats_bytes_saved_.fetch_add(raw_sizes[i] - iovs[i].iov_len, std::memory_order_relaxed);
+            }
+        }
+        total_sent += sent_datagrams;
+
+        if (sent < messages) {
+            if (runs[sent] == 1) {
+                break;  // The socket refused a plain datagram
+            }
+            // A segmented message was refused: segments above the path MTU (EINVAL) or no checksum offload
+            // on the device (EIO). Resend the rest with smaller segments or one datagram per message
+            const size_t segment = iovs[sent_datagrams].iov_len;
+            if (error == EINVAL && segment > 1) {
+                gso_max_segment_.store(segment - 1, std::memory_order_relaxed);
+            } else {
+                gso_enabled_.store(false, std::memory_order_relaxed);
+                NEXUS_WARN("Udp") << "UDP segmentation offload refused on port " << port_ << ": " << strerror(error)
+                                  << " (sending one datagram per message)";
+            }
+        }
+    }
+    return total_sent;
+}
+
+size_t UdpTransport::buildMessages(struct iovec* iovs, size_t count, const struct sockaddr_in& dest,
+                                   struct mmsghdr* msgs, size_t* runs, SegmentControl* controls) {
+    const bool segment = gso_enabled_.load(std::memory_order_relaxed);
+    const size_t max_segment = gso_max_segment_.load(std::memory_order_relaxed);
+    size_t messages = 0;
+    for (size_t i = 0; i < count;) {
+        // Run: datagrams of the first one's size, then at most one shorter datagram, within the kernel's limits
+        size_t run = 1;
+        const size_t size = iovs[i].iov_len;
+        if (segment && size <= max_segment) {
+            size_t bytes = size;
+            while (i + run < count && run < MAX_GSO_SEGMENTS && iovs[i + run].iov_len <= size &&
+                   bytes + iovs[i + run].iov_len <= MAX_GSO_BYTES) {
+                bytes += iovs[i + run].iov_len;
+                if (iovs[i + run++].iov_len < size) {
+                    break;
+                }
+            }
+        }
+
+        struct mmsghdr& msg = msgs[messages];
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_hdr.msg_name = const_cast<struct sockaddr_in*>(&dest);
+        msg.msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        msg.msg_hdr.msg_iov = &iovs[i];
+        msg.msg_hdr.msg_iovlen = run;
+#ifdef UDP_SEGMENT
+        if (run > 1) {
+            msg.msg_hdr.msg_control = controls[messages].space;
+            msg.msg_hdr.msg_controllen = sizeof(controls[messages].space);
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg.msg_hdr);
+            cmsg->cmsg_level = IPPROTO_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t segment_size = static_cast<uint16_t>(size);
+            std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        }
+#else
+        (void)controls;
+#endif
+        runs[messages++] = run;
+        i += run;
+    }
+    return messages;
+}
+
+size_t UdpTransport::compressDatagram(const uint8_t* data, size_t size, std::vector<uint8_t>& out) const {
+    const size_t threshold = compression_threshold_.load(std::memory_order_relaxed);
+    if (threshold == 0 || size < threshold || size <= sizeof(CompressedPacket) + 1 ||
+        size > CompressedPacket::MAX_RAW_SIZE) {
+        return 0;
+    }
+
+    out.resize(size);
+    const size_t block_size =
+        lz4Compress(data, size, out.data() + sizeof(CompressedPacket), size - sizeof(CompressedPacket) - 1);
+    if (block_size == 0) {
+        return 0;
+    }
+
+    CompressedPacket* header = reinterpret_cast<CompressedPacket*>(out.data());
+    header->magic = MessagePacket::MAGIC;
+    header->version = CompressedPacket::VERSION;
+    header->reserved = 0;
+    header->raw_size = static_cast<uint32_t>(size);
+    return sizeof(CompressedPacket) + block_size;
+}
+
+size_t UdpTransport::sendMessages(struct mmsghdr* msgs, size_t count) {
+    size_t sent = 0;
+    while (sent < count) {
+        const int result = sendmmsg(socket_fd_, msgs + sent, static_cast<unsigned int>(count - sent), 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;  // msgs[sent] was refused
+        }
+        for (size_t i = sent; i < sent + static_cast<size_t>(result); ++i) {
+            const struct sockaddr_in* dest = static_cast<const struct sockaddr_in*>(msgs[i].msg_hdr.msg_name);
+            NEXUS_TRACE2(udp_send, ntohs(dest->sin_port), msgs[i].msg_len);
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return sent;
+}
+
+UdpTransport::OffloadStats UdpTransport::getOffloadStats() const {
+    OffloadStats stats;
+    stats.segmented_sends = stats_segmented_sends_.load(std::memory_order_relaxed);
+    stats.segmented_datagrams = stats_segmented_datagrams_.load(std::memory_order_relaxed);
+    stats.coalesced_receives = stats_coalesced_receives_.load(std::memory_order_relaxed);
+    stats.coalesced_datagrams = stats_coalesced_datagrams_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+UdpTransport::CompressionStats UdpTransport::getCompressionStats() const {
+    CompressionStats stats;
+    stats.packets_compressed = stats_compressed_.load(std::memory_order_relaxed);
+    stats.bytes_saved = stats_bytes_saved_.load(std::memory_order_relaxed);
+    stats.packets_expanded = stats_expanded_.load(std::memory_order_relaxed);
+    stats.packets_rejected = stats_rejected_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool UdpTransport::resolveAddress(const std::string& addr, uint16_t port, struct sockaddr_in& dest) {
     std::memset(&dest, 0, sizeof(dest));
     dest.sin_family = AF_INET;
     dest.sin_port = htons(port);
 
-    if (inet_pton(AF_INET, addr.c_str(), &dest.sin_addr) <= 0) {
+    return inet_pton(AF_INET, addr.c_str(), &dest.sin_addr) > 0;
+}
+
+std::string UdpTransport::formatAddress(const sockaddr_in& addr) {
+    if (addr.sin_addr.s_addr == htonl(INADDR_ANY)) {
+        return "127.0.0.1";
+    }
+    char text[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, text, sizeof(text));
+    return text;
+}
+
+sockaddr_in UdpTransport::replyAddress(const sockaddr_in& from, uint16_t port) {
+    sockaddr_in reply;
+    std::memset(&reply, 0, sizeof(reply));
+    reply.sin_family = AF_INET;
+    reply.sin_port = htons(port);
+    reply.sin_addr.s_addr = from.sin_addr.s_addr == htonl(INADDR_ANY) ? htonl(INADDR_LOOPBACK) : from.sin_addr.s_addr;
+    return reply;
+}
+
+bool UdpTransport::joinMulticastGroup(const std::string& group_addr) {
+    return changeMembership(group_addr, IP_ADD_MEMBERSHIP);
+}
+
+bool UdpTransport::leaveMulticastGroup(const std::string& group_addr) {
+    return changeMembership(group_addr, IP_DROP_MEMBERSHIP);
+}
+
+bool UdpTransport::changeMembership(const std::string& group_addr, int option) {
+    if (!initialized_ || socket_fd_ < 0) {
         return false;
     }
 
-    // Send data
-    const ssize_t sent = sendto(socket_fd_, data, size, 0, reinterpret_cast<struct sockaddr*>(&dest), sizeof(dest));
+    struct ip_mreq mreq;
+    std::memset(&mreq, 0, sizeof(mreq));
+    if (inet_pton(AF_INET, group_addr.c_str(), &mreq.imr_multiaddr) <= 0 ||
+        !IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr))) {
+        return false;
+    }
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (setsockopt(socket_fd_, IPPROTO_IP, option, &mreq, sizeof(mreq)) < 0) {
+        NEXUS_WARN("Udp") << (option == IP_ADD_MEMBERSHIP ? "Join" : "Leave") << " multicast group " << group_addr
+                          << " failed: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
 
-    return sent == static_cast<ssize_t>(size);
+bool UdpTransport::setMulticastTtl(uint8_t ttl) {
+    if (!initialized_ || socket_fd_ < 0) {
+        return false;
+    }
+    unsigned char value = ttl;
+    return setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &value, sizeof(value)) == 0;
 }
 
 bool UdpTransport::broadcast(const uint8_t* data, size_t size) {
@@ -147,46 +920,214 @@ bool UdpTransport::broadcast(const uint8_t* data, size_t size) {
 }
 
 void UdpTransport::setReceiveCallback(ReceiveCallback callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    receive_callback_ = std::move(callback);
+    std::shared_ptr<const ReceiveCallback> installed;
+    if (callback) {
+        installed = std::make_shared<const ReceiveCallback>(std::move(callback));
+    }
+    std::atomic_store(&receive_callback_, std::move(installed));
 }
 
-void UdpTransport::receiveThread() {
+void UdpTransport::receiveThread(int fd, size_t index, IoUringReceiver* ring) {
+    ThreadPlacement placement = receive_placement_;
+    if (!receive_cpu_sets_.empty()) {
+        placement.cpu_mask = receive_cpu_sets_[index % receive_cpu_sets_.size()];
+    }
+    applyThreadPlacement(placement, "udp receive " + std::to_string(index));
+
+    std::vector<uint8_t> expanded;  // Compressed datagrams are expanded here (sized on first use)
+    if (ring) {
+        if (receiveWithIoUring(*ring, expanded)) {
+            return;
+        }
+        io_uring_sockets_.fetch_sub(1, std::memory_order_relaxed);
+        NEXUS_WARN("Udp") << "Multishot io_uring receive refused on port " << port_ << " (using the socket loop)";
+    }
+
     constexpr size_t BUFFER_SIZE = 65536;
-    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    // One buffer per batch slot, left uninitialized: pages only become resident once a datagram lands there
+    std::unique_ptr<uint8_t[]> buffers(new uint8_t[RECV_BATCH * BUFFER_SIZE]);
 
-    struct sockaddr_in from_addr;
-    socklen_t from_len = sizeof(from_addr);
+    struct sockaddr_in from_addrs[RECV_BATCH];
+    struct iovec iovs[RECV_BATCH];
+    struct mmsghdr msgs[RECV_BATCH];
+    SegmentControl controls[RECV_BATCH];  // UDP_GRO: segment size of a coalesced buffer
+    for (size_t i = 0; i < RECV_BATCH; ++i) {
+        iovs[i].iov_base = buffers.get() + i * BUFFER_SIZE;
+        iovs[i].iov_len = BUFFER_SIZE;
+    }
 
     while (running_) {
-        // Receive data
-        ssize_t received = recvfrom(socket_fd_, buffer.data(), buffer.size(), 0,
-                                    reinterpret_cast<struct sockaddr*>(&from_addr), &from_len);
+        // Drain up to RECV_BATCH datagrams per syscall (msg_namelen is value-result: reset every call)
+        std::memset(msgs, 0, sizeof(msgs));
+        for (size_t i = 0; i < RECV_BATCH; ++i) {
+            msgs[i].msg_hdr.msg_name = &from_addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(from_addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            if (gro_enabled_) {
+                msgs[i].msg_hdr.msg_control = controls[i].space;
+                msgs[i].msg_hdr.msg_controllen = sizeof(controls[i].space);
+            }
+        }
+        const int received = recvmmsg(fd, msgs, RECV_BATCH, 0, nullptr);
 
         if (received > 0) {
-            // Convert address to string
-            char addr_str[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &from_addr.sin_addr, addr_str, sizeof(addr_str));
-            std::string from_address(addr_str);
-
-            // Invoke callback
-            {
-                std::lock_guard<std::mutex> lock(callback_mutex_);
-                if (receive_callback_) {
-                    NEXUS_DEBUG("Udp") << "UDP Received message from " << from_address << " (" << received << " bytes)";
-                    receive_callback_(buffer.data(), static_cast<size_t>(received), from_address);
-                }
+            // One reference per batch keeps the callback alive even if it is replaced meanwhile
+            const std::shared_ptr<const ReceiveCallback> callback = std::atomic_load(&receive_callback_);
+            if (!callback) {
+                continue;
+            }
+            for (int i = 0; i < received; ++i) {
+                deliverBuffer(*callback, static_cast<const uint8_t*>(iovs[i].iov_base), msgs[i].msg_len,
+                              coalescedSegment(msgs[i].msg_hdr), from_addrs[i], expanded);
             }
         } else if (received < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                // No data available, sleep briefly
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            } else {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
                 // Error
                 break;
             }
+
+            // Drained: sleep until a datagram arrives or shutdown() signals wake_fd_
+            struct pollfd fds[2];
+            fds[0].fd = fd;
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            fds[1].fd = wake_fd_;
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+            if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+                break;
+            }
+            if (fds[1].revents & POLLIN) {
+                break;
+            }
+        }
+    }
+}
+
+#ifdef NEXUS_UDP_IO_URING
+bool UdpTransport::receiveWithIoUring(IoUringReceiver& ring, std::vector<uint8_t>& expanded) {
+    const struct msghdr& layout = ring.layout();
+    bool armed = true;     // The multishot receive is still queued in the kernel
+    bool received = false;
+    while (running_) {
+        if (!armed) {
+            armed = ring.armReceive();
+        }
+        if (!ring.submitAndWait()) {
+            break;
+        }
+
+        // One reference per wakeup keeps the callback alive even if it is replaced meanwhile
+        const std::shared_ptr<const ReceiveCallback> callback = std::atomic_load(&receive_callback_);
+        bool woken = false;
+        bool refused = false;
+        ring.forEachCompletion([&](const struct io_uring_cqe& cqe) {
+            if (cqe.user_data == IoUringReceiver::WAKE_TAG) {
+                woken = true;
+                return;
+            }
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                armed = false;  // Ended (CQ overflow, no free buffer, error): queued again on the next pass
+            }
+            if (cqe.res < 0) {
+                refused = refused || (!received && (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP));
+                return;
+            }
+            if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+                return;
+            }
+            received = true;
+            const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            const uint8_t* buffer = ring.buffer(bid);
+            const struct io_uring_recvmsg_out* out = reinterpret_cast<const struct io_uring_recvmsg_out*>(buffer);
+            const uint8_t* name = buffer + sizeof(*out);
+            const uint8_t* control = name + layout.msg_namelen;
+            const uint8_t* payload = control + layout.msg_controllen;
+            if (callback && !(out->flags & MSG_TRUNC) && out->namelen >= sizeof(struct sockaddr_in)) {
+                struct sockaddr_in from;
+                std::memcpy(&from, name, sizeof(from));
+                struct msghdr msg;
+                std::memset(&msg, 0, sizeof(msg));
+                msg.msg_control = const_cast<uint8_t*>(control);
+                msg.msg_controllen = out->controllen;
+                deliverBuffer(*callback, payload, out->payloadlen, coalescedSegment(msg), from, expanded);
+            }
+            ring.recycle(bid);
+        });
+        if (woken) {
+            break;
+        }
+        if (refused) {
+            return false;
+        }
+    }
+    return true;
+}
+#else
+bool UdpTransport::receiveWithIoUring(IoUringReceiver&, std::vector<uint8_t>&) {
+    return false;
+}
+#endif
+
+size_t UdpTransport::coalescedSegment(const struct msghdr& msg) {
+#ifdef UDP_GRO
+    for (const struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), const_cast<struct cmsghdr*>(cmsg))) {
+        if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segment = 0;
+            std::memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+            return segment > 0 ? static_cast<size_t>(segment) : 0;
         }
     }
+#else
+    (void)msg;
+#endif
+    return 0;
+}
+
+void UdpTransport::deliverBuffer(const ReceiveCallback& callback, const uint8_t* data, size_t length, size_t segment,
+                                 const struct sockaddr_in& from, std::vector<uint8_t>& expanded) {
+    if (segment == 0 || segment >= length) {
+        if (length > 0) {
+            deliverDatagram(callback, data, length, from, expanded);
+        }
+        return;
+    }
+    // Coalesced by GRO: every segment but the last is exactly segment bytes
+    size_t datagrams = 0;
+    for (size_t offset = 0; offset < length; offset += segment, ++datagrams) {
+        deliverDatagram(callback, data + offset, std::min(segment, length - offset), from, expanded);
+    }
+    stats_coalesced_receives_.fetch_add(1, std::memory_order_relaxed);
+    stats_coalesced_datagrams_.fetch_add(datagrams, std::memory_order_relaxed);
+}
+
+void UdpTransport::deliverDatagram(const ReceiveCallback& callback, const uint8_t* data, size_t size,
+                                   const struct sockaddr_in& from, std::vector<uint8_t>& expanded) {
+    if (size >= sizeof(CompressedPacket) && CompressedPacket::isCompressed(data)) {
+        const CompressedPacket* packet = reinterpret_cast<const CompressedPacket*>(data);
+        if (packet->raw_size > CompressedPacket::MAX_RAW_SIZE) {
+            stats_rejected_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        expanded.resize(CompressedPacket::MAX_RAW_SIZE);
+        const size_t raw_size =
+            lz4Decompress(packet->getBlock(), size - sizeof(CompressedPacket), expanded.data(), packet->raw_size);
+        if (raw_size != packet->raw_size) {
+            stats_rejected_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        stats_expanded_.fetch_add(1, std::memory_order_relaxed);
+        data = expanded.data();
+        size = raw_size;
+    }
+
+    NEXUS_TRACE2(udp_recv, ntohs(from.sin_port), size);
+    callback(data, size, from);
 }
 
 }  // namespace rpc
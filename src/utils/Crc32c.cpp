@@ -0,0 +1,144 @@
+#include "nexus/utils/Crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define NEXUS_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define NEXUS_CRC32C_ARM 1
+#endif
+
+namespace Nexus {
+namespace rpc {
+
+namespace {
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;  // Reflected Castagnoli polynomial
+constexpr uint32_t CRC32_POLY = 0xEDB88320;   // Reflected IEEE 802.3 polynomial
+constexpr size_t COPY_CHUNK = 4096;           // crc32cCopy(): chunk checksummed while still in L1
+
+// Slicing-by-8 tables: entries[k][b] is the CRC of byte b followed by k zero bytes
+struct CrcTable {
+    uint32_t entries[8][256];
+
+    explicit CrcTable(uint32_t poly) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? poly : 0);
+            }
+            entries[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+// Eight bytes per step through eight independent lookups (~4x the byte-at-a-time loop)
+uint32_t crcSoftware(const CrcTable& table, uint32_t crc, const uint8_t* ptr, size_t size) {
+    for (; size >= 8; size -= 8, ptr += 8) {
+        const uint32_t low = crc ^ (static_cast<uint32_t>(ptr[0]) | (static_cast<uint32_t>(ptr[1]) << 8) |
+                                    (static_cast<uint32_t>(ptr[2]) << 16) | (static_cast<uint32_t>(ptr[3]) << 24));
+        const uint32_t high = static_cast<uint32_t>(ptr[4]) | (static_cast<uint32_t>(ptr[5]) << 8) |
+                              (static_cast<uint32_t>(ptr[6]) << 16) | (static_cast<uint32_t>(ptr[7]) << 24);
+        crc = table.entries[7][low & 0xFF] ^ table.entries[6][(low >> 8) & 0xFF] ^
+              table.entries[5][(low >> 16) & 0xFF] ^ table.entries[4][low >> 24] ^ table.entries[3][high & 0xFF] ^
+              table.entries[2][(high >> 8) & 0xFF] ^ table.entries[1][(high >> 16) & 0xFF] ^
+              table.entries[0][high >> 24];
+    }
+    for (; size > 0; --size, ++ptr) {
+        crc = table.entries[0][(crc ^ *ptr) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t crc32cSoftware(uint32_t crc, const uint8_t* ptr, size_t size) {
+    static const CrcTable table(CRC32C_POLY);
+    return crcSoftware(table, crc, ptr, size);
+}
+
+#if defined(NEXUS_CRC32C_X86)
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(uint32_t crc, const uint8_t* ptr, size_t size) {
+    uint64_t crc64 = crc;
+    for (; size >= 8; size -= 8, ptr += 8) {
+        uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    uint32_t crc32 = static_cast<uint32_t>(crc64);
+    for (; size > 0; --size, ++ptr) {
+        crc32 = _mm_crc32_u8(crc32, *ptr);
+    }
+    return crc32;
+}
+
+bool detectHardware() {
+    __builtin_cpu_init();  // May run before the runtime's own constructors
+    return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(NEXUS_CRC32C_ARM)
+uint32_t crc32cHardware(uint32_t crc, const uint8_t* ptr, size_t size) {
+    for (; size >= 8; size -= 8, ptr += 8) {
+        uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; --size, ++ptr) {
+        crc = __crc32cb(crc, *ptr);
+    }
+    return crc;
+}
+
+bool detectHardware() {
+    return true;  // Compiled for the CRC extension
+}
+#else
+uint32_t crc32cHardware(uint32_t crc, const uint8_t* ptr, size_t size) {
+    return crc32cSoftware(crc, ptr, size);
+}
+
+bool detectHardware() {
+    return false;
+}
+#endif
+
+// Resolved once; the check is a load of a static afterwards
+const bool g_hardware = detectHardware();
+}  // namespace
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    crc = g_hardware ? crc32cHardware(crc, ptr, size) : crc32cSoftware(crc, ptr, size);
+    return ~crc;
+}
+
+uint32_t crc32cCopy(uint32_t crc, void* dst, const void* src, size_t size) {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    while (size > 0) {
+        const size_t chunk = size < COPY_CHUNK ? size : COPY_CHUNK;
+        std::memcpy(out, in, chunk);
+        crc = crc32c(crc, in, chunk);  // Source chunk is cache-hot from the copy
+        out += chunk;
+        in += chunk;
+        size -= chunk;
+    }
+    return crc;
+}
+
+uint32_t crc32(uint32_t crc, const void* data, size_t size) {
+    static const CrcTable table(CRC32_POLY);
+    return ~crcSoftware(table, ~crc, static_cast<const uint8_t*>(data), size);
+}
+
+bool crc32cHardwareAccelerated() {
+    return g_hardware;
+}
+
+}  // namespace rpc
+}  // namespace Nexus
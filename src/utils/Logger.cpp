@@ -1,10 +1,73 @@
 #include "nexus/utils/Logger.h"
 
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
+#include <thread>
+
+#include "nexus/utils/BoundedQueue.h"
 
 namespace Nexus {
 namespace rpc {
 
+/**
+ * @brief Background writer of asynchronous mode
+ *
+ * Producers push finished lines onto a lock-free ring and signal an
+ * eventcount; the writer drains the ring, flushing the streams whenever it
+ * runs dry.
+ */
+struct Logger::AsyncWriter {
+    struct Line {
+        Level level = Level::INFO;
+        std::string text;
+    };
+
+    explicit AsyncWriter(size_t capacity) : lines(capacity), owner_pid(getpid()), thread([this] { run(); }) {}
+
+    void run() {
+        Line line;
+        for (;;) {
+            bool wrote = false;
+            while (lines.tryPop(line)) {
+                writeLine(line.level, line.text);
+                written.fetch_add(1, std::memory_order_release);
+                wrote = true;
+            }
+            const uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                writeLine(Level::WARN, "[Logger] " + std::to_string(lost) + " log line(s) dropped (async ring full)");
+                wrote = true;
+            }
+            if (wrote) {
+                std::cout.flush();
+                std::cerr.flush();
+            }
+            uint32_t key = ready.prepareWait();
+            if (!lines.empty()) {
+                ready.cancelWait();
+            } else if (stopping.load(std::memory_order_acquire)) {
+                ready.cancelWait();
+                return;
+            } else {
+                ready.wait(key);
+            }
+        }
+    }
+
+    BoundedMpmcQueue<Line> lines;
+    EventCount ready;                    // Signalled per pushed line and on stop
+    std::atomic<uint64_t> pushed{0};     // Lines accepted by the ring
+    std::atomic<uint64_t> written{0};    // Lines the writer has written
+    std::atomic<uint64_t> dropped{0};    // Lines lost to a full ring, not yet reported
+    std::atomic<bool> stopping{false};
+    const pid_t owner_pid;               // A forked child has the memory but not the thread
+    std::thread thread;                  // Last: starts once the members above exist
+};
+
 Logger& Logger::instance() {
     static Logger logger;
     return logger;
@@ -25,26 +88,73 @@ Logger::Logger() {
         else if (level_str == "NONE")
             min_level_ = Level::NONE;
     }
+    if (const char* async = std::getenv("NEXUS_LOG_ASYNC")) {
+        if (std::atoi(async) != 0) {
+            setAsync(true);
+        }
+    }
+}
+
+Logger::~Logger() {
+    // Later log() calls (other static destructors) fall back to writing synchronously
+    async_.store(false, std::memory_order_release);
+    if (!async_writer_ || async_writer_->owner_pid != getpid()) {
+        return;  // Leaked in a forked child: its writer thread never existed there
+    }
+    async_writer_->stopping.store(true, std::memory_order_release);
+    async_writer_->ready.notifyAll();
+    async_writer_->thread.join();
+    delete async_writer_;
+    async_writer_ = nullptr;
 }
 
 void Logger::setLevel(Level level) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    min_level_ = level;
+    min_level_.store(level, std::memory_order_relaxed);
 }
 
 Logger::Level Logger::getLevel() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return min_level_;
+    return min_level_.load(std::memory_order_relaxed);
 }
 
 void Logger::setShowTimestamp(bool show) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    show_timestamp_ = show;
+    show_timestamp_.store(show, std::memory_order_relaxed);
 }
 
 void Logger::setShowComponent(bool show) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    show_component_ = show;
+    show_component_.store(show, std::memory_order_relaxed);
+}
+
+void Logger::setAsync(bool async, size_t capacity) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (async && !async_writer_) {
+            async_writer_ = new AsyncWriter(capacity);
+            // The child of a fork() has no writer thread: it logs synchronously
+            static const int registered = pthread_atfork(nullptr, nullptr, [] {
+                Logger::instance().async_.store(false, std::memory_order_relaxed);
+            });
+            (void)registered;
+        }
+        async_.store(async, std::memory_order_release);
+    }
+    if (!async) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    AsyncWriter* writer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer = async_writer_;
+    }
+    if (!writer || writer->owner_pid != getpid()) {
+        return;
+    }
+    const uint64_t target = writer->pushed.load(std::memory_order_acquire);
+    while (writer->written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
 }
 
 const char* Logger::levelToString(Level level) const {
@@ -67,38 +177,75 @@ std::string Logger::getTimestamp() const {
     auto time_t_now = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
 
-    std::tm tm;
+    // Date and time are formatted once per second per thread; only the milliseconds change per line
+    thread_local std::time_t cached_second = -1;
+    thread_local char cached_text[32];
+    if (time_t_now != cached_second) {
+        std::tm tm;
 #ifdef _WIN32
-    localtime_s(&tm, &time_t_now);
+        localtime_s(&tm, &time_t_now);
 #else
-    localtime_r(&time_t_now, &tm);
+        localtime_r(&time_t_now, &tm);
 #endif
+        std::strftime(cached_text, sizeof(cached_text), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_second = time_t_now;
+    }
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+    char text[40];
+    std::snprintf(text, sizeof(text), "%s.%03d", cached_text, static_cast<int>(ms.count()));
+    return text;
 }
 
-void Logger::log(Level level, const std::string& component, const std::string& message) {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::string Logger::formatLine(Level level, const std::string& component, const std::string& message) const {
+    std::string line;
+    line.reserve(48 + component.size() + message.size());
+    if (show_timestamp_.load(std::memory_order_relaxed)) {
+        line += '[';
+        line += getTimestamp();
+        line += "] ";
+    }
 
-    if (level < min_level_) {
-        return;
+    line += '[';
+    line += levelToString(level);
+    line += "] ";
+
+    if (show_component_.load(std::memory_order_relaxed) && !component.empty()) {
+        line += '[';
+        line += component;
+        line += "] ";
     }
 
+    line += message;
+    return line;
+}
+
+void Logger::writeLine(Level level, const std::string& line) {
     std::ostream& out = (level >= Level::WARN) ? std::cerr : std::cout;
+    out << line << '\n';
+}
 
-    if (show_timestamp_) {
-        out << "[" << getTimestamp() << "] ";
+void Logger::log(Level level, const std::string& component, const std::string& message) {
+    if (level < min_level_.load(std::memory_order_relaxed)) {
+        return;
     }
 
-    out << "[" << levelToString(level) << "] ";
-
-    if (show_component_ && !component.empty()) {
-        out << "[" << component << "] ";
+    if (async_.load(std::memory_order_acquire)) {
+        AsyncWriter::Line line;
+        line.level = level;
+        line.text = formatLine(level, component, message);
+        if (async_writer_->lines.tryPush(line)) {
+            async_writer_->pushed.fetch_add(1, std::memory_order_release);
+            async_writer_->ready.notify();
+        } else {
+            async_writer_->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
     }
 
-    out << message << std::endl;
+    const std::string line = formatLine(level, component, message);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostream& out = (level >= Level::WARN) ? std::cerr : std::cout;
+    out << line << std::endl;
 }
 
 }  // namespace rpc
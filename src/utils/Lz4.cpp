@@ -0,0 +1,169 @@
+#include "nexus/utils/Lz4.h"
+
+#include <cstring>
+
+namespace Nexus {
+namespace rpc {
+
+namespace {
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;  // Format rule: a block ends with at least 5 literals
+constexpr size_t MATCH_LIMIT = 12;   // Format rule: the last match starts at least 12 bytes before the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+constexpr size_t SKIP_SHIFT = 6;  // Step grows by one every 64 bytes without a match
+
+uint32_t read32(const uint8_t* ptr) {
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+uint32_t hash32(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Length continuation bytes after a 15 in the token
+uint8_t* writeLength(uint8_t* op, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *op++ = 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+// One sequence: literals [anchor, anchor + literals), then a match (none if match_len == 0, last sequence)
+uint8_t* writeSequence(uint8_t* op, uint8_t* op_end, const uint8_t* anchor, size_t literals, size_t offset,
+                       size_t match_len) {
+    const size_t worst = 1 + literals / 255 + 1 + literals + 2 + match_len / 255 + 1;
+    if (static_cast<size_t>(op_end - op) < worst) {
+        return nullptr;
+    }
+
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15) {
+        op = writeLength(op, literals - 15);
+    }
+    std::memcpy(op, anchor, literals);
+    op += literals;
+
+    if (match_len > 0) {
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        const size_t extra = match_len - MIN_MATCH;
+        *token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+        if (extra >= 15) {
+            op = writeLength(op, extra - 15);
+        }
+    }
+    return op;
+}
+
+// Token length extension; false if the input ends inside it
+bool readLength(const uint8_t*& ip, const uint8_t* ip_end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= ip_end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+}  // namespace
+
+size_t lz4Compress(const void* src, size_t size, void* dst, size_t capacity) {
+    const uint8_t* const base = static_cast<const uint8_t*>(src);
+    const uint8_t* const end = base + size;
+    const uint8_t* anchor = base;
+    uint8_t* op = static_cast<uint8_t*>(dst);
+    uint8_t* const op_end = op + capacity;
+
+    if (size > MATCH_LIMIT) {
+        uint32_t table[1u << HASH_BITS] = {};  // Positions relative to base
+        const uint8_t* const match_limit = end - MATCH_LIMIT;
+        const uint8_t* ip = base;
+        while (ip < match_limit) {
+            const uint32_t sequence = read32(ip);
+            const uint32_t slot = hash32(sequence);
+            const uint8_t* ref = base + table[slot];
+            table[slot] = static_cast<uint32_t>(ip - base);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> SKIP_SHIFT);
+                continue;
+            }
+
+            size_t match_len = MIN_MATCH;
+            while (ip + match_len < end - LAST_LITERALS && ip[match_len] == ref[match_len]) {
+                ++match_len;
+            }
+            op = writeSequence(op, op_end, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref),
+                               match_len);
+            if (!op) {
+                return 0;
+            }
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    op = writeSequence(op, op_end, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return op ? static_cast<size_t>(op - static_cast<uint8_t*>(dst)) : 0;
+}
+
+size_t lz4Decompress(const void* src, size_t size, void* dst, size_t capacity) {
+    const uint8_t* ip = static_cast<const uint8_t*>(src);
+    const uint8_t* const ip_end = ip + size;
+    uint8_t* const out = static_cast<uint8_t*>(dst);
+    uint8_t* op = out;
+    uint8_t* const op_end = out + capacity;
+
+    while (ip < ip_end) {
+        const uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(ip, ip_end, literals)) {
+            return SIZE_MAX;
+        }
+        if (static_cast<size_t>(ip_end - ip) < literals || static_cast<size_t>(op_end - op) < literals) {
+            return SIZE_MAX;
+        }
+        std::memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == ip_end) {
+            break;  // Last sequence has no match
+        }
+
+        if (ip_end - ip < 2) {
+            return SIZE_MAX;
+        }
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - out)) {
+            return SIZE_MAX;
+        }
+
+        size_t match_len = token & 0x0F;
+        if (match_len == 15 && !readLength(ip, ip_end, match_len)) {
+            return SIZE_MAX;
+        }
+        match_len += MIN_MATCH;
+        if (static_cast<size_t>(op_end - op) < match_len) {
+            return SIZE_MAX;
+        }
+        // Byte by byte: a match may overlap the bytes it produces (offset < length repeats a run)
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < match_len; ++i) {
+            op[i] = match[i];
+        }
+        op += match_len;
+    }
+    return static_cast<size_t>(op - out);
+}
+
+}  // namespace rpc
+}  // namespace Nexus
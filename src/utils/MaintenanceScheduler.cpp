@@ -0,0 +1,144 @@
+#include "nexus/utils/MaintenanceScheduler.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <unistd.h>
+
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+constexpr MaintenanceScheduler::TaskId MaintenanceScheduler::NO_TASK;
+
+MaintenanceScheduler& MaintenanceScheduler::instance() {
+    // Destroyed at exit only by the process that started the thread: in a forked child the copied
+    // condition variables still count the parent's waiter, and destroying them would block forever
+    static MaintenanceScheduler* scheduler = new MaintenanceScheduler();
+    static struct Shutdown {
+        ~Shutdown() {
+            if (scheduler->owner_pid_ == 0 || scheduler->owner_pid_ == getpid()) {
+                delete scheduler;
+            }
+        }
+    } shutdown;
+    return *scheduler;
+}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        tasks_.clear();
+    }
+    wake_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+MaintenanceScheduler::TaskId MaintenanceScheduler::schedule(std::chrono::milliseconds interval, Task task,
+                                                            std::chrono::milliseconds initial_delay) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const TaskId id = next_id_++;
+    Entry& entry = tasks_[id];
+    entry.task = std::move(task);
+    entry.interval = std::max(interval, std::chrono::milliseconds(1));
+    entry.next_run = std::chrono::steady_clock::now() + initial_delay;
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&MaintenanceScheduler::run, this);
+        owner_pid_ = getpid();
+    }
+    wake_cv_.notify_all();
+    return id;
+}
+
+void MaintenanceScheduler::cancel(TaskId id) {
+    if (id == NO_TASK) {
+        return;  // running_ is NO_TASK while idle: waiting for it to differ would never end
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_.erase(id);
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        idle_cv_.wait(lock, [this, id] { return running_ != id; });
+    }
+}
+
+void MaintenanceScheduler::runSoon(TaskId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it != tasks_.end()) {
+        it->second.next_run = std::chrono::steady_clock::now();
+        it->second.rerun = running_ == id;
+        wake_cv_.notify_all();
+    }
+}
+
+size_t MaintenanceScheduler::taskCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void MaintenanceScheduler::setThreadPlacement(const ThreadPlacement& placement) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    placement_ = placement;
+    placement_pending_ = true;
+    wake_cv_.notify_all();
+}
+
+void MaintenanceScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (placement_pending_) {
+            const ThreadPlacement placement = placement_;
+            placement_pending_ = false;
+            lock.unlock();
+            applyThreadPlacement(placement, "maintenance");
+            lock.lock();
+            continue;
+        }
+        if (tasks_.empty()) {
+            wake_cv_.wait(lock);
+            continue;
+        }
+
+        auto due = tasks_.begin();
+        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+            if (it->second.next_run < due->second.next_run) {
+                due = it;
+            }
+        }
+        if (due->second.next_run > std::chrono::steady_clock::now()) {
+            wake_cv_.wait_until(lock, due->second.next_run);
+            continue;  // Tasks may have come or gone meanwhile
+        }
+
+        // Run without the lock (the task may schedule or cancel); a copy, since cancel() may erase the entry
+        const TaskId id = due->first;
+        Task task = due->second.task;
+        running_ = id;
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception& e) {
+            NEXUS_ERROR("Scheduler") << "Maintenance task " << id << " threw: " << e.what();
+        } catch (...) {
+            NEXUS_ERROR("Scheduler") << "Maintenance task " << id << " threw";
+        }
+        task = nullptr;  // Release captured state before cancel() returns
+        lock.lock();
+        running_ = NO_TASK;
+        auto it = tasks_.find(id);
+        if (it != tasks_.end()) {
+            Entry& entry = it->second;
+            entry.next_run = std::chrono::steady_clock::now() + (entry.rerun ? std::chrono::milliseconds(0)
+                                                                              : entry.interval);
+            entry.rerun = false;
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,238 @@
+#include "nexus/utils/MetricsSegment.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include "nexus/platform/qnx_compat.h"
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+constexpr uint32_t MetricsLayout::MAGIC;
+constexpr uint32_t MetricsLayout::VERSION;
+constexpr size_t MetricsLayout::NAME_LEN;
+constexpr size_t MetricsLayout::MAX_TOPICS;
+constexpr size_t MetricsLayout::MAX_LARGE_READERS;
+constexpr const char* MetricsSegment::PREFIX;
+
+const char* const MetricsLayout::NODE_NAMES[NODE_METRICS] = {
+    "worker_queue_depth",
+    "worker_dropped_total",
+    "shm_sent_total",
+    "shm_received_total",
+    "shm_dropped_total",
+    "shm_bytes_sent_total",
+    "shm_bytes_received_total",
+    "shm_inbound_queues",
+    "shm_inbox_depth",
+    "shm_depth_high",
+    "shm_depth_normal",
+    "shm_depth_bulk",
+    "shm_dropped_high_total",
+    "shm_dropped_normal_total",
+    "shm_dropped_bulk_total",
+    "shm_max_congestion",
+};
+
+const char* const MetricsLayout::TOPIC_NAMES[TOPIC_METRICS] = {
+    "published_total",
+    "published_bytes_total",
+    "delivered_total",
+    "delivered_bytes_total",
+    "dropped_total",
+    "callback_ns_total",
+    "queue_depth",
+};
+
+const char* const MetricsLayout::LARGE_READER_NAMES[LARGE_READER_METRICS] = {
+    "lag_bytes",
+    "capacity_bytes",
+    "bytes_read_total",
+};
+
+namespace {
+constexpr int READ_ATTEMPTS = 100;  // The owner's refresh takes microseconds
+
+bool processAlive(pid_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// Map segment @p name read-only; nullptr if it is not a metrics segment of this version
+const MetricsLayout* mapForReading(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MetricsLayout)) {
+        close(fd);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, sizeof(MetricsLayout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    const MetricsLayout* layout = static_cast<const MetricsLayout*>(addr);
+    if (layout->magic != MetricsLayout::MAGIC || layout->version != MetricsLayout::VERSION) {
+        munmap(addr, sizeof(MetricsLayout));
+        return nullptr;
+    }
+    return layout;
+}
+
+std::string copyName(const char* name) {
+    return std::string(name, strnlen(name, MetricsLayout::NAME_LEN));
+}
+
+template <typename EntryT>
+void copyRows(const EntryT* entries, uint32_t count, size_t metrics, std::vector<MetricsSnapshot::Row>& rows) {
+    rows.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        rows[i].name = copyName(entries[i].name);
+        rows[i].values.resize(metrics);
+        for (size_t m = 0; m < metrics; ++m) {
+            rows[i].values[m] = entries[i].values[m].load(std::memory_order_relaxed);
+        }
+    }
+}
+}  // namespace
+
+MetricsSegment::~MetricsSegment() {
+    if (layout_) {
+        munmap(layout_, sizeof(MetricsLayout));
+        shm_unlink(name_.c_str());
+    }
+}
+
+std::string MetricsSegment::segmentName(const std::string& node_id) {
+    std::string name = std::string("/") + PREFIX + node_id;
+    for (size_t i = 1; i < name.size(); ++i) {
+        if (name[i] == '/') {
+            name[i] = '_';
+        }
+    }
+    return name;
+}
+
+bool MetricsSegment::create(const std::string& node_id, uint32_t interval_ms) {
+    name_ = segmentName(node_id);
+    shm_unlink(name_.c_str());  // Left by an earlier process with the same node id
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        NEXUS_WARN("Metrics") << "Failed to create metrics segment " << name_ << ": " << strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, sizeof(MetricsLayout)) != 0) {
+        NEXUS_WARN("Metrics") << "Failed to size metrics segment " << name_ << ": " << strerror(errno);
+        close(fd);
+        shm_unlink(name_.c_str());
+        return false;
+    }
+    void* addr = mmap(nullptr, sizeof(MetricsLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        NEXUS_WARN("Metrics") << "Failed to map metrics segment " << name_ << ": " << strerror(errno);
+        shm_unlink(name_.c_str());
+        return false;
+    }
+
+    // Zero-filled by ftruncate: every counter starts at 0; the magic goes in last
+    layout_ = static_cast<MetricsLayout*>(addr);
+    layout_->version = MetricsLayout::VERSION;
+    layout_->pid = static_cast<int32_t>(getpid());
+    std::strncpy(layout_->node_id, node_id.c_str(), MetricsLayout::NAME_LEN - 1);
+    layout_->interval_ms.store(interval_ms, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    layout_->magic = MetricsLayout::MAGIC;
+    return true;
+}
+
+void MetricsSegment::beginUpdate() {
+    layout_->sequence.store(layout_->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void MetricsSegment::endUpdate() {
+    layout_->sequence.store(layout_->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::vector<std::string> MetricsSegment::list() {
+    std::vector<std::string> names;
+    DIR* dir = opendir(LIBRPC_SHM_DIR);
+    if (!dir) {
+        return names;
+    }
+    const size_t prefix_len = std::strlen(PREFIX);
+    while (struct dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, PREFIX, prefix_len) == 0) {
+            names.push_back(std::string("/") + entry->d_name);
+        }
+    }
+    closedir(dir);
+    return names;
+}
+
+bool MetricsSegment::read(const std::string& name, MetricsSnapshot& snapshot) {
+    const MetricsLayout* layout = mapForReading(name);
+    if (!layout) {
+        return false;
+    }
+
+    bool consistent = false;
+    for (int attempt = 0; attempt < READ_ATTEMPTS && !consistent; ++attempt) {
+        const uint32_t before = layout->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        snapshot.interval_ms = layout->interval_ms.load(std::memory_order_relaxed);
+        snapshot.update_ms = layout->update_ms.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < MetricsLayout::NODE_METRICS; ++i) {
+            snapshot.node[i] = layout->node[i].load(std::memory_order_relaxed);
+        }
+        const uint32_t topics = std::min<uint32_t>(layout->topic_count.load(std::memory_order_relaxed),
+                                                   static_cast<uint32_t>(MetricsLayout::MAX_TOPICS));
+        const uint32_t readers = std::min<uint32_t>(layout->large_reader_count.load(std::memory_order_relaxed),
+                                                    static_cast<uint32_t>(MetricsLayout::MAX_LARGE_READERS));
+        copyRows(layout->topics, topics, MetricsLayout::TOPIC_METRICS, snapshot.topics);
+        copyRows(layout->large_readers, readers, MetricsLayout::LARGE_READER_METRICS, snapshot.large_readers);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        consistent = layout->sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    snapshot.segment = name;
+    snapshot.node_id = copyName(layout->node_id);
+    snapshot.pid = layout->pid;
+    snapshot.alive = processAlive(layout->pid);
+    munmap(const_cast<MetricsLayout*>(layout), sizeof(MetricsLayout));
+    return consistent;
+}
+
+size_t MetricsSegment::removeOrphaned() {
+    size_t removed = 0;
+    for (const std::string& name : list()) {
+        const MetricsLayout* layout = mapForReading(name);
+        if (!layout) {
+            continue;
+        }
+        const pid_t pid = layout->pid;
+        munmap(const_cast<MetricsLayout*>(layout), sizeof(MetricsLayout));
+        if (!processAlive(pid) && shm_unlink(name.c_str()) == 0) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,94 @@
+#include "nexus/utils/Numa.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+#ifdef __linux__
+namespace {
+// <linux/mempolicy.h> values; the header is not always installed and libnuma is not a dependency
+constexpr int kMpolBind = 2;
+constexpr unsigned kMpolMfMove = 1u << 1;
+constexpr unsigned long kMpolFNode = 1ul << 0;
+constexpr unsigned long kMpolFAddr = 1ul << 1;
+constexpr int kMaxNodes = 64;
+}  // namespace
+#endif
+
+uint64_t numaNodeCpus(int node) {
+    if (node < 0) {
+        return 0;
+    }
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+        return 0;
+    }
+
+    // "0-3,8-11"
+    uint64_t mask = 0;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first < 0 ? 0 : first; cpu <= last && cpu < 64; ++cpu) {
+            mask |= uint64_t(1) << cpu;
+        }
+    }
+    return mask;
+}
+
+bool bindMemoryToNumaNode(void* addr, size_t size, int node) {
+#ifdef __linux__
+    if (node < 0 || node >= kMaxNodes) {
+        NEXUS_WARN("Numa") << "NUMA node " << node << " out of range";
+        return false;
+    }
+    unsigned long nodemask = 1ul << node;
+    if (syscall(SYS_mbind, addr, size, kMpolBind, &nodemask, static_cast<unsigned long>(kMaxNodes + 1),
+                kMpolMfMove) != 0) {
+        NEXUS_WARN("Numa") << "mbind of " << size << " bytes to NUMA node " << node << " failed: " << strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    (void)addr;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+}
+
+int numaNodeOf(const void* addr) {
+#ifdef __linux__
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0ul, addr, kMpolFNode | kMpolFAddr) != 0) {
+        return -1;
+    }
+    return node;
+#else
+    (void)addr;
+    return -1;
+#endif
+}
+
+}  // namespace rpc
+}  // namespace Nexus
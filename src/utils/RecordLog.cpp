@@ -0,0 +1,430 @@
+#include "nexus/utils/RecordLog.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+constexpr uint32_t RecordLayout::MAGIC;
+constexpr uint32_t RecordLayout::VERSION;
+constexpr size_t RecordLayout::ALIGN;
+
+namespace {
+constexpr size_t HEADER_SIZE = sizeof(RecordLayout::SegmentHeader);
+static_assert(HEADER_SIZE % RecordLayout::ALIGN == 0, "frames must start aligned");
+
+size_t streamFrameSize(const RecordStream& stream) {
+    return RecordLayout::frameSize(sizeof(RecordLayout::StreamRecord) + stream.name.size() + stream.topic.size());
+}
+
+uint64_t steadyClockNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+uint64_t wallClockNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+}
+
+std::string streamKey(const RecordStream& stream) {
+    std::string key(1, static_cast<char>(stream.kind));
+    key += stream.name;
+    key += '\0';
+    key += stream.topic;
+    return key;
+}
+}  // namespace
+
+std::string RecordLayout::segmentPath(const std::string& base, uint32_t segment) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06u.nxrec", segment);
+    return base + suffix;
+}
+
+// ============================================================================
+// RecordWriter
+// ============================================================================
+
+RecordWriter::~RecordWriter() {
+    close();
+}
+
+bool RecordWriter::open(const std::string& base, const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_) {
+        return false;
+    }
+    base_ = base;
+    options_ = options;
+    start_ns_ = steadyClockNs();
+    segment_ = 0;
+    streams_.clear();
+    stream_ids_.clear();
+    streams_bytes_ = 0;
+    stats_ = Stats();
+    open_ = openSegment();
+    return open_;
+}
+
+bool RecordWriter::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+uint32_t RecordWriter::addStream(const RecordStream& stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string key = streamKey(stream);
+    auto it = stream_ids_.find(key);
+    if (it != stream_ids_.end()) {
+        return it->second;
+    }
+    if (!open_ || stream.name.size() > UINT16_MAX || stream.topic.size() > UINT16_MAX) {
+        return UINT32_MAX;
+    }
+
+    // Written here and again in the trailer
+    const size_t frame_size = streamFrameSize(stream);
+    uint8_t* frame = reserve(frame_size, frame_size);
+    if (!frame) {
+        return UINT32_MAX;
+    }
+    const uint32_t id = static_cast<uint32_t>(streams_.size());
+    streams_.push_back(stream);
+    stream_ids_[key] = id;
+    streams_bytes_ += frame_size;
+    writeStream(frame, id, now());
+    return id;
+}
+
+bool RecordWriter::append(uint32_t stream, const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint8_t* frame = nullptr;
+    if (open_ && stream < streams_.size() && size <= UINT32_MAX) {
+        frame = reserve(RecordLayout::frameSize(size), 0);
+    }
+    if (!frame) {
+        stats_.dropped++;
+        return false;
+    }
+
+    const uint64_t time_ns = now();
+    if (index_.empty() || time_ns - index_.back().time_ns >= options_.index_interval_ns) {
+        index_.push_back({time_ns, static_cast<uint64_t>(frame - map_)});
+    }
+    writeFrame(frame, RecordLayout::FRAME_DATA, stream, time_ns, data, size);
+    stats_.frames++;
+    stats_.bytes += size;
+    return true;
+}
+
+void RecordWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_) {
+        closeSegment();
+        open_ = false;
+    }
+}
+
+RecordWriter::Stats RecordWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool RecordWriter::openSegment() {
+    const std::string path = RecordLayout::segmentPath(base_, segment_);
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        NEXUS_ERROR("Recorder") << "Failed to create " << path << ": " << strerror(errno);
+        return false;
+    }
+
+    // Reserve the blocks up front: a full disk fails here, not as SIGBUS on a store into the mapping
+#ifdef __QNXNTO__
+    int rc = ftruncate(fd_, static_cast<off_t>(options_.segment_size)) == 0 ? 0 : errno;
+#else
+    int rc = posix_fallocate(fd_, 0, static_cast<off_t>(options_.segment_size));
+#endif
+    void* addr = MAP_FAILED;
+    if (rc == 0) {
+        addr = mmap(nullptr, options_.segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        rc = addr == MAP_FAILED ? errno : 0;
+    }
+    if (rc != 0) {
+        NEXUS_ERROR("Recorder") << "Failed to map " << options_.segment_size << " bytes for " << path << ": "
+                                << strerror(rc);
+        ::close(fd_);
+        fd_ = -1;
+        unlink(path.c_str());
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(addr, options_.segment_size, MADV_SEQUENTIAL);
+#endif
+
+    map_ = static_cast<uint8_t*>(addr);
+    auto* header = reinterpret_cast<RecordLayout::SegmentHeader*>(map_);
+    std::memset(header, 0, HEADER_SIZE);
+    header->magic = RecordLayout::MAGIC;
+    header->version = RecordLayout::VERSION;
+    header->segment = segment_;
+    header->start_wall_ns = wallClockNs() - now();
+    header->index_interval_ns = options_.index_interval_ns;
+    used_ = HEADER_SIZE;
+    index_.clear();
+
+    // Self-contained: every stream known so far, before the first DATA frame
+    const uint64_t time_ns = now();
+    for (uint32_t id = 0; id < streams_.size(); ++id) {
+        writeStream(map_ + used_, id, time_ns);
+        used_ += streamFrameSize(streams_[id]);
+    }
+    stats_.segments++;
+    return true;
+}
+
+void RecordWriter::closeSegment() {
+    // Trailer: streams, then the index (room for both was kept by reserve())
+    auto* header = reinterpret_cast<RecordLayout::SegmentHeader*>(map_);
+    const size_t trailer_offset = used_;
+    for (uint32_t id = 0; id < streams_.size(); ++id) {
+        writeStream(map_ + used_, id, 0);
+        used_ += streamFrameSize(streams_[id]);
+    }
+    const size_t index_bytes = index_.size() * sizeof(RecordLayout::IndexEntry);
+    writeFrame(map_ + used_, RecordLayout::FRAME_INDEX, 0, 0, index_.data(), index_bytes);
+    used_ += RecordLayout::frameSize(index_bytes);
+    header->trailer_offset = trailer_offset;
+    header->end_offset = used_;
+
+    munmap(map_, options_.segment_size);
+    map_ = nullptr;
+    if (ftruncate(fd_, static_cast<off_t>(used_)) != 0) {
+        NEXUS_WARN("Recorder") << "Failed to truncate segment " << segment_ << ": " << strerror(errno);
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+uint8_t* RecordWriter::reserve(size_t frame_size, size_t trailer_growth) {
+    // The trailer must always fit: every stream frame again, plus the index with one more entry
+    const size_t index_frame = RecordLayout::frameSize((index_.size() + 1) * sizeof(RecordLayout::IndexEntry));
+    if (used_ + frame_size + streams_bytes_ + trailer_growth + index_frame > options_.segment_size) {
+        // Not even an empty segment (streams repeated, no index yet) would hold the frame
+        if (HEADER_SIZE + streams_bytes_ + frame_size + streams_bytes_ + trailer_growth +
+                RecordLayout::frameSize(sizeof(RecordLayout::IndexEntry)) >
+            options_.segment_size) {
+            return nullptr;
+        }
+        closeSegment();
+        segment_++;
+        if (!openSegment()) {
+            open_ = false;
+            return nullptr;
+        }
+    }
+    uint8_t* frame = map_ + used_;
+    used_ += frame_size;
+    return frame;
+}
+
+void RecordWriter::writeFrame(uint8_t* frame, RecordLayout::FrameType type, uint32_t stream, uint64_t time_ns,
+                              const void* data, size_t size) {
+    auto* header = reinterpret_cast<RecordLayout::FrameHeader*>(frame);
+    header->size = static_cast<uint32_t>(size);
+    header->reserved = 0;
+    header->stream = stream;
+    header->reserved2 = 0;
+    header->time_ns = time_ns;
+    if (data && size > 0) {
+        std::memcpy(frame + sizeof(RecordLayout::FrameHeader), data, size);
+    }
+    header->type = type;  // Last: a frame of type 0 ends a segment that was not closed
+}
+
+void RecordWriter::writeStream(uint8_t* frame, uint32_t id, uint64_t time_ns) {
+    const RecordStream& stream = streams_[id];
+    uint8_t* payload = frame + sizeof(RecordLayout::FrameHeader);
+    RecordLayout::StreamRecord record = {};
+    record.kind = stream.kind;
+    record.name_len = static_cast<uint16_t>(stream.name.size());
+    record.topic_len = static_cast<uint16_t>(stream.topic.size());
+    std::memcpy(payload, &record, sizeof(record));
+    std::memcpy(payload + sizeof(record), stream.name.data(), stream.name.size());
+    std::memcpy(payload + sizeof(record) + stream.name.size(), stream.topic.data(), stream.topic.size());
+    // Payload already in place: only the header is left
+    writeFrame(frame, RecordLayout::FRAME_STREAM, id, time_ns, nullptr,
+               sizeof(record) + stream.name.size() + stream.topic.size());
+}
+
+uint64_t RecordWriter::now() const {
+    return steadyClockNs() - start_ns_;
+}
+
+// ============================================================================
+// RecordReader
+// ============================================================================
+
+RecordReader::~RecordReader() {
+    close();
+}
+
+std::vector<std::string> RecordReader::segments(const std::string& base) {
+    std::vector<std::string> paths;
+    struct stat st;
+    for (uint32_t segment = 0;; ++segment) {
+        std::string path = RecordLayout::segmentPath(base, segment);
+        if (stat(path.c_str(), &st) != 0) {
+            return paths;
+        }
+        paths.push_back(std::move(path));
+    }
+}
+
+bool RecordReader::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        map_ = nullptr;
+        close();
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(addr);
+    header_ = reinterpret_cast<const RecordLayout::SegmentHeader*>(map_);
+    if (header_->magic != RecordLayout::MAGIC || header_->version != RecordLayout::VERSION) {
+        close();
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(const_cast<uint8_t*>(map_), size_, MADV_SEQUENTIAL);
+#endif
+
+    if (header_->trailer_offset != 0 && header_->end_offset <= size_ && header_->trailer_offset < header_->end_offset) {
+        // Closed: streams and index from the trailer
+        end_ = header_->end_offset;
+        for (size_t offset = header_->trailer_offset; const RecordLayout::FrameHeader* frame = frameAt(offset);
+             offset += RecordLayout::frameSize(frame->size)) {
+            const uint8_t* payload = reinterpret_cast<const uint8_t*>(frame + 1);
+            if (frame->type == RecordLayout::FRAME_STREAM) {
+                addStream(*frame);
+            } else if (frame->type == RecordLayout::FRAME_INDEX) {
+                const auto* entries = reinterpret_cast<const RecordLayout::IndexEntry*>(payload);
+                index_.assign(entries, entries + frame->size / sizeof(RecordLayout::IndexEntry));
+            }
+        }
+        end_ = header_->trailer_offset;
+    } else {
+        // Not closed (the recorder died): scan up to the first unwritten frame, rebuilding the index
+        end_ = size_;
+        size_t offset = HEADER_SIZE;
+        for (const RecordLayout::FrameHeader* frame; (frame = frameAt(offset)) != nullptr;
+             offset += RecordLayout::frameSize(frame->size)) {
+            if (frame->type == RecordLayout::FRAME_STREAM) {
+                addStream(*frame);
+            } else if (frame->type == RecordLayout::FRAME_DATA &&
+                       (index_.empty() || frame->time_ns - index_.back().time_ns >= header_->index_interval_ns)) {
+                index_.push_back({frame->time_ns, offset});
+            }
+        }
+        end_ = offset;
+    }
+    offset_ = HEADER_SIZE;
+    skip_before_ns_ = 0;
+    return true;
+}
+
+void RecordReader::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), size_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    header_ = nullptr;
+    size_ = end_ = offset_ = 0;
+    streams_.clear();
+    index_.clear();
+}
+
+bool RecordReader::next(Frame& frame) {
+    while (const RecordLayout::FrameHeader* header = frameAt(offset_)) {
+        offset_ += RecordLayout::frameSize(header->size);
+        if (header->type == RecordLayout::FRAME_DATA && header->time_ns >= skip_before_ns_) {
+            frame.stream = header->stream;
+            frame.time_ns = header->time_ns;
+            frame.data = reinterpret_cast<const uint8_t*>(header + 1);
+            frame.size = header->size;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RecordReader::seek(uint64_t time_ns) {
+    offset_ = HEADER_SIZE;
+    for (const auto& entry : index_) {
+        if (entry.time_ns > time_ns) {
+            break;
+        }
+        offset_ = entry.offset;
+    }
+    skip_before_ns_ = time_ns;
+}
+
+const RecordLayout::FrameHeader* RecordReader::frameAt(size_t offset) const {
+    if (!map_ || offset + sizeof(RecordLayout::FrameHeader) > end_) {
+        return nullptr;
+    }
+    const auto* frame = reinterpret_cast<const RecordLayout::FrameHeader*>(map_ + offset);
+    if (frame->type == RecordLayout::FRAME_NONE || offset + RecordLayout::frameSize(frame->size) > end_) {
+        return nullptr;
+    }
+    return frame;
+}
+
+void RecordReader::addStream(const RecordLayout::FrameHeader& frame) {
+    RecordLayout::StreamRecord record;
+    if (frame.size < sizeof(record)) {
+        return;
+    }
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(&frame + 1);
+    std::memcpy(&record, payload, sizeof(record));
+    if (sizeof(record) + record.name_len + record.topic_len > frame.size) {
+        return;
+    }
+    if (frame.stream >= streams_.size()) {
+        streams_.resize(frame.stream + 1);
+    }
+    RecordStream& stream = streams_[frame.stream];
+    stream.kind = static_cast<RecordLayout::StreamKind>(record.kind);
+    const char* text = reinterpret_cast<const char*>(payload + sizeof(record));
+    stream.name.assign(text, record.name_len);
+    stream.topic.assign(text + record.name_len, record.topic_len);
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,130 @@
+#include "nexus/utils/ShmMapping.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "nexus/utils/Logger.h"
+#include "nexus/utils/Numa.h"
+
+namespace Nexus {
+namespace rpc {
+
+namespace {
+// mmap() of @p size bytes at @p offset (at @p fixed_addr when set), then the optional advice
+void* mapWithOptions(void* fixed_addr, int fd, size_t size, off_t offset, int prot, const ShmMapOptions& options) {
+    int flags = MAP_SHARED;
+    if (fixed_addr) {
+        flags |= MAP_FIXED;
+    }
+#ifndef __QNXNTO__
+    if (options.noreserve) {
+        flags |= MAP_NORESERVE;
+    }
+#endif
+
+    // MAP_POPULATE would fault the pages in before the huge page advice or the NUMA policy applies
+    bool touch_pages = options.prefault;
+#ifdef MAP_POPULATE
+    if (options.prefault && !options.huge_pages && options.numa_node < 0) {
+        flags |= MAP_POPULATE;
+        touch_pages = false;
+    }
+#endif
+
+    void* addr = mmap(fixed_addr, size, prot, flags, fd, offset);
+    if (addr == MAP_FAILED) {
+        return addr;
+    }
+
+    // Policy first: prefaulting below (or the first writer later) allocates the pages on that node
+    if (options.numa_node >= 0) {
+        bindMemoryToNumaNode(addr, size, options.numa_node);
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (options.huge_pages && madvise(addr, size, MADV_HUGEPAGE) != 0) {
+        NEXUS_WARN("Shm") << "MADV_HUGEPAGE failed: " << strerror(errno);
+    }
+#endif
+
+    // Read one byte per page: allocates the shmem pages and keeps the contents of an existing segment
+    if (touch_pages) {
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const volatile char* bytes = static_cast<const volatile char*>(addr);
+        for (size_t page = 0; page < size; page += page_size) {
+            (void)bytes[page];
+        }
+    }
+
+    if (options.lock && mlock(addr, size) != 0) {
+        NEXUS_WARN("Shm") << "mlock of " << size << " bytes failed: " << strerror(errno);
+    }
+    return addr;
+}
+}  // namespace
+
+void* mapSharedMemory(int fd, size_t size, int prot, const ShmMapOptions& options) {
+    return mapWithOptions(nullptr, fd, size, 0, prot, options);
+}
+
+void* mapSharedMemoryMirrored(int fd, size_t data_offset, size_t capacity, int prot, const ShmMapOptions& options) {
+    // Reserve the whole address range first so nothing else can land between the two views
+    const size_t total = data_offset + 2 * capacity;
+    void* base = mmap(nullptr, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return base;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(base);
+    if (mapWithOptions(bytes, fd, data_offset + capacity, 0, prot, options) == MAP_FAILED ||
+        mapWithOptions(bytes + data_offset + capacity, fd, capacity, static_cast<off_t>(data_offset), prot,
+                       options) == MAP_FAILED) {
+        int saved_errno = errno;
+        munmap(base, total);
+        errno = saved_errno;
+        return MAP_FAILED;
+    }
+    return base;
+}
+
+MappingUsage mappingUsage(const void* addr, size_t size) {
+    MappingUsage usage;
+    usage.mapped = size;
+    if (!addr || size == 0) {
+        return usage;
+    }
+
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> pages((size + page_size - 1) / page_size);
+    if (mincore(const_cast<void*>(addr), size, pages.data()) != 0) {
+        NEXUS_DEBUG("Shm") << "mincore failed: " << strerror(errno);
+        return usage;
+    }
+    for (unsigned char page : pages) {
+        if (page & 1) {
+            usage.resident += page_size;
+        }
+    }
+    usage.resident = std::min(usage.resident, size);
+    return usage;
+}
+
+size_t processResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+}  // namespace rpc
+}  // namespace Nexus
@@ -0,0 +1,138 @@
+#include "nexus/utils/ThreadPlacement.h"
+
+#include <pthread.h>
+#include <sched.h>
+#ifdef __QNXNTO__
+#include <sys/neutrino.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "nexus/utils/Logger.h"
+
+namespace Nexus {
+namespace rpc {
+
+namespace {
+const char* policyName(SchedPolicy policy) {
+    switch (policy) {
+        case SchedPolicy::OTHER:
+            return "SCHED_OTHER";
+        case SchedPolicy::FIFO:
+            return "SCHED_FIFO";
+        case SchedPolicy::RR:
+            return "SCHED_RR";
+        default:
+            return "inherited";
+    }
+}
+}  // namespace
+
+bool pinCurrentThread(uint64_t mask, const std::string& role) {
+#ifdef __QNXNTO__
+    if (ThreadCtl(_NTO_TCTL_RUNMASK, reinterpret_cast<void*>(static_cast<uintptr_t>(mask))) == -1) {
+        NEXUS_WARN("Thread") << "Failed to pin " << role << " thread to CPU mask 0x" << std::hex << mask << std::dec
+                             << ": " << strerror(errno);
+        return false;
+    }
+#else
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < 64; ++cpu) {
+        if (mask & (uint64_t(1) << cpu)) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (rc != 0) {
+        NEXUS_WARN("Thread") << "Failed to pin " << role << " thread to CPU mask 0x" << std::hex << mask << std::dec
+                             << ": " << strerror(rc);
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool applyThreadPlacement(const ThreadPlacement& placement, const std::string& role) {
+    bool applied = true;
+    if (placement.cpu_mask != 0) {
+        applied = pinCurrentThread(placement.cpu_mask, role);
+    }
+    if (placement.policy == SchedPolicy::INHERIT) {
+        return applied;
+    }
+
+    int policy = SCHED_OTHER;
+    sched_param param{};
+    if (placement.policy == SchedPolicy::FIFO || placement.policy == SchedPolicy::RR) {
+        policy = placement.policy == SchedPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        param.sched_priority = std::min(std::max(placement.priority, sched_get_priority_min(policy)),
+                                        sched_get_priority_max(policy));
+    }
+#ifdef __QNXNTO__
+    else {
+        param.sched_priority = getprio(0);  // SCHED_OTHER keeps the thread's priority on QNX
+    }
+#endif
+    const int rc = pthread_setschedparam(pthread_self(), policy, &param);
+    if (rc != 0) {
+        // Typically EPERM without CAP_SYS_NICE / RLIMIT_RTPRIO: keep the current scheduling
+        NEXUS_WARN("Thread") << "Failed to set " << policyName(placement.policy) << " priority "
+                             << param.sched_priority << " for " << role << " thread: " << strerror(rc);
+        return false;
+    }
+    return applied;
+}
+
+uint64_t parseCpuSet(const std::string& set) {
+    uint64_t mask = 0;
+    std::istringstream cpus_stream(set);
+    std::string range;
+    while (std::getline(cpus_stream, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = std::max(first, 0); cpu <= last && cpu < 64; ++cpu) {
+            mask |= uint64_t(1) << cpu;
+        }
+    }
+    return mask;
+}
+
+bool parseThreadPlacement(const std::string& spec, ThreadPlacement& placement) {
+    const size_t at = spec.find('@');
+    const std::string scheduling = spec.substr(0, at);
+    const size_t colon = scheduling.find(':');
+    const std::string name = scheduling.substr(0, colon);
+
+    ThreadPlacement parsed;
+    if (name.empty() || name == "inherit") {
+        parsed.policy = SchedPolicy::INHERIT;
+    } else if (name == "other") {
+        parsed.policy = SchedPolicy::OTHER;
+    } else if (name == "fifo") {
+        parsed.policy = SchedPolicy::FIFO;
+    } else if (name == "rr") {
+        parsed.policy = SchedPolicy::RR;
+    } else {
+        return false;
+    }
+    if (colon != std::string::npos) {
+        parsed.priority = std::atoi(scheduling.c_str() + colon + 1);
+    }
+    if (at != std::string::npos) {
+        parsed.cpu_mask = parseCpuSet(spec.substr(at + 1));
+    }
+    placement = parsed;
+    return true;
+}
+
+}  // namespace rpc
+}  // namespace Nexus
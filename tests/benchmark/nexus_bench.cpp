@@ -0,0 +1,727 @@
+/**
+ * @file nexus_bench.cpp
+ * @brief Latency/throughput benchmark for the in-process, SHM, UDP and LargeDataChannel paths
+ *
+ * Every case (path × message size × publishers × subscribers) runs in this
+ * process. Publishers stamp each payload with a sequence number and the send
+ * time (steady_clock); subscribers record the one-way latency into a
+ * log-linear histogram. Publishers keep at most a window of messages in
+ * flight, so memory stays bounded for large payloads and the latency is the
+ * one seen at the sustained throughput, not the depth of an ever-growing
+ * queue.
+ *
+ * Usage: nexus_bench [--paths inproc,shm-cv,shm-sem,shm-poll,udp,large]
+ *                    [--sizes 16,1K,64K,8M] [--publishers 1,2] [--subscribers 1,4]
+ *                    [--messages N] [--max-bytes N] [--warmup N] [--window N]
+ *                    [--format text|csv|json] [--output FILE]
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexus/core/Node.h"
+#include "nexus/transport/LargeDataChannel.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
+#include "nexus/transport/UdpTransport.h"
+#include "nexus/utils/Logger.h"
+
+using namespace Nexus::rpc;
+
+namespace {
+
+// Payload header: [0, 8) sequence (below 2^48, so byte 6 - the SHM frame type - stays DATA), [8, 16) send time
+constexpr size_t STAMP_BYTES = 16;
+constexpr uint64_t IDLE_TIMEOUT_MS = 2000;  // A case ends once no message arrived for this long
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Log-linear latency histogram (HdrHistogram bucket layout)
+ *
+ * Values below 2^SUB_BITS have their own bucket; above that each power of two
+ * is split into 2^SUB_BITS buckets, so a percentile is within 1% of the true
+ * value at any magnitude with a fixed 58 KB of counters.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() : counts_(BUCKETS, 0) {}
+
+    void record(uint64_t value) {
+        counts_[index(value)]++;
+        total_++;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    /// Value at @p percentile (0-100): the middle of its bucket, clamped to the recorded range
+    uint64_t percentile(double percentile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                const uint64_t middle = lowerBound(i) + (lowerBound(i + 1) - lowerBound(i)) / 2;
+                return std::min(std::max(middle, min_), max_);
+            }
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_) / total_ : 0.0; }
+
+private:
+    static constexpr int SUB_BITS = 7;
+    static constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static size_t index(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const int magnitude = 63 - __builtin_clzll(value);  // >= SUB_BITS
+        const uint64_t sub = (value >> (magnitude - SUB_BITS)) - SUB_BUCKETS;
+        return static_cast<size_t>((magnitude - SUB_BITS + 1) * SUB_BUCKETS + sub);
+    }
+
+    static uint64_t lowerBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const int magnitude = static_cast<int>(index / SUB_BUCKETS) + SUB_BITS - 1;
+        return (SUB_BUCKETS + index % SUB_BUCKETS) << (magnitude - SUB_BITS);
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+constexpr int LatencyHistogram::SUB_BITS;
+constexpr uint64_t LatencyHistogram::SUB_BUCKETS;
+constexpr size_t LatencyHistogram::BUCKETS;
+
+struct BenchOptions {
+    std::vector<std::string> paths = {"inproc", "shm-cv", "shm-sem", "shm-poll", "udp", "large"};
+    std::vector<size_t> sizes = {16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 8388608};
+    std::vector<int> publishers = {1};
+    std::vector<int> subscribers = {1};
+    uint64_t messages = 20000;                  // Per publisher (capped by max_bytes)
+    uint64_t max_bytes = 512ull * 1024 * 1024;  // Per publisher and case
+    uint64_t warmup = 100;                      // Leading messages per publisher left out of the histogram
+    uint64_t window = 0;                        // Messages in flight per subscriber (0: from the size)
+    std::string format = "text";
+    std::string output;
+};
+
+struct CaseResult {
+    std::string path;
+    size_t size = 0;
+    int publishers = 0;
+    int subscribers = 0;
+    uint64_t expected = 0;  // Deliveries: messages × publishers × subscribers
+    uint64_t received = 0;
+    double seconds = 0.0;
+    LatencyHistogram latency;  // Nanoseconds
+};
+
+// One subscriber's histogram; a subscriber may be called from several threads (in-process publishers)
+struct SubscriberStats {
+    std::mutex mutex;
+    LatencyHistogram histogram;
+};
+
+// State shared by the publishers and subscribers of one case
+struct CaseState {
+    size_t size = 0;
+    int publishers = 0;
+    int subscribers = 0;
+    uint64_t messages = 0;
+    uint64_t warmup = 0;
+    uint64_t window = 0;
+    std::atomic<uint64_t> published{0};  // Sends (each reaches every subscriber)
+    std::atomic<uint64_t> received{0};   // Deliveries
+    std::atomic<int64_t> first_send_ns{0};
+    std::atomic<int64_t> last_receive_ns{0};
+    std::vector<std::unique_ptr<SubscriberStats>> stats;
+
+    uint64_t expected() const { return messages * publishers * subscribers; }
+};
+
+void record(CaseState& state, SubscriberStats& stats, const uint8_t* data, size_t size) {
+    if (size < STAMP_BYTES) {
+        return;
+    }
+    const int64_t now = nowNs();
+    uint64_t sequence;
+    int64_t sent;
+    std::memcpy(&sequence, data, sizeof(sequence));
+    std::memcpy(&sent, data + sizeof(sequence), sizeof(sent));
+    if (sequence >= state.warmup) {
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        stats.histogram.record(static_cast<uint64_t>(std::max<int64_t>(0, now - sent)));
+    }
+    state.last_receive_ns.store(now, std::memory_order_relaxed);
+    state.received.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Wait until at most window × subscribers deliveries are outstanding; lossy paths give up after a stall
+void waitForWindow(CaseState& state) {
+    const uint64_t limit = state.window * state.subscribers;
+    uint64_t last_received = state.received.load(std::memory_order_relaxed);
+    int64_t stall_start = nowNs();
+    while (true) {
+        const uint64_t received = state.received.load(std::memory_order_relaxed);
+        const uint64_t outstanding = state.published.load(std::memory_order_relaxed) * state.subscribers - received;
+        if (outstanding <= limit) {
+            return;
+        }
+        if (received != last_received) {
+            last_received = received;
+            stall_start = nowNs();
+        } else if (nowNs() - stall_start > 50 * 1000000LL) {
+            return;  // Nothing arrives: the rest of the window was lost
+        }
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Run the publishers of a case and wait for the deliveries
+ * @param send Sends one stamped payload for publisher @p index; false to retry (queue full)
+ */
+void runPublishers(CaseState& state, const std::function<bool(int index, const uint8_t* data, size_t size)>& send) {
+    state.first_send_ns.store(nowNs());
+    std::vector<std::thread> threads;
+    for (int p = 0; p < state.publishers; ++p) {
+        threads.emplace_back([&state, &send, p]() {
+            std::vector<uint8_t> payload(state.size);
+            for (size_t i = STAMP_BYTES; i < payload.size(); ++i) {
+                payload[i] = static_cast<uint8_t>(i * 31 + p);  // Not all zeros: no path gets to skip work
+            }
+            for (uint64_t sequence = 0; sequence < state.messages; ++sequence) {
+                waitForWindow(state);
+                std::memcpy(payload.data(), &sequence, sizeof(sequence));
+                const int64_t deadline = nowNs() + IDLE_TIMEOUT_MS * 1000000LL;
+                while (true) {
+                    const int64_t sent = nowNs();
+                    std::memcpy(payload.data() + sizeof(sequence), &sent, sizeof(sent));
+                    if (send(p, payload.data(), payload.size()) || sent > deadline) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                state.published.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Drain: every delivery, or nothing new for IDLE_TIMEOUT_MS (lossy paths)
+    uint64_t last_received = state.received.load();
+    int64_t idle_since = nowNs();
+    while (state.received.load() < state.expected()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const uint64_t received = state.received.load();
+        if (received != last_received) {
+            last_received = received;
+            idle_since = nowNs();
+        } else if (nowNs() - idle_since > static_cast<int64_t>(IDLE_TIMEOUT_MS) * 1000000LL) {
+            break;
+        }
+    }
+}
+
+std::string benchId(const std::string& role, int index) {
+    return "nxb" + std::to_string(getpid()) + role + std::to_string(index);
+}
+
+// ==================== Paths ====================
+
+// Node API between nodes of this process (in-process queues, no transport)
+void runInProcess(CaseState& state) {
+    std::vector<std::shared_ptr<Node>> subscribers;
+    for (int s = 0; s < state.subscribers; ++s) {
+        auto node = createNode(benchId("is", s));
+        SubscriberStats* stats = state.stats[s].get();
+        node->subscribe("nexus_bench", {"data"},
+                        [&state, stats](const Node::Property&, const Node::Property&, const uint8_t* data,
+                                        size_t size) { record(state, *stats, data, size); });
+        subscribers.push_back(node);
+    }
+    std::vector<std::shared_ptr<Node>> publishers;
+    for (int p = 0; p < state.publishers; ++p) {
+        publishers.push_back(createNode(benchId("ip", p)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Subscriptions reach the publishers
+
+    runPublishers(state, [&publishers](int index, const uint8_t* data, size_t size) {
+        return publishers[index]->publish("nexus_bench", "data", data, size) != Node::QUEUE_FULL;
+    });
+}
+
+// SharedMemoryTransportV3 frames, every publisher to every subscriber
+void runSharedMemory(CaseState& state, SharedMemoryTransportV3::NotifyMechanism mechanism) {
+    SharedMemoryTransportV3::Config config;
+    config.notify_mechanism = mechanism;
+
+    std::vector<std::unique_ptr<SharedMemoryTransportV3>> subscribers;
+    std::vector<std::string> subscriber_ids;
+    for (int s = 0; s < state.subscribers; ++s) {
+        std::unique_ptr<SharedMemoryTransportV3> transport(new SharedMemoryTransportV3());
+        subscriber_ids.push_back(benchId("ss", s));
+        if (!transport->initialize(subscriber_ids.back(), config)) {
+            std::cerr << "SHM subscriber initialization failed\n";
+            return;
+        }
+        SubscriberStats* stats = state.stats[s].get();
+        transport->setReceiveCallback([&state, stats](const uint8_t* data, size_t size, const std::string&) {
+            record(state, *stats, data, size);
+        });
+        transport->startReceiving();
+        subscribers.push_back(std::move(transport));
+    }
+    std::vector<std::unique_ptr<SharedMemoryTransportV3>> publishers;
+    for (int p = 0; p < state.publishers; ++p) {
+        std::unique_ptr<SharedMemoryTransportV3> transport(new SharedMemoryTransportV3());
+        if (!transport->initialize(benchId("sp", p), config)) {
+            std::cerr << "SHM publisher initialization failed\n";
+            return;
+        }
+        publishers.push_back(std::move(transport));
+    }
+
+    // A frame that does not fit one subscriber is retried for that subscriber only
+    std::vector<std::vector<bool>> pending(state.publishers, std::vector<bool>(state.subscribers));
+    std::vector<uint64_t> current(state.publishers, UINT64_MAX);  // Sequence pending[] belongs to
+    runPublishers(state, [&](int index, const uint8_t* data, size_t size) {
+        uint64_t sequence;
+        std::memcpy(&sequence, data, sizeof(sequence));
+        if (sequence != current[index]) {
+            current[index] = sequence;
+            std::fill(pending[index].begin(), pending[index].end(), true);
+        }
+        bool all_sent = true;
+        for (int s = 0; s < state.subscribers; ++s) {
+            if (pending[index][s]) {
+                pending[index][s] = !publishers[index]->send(subscriber_ids[s], data, size);
+                all_sent = all_sent && !pending[index][s];
+            }
+        }
+        return all_sent;
+    });
+
+    for (auto& subscriber : subscribers) {
+        subscriber->stopReceiving();
+    }
+}
+
+// UdpTransport datagrams over loopback (lossy: drops are reported, not retried)
+void runUdp(CaseState& state) {
+    std::vector<std::unique_ptr<UdpTransport>> subscribers;
+    std::vector<sockaddr_in> destinations;
+    for (int s = 0; s < state.subscribers; ++s) {
+        std::unique_ptr<UdpTransport> transport(new UdpTransport());
+        if (!transport->initialize(0)) {
+            std::cerr << "UDP subscriber initialization failed\n";
+            return;
+        }
+        SubscriberStats* stats = state.stats[s].get();
+        transport->setReceiveCallback([&state, stats](const uint8_t* data, size_t size, const sockaddr_in&) {
+            record(state, *stats, data, size);
+        });
+        sockaddr_in destination;
+        std::memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(transport->getPort());
+        destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        destinations.push_back(destination);
+        subscribers.push_back(std::move(transport));
+    }
+    std::vector<std::unique_ptr<UdpTransport>> publishers;
+    for (int p = 0; p < state.publishers; ++p) {
+        std::unique_ptr<UdpTransport> transport(new UdpTransport());
+        if (!transport->initialize(0)) {
+            std::cerr << "UDP publisher initialization failed\n";
+            return;
+        }
+        publishers.push_back(std::move(transport));
+    }
+
+    runPublishers(state, [&](int index, const uint8_t* data, size_t size) {
+        for (const auto& destination : destinations) {
+            publishers[index]->sendTo(data, size, destination);
+        }
+        return true;
+    });
+
+    for (auto& subscriber : subscribers) {
+        subscriber->shutdown();
+    }
+}
+
+// LargeDataChannel: one channel per publisher, every subscriber reads all of them
+void runLargeData(CaseState& state) {
+    LargeDataChannel::Config config;
+    config.max_block_size = std::max(config.max_block_size, state.size);
+    config.buffer_size = std::max(config.buffer_size, 4 * (state.size + 4096));
+    config.max_readers = std::max<size_t>(config.max_readers, state.subscribers);
+    config.overflow_policy = LargeDataOverflowPolicy::BLOCK;  // Back-pressure instead of dropped blocks
+
+    std::vector<std::shared_ptr<LargeDataChannel>> writers;
+    std::vector<std::string> names;
+    for (int p = 0; p < state.publishers; ++p) {
+        names.push_back(benchId("lc", p));
+        auto writer = LargeDataChannel::create(names.back(), config);
+        if (!writer) {
+            std::cerr << "LargeDataChannel creation failed\n";
+            return;
+        }
+        writers.push_back(writer);
+    }
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> readers;
+    for (int s = 0; s < state.subscribers; ++s) {
+        std::vector<std::shared_ptr<LargeDataChannel>> channels;
+        for (const auto& name : names) {
+            auto reader = LargeDataChannel::create(name, config);
+            LargeDataChannel::DataBlock block;
+            reader->tryRead(block);  // Registers the reader before the first block
+            channels.push_back(reader);
+        }
+        SubscriberStats* stats = state.stats[s].get();
+        readers.emplace_back([&state, &running, stats, channels]() {
+            while (running.load(std::memory_order_relaxed)) {
+                bool any = false;
+                for (const auto& channel : channels) {
+                    LargeDataChannel::DataBlock block;
+                    while (channel->tryRead(block)) {
+                        record(state, *stats, block.data, block.size);
+                        channel->releaseBlock(block);
+                        any = true;
+                    }
+                }
+                if (!any) {
+                    if (channels.size() == 1) {
+                        channels.front()->waitForData(1);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    runPublishers(state, [&writers](int index, const uint8_t* data, size_t size) {
+        return writers[index]->write("data", data, size) >= 0;
+    });
+
+    running.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+}
+
+// Largest payload a path carries in one message (0: unknown path)
+size_t maxPayload(const std::string& path) {
+    if (path == "inproc" || path == "large") {
+        return 8 * 1024 * 1024;
+    }
+    if (path.compare(0, 4, "shm-") == 0) {
+        return SharedMemoryTransportV3::DATA_QUEUE_SIZE_BYTES / 4 - 8;  // Largest frame of a data lane
+    }
+    if (path == "udp") {
+        return 65507;  // One IPv4 datagram
+    }
+    return 0;
+}
+
+bool runCase(const BenchOptions& options, const std::string& path, size_t size, int publishers, int subscribers,
+             CaseResult& result) {
+    CaseState state;
+    state.size = size;
+    state.publishers = publishers;
+    state.subscribers = subscribers;
+    state.messages = std::max<uint64_t>(1, std::min<uint64_t>(options.messages, options.max_bytes / size));
+    state.warmup = std::min(options.warmup, state.messages / 10);
+    state.window = options.window ? options.window
+                                  : std::max<uint64_t>(4, std::min<uint64_t>(1024, (64ull * 1024 * 1024) / size));
+    for (int s = 0; s < subscribers; ++s) {
+        state.stats.emplace_back(new SubscriberStats());
+    }
+
+    if (path == "inproc") {
+        runInProcess(state);
+    } else if (path == "shm-cv") {
+        runSharedMemory(state, SharedMemoryTransportV3::NotifyMechanism::CONDITION_VARIABLE);
+    } else if (path == "shm-sem") {
+        runSharedMemory(state, SharedMemoryTransportV3::NotifyMechanism::SEMAPHORE);
+    } else if (path == "shm-poll") {
+        runSharedMemory(state, SharedMemoryTransportV3::NotifyMechanism::SMART_POLLING);
+    } else if (path == "udp") {
+        runUdp(state);
+    } else if (path == "large") {
+        runLargeData(state);
+    } else {
+        return false;
+    }
+
+    result.path = path;
+    result.size = size;
+    result.publishers = publishers;
+    result.subscribers = subscribers;
+    result.expected = state.expected();
+    result.received = state.received.load();
+    result.seconds = std::max<int64_t>(1, state.last_receive_ns.load() - state.first_send_ns.load()) / 1e9;
+    for (const auto& stats : state.stats) {
+        result.latency.merge(stats->histogram);
+    }
+    return true;
+}
+
+// ==================== Output ====================
+
+double micros(uint64_t ns) {
+    return ns / 1000.0;
+}
+
+void writeText(std::ostream& out, const std::vector<CaseResult>& results) {
+    out << std::left << std::setw(9) << "path" << std::right << std::setw(9) << "size" << std::setw(5) << "pub"
+        << std::setw(5) << "sub" << std::setw(12) << "msg/s" << std::setw(10) << "MB/s" << std::setw(8) << "loss%"
+        << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(11) << "p99.9 us" << std::setw(11)
+        << "max us" << "\n";
+    out << std::fixed;
+    for (const auto& r : results) {
+        const double rate = r.received / r.seconds;
+        const double loss = r.expected ? 100.0 * (r.expected - r.received) / r.expected : 0.0;
+        out << std::left << std::setw(9) << r.path << std::right << std::setw(9) << r.size << std::setw(5)
+            << r.publishers << std::setw(5) << r.subscribers << std::setprecision(0) << std::setw(12) << rate
+            << std::setprecision(1) << std::setw(10) << rate * r.size / (1024.0 * 1024.0) << std::setprecision(2)
+            << std::setw(8) << loss << std::setprecision(1) << std::setw(10) << micros(r.latency.percentile(50))
+            << std::setw(10) << micros(r.latency.percentile(99)) << std::setw(11)
+            << micros(r.latency.percentile(99.9)) << std::setw(11) << micros(r.latency.max()) << "\n";
+    }
+}
+
+void writeCsv(std::ostream& out, const std::vector<CaseResult>& results) {
+    out << "path,size,publishers,subscribers,expected,received,seconds,msgs_per_sec,mb_per_sec,"
+           "min_us,mean_us,p50_us,p99_us,p999_us,max_us\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : results) {
+        const double rate = r.received / r.seconds;
+        out << r.path << "," << r.size << "," << r.publishers << "," << r.subscribers << "," << r.expected << ","
+            << r.received << "," << r.seconds << "," << rate << "," << rate * r.size / (1024.0 * 1024.0) << ","
+            << micros(r.latency.min()) << "," << r.latency.mean() / 1000.0 << "," << micros(r.latency.percentile(50))
+            << "," << micros(r.latency.percentile(99)) << "," << micros(r.latency.percentile(99.9)) << ","
+            << micros(r.latency.max()) << "\n";
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<CaseResult>& results) {
+    out << std::fixed << std::setprecision(3) << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CaseResult& r = results[i];
+        const double rate = r.received / r.seconds;
+        out << "  {\"path\": \"" << r.path << "\", \"size\": " << r.size << ", \"publishers\": " << r.publishers
+            << ", \"subscribers\": " << r.subscribers << ", \"expected\": " << r.expected
+            << ", \"received\": " << r.received << ", \"seconds\": " << r.seconds << ", \"msgs_per_sec\": " << rate
+            << ", \"mb_per_sec\": " << rate * r.size / (1024.0 * 1024.0) << ", \"latency_us\": {\"min\": "
+            << micros(r.latency.min()) << ", \"mean\": " << r.latency.mean() / 1000.0
+            << ", \"p50\": " << micros(r.latency.percentile(50)) << ", \"p99\": " << micros(r.latency.percentile(99))
+            << ", \"p99.9\": " << micros(r.latency.percentile(99.9)) << ", \"max\": " << micros(r.latency.max())
+            << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// ==================== Command line ====================
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// "4096", "4K", "8M"
+bool parseSize(const std::string& text, uint64_t& value) {
+    char* end = nullptr;
+    const unsigned long long number = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) {
+        return false;
+    }
+    uint64_t scale = 1;
+    if (*end == 'K' || *end == 'k') {
+        scale = 1024;
+        ++end;
+    } else if (*end == 'M' || *end == 'm') {
+        scale = 1024 * 1024;
+        ++end;
+    }
+    value = number * scale;
+    return *end == '\0';
+}
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --paths LIST        inproc,shm-cv,shm-sem,shm-poll,udp,large (default: all)\n"
+              << "  --sizes LIST        Payload sizes, K/M suffixes allowed (default: 16 to 8M)\n"
+              << "  --publishers LIST   Publisher counts to sweep (default: 1)\n"
+              << "  --subscribers LIST  Subscriber counts to sweep (default: 1)\n"
+              << "  --messages N        Messages per publisher (default: 20000)\n"
+              << "  --max-bytes N       Cap on bytes per publisher and case (default: 512M)\n"
+              << "  --warmup N          Leading messages left out of the latency (default: 100)\n"
+              << "  --window N          Messages in flight per subscriber (default: from the size)\n"
+              << "  --format FORMAT     text, csv or json (default: text)\n"
+              << "  --output FILE       Write the results to FILE instead of stdout\n";
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        uint64_t number = 0;
+        if (arg == "--paths") {
+            options.paths = splitList(value);
+        } else if (arg == "--sizes" || arg == "--publishers" || arg == "--subscribers") {
+            std::vector<uint64_t> numbers;
+            for (const auto& item : splitList(value)) {
+                if (!parseSize(item, number) || number == 0) {
+                    return false;
+                }
+                numbers.push_back(number);
+            }
+            if (arg == "--sizes") {
+                options.sizes.clear();
+                for (uint64_t size : numbers) {
+                    options.sizes.push_back(std::max<size_t>(size, STAMP_BYTES));
+                }
+            } else {
+                auto& counts = arg == "--publishers" ? options.publishers : options.subscribers;
+                counts.assign(numbers.begin(), numbers.end());
+            }
+        } else if (arg == "--messages" || arg == "--max-bytes" || arg == "--warmup" || arg == "--window") {
+            if (!parseSize(value, number)) {
+                return false;
+            }
+            (arg == "--messages"    ? options.messages
+             : arg == "--max-bytes" ? options.max_bytes
+             : arg == "--warmup"    ? options.warmup
+                                    : options.window) = number;
+        } else if (arg == "--format" && (value == "text" || value == "csv" || value == "json")) {
+            options.format = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    for (const auto& path : options.paths) {
+        if (maxPayload(path) == 0) {
+            std::cerr << "Unknown path: " << path << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!std::getenv("NEXUS_LOG_LEVEL")) {
+        Logger::instance().setLevel(Logger::Level::ERROR);
+    }
+
+    std::vector<CaseResult> results;
+    for (const auto& path : options.paths) {
+        for (size_t size : options.sizes) {
+            if (size > maxPayload(path)) {
+                std::cerr << "skip " << path << " " << size << "B (largest payload " << maxPayload(path) << "B)\n";
+                continue;
+            }
+            for (int publishers : options.publishers) {
+                for (int subscribers : options.subscribers) {
+                    CaseResult result;
+                    std::cerr << "run  " << path << " " << size << "B " << publishers << "x" << subscribers << "\n";
+                    if (runCase(options, path, size, publishers, subscribers, result)) {
+                        results.push_back(std::move(result));
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Cannot write " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    if (options.format == "csv") {
+        writeCsv(out, results);
+    } else if (options.format == "json") {
+        writeJson(out, results);
+    } else {
+        writeText(out, results);
+    }
+    return 0;
+}
@@ -0,0 +1,644 @@
+/**
+ * @file notify_perf.cpp
+ * @brief Multi-process comparison of the shared memory notify mechanisms, checked against baselines
+ *
+ * For each SharedMemoryTransportV3::NotifyMechanism, separate processes run:
+ *  - pingpong: a ping goes out again from the receive callback as soon as the
+ *    echo comes back; half the round trip is the wakeup latency (P50/P99)
+ *  - fanout:   one sender streams frames to several receiver processes as fast
+ *    as credit allows; throughput and the receivers' CPU usage while busy
+ *  - idle:     a receiver with no traffic; its CPU usage is the cost of waiting
+ *
+ * Every metric is compared with the baseline file (one "name baseline
+ * relative_tolerance absolute_tolerance" line each). Metrics ending in
+ * "_per_s" must not fall below baseline - allowance, the others must not
+ * exceed baseline + allowance, where allowance = baseline * relative +
+ * absolute. A regression makes the exit code 1. --update-baseline rewrites
+ * the baselines with the measured values, keeping the tolerances.
+ *
+ * Usage: notify_perf [--mechanisms cv,sem,poll] [--baseline FILE] [--update-baseline]
+ *                    [--pings N] [--messages N] [--receivers N] [--output FILE]
+ */
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexus/transport/SharedMemoryTransportV3.h"
+#include "nexus/utils/Logger.h"
+
+using namespace Nexus::rpc;
+using Mechanism = SharedMemoryTransportV3::NotifyMechanism;
+
+namespace {
+
+constexpr size_t FRAME_BYTES = 64;
+constexpr size_t WARMUP_PINGS = 100;
+constexpr int IDLE_MS = 1000;
+constexpr int CHILD_TIMEOUT_MS = 20000;  // A scenario fails if a child does not report within this time
+constexpr uint8_t END_MARK = 0xEE;       // First byte of the frame that ends a fanout stream
+
+struct PerfOptions {
+    std::vector<std::string> mechanisms = {"cv", "sem", "poll"};
+    std::string baseline;
+    bool update_baseline = false;
+    size_t pings = 2000;
+    size_t messages = 50000;  // Per receiver
+    int receivers = 3;
+    std::string output;
+};
+
+// What a child writes to its pipe when done
+struct ChildReport {
+    uint64_t received;
+    uint64_t cpu_us;        // CPU time of the measured phase
+    uint64_t wall_us;       // Duration of the measured phase
+    uint64_t last_recv_ns;  // CLOCK_MONOTONIC of the last frame (system-wide, comparable across processes)
+};
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t cpuUs() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ull +
+           static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+bool parseMechanism(const std::string& name, Mechanism& mechanism) {
+    if (name == "cv") {
+        mechanism = Mechanism::CONDITION_VARIABLE;
+    } else if (name == "sem") {
+        mechanism = Mechanism::SEMAPHORE;
+    } else if (name == "poll") {
+        mechanism = Mechanism::SMART_POLLING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string perfId(const std::string& role, int index) {
+    return "nexus_perf_" + role + std::to_string(index) + "_" + std::to_string(getpid());
+}
+
+// ---------------------------------------------------------------------------
+// Child processes: a transport of their own, ready byte, then one ChildReport
+
+class Child {
+public:
+    // Re-executes this program as "--child ROLE MECHANISM ID FD"; the child reports through the pipe
+    bool start(const std::string& role, const std::string& mechanism, const std::string& id) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        pid_ = fork();
+        if (pid_ < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        if (pid_ == 0) {
+            // Exec right away: the parent's transports may have left threads (and their locks) behind
+            close(fds[0]);
+            const std::string fd = std::to_string(fds[1]);
+            execl("/proc/self/exe", "notify_perf", "--child", role.c_str(), mechanism.c_str(), id.c_str(), fd.c_str(),
+                  static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(fds[1]);
+        fd_ = fds[0];
+        return true;
+    }
+
+    ~Child() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+        if (pid_ > 0) {
+            if (!reported_) {
+                kill(pid_, SIGKILL);
+            }
+            waitpid(pid_, nullptr, 0);  // A child that reported is only tearing its transport down
+        }
+    }
+
+    bool waitReady() {
+        char ready = 0;
+        return readFully(&ready, sizeof(ready));
+    }
+
+    bool waitReport(ChildReport& report) {
+        reported_ = readFully(&report, sizeof(report));
+        return reported_;
+    }
+
+private:
+    bool readFully(void* buffer, size_t size) {
+        uint8_t* out = static_cast<uint8_t*>(buffer);
+        size_t done = 0;
+        while (done < size) {
+            pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, CHILD_TIMEOUT_MS) <= 0) {
+                return false;
+            }
+            ssize_t n = read(fd_, out + done, size - done);
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    pid_t pid_ = -1;
+    int fd_ = -1;
+    bool reported_ = false;
+};
+
+bool writeFully(int fd, const void* data, size_t size) {
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, in, size);
+        if (n <= 0) {
+            return false;
+        }
+        in += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool signalReady(int fd) {
+    const char ready = 1;
+    return writeFully(fd, &ready, sizeof(ready));
+}
+
+// Sends until the receiver has credit (blocking sends give up after one backoff)
+void sendRetrying(SharedMemoryTransportV3& transport, const std::string& dest, const uint8_t* data, size_t size) {
+    while (!transport.send(dest, data, size)) {
+        std::this_thread::yield();
+    }
+}
+
+
+// Child: echoes every frame back to its sender until END_MARK
+bool childEcho(const std::string& id, const SharedMemoryTransportV3::Config& config, int fd) {
+    SharedMemoryTransportV3 transport;
+    if (!transport.initialize(id, config)) {
+        return false;
+    }
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    transport.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string& from) {
+        if (size > 0 && data[0] == END_MARK) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            done_cv.notify_all();
+            return;
+        }
+        sendRetrying(transport, from, data, size);
+    });
+    transport.startReceiving();
+    if (!signalReady(fd)) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait_for(lock, std::chrono::milliseconds(CHILD_TIMEOUT_MS), [&] { return done; });
+    }
+    transport.stopReceiving();
+    ChildReport report = {};
+    return writeFully(fd, &report, sizeof(report));
+}
+
+// Child: counts frames until END_MARK; CPU and wall time are taken from the first frame on
+bool childSink(const std::string& id, const SharedMemoryTransportV3::Config& config, int fd) {
+    SharedMemoryTransportV3 transport;
+    if (!transport.initialize(id, config)) {
+        return false;
+    }
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    ChildReport report = {};
+    uint64_t first_ns = 0;
+    uint64_t first_cpu = 0;
+    transport.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        const uint64_t now = monotonicNs();
+        if (first_ns == 0) {
+            first_ns = now;
+            first_cpu = cpuUs();
+        }
+        if (size > 0 && data[0] == END_MARK) {
+            report.cpu_us = cpuUs() - first_cpu;
+            report.wall_us = (now - first_ns) / 1000;
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            done_cv.notify_all();
+            return;
+        }
+        report.received++;
+        report.last_recv_ns = now;
+    });
+    transport.startReceiving();
+    if (!signalReady(fd)) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!done_cv.wait_for(lock, std::chrono::milliseconds(CHILD_TIMEOUT_MS), [&] { return done; })) {
+            return false;
+        }
+    }
+    transport.stopReceiving();
+    return writeFully(fd, &report, sizeof(report));
+}
+
+// Child: a receiver without traffic; reports its CPU time over IDLE_MS
+bool childIdle(const std::string& id, const SharedMemoryTransportV3::Config& config, int fd) {
+    SharedMemoryTransportV3 transport;
+    if (!transport.initialize(id, config)) {
+        return false;
+    }
+    transport.setReceiveCallback([](const uint8_t*, size_t, const std::string&) {});
+    transport.startReceiving();
+    if (!signalReady(fd)) {
+        return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Receive threads settle
+    ChildReport report = {};
+    const uint64_t cpu_start = cpuUs();
+    const uint64_t wall_start = monotonicNs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_MS));
+    report.cpu_us = cpuUs() - cpu_start;
+    report.wall_us = (monotonicNs() - wall_start) / 1000;
+    transport.stopReceiving();
+    return writeFully(fd, &report, sizeof(report));
+}
+
+int childMain(const std::string& role, const std::string& mechanism, const std::string& id, int fd) {
+    SharedMemoryTransportV3::Config config;
+    if (!parseMechanism(mechanism, config.notify_mechanism)) {
+        return 2;
+    }
+    bool ok = false;
+    if (role == "echo") {
+        ok = childEcho(id, config, fd);
+    } else if (role == "sink") {
+        ok = childSink(id, config, fd);
+    } else if (role == "idle") {
+        ok = childIdle(id, config, fd);
+    }
+    close(fd);
+    return ok ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios (parent side); each adds "<mechanism>.<metric>" entries to @p metrics
+
+using Metrics = std::map<std::string, double>;
+
+double percentile(std::vector<uint64_t>& values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return static_cast<double>(values[std::min(values.size() - 1, static_cast<size_t>(q * values.size()))]);
+}
+
+bool runPingPong(const std::string& name, const PerfOptions& options, Metrics& metrics) {
+    SharedMemoryTransportV3::Config config;
+    parseMechanism(name, config.notify_mechanism);
+    const std::string echo_id = perfId("echo", 0);
+    Child echo;
+    if (!echo.start("echo", name, echo_id) || !echo.waitReady()) {
+        std::cerr << name << " pingpong: echo process did not start\n";
+        return false;
+    }
+
+    SharedMemoryTransportV3 transport;
+    if (!transport.initialize(perfId("ping", 0), config)) {
+        return false;
+    }
+    const size_t total = WARMUP_PINGS + options.pings;
+    std::vector<uint64_t> one_way_ns;
+    one_way_ns.reserve(options.pings);
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    uint8_t frame[FRAME_BYTES] = {};
+    uint64_t sent_ns = 0;
+    size_t replies = 0;
+    // The next ping leaves from the callback: no handoff to another thread in the measured path
+    transport.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) {
+        const uint64_t rtt = monotonicNs() - sent_ns;
+        if (++replies > WARMUP_PINGS) {
+            one_way_ns.push_back(rtt / 2);
+        }
+        if (replies < total) {
+            sent_ns = monotonicNs();
+            sendRetrying(transport, echo_id, frame, sizeof(frame));
+        } else {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            done_cv.notify_all();
+        }
+    });
+    transport.startReceiving();
+    sent_ns = monotonicNs();
+    sendRetrying(transport, echo_id, frame, sizeof(frame));
+    bool finished;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished = done_cv.wait_for(lock, std::chrono::milliseconds(CHILD_TIMEOUT_MS), [&] { return done; });
+    }
+    transport.stopReceiving();
+    uint8_t end[FRAME_BYTES] = {END_MARK};
+    sendRetrying(transport, echo_id, end, sizeof(end));
+    ChildReport report;
+    echo.waitReport(report);
+    if (!finished) {
+        std::cerr << name << " pingpong: " << replies << "/" << total << " replies before the timeout\n";
+        return false;
+    }
+    metrics[name + ".wakeup_p50_us"] = percentile(one_way_ns, 0.50) / 1000.0;
+    metrics[name + ".wakeup_p99_us"] = percentile(one_way_ns, 0.99) / 1000.0;
+    return true;
+}
+
+bool runFanout(const std::string& name, const PerfOptions& options, Metrics& metrics) {
+    SharedMemoryTransportV3::Config config;
+    parseMechanism(name, config.notify_mechanism);
+    std::vector<std::unique_ptr<Child>> sinks;
+    std::vector<std::string> sink_ids;
+    for (int r = 0; r < options.receivers; ++r) {
+        sink_ids.push_back(perfId("sink", r));
+        sinks.emplace_back(new Child());
+        if (!sinks.back()->start("sink", name, sink_ids.back()) || !sinks.back()->waitReady()) {
+            std::cerr << name << " fanout: receiver process did not start\n";
+            return false;
+        }
+    }
+
+    SharedMemoryTransportV3 transport;
+    if (!transport.initialize(perfId("source", 0), config)) {
+        return false;
+    }
+    uint8_t frame[FRAME_BYTES] = {};
+    const uint64_t start_ns = monotonicNs();
+    for (size_t i = 0; i < options.messages; ++i) {
+        std::memcpy(frame + 1, &i, sizeof(i));  // frame[0] stays 0, never END_MARK
+        for (const auto& id : sink_ids) {
+            sendRetrying(transport, id, frame, sizeof(frame));
+        }
+    }
+    frame[0] = END_MARK;
+    for (const auto& id : sink_ids) {
+        sendRetrying(transport, id, frame, sizeof(frame));
+    }
+
+    uint64_t last_ns = start_ns;
+    uint64_t received = 0;
+    double cpu_percent = 0.0;
+    for (auto& sink : sinks) {
+        ChildReport report;
+        if (!sink->waitReport(report)) {
+            std::cerr << name << " fanout: a receiver did not report\n";
+            return false;
+        }
+        received += report.received;
+        last_ns = std::max(last_ns, report.last_recv_ns);
+        cpu_percent += report.wall_us > 0 ? 100.0 * report.cpu_us / report.wall_us : 0.0;
+    }
+    const uint64_t expected = options.messages * sink_ids.size();
+    if (received != expected) {
+        std::cerr << name << " fanout: " << received << "/" << expected << " frames received\n";
+        return false;
+    }
+    metrics[name + ".fanout_msgs_per_s"] = received * 1e9 / std::max<uint64_t>(last_ns - start_ns, 1);
+    metrics[name + ".fanout_receiver_cpu_percent"] = cpu_percent / sinks.size();
+    return true;
+}
+
+bool runIdle(const std::string& name, Metrics& metrics) {
+    Child idle;
+    ChildReport report;
+    if (!idle.start("idle", name, perfId("idle", 0)) || !idle.waitReady() || !idle.waitReport(report)) {
+        std::cerr << name << " idle: receiver process did not report\n";
+        return false;
+    }
+    metrics[name + ".idle_receiver_cpu_percent"] = report.wall_us > 0 ? 100.0 * report.cpu_us / report.wall_us : 0;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Baselines
+
+struct Baseline {
+    double value;
+    double relative;
+    double absolute;
+};
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Tolerance of a metric new to the baseline file: wide enough for shared CI machines
+Baseline defaultTolerance(const std::string& metric) {
+    if (endsWith(metric, "_per_s")) {
+        return {0.0, 0.6, 0.0};
+    }
+    if (endsWith(metric, "_us")) {
+        return {0.0, 2.0, 20.0};
+    }
+    return {0.0, 1.0, 5.0};  // CPU percent
+}
+
+std::map<std::string, Baseline> loadBaselines(const std::string& path) {
+    std::map<std::string, Baseline> baselines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream in(line);
+        std::string name;
+        Baseline baseline;
+        if (in >> name >> baseline.value >> baseline.relative >> baseline.absolute) {
+            baselines[name] = baseline;
+        }
+    }
+    return baselines;
+}
+
+bool saveBaselines(const std::string& path, const std::map<std::string, Baseline>& baselines) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# notify_perf baselines: metric baseline relative_tolerance absolute_tolerance\n"
+         << "# \"_per_s\" metrics must stay above baseline - allowance, the others below baseline + allowance\n"
+         << "# (allowance = baseline * relative + absolute). Regenerate with notify_perf --update-baseline.\n";
+    for (const auto& entry : baselines) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-40s %12.2f %6.2f %8.2f\n", entry.first.c_str(), entry.second.value,
+                      entry.second.relative, entry.second.absolute);
+        file << line;
+    }
+    return static_cast<bool>(file);
+}
+
+// Prints every metric with its limit; returns false on a regression
+bool compare(const Metrics& metrics, const std::map<std::string, Baseline>& baselines) {
+    bool ok = true;
+    std::printf("%-40s %12s %12s %12s  %s\n", "METRIC", "VALUE", "BASELINE", "LIMIT", "STATUS");
+    for (const auto& entry : metrics) {
+        const auto it = baselines.find(entry.first);
+        if (it == baselines.end()) {
+            std::printf("%-40s %12.2f %12s %12s  %s\n", entry.first.c_str(), entry.second, "-", "-", "no baseline");
+            continue;
+        }
+        const Baseline& baseline = it->second;
+        const double allowance = baseline.value * baseline.relative + baseline.absolute;
+        const bool higher = endsWith(entry.first, "_per_s");
+        const double limit = higher ? baseline.value - allowance : baseline.value + allowance;
+        const bool pass = higher ? entry.second >= limit : entry.second <= limit;
+        ok = ok && pass;
+        std::printf("%-40s %12.2f %12.2f %s%11.2f  %s\n", entry.first.c_str(), entry.second, baseline.value,
+                    higher ? ">" : "<", limit, pass ? "ok" : "REGRESSION");
+    }
+    return ok;
+}
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --mechanisms LIST   cv,sem,poll (default: all)\n"
+              << "  --baseline FILE     Compare with (or, with --update-baseline, write) these baselines\n"
+              << "  --update-baseline   Store the measured values as the new baselines\n"
+              << "  --pings N           Measured ping-pong round trips (default: 2000)\n"
+              << "  --messages N        Fanout frames per receiver (default: 50000)\n"
+              << "  --receivers N       Fanout receiver processes (default: 3)\n"
+              << "  --output FILE       Also write \"metric value\" lines to FILE\n";
+}
+
+bool parseOptions(int argc, char* argv[], PerfOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--update-baseline") {
+            options.update_baseline = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--mechanisms") {
+            options.mechanisms.clear();
+            std::istringstream in(value);
+            std::string item;
+            Mechanism mechanism;
+            while (std::getline(in, item, ',')) {
+                if (!parseMechanism(item, mechanism)) {
+                    return false;
+                }
+                options.mechanisms.push_back(item);
+            }
+        } else if (arg == "--baseline") {
+            options.baseline = value;
+        } else if (arg == "--pings" && std::atoi(value.c_str()) > 0) {
+            options.pings = static_cast<size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--messages" && std::atoi(value.c_str()) > 0) {
+            options.messages = static_cast<size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--receivers" && std::atoi(value.c_str()) > 0) {
+            options.receivers = std::atoi(value.c_str());
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return !options.update_baseline || !options.baseline.empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 6 && std::string(argv[1]) == "--child") {
+        Logger::instance().setLevel(Logger::Level::ERROR);
+        return childMain(argv[2], argv[3], argv[4], std::atoi(argv[5]));
+    }
+
+    PerfOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!std::getenv("NEXUS_LOG_LEVEL")) {
+        Logger::instance().setLevel(Logger::Level::ERROR);
+    }
+
+    Metrics metrics;
+    bool ok = true;
+    for (const auto& name : options.mechanisms) {
+        std::cerr << "run  " << name << "\n";
+        ok = runPingPong(name, options, metrics) && ok;
+        ok = runFanout(name, options, metrics) && ok;
+        ok = runIdle(name, metrics) && ok;
+    }
+
+    if (!options.output.empty()) {
+        std::ofstream file(options.output);
+        for (const auto& entry : metrics) {
+            file << entry.first << " " << entry.second << "\n";
+        }
+    }
+
+    std::map<std::string, Baseline> baselines;
+    if (!options.baseline.empty()) {
+        baselines = loadBaselines(options.baseline);
+    }
+    if (options.update_baseline) {
+        for (const auto& entry : metrics) {
+            auto it = baselines.find(entry.first);
+            Baseline baseline = it != baselines.end() ? it->second : defaultTolerance(entry.first);
+            baseline.value = entry.second;
+            baselines[entry.first] = baseline;
+        }
+        if (!saveBaselines(options.baseline, baselines)) {
+            std::cerr << "Cannot write " << options.baseline << "\n";
+            return 1;
+        }
+    }
+    ok = compare(metrics, baselines) && ok;
+    return ok ? 0 : 1;
+}
@@ -65,7 +65,7 @@ struct TestMessage {
 // ============================================================================
 // 统计数据
 // ============================================================================
-struct TopicStats {
+struct TopicTrafficStats {
     std::atomic<uint64_t> sent_count{0};
     std::atomic<uint64_t> recv_count{0};
     std::atomic<uint64_t> lost_count{0};
@@ -77,7 +77,7 @@ struct TopicStats {
 };
 
 struct ProcessStats {
-    std::map<std::string, TopicStats> topic_stats;
+    std::map<std::string, TopicTrafficStats> topic_stats;
     std::atomic<uint64_t> total_sent{0};
     std::atomic<uint64_t> total_recv{0};
     std::atomic<uint64_t> memory_kb{0};
@@ -233,7 +233,7 @@ void publishThread(std::shared_ptr<Node> node,
     (void)is_cross_process;
     
     // 🔧 如果启用详细统计，才处理per-topic统计
-    TopicStats* stats_ptr = nullptr;
+    TopicTrafficStats* stats_ptr = nullptr;
     if (g_config.enable_detailed_stats) {
         // 构造完整topic名称用于统计
         std::string full_topic = group + "/" + topic;
@@ -309,7 +309,7 @@ void generateFinalReport() {
     std::cout << "────────────────────────────────────────────────────────────\n";
     for (auto& pair : g_stats.topic_stats) {
         const std::string& topic = pair.first;
-        TopicStats& stats = pair.second;
+        TopicTrafficStats& stats = pair.second;
         
         std::lock_guard<std::mutex> lock(stats.mutex);
         uint64_t sent = stats.sent_count.load(std::memory_order_relaxed);
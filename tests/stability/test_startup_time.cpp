@@ -0,0 +1,72 @@
+/**
+ * @file test_startup_time.cpp
+ * @brief 测试节点启动/关闭耗时 - 反复创建并销毁节点，统计 createNode() 与析构的时间
+ *
+ * 可选 peers 个常驻节点：新节点启动时需要发现并连接它们（服务查询等待应答）
+ */
+
+#include "nexus/core/Node.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Nexus::rpc;
+using namespace std::chrono;
+
+static void printStats(const char* label, std::vector<double> samples_ms) {
+    std::sort(samples_ms.begin(), samples_ms.end());
+    double sum = 0;
+    for (double s : samples_ms) {
+        sum += s;
+    }
+    std::cout << label << ": min " << samples_ms.front() << " ms, median " << samples_ms[samples_ms.size() / 2]
+              << " ms, avg " << sum / samples_ms.size() << " ms, max " << samples_ms.back() << " ms\n";
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc >= 2 ? std::atoi(argv[1]) : 20;
+    int peers = argc >= 3 ? std::atoi(argv[2]) : 1;
+    if (iterations <= 0 || peers < 0) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [peers]\n";
+        return 1;
+    }
+
+    std::cout << "\n╔══════════════════════════════════════════════════════════╗\n";
+    std::cout << "║      Startup/Shutdown Time Test                          ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════╝\n";
+    std::cout << iterations << " iterations, " << peers << " resident peer node(s)\n\n";
+
+    std::vector<std::shared_ptr<Node>> resident;
+    for (int i = 0; i < peers; ++i) {
+        resident.push_back(createNode("startup_peer_" + std::to_string(i)));
+        resident.back()->subscribe("startup_group", {"startup_topic"},
+                                   [](const std::string&, const std::string&, const uint8_t*, size_t) {});
+    }
+
+    std::vector<double> startup_ms;
+    std::vector<double> shutdown_ms;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = steady_clock::now();
+        std::shared_ptr<Node> node = createNode("startup_node_" + std::to_string(i));
+        auto created = steady_clock::now();
+        if (!node) {
+            std::cerr << "Failed to create node\n";
+            return 1;
+        }
+        node.reset();
+        auto destroyed = steady_clock::now();
+
+        startup_ms.push_back(duration_cast<microseconds>(created - start).count() / 1000.0);
+        shutdown_ms.push_back(duration_cast<microseconds>(destroyed - created).count() / 1000.0);
+    }
+
+    printStats("startup ", startup_ms);
+    printStats("shutdown", shutdown_ms);
+
+    std::cout << "\n✓ 测试完成\n";
+    return 0;
+}
@@ -1,11 +1,13 @@
 #include "simple_test.h"
 #include "nexus/core/Config.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
 #include <cstdlib>
 
 using namespace Nexus::rpc;
 
 #include "simple_test.h"
 #include "nexus/core/Config.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
 #include <cstdlib>
 
 using namespace Nexus::rpc;
@@ -24,8 +26,30 @@ struct ConfigResetter {
         unsetenv("NEXUS_SHM_QUEUE_CAPACITY");
         unsetenv("NEXUS_HEARTBEAT_INTERVAL_MS");
         unsetenv("NEXUS_NODE_TIMEOUT_MS");
+        unsetenv("NEXUS_SHM_RECEIVE_THREADS");
+        unsetenv("NEXUS_SHM_NON_BLOCKING");
         unsetenv("NEXUS_BUFFER_SIZE");
         unsetenv("NEXUS_MAX_BLOCK_SIZE");
+        unsetenv("NEXUS_WORKER_CPUS");
+        unsetenv("NEXUS_WORKER_PRIORITY");
+        unsetenv("NEXUS_BLOCK_TIMEOUT_MS");
+        unsetenv("NEXUS_SHM_SEND_TIMEOUT_MS");
+        unsetenv("NEXUS_SHM_CHECKSUM");
+        unsetenv("NEXUS_UDP_CHECKSUM");
+        unsetenv("NEXUS_UDP_COMPRESS_THRESHOLD");
+        unsetenv("NEXUS_SHM_PREFAULT");
+        unsetenv("NEXUS_LARGE_DATA_HUGE_PAGES");
+        unsetenv("NEXUS_NUMA_NODE");
+        unsetenv("NEXUS_DISCOVERY_CACHE");
+        unsetenv("NEXUS_LATENCY_TRACING");
+        unsetenv("NEXUS_METRICS_INTERVAL_MS");
+        unsetenv("NEXUS_WATERMARK_HIGH_PERCENT");
+        unsetenv("NEXUS_WATERMARK_LOW_PERCENT");
+        unsetenv("NEXUS_WATERMARK_POLL_MS");
+        unsetenv("NEXUS_THREADS_SHM_RECEIVE");
+        unsetenv("NEXUS_THREADS_WORKER");
+        unsetenv("NEXUS_THREADS_SYSTEM");
+        unsetenv("NEXUS_THREADS_MAINTENANCE");
     }
     
     void reset() {
@@ -34,6 +58,7 @@ struct ConfigResetter {
         config.transport = Config::TransportConfig();
         config.shm = Config::SharedMemoryConfig();
         config.large_data = Config::LargeDataConfig();
+        config.threads = Config::ThreadsConfig();
     }
 };
 
@@ -45,11 +70,25 @@ TEST(ConfigTest, DefaultValues) {
     ASSERT_EQ(config.node.queue_capacity, 1024);
     ASSERT_EQ(config.node.num_processing_threads, 4);
     ASSERT_EQ(config.node.max_queue_size, 25000);
+    ASSERT_EQ(config.node.block_timeout_ms, 100u);
+    ASSERT_EQ(config.node.numa_node, -1);
+    ASSERT_TRUE(config.node.discovery_cache.empty());
+    ASSERT_FALSE(config.node.latency_tracing);
+    ASSERT_EQ(config.node.metrics_interval_ms, 0u);
+    ASSERT_EQ(config.node.watermark_high_percent, 80u);
+    ASSERT_EQ(config.node.watermark_low_percent, 50u);
+    ASSERT_EQ(config.node.watermark_poll_ms, 10u);
     
     ASSERT_EQ(config.shm.queue_capacity, 1024);
     ASSERT_EQ(config.shm.max_inbound_queues, 64);
     ASSERT_EQ(config.shm.heartbeat_interval_ms, 1000);
     ASSERT_EQ(config.shm.node_timeout_ms, 5000);
+    ASSERT_EQ(config.shm.receive_threads, 1u);
+    ASSERT_FALSE(config.shm.non_blocking_send);
+    ASSERT_EQ(config.shm.send_timeout_ms, 0u);
+    ASSERT_TRUE(config.shm.checksum == ChecksumType::NONE);
+    ASSERT_TRUE(config.transport.udp_checksum == ChecksumType::CRC32C);
+    ASSERT_EQ(config.transport.udp_compress_threshold, 0u);
     
     ASSERT_EQ(config.large_data.buffer_size, 64 * 1024 * 1024);
     ASSERT_EQ(config.large_data.max_block_size, 8 * 1024 * 1024);
@@ -65,8 +104,24 @@ TEST(ConfigTest, LoadFromEnvAllVars) {
     setenv("NEXUS_SHM_QUEUE_CAPACITY", "512", 1);
     setenv("NEXUS_HEARTBEAT_INTERVAL_MS", "2000", 1);
     setenv("NEXUS_NODE_TIMEOUT_MS", "10000", 1);
+    setenv("NEXUS_SHM_RECEIVE_THREADS", "4", 1);
+    setenv("NEXUS_SHM_NON_BLOCKING", "1", 1);
+    setenv("NEXUS_BLOCK_TIMEOUT_MS", "250", 1);
+    setenv("NEXUS_SHM_SEND_TIMEOUT_MS", "5", 1);
+    setenv("NEXUS_SHM_CHECKSUM", "sum", 1);
+    setenv("NEXUS_UDP_CHECKSUM", "bogus", 1);
+    setenv("NEXUS_UDP_COMPRESS_THRESHOLD", "1024", 1);
     setenv("NEXUS_BUFFER_SIZE", "1048576", 1); // 1MB
     setenv("NEXUS_MAX_BLOCK_SIZE", "524288", 1); // 512KB
+    setenv("NEXUS_SHM_PREFAULT", "1", 1);
+    setenv("NEXUS_LARGE_DATA_HUGE_PAGES", "1", 1);
+    setenv("NEXUS_NUMA_NODE", "1", 1);
+    setenv("NEXUS_DISCOVERY_CACHE", "/tmp/nexus.cache", 1);
+    setenv("NEXUS_LATENCY_TRACING", "1", 1);
+    setenv("NEXUS_METRICS_INTERVAL_MS", "500", 1);
+    setenv("NEXUS_WATERMARK_HIGH_PERCENT", "90", 1);
+    setenv("NEXUS_WATERMARK_LOW_PERCENT", "30", 1);
+    setenv("NEXUS_WATERMARK_POLL_MS", "0", 1);  // Clamped to 1
     
     Config& config = Config::instance();
     config.loadFromEnv();
@@ -75,13 +130,31 @@ TEST(ConfigTest, LoadFromEnvAllVars) {
     ASSERT_EQ(config.node.queue_capacity, 512);
     ASSERT_EQ(config.node.num_processing_threads, 8);
     ASSERT_EQ(config.node.max_queue_size, 10000);
+    ASSERT_EQ(config.node.block_timeout_ms, 250u);
+    ASSERT_EQ(config.node.numa_node, 1);
+    ASSERT_TRUE(config.node.discovery_cache == "/tmp/nexus.cache");
+    ASSERT_TRUE(config.node.latency_tracing);
+    ASSERT_EQ(config.node.metrics_interval_ms, 500u);
+    ASSERT_EQ(config.node.watermark_high_percent, 90u);
+    ASSERT_EQ(config.node.watermark_low_percent, 30u);
+    ASSERT_EQ(config.node.watermark_poll_ms, 1u);
     
     ASSERT_EQ(config.shm.queue_capacity, 512);
     ASSERT_EQ(config.shm.heartbeat_interval_ms, 2000);
     ASSERT_EQ(config.shm.node_timeout_ms, 10000);
+    ASSERT_EQ(config.shm.receive_threads, 4u);
+    ASSERT_TRUE(config.shm.non_blocking_send);
+    ASSERT_EQ(config.shm.send_timeout_ms, 5u);
+    ASSERT_TRUE(config.shm.checksum == ChecksumType::SUM);
+    ASSERT_TRUE(config.transport.udp_checksum == ChecksumType::CRC32C);  // Unknown name ignored
+    ASSERT_EQ(config.transport.udp_compress_threshold, 1024u);
     
     ASSERT_EQ(config.large_data.buffer_size, 1048576);
     ASSERT_EQ(config.large_data.max_block_size, 524288);
+    ASSERT_TRUE(config.shm.prefault);
+    ASSERT_FALSE(config.shm.huge_pages);
+    ASSERT_TRUE(config.large_data.huge_pages);
+    ASSERT_FALSE(config.large_data.lock_memory);
 }
 
 TEST(ConfigTest, LoadFromEnvClamping) {
@@ -92,14 +165,14 @@ TEST(ConfigTest, LoadFromEnvClamping) {
     setenv("NEXUS_MAX_INBOUND_QUEUES", "1", 1); // Min 8
     setenv("NEXUS_QUEUE_CAPACITY", "10", 1);    // Min 64
     setenv("NEXUS_NUM_THREADS", "0", 1);        // Min 1
-    setenv("NEXUS_SHM_QUEUE_CAPACITY", "10", 1);// Min 64
+    setenv("NEXUS_SHM_QUEUE_CAPACITY", "10", 1);// Min 64, then 128 x 2KB to fit a full MessagePacket
     
     config.loadFromEnv();
     
     ASSERT_EQ(config.node.max_inbound_queues, 8);
     ASSERT_EQ(config.node.queue_capacity, 64);
     ASSERT_EQ(config.node.num_processing_threads, 1);
-    ASSERT_EQ(config.shm.queue_capacity, 64);
+    ASSERT_EQ(config.shm.queue_capacity, 128);
     
     // Reset for max clamping
     resetter.reset();
@@ -118,6 +191,70 @@ TEST(ConfigTest, LoadFromEnvClamping) {
     ASSERT_EQ(config.shm.queue_capacity, 1024);
 }
 
+TEST(ConfigTest, LoadFromEnvWorkerScheduling) {
+    ConfigResetter resetter;
+    Config& config = Config::instance();
+    ASSERT_TRUE(config.node.worker_cpu_sets.empty());
+    ASSERT_EQ(config.node.worker_priority, 0);
+
+    setenv("NEXUS_WORKER_CPUS", "0-1;2;3,5;;70", 1);  // Empty and out-of-range sets are skipped
+    setenv("NEXUS_WORKER_PRIORITY", "150", 1);       // Max 99
+    config.loadFromEnv();
+
+    ASSERT_EQ(config.node.worker_cpu_sets.size(), 3u);
+    ASSERT_EQ(config.node.worker_cpu_sets[0], 0x3u);
+    ASSERT_EQ(config.node.worker_cpu_sets[1], 0x4u);
+    ASSERT_EQ(config.node.worker_cpu_sets[2], 0x28u);
+    ASSERT_EQ(config.node.worker_priority, 99);
+}
+
+TEST(ConfigTest, LoadFromEnvThreadPlacement) {
+    ConfigResetter resetter;
+    Config& config = Config::instance();
+    ASSERT_EQ(config.threads.shm_receive.cpu_mask, 0u);
+    ASSERT_TRUE(config.threads.shm_receive.policy == SchedPolicy::INHERIT);
+
+    setenv("NEXUS_THREADS_SHM_RECEIVE", "fifo:80@2-3", 1);
+    setenv("NEXUS_THREADS_WORKER", "@4,6", 1);
+    setenv("NEXUS_THREADS_SYSTEM", "rr:5", 1);
+    setenv("NEXUS_THREADS_MAINTENANCE", "idle:1@0", 1);  // Unknown policy: role unchanged
+    config.loadFromEnv();
+
+    ASSERT_TRUE(config.threads.shm_receive.policy == SchedPolicy::FIFO);
+    ASSERT_EQ(config.threads.shm_receive.priority, 80);
+    ASSERT_EQ(config.threads.shm_receive.cpu_mask, 0xcu);
+    ASSERT_TRUE(config.threads.worker.policy == SchedPolicy::INHERIT);
+    ASSERT_EQ(config.threads.worker.cpu_mask, 0x50u);
+    ASSERT_TRUE(config.threads.system.policy == SchedPolicy::RR);
+    ASSERT_EQ(config.threads.system.priority, 5);
+    ASSERT_EQ(config.threads.system.cpu_mask, 0u);
+    ASSERT_TRUE(config.threads.maintenance.policy == SchedPolicy::INHERIT);
+    ASSERT_EQ(config.threads.maintenance.cpu_mask, 0u);
+    ASSERT_EQ(config.threads.udp_receive.cpu_mask, 0u);
+}
+
+TEST(ConfigTest, ValidateShmQueueFitsMaxPacket) {
+    ConfigResetter resetter;
+    Config& config = Config::instance();
+
+    config.shm.message_size = 4096;
+    config.shm.queue_capacity = 16;
+    config.validate();
+    ASSERT_EQ(config.shm.queue_capacity, 64);  // 64 x 4KB = MIN_DATA_QUEUE_SIZE_BYTES
+    ASSERT_FALSE(config.shm.queue_capacity * config.shm.message_size <
+                 SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES);
+
+    config.shm.queue_capacity = 1024;  // Large enough: unchanged
+    config.validate();
+    ASSERT_EQ(config.shm.queue_capacity, 1024);
+
+    config.shm.message_size = 0;  // Back to the default message size
+    config.shm.queue_capacity = 1;
+    config.validate();
+    ASSERT_EQ(config.shm.message_size, 2048);
+    ASSERT_EQ(config.shm.queue_capacity, 128);
+}
+
 TEST(ConfigTest, CalculateMemoryFootprint) {
     ConfigResetter resetter;
     Config& config = Config::instance();
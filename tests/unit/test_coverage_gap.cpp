@@ -267,8 +267,9 @@ namespace Internal {
 
         std::atomic<uint64_t> node_id_atomic[8];
         std::atomic<uint64_t> shm_name_atomic[8];
+        std::atomic<uint64_t> node_hash;
 
-        char padding[48];
+        char padding[40];
     };
 
     struct alignas(64) RegistryHeader {
@@ -278,12 +279,20 @@ namespace Internal {
         std::atomic<uint32_t> num_entries;
         std::atomic<uint32_t> capacity;
         std::atomic<uint32_t> ref_count;
+        std::atomic<uint32_t> generation;
         std::atomic<uint32_t> ref_pids[SharedMemoryRegistry::MAX_REGISTRY_ENTRIES];
     };
 
+    struct RegistryIndex {
+        std::atomic<uint32_t> updating;
+        std::atomic<uint32_t> tombstones;
+        std::atomic<uint32_t> slots[SharedMemoryRegistry::INDEX_SLOTS];
+    };
+
     struct RegistryRegion {
         RegistryHeader header;
         RegistryEntry entries[SharedMemoryRegistry::MAX_REGISTRY_ENTRIES];
+        RegistryIndex index;
     };
 }
 
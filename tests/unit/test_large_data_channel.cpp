@@ -1,7 +1,10 @@
 #include "simple_test.h"
 #include "nexus/transport/LargeDataChannel.h"
+#include <algorithm>
 #include <vector>
+#include <chrono>
 #include <cstring>
+#include <thread>
 
 using namespace Nexus;
 using namespace Nexus::rpc;
@@ -33,3 +36,401 @@ TEST(LargeDataChannelTest, CreateAndWrite) {
         reader->releaseBlock(block);
     }
 }
+
+TEST(LargeDataChannelTest, ReserveAndCommit) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;  // 1MB
+
+    auto writer = LargeDataChannel::create("test_channel_reserve", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_reserve");
+    ASSERT_TRUE(reader != nullptr);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));  // Registers the reader
+
+    // Fill shared memory in place; nothing is visible before the commit
+    uint8_t* frame = writer->reserveBlock("camera", 4096);
+    ASSERT_TRUE(frame != nullptr);
+    ASSERT_TRUE(writer->reserveBlock("camera", 16) == nullptr);  // One reservation at a time
+    for (size_t i = 0; i < 3000; ++i) {
+        frame[i] = static_cast<uint8_t>(i);
+    }
+    ASSERT_FALSE(reader->tryRead(block));
+
+    // Commit fewer bytes than reserved (encoder output)
+    ASSERT_EQ(-1, writer->commitBlock(4097));
+    int64_t seq = writer->commitBlock(3000);
+    ASSERT_TRUE(seq >= 0);
+    ASSERT_EQ(-1, writer->commitBlock());
+
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_TRUE(block.isValid());
+    ASSERT_EQ("camera", block.getTopic());
+    ASSERT_EQ(3000u, block.size);
+    ASSERT_EQ(static_cast<uint64_t>(seq), block.header->sequence);
+    ASSERT_EQ(0, std::memcmp(frame, block.data, block.size));
+    reader->releaseBlock(block);
+
+    // Aborted reservations leave no block and use no sequence number
+    ASSERT_TRUE(writer->reserveBlock("camera", 128) != nullptr);
+    writer->abortBlock();
+    ASSERT_FALSE(reader->tryRead(block));
+    ASSERT_TRUE(writer->reserveBlock("camera", 64) != nullptr);
+    ASSERT_EQ(seq + 1, writer->commitBlock());
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_EQ(64u, block.size);
+    reader->releaseBlock(block);
+}
+
+TEST(LargeDataChannelTest, WaitForData) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;  // 1MB
+
+    auto writer = LargeDataChannel::create("test_channel_wait", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_wait");
+    ASSERT_TRUE(reader != nullptr);
+
+    // Nothing written: times out
+    ASSERT_FALSE(reader->waitForData(20));
+
+    // A commit from another thread wakes the blocked reader
+    std::vector<uint8_t> data(512, 0x5A);
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        writer->write("topic", data.data(), data.size());
+    });
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(reader->waitForData(5000));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    producer.join();
+
+    LargeDataChannel::DataBlock block;
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_EQ(512u, block.size);
+    ASSERT_TRUE(reader->releaseBlock(block));
+
+    // Unread data returns immediately
+    writer->write("topic", data.data(), data.size());
+    ASSERT_TRUE(reader->waitForData(0));
+}
+
+TEST(LargeDataChannelTest, CachedMinReadPosFollowsReaders) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 64 * 1024;
+    config.max_block_size = 16 * 1024;
+    config.overflow_policy = LargeDataOverflowPolicy::DROP_NEWEST;
+
+    auto writer = LargeDataChannel::create("test_channel_min_cache", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_min_cache");
+    ASSERT_TRUE(reader != nullptr);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));
+
+    // Several laps: the writer fills the ring against its cached minimum, rescans once
+    // the reader has drained it, and never overwrites a block the reader has not released
+    std::vector<uint8_t> data(8 * 1024);
+    uint8_t next_write = 0;
+    uint8_t next_read = 0;
+    for (int lap = 0; lap < 5; ++lap) {
+        size_t written = 0;
+        for (;;) {
+            std::fill(data.begin(), data.end(), next_write);
+            if (writer->write("topic", data.data(), data.size()) == -1) {
+                break;
+            }
+            ++next_write;
+            ++written;
+        }
+        ASSERT_GT(written, 0u);
+        ASSERT_LT(written * (data.size() + sizeof(LargeDataHeader)), config.buffer_size + 1);
+
+        while (reader->tryRead(block)) {
+            ASSERT_EQ(next_read, block.data[0]);
+            ASSERT_EQ(next_read, block.data[block.size - 1]);
+            ASSERT_TRUE(reader->releaseBlock(block));
+            ++next_read;
+        }
+        ASSERT_EQ(next_write, next_read);
+    }
+}
+
+TEST(LargeDataChannelTest, PrefaultedHugePageMapping) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 4 * 1024 * 1024;
+    config.huge_pages = true;   // Best effort: ignored without shmem THP
+    config.prefault = true;
+    config.lock_memory = true;  // Best effort: RLIMIT_MEMLOCK may refuse
+
+    auto writer = LargeDataChannel::create("test_channel_prefault", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_prefault", config);
+    ASSERT_TRUE(reader != nullptr);
+
+    std::vector<uint8_t> data(64 * 1024, 0x3C);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));  // Registers the reader
+    ASSERT_TRUE(writer->write("topic", data.data(), data.size()) >= 0);
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_EQ(0, std::memcmp(data.data(), block.data, block.size));
+    ASSERT_TRUE(reader->releaseBlock(block));
+}
+
+TEST(LargeDataChannelTest, NumaBoundRing) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;
+    config.prefault = true;
+    config.numa_node = 0;  // Best effort: mbind may be unavailable in containers
+
+    auto writer = LargeDataChannel::create("test_channel_numa", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_numa");
+    ASSERT_TRUE(reader != nullptr);
+
+    std::vector<uint8_t> data(16 * 1024, 0x5A);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));
+    ASSERT_TRUE(writer->write("topic", data.data(), data.size()) >= 0);
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_EQ(0, std::memcmp(data.data(), block.data, block.size));
+    ASSERT_TRUE(reader->releaseBlock(block));
+
+    // Node 0 always exists; -1 only when the kernel does not report placement
+    int node = writer->getStats().numa_node;
+    ASSERT_TRUE(node == 0 || node == -1);
+    ASSERT_EQ(reader->getStats().numa_node, node);
+}
+
+TEST(LargeDataChannelTest, MirroredRingWrapsContiguously) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 64 * 1024;
+    config.max_block_size = 32 * 1024;
+    config.mirrored = true;
+
+    auto writer = LargeDataChannel::create("test_channel_mirrored", config);
+    ASSERT_TRUE(writer != nullptr);
+    ASSERT_TRUE(writer->isMirrored());
+    auto reader = LargeDataChannel::create("test_channel_mirrored");  // Layout follows the creator
+    ASSERT_TRUE(reader != nullptr);
+    ASSERT_TRUE(reader->isMirrored());
+
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));  // Registers the reader
+
+    // 20000-byte blocks do not divide the ring: most of them straddle its end
+    std::vector<uint8_t> data(20000);
+    for (int i = 0; i < 12; ++i) {
+        for (size_t j = 0; j < data.size(); ++j) {
+            data[j] = static_cast<uint8_t>(i * 31 + j);
+        }
+        ASSERT_TRUE(writer->write("topic", data.data(), data.size()) >= 0);
+        ASSERT_TRUE(reader->tryRead(block));
+        ASSERT_EQ(i * (sizeof(LargeDataHeader) + data.size()), block.position);  // No tail space skipped
+        ASSERT_EQ(data.size(), block.size);
+        ASSERT_EQ(0, std::memcmp(data.data(), block.data, block.size));
+        ASSERT_TRUE(reader->releaseBlock(block));
+    }
+
+}
+
+TEST(LargeDataChannelTest, StreamLargerThanRing) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;
+    config.max_block_size = 512 * 1024;
+    config.stream_chunk_size = 128 * 1024;
+    config.overflow_policy = LargeDataOverflowPolicy::BLOCK;  // Writer waits for the reader to release chunks
+    config.block_timeout_ms = 5000;
+
+    auto writer = LargeDataChannel::create("test_channel_stream", config);
+    ASSERT_TRUE(writer != nullptr);
+    auto reader = LargeDataChannel::create("test_channel_stream", config);
+    ASSERT_TRUE(reader != nullptr);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(reader->tryRead(block));  // Registers the reader
+
+    // 5MB object through a 1MB ring: only possible if the reader consumes while the writer writes
+    std::vector<uint8_t> object(5 * 1024 * 1024 + 1000);
+    for (size_t i = 0; i < object.size(); ++i) {
+        object[i] = static_cast<uint8_t>(i * 7 + (i >> 12));
+    }
+    int64_t last_seq = 0;
+    std::thread producer([&]() {
+        if (writer->beginStream("pointcloud", object.size())) {
+            size_t half = object.size() / 2;
+            writer->writeStream(object.data(), half);
+            last_seq = writer->writeStream(object.data() + half, object.size() - half, true);
+        }
+    });
+
+    std::vector<uint8_t> received;
+    uint64_t stream_id = 0;
+    uint32_t next_chunk = 0;
+    bool ended = false;
+    while (!ended) {
+        if (!reader->waitForData(5000)) {
+            break;
+        }
+        if (!reader->tryRead(block)) {
+            continue;
+        }
+        if (block.isStreamChunk()) {
+            stream_id = next_chunk == 0 ? block.header->stream_id : stream_id;
+            ended = block.isStreamEnd();
+            if (block.header->chunk_index == next_chunk && block.header->stream_id == stream_id &&
+                block.header->stream_offset == received.size() && block.header->stream_size == object.size()) {
+                received.insert(received.end(), block.data, block.data + block.size);
+                ++next_chunk;
+            }
+        }
+        reader->releaseBlock(block);
+    }
+    producer.join();
+
+    ASSERT_TRUE(ended);
+    ASSERT_TRUE(last_seq > 0);
+    ASSERT_FALSE(writer->inStream());
+    ASSERT_EQ(0u, stream_id);  // First chunk's sequence
+    ASSERT_EQ(object.size(), received.size());
+    ASSERT_TRUE(received == object);
+
+    // Aborted streams end with an empty STREAM_ABORTED chunk
+    ASSERT_TRUE(writer->beginStream("pointcloud"));
+    ASSERT_FALSE(writer->beginStream("pointcloud"));
+    ASSERT_TRUE(writer->writeStream(object.data(), 1000) >= 0);
+    writer->abortStream();
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_FALSE(block.isStreamEnd());
+    ASSERT_EQ(0u, block.header->stream_size);
+    reader->releaseBlock(block);
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_TRUE(block.isStreamEnd());
+    ASSERT_TRUE(block.isStreamAborted());
+    ASSERT_EQ(0u, block.size);
+    reader->releaseBlock(block);
+}
+
+TEST(LargeDataChannelTest, CrcTypeInHeader) {
+    std::vector<uint8_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // Default writers use CRC32C; CRC32 writers (older format) stay readable
+    const LargeDataCrc types[] = {LargeDataCrc::CRC32C, LargeDataCrc::CRC32};
+    for (LargeDataCrc type : types) {
+        LargeDataChannel::Config config;
+        config.buffer_size = 1024 * 1024;
+        config.crc_type = type;
+        const std::string name = type == LargeDataCrc::CRC32C ? "test_channel_crc32c" : "test_channel_crc32";
+        auto writer = LargeDataChannel::create(name, config);
+        ASSERT_TRUE(writer != nullptr);
+        auto reader = LargeDataChannel::create(name);
+        ASSERT_TRUE(reader != nullptr);
+        LargeDataChannel::DataBlock block;
+        ASSERT_FALSE(reader->tryRead(block));
+
+        ASSERT_TRUE(writer->write("lidar", data.data(), data.size()) >= 0);
+        ASSERT_TRUE(reader->tryRead(block));
+        ASSERT_EQ(static_cast<int>(type), static_cast<int>(block.header->crc_type));
+        ASSERT_EQ(0, std::memcmp(data.data(), block.data, data.size()));
+        reader->releaseBlock(block);
+    }
+}
+
+TEST(LargeDataChannelTest, ReaderVerifyModes) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;
+    auto writer = LargeDataChannel::create("test_channel_verify", config);
+    ASSERT_TRUE(writer != nullptr);
+
+    LargeDataChannel::Config trust_config;
+    trust_config.verify_mode = LargeDataVerifyMode::TRUST;
+    auto full = LargeDataChannel::create("test_channel_verify");
+    auto trust = LargeDataChannel::create("test_channel_verify", trust_config);
+    auto sampled = LargeDataChannel::create("test_channel_verify");
+    ASSERT_TRUE(full && trust && sampled);
+    sampled->setVerifyMode(LargeDataVerifyMode::SAMPLED, 2);
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(full->tryRead(block));
+    ASSERT_FALSE(trust->tryRead(block));
+    ASSERT_FALSE(sampled->tryRead(block));
+
+    std::vector<uint8_t> data(2048, 0x5A);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(writer->write("frames", data.data(), data.size()) >= 0);
+    }
+
+    // Corrupt the payload of the first block behind the writer's back
+    ASSERT_TRUE(trust->tryRead(block));
+    const_cast<uint8_t*>(block.data)[0] ^= 0xFF;
+
+    // TRUST never rehashes: all four blocks are delivered
+    for (int i = 0; i < 4; ++i) {
+        if (i > 0) {
+            ASSERT_TRUE(trust->tryRead(block));
+        }
+        trust->releaseBlock(block);
+    }
+    ASSERT_EQ(0u, trust->getStats().blocks_verified);
+    ASSERT_TRUE(trust->getStats().verify_mode == LargeDataVerifyMode::TRUST);
+
+    // FULL catches the corruption
+    ASSERT_FALSE(full->tryRead(block));
+    ASSERT_EQ((int)LargeDataChannel::ReadResult::CRC_ERROR, (int)block.result);
+
+    // SAMPLED (every 2nd block): the corrupted first block passes unchecked, the second is verified
+    ASSERT_TRUE(sampled->tryRead(block));
+    sampled->releaseBlock(block);
+    ASSERT_TRUE(sampled->tryRead(block));
+    sampled->releaseBlock(block);
+    ASSERT_EQ(1u, sampled->getStats().blocks_verified);
+}
+
+TEST(LargeDataChannelTest, AttachFromLatestAndReaderMask) {
+    LargeDataChannel::Config config;
+    config.buffer_size = 1024 * 1024;
+    auto writer = LargeDataChannel::create("test_channel_mask", config);
+    ASSERT_TRUE(writer != nullptr);
+
+    std::vector<uint8_t> data(256, 0x11);
+    ASSERT_TRUE(writer->write("old", data.data(), data.size()) >= 0);
+
+    // From the latest position: the block written before attaching is not replayed
+    auto latest = LargeDataChannel::create("test_channel_mask");
+    auto replay = LargeDataChannel::create("test_channel_mask");
+    ASSERT_TRUE(latest && replay);
+    const int32_t slot = latest->attachReader(true);
+    ASSERT_TRUE(slot >= 0);
+    ASSERT_EQ(slot, latest->attachReader(true));
+    ASSERT_EQ(slot, latest->getReaderId());
+    const int32_t other = replay->attachReader();
+    ASSERT_TRUE(other >= 0);
+    ASSERT_NE(slot, other);
+
+    LargeDataChannel::DataBlock block;
+    ASSERT_FALSE(latest->tryRead(block));
+    ASSERT_TRUE(replay->tryRead(block));
+    ASSERT_EQ(std::string("old"), block.getTopic());
+    ASSERT_TRUE(block.isFor(slot));  // No mask: every reader
+    replay->releaseBlock(block);
+
+    // A masked block is read by everyone but meant only for its readers
+    uint8_t* reserved = writer->reserveBlock("masked", data.size(), static_cast<uint16_t>(1u << slot));
+    ASSERT_TRUE(reserved != nullptr);
+    memcpy(reserved, data.data(), data.size());
+    ASSERT_TRUE(writer->commitBlock() >= 0);
+    ASSERT_TRUE(latest->tryRead(block));
+    ASSERT_TRUE(block.isFor(slot));
+    ASSERT_FALSE(block.isFor(other));
+    latest->releaseBlock(block);
+    ASSERT_TRUE(replay->tryRead(block));
+    ASSERT_FALSE(block.isFor(other));
+    replay->releaseBlock(block);
+
+    // The mask does not stick to the next block
+    ASSERT_TRUE(writer->write("plain", data.data(), data.size()) >= 0);
+    ASSERT_TRUE(replay->tryRead(block));
+    ASSERT_TRUE(block.isFor(other));
+    replay->releaseBlock(block);
+}
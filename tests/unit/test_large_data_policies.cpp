@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <chrono>
+#include <thread>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -14,6 +16,8 @@ TEST(LargeDataPolicies, DropOldest) {
     config.buffer_size = 4096 * 10;
     config.max_block_size = 4096;
     config.overflow_policy = LargeDataOverflowPolicy::DROP_OLDEST;
+    size_t overflow_calls = 0;
+    config.overflow_callback = [&](const std::string&, const std::string&, uint64_t, size_t) { ++overflow_calls; };
     
     std::string shm_name = "test_policy_drop_oldest";
     shm_unlink(shm_name.c_str());
@@ -28,24 +32,26 @@ TEST(LargeDataPolicies, DropOldest) {
     reader->tryRead(block); // Registers the reader
     
     std::vector<uint8_t> data(1024, 0xAA);
-    
-    // Fill buffer
-    // Capacity is 40960. Each write is ~1100 bytes.
-    // 40 writes should fill it.
-    int writes = 0;
+
+    // The writer never waits for the stalled reader: it pushes the reader forward instead
     for (int i = 0; i < 50; ++i) {
-        if (channel->write("topic", data.data(), data.size()) == -1) {
-            break;
-        }
-        writes++;
+        ASSERT_NE(channel->write("topic", data.data(), data.size()), -1);
     }
-    
-    // Should have stopped before 50
-    ASSERT_LT(writes, 50);
+    ASSERT_GT(overflow_calls, 0u);
 
-    // The next write should fail because DROP_OLDEST is not supported
-    int64_t result = channel->write("topic", data.data(), data.size());
-    ASSERT_EQ(result, -1);
+    // The reader resumes at the oldest block still in the buffer, never in the middle of one
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_GT(block.header->sequence, 0u);
+    ASSERT_TRUE(reader->releaseBlock(block));
+
+    // A block held while the writer laps the reader is reported on release
+    ASSERT_TRUE(reader->tryRead(block));
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_NE(channel->write("topic", data.data(), data.size()), -1);
+    }
+    ASSERT_FALSE(reader->releaseBlock(block));
+    ASSERT_TRUE(reader->tryRead(block));
+    ASSERT_TRUE(reader->releaseBlock(block));
 }
 
 TEST(LargeDataPolicies, Block) {
@@ -53,6 +59,7 @@ TEST(LargeDataPolicies, Block) {
     config.buffer_size = 4096 * 10;
     config.max_block_size = 4096;
     config.overflow_policy = LargeDataOverflowPolicy::BLOCK;
+    config.block_timeout_ms = 20;
     
     std::string shm_name = "test_policy_block";
     shm_unlink(shm_name.c_str());
@@ -80,10 +87,24 @@ TEST(LargeDataPolicies, Block) {
     // Should have stopped before 50
     ASSERT_LT(writes, 50);
     
-    // Should log error and return -1 (BLOCK not recommended/implemented fully?)
-    // The code says: NEXUS_ERROR("LargeData") << "Buffer full (BLOCK policy not recommended)";
+    // Reader never consumes: the write waits block_timeout_ms, then fails
+    auto start = std::chrono::steady_clock::now();
     int64_t result = channel->write("topic", data.data(), data.size());
     ASSERT_EQ(result, -1);
+    ASSERT_GT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+              static_cast<long>(config.block_timeout_ms) - 1);
+
+    // Reader frees space while the writer waits: the write goes through
+    std::thread consumer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        LargeDataChannel::DataBlock freed;
+        if (reader->tryRead(freed)) {
+            reader->releaseBlock(freed);
+        }
+    });
+    result = channel->write("topic", data.data(), data.size());
+    consumer.join();
+    ASSERT_GT(result, -1);
 }
 
 TEST(LargeDataPolicies, WriteTooLarge) {
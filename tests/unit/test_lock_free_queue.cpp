@@ -1,9 +1,14 @@
 #include "simple_test.h"
 #include "nexus/transport/LockFreeQueue.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
+#include "nexus/utils/BoundedQueue.h"
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <chrono>
 #include <cstring>
+#include <memory>
+#include <string>
 
 using namespace Nexus::rpc;
 
@@ -107,3 +112,317 @@ TEST(LockFreeQueueTest, MultiThreaded) {
     producer.join();
     consumer.join();
 }
+
+TEST(LockFreeQueueTest, ReserveCommit) {
+    LockFreeRingBuffer<1024> queue;
+    uint8_t data[128];
+    size_t size;
+
+    LockFreeRingBuffer<1024>::Reservation reservation;
+    ASSERT_TRUE(queue.tryReserve(5, reservation));
+    ASSERT_EQ(5u, reservation.size);
+
+    // Frame is not visible to the reader until committed
+    ASSERT_FALSE(queue.tryRead(data, size));
+
+    std::memcpy(reservation.data, "hello", 5);
+    queue.commit(reservation);
+
+    ASSERT_TRUE(queue.tryRead(data, size));
+    ASSERT_EQ(5u, size);
+    ASSERT_EQ(0, std::memcmp(data, "hello", 5));
+    ASSERT_EQ(1u, queue.getStats().messages_written);
+}
+
+TEST(LockFreeQueueTest, ReserveFailures) {
+    LockFreeRingBuffer<64> queue;
+    LockFreeRingBuffer<64>::Reservation reservation;
+
+    ASSERT_FALSE(queue.tryReserve(0, reservation));
+
+    // 4 x 16-byte frames fill the buffer
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryReserve(1, reservation));
+        queue.commit(reservation);
+    }
+    ASSERT_FALSE(queue.tryReserve(1, reservation));
+    ASSERT_EQ(1u, queue.getStats().messages_dropped);
+}
+
+TEST(LockFreeQueueTest, PeekConsume) {
+    LockFreeRingBuffer<1024> queue;
+    LockFreeRingBuffer<1024>::ReadView view;
+
+    ASSERT_FALSE(queue.tryPeek(view));
+
+    uint8_t msg[] = {7, 8, 9};
+    ASSERT_TRUE(queue.tryWrite(msg, sizeof(msg)));
+
+    // Peeking twice returns the same frame until it is consumed
+    ASSERT_TRUE(queue.tryPeek(view));
+    ASSERT_EQ(sizeof(msg), view.size);
+    ASSERT_EQ(7, view.data[0]);
+    ASSERT_TRUE(queue.tryPeek(view));
+    ASSERT_EQ(7, view.data[0]);
+    ASSERT_FALSE(queue.empty());
+
+    queue.consume(view);
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.tryPeek(view));
+    ASSERT_EQ(1u, queue.getStats().messages_read);
+}
+
+TEST(LockFreeQueueTest, PeekAfterExactFill) {
+    // 4 x 16-byte frames end exactly at the end of the buffer
+    LockFreeRingBuffer<64> queue;
+    LockFreeRingBuffer<64>::ReadView view;
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            uint8_t val = static_cast<uint8_t>(round * 4 + i);
+            ASSERT_TRUE(queue.tryWrite(&val, 1));
+            ASSERT_TRUE(queue.tryPeek(view));
+            ASSERT_EQ(val, view.data[0]);
+            queue.consume(view);
+        }
+    }
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueueTest, ReserveNextBatch) {
+    LockFreeRingBuffer<1024> queue;
+    LockFreeRingBuffer<1024>::Reservation first;
+    LockFreeRingBuffer<1024>::Reservation second;
+    uint8_t data[128];
+    size_t size;
+
+    ASSERT_TRUE(queue.tryReserve(1, first));
+    first.data[0] = 1;
+    ASSERT_TRUE(queue.tryReserveNext(first, 1, second));
+    second.data[0] = 2;
+
+    // Nothing visible before the batch is committed
+    ASSERT_FALSE(queue.tryRead(data, size));
+
+    queue.commit(second);
+    ASSERT_EQ(2u, queue.getStats().messages_written);
+
+    ASSERT_TRUE(queue.tryRead(data, size));
+    ASSERT_EQ(1, data[0]);
+    ASSERT_TRUE(queue.tryRead(data, size));
+    ASSERT_EQ(2, data[0]);
+    ASSERT_FALSE(queue.tryRead(data, size));
+}
+
+TEST(LockFreeQueueTest, LargeFrames) {
+    LockFreeRingBuffer<65536> queue;
+    ASSERT_EQ(16384u - 8u, LockFreeRingBuffer<65536>::MAX_MSG_SIZE);
+    ASSERT_EQ(2040u, LockFreeRingBuffer<1024>::MAX_MSG_SIZE);
+
+    std::vector<uint8_t> msg(LockFreeRingBuffer<65536>::MAX_MSG_SIZE);
+    for (size_t i = 0; i < msg.size(); ++i) {
+        msg[i] = static_cast<uint8_t>(i * 7);
+    }
+    ASSERT_FALSE(queue.tryWrite(msg.data(), msg.size() + 1));
+
+    // Maximum-size frames keep fitting whatever the head position
+    LockFreeRingBuffer<65536>::ReadView view;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(queue.tryWrite(msg.data(), msg.size() - static_cast<size_t>(i) * 100));
+        ASSERT_TRUE(queue.tryPeek(view));
+        ASSERT_EQ(msg.size() - static_cast<size_t>(i) * 100, view.size);
+        ASSERT_EQ(0, std::memcmp(view.data, msg.data(), view.size));
+        queue.consume(view);
+    }
+}
+
+TEST(LockFreeQueueTest, CanReserveTracksCredit) {
+    LockFreeRingBuffer<4096> queue;
+    std::vector<uint8_t> msg(1000, 0x22);
+
+    ASSERT_TRUE(queue.canReserve(msg.size()));
+    ASSERT_FALSE(queue.canReserve(0));
+    ASSERT_FALSE(queue.canReserve(queue.maxMessageSize() + 1));
+
+    while (queue.canReserve(msg.size())) {
+        ASSERT_TRUE(queue.tryWrite(msg.data(), msg.size()));
+    }
+    ASSERT_FALSE(queue.tryWrite(msg.data(), msg.size()));
+
+    // Consumer frees space: credit comes back (via wrap-around once enough is released)
+    uint8_t data[2048];
+    size_t size;
+    ASSERT_TRUE(queue.tryRead(data, size));
+    ASSERT_TRUE(queue.tryRead(data, size));
+    ASSERT_TRUE(queue.canReserve(msg.size()));
+    ASSERT_TRUE(queue.tryWrite(msg.data(), msg.size()));
+}
+
+TEST(LockFreeQueueTest, RuntimeCapacity) {
+    LockFreeRingBuffer<65536> queue;
+    ASSERT_EQ(65536u, queue.capacity());
+
+    queue.setCapacity(4099);  // Rounded down to 8 bytes
+    ASSERT_EQ(4096u, queue.capacity());
+    ASSERT_EQ(2040u, queue.maxMessageSize());
+
+    // 1000-byte payload -> 1008-byte frame: 4 frames fill the reduced ring
+    std::vector<uint8_t> msg(1000, 0x11);
+    int written = 0;
+    while (queue.tryWrite(msg.data(), msg.size())) {
+        written++;
+    }
+    ASSERT_EQ(4, written);
+
+    // Wrap-around stays within the reduced capacity (keep one frame of slack
+    // so the wrapped write never lands exactly on the tail)
+    uint8_t data[2048];
+    size_t size;
+    ASSERT_TRUE(queue.tryRead(data, size));
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue.tryRead(data, size));
+        ASSERT_EQ(msg.size(), size);
+        ASSERT_TRUE(queue.tryWrite(msg.data(), msg.size()));
+    }
+
+    queue.setCapacity(0);
+    ASSERT_EQ(65536u, queue.capacity());
+}
+
+TEST(LockFreeQueueTest, DataQueueFitsMaxPacket) {
+    typedef LockFreeRingBuffer<SharedMemoryTransportV3::DATA_QUEUE_SIZE_BYTES> DataRing;
+
+    // Largest MessagePacket: full group, topic and payload, with a deadline trailer
+    std::string group(MessagePacket::MAX_GROUP_LEN, 'g');
+    std::string topic(MessagePacket::MAX_TOPIC_LEN, 't');
+    std::vector<uint8_t> payload(MessagePacket::MAX_PAYLOAD_LEN, 0x5a);
+    std::vector<uint8_t> frame = MessageBuilder::build("node", group, topic, payload.data(), payload.size());
+    frame.resize(frame.size() + sizeof(DeadlineStamp));
+    DataTrailer trailer;
+    trailer.send_ns = 1;
+    trailer.ttl_ns = 1000;
+    MessageBuilder::stampTrailer(reinterpret_cast<MessagePacket*>(frame.data()), trailer);
+    ASSERT_EQ(SharedMemoryTransportV3::MAX_DATA_FRAME_BYTES, frame.size());
+
+    // At the full and at the smallest runtime capacity
+    for (size_t capacity : {SharedMemoryTransportV3::DATA_QUEUE_SIZE_BYTES,
+                            SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES}) {
+        std::unique_ptr<DataRing> queue(new DataRing());
+        queue->setCapacity(capacity);
+        ASSERT_EQ(capacity, queue->capacity());
+        ASSERT_FALSE(queue->maxMessageSize() < SharedMemoryTransportV3::MAX_DATA_FRAME_BYTES);
+
+        // Fits whatever the head position, including across wrap-arounds
+        DataRing::ReadView view;
+        for (int i = 0; i < 12; ++i) {
+            ASSERT_TRUE(queue->tryWrite(frame.data(), frame.size()));
+            ASSERT_TRUE(queue->tryPeek(view));
+            ASSERT_EQ(frame.size(), view.size);
+            ASSERT_EQ(0, std::memcmp(view.data, frame.data(), view.size));
+            queue->consume(view);
+        }
+    }
+}
+
+TEST(BoundedMpmcQueueTest, FifoAndCapacity) {
+    BoundedMpmcQueue<std::string> queue(3);  // Not a power of two
+    ASSERT_EQ(3u, queue.capacity());
+    ASSERT_TRUE(queue.empty());
+
+    // Wrap around the ring several times
+    for (int lap = 0; lap < 5; ++lap) {
+        for (int i = 0; i < 3; ++i) {
+            std::string item = "msg" + std::to_string(i);
+            ASSERT_TRUE(queue.tryPush(item));
+            ASSERT_TRUE(item.empty());  // Moved into the queue
+        }
+        std::string extra = "extra";
+        ASSERT_FALSE(queue.tryPush(extra));
+        ASSERT_EQ(std::string("extra"), extra);  // Untouched on failure
+        ASSERT_EQ(3u, queue.size());
+
+        std::string out;
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(queue.tryPop(out));
+            ASSERT_EQ("msg" + std::to_string(i), out);
+        }
+        ASSERT_FALSE(queue.tryPop(out));
+    }
+
+    // A single slot cannot distinguish full from free: capacity is raised to 2
+    BoundedMpmcQueue<int> tiny(1);
+    ASSERT_EQ(2u, tiny.capacity());
+    int a = 1, b = 2, c = 3;
+    ASSERT_TRUE(tiny.tryPush(a));
+    ASSERT_TRUE(tiny.tryPush(b));
+    ASSERT_FALSE(tiny.tryPush(c));
+}
+
+TEST(BoundedMpmcQueueTest, MultiProducerWithEventCount) {
+    BoundedMpmcQueue<int> queue(64);
+    EventCount ready;
+    const int producers = 4;
+    const int per_producer = 20000;
+    std::atomic<int> done{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                int value = p * per_producer + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+                ready.notify();
+            }
+            done++;
+            ready.notifyAll();
+        });
+    }
+
+    // Single consumer: per-producer order must hold and nothing may be lost
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    while (received < producers * per_producer) {
+        int value;
+        if (queue.tryPop(value)) {
+            int p = value / per_producer;
+            ASSERT_GT(value % per_producer, last[p]);
+            last[p] = value % per_producer;
+            received++;
+            continue;
+        }
+        uint32_t key = ready.prepareWait();
+        if (!queue.empty() || done.load() == producers) {
+            ready.cancelWait();
+        } else {
+            ready.wait(key);
+        }
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(producers * per_producer, received);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(BoundedMpmcQueueTest, EventCountWaitFor) {
+    EventCount ec;
+
+    // No notification: times out
+    auto start = std::chrono::steady_clock::now();
+    uint32_t key = ec.prepareWait();
+    ASSERT_FALSE(ec.waitFor(key, std::chrono::milliseconds(20)));
+    ASSERT_GT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+              19);
+
+    // Notified before the deadline
+    key = ec.prepareWait();
+    std::thread notifier([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ec.notifyAll();
+    });
+    ASSERT_TRUE(ec.waitFor(key, std::chrono::seconds(5)));
+    notifier.join();
+}
@@ -164,3 +164,49 @@ TEST(LoggerCoverageTest, StreamMacros) {
     ASSERT_TRUE(err.find("Warn 3") != std::string::npos);
     ASSERT_TRUE(err.find("Error 4") != std::string::npos);
 }
+
+TEST(LoggerCoverageTest, DisabledLevelSkipsFormatting) {
+    auto& logger = Logger::instance();
+    OutputCapturer capturer;
+    logger.setLevel(Logger::Level::WARN);
+
+    int evaluated = 0;
+    auto operand = [&evaluated]() {
+        ++evaluated;
+        return std::string("expensive");
+    };
+    NEXUS_DEBUG("STREAM") << operand();
+    NEXUS_INFO("STREAM") << operand();
+    NEXUS_LOG_INFO("MACRO", operand());
+    ASSERT_EQ(0, evaluated);
+    ASSERT_FALSE(logger.enabled(Logger::Level::INFO));
+
+    NEXUS_WARN("STREAM") << operand();
+    ASSERT_EQ(1, evaluated);
+    logger.setLevel(Logger::Level::INFO);
+}
+
+TEST(LoggerCoverageTest, AsyncMode) {
+    auto& logger = Logger::instance();
+    OutputCapturer capturer;
+    logger.setLevel(Logger::Level::INFO);
+    logger.setShowTimestamp(false);
+
+    logger.setAsync(true, 64);
+    for (int i = 0; i < 20; ++i) {
+        NEXUS_INFO("ASYNC") << "line " << i;
+    }
+    NEXUS_ERROR("ASYNC") << "async error";
+    logger.flush();
+    logger.setAsync(false);
+
+    std::string out = capturer.getStdout();
+    ASSERT_TRUE(out.find("[INFO ] [ASYNC] line 0\n") != std::string::npos);
+    ASSERT_TRUE(out.find("[INFO ] [ASYNC] line 19\n") != std::string::npos);
+    ASSERT_TRUE(capturer.getStderr().find("async error") != std::string::npos);
+
+    // Synchronous again
+    NEXUS_INFO("ASYNC") << "sync line";
+    ASSERT_TRUE(capturer.getStdout().find("sync line") != std::string::npos);
+    logger.setShowTimestamp(true);
+}
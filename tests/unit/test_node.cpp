@@ -1,7 +1,16 @@
 #include "simple_test.h"
+#include "nexus/core/Config.h"
 #include "nexus/core/NodeImpl.h"
+#include "nexus/core/PollingSubscription.h"
+#include "nexus/core/Recorder.h"
+#include "nexus/core/TypedTopic.h"
+#include "nexus/registry/GlobalRegistry.h"
+#include <poll.h>
 #include <atomic>
+#include <cstring>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 using namespace Nexus;
 using namespace Nexus::rpc;
@@ -69,6 +78,93 @@ TEST(NodeImplTest, Unsubscribe) {
     ASSERT_EQ(0, count);
 }
 
+TEST(NodeImplTest, WildcardSubscribe) {
+    auto pub_node = std::make_shared<NodeImpl>("wild_pub", false, 0, TransportMode::AUTO);
+    pub_node->initialize(0);
+    auto sub_node = std::make_shared<NodeImpl>("wild_sub", false, 0, TransportMode::AUTO);
+    sub_node->initialize(0);
+
+    std::vector<std::string> received;
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    auto cb = [&](const std::string&, const std::string& topic, const uint8_t*, size_t) { received.push_back(topic); };
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)sub_node->subscribe("wild", {"camera/#/raw"}, cb, options));
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)sub_node->subscribe("wild", {"sensors/*", "camera/front/#"}, cb, options));
+    ASSERT_TRUE(sub_node->isSubscribed("wild", "sensors/*"));
+    ASSERT_TRUE(sub_node->isSubscribed("wild", "sensors/imu"));
+    ASSERT_FALSE(sub_node->isSubscribed("wild", "sensors/imu/raw"));
+
+    pub_node->publish("wild", "sensors/imu", "a");
+    pub_node->publish("wild", "sensors/imu", "b");  // Now subscribed by id
+    pub_node->publish("wild", "sensors/imu/raw", "c");
+    pub_node->publish("wild", "camera/front/left", "d");
+    pub_node->publish("other", "sensors/imu", "e");
+    ASSERT_EQ(3u, received.size());
+    ASSERT_EQ(std::string("camera/front/left"), received[2]);
+
+    // Dropping the pattern drops the topics it matched
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)sub_node->unsubscribe("wild", {"sensors/*"}));
+    ASSERT_FALSE(sub_node->isSubscribed("wild", "sensors/imu"));
+    pub_node->publish("wild", "sensors/imu", "f");
+    pub_node->publish("wild", "camera/front", "g");
+    ASSERT_EQ(4u, received.size());
+    ASSERT_EQ(std::string("camera/front"), received[3]);
+
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)sub_node->unsubscribe("wild", {}));
+    pub_node->publish("wild", "camera/front/left", "h");
+    ASSERT_EQ(4u, received.size());
+}
+
+TEST(NodeImplTest, LatestValueDispatch) {
+    auto pub_node = std::make_shared<NodeImpl>("latest_pub", false, 0, TransportMode::AUTO);
+    pub_node->initialize(0);
+    auto sub_node = std::make_shared<NodeImpl>("latest_sub", false, 0, TransportMode::AUTO);
+    sub_node->initialize(0);
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::mutex mutex;
+    std::vector<std::string> received;
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::LATEST;
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)sub_node->subscribe("state", {"pose"},
+                                   [&](const std::string&, const std::string&, const uint8_t* data, size_t size) {
+                                       entered = true;
+                                       while (!release) {
+                                           std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                       }
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       received.emplace_back(reinterpret_cast<const char*>(data), size);
+                                   },
+                                   options));
+
+    // The worker is busy with the first sample while 99 more arrive: only the newest is kept
+    pub_node->publish("state", "pose", "0");
+    for (int i = 0; i < 200 && !entered; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(entered.load());
+    for (int i = 1; i < 100; ++i) {
+        pub_node->publish("state", "pose", std::to_string(i));
+    }
+    release = true;
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() >= 2) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(2u, received.size());
+    ASSERT_EQ(std::string("0"), received[0]);
+    ASSERT_EQ(std::string("99"), received[1]);
+}
+
 TEST(NodeImplTest, AutoGenerateId) {
     auto node = std::make_shared<NodeImpl>("", false, 0, TransportMode::AUTO);
     node->initialize(0);
@@ -107,3 +203,816 @@ TEST(NodeImplTest, SelfMessage) {
     // NodeImpl filters self messages
     ASSERT_EQ(0, count);
 }
+
+TEST(NodeImplTest, PublishInPlace) {
+    auto node1 = std::make_shared<NodeImpl>("inplace_pub", false, 0, TransportMode::AUTO);
+    node1->initialize(0);
+
+    auto node2 = std::make_shared<NodeImpl>("inplace_sub", false, 0, TransportMode::AUTO);
+    node2->initialize(0);
+
+    std::atomic<int> received_count{0};
+    std::string last_msg;
+
+    node2->subscribe("group_ip", {"topic_ip"}, [&](const std::string&, const std::string&, const uint8_t* data, size_t size) {
+        last_msg.assign(reinterpret_cast<const char*>(data), size);
+        received_count++;
+    });
+
+    auto noop = [](uint8_t*, size_t) {};
+    ASSERT_EQ(Node::INVALID_ARG, node1->publishInPlace("", "topic_ip", 4, noop));
+    ASSERT_EQ(Node::INVALID_ARG, node1->publishInPlace("group_ip", "topic_ip", 4, nullptr));
+
+    ASSERT_EQ(Node::NO_ERROR, node1->publishInPlace("group_ip", "topic_ip", 4, [](uint8_t* payload, size_t size) {
+        std::memcpy(payload, "abcd", size);
+    }));
+
+    for (int i = 0; i < 20; ++i) {
+        if (received_count > 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(1, received_count);
+    ASSERT_EQ(std::string("abcd"), last_msg);
+}
+
+TEST(NodeImplTest, PublishBatch) {
+    auto node1 = std::make_shared<NodeImpl>("batch_pub", false, 0, TransportMode::AUTO);
+    node1->initialize(0);
+
+    auto node2 = std::make_shared<NodeImpl>("batch_sub", false, 0, TransportMode::AUTO);
+    node2->initialize(0);
+
+    std::atomic<int> received_count{0};
+
+    node2->subscribe("group_b", {"topic_b"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        received_count++;
+    });
+
+    ASSERT_EQ(Node::INVALID_ARG, node1->publishBatch("", "topic_b", {"x"}));
+    ASSERT_EQ(Node::NO_ERROR, node1->publishBatch("group_b", "topic_b", {}));
+    ASSERT_EQ(Node::NO_ERROR, node1->publishBatch("group_b", "topic_b", {"m1", "m2", "m3"}));
+
+    for (int i = 0; i < 50; ++i) {
+        if (received_count >= 3) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(3, received_count);
+}
+
+TEST(NodeImplTest, TopicHandles) {
+    auto node1 = std::make_shared<NodeImpl>("handle_pub", false, 0, TransportMode::AUTO);
+    node1->initialize(0);
+    auto node2 = std::make_shared<NodeImpl>("handle_sub", false, 0, TransportMode::AUTO);
+    node2->initialize(0);
+
+    // Same pair -> same handle; distinct pairs -> distinct dense ids
+    TopicHandle imu = node1->resolveTopic("sensors", "imu");
+    TopicHandle lidar = node1->resolveTopic("sensors", "lidar");
+    ASSERT_TRUE(imu.valid());
+    ASSERT_TRUE(imu == node2->resolveTopic("sensors", "imu"));
+    ASSERT_NE(imu.id(), lidar.id());
+    ASSERT_EQ(std::string("sensors"), imu.group());
+    ASSERT_EQ(std::string("imu"), imu.topic());
+    ASSERT_FALSE(node1->resolveTopic("", "imu").valid());
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)node1->publish(TopicHandle(), "x"));
+
+    std::atomic<int> imu_count{0};
+    std::atomic<int> lidar_count{0};
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)node2->subscribe(imu, [&](const std::string& group, const std::string& topic, const uint8_t*,
+                                             size_t size) {
+                  if (topic == "imu") {
+                      ASSERT_EQ(std::string("sensors"), group);
+                      ASSERT_EQ(5u, size);
+                      imu_count++;
+                  } else {
+                      lidar_count++;
+                  }
+              }));
+    ASSERT_TRUE(node2->isSubscribed("sensors", "imu"));
+    ASSERT_FALSE(node2->isSubscribed("sensors", "lidar"));
+
+    // Handle publish and string publish reach the same subscriber; unsubscribed topic is filtered
+    node1->publish(imu, "hello");
+    node1->publish("sensors", "imu", "world");
+    node1->publish(lidar, "dropped");
+
+    for (int i = 0; i < 50 && imu_count < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2, imu_count.load());
+    ASSERT_EQ(0, lidar_count.load());
+
+    // Unsubscribing stops delivery by id
+    node2->unsubscribe("sensors", {"imu"});
+    node1->publish(imu, "hello");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(2, imu_count.load());
+}
+
+TEST(NodeImplTest, InlineDispatch) {
+    auto node1 = std::make_shared<NodeImpl>("inline_pub", false, 0, TransportMode::AUTO);
+    node1->initialize(0);
+    auto node2 = std::make_shared<NodeImpl>("inline_sub", false, 0, TransportMode::AUTO);
+    node2->initialize(0);
+
+    std::atomic<int> received{0};
+    std::thread::id callback_thread;
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)node2->subscribe("inline", {"fast"},
+                                    [&](const std::string&, const std::string&, const uint8_t* payload, size_t size) {
+                                        ASSERT_EQ(std::string("ping"),
+                                                  std::string(reinterpret_cast<const char*>(payload), size));
+                                        callback_thread = std::this_thread::get_id();
+                                        received++;
+                                    },
+                                    options));
+
+    // In-process: the callback has run on the publishing thread before publish() returns
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)node1->publish("inline", "fast", "ping"));
+    ASSERT_EQ(1, received.load());
+    ASSERT_TRUE(callback_thread == std::this_thread::get_id());
+
+    // Re-subscribing with default options moves the topic back to the dispatch workers
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)node2->subscribe("inline", {"fast"},
+                                    [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+                                        callback_thread = std::this_thread::get_id();
+                                        received++;
+                                    }));
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)node1->publish("inline", "fast", "ping"));
+    for (int i = 0; i < 100 && received.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2, received.load());
+    ASSERT_TRUE(callback_thread != std::this_thread::get_id());
+}
+
+TEST(NodeImplTest, TopicStats) {
+    auto publisher = std::make_shared<NodeImpl>("stats_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto subscriber = std::make_shared<NodeImpl>("stats_sub", false, 0, TransportMode::AUTO);
+    subscriber->initialize(0);
+
+    // Queued topic whose callback can be held, and an inline one (callbacks are per group)
+    std::atomic<int> queued{0};
+    std::atomic<int> inline_count{0};
+    std::atomic<bool> hold{false};
+    std::atomic<bool> held{false};
+    subscriber->subscribe("stats", {"queued"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        while (hold.load()) {
+            held = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        queued++;
+    });
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    subscriber->subscribe(
+        "stats_inline", {"fast"},
+        [&](const std::string&, const std::string&, const uint8_t*, size_t) { inline_count++; },
+        options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Subscriptions reach the publisher
+
+    publisher->publish("stats", "queued", "12345");
+    publisher->publish("stats", "queued", "123");
+    publisher->publishBatch("stats", "queued", {"1", "22"});
+    publisher->publish("stats_inline", "fast", "abcd");
+    for (int i = 0; i < 100 && queued.load() < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(4, queued.load());
+    ASSERT_EQ(1, inline_count.load());
+
+    // Overflow while the worker is held in the callback
+    auto& config = Config::instance();
+    const size_t max_queue_size = config.node.max_queue_size;
+    config.node.max_queue_size = 2;
+    subscriber->setQueueOverflowPolicy(QueueOverflowPolicy::DROP_NEWEST);
+    hold = true;
+    publisher->publish("stats", "queued", "x");
+    for (int i = 0; i < 100 && !held.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (int i = 0; i < 5; ++i) {
+        publisher->publish("stats", "queued", "y");
+    }
+    hold = false;
+    config.node.max_queue_size = max_queue_size;
+    for (int i = 0; i < 100 && queued.load() < 7; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(7, queued.load());
+
+    auto find = [](const std::vector<TopicStats>& all, const std::string& group, const std::string& topic) {
+        for (const auto& stats : all) {
+            if (stats.group == group && stats.topic == topic) {
+                return stats;
+            }
+        }
+        return TopicStats();
+    };
+
+    const auto published = publisher->getTopicStats();
+    ASSERT_EQ(10u, find(published, "stats", "queued").published);
+    ASSERT_EQ(17u, find(published, "stats", "queued").published_bytes);
+    ASSERT_EQ(0u, find(published, "stats", "queued").delivered);
+    ASSERT_EQ(1u, find(published, "stats_inline", "fast").published);
+
+    const auto received = subscriber->getTopicStats();
+    const TopicStats queued_stats = find(received, "stats", "queued");
+    ASSERT_EQ(0u, queued_stats.published);
+    ASSERT_EQ(7u, queued_stats.delivered);
+    ASSERT_EQ(14u, queued_stats.delivered_bytes);
+    ASSERT_EQ(3u, queued_stats.dropped);
+    ASSERT_GT(queued_stats.callback_ns, 1000000u);  // Held for at least a millisecond
+    ASSERT_EQ(1u, find(received, "stats_inline", "fast").delivered);
+    ASSERT_EQ(4u, find(received, "stats_inline", "fast").delivered_bytes);
+}
+
+TEST(NodeImplTest, MetricsSegment) {
+    auto& config = Config::instance();
+    config.node.metrics_interval_ms = 20;
+    auto publisher = std::make_shared<NodeImpl>("metrics_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    config.node.metrics_interval_ms = 0;
+
+    publisher->publish("metrics", "topic", "12345");
+    publisher->publish("metrics", "topic", "678");
+
+    MetricsSnapshot snapshot;
+    const MetricsSnapshot::Row* row = nullptr;
+    for (int i = 0; i < 100 && !row; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (MetricsSegment::read(MetricsSegment::segmentName("metrics_pub"), snapshot) && !snapshot.topics.empty()) {
+            row = &snapshot.topics[0];
+        }
+    }
+    ASSERT_TRUE(row != nullptr);
+    ASSERT_EQ(std::string("metrics_pub"), snapshot.node_id);
+    ASSERT_TRUE(snapshot.alive);
+    ASSERT_GT(snapshot.update_ms, 0u);
+    ASSERT_EQ(std::string("metrics/topic"), row->name);
+    ASSERT_EQ(2u, row->values[MetricsLayout::TOPIC_PUBLISHED]);
+    ASSERT_EQ(8u, row->values[MetricsLayout::TOPIC_PUBLISHED_BYTES]);
+
+    publisher.reset();
+    ASSERT_FALSE(MetricsSegment::read(MetricsSegment::segmentName("metrics_pub"), snapshot));
+}
+
+TEST(NodeImplTest, WatermarkCallbacks) {
+    auto node = std::make_shared<NodeImpl>("watermark_node", false, 0, TransportMode::AUTO);
+    node->initialize(0);
+    auto publisher = std::make_shared<NodeImpl>("watermark_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    ASSERT_EQ(Node::INVALID_ARG, node->setWatermarks(50, 50));
+    ASSERT_EQ(Node::INVALID_ARG, node->setWatermarks(101, 20));
+    ASSERT_EQ(Node::NO_ERROR, node->setWatermarks(50, 20));
+
+    std::mutex mutex;
+    std::vector<WatermarkEvent> events;
+    node->setWatermarkCallback([&](const WatermarkEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event);
+    });
+    auto eventCount = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size();
+    };
+
+    std::atomic<bool> hold{true};
+    std::atomic<int> delivered{0};
+    node->subscribe("watermark", {"topic"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        while (hold.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        delivered++;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Subscription reaches the publisher
+
+    auto& config = Config::instance();
+    const size_t max_queue_size = config.node.max_queue_size;
+    config.node.max_queue_size = 10;
+    for (int i = 0; i < 8; ++i) {
+        publisher->publish("watermark", "topic", "x");  // One is held in the callback, the rest queue up
+    }
+    for (int i = 0; i < 100 && eventCount() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, eventCount());
+
+    hold = false;
+    for (int i = 0; i < 100 && (eventCount() < 2 || delivered.load() < 8); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    config.node.max_queue_size = max_queue_size;
+    node->setWatermarkCallback(nullptr);
+
+    ASSERT_EQ(8, delivered.load());
+    ASSERT_EQ(2u, events.size());
+    ASSERT_TRUE(events[0].source == WatermarkSource::WORKER_QUEUE);
+    ASSERT_TRUE(events[0].high);
+    ASSERT_EQ(std::string("watermark"), events[0].group);
+    ASSERT_EQ(std::string("topic"), events[0].name);
+    ASSERT_EQ(10u, events[0].capacity);
+    ASSERT_FALSE(events[1].high);
+    ASSERT_LT(events[1].level, 3u);
+}
+
+TEST(NodeImplTest, MemoryUsage) {
+    auto node = std::make_shared<NodeImpl>("memory_node", false, 0, TransportMode::AUTO);
+    node->initialize(0);
+
+    MemoryUsage usage = node->getMemoryUsage();
+    ASSERT_EQ(std::string("memory_node"), usage.shm_segment.name);
+    ASSERT_GT(usage.shm_segment.mapped, size_t(1024 * 1024));  // NodeSharedMemory: rings of every inbound queue
+    ASSERT_GT(usage.shm_segment.resident, 0u);  // Header written at creation
+    ASSERT_LT(usage.shm_segment.resident, usage.shm_segment.mapped);  // Rings untouched so far
+    ASSERT_TRUE(usage.large_writers.empty());
+    ASSERT_EQ(0u, usage.queued_messages);
+    ASSERT_GT(usage.process_resident, 0u);
+
+    auto channel = node->getLargeDataChannel("memory_channel");
+    ASSERT_TRUE(channel != nullptr);
+    std::vector<uint8_t> data(256 * 1024, 0x5a);
+    ASSERT_GT(channel->write("memory", data.data(), data.size()), -1);
+
+    node->subscribe("memory", {"topic"}, [](const std::string&, const std::string&, const uint8_t*, size_t) {});
+    usage = node->getMemoryUsage();
+    ASSERT_EQ(1u, usage.large_writers.size());
+    ASSERT_EQ(std::string("memory_channel"), usage.large_writers[0].name);
+    ASSERT_GT(usage.large_writers[0].mapped, channel->getCapacity() - 1);
+    ASSERT_GT(usage.large_writers[0].resident, data.size() - 1);  // Written pages are backed
+    ASSERT_LT(usage.large_writers[0].resident, usage.large_writers[0].mapped);
+    ASSERT_GT(usage.queue_bytes, 0u);
+
+    node->unsubscribe("memory", {"topic"});
+}
+
+TEST(NodeImplTest, InProcessSubscriberLists) {
+    auto publisher = std::make_shared<NodeImpl>("lists_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto exact = std::make_shared<NodeImpl>("lists_exact", false, 0, TransportMode::AUTO);
+    exact->initialize(0);
+    auto wildcard = std::make_shared<NodeImpl>("lists_wildcard", false, 0, TransportMode::AUTO);
+    wildcard->initialize(0);
+    auto idle = std::make_shared<NodeImpl>("lists_idle", false, 0, TransportMode::AUTO);
+    idle->initialize(0);
+
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    std::atomic<int> exact_count{0};
+    std::atomic<int> wildcard_count{0};
+    exact->subscribe("lists", {"a/x"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        exact_count++;
+    }, options);
+    wildcard->subscribe("lists", {"a/*"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        wildcard_count++;
+    }, options);
+
+    auto& registry = GlobalRegistry::instance();
+    TopicHandle x = registry.findTopic("lists", "a/x");
+    auto subscribers = registry.getInProcessSubscribers();
+    ASSERT_EQ(1u, subscribers->topic(x.id()).size());
+    ASSERT_TRUE(subscribers->topic(x.id())[0].lock() == exact);
+    ASSERT_EQ(1u, subscribers->patterns("lists").size());
+    ASSERT_TRUE(subscribers->patterns("other").empty());
+
+    publisher->publish("lists", "a/x", "1");
+    publisher->publish("lists", "a/x", "2");
+    publisher->publish("lists", "b/x", "3");
+
+    // The wildcard matched a/x on first delivery and is now listed under it, once
+    subscribers = registry.getInProcessSubscribers();
+    int exact_received = exact_count;
+    int wildcard_received = wildcard_count;
+    ASSERT_EQ(2, exact_received);
+    ASSERT_EQ(2, wildcard_received);
+    ASSERT_EQ(2u, subscribers->topic(x.id()).size());
+
+    exact->unsubscribe("lists", {"a/x"});
+    wildcard->unsubscribe("lists", {});
+    subscribers = registry.getInProcessSubscribers();
+    ASSERT_TRUE(subscribers->topic(x.id()).empty());
+    ASSERT_TRUE(subscribers->patterns("lists").empty());
+
+    // A destroyed node leaves the lists
+    exact->subscribe("lists", {"a/x"}, [](const std::string&, const std::string&, const uint8_t*, size_t) {});
+    ASSERT_EQ(1u, registry.getInProcessSubscribers()->topic(x.id()).size());
+    exact.reset();
+    ASSERT_TRUE(registry.getInProcessSubscribers()->topic(x.id()).empty());
+}
+
+TEST(NodeImplTest, FanOutSharesPayload) {
+    auto publisher = std::make_shared<NodeImpl>("fanout_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+
+    // Queued (worker) delivery on every subscriber: all of them read the one pooled copy
+    const int kSubscribers = 4;
+    const int kMessages = 50;
+    std::vector<std::shared_ptr<NodeImpl>> subscribers;
+    std::atomic<int> received{0};
+    std::atomic<int> corrupted{0};
+    for (int i = 0; i < kSubscribers; ++i) {
+        auto node = std::make_shared<NodeImpl>("fanout_sub" + std::to_string(i), false, 0, TransportMode::AUTO);
+        node->initialize(0);
+        node->subscribe("fanout", {"data"}, [&](const std::string&, const std::string&, const uint8_t* data,
+                                                size_t size) {
+            if (size != 2000 || data[0] != data[size - 1]) {
+                corrupted++;
+            }
+            received++;
+        });
+        subscribers.push_back(node);
+    }
+
+    for (int i = 0; i < kMessages; ++i) {
+        publisher->publish("fanout", "data", std::string(2000, static_cast<char>('a' + i % 26)));
+    }
+    for (int i = 0; i < 200 && received < kSubscribers * kMessages; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int total = received;
+    int bad = corrupted;
+    ASSERT_EQ(kSubscribers * kMessages, total);
+    ASSERT_EQ(0, bad);
+}
+
+TEST(NodeImplTest, PollingSubscription) {
+    auto publisher = std::make_shared<NodeImpl>("polling_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto subscriber = std::make_shared<NodeImpl>("polling_sub", false, 0, TransportMode::AUTO);
+    subscriber->initialize(0);
+
+    auto polling = subscriber->subscribePolling("polling", {"pose", "scan/*"}, 4);
+    ASSERT_TRUE(polling != nullptr);
+    ASSERT_TRUE(subscriber->subscribePolling("", {"pose"}) == nullptr);
+    ASSERT_TRUE(subscriber->isSubscribed("polling", "pose"));
+
+    // Nothing queued: the descriptor is not readable
+    PolledMessage message;
+    ASSERT_FALSE(polling->tryTake(message));
+    ASSERT_FALSE(polling->wait(0));
+
+    // In-process publishes are queued on the publisher's thread; the descriptor turns readable
+    publisher->publish("polling", "pose", "p1");
+    publisher->publish("polling", "scan/front", "s1");
+    pollfd pfd = {polling->fd(), POLLIN, 0};
+    ASSERT_EQ(1, poll(&pfd, 1, 1000));
+    ASSERT_EQ(2u, polling->size());
+
+    PolledMessage batch[8];
+    ASSERT_EQ(2u, polling->takeBatch(batch, 8));
+    ASSERT_EQ("pose", batch[0].topicName());
+    ASSERT_EQ("p1", std::string(reinterpret_cast<const char*>(batch[0].data()), batch[0].size()));
+    ASSERT_EQ("scan/front", batch[1].topicName());
+    ASSERT_EQ("polling", batch[1].group());
+    ASSERT_FALSE(polling->tryTake(message));
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+
+    // Full queue: drop-oldest (the default policy) keeps the newest four
+    for (int i = 0; i < 6; ++i) {
+        publisher->publish("polling", "pose", std::to_string(i));
+    }
+    ASSERT_EQ(4u, polling->size());
+    ASSERT_EQ(2u, polling->dropped());
+    ASSERT_TRUE(polling->tryTake(message));
+    ASSERT_EQ("2", std::string(reinterpret_cast<const char*>(message.data()), message.size()));
+
+    // After unsubscribing, queued messages can still be taken but no new ones arrive
+    subscriber->unsubscribe("polling", {"pose", "scan/*"});
+    publisher->publish("polling", "pose", "late");
+    ASSERT_EQ(3u, polling->takeBatch(batch, 8));
+    ASSERT_FALSE(polling->tryTake(message));
+}
+
+TEST(NodeImplTest, MessageDeadlines) {
+    auto publisher = std::make_shared<NodeImpl>("deadline_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto subscriber = std::make_shared<NodeImpl>("deadline_sub", false, 0, TransportMode::AUTO);
+    subscriber->initialize(0);
+
+    std::vector<std::string> received;
+    std::mutex received_mutex;
+    std::atomic<bool> hold{false};
+    std::atomic<bool> held{false};
+    subscriber->subscribe("deadline", {"pose"},
+                          [&](const std::string&, const std::string&, const uint8_t* data, size_t size) {
+                              while (hold.load()) {
+                                  held = true;
+                                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                              }
+                              std::lock_guard<std::mutex> lock(received_mutex);
+                              received.emplace_back(reinterpret_cast<const char*>(data), size);
+                          });
+    auto polling = subscriber->subscribePolling("deadline_poll", {"state"});
+    ASSERT_TRUE(polling != nullptr);
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)publisher->setTopicTtl("", "state", 1000));
+
+    // Messages that outlive their deadline behind a slow callback are dropped, not delivered late
+    hold = true;
+    publisher->publish("deadline", "pose", "first");
+    for (int i = 0; i < 100 && !held.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const uint8_t stale[] = {'s'};
+    for (int i = 0; i < 3; ++i) {
+        publisher->publishWithTtl("deadline", "pose", stale, sizeof(stale), 2000);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    publisher->publish("deadline", "pose", "fresh");
+    hold = false;
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(received_mutex);
+            if (received.size() >= 2) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        ASSERT_EQ(2u, received.size());
+        ASSERT_EQ("first", received[0]);
+        ASSERT_EQ("fresh", received[1]);
+    }
+
+    // Per-topic time-to-live set on the publisher; a polling queue skips what expired in it
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)publisher->setTopicTtl("deadline_poll", "state", 1000));
+    publisher->publish("deadline_poll", "state", "old");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    PolledMessage message;
+    ASSERT_FALSE(polling->tryTake(message));
+    ASSERT_EQ(1u, polling->expired());
+
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)publisher->setTopicTtl("deadline_poll", "state", 0));
+    publisher->publish("deadline_poll", "state", "new");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(polling->tryTake(message));
+    ASSERT_EQ("new", std::string(reinterpret_cast<const char*>(message.data()), message.size()));
+
+    uint64_t expired = 0;
+    for (const auto& stats : subscriber->getTopicStats()) {
+        if (stats.group == "deadline" && stats.topic == "pose") {
+            expired = stats.expired;
+        }
+    }
+    ASSERT_EQ(3u, expired);
+    ASSERT_EQ(3u, subscriber->getQueueStats().total_expired);
+}
+
+TEST(NodeImplTest, BinaryAndGatherPublish) {
+    auto node1 = std::make_shared<NodeImpl>("binary_pub", false, 0, TransportMode::AUTO);
+    node1->initialize(0);
+    auto node2 = std::make_shared<NodeImpl>("binary_sub", false, 0, TransportMode::AUTO);
+    node2->initialize(0);
+
+    std::vector<std::string> received;
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    node2->subscribe(
+        "binary", {"frame"},
+        [&](const std::string&, const std::string&, const uint8_t* payload, size_t size) {
+            received.emplace_back(reinterpret_cast<const char*>(payload), size);
+        },
+        options);
+
+    struct Header {
+        uint32_t id;
+        uint32_t length;
+    };
+    const Header header = {7, 5};
+    const char body[] = "hello";
+
+    // Raw bytes, no Property wrapper
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)node1->publish("binary", "frame", reinterpret_cast<const uint8_t*>(body), 5));
+
+    // Header and body gathered into one payload (empty segments are skipped)
+    Node::PayloadSegment segments[] = {{&header, sizeof(header)}, {nullptr, 0}, {body, 5}};
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)node1->publishv("binary", "frame", segments, 3));
+
+    ASSERT_EQ(2u, received.size());
+    ASSERT_EQ(std::string("hello"), received[0]);
+    ASSERT_EQ(sizeof(header) + 5, received[1].size());
+    Header copy;
+    std::memcpy(&copy, received[1].data(), sizeof(copy));
+    ASSERT_EQ(7u, copy.id);
+    ASSERT_EQ(std::string("hello"), received[1].substr(sizeof(header)));
+
+    // Invalid arguments
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)node1->publish("binary", "frame", nullptr, 4));
+    Node::PayloadSegment bad[] = {{nullptr, 4}};
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)node1->publishv("binary", "frame", bad, 1));
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)node1->publishv("", "frame", segments, 3));
+}
+
+namespace {
+struct Pose {
+    double x;
+    double y;
+    uint32_t frame;
+};
+struct OtherPose {  // Same size as Pose, different type
+    double a;
+    double b;
+    uint32_t c;
+};
+}  // namespace
+
+TEST(NodeImplTest, TypedPublishSubscribe) {
+    auto pub_node = std::make_shared<NodeImpl>("typed_pub", false, 0, TransportMode::AUTO);
+    pub_node->initialize(0);
+    auto sub_node = std::make_shared<NodeImpl>("typed_sub", false, 0, TransportMode::AUTO);
+    sub_node->initialize(0);
+
+    ASSERT_NE(typeHash<Pose>(), typeHash<OtherPose>());
+
+    std::vector<Pose> received;
+    SubscribeOptions options;
+    options.dispatch = DispatchMode::INLINE;
+    TypedSubscriber<Pose> subscriber(sub_node, "typed", "pose");
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)subscriber.subscribe([&](const Pose& pose) { received.push_back(pose); }, options));
+
+    TypedPublisher<Pose> publisher(pub_node, "typed", "pose");
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)publisher.publish(Pose{1.5, -2.0, 42}));
+    ASSERT_EQ(1u, received.size());
+    ASSERT_TRUE(received[0].x == 1.5 && received[0].y == -2.0);
+    ASSERT_EQ(42u, received[0].frame);
+
+    // Wrong type with the same size, and untyped payloads, are rejected
+    TypedPublisher<OtherPose> other(pub_node, "typed", "pose");
+    other.publish(OtherPose{0, 0, 0});
+    pub_node->publish("typed", "pose", "raw");
+    ASSERT_EQ(1u, received.size());
+    ASSERT_EQ(2u, subscriber.rejected());
+
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)subscriber.unsubscribe());
+    ASSERT_FALSE(sub_node->isSubscribed("typed", "pose"));
+}
+
+TEST(NodeImplTest, RequestResponseCall) {
+    auto server = std::make_shared<NodeImpl>("rpc_server", false, 0, TransportMode::AUTO);
+    server->initialize(0);
+    auto caller = std::make_shared<NodeImpl>("rpc_caller", false, 0, TransportMode::AUTO);
+    caller->initialize(0);
+
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)server->serve("math", "double", [](const uint8_t* request, size_t size, std::string& response) {
+                  response.assign(reinterpret_cast<const char*>(request), size);
+                  response += response;
+              }));
+    ASSERT_EQ((int)Node::Error::ALREADY_EXISTS,
+              (int)server->serve("math", "double", [](const uint8_t*, size_t, std::string&) {}));
+
+    std::string response;
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)caller->call("math", "double", "ab", response, 100));
+    ASSERT_EQ(std::string("abab"), response);
+
+    Node::Error async_error = Node::Error::UNEXPECTED_ERROR;
+    std::string async_response;
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)caller->callAsync("math", "double", "x", 100, [&](Node::Error error, const uint8_t* data, size_t size) {
+                  async_error = error;
+                  async_response.assign(reinterpret_cast<const char*>(data), size);
+              }));
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)async_error);
+    ASSERT_EQ(std::string("xx"), async_response);
+
+    // A node calling a method it serves itself runs the handler in-process
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)server->call("math", "double", "s", response, 100));
+    ASSERT_EQ(std::string("ss"), response);
+
+    ASSERT_EQ((int)Node::Error::NOT_FOUND, (int)caller->call("math", "triple", "x", response, 100));
+    ASSERT_EQ((int)Node::Error::INVALID_ARG, (int)caller->call("", "double", "x", response, 100));
+
+    ASSERT_EQ((int)Node::Error::NO_ERROR, (int)server->unserve("math", "double"));
+    ASSERT_EQ((int)Node::Error::NOT_FOUND, (int)server->unserve("math", "double"));
+    ASSERT_EQ((int)Node::Error::NOT_FOUND, (int)caller->call("math", "double", "x", response, 100));
+}
+
+TEST(RecorderTest, RecordAndReplay) {
+    const std::string base = "/tmp/nexus_recorder_test_" + std::to_string(getpid());
+    auto publisher = std::make_shared<NodeImpl>("rec_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto recording = std::make_shared<NodeImpl>("rec_recorder", false, 0, TransportMode::AUTO);
+    recording->initialize(0);
+
+    Recorder recorder(recording);
+    ASSERT_EQ(recorder.recordTopics("rec", {"pose"}), Node::Error::NOT_INITIALIZED);
+    ASSERT_TRUE(recorder.start(base));
+    ASSERT_EQ(recorder.recordTopics("rec", {"pose", "scan/*"}), Node::Error::NO_ERROR);
+    ASSERT_EQ(recorder.recordLargeData("rec_camera"), Node::Error::NO_ERROR);
+
+    std::vector<uint8_t> image(256 * 1024, 0x42);
+    for (int i = 0; i < 10; ++i) {
+        publisher->publish("rec", "pose", "pose" + std::to_string(i));
+        publisher->publish("rec", "scan/front", std::string(100, 's'));
+    }
+    ASSERT_EQ(publisher->writeLargeData("rec_camera", "image", image.data(), image.size()), Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && recorder.getStats().frames < 21; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    recorder.stop();
+    RecordWriter::Stats stats = recorder.getStats();
+    ASSERT_EQ(21u, stats.frames);
+    ASSERT_EQ(0u, stats.dropped);
+
+    // Replay as fast as possible to a fresh subscriber and large data reader
+    auto listener = std::make_shared<NodeImpl>("rec_listener", false, 0, TransportMode::AUTO);
+    listener->initialize(0);
+    std::vector<std::string> poses;
+    std::atomic<int> scans{0};
+    std::atomic<size_t> image_bytes{0};
+    SubscribeOptions inline_options;
+    inline_options.dispatch = DispatchMode::INLINE;
+    listener->subscribe("rec", {"pose", "scan/front"}, [&](const std::string&, const std::string& topic,
+                                                           const uint8_t* data, size_t size) {
+        if (topic == "pose") {
+            poses.emplace_back(reinterpret_cast<const char*>(data), size);
+        } else {
+            scans++;
+        }
+    }, inline_options);
+    listener->subscribeLargeData("rec_camera", [&](const std::string&, const std::string&, const uint8_t*,
+                                                   size_t size, uint64_t) { image_bytes += size; });
+
+    auto replaying = std::make_shared<NodeImpl>("rec_replayer", false, 0, TransportMode::AUTO);
+    replaying->initialize(0);
+    Replayer replayer(replaying);
+    Replayer::Options options;
+    options.speed = 0;
+    ASSERT_TRUE(replayer.run(base, options));
+    for (int i = 0; i < 100 && image_bytes < image.size(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    listener->unsubscribeLargeData("rec_camera");
+
+    Replayer::Stats replayed = replayer.getStats();
+    ASSERT_EQ(20u, replayed.messages);
+    ASSERT_EQ(1u, replayed.large_blocks);
+    ASSERT_EQ(10u, poses.size());
+    ASSERT_EQ(std::string("pose0"), poses.front());
+    ASSERT_EQ(std::string("pose9"), poses.back());
+    int scan_count = scans;
+    ASSERT_EQ(10, scan_count);
+    size_t received_image = image_bytes;
+    ASSERT_EQ(image.size(), received_image);
+
+    ASSERT_FALSE(replayer.run(base + "_missing"));
+    unlink(RecordLayout::segmentPath(base, 0).c_str());
+}
+
+TEST(NodeImplTest, NodeWideQueueLimit) {
+    auto& config = Config::instance();
+    const Config::NodeConfig saved = config.node;
+    config.node.per_topic_queue_size = 3;  // Rings of lanes created from now on
+    auto publisher = std::make_shared<NodeImpl>("limit_pub", false, 0, TransportMode::AUTO);
+    publisher->initialize(0);
+    auto subscriber = std::make_shared<NodeImpl>("limit_sub", false, 0, TransportMode::AUTO);
+    subscriber->initialize(0);
+    subscriber->setQueueOverflowPolicy(QueueOverflowPolicy::DROP_NEWEST);
+
+    std::atomic<bool> hold{true};
+    std::atomic<int> held{0};
+    std::atomic<int> delivered{0};
+    subscriber->subscribe("limit", {"a", "b"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        held++;
+        while (hold.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        delivered++;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Subscription reaches the publisher
+
+    // One message per topic held by a worker, the rest stays queued
+    publisher->publish("limit", "a", "x");
+    publisher->publish("limit", "b", "x");
+    for (int i = 0; i < 100 && held.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2, held.load());
+
+    config.node.max_queue_size = 4;
+    for (int i = 0; i < 4; ++i) {
+        publisher->publish("limit", "a", "y");  // Ring of 3: the fourth is dropped
+    }
+    for (int i = 0; i < 3; ++i) {
+        publisher->publish("limit", "b", "y");  // Its ring has room, the node has one slot left
+    }
+    hold = false;
+    for (int i = 0; i < 100 && delivered.load() < 6; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    config.node = saved;
+
+    ASSERT_EQ(6, delivered.load());
+    ASSERT_EQ(3u, subscriber->getQueueStats().total_dropped);
+}
@@ -3,6 +3,7 @@
 #include "nexus/core/NodeImpl.h"
 #undef private
 #include "nexus/core/Config.h"
+#include <mutex>
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -108,3 +109,114 @@ TEST(NodeImplAdvancedTest, SendLargeDataEdgeCases) {
     std::vector<uint8_t> data(100, 0);
     ASSERT_EQ(node->sendLargeData("g", "ch_test", "t", data.data(), data.size()), Node::Error::NO_ERROR);
 }
+
+TEST(NodeImplAdvancedTest, LargeDataDoorbell) {
+    auto writer = std::make_shared<NodeImpl>("doorbell_writer", false, 0);
+    writer->initialize(0);
+    auto reader = std::make_shared<NodeImpl>("doorbell_reader", false, 0);
+    reader->initialize(0);
+
+    std::mutex mutex;
+    std::vector<std::string> topics;
+    std::vector<size_t> sizes;
+    bool contents_ok = true;
+    auto callback = [&](const std::string& channel, const std::string& topic, const uint8_t* data, size_t size,
+                        uint64_t) {
+        std::lock_guard<std::mutex> lock(mutex);
+        contents_ok = contents_ok && channel == "ch_doorbell" && data[size - 1] == 0xAB;
+        topics.push_back(topic);
+        sizes.push_back(size);
+    };
+    ASSERT_EQ(reader->subscribeLargeData("ch_doorbell", nullptr), Node::Error::INVALID_ARG);
+    ASSERT_EQ(reader->subscribeLargeData("ch_doorbell", callback), Node::Error::NO_ERROR);
+    ASSERT_EQ(reader->subscribeLargeData("ch_doorbell", callback), Node::Error::ALREADY_EXISTS);
+
+    // No notification is published; the reader thread wakes on the channel itself
+    std::vector<uint8_t> data(4096, 0xAB);
+    ASSERT_EQ(writer->writeLargeData("ch_doorbell", "frame", data.data(), data.size()), Node::Error::NO_ERROR);
+    ASSERT_EQ(writer->sendLargeData("g", "ch_doorbell", "notified", data.data(), 100), Node::Error::NO_ERROR);
+    ASSERT_EQ(writer->writeLargeData("ch_doorbell", "", data.data(), data.size()), Node::Error::INVALID_ARG);
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (topics.size() == 2) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(2u, topics.size());
+        ASSERT_EQ(std::string("frame"), topics[0]);
+        ASSERT_EQ(4096u, sizes[0]);
+        ASSERT_EQ(std::string("notified"), topics[1]);
+        ASSERT_EQ(100u, sizes[1]);
+        ASSERT_TRUE(contents_ok);
+    }
+
+    ASSERT_EQ(reader->unsubscribeLargeData("ch_doorbell"), Node::Error::NO_ERROR);
+    ASSERT_EQ(reader->unsubscribeLargeData("ch_doorbell"), Node::Error::NOT_FOUND);
+}
+
+TEST(NodeImplAdvancedTest, LargeDataBridgeImport) {
+    auto source = std::make_shared<NodeImpl>("bridge_source", false, 0);
+    source->initialize(0);
+    auto sink = std::make_shared<NodeImpl>("bridge_sink", false, 0);
+    sink->initialize(0);
+
+    ASSERT_EQ(source->bridgeLargeData(""), Node::Error::INVALID_ARG);
+    ASSERT_EQ(source->bridgeLargeData("ch_bridge_src"), Node::Error::NO_ERROR);
+    ASSERT_EQ(source->bridgeLargeData("ch_bridge_src"), Node::Error::ALREADY_EXISTS);
+    ASSERT_EQ(sink->importLargeData("ch_bridge_src", "ch_bridge_dst"), Node::Error::NO_ERROR);
+    ASSERT_EQ(sink->importLargeData("ch_bridge_src", "ch_bridge_dst"), Node::Error::ALREADY_EXISTS);
+
+    // Imported blocks are read from the local channel like any other
+    std::mutex mutex;
+    std::vector<std::string> topics;
+    std::vector<std::vector<uint8_t>> blocks;
+    auto callback = [&](const std::string&, const std::string& topic, const uint8_t* data, size_t size, uint64_t) {
+        std::lock_guard<std::mutex> lock(mutex);
+        topics.push_back(topic);
+        blocks.emplace_back(data, data + size);
+    };
+    ASSERT_EQ(sink->subscribeLargeData("ch_bridge_dst", callback), Node::Error::NO_ERROR);
+
+    std::vector<uint8_t> frame(256 * 1024);
+    for (size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = static_cast<uint8_t>(i * 13);
+    }
+    ASSERT_EQ(source->writeLargeData("ch_bridge_src", "frame", frame.data(), frame.size()), Node::Error::NO_ERROR);
+
+    // A stream is replayed as a stream: chunks arrive whole and the object ends where the source ended it
+    auto channel = source->getLargeDataChannel("ch_bridge_src");
+    ASSERT_TRUE(channel != nullptr);
+    ASSERT_TRUE(channel->beginStream("object", 3000));
+    ASSERT_TRUE(channel->writeStream(frame.data(), 1000) >= 0);
+    ASSERT_TRUE(channel->writeStream(frame.data() + 1000, 2000, true) >= 0);
+
+    for (int i = 0; i < 400; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (blocks.size() >= 3) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(3u, blocks.size());
+        ASSERT_EQ(std::string("frame"), topics[0]);
+        ASSERT_TRUE(blocks[0] == frame);
+        ASSERT_EQ(std::string("object"), topics[1]);
+        std::vector<uint8_t> object(blocks[1]);
+        object.insert(object.end(), blocks[2].begin(), blocks[2].end());
+        ASSERT_TRUE(object == std::vector<uint8_t>(frame.begin(), frame.begin() + 3000));
+    }
+
+    ASSERT_EQ(sink->unsubscribeLargeData("ch_bridge_dst"), Node::Error::NO_ERROR);
+    ASSERT_EQ(source->unbridgeLargeData("ch_bridge_src"), Node::Error::NO_ERROR);
+    ASSERT_EQ(source->unbridgeLargeData("ch_bridge_src"), Node::Error::NOT_FOUND);
+}
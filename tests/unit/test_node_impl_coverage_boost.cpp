@@ -23,11 +23,14 @@
 #define private public
 #define protected public
 #include "nexus/core/NodeImpl.h"
+#include "nexus/core/RpcServer.h"
+#include "nexus/core/TopicBus.h"
 #undef private
 #undef protected
 
 #include "nexus/core/Config.h"
 #include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/SharedMemoryTransportV3.h"
 #include "nexus/transport/UdpTransport.h"
 
 using namespace Nexus;
@@ -94,6 +97,12 @@ public:
         node->processPacket(data, size, from);
     }
 
+    static void addPendingCall(std::shared_ptr<NodeImpl> node, uint64_t call_id, const Node::ReplyCallback& callback) {
+        std::lock_guard<std::mutex> lock(node->rpc_server_->calls_mutex_);
+        node->rpc_server_->pending_calls_[call_id] =
+            RpcServer::PendingCall{callback, std::chrono::steady_clock::now()};
+    }
+
     enum class SystemMessageType { SERVICE_REGISTER, SERVICE_UNREGISTER, NODE_JOIN, NODE_LEAVE };
 
     static void enqueueSystemMessage(std::shared_ptr<NodeImpl> node, SystemMessageType type, 
@@ -246,6 +255,37 @@ TEST(NodeImplCoverageBoostTest, QueueOverflowPolicies) {
     }
 }
 
+TEST(NodeImplCoverageBoostTest, EnqueueByNameFiltersUnsubscribed) {
+    auto node = std::make_shared<NodeImpl>("by_name_node", false, 0);
+    node->initialize(0);
+
+    std::atomic<int> received{0};
+    std::atomic<int> wrong{0};
+    node->subscribe("view_group", {"topic"},
+                    [&](const std::string& group, const std::string& topic, const uint8_t*, size_t) {
+                        (group == "view_group" && topic == "topic") ? received++ : wrong++;
+                    });
+
+    // Names are views into a larger buffer, as they are inside a received packet
+    const char frame[] = "view_groupxtopicx";
+    const uint8_t payload[4] = {1, 2, 3, 4};
+    NodeImplTester::enqueueMessage(node, "src", std::string(frame, 10), std::string(frame + 11, 5), payload, 4);
+    NodeImplTester::enqueueMessage(node, "src", "view_group", "other", payload, 4);
+    NodeImplTester::enqueueMessage(node, "src", "view_grou", "topic", payload, 4);
+
+    for (int i = 0; i < 100 && received.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, received.load());
+
+    // Unsubscribed: the name lookup no longer matches
+    node->unsubscribe("view_group", {"topic"});
+    NodeImplTester::enqueueMessage(node, "src", "view_group", "topic", payload, 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(1, received.load());
+    ASSERT_EQ(0, wrong.load());
+}
+
 TEST(NodeImplCoverageBoostTest, HandleServiceMessageEdgeCases) {
     ResetState();
     auto node = std::make_shared<NodeImpl>("test_node", false, 0);
@@ -522,6 +562,134 @@ TEST(NodeImplCoverageBoostTest, ProcessPacketCoverage) {
     process(Nexus::rpc::MessageType::DATA, "pp_cov_node");
 }
 
+TEST(NodeImplCoverageBoostTest, ProcessCompactPacket) {
+    auto node = std::make_shared<Nexus::rpc::NodeImpl>("compact_node", false, 0);
+    node->initialize(0);
+
+    std::atomic<int> received{0};
+    node->subscribe("compact_group", {"topic"},
+                    [&](const std::string& group, const std::string& topic, const uint8_t* data, size_t size) {
+                        if (group == "compact_group" && topic == "topic" && size == 3 &&
+                            std::memcmp(data, "abc", 3) == 0) {
+                            received++;
+                        }
+                    });
+    Nexus::rpc::TopicHandle handle = node->resolveTopic("compact_group", "topic");
+
+    auto process = [&](uint32_t topic_hash) {
+        std::vector<uint8_t> frame(Nexus::rpc::CompactPacket::packetSize(3));
+        auto* packet = Nexus::rpc::MessageBuilder::buildCompactHeader(frame.data(), handle.id(), topic_hash, 3);
+        std::memcpy(packet->getPayload(), "abc", 3);
+        packet->checksum = packet->calculateChecksum();
+        NodeImplTester::processPacket(node, frame.data(), frame.size(), "shm");
+    };
+
+    // Matching id and hash: delivered as group/topic
+    process(handle.hash());
+    // Stale id (hash of another topic): dropped
+    process(handle.hash() ^ 1);
+
+    for (int i = 0; i < 100 && received.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(1, received.load());
+}
+
+TEST(NodeImplCoverageBoostTest, TracedPacketLatency) {
+    Config::instance().node.latency_tracing = true;
+    auto node = std::make_shared<NodeImpl>("traced_node", false, 0);
+    Config::instance().node.latency_tracing = false;
+    node->initialize(0);
+
+    std::atomic<int> received{0};
+    node->subscribe("traced_group", {"topic"},
+                    [&](const std::string&, const std::string&, const uint8_t* data, size_t size) {
+                        if (size == 3 && std::memcmp(data, "abc", 3) == 0) {
+                            received++;
+                        }
+                    });
+    TopicHandle handle = node->resolveTopic("traced_group", "topic");
+
+    // Compact frame: stamp behind the payload, type changed before the checksum
+    std::vector<uint8_t> compact(CompactPacket::packetSize(3) + sizeof(TraceStamp));
+    CompactPacket* packet = MessageBuilder::buildCompactHeader(compact.data(), handle.id(), handle.hash(), 3);
+    std::memcpy(packet->getPayload(), "abc", 3);
+    MessageBuilder::stampSendTime(packet);
+    packet->checksum = packet->calculateChecksum();
+    ASSERT_TRUE(packet->isValid(compact.size()));
+    NodeImplTester::processPacket(node, compact.data(), compact.size(), "shm");
+
+    // Full packet, without room for the stamp: delivered, but no transit sample
+    std::vector<uint8_t> full = MessageBuilder::build("remote_node", "traced_group", "topic", "abc");
+    reinterpret_cast<MessagePacket*>(full.data())->msg_type = static_cast<uint8_t>(MessageType::TRACED_DATA);
+    reinterpret_cast<MessagePacket*>(full.data())->checksum =
+        reinterpret_cast<MessagePacket*>(full.data())->calculateChecksum();
+    NodeImplTester::processPacket(node, full.data(), full.size(), "shm");
+
+    for (int i = 0; i < 100 && received.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(2, received.load());
+
+    std::vector<TopicLatency> latency = node->getTopicLatency();
+    ASSERT_EQ(1u, latency.size());
+    ASSERT_TRUE(latency[0].group == "traced_group" && latency[0].topic == "topic");
+    ASSERT_EQ(1u, latency[0].transit.count);
+    ASSERT_EQ(2u, latency[0].receive.count);
+    ASSERT_EQ(2u, latency[0].queue.count);
+    ASSERT_EQ(2u, latency[0].callback.count);
+    ASSERT_GT(latency[0].transit.quantileNs(0.5), 0u);
+    ASSERT_LT(latency[0].transit.total_ns, 1000000000ull);
+}
+
+TEST(NodeImplCoverageBoostTest, DeadlinePacketExpiry) {
+    auto node = std::make_shared<NodeImpl>("deadline_node", false, 0);
+    node->initialize(0);
+
+    std::atomic<int> received{0};
+    node->subscribe("deadline_group", {"topic"},
+                    [&](const std::string&, const std::string&, const uint8_t*, size_t) { received++; });
+    TopicHandle handle = node->resolveTopic("deadline_group", "topic");
+
+    // Compact shm frames stamped with the sender's deadline: only the one still in time is delivered
+    auto process = [&](uint64_t send_ns, uint64_t ttl_ns) {
+        DataTrailer trailer;
+        trailer.send_ns = send_ns;
+        trailer.ttl_ns = ttl_ns;
+        std::vector<uint8_t> frame(CompactPacket::packetSize(3) + trailer.size());
+        CompactPacket* packet = MessageBuilder::buildCompactHeader(frame.data(), handle.id(), handle.hash(), 3);
+        std::memcpy(packet->getPayload(), "abc", 3);
+        MessageBuilder::stampTrailer(packet, trailer);
+        packet->checksum = packet->calculateChecksum();
+        NodeImplTester::processPacket(node, frame.data(), frame.size(), "shm");
+    };
+    const uint64_t now = TraceStamp::now();
+    process(now, 10000000000ull);     // 10 s left
+    process(now - 2000000, 1000000);  // Expired 1 ms ago
+
+    // Full packet, expired: dropped as well
+    std::vector<uint8_t> full = MessageBuilder::build("remote_node", "deadline_group", "topic", "abc");
+    full.resize(full.size() + sizeof(DeadlineStamp));
+    MessagePacket* packet = reinterpret_cast<MessagePacket*>(full.data());
+    MessageBuilder::stampTrailer(packet, DataTrailer{false, now - 2000000, 1000000});
+    packet->checksum = packet->calculateChecksum();
+    NodeImplTester::processPacket(node, full.data(), full.size(), "shm");
+
+    for (int i = 0; i < 100 && received.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(1, received.load());
+
+    const std::vector<TopicStats> stats = node->getTopicStats();
+    ASSERT_EQ(1u, stats.size());
+    ASSERT_EQ(2u, stats[0].expired);
+    ASSERT_EQ(1u, stats[0].delivered);
+    ASSERT_EQ(2u, node->getQueueStats().total_expired);
+}
+
 TEST(NodeImplCoverageBoostTest, SystemMessageCoverage) {
     auto node = std::make_shared<NodeImpl>("sys_msg_node", false, 0);
     node->initialize(0);
@@ -796,3 +964,534 @@ TEST(NodeImplCoverageBoostTest, UdpHeartbeatAndTimeout) {
     ASSERT_EQ(NodeImplTester::getRemoteNodesCount(node_impl), 1);
 }
 
+
+TEST(NodeImplCoverageBoostTest, CallRequestReplyOverSharedMemory) {
+    ResetState();
+    auto server = std::make_shared<NodeImpl>("rpc_server", false, 0, TransportMode::LOCK_FREE_SHM);
+    server->initialize(0);
+    auto caller = std::make_shared<NodeImpl>("rpc_caller", false, 0, TransportMode::LOCK_FREE_SHM);
+    caller->initialize(0);
+
+    std::atomic<bool> on_receive_thread{false};
+    const std::thread::id receive_thread = std::this_thread::get_id();  // processPacket() runs here
+    auto echo_handler = [&](const uint8_t* request, size_t size, std::string& response) {
+        on_receive_thread = on_receive_thread || std::this_thread::get_id() == receive_thread;
+        response.assign("re:").append(reinterpret_cast<const char*>(request), size);
+    };
+    ASSERT_EQ(Node::NO_ERROR, server->serve("rpc", "echo", echo_handler));
+    std::atomic<bool> release{false};
+    ASSERT_EQ(Node::NO_ERROR, server->serve("rpc", "slow", [&](const uint8_t*, size_t, std::string& response) {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        response = "done";
+    }));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::pair<Node::Error, std::string>> replies;
+    auto on_reply = [&](Node::Error error, const uint8_t* data, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        replies.emplace_back(error, std::string(reinterpret_cast<const char*>(data), size));
+        cv.notify_one();
+    };
+    NodeImplTester::addPendingCall(caller, 6, on_reply);
+    NodeImplTester::addPendingCall(caller, 7, on_reply);
+    NodeImplTester::addPendingCall(caller, 8, on_reply);
+
+    // REQUEST frames as the caller would send them; the server replies into the caller's queue
+    auto request = [&](const std::string& method, uint64_t call_id, const std::string& body) {
+        CallHeader header = {};
+        header.call_id = call_id;
+        std::string payload(reinterpret_cast<const char*>(&header), sizeof(header));
+        payload += body;
+        return MessageBuilder::build(caller->getNodeId(), "rpc", method, payload, 0, MessageType::REQUEST);
+    };
+    // A slow handler holds one call worker; the receive thread and the other requests go on
+    auto slow = request("slow", 6, "");
+    NodeImplTester::processPacket(server, slow.data(), slow.size(), caller->getNodeId());
+    auto echo = request("echo", 7, "ping");
+    NodeImplTester::processPacket(server, echo.data(), echo.size(), caller->getNodeId());
+    auto missing = request("missing", 8, "");
+    NodeImplTester::processPacket(server, missing.data(), missing.size(), caller->getNodeId());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_for(lock, std::chrono::seconds(2), [&] { return replies.size() == 2; });
+    ASSERT_EQ(2u, replies.size());
+    std::map<std::string, Node::Error> by_body;
+    for (const auto& reply : replies) {
+        by_body[reply.second] = reply.first;
+    }
+    ASSERT_EQ(1u, by_body.count("re:ping"));
+    ASSERT_EQ(Node::NO_ERROR, by_body["re:ping"]);
+    ASSERT_EQ(1u, by_body.count(""));
+    ASSERT_EQ(Node::NOT_FOUND, by_body[""]);
+    ASSERT_FALSE(on_receive_thread.load());
+
+    release = true;
+    cv.wait_for(lock, std::chrono::seconds(2), [&] { return replies.size() == 3; });
+    ASSERT_EQ(3u, replies.size());
+    ASSERT_EQ(std::string("done"), replies[2].second);
+    lock.unlock();
+
+    // A caller that left cannot be answered: the failed reply is counted
+    ASSERT_EQ(0u, server->getFailedReplyCount());
+    auto orphan = MessageBuilder::build("rpc_gone", "rpc", "echo", std::string(sizeof(CallHeader), '\0'), 0,
+                                        MessageType::REQUEST);
+    NodeImplTester::processPacket(server, orphan.data(), orphan.size(), "rpc_gone");
+    for (int i = 0; i < 200 && server->getFailedReplyCount() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(1u, server->getFailedReplyCount());
+}
+
+TEST(NodeImplCoverageBoostTest, ServicePriorityAdvertised) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("prio_node", false, 0);
+    node->initialize(0);
+
+    // SHARED_MEMORY subscription with topic id 7 and a trailing HIGH priority byte
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(ServiceType::NORMAL_MESSAGE),
+                                    static_cast<uint8_t>(TransportType::SHARED_MEMORY), 0, 0, 0, 7, 0, 0, 0,
+                                    static_cast<uint8_t>(MessagePriority::HIGH)};
+    NodeImplTester::handleServiceMessage(node, "prio_remote", "prio_group", "cmd", payload.data(), payload.size(), true);
+
+    // Older peers stop after the topic id: NORMAL
+    payload.pop_back();
+    NodeImplTester::handleServiceMessage(node, "prio_remote", "prio_group", "telemetry", payload.data(), payload.size(),
+                                         true);
+
+    int checked = 0;
+    for (const auto& svc : node->discoverServices("prio_group")) {
+        if (svc.node_id != "prio_remote") {
+            continue;
+        }
+        ASSERT_EQ(svc.topic_id, 7u);
+        ASSERT_TRUE(svc.priority == (svc.topic == "cmd" ? MessagePriority::HIGH : MessagePriority::NORMAL));
+        checked++;
+    }
+    ASSERT_EQ(checked, 2);
+
+    ASSERT_EQ((int)node->setTopicPriority("prio_group", "cmd", MessagePriority::HIGH), (int)Node::Error::NO_ERROR);
+    ASSERT_EQ((int)node->setTopicPriority("", "cmd", MessagePriority::HIGH), (int)Node::Error::INVALID_ARG);
+}
+
+TEST(NodeImplCoverageBoostTest, TopicBusReaderSlotAdvertised) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("slot_node", false, 0);
+    node->initialize(0);
+
+    // Bus reader descriptor: no topic id, version 0, no rate, then reader slot 3
+    const std::string channel = "slot_bus";
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(ServiceType::TOPIC_BUS),
+                                    static_cast<uint8_t>(TransportType::SHARED_MEMORY),
+                                    static_cast<uint8_t>(channel.size()), 0, 0};
+    payload.insert(payload.end(), channel.begin(), channel.end());
+    payload.insert(payload.end(), {0xFF, 0xFF, 0xFF, 0xFF, 1, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0});
+    NodeImplTester::handleServiceMessage(node, "slot_reader", "slot_group", "feed", payload.data(), payload.size(),
+                                         true);
+
+    // The publisher's own bus stops before the slot
+    payload.resize(payload.size() - 8);
+    NodeImplTester::handleServiceMessage(node, "slot_pub", "slot_group", "feed", payload.data(), payload.size(), true);
+
+    int checked = 0;
+    for (const auto& svc : node->discoverServices("slot_group", ServiceType::TOPIC_BUS)) {
+        ASSERT_TRUE(svc.topic_id == ServiceDescriptor::NO_TOPIC_ID);
+        if (svc.node_id == "slot_reader") {
+            ASSERT_EQ(svc.reader_slot, 3u);
+            checked++;
+        } else if (svc.node_id == "slot_pub") {
+            ASSERT_TRUE(svc.reader_slot == ServiceDescriptor::NO_READER_SLOT);
+            checked++;
+        }
+    }
+    ASSERT_EQ(checked, 2);
+}
+
+TEST(NodeImplCoverageBoostTest, SubscriberRateLimit) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("rate_node", true, 0);
+    node->initialize(0);
+    ASSERT_TRUE(node->udp_transport_ != nullptr);
+    SubscribeOptions negative;
+    negative.max_rate_hz = -1;
+    ASSERT_EQ((int)node->subscribe("rate_group", {"imu"},
+                                   [](const std::string&, const std::string&, const uint8_t*, size_t) {}, negative),
+              (int)Node::Error::INVALID_ARG);
+
+    // Two remote UDP subscribers: one takes every message, the other asked for at most one per second
+    std::atomic<int> full_count{0};
+    std::atomic<int> limited_count{0};
+    UdpTransport full_peer;
+    UdpTransport limited_peer;
+    ASSERT_TRUE(full_peer.initialize(0));
+    ASSERT_TRUE(limited_peer.initialize(0));
+    auto counter = [](std::atomic<int>& count) {
+        return [&count](const uint8_t* bytes, size_t size, const sockaddr_in&) {
+            if (size >= sizeof(MessagePacket) &&
+                reinterpret_cast<const MessagePacket*>(bytes)->msg_type == static_cast<uint8_t>(MessageType::DATA)) {
+                count++;
+            }
+        };
+    };
+    full_peer.setReceiveCallback(counter(full_count));
+    limited_peer.setReceiveCallback(counter(limited_count));
+
+    ServiceDescriptor full;
+    full.node_id = "rate_full";
+    full.group = "rate_group";
+    full.topic = "imu";
+    full.transport = TransportType::UDP;
+    full.udp_address = "127.0.0.1:" + std::to_string(full_peer.getPort());
+    GlobalRegistry::instance().registerService("rate_group", full);
+
+    // Unversioned descriptor with the rate: empty multicast group, version 0, then min_interval_us
+    const std::string address = "127.0.0.1:" + std::to_string(limited_peer.getPort());
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(ServiceType::NORMAL_MESSAGE),
+                                    static_cast<uint8_t>(TransportType::UDP), 0,
+                                    static_cast<uint8_t>(address.size()), 0};
+    payload.insert(payload.end(), address.begin(), address.end());
+    payload.insert(payload.end(), {0, 0, 0, 0, 0, 0x40, 0x42, 0x0F, 0x00});  // 1000000 us
+    NodeImplTester::handleServiceMessage(node, "rate_limited", "rate_group", "imu", payload.data(), payload.size(),
+                                         true);
+    uint32_t advertised = 0;
+    for (const auto& svc : node->discoverServices("rate_group")) {
+        if (svc.node_id == "rate_limited") {
+            advertised = svc.min_interval_us;
+        }
+    }
+    ASSERT_EQ(1000000u, advertised);
+
+    // A burst (single publishes and a batch) reaches the limited subscriber once
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ((int)node->publish("rate_group", "imu", "sample"), (int)Node::Error::NO_ERROR);
+    }
+    ASSERT_EQ((int)node->publishBatch("rate_group", "imu", {"a", "b", "c"}), (int)Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && full_count.load() < 23; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(23, full_count.load());
+    ASSERT_EQ(1, limited_count.load());
+
+    // Once the interval passed, the next message goes out again
+    std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+    ASSERT_EQ((int)node->publish("rate_group", "imu", "sample"), (int)Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && (limited_count.load() < 2 || full_count.load() < 24); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2, limited_count.load());
+    ASSERT_EQ(24, full_count.load());
+
+    full_peer.shutdown();
+    limited_peer.shutdown();
+    GlobalRegistry::instance().clearServices();
+}
+
+namespace {
+
+// Blocks of a topic bus meant for @p slot, read and released
+int drainTopicBus(LargeDataChannel& ring, int32_t slot) {
+    int blocks = 0;
+    LargeDataChannel::DataBlock block;
+    while (ring.tryRead(block)) {
+        blocks += block.isFor(slot) ? 1 : 0;
+        ring.releaseBlock(block);
+    }
+    return blocks;
+}
+
+}  // namespace
+
+TEST(NodeImplCoverageBoostTest, TopicBusPublisher) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("bus_pub", false, 0);
+    node->initialize(0);
+    ASSERT_TRUE(node->shm_transport_v3_ != nullptr && node->shm_transport_v3_->isInitialized());
+    ASSERT_EQ((int)node->setTopicBus("bus_group", "feed/#", true), (int)Node::Error::INVALID_ARG);
+
+    // Two subscribers in other processes: one reads the bus, the other only has its queue
+    std::atomic<int> reader_frames{0};
+    std::atomic<int> direct_frames{0};
+    SharedMemoryTransportV3 reader_peer;
+    SharedMemoryTransportV3 direct_peer;
+    ASSERT_TRUE(reader_peer.initialize("bus_reader_peer"));
+    ASSERT_TRUE(direct_peer.initialize("bus_direct_peer"));
+    auto counter = [](std::atomic<int>& count) {
+        return [&count](const uint8_t* bytes, size_t size, const std::string&) {
+            if (size < sizeof(MessagePacket)) {
+                return;
+            }
+            const uint8_t type = reinterpret_cast<const MessagePacket*>(bytes)->msg_type;
+            if (type == static_cast<uint8_t>(MessageType::DATA) ||
+                type == static_cast<uint8_t>(MessageType::DEADLINE_DATA)) {
+                count++;
+            }
+        };
+    };
+    reader_peer.setReceiveCallback(counter(reader_frames));
+    direct_peer.setReceiveCallback(counter(direct_frames));
+    reader_peer.startReceiving();
+    direct_peer.startReceiving();
+    for (const char* peer : {"bus_reader_peer", "bus_direct_peer"}) {
+        ServiceDescriptor svc;
+        svc.node_id = peer;
+        svc.group = "bus_group";
+        svc.topic = "feed";
+        svc.transport = TransportType::SHARED_MEMORY;
+        GlobalRegistry::instance().registerService("bus_group", svc);
+    }
+
+    ASSERT_EQ((int)node->setTopicBus("bus_group", "feed", true), (int)Node::Error::NO_ERROR);
+    ASSERT_EQ((int)node->setTopicBus("bus_group", "feed", true), (int)Node::Error::NO_ERROR);
+    std::string channel_name;
+    for (const auto& svc : node->discoverServices("bus_group", ServiceType::TOPIC_BUS)) {
+        if (svc.node_id == "bus_pub") {
+            channel_name = svc.channel_name;
+        }
+    }
+    ASSERT_FALSE(channel_name.empty());
+
+    // The reader peer attaches to the ring and advertises its slot
+    auto ring = LargeDataChannel::create(channel_name, TopicBus::channelConfig());
+    ASSERT_TRUE(ring != nullptr);
+    const int32_t slot = ring->attachReader(true);
+    ASSERT_TRUE(slot >= 0);
+    ServiceDescriptor bus_reader;
+    bus_reader.node_id = "bus_reader_peer";
+    bus_reader.group = "bus_group";
+    bus_reader.topic = "feed";
+    bus_reader.type = ServiceType::TOPIC_BUS;
+    bus_reader.channel_name = channel_name;
+    bus_reader.transport = TransportType::SHARED_MEMORY;
+    bus_reader.reader_slot = static_cast<uint32_t>(slot);
+    GlobalRegistry::instance().registerService("bus_group", bus_reader);
+
+    // Until both peers are connected, messages may go missing
+    int warm_blocks = 0;
+    for (int i = 0; i < 200 && (direct_frames.load() == 0 || warm_blocks == 0); ++i) {
+        node->publish("bus_group", "feed", "warm");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        warm_blocks += drainTopicBus(*ring, slot);
+    }
+    ASSERT_GT(warm_blocks, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    drainTopicBus(*ring, slot);
+    reader_frames = 0;
+    direct_frames = 0;
+
+    // One ring write per message for the reader peer, queue frames for the other
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ((int)node->publish("bus_group", "feed", "sample"), (int)Node::Error::NO_ERROR);
+    }
+    ASSERT_EQ((int)node->publishBatch("bus_group", "feed", {"a", "b"}), (int)Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && direct_frames.load() < 7; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(7, direct_frames.load());
+    ASSERT_EQ(0, reader_frames.load());
+    ASSERT_EQ(7, drainTopicBus(*ring, slot));
+
+    // A message with a deadline cannot ride the ring: the reader peer gets it directly
+    ASSERT_EQ((int)node->publishWithTtl("bus_group", "feed", reinterpret_cast<const uint8_t*>("ttl"), 3, 1000000),
+              (int)Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && reader_frames.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, reader_frames.load());
+    ASSERT_EQ(0, drainTopicBus(*ring, slot));
+
+    // Bus off: its service is withdrawn and every subscriber is sent to directly again
+    ASSERT_EQ((int)node->setTopicBus("bus_group", "feed", false), (int)Node::Error::NO_ERROR);
+    bool advertised = false;
+    for (const auto& svc : node->discoverServices("bus_group", ServiceType::TOPIC_BUS)) {
+        advertised = advertised || svc.node_id == "bus_pub";
+    }
+    ASSERT_FALSE(advertised);
+    ASSERT_EQ((int)node->publish("bus_group", "feed", "sample"), (int)Node::Error::NO_ERROR);
+    for (int i = 0; i < 100 && reader_frames.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2, reader_frames.load());
+    ASSERT_EQ(0, drainTopicBus(*ring, slot));
+
+    GlobalRegistry::instance().clearServices();
+}
+
+TEST(NodeImplCoverageBoostTest, TopicBusSubscriber) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("bus_sub", false, 0);
+    node->initialize(0);
+    std::atomic<int> received{0};
+    ASSERT_EQ((int)node->subscribe("bus_group", {"feed"},
+                                   [&received](const std::string&, const std::string&, const uint8_t*, size_t size) {
+                                       if (size == 5) {
+                                           received++;
+                                       }
+                                   }),
+              (int)Node::Error::NO_ERROR);
+
+    // A publisher in another process: its ring and TOPIC_BUS service
+    const std::string channel_name = "nexus_bus_channel_test_" + std::to_string(getpid());
+    auto ring = LargeDataChannel::create(channel_name, TopicBus::channelConfig());
+    ASSERT_TRUE(ring != nullptr);
+    ServiceDescriptor bus;
+    bus.node_id = "bus_remote_pub";
+    bus.group = "bus_group";
+    bus.topic = "feed";
+    bus.type = ServiceType::TOPIC_BUS;
+    bus.channel_name = channel_name;
+    bus.transport = TransportType::SHARED_MEMORY;
+    GlobalRegistry::instance().registerService("bus_group", bus);
+
+    // Picked up by the maintenance task; the node advertises the reader slot it took
+    uint32_t slot = ServiceDescriptor::NO_READER_SLOT;
+    for (int i = 0; i < 100 && slot == ServiceDescriptor::NO_READER_SLOT; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        for (const auto& svc : node->discoverServices("bus_group", ServiceType::TOPIC_BUS)) {
+            if (svc.node_id == "bus_sub" && svc.channel_name == channel_name) {
+                slot = svc.reader_slot;
+                ASSERT_TRUE(svc.topic_id == ServiceDescriptor::NO_TOPIC_ID);
+            }
+        }
+    }
+    ASSERT_LT(slot, (uint32_t)MAX_READERS);
+
+    // Blocks for every reader or for our slot are delivered, blocks for other readers skipped
+    const uint8_t hello[] = {'h', 'e', 'l', 'l', 'o'};
+    ASSERT_TRUE(ring->write("feed", hello, sizeof(hello)) >= 0);
+    for (uint16_t mask : {static_cast<uint16_t>(1u << slot), static_cast<uint16_t>(1u << ((slot + 1) % 16))}) {
+        uint8_t* block = ring->reserveBlock("feed", sizeof(hello), mask);
+        ASSERT_TRUE(block != nullptr);
+        memcpy(block, hello, sizeof(hello));
+        ASSERT_TRUE(ring->commitBlock() >= 0);
+    }
+    for (int i = 0; i < 100 && received.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(2, received.load());
+
+    // Unsubscribing detaches: the reader service is withdrawn
+    ASSERT_EQ((int)node->unsubscribe("bus_group", {"feed"}), (int)Node::Error::NO_ERROR);
+    bool reading = false;
+    for (const auto& svc : node->discoverServices("bus_group", ServiceType::TOPIC_BUS)) {
+        reading = reading || svc.node_id == "bus_sub";
+    }
+    ASSERT_FALSE(reading);
+    ASSERT_TRUE(node->topic_bus_readers_->empty());
+
+    GlobalRegistry::instance().clearServices();
+}
+
+TEST(NodeImplCoverageBoostTest, UnsubscribeReleasesQueuedPayloads) {
+    ResetState();
+    auto publisher = std::make_shared<NodeImpl>("lane_pub", false, 0);
+    publisher->initialize(0);
+    auto node = std::make_shared<NodeImpl>("lane_sub", false, 0);
+    node->initialize(0);
+    const size_t outstanding = NodeImpl::payloadPool().outstanding();
+
+    std::atomic<bool> hold{true};
+    std::atomic<int> held{0};
+    node->subscribe("lane_group", {"backlog"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        held++;
+        while (hold.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Subscription reaches the publisher
+
+    // One message held by the worker, the rest waits on the lane
+    publisher->publish("lane_group", "backlog", "first");
+    for (int i = 0; i < 100 && held.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, held.load());
+    for (int i = 0; i < 5; ++i) {
+        publisher->publish("lane_group", "backlog", "queued");
+    }
+    ASSERT_EQ(outstanding + 6, NodeImpl::payloadPool().outstanding());
+    ASSERT_EQ(5u, node->pending_messages_.load());
+
+    // Unsubscribing with a non-empty lane hands the queued payloads back at once
+    ASSERT_EQ((int)node->unsubscribe("lane_group", {"backlog"}), (int)Node::Error::NO_ERROR);
+    ASSERT_EQ(outstanding + 1, NodeImpl::payloadPool().outstanding());
+    ASSERT_EQ(0u, node->pending_messages_.load());
+
+    hold = false;
+    for (int i = 0; i < 100 && NodeImpl::payloadPool().outstanding() != outstanding; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(outstanding, NodeImpl::payloadPool().outstanding());
+    ASSERT_EQ(1, held.load());
+}
+
+TEST(NodeImplCoverageBoostTest, UdpLivenessPiggybacksOnTraffic) {
+    ResetState();
+    auto node = std::make_shared<NodeImpl>("udp_live_node", true, 0);
+    node->initialize(0);
+    ASSERT_TRUE(node->udp_transport_ != nullptr);
+
+    // A remote node that subscribed over UDP: count what reaches its socket
+    std::atomic<int> heartbeats{0};
+    std::atomic<int> data{0};
+    UdpTransport peer;
+    ASSERT_TRUE(peer.initialize(0));
+    peer.setReceiveCallback([&](const uint8_t* bytes, size_t size, const sockaddr_in&) {
+        if (size < sizeof(MessagePacket)) {
+            return;
+        }
+        const MessageType type = static_cast<MessageType>(reinterpret_cast<const MessagePacket*>(bytes)->msg_type);
+        if (type == MessageType::HEARTBEAT) {
+            heartbeats++;
+        } else if (type == MessageType::DATA) {
+            data++;
+        }
+    });
+
+    ServiceDescriptor svc;
+    svc.node_id = "remote_busy";
+    svc.group = "live";
+    svc.topic = "ticks";
+    svc.transport = TransportType::UDP;
+    svc.udp_address = "127.0.0.1:" + std::to_string(peer.getPort());
+    GlobalRegistry::instance().registerService("live", svc);
+
+    // An idle peer is heartbeated, once per interval however often the pass runs
+    node->sendUdpHeartbeat();
+    for (int i = 0; i < 100 && heartbeats.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_GT(heartbeats.load(), 0);
+    int seen = heartbeats.load();
+    node->sendUdpHeartbeat();
+    node->sendUdpHeartbeat();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(heartbeats.load(), seen);
+
+    // Once the interval passed, data sent to the peer stands in for its heartbeat
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    seen = heartbeats.load();
+    ASSERT_EQ((int)node->publish("live", "ticks", "tick"), (int)Node::Error::NO_ERROR);
+    node->sendUdpHeartbeat();
+    for (int i = 0; i < 100 && data.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(data.load(), 1);
+    ASSERT_EQ(heartbeats.load(), seen);
+
+    // Any packet from a node we never heard a heartbeat from makes it known (and refreshes it later)
+    PacketView packet = MessageBuilder::buildView("remote_busy", "live", "ticks", std::string("x"), peer.getPort(),
+                                                  MessageType::DATA);
+    ASSERT_TRUE(peer.send(packet.data(), packet.size(), "127.0.0.1", node->getUdpPort()));
+    for (int i = 0; i < 100 && NodeImplTester::getRemoteNodesCount(node) == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(NodeImplTester::getRemoteNodesCount(node), 1);
+
+    peer.shutdown();
+    GlobalRegistry::instance().clearServices();
+}
@@ -295,7 +295,7 @@ TEST(NodeImplCoverageFinal, HandleQuerySubscriptions) {
     // We should receive a SERVICE_REGISTER reply?
     // We can check if we receive something.
     bool received = false;
-    sender.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string& from_addr) {
+    sender.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in& from_addr) {
         if (size < sizeof(MessagePacket)) return;
         const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
         if (packet->msg_type == static_cast<uint8_t>(MessageType::SERVICE_REGISTER)) {
@@ -631,6 +631,57 @@ TEST(NodeImplCoverageFinal, LargeDataBufferFull) {
     ASSERT_EQ(err, Node::Error::TIMEOUT);
 }
 
+TEST(NodeImplCoverageFinal, LargeDataWatermark) {
+    auto node = std::make_shared<NodeImpl>("ld_watermark_node", false, 0);
+    node->initialize(0);
+
+    LargeDataChannel::Config config;
+    config.buffer_size = 8192;
+    config.max_block_size = 4096;
+    auto channel = LargeDataChannel::create("wm_channel", config);
+    auto reader_channel = LargeDataChannel::create("wm_channel", config);
+    LargeDataChannel::DataBlock block;
+    reader_channel->tryRead(block);  // Registers the reader
+    NodeImplTester::injectLargeDataChannel(node, "wm_channel", channel);
+
+    std::mutex mutex;
+    std::vector<WatermarkEvent> events;
+    node->setWatermarks(50, 10);
+    node->setWatermarkCallback([&](const WatermarkEvent& event) {
+        if (event.source == WatermarkSource::LARGE_DATA_RING) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(event);
+        }
+    });
+    auto eventCount = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size();
+    };
+
+    std::vector<uint8_t> data(2048, 0xAB);
+    ASSERT_EQ(Node::NO_ERROR, node->sendLargeData("group", "wm_channel", "a", data.data(), data.size()));
+    ASSERT_EQ(Node::NO_ERROR, node->sendLargeData("group", "wm_channel", "b", data.data(), data.size()));
+    for (int i = 0; i < 100 && eventCount() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, eventCount());
+
+    while (reader_channel->tryRead(block)) {
+        reader_channel->releaseBlock(block);
+    }
+    for (int i = 0; i < 100 && eventCount() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    node->setWatermarkCallback(nullptr);
+
+    ASSERT_EQ(2u, events.size());
+    ASSERT_TRUE(events[0].high);
+    ASSERT_EQ(std::string("wm_channel"), events[0].name);
+    ASSERT_EQ(8192u, events[0].capacity);
+    ASSERT_FALSE(events[1].high);
+    ASSERT_EQ(0u, events[1].level);
+}
+
 TEST(NodeImplCoverageFinal, InvalidPacket) {
     auto node = std::make_shared<NodeImpl>("packet_node", false, 0);
     
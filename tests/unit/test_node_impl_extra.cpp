@@ -4,8 +4,11 @@
 #include <vector>
 #include <cstring>
 #include <atomic>
+#include <mutex>
+#include <string>
 #include <sys/mman.h>
 #include <fcntl.h>
+#include "nexus/core/Config.h"
 #include "nexus/core/NodeImpl.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include "nexus/core/Message.h"
@@ -34,7 +37,8 @@ TEST(NodeImplExtra, QueueStatsAndOverflow) {
     // 1. Test getQueueStats initially
     auto stats = node->getQueueStats();
     ASSERT_EQ(stats.total_dropped, 0);
-    for (size_t i = 0; i < NodeImpl::NUM_PROCESSING_THREADS; ++i) {
+    ASSERT_EQ(stats.queue_depth.size(), node->getProcessingThreadCount());
+    for (size_t i = 0; i < stats.queue_depth.size(); ++i) {
         ASSERT_EQ(stats.queue_depth[i], 0);
     }
 
@@ -51,6 +55,35 @@ TEST(NodeImplExtra, QueueStatsAndOverflow) {
     // But we verified the API calls work.
 }
 
+TEST(NodeImplExtra, ConfigurableDispatchPool) {
+    RegistryCleanup cleanup;
+    auto& config = Config::instance();
+    const auto original_node_config = config.node;
+    config.node.num_processing_threads = 2;
+    config.node.worker_cpu_sets = {0x1};  // Every worker on CPU 0
+    config.node.worker_priority = 10;     // Falls back to default scheduling without privileges
+
+    auto pub = std::make_shared<NodeImpl>("test_pool_pub", false, 0);
+    pub->initialize(0);
+    auto sub = std::make_shared<NodeImpl>("test_pool_sub", false, 0);
+    sub->initialize(0);
+    config.node = original_node_config;  // Fixed at construction
+
+    ASSERT_EQ(sub->getProcessingThreadCount(), 2u);
+    ASSERT_EQ(sub->getQueueStats().queue_depth.size(), 2u);
+
+    std::atomic<int> received{0};
+    sub->subscribe("pool", {"a", "b", "c"},
+                   [&](const std::string&, const std::string&, const uint8_t*, size_t) { received++; });
+    for (const char* topic : {"a", "b", "c"}) {
+        pub->publish("pool", topic, "x");
+    }
+    for (int i = 0; i < 100 && received.load() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), 3);
+}
+
 TEST(NodeImplExtra, CleanupOrphanedChannels) {
     RegistryCleanup cleanup;
     std::string node_id = "test_node_cleanup";
@@ -192,3 +225,112 @@ TEST(NodeImplExtra, DiscoverServices) {
     }
     ASSERT_TRUE(found);
 }
+
+TEST(NodeImplExtra, WorkStealingKeepsTopicOrder) {
+    RegistryCleanup cleanup;
+    auto& config = Config::instance();
+    const size_t original_threads = config.node.num_processing_threads;
+    config.node.num_processing_threads = 2;
+
+    auto pub = std::make_shared<NodeImpl>("test_steal_pub", false, 0);
+    pub->initialize(0);
+    auto sub = std::make_shared<NodeImpl>("test_steal_sub", false, 0);
+    sub->initialize(0);
+    config.node.num_processing_threads = original_threads;
+
+    // Two topics with the same home worker
+    TopicHandle lidar = sub->resolveTopic("steal", "lidar");
+    TopicHandle imu = sub->resolveTopic("steal", "imu");
+    for (int i = 0; imu.id() % 2 != lidar.id() % 2; ++i) {
+        imu = sub->resolveTopic("steal", "imu" + std::to_string(i));
+    }
+
+    std::mutex mutex;
+    std::vector<int> lidar_order;
+    std::atomic<bool> imu_received{false};
+    sub->subscribe("steal", {lidar.topic(), imu.topic()},
+                   [&](const std::string&, const std::string& topic, const uint8_t* payload, size_t size) {
+                       if (topic == lidar.topic()) {
+                           std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                           std::lock_guard<std::mutex> lock(mutex);
+                           lidar_order.push_back(std::stoi(std::string(reinterpret_cast<const char*>(payload), size)));
+                       } else {
+                           imu_received = true;
+                       }
+                   });
+
+    // Lidar burst keeps its home worker busy for ~1s; IMU must be stolen by the idle worker
+    for (int i = 0; i < 50; ++i) {
+        pub->publish(lidar, std::to_string(i));
+    }
+    auto start = std::chrono::steady_clock::now();
+    pub->publish(imu, "x");
+    while (!imu_received && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(imu_received.load());
+    ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+              200);
+
+    // Lanes move between workers between batches, but each topic stays in order
+    for (int i = 0; i < 300; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (lidar_order.size() == 50) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(lidar_order.size(), 50u);
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(lidar_order[i], i);
+    }
+}
+
+TEST(NodeImplExtra, BlockPolicyBackpressure) {
+    RegistryCleanup cleanup;
+    auto& config = Config::instance();
+    const size_t original_size = config.node.max_queue_size;
+    const uint32_t original_timeout = config.node.block_timeout_ms;
+    config.node.max_queue_size = 2;
+    config.node.block_timeout_ms = 1000;
+
+    auto pub = std::make_shared<NodeImpl>("test_block_pub", false, 0);
+    pub->initialize(0);
+    auto sub = std::make_shared<NodeImpl>("test_block_sub", false, 0);
+    sub->initialize(0);
+    sub->setQueueOverflowPolicy(QueueOverflowPolicy::BLOCK);
+
+    std::atomic<int> received{0};
+    std::atomic<int> delay_ms{2};
+    sub->subscribe("block", {"slow"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms.load()));
+        received++;
+    });
+
+    // Publisher is paced by the subscriber instead of losing messages
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(pub->publish("block", "slow", "x"), Node::Error::NO_ERROR);
+    }
+    for (int i = 0; i < 200 && received < 20; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), 20);
+    ASSERT_EQ(sub->getQueueStats().total_dropped, 0u);
+
+    // Subscriber slower than the bound: publish reports QUEUE_FULL with a retry hint
+    config.node.block_timeout_ms = 10;
+    delay_ms = 100;
+    Node::Error err = Node::Error::NO_ERROR;
+    for (int i = 0; i < 10 && err == Node::Error::NO_ERROR; ++i) {
+        err = pub->publish("block", "slow", "x");
+    }
+    ASSERT_EQ(err, Node::Error::QUEUE_FULL);
+    ASSERT_GT(pub->getRetryHintUs(), 0u);
+    ASSERT_GT(sub->getQueueStats().total_dropped, 0u);
+
+    config.node.max_queue_size = original_size;
+    config.node.block_timeout_ms = original_timeout;
+}
@@ -118,7 +118,7 @@ TEST(NodeImplMoreCoverage, CleanupThread) {
     auto node = std::make_shared<NodeImpl>("test_cleanup_thread", false, 0, TransportMode::LOCK_FREE_SHM);
     node->initialize(0);
     
-    ASSERT_TRUE(node->cleanup_running_);
+    ASSERT_NE(node->cleanup_task_, MaintenanceScheduler::NO_TASK);
     
     // We can manually call cleanupOrphanedChannels
     node->cleanupOrphanedChannels();
@@ -3,6 +3,12 @@
 #include "nexus/core/Message.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include "nexus/registry/GlobalRegistry.h"
+#include "nexus/core/Config.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
 #include <thread>
 #include <chrono>
 #include <atomic>
@@ -135,3 +141,257 @@ TEST(NodeImplServiceDiscoveryTest, NodeLeaveCleanup) {
     observer.reset();
     Nexus::rpc::GlobalRegistry::instance().clearServices();
 }
+
+namespace {
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>((value >> shift) & 0xFF));
+    }
+}
+
+// Shared memory service descriptor, optionally carrying the sender's service set version
+std::vector<uint8_t> shmDescriptor(uint32_t version) {
+    std::vector<uint8_t> desc = {static_cast<uint8_t>(ServiceType::NORMAL_MESSAGE),
+                                 static_cast<uint8_t>(TransportType::SHARED_MEMORY), 0, 0, 0};
+    if (version != 0) {
+        putU32(desc, ServiceDescriptor::NO_TOPIC_ID);
+        desc.push_back(static_cast<uint8_t>(MessagePriority::NORMAL));
+        putU32(desc, version);
+    }
+    return desc;
+}
+
+// One SERVICE_SNAPSHOT frame payload: version, flags (1 first, 2 last), entries in snap_group
+std::vector<uint8_t> snapshotChunk(uint32_t version, uint8_t flags, const std::vector<std::string>& topics) {
+    std::vector<uint8_t> payload;
+    putU32(payload, version);
+    payload.push_back(flags);
+    payload.push_back(static_cast<uint8_t>(topics.size()));
+    payload.push_back(0);
+    const std::string group = "snap_group";
+    const std::vector<uint8_t> desc = shmDescriptor(0);
+    for (const auto& topic : topics) {
+        payload.push_back(static_cast<uint8_t>(group.size()));
+        payload.push_back(static_cast<uint8_t>(topic.size()));
+        payload.push_back(static_cast<uint8_t>(desc.size()));
+        payload.push_back(0);
+        payload.insert(payload.end(), group.begin(), group.end());
+        payload.insert(payload.end(), topic.begin(), topic.end());
+        payload.insert(payload.end(), desc.begin(), desc.end());
+    }
+    return payload;
+}
+
+bool hasService(const std::string& node_id, const std::string& topic) {
+    for (const auto& svc : GlobalRegistry::instance().findServices("snap_group")) {
+        if (svc.node_id == node_id && svc.topic == topic) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(NodeImplServiceDiscoveryTest, VersionedQueryAnsweredWithSnapshot) {
+    GlobalRegistry::instance().clearServices();
+
+    auto responder = std::make_shared<NodeImpl>("snapshot_responder", false, 0, TransportMode::LOCK_FREE_SHM);
+    responder->initialize(0);
+
+    // Enough services to need several snapshot frames
+    std::vector<std::string> topics;
+    for (int i = 0; i < 200; ++i) {
+        topics.push_back("snapshot_topic_with_a_long_name_" + std::to_string(i));
+    }
+    ASSERT_EQ((int)Node::Error::NO_ERROR,
+              (int)responder->subscribe("snap_group", topics,
+                                        [](const std::string&, const std::string&, const uint8_t*, size_t) {}));
+
+    SharedMemoryTransportV3 querier;
+    ASSERT_TRUE(querier.initialize("snapshot_querier"));
+
+    std::atomic<int> frames{0};
+    std::atomic<int> entries{0};
+    std::atomic<int> last_frames{0};
+    std::atomic<int> unchanged_frames{0};
+    std::atomic<uint32_t> version{0};
+    querier.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        if (size < sizeof(MessagePacket)) return;
+        const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
+        if (packet->msg_type != static_cast<uint8_t>(MessageType::SERVICE_SNAPSHOT) || packet->payload_len < 7) {
+            return;
+        }
+        const uint8_t* payload = packet->getPayload();
+        version = static_cast<uint32_t>(payload[0]) | (static_cast<uint32_t>(payload[1]) << 8) |
+                  (static_cast<uint32_t>(payload[2]) << 16) | (static_cast<uint32_t>(payload[3]) << 24);
+        entries += payload[5] | (payload[6] << 8);
+        if (payload[4] & 0x02) {
+            ++last_frames;
+        }
+        if (payload[4] & 0x04) {
+            ++unchanged_frames;
+        }
+        ++frames;
+    });
+    querier.startReceiving();
+
+    // Version 0: we know nothing yet, send everything
+    std::vector<uint8_t> query;
+    putU32(query, 0);
+    auto packet = MessageBuilder::build("snapshot_querier", "", "", query.data(), query.size(), 0,
+                                        MessageType::SERVICE_REGISTER);
+    querier.send("snapshot_responder", packet.data(), packet.size());
+    for (int retries = 0; last_frames < 1 && retries < 50; ++retries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(last_frames.load(), 1);
+    ASSERT_EQ(entries.load(), 200);
+    ASSERT_GT(frames.load(), 1);   // Chunked ...
+    ASSERT_LT(frames.load(), 20);  // ... but far fewer frames than services
+    ASSERT_GT(version.load(), 0u);
+
+    // Current version: nothing to send
+    const int full_frames = frames;
+    query.clear();
+    putU32(query, version);
+    packet = MessageBuilder::build("snapshot_querier", "", "", query.data(), query.size(), 0,
+                                   MessageType::SERVICE_REGISTER);
+    querier.send("snapshot_responder", packet.data(), packet.size());
+    for (int retries = 0; last_frames < 2 && retries < 50; ++retries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(last_frames.load(), 2);
+    ASSERT_EQ(unchanged_frames.load(), 1);
+    ASSERT_EQ(frames.load(), full_frames + 1);
+    ASSERT_EQ(entries.load(), 200);
+
+    querier.stopReceiving();
+    responder.reset();
+    GlobalRegistry::instance().clearServices();
+}
+
+TEST(NodeImplServiceDiscoveryTest, SnapshotAndVersionedUpdatesApplied) {
+    GlobalRegistry::instance().clearServices();
+
+    auto receiver = std::make_shared<NodeImpl>("snapshot_receiver", false, 0, TransportMode::LOCK_FREE_SHM);
+    receiver->initialize(0);
+    std::atomic<int> added{0};
+    std::atomic<int> removed{0};
+    receiver->setServiceDiscoveryCallback([&](ServiceEvent event, const ServiceDescriptor& svc) {
+        if (svc.node_id != "snapshot_peer") return;
+        if (event == ServiceEvent::SERVICE_ADDED) ++added;
+        if (event == ServiceEvent::SERVICE_REMOVED) ++removed;
+    });
+
+    SharedMemoryTransportV3 peer;
+    ASSERT_TRUE(peer.initialize("snapshot_peer"));
+    std::atomic<int> resync_queries{0};
+    peer.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        if (size < sizeof(MessagePacket)) return;
+        const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
+        if (packet->msg_type == static_cast<uint8_t>(MessageType::SERVICE_REGISTER) && packet->payload_len == 4) {
+            ++resync_queries;
+        }
+    });
+    peer.startReceiving();
+
+    // A service the peer no longer has (its unregister was lost)
+    ServiceDescriptor stale;
+    stale.node_id = "snapshot_peer";
+    stale.group = "snap_group";
+    stale.topic = "stale";
+    stale.type = ServiceType::NORMAL_MESSAGE;
+    stale.transport = TransportType::SHARED_MEMORY;
+    GlobalRegistry::instance().registerService("snap_group", stale);
+
+    // Snapshot at version 5, in two frames
+    auto first = snapshotChunk(5, 0x01, {"a"});
+    auto last = snapshotChunk(5, 0x02, {"b", "f"});
+    for (const auto* payload : {&first, &last}) {
+        auto packet = MessageBuilder::build("snapshot_peer", "", "", payload->data(), payload->size(), 0,
+                                            MessageType::SERVICE_SNAPSHOT);
+        ASSERT_TRUE(peer.send("snapshot_receiver", packet.data(), packet.size()));
+    }
+    for (int retries = 0; hasService("snapshot_peer", "stale") && retries < 50; ++retries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_FALSE(hasService("snapshot_peer", "stale"));
+    ASSERT_TRUE(hasService("snapshot_peer", "a"));
+    ASSERT_TRUE(hasService("snapshot_peer", "b"));
+    ASSERT_EQ(added.load(), 3);
+    ASSERT_EQ(removed.load(), 1);
+
+    // Updates: 5 is already covered, 6 follows on, 9 skips two versions and asks for a resync
+    auto update = [&](const std::string& topic, uint32_t version) {
+        const auto desc = shmDescriptor(version);
+        auto packet = MessageBuilder::build("snapshot_peer", "snap_group", topic, desc.data(), desc.size(), 0,
+                                            MessageType::SERVICE_REGISTER);
+        return peer.send("snapshot_receiver", packet.data(), packet.size());
+    };
+    ASSERT_TRUE(update("c", 5));
+    ASSERT_TRUE(update("d", 6));
+    ASSERT_TRUE(update("e", 9));
+    for (int retries = 0; resync_queries < 1 && retries < 50; ++retries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(resync_queries.load(), 1);
+    ASSERT_FALSE(hasService("snapshot_peer", "c"));
+    ASSERT_TRUE(hasService("snapshot_peer", "d"));
+    ASSERT_TRUE(hasService("snapshot_peer", "e"));
+
+    peer.stopReceiving();
+    receiver.reset();
+    GlobalRegistry::instance().clearServices();
+}
+
+static bool fileContains(const std::string& path, const std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return contents.find(text) != std::string::npos;
+}
+
+TEST(NodeImplServiceDiscoveryTest, DiscoveryCacheWarmRestart) {
+    auto& registry = Nexus::rpc::GlobalRegistry::instance();
+    registry.clearServices();
+    const std::string path = "/tmp/nexus_discovery_cache_" + std::to_string(getpid());
+    std::remove(path.c_str());
+    Config::instance().node.discovery_cache = path;
+
+    // A UDP subscriber in another process, as seen by the node before its restart
+    ServiceDescriptor ghost;
+    ghost.node_id = "cache_ghost_node";
+    ghost.group = "cache_group";
+    ghost.topic = "cache_topic";
+    ghost.transport = TransportType::UDP;
+    ghost.udp_address = "127.0.0.1:9";
+
+    {
+        auto writer = std::make_shared<NodeImpl>("cache_writer_node", true, 0, TransportMode::LOCK_FREE_SHM);
+        writer->initialize(0);
+        registry.registerService("cache_group", ghost);
+        for (int i = 0; i < 40 && !fileContains(path, ghost.node_id); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        ASSERT_TRUE(fileContains(path, ghost.node_id));
+    }
+    registry.unregisterService("cache_group", ghost);
+    ASSERT_EQ(registry.findServices("cache_group").size(), 0u);
+
+    // Restart: the route exists as soon as initialize() returns
+    auto reader = std::make_shared<NodeImpl>("cache_reader_node", true, 0, TransportMode::LOCK_FREE_SHM);
+    reader->initialize(0);
+    auto services = registry.findServices("cache_group");
+    ASSERT_EQ(services.size(), 1u);
+    ASSERT_TRUE(services[0].udp_address == ghost.udp_address);
+
+    // The ghost never heartbeats or re-announces: revalidation drops it
+    for (int i = 0; i < 100 && !registry.findServices("cache_group").empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(registry.findServices("cache_group").size(), 0u);
+
+    Config::instance().node.discovery_cache.clear();
+    std::remove(path.c_str());
+}
@@ -1,9 +1,13 @@
 #include "simple_test.h"
 #include "nexus/core/NodeImpl.h"
 #include "nexus/core/Config.h"
+#include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/UdpTransport.h"
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <string>
+#include <vector>
 
 using namespace Nexus::rpc;
 
@@ -53,3 +57,77 @@ TEST(NodeUdpTest, UdpMessageHandling) {
         retries++;
     }
 }
+
+TEST(NodeUdpTest, MulticastFanOut) {
+    auto& transport_config = Config::instance().transport;
+    const Config::TransportConfig saved = transport_config;
+    transport_config.udp_multicast = true;
+    transport_config.udp_multicast_port = 47150;
+
+    // A UDP subscriber joins the group of its topic and advertises it
+    std::atomic<int> local_received{0};
+    auto subscriber = std::make_shared<NodeImpl>("mcast_sub", true, 0, TransportMode::UDP);
+    subscriber->initialize(0);
+    subscriber->subscribe("dash", {"speed"}, [&](const std::string&, const std::string&, const uint8_t*, size_t) {
+        local_received.fetch_add(1);
+    });
+    std::string group_address;
+    for (const auto& svc : GlobalRegistry::instance().findServices("dash")) {
+        if (svc.node_id == "mcast_sub" && svc.transport == TransportType::UDP) {
+            group_address = svc.multicast_address;
+        }
+    }
+    ASSERT_EQ(0u, group_address.find("239.255.73."));
+    ASSERT_NE(std::string::npos, group_address.find(":47150"));
+
+    // Three remote dashboards in the same group, each with its own unicast socket
+    UdpTransport group_rx;
+    ASSERT_TRUE(group_rx.initialize(47150, true));
+    ASSERT_TRUE(group_rx.joinMulticastGroup(group_address.substr(0, group_address.find(':'))));
+    std::atomic<int> group_received{0};
+    group_rx.setReceiveCallback([&](const uint8_t*, size_t, const sockaddr_in&) { group_received.fetch_add(1); });
+
+    UdpTransport unicast_rx[3];
+    std::atomic<int> unicast_received{0};
+    std::vector<ServiceDescriptor> remotes;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(unicast_rx[i].initialize(0));
+        unicast_rx[i].setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
+            // Heartbeats still go to each remote node; only DATA is fanned out through the group
+            if (size >= sizeof(MessagePacket) &&
+                reinterpret_cast<const MessagePacket*>(data)->msg_type == static_cast<uint8_t>(MessageType::DATA)) {
+                unicast_received.fetch_add(1);
+            }
+        });
+        ServiceDescriptor svc;
+        svc.node_id = "remote_dash" + std::to_string(i);
+        svc.group = "dash";
+        svc.topic = "speed";
+        svc.transport = TransportType::UDP;
+        svc.udp_address = "127.0.0.1:" + std::to_string(unicast_rx[i].getPort());
+        svc.multicast_address = group_address;
+        GlobalRegistry::instance().registerService("dash", svc);
+        remotes.push_back(svc);
+    }
+
+    // One datagram per message, whatever the number of remote subscribers
+    auto publisher = std::make_shared<NodeImpl>("mcast_pub", true, 0, TransportMode::UDP);
+    publisher->initialize(0);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(Node::NO_ERROR, publisher->publish("dash", "speed", "42"));
+    }
+    for (int i = 0; i < 100 && (group_received.load() < 5 || local_received.load() < 5); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ASSERT_EQ(5, group_received.load());
+    ASSERT_EQ(0, unicast_received.load());
+    // The in-process subscriber is delivered directly and ignores the multicast copy
+    ASSERT_EQ(5, local_received.load());
+
+    for (const auto& svc : remotes) {
+        GlobalRegistry::instance().unregisterService("dash", svc);
+    }
+    transport_config = saved;
+}
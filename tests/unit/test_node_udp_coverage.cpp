@@ -36,7 +36,7 @@ TEST(NodeUdpCoverage, HandleQuerySubscriptions) {
     ASSERT_TRUE(helper.initialize(0)); // Bind to any port
     
     std::atomic<bool> received_reply{false};
-    helper.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&){
+    helper.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&){
         std::cout << "DEBUG: Helper received " << size << " bytes" << std::endl;
         if (size < sizeof(MessagePacket)) return;
         const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
@@ -83,7 +83,7 @@ TEST(NodeUdpCoverage, SendHeartbeat) {
     
     // 4. Wait for heartbeat packet on helper
     std::atomic<bool> received_hb{false};
-    helper.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&){
+    helper.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&){
         if (size < sizeof(MessagePacket)) return;
         const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
         if (packet->msg_type == static_cast<uint8_t>(MessageType::HEARTBEAT)) {
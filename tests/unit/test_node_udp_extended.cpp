@@ -71,7 +71,7 @@ TEST(NodeUdpExtendedTest, QuerySubscriptions) {
     ASSERT_TRUE(remote_transport.initialize(0));
     
     std::atomic<bool> response_received{false};
-    remote_transport.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+    remote_transport.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
         if (size < sizeof(MessagePacket)) return;
         const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
         
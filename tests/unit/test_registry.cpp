@@ -2,7 +2,10 @@
 #include "nexus/registry/GlobalRegistry.h"
 #include "nexus/registry/SharedMemoryRegistry.h"
 #include "nexus/core/NodeImpl.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <unistd.h> // For getpid()
 
 using namespace Nexus;
@@ -33,6 +36,95 @@ TEST(GlobalRegistryTest, RegisterNode) {
     ASSERT_TRUE(found == nullptr);
 }
 
+TEST(GlobalRegistryTest, RouteVersion) {
+    auto& registry = GlobalRegistry::instance();
+
+    ServiceDescriptor svc;
+    svc.node_id = "route_node";
+    svc.group = "route_group";
+    svc.topic = "route_topic";
+    svc.transport = TransportType::SHARED_MEMORY;
+
+    // Every change a cached route depends on bumps the version
+    uint64_t version = registry.getRouteVersion();
+    registry.registerService(svc.group, svc);
+    ASSERT_GT(registry.getRouteVersion(), version);
+
+    version = registry.getRouteVersion();
+    registry.unregisterService(svc.group, svc);
+    ASSERT_GT(registry.getRouteVersion(), version);
+
+    version = registry.getRouteVersion();
+    registry.invalidateRoutes();
+    ASSERT_GT(registry.getRouteVersion(), version);
+
+    // Lookups leave it alone
+    version = registry.getRouteVersion();
+    registry.findServices(svc.group);
+    ASSERT_EQ(registry.getRouteVersion(), version);
+}
+
+TEST(GlobalRegistryTest, ServiceIndex) {
+    auto& registry = GlobalRegistry::instance();
+
+    ServiceDescriptor exact;
+    exact.node_id = "index_node1";
+    exact.group = "index_group";
+    exact.topic = "sensors/temp";
+    exact.transport = TransportType::SHARED_MEMORY;
+    ServiceDescriptor pattern = exact;
+    pattern.topic = "sensors/*";
+    ServiceDescriptor remote = exact;
+    remote.node_id = "index_node2";
+    remote.transport = TransportType::UDP;
+    remote.udp_address = "127.0.0.1:5000";
+    registry.registerService(exact.group, exact);
+    registry.registerService(pattern.group, pattern);
+    registry.registerService(remote.group, remote);
+
+    auto services = registry.getServices();
+    ASSERT_EQ(services->group("index_group").size(), 3u);
+    ASSERT_EQ(services->topic("index_group", "sensors/temp").size(), 2u);
+    ASSERT_EQ(services->patterns("index_group").size(), 1u);
+    ASSERT_EQ(services->patterns("index_group")[0].topic, std::string("sensors/*"));
+    ASSERT_EQ(services->node("index_node1").size(), 2u);
+    ASSERT_EQ(services->node("index_node2").size(), 1u);
+    ASSERT_TRUE(services->topic("index_group", "sensors/humidity").empty());
+    ASSERT_TRUE(services->topic("no_such_group", "sensors/temp").empty());
+
+    size_t udp = 0;
+    for (const auto& svc : services->transport(TransportType::UDP)) {
+        if (svc.group == "index_group") {
+            udp++;
+        }
+    }
+    ASSERT_EQ(udp, 1u);
+
+    // A snapshot is immutable: later changes publish a new one
+    auto node = std::make_shared<MockNode>("index_node1");
+    registry.registerNode("index_node1", std::weak_ptr<NodeImpl>(node));
+    registry.unregisterNode("index_node1");
+    ASSERT_EQ(services->node("index_node1").size(), 2u);
+    auto current = registry.getServices();
+    ASSERT_TRUE(current->node("index_node1").empty());
+    ASSERT_EQ(current->group("index_group").size(), 1u);
+    ASSERT_TRUE(current->patterns("index_group").empty());
+
+    registry.unregisterService(remote.group, remote);
+    ASSERT_TRUE(registry.getServices()->group("index_group").empty());
+    ASSERT_TRUE(registry.findServices("index_group").empty());
+}
+
+TEST(GlobalRegistryTest, TopicById) {
+    auto& registry = GlobalRegistry::instance();
+
+    TopicHandle handle = registry.resolveTopic("id_group", "id_topic");
+    ASSERT_TRUE(registry.topicById(handle.id()) == handle);
+    ASSERT_EQ(CompactPacket::topicHash("id_group", "id_topic"), handle.hash());
+    ASSERT_FALSE(registry.topicById(static_cast<uint32_t>(registry.getTopicCount())).valid());
+    ASSERT_FALSE(registry.topicById(ServiceDescriptor::NO_TOPIC_ID).valid());
+}
+
 TEST(SharedMemoryRegistryTest, BasicOperations) {
     SharedMemoryRegistry::cleanupOrphanedRegistry();
     SharedMemoryRegistry registry;
@@ -101,3 +193,114 @@ TEST(SharedMemoryRegistryTest, MaxNodes) {
         registry.unregisterNode(id);
     }
 }
+
+TEST(SharedMemoryRegistryTest, IndexSurvivesChurn) {
+    SharedMemoryRegistry registry;
+    ASSERT_TRUE(registry.initialize());
+
+    // Each round leaves 100 tombstones: later rounds run past the rebuild threshold
+    const int kNodes = 100;
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < kNodes; ++i) {
+            std::string id = "churn_" + std::to_string(round) + "_" + std::to_string(i);
+            ASSERT_TRUE(registry.registerNode(id, "/churn_shm_" + std::to_string(i)));
+        }
+        for (int i = 0; i < kNodes; ++i) {
+            std::string id = "churn_" + std::to_string(round) + "_" + std::to_string(i);
+            NodeInfo info;
+            ASSERT_TRUE(registry.findNode(id, info));
+            ASSERT_EQ(id, info.node_id);
+            ASSERT_EQ("/churn_shm_" + std::to_string(i), info.shm_name);
+            ASSERT_TRUE(registry.updateHeartbeat(id));
+        }
+        // Remove every other node, check the rest is still found past the tombstones
+        for (int i = 0; i < kNodes; i += 2) {
+            ASSERT_TRUE(registry.unregisterNode("churn_" + std::to_string(round) + "_" + std::to_string(i)));
+        }
+        for (int i = 0; i < kNodes; ++i) {
+            std::string id = "churn_" + std::to_string(round) + "_" + std::to_string(i);
+            ASSERT_EQ(i % 2 != 0, registry.nodeExists(id));
+        }
+        for (int i = 1; i < kNodes; i += 2) {
+            ASSERT_TRUE(registry.unregisterNode("churn_" + std::to_string(round) + "_" + std::to_string(i)));
+        }
+    }
+    ASSERT_FALSE(registry.nodeExists("churn_3_1"));
+    ASSERT_FALSE(registry.updateHeartbeat("churn_0_0"));
+}
+
+TEST(SharedMemoryRegistryTest, NodeListGeneration) {
+    SharedMemoryRegistry registry;
+    ASSERT_TRUE(registry.initialize());
+
+    uint32_t generation = SharedMemoryRegistry::NO_GENERATION;
+    std::vector<NodeInfo> nodes;
+    ASSERT_TRUE(registry.getAllNodesIfChanged(generation, nodes));
+    ASSERT_FALSE(registry.getAllNodesIfChanged(generation, nodes));
+
+    // Membership changes bump the generation, heartbeats do not
+    ASSERT_TRUE(registry.registerNode("gen_node", "/gen_shm"));
+    ASSERT_TRUE(registry.getAllNodesIfChanged(generation, nodes));
+    bool found = false;
+    for (const auto& n : nodes) {
+        found = found || n.node_id == "gen_node";
+    }
+    ASSERT_TRUE(found);
+    ASSERT_TRUE(registry.updateHeartbeat("gen_node"));
+    ASSERT_FALSE(registry.getAllNodesIfChanged(generation, nodes));
+
+    // Lock-free readers never see an entry half written or half cleared
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (int i = 0; !stop.load(); ++i) {
+            std::string id = "gen_churn_" + std::to_string(i % 8);
+            registry.registerNode(id, "/gen_churn_shm");
+            registry.unregisterNode(id);
+        }
+    });
+    int torn = 0;
+    for (int i = 0; i < 2000; ++i) {
+        for (const auto& n : registry.getAllNodes()) {
+            if (n.node_id.empty() || n.shm_name.empty() || n.pid == 0) {
+                torn++;
+            }
+        }
+    }
+    stop = true;
+    writer.join();
+    ASSERT_EQ(0, torn);
+
+    ASSERT_TRUE(registry.unregisterNode("gen_node"));
+    ASSERT_TRUE(registry.getAllNodesIfChanged(generation, nodes));
+    for (const auto& n : nodes) {
+        ASSERT_NE(std::string("gen_node"), n.node_id);
+    }
+}
+
+TEST(SharedMemoryRegistryTest, WaitForChange) {
+    SharedMemoryRegistry registry;
+    ASSERT_TRUE(registry.initialize());
+
+    uint32_t generation = SharedMemoryRegistry::NO_GENERATION;
+    ASSERT_TRUE(registry.waitForChange(generation, 0));
+    ASSERT_FALSE(registry.waitForChange(generation, 20));
+
+    // A registration from another thread wakes the waiter long before the timeout
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        registry.registerNode("wait_node", "/wait_shm");
+    });
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(registry.waitForChange(generation, 5000));
+    auto waited = std::chrono::steady_clock::now() - start;
+    writer.join();
+    ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(waited).count(), 2000);
+    ASSERT_TRUE(registry.nodeExists("wait_node"));
+
+    // Heartbeats are not membership changes
+    ASSERT_TRUE(registry.updateHeartbeat("wait_node"));
+    ASSERT_FALSE(registry.waitForChange(generation, 20));
+
+    ASSERT_TRUE(registry.unregisterNode("wait_node"));
+    ASSERT_TRUE(registry.waitForChange(generation, 0));
+}
@@ -31,7 +31,8 @@ struct TestRegistryEntry {
     std::atomic<uint64_t> last_heartbeat;
     std::atomic<uint64_t> node_id_atomic[8];
     std::atomic<uint64_t> shm_name_atomic[8];
-    char padding[48];
+    std::atomic<uint64_t> node_hash;
+    char padding[40];
 };
 
 struct alignas(64) TestRegistryHeader {
@@ -41,12 +42,20 @@ struct alignas(64) TestRegistryHeader {
     std::atomic<uint32_t> num_entries;
     std::atomic<uint32_t> capacity;
     std::atomic<uint32_t> ref_count;
+    std::atomic<uint32_t> generation;
     std::atomic<uint32_t> ref_pids[SharedMemoryRegistry::MAX_REGISTRY_ENTRIES];
 };
 
+struct TestRegistryIndex {
+    std::atomic<uint32_t> updating;
+    std::atomic<uint32_t> tombstones;
+    std::atomic<uint32_t> slots[SharedMemoryRegistry::INDEX_SLOTS];
+};
+
 struct TestRegistryRegion {
     TestRegistryHeader header;
     TestRegistryEntry entries[SharedMemoryRegistry::MAX_REGISTRY_ENTRIES];
+    TestRegistryIndex index;
 };
 
 class RegistryCoverageExtraTest {
@@ -0,0 +1,300 @@
+#include "simple_test.h"
+#include "nexus/core/Config.h"
+#include "nexus/core/NodeImpl.h"
+#include "nexus/registry/GlobalRegistry.h"
+#include "nexus/transport/LargeDataChannel.h"
+#include "nexus/transport/ReliableUdpChannel.h"
+#include "nexus/transport/UdpTransport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Nexus::rpc;
+
+namespace {
+
+struct Received {
+    std::string group;
+    std::string topic;
+    std::vector<uint8_t> payload;
+    std::string source;
+};
+
+// Hand every valid packet of @p transport to @p channel, unless @p drop says otherwise
+void attach(UdpTransport& transport, ReliableUdpChannel& channel,
+            std::function<bool(const MessagePacket&)> drop = nullptr) {
+    transport.setReceiveCallback([&channel, drop](const uint8_t* data, size_t size, const sockaddr_in& from) {
+        const MessagePacket* packet = reinterpret_cast<const MessagePacket*>(data);
+        if (size < sizeof(MessagePacket) || !packet->isValid() || (drop && drop(*packet))) {
+            return;
+        }
+        channel.handlePacket(*packet, from);
+    });
+}
+
+// Stops a socket's receive thread before the channels it feeds are destroyed
+struct ShutdownOnExit {
+    UdpTransport& first;
+    UdpTransport& second;
+    ~ShutdownOnExit() {
+        first.shutdown();
+        second.shutdown();
+    }
+};
+
+std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+    return data;
+}
+
+bool waitFor(std::mutex& mutex, const std::vector<Received>& received, size_t count) {
+    for (int i = 0; i < 500; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() >= count) return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(ReliableUdpTest, LargeMessagesArriveWholeAndInOrder) {
+    UdpTransport tx_socket;
+    UdpTransport rx_socket;
+    ASSERT_TRUE(tx_socket.initialize(0));
+    ASSERT_TRUE(rx_socket.initialize(0));
+
+    ReliableUdpChannel::Options options;
+    ReliableUdpChannel sender(tx_socket, "reliable_tx", options);
+    ReliableUdpChannel receiver(rx_socket, "reliable_rx", options);
+    attach(tx_socket, sender);
+    attach(rx_socket, receiver);
+    ShutdownOnExit shutdown{tx_socket, rx_socket};
+
+    std::mutex mutex;
+    std::vector<Received> received;
+    receiver.setMessageCallback([&](StringView source, StringView group, StringView topic, const uint8_t* payload,
+                                    size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back({group.str(), topic.str(), std::vector<uint8_t>(payload, payload + size), source.str()});
+    });
+
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", rx_socket.getPort(), dest));
+
+    // Far above one datagram (MessagePacket::MAX_PAYLOAD_LEN), then small and empty messages behind it
+    const std::vector<uint8_t> large = pattern(3 * 1024 * 1024, 7);
+    const std::vector<uint8_t> small = pattern(100, 1);
+    ASSERT_TRUE(sender.send(dest, "maps", "tile", large.data(), large.size()));
+    ASSERT_TRUE(sender.send(dest, "maps", "meta", small.data(), small.size()));
+    ASSERT_TRUE(sender.send(dest, "maps", "end", nullptr, 0));
+    ASSERT_TRUE(waitFor(mutex, received, 3));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(3u, received.size());
+    ASSERT_EQ(std::string("tile"), received[0].topic);
+    ASSERT_EQ(std::string("maps"), received[0].group);
+    ASSERT_EQ(std::string("reliable_tx"), received[0].source);
+    ASSERT_TRUE(received[0].payload == large);
+    ASSERT_EQ(std::string("meta"), received[1].topic);
+    ASSERT_TRUE(received[1].payload == small);
+    ASSERT_EQ(std::string("end"), received[2].topic);
+    ASSERT_EQ(0u, received[2].payload.size());
+    ASSERT_EQ(3u, sender.getStats().messages_sent);
+    ASSERT_EQ(3u, receiver.getStats().messages_delivered);
+}
+
+TEST(ReliableUdpTest, LostFragmentsAndAcksAreRecovered) {
+    UdpTransport tx_socket;
+    UdpTransport rx_socket;
+    ASSERT_TRUE(tx_socket.initialize(0));
+    ASSERT_TRUE(rx_socket.initialize(0));
+
+    ReliableUdpChannel::Options options;
+    options.window = 32;
+    ReliableUdpChannel sender(tx_socket, "lossy_tx", options);
+    ReliableUdpChannel receiver(rx_socket, "lossy_rx", options);
+
+    // First transmission of every 7th fragment and every 3rd acknowledgement is lost, including the tail
+    std::mutex drop_mutex;
+    std::set<uint32_t> dropped;
+    int acks = 0;
+    attach(rx_socket, receiver, [&](const MessagePacket& packet) {
+        ReliableFragment header;
+        std::memcpy(&header, packet.getPayload(), sizeof(header));
+        std::lock_guard<std::mutex> lock(drop_mutex);
+        return header.seq % 7 == 3 && dropped.insert(header.seq).second;
+    });
+    attach(tx_socket, sender, [&](const MessagePacket&) {
+        std::lock_guard<std::mutex> lock(drop_mutex);
+        return ++acks % 3 == 0;
+    });
+    ShutdownOnExit shutdown{tx_socket, rx_socket};
+
+    std::mutex mutex;
+    std::vector<Received> received;
+    receiver.setMessageCallback([&](StringView, StringView group, StringView topic, const uint8_t* payload,
+                                    size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back({group.str(), topic.str(), std::vector<uint8_t>(payload, payload + size)});
+    });
+
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", rx_socket.getPort(), dest));
+
+    // Lossless command stream: every message, in order
+    std::vector<std::vector<uint8_t>> sent;
+    for (int i = 0; i < 20; ++i) {
+        sent.push_back(pattern(static_cast<size_t>(i) * 997 + 10, static_cast<uint8_t>(i)));
+        ASSERT_TRUE(sender.send(dest, "robot", "commands", sent.back().data(), sent.back().size()));
+    }
+    ASSERT_TRUE(waitFor(mutex, received, sent.size()));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(sent.size(), received.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        ASSERT_TRUE(received[i].payload == sent[i]);
+    }
+    ASSERT_GT(sender.getStats().retransmits, 0u);
+    ASSERT_GT(receiver.getStats().nacks_sent, 0u);
+}
+
+TEST(ReliableUdpTest, SendTimesOutWithoutReceiver) {
+    UdpTransport tx_socket;
+    UdpTransport silent;  // Bound, but nobody acknowledges
+    ASSERT_TRUE(tx_socket.initialize(0));
+    ASSERT_TRUE(silent.initialize(0));
+
+    ReliableUdpChannel::Options options;
+    options.window = 4;
+    options.timeout_ms = 100;
+    ReliableUdpChannel sender(tx_socket, "lonely_tx", options);
+
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", silent.getPort(), dest));
+    const std::vector<uint8_t> payload = pattern(options.fragment_size * 10, 3);
+    ASSERT_FALSE(sender.send(dest, "g", "t", payload.data(), payload.size()));
+
+    // Too large for any receiver
+    options.max_message_size = 1000;
+    ReliableUdpChannel limited(tx_socket, "limited_tx", options);
+    ASSERT_FALSE(limited.send(dest, "g", "t", payload.data(), payload.size()));
+}
+
+TEST(ReliableUdpTest, NodePublishesReliableTopic) {
+    // A remote subscriber of a UDP service, speaking the reliable protocol
+    UdpTransport remote_socket;
+    ASSERT_TRUE(remote_socket.initialize(0));
+    ReliableUdpChannel remote(remote_socket, "reliable_remote", ReliableUdpChannel::Options());
+    attach(remote_socket, remote);
+    ShutdownOnExit shutdown{remote_socket, remote_socket};
+
+    std::mutex mutex;
+    std::vector<Received> received;
+    remote.setMessageCallback([&](StringView, StringView group, StringView topic, const uint8_t* payload,
+                                  size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back({group.str(), topic.str(), std::vector<uint8_t>(payload, payload + size)});
+    });
+
+    ServiceDescriptor svc;
+    svc.node_id = "reliable_remote";
+    svc.group = "lidar";
+    svc.topic = "scan";
+    svc.transport = TransportType::UDP;
+    svc.udp_address = "127.0.0.1:" + std::to_string(remote_socket.getPort());
+    GlobalRegistry::instance().registerService("lidar", svc);
+
+    auto publisher = std::make_shared<NodeImpl>("reliable_pub", true, 0, TransportMode::UDP);
+    publisher->initialize(0);
+    ASSERT_EQ(Node::INVALID_ARG, publisher->setTopicReliable("", "scan", true));
+    ASSERT_EQ(Node::NO_ERROR, publisher->setTopicReliable("lidar", "scan", true));
+
+    // One publish, far beyond a datagram; a gathered publish behind it
+    const std::vector<uint8_t> scan = pattern(512 * 1024, 9);
+    ASSERT_EQ(Node::NO_ERROR, publisher->publish("lidar", "scan", scan.data(), scan.size()));
+    const char head[] = "head";
+    const Node::PayloadSegment segments[] = {{head, 4}, {scan.data(), 1000}};
+    ASSERT_EQ(Node::NO_ERROR, publisher->publishv("lidar", "scan", segments, 2));
+    ASSERT_TRUE(waitFor(mutex, received, 2));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(2u, received.size());
+        ASSERT_EQ(std::string("lidar"), received[0].group);
+        ASSERT_EQ(std::string("scan"), received[0].topic);
+        ASSERT_TRUE(received[0].payload == scan);
+        ASSERT_EQ(1004u, received[1].payload.size());
+        ASSERT_EQ(0, std::memcmp(received[1].payload.data(), head, 4));
+    }
+
+    GlobalRegistry::instance().unregisterService("lidar", svc);
+}
+
+TEST(ReliableUdpTest, NodeBridgesLargeDataChannel) {
+    // A remote importer of the bridged channel, speaking the reliable protocol
+    UdpTransport remote_socket;
+    ASSERT_TRUE(remote_socket.initialize(0));
+    ReliableUdpChannel remote(remote_socket, "bridge_remote", ReliableUdpChannel::Options());
+    attach(remote_socket, remote);
+    ShutdownOnExit shutdown{remote_socket, remote_socket};
+
+    std::mutex mutex;
+    std::vector<Received> received;
+    remote.setMessageCallback([&](StringView, StringView group, StringView topic, const uint8_t* payload,
+                                  size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back({group.str(), topic.str(), std::vector<uint8_t>(payload, payload + size)});
+    });
+
+    ServiceDescriptor svc;
+    svc.node_id = "bridge_remote";
+    svc.group = Node::LARGE_DATA_BRIDGE_GROUP;
+    svc.topic = "ch_bridge_udp";
+    svc.transport = TransportType::UDP;
+    svc.udp_address = "127.0.0.1:" + std::to_string(remote_socket.getPort());
+    GlobalRegistry::instance().registerService(svc.group, svc);
+
+    auto bridge = std::make_shared<NodeImpl>("bridge_udp", true, 0, TransportMode::UDP);
+    bridge->initialize(0);
+    ASSERT_EQ(Node::NO_ERROR, bridge->bridgeLargeData("ch_bridge_udp"));
+
+    // Advertised for remote discovery
+    bool advertised = false;
+    for (const auto& channel : bridge->findLargeDataChannels(Node::LARGE_DATA_BRIDGE_GROUP)) {
+        advertised = advertised || (channel.node_id == "bridge_udp" && channel.channel_name == "ch_bridge_udp");
+    }
+    ASSERT_TRUE(advertised);
+
+    const std::vector<uint8_t> frame = pattern(1024 * 1024, 5);
+    ASSERT_EQ(Node::NO_ERROR, bridge->writeLargeData("ch_bridge_udp", "camera", frame.data(), frame.size()));
+    ASSERT_TRUE(waitFor(mutex, received, 1));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(std::string(Node::LARGE_DATA_BRIDGE_GROUP), received[0].group);
+        ASSERT_EQ(std::string("ch_bridge_udp"), received[0].topic);
+        ASSERT_EQ(sizeof(LargeDataBridgeHeader) + frame.size(), received[0].payload.size());
+        LargeDataBridgeHeader header;
+        std::memcpy(&header, received[0].payload.data(), sizeof(header));
+        ASSERT_EQ(std::string("camera"), std::string(header.topic));
+        ASSERT_EQ(frame.size(), static_cast<size_t>(header.size));
+        ASSERT_EQ(0, header.stream_flags);
+        ASSERT_EQ(0, std::memcmp(received[0].payload.data() + sizeof(header), frame.data(), frame.size()));
+    }
+
+    ASSERT_EQ(Node::NO_ERROR, bridge->unbridgeLargeData("ch_bridge_udp"));
+    GlobalRegistry::instance().unregisterService(svc.group, svc);
+}
@@ -3,7 +3,14 @@
 #include "nexus/transport/UdpTransport.h"
 #include "nexus/core/NodeImpl.h"
 #include "nexus/core/Message.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <pthread.h>
+#include <set>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace Nexus;
 using namespace Nexus::rpc;
@@ -31,6 +38,423 @@ TEST(UdpTransportTest, BasicInit) {
     ASSERT_TRUE(transport.initialize(0));
 }
 
+TEST(UdpTransportTest, CompressedRoundTrip) {
+    UdpTransport sender;
+    UdpTransport receiver;
+    ASSERT_TRUE(sender.initialize(0));
+    ASSERT_TRUE(receiver.initialize(0));
+    sender.setCompressionThreshold(512);
+
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> received;
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.emplace_back(data, data + size);
+    });
+
+    std::string diagnostics;
+    while (diagnostics.size() < 8000) {
+        diagnostics += "{\"dtc\":\"P0420\",\"state\":\"inactive\"},";
+    }
+    auto large = MessageBuilder::build("udp_sender", "diag", "dtc", diagnostics);
+    auto small = MessageBuilder::build("udp_sender", "diag", "dtc", "tiny");
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    ASSERT_TRUE(sender.sendTo(large.data(), large.size(), dest));
+    ASSERT_TRUE(sender.sendTo(small.data(), small.size(), dest));
+
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() == 2) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // Only the large packet went compressed; both arrive as sent
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(2u, received.size());
+    ASSERT_TRUE(received[0] == large);
+    ASSERT_TRUE(received[1] == small);
+    ASSERT_EQ(1u, sender.getCompressionStats().packets_compressed);
+    ASSERT_TRUE(sender.getCompressionStats().bytes_saved > large.size() / 2);
+    ASSERT_EQ(1u, receiver.getCompressionStats().packets_expanded);
+}
+
+TEST(UdpTransportTest, SendBatch) {
+    UdpTransport sender;
+    UdpTransport receivers[3];
+    ASSERT_TRUE(sender.initialize(0));
+
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> received[3];
+    std::vector<sockaddr_in> dests;
+    for (int r = 0; r < 3; ++r) {
+        ASSERT_TRUE(receivers[r].initialize(0));
+        receivers[r].setReceiveCallback([&, r](const uint8_t* data, size_t size, const sockaddr_in&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            received[r].emplace_back(data, data + size);
+        });
+        sockaddr_in dest;
+        ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receivers[r].getPort(), dest));
+        dests.push_back(dest);
+    }
+
+    // One datagram fanned out to every receiver
+    auto packet = MessageBuilder::build("udp_sender", "telemetry", "speed", "42");
+    ASSERT_EQ(3u, sender.sendBatch(packet.data(), packet.size(), dests));
+
+    // More datagrams than one sendmmsg call takes, to a single receiver, in order
+    std::vector<std::vector<uint8_t>> burst;
+    for (size_t i = 0; i < UdpTransport::SEND_BATCH + 6; ++i) {
+        burst.push_back(MessageBuilder::build("udp_sender", "telemetry", "speed", std::to_string(i)));
+    }
+    std::vector<UdpTransport::Datagram> datagrams;
+    for (const auto& datagram : burst) {
+        datagrams.push_back({datagram.data(), datagram.size()});
+    }
+    ASSERT_EQ(burst.size(), sender.sendBatch(datagrams.data(), datagrams.size(), dests[0]));
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received[0].size() == burst.size() + 1 && received[1].size() == 1 && received[2].size() == 1) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(burst.size() + 1, received[0].size());
+    for (int r = 0; r < 3; ++r) {
+        ASSERT_TRUE(received[r][0] == packet);
+    }
+    for (size_t i = 0; i < burst.size(); ++i) {
+        ASSERT_TRUE(received[0][i + 1] == burst[i]);
+    }
+}
+
+TEST(UdpTransportTest, IdleReceiverWakesOnDatagram) {
+    UdpTransport sender;
+    UdpTransport receiver;
+    ASSERT_TRUE(sender.initialize(0));
+    ASSERT_TRUE(receiver.initialize(0));
+
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const sockaddr_in&) { received.fetch_add(1); });
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    auto packet = MessageBuilder::build("udp_sender", "cmd", "stop", "now");
+
+    // The first datagram after an idle period is delivered without waiting out a sleep
+    int fast = 0;
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(sender.sendTo(packet.data(), packet.size(), dest));
+        while (received.load() <= i && std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(i + 1, received.load());
+        if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2)) {
+            ++fast;
+        }
+    }
+    ASSERT_GT(fast, 5);
+
+    // shutdown() wakes the blocked receive thread immediately
+    auto start = std::chrono::steady_clock::now();
+    receiver.shutdown();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+}
+
+TEST(UdpTransportTest, CallbackReplacedWithoutWaitingForDispatch) {
+    UdpTransport sender;
+    UdpTransport receiver;
+    ASSERT_TRUE(sender.initialize(0));
+    ASSERT_TRUE(receiver.initialize(0));
+
+    // The first callback stays busy until released and records the raw sender address
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::atomic<uint16_t> from_port{0};
+    std::atomic<uint32_t> from_ip{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const sockaddr_in& from) {
+        from_port.store(ntohs(from.sin_port));
+        from_ip.store(ntohl(from.sin_addr.s_addr));
+        entered.store(true);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    auto packet = MessageBuilder::build("udp_sender", "cmd", "stop", "now");
+    ASSERT_TRUE(sender.sendTo(packet.data(), packet.size(), dest));
+    for (int i = 0; i < 200 && !entered.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(entered.load());
+    ASSERT_EQ(sender.getPort(), from_port.load());
+    ASSERT_EQ(static_cast<uint32_t>(INADDR_LOOPBACK), from_ip.load());
+
+    // Installing a new callback does not wait for the running one
+    std::atomic<int> replaced{0};
+    auto start = std::chrono::steady_clock::now();
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const sockaddr_in&) { replaced.fetch_add(1); });
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    release.store(true);
+
+    ASSERT_TRUE(sender.sendTo(packet.data(), packet.size(), dest));
+    for (int i = 0; i < 200 && replaced.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(1, replaced.load());
+
+    sockaddr_in wildcard;
+    ASSERT_TRUE(UdpTransport::resolveAddress("0.0.0.0", 0, wildcard));
+    ASSERT_EQ(std::string("127.0.0.1"), UdpTransport::formatAddress(wildcard));
+    const sockaddr_in reply = UdpTransport::replyAddress(wildcard, 4242);
+    ASSERT_EQ(std::string("127.0.0.1"), UdpTransport::formatAddress(reply));
+    ASSERT_EQ(4242, ntohs(reply.sin_port));
+}
+
+TEST(UdpTransportTest, SegmentationOffloadKeepsDatagrams) {
+    UdpTransport sender;
+    UdpTransport receiver;
+    UdpTransport plain_receiver;
+    plain_receiver.setSegmentationOffload(false);
+    ASSERT_TRUE(sender.initialize(0));
+    ASSERT_TRUE(receiver.initialize(0));
+    ASSERT_TRUE(plain_receiver.initialize(0));
+    ASSERT_FALSE(plain_receiver.hasReceiveOffload());
+
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> received[2];
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received[0].emplace_back(data, data + size);
+    });
+    plain_receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received[1].emplace_back(data, data + size);
+    });
+
+    // A larger first datagram, runs of equal sizes, shorter tails: as reliable fragments look
+    std::vector<std::vector<uint8_t>> payloads;
+    const size_t sizes[] = {1300, 1000, 1000, 1000, 1000, 600, 1000, 1000, 1000, 1000, 1000, 1000, 40};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; ++i) {
+            payload[i] = static_cast<uint8_t>(payloads.size() * 7 + i);
+        }
+        payloads.push_back(payload);
+    }
+    std::vector<UdpTransport::Datagram> datagrams;
+    for (const auto& payload : payloads) {
+        datagrams.push_back({payload.data(), payload.size()});
+    }
+
+    sockaddr_in dests[2];
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dests[0]));
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", plain_receiver.getPort(), dests[1]));
+    for (int r = 0; r < 2; ++r) {
+        ASSERT_EQ(datagrams.size(), sender.sendBatch(datagrams.data(), datagrams.size(), dests[r]));
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received[0].size() >= payloads.size() && received[1].size() >= payloads.size()) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // Both receivers see the original datagrams, whether or not the kernel segmented and coalesced them
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int r = 0; r < 2; ++r) {
+        ASSERT_EQ(payloads.size(), received[r].size());
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            ASSERT_TRUE(received[r][i] == payloads[i]);
+        }
+    }
+    if (sender.hasSendOffload()) {
+        ASSERT_GT(sender.getOffloadStats().segmented_sends, 0u);
+        ASSERT_GT(sender.getOffloadStats().segmented_datagrams, sender.getOffloadStats().segmented_sends);
+        // Loopback hands segmented messages to a UDP_GRO socket unsplit
+        if (receiver.hasReceiveOffload()) {
+            ASSERT_GT(receiver.getOffloadStats().coalesced_datagrams, 0u);
+        }
+    }
+    ASSERT_EQ(0u, plain_receiver.getOffloadStats().coalesced_receives);
+}
+
+TEST(UdpTransportTest, IoUringReceiveKeepsDatagrams) {
+    UdpTransport sender;
+    UdpTransport receiver;
+    receiver.setIoUring(true);
+    receiver.setCompressionThreshold(64);
+    ASSERT_TRUE(sender.initialize(0));
+    ASSERT_TRUE(receiver.initialize(0));
+    sender.setCompressionThreshold(512);
+
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> received;
+    std::vector<uint16_t> from_ports;
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in& from) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.emplace_back(data, data + size);
+        from_ports.push_back(ntohs(from.sin_port));
+    });
+
+    // More rounds than the ring has buffers: they must be recycled (and the receive re-armed if it ran dry)
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    std::vector<std::vector<uint8_t>> payloads;
+    for (int round = 0; round < 4; ++round) {
+        std::vector<UdpTransport::Datagram> datagrams;
+        const size_t first = payloads.size();
+        for (int i = 0; i < 50; ++i) {
+            // Mostly small datagrams, some large and compressible (expanded on receive)
+            std::vector<uint8_t> payload(i % 10 == 0 ? 2000 : 100 + i, static_cast<uint8_t>(round * 50 + i));
+            payloads.push_back(payload);
+        }
+        for (size_t i = first; i < payloads.size(); ++i) {
+            datagrams.push_back({payloads[i].data(), payloads[i].size()});
+        }
+        ASSERT_EQ(datagrams.size(), sender.sendBatch(datagrams.data(), datagrams.size(), dest));
+        for (int i = 0; i < 200; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (received.size() >= payloads.size()) {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // Same datagrams, in order, from the sender's socket, whichever receive backend the kernel allowed
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(payloads.size(), received.size());
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            ASSERT_TRUE(received[i] == payloads[i]);
+            ASSERT_EQ(sender.getPort(), from_ports[i]);
+        }
+    }
+    ASSERT_GT(receiver.getCompressionStats().packets_expanded, 0u);
+
+    // Shutdown wakes the completion wait
+    receiver.shutdown();
+    ASSERT_FALSE(receiver.usesIoUring());
+
+    UdpTransport plain;
+    ASSERT_TRUE(plain.initialize(0));
+    ASSERT_FALSE(plain.usesIoUring());
+}
+
+TEST(UdpTransportTest, ReusePortReceiveThreads) {
+    UdpTransport receiver;
+    receiver.setReceiveThreads(4);
+    ASSERT_TRUE(receiver.initialize(0));
+
+    // The port stays exclusive, to plain and reuse-port transports alike
+    UdpTransport plain;
+    ASSERT_FALSE(plain.initialize(receiver.getPort()));
+    UdpTransport grouped;
+    grouped.setReceiveThreads(4);
+    ASSERT_FALSE(grouped.initialize(receiver.getPort()));
+
+    constexpr int SENDERS = 8;
+    constexpr int MESSAGES = 50;
+    std::mutex mutex;
+    std::vector<int> sequences[SENDERS];
+    std::set<std::thread::id> threads;
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const sockaddr_in&) {
+        if (size != 2 || data[0] >= SENDERS) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        sequences[data[0]].push_back(data[1]);
+        threads.insert(std::this_thread::get_id());
+    });
+
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    UdpTransport senders[SENDERS];
+    for (int s = 0; s < SENDERS; ++s) {
+        ASSERT_TRUE(senders[s].initialize(0));
+    }
+    for (int i = 0; i < MESSAGES; ++i) {
+        for (int s = 0; s < SENDERS; ++s) {
+            const uint8_t datagram[2] = {static_cast<uint8_t>(s), static_cast<uint8_t>(i)};
+            ASSERT_TRUE(senders[s].sendTo(datagram, sizeof(datagram), dest));
+        }
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t total = 0;
+            for (const auto& sequence : sequences) total += sequence.size();
+            if (total == SENDERS * MESSAGES) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Each sender is one flow: hashed to one socket, received in order
+    for (const auto& sequence : sequences) {
+        ASSERT_EQ(static_cast<size_t>(MESSAGES), sequence.size());
+        for (int i = 0; i < MESSAGES; ++i) {
+            ASSERT_EQ(i, sequence[i]);
+        }
+    }
+    // Eight flows over four sockets: more than one receive thread ran the callback
+    ASSERT_GT(threads.size(), 1u);
+}
+
+TEST(UdpTransportTest, ReceiveThreadsSteeredByCpu) {
+    // Every CPU routed to socket 0 (both threads share the only set): all datagrams take one thread
+    UdpTransport receiver;
+    receiver.setReceiveThreads(2, {0x1});
+    ASSERT_TRUE(receiver.initialize(0));
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const sockaddr_in&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        received.fetch_add(1);
+    });
+
+    // Loopback datagrams are received on the sending CPU: send from CPU 0
+    cpu_set_t saved;
+    ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved));
+    cpu_set_t cpu0;
+    CPU_ZERO(&cpu0);
+    CPU_SET(0, &cpu0);
+    ASSERT_EQ(0, pthread_setaffinity_np(pthread_self(), sizeof(cpu0), &cpu0));
+
+    sockaddr_in dest;
+    ASSERT_TRUE(UdpTransport::resolveAddress("127.0.0.1", receiver.getPort(), dest));
+    UdpTransport senders[8];
+    for (auto& sender : senders) {
+        ASSERT_TRUE(sender.initialize(0));
+        const uint8_t datagram[1] = {1};
+        ASSERT_TRUE(sender.sendTo(datagram, sizeof(datagram), dest));
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+
+    for (int i = 0; i < 200 && received.load() < 8; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(8, received.load());
+    ASSERT_EQ(1u, threads.size());
+}
+
 TEST(TransportTest, MessageSerialization) {
     // Test MessagePacket struct serialization
     MessagePacket msg;
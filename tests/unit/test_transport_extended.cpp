@@ -1,6 +1,8 @@
 #include "simple_test.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include <atomic>
+#include <cstring>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <string>
@@ -83,3 +85,159 @@ TEST(SharedMemoryTransportExtendedTest, Broadcast) {
     t2.stopReceiving();
     t3.stopReceiving();
 }
+
+TEST(SharedMemoryTransportExtendedTest, SendInPlace) {
+    SharedMemoryTransportV3 t1;
+    SharedMemoryTransportV3 t2;
+
+    ASSERT_TRUE(t1.initialize("inplace_node1"));
+    ASSERT_TRUE(t2.initialize("inplace_node2"));
+
+    std::atomic<int> received_count{0};
+    std::string last_msg;
+
+    t2.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        last_msg.assign(reinterpret_cast<const char*>(data), size);
+        received_count++;
+    });
+    t2.startReceiving();
+
+    const std::string msg = "Written in place";
+    ASSERT_TRUE(t1.sendInPlace("inplace_node2", msg.size(),
+                               [&](uint8_t* frame, size_t size) { std::memcpy(frame, msg.data(), size); }));
+
+    // Invalid requests
+    ASSERT_FALSE(t1.sendInPlace("inplace_node2", msg.size(), nullptr));
+    ASSERT_FALSE(t1.sendInPlace("inplace_node1", msg.size(), [](uint8_t*, size_t) {}));
+
+    for (int i = 0; i < 20; ++i) {
+        if (received_count > 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(1, received_count);
+    ASSERT_EQ(msg, last_msg);
+
+    t2.stopReceiving();
+}
+
+TEST(SharedMemoryTransportExtendedTest, SendBatch) {
+    SharedMemoryTransportV3 t1;
+    SharedMemoryTransportV3 t2;
+
+    ASSERT_TRUE(t1.initialize("batch_node1"));
+    ASSERT_TRUE(t2.initialize("batch_node2"));
+
+    std::atomic<int> received_count{0};
+    std::vector<std::string> received;
+    std::mutex received_mutex;
+
+    t2.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received.emplace_back(reinterpret_cast<const char*>(data), size);
+        received_count++;
+    });
+    t2.startReceiving();
+
+    const std::vector<std::string> msgs = {"first", "second", "third"};
+    std::vector<const uint8_t*> frames;
+    std::vector<size_t> sizes;
+    for (const auto& m : msgs) {
+        frames.push_back(reinterpret_cast<const uint8_t*>(m.data()));
+        sizes.push_back(m.size());
+    }
+
+    ASSERT_EQ(3u, t1.sendv("batch_node2", frames.data(), sizes.data(), frames.size()));
+    ASSERT_EQ(0u, t1.sendv("batch_node2", nullptr, sizes.data(), sizes.size()));
+    ASSERT_EQ(0u, t1.sendv("batch_node1", frames.data(), sizes.data(), frames.size()));
+
+    for (int i = 0; i < 50; ++i) {
+        if (received_count >= 3) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(3, received_count);
+    std::lock_guard<std::mutex> lock(received_mutex);
+    ASSERT_TRUE(received == msgs);
+
+    t2.stopReceiving();
+}
+
+TEST(SharedMemoryTransportExtendedTest, SendByHandle) {
+    SharedMemoryTransportV3 t1;
+    SharedMemoryTransportV3 t2;
+
+    ASSERT_TRUE(t1.initialize("handle_node1"));
+    ASSERT_TRUE(t2.initialize("handle_node2"));
+
+    std::atomic<int> received_count{0};
+    t2.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received_count++; });
+    t2.startReceiving();
+
+    ASSERT_EQ(SharedMemoryTransportV3::INVALID_NODE_HANDLE, t1.resolveNode("handle_node1"));
+    ASSERT_EQ(SharedMemoryTransportV3::INVALID_NODE_HANDLE, t1.resolveNode("handle_missing"));
+
+    SharedMemoryTransportV3::NodeHandle handle = t1.resolveNode("handle_node2");
+    ASSERT_NE(SharedMemoryTransportV3::INVALID_NODE_HANDLE, handle);
+    ASSERT_EQ(handle, t1.resolveNode("handle_node2"));
+
+    const std::string msg = "via handle";
+    ASSERT_TRUE(t1.send(handle, reinterpret_cast<const uint8_t*>(msg.data()), msg.size()));
+
+    for (int i = 0; i < 20; ++i) {
+        if (received_count > 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, received_count);
+
+    // Handles are not reused after a disconnect
+    t1.disconnectFromNode("handle_node2");
+    ASSERT_FALSE(t1.send(handle, reinterpret_cast<const uint8_t*>(msg.data()), msg.size()));
+    SharedMemoryTransportV3::NodeHandle new_handle = t1.resolveNode("handle_node2");
+    ASSERT_NE(SharedMemoryTransportV3::INVALID_NODE_HANDLE, new_handle);
+    ASSERT_NE(handle, new_handle);
+
+    t2.stopReceiving();
+}
+
+TEST(SharedMemoryTransportExtendedTest, MediumSizedMessages) {
+    SharedMemoryTransportV3 t1;
+    SharedMemoryTransportV3 t2;
+
+    ASSERT_TRUE(t1.initialize("medium_node1"));
+    ASSERT_TRUE(t2.initialize("medium_node2"));
+
+    std::atomic<int> received_count{0};
+    std::vector<size_t> received_sizes;
+    std::mutex received_mutex;
+
+    t2.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string&) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        if (size > 0 && data[size - 1] == 0x5A) {
+            received_sizes.push_back(size);
+        }
+        received_count++;
+    });
+    t2.startReceiving();
+
+    // 8KB tile and a near-maximum packet travel over the normal data queue
+    std::vector<uint8_t> tile(8 * 1024, 0x5A);
+    std::vector<uint8_t> big(65000, 0x5A);
+    tile[6] = 0;  // Message type byte: DATA, so the data queue is used
+    big[6] = 0;
+    ASSERT_TRUE(t1.send("medium_node2", tile.data(), tile.size()));
+    ASSERT_TRUE(t1.send("medium_node2", big.data(), big.size()));
+
+    for (int i = 0; i < 50; ++i) {
+        if (received_count >= 2) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(2, received_count);
+    std::lock_guard<std::mutex> lock(received_mutex);
+    ASSERT_EQ(2u, received_sizes.size());
+    ASSERT_EQ(tile.size(), received_sizes[0]);
+    ASSERT_EQ(big.size(), received_sizes[1]);
+
+    t2.stopReceiving();
+}
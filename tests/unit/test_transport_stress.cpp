@@ -1,6 +1,10 @@
 #include "simple_test.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <string>
@@ -57,9 +61,7 @@ TEST(TransportStress, NotifyMechanisms) {
 TEST(TransportStress, Congestion) {
     SharedMemoryTransportV3 t1, t2;
     SharedMemoryTransportV3::Config config;
-    // Note: queue_capacity in Config is currently ignored by implementation, 
-    // it uses fixed compile-time constant QUEUE_CAPACITY = 256.
-    // So we need to send more than 256 messages to trigger congestion.
+    // Default queue_capacity is the full 512KB data queue.
     
     ASSERT_TRUE(t1.initialize("cong_node1", config));
     ASSERT_TRUE(t2.initialize("cong_node2", config));
@@ -221,6 +223,70 @@ TEST(TransportStress, ExplicitDisconnect) {
     ASSERT_EQ(t1.getConnectionCount(), 1);
 }
 
+TEST(TransportStress, RegistryChangeConnects) {
+    SharedMemoryTransportV3 t1;
+    ASSERT_TRUE(t1.initialize("push_node1"));
+    t1.startReceiving();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(t1.getConnectionCount(), 0);
+
+    // A node registering wakes t1's heartbeat loop well before its next 1s round
+    SharedMemoryTransportV3 t2;
+    ASSERT_TRUE(t2.initialize("push_node2"));
+    for (int i = 0; i < 50 && t1.getConnectionCount() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(t1.getConnectionCount(), 1);
+
+    t1.stopReceiving();
+}
+
+TEST(TransportStress, ConnectAsyncReadiness) {
+    SharedMemoryTransportV3 t1;
+    ASSERT_TRUE(t1.initialize("async_node1"));
+    std::mutex mutex;
+    std::vector<std::string> ready;
+    t1.setConnectionCallback([&](const std::string& node_id, SharedMemoryTransportV3::NodeHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (handle != SharedMemoryTransportV3::INVALID_NODE_HANDLE) {
+            ready.push_back(node_id);
+        }
+    });
+
+    SharedMemoryTransportV3 t2;
+    ASSERT_TRUE(t2.initialize("async_node2"));
+    t1.connectAsync("async_node2");
+    size_t ready_count = 0;
+    for (int i = 0; i < 100 && ready_count == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::lock_guard<std::mutex> lock(mutex);
+        ready_count = ready.size();
+    }
+    ASSERT_EQ(ready_count, 1u);
+    ASSERT_EQ(ready[0], std::string("async_node2"));
+    ASSERT_EQ(t1.getConnectionCount(), 1);
+    ASSERT_FALSE(t1.isConnectPending("async_node2"));
+
+    // An unregistered node fails once on the caller's thread, then is dropped by the connector
+    ASSERT_EQ(t1.resolveNode("async_missing"), SharedMemoryTransportV3::INVALID_NODE_HANDLE);
+    for (int i = 0; i < 100 && t1.isConnectPending("async_missing"); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_FALSE(t1.isConnectPending("async_missing"));
+}
+
+TEST(TransportStress, ShutdownWithoutPeersIsImmediate) {
+    auto transport = std::unique_ptr<SharedMemoryTransportV3>(new SharedMemoryTransportV3());
+    ASSERT_TRUE(transport->initialize("shutdown_node"));
+    transport->startReceiving();
+
+    // Nobody is attached: the destructor has nothing to wait for (it used to sleep 300ms)
+    auto start = std::chrono::steady_clock::now();
+    transport.reset();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_LT(elapsed.count(), 250);
+}
+
 TEST(TransportStress, HeartbeatLoop) {
     SharedMemoryTransportV3 t;
     ASSERT_TRUE(t.initialize("hb_node"));
@@ -268,3 +334,132 @@ TEST(TransportStress, Stats) {
     
     t2.stopReceiving();
 }
+
+TEST(TransportStress, RuntimeQueueCapacity) {
+    SharedMemoryTransportV3 t1, t2;
+    SharedMemoryTransportV3::Config small_config;
+    small_config.queue_capacity = SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES;  // 256KB
+
+    ASSERT_TRUE(t1.initialize("cap_node1"));
+    ASSERT_TRUE(t2.initialize("cap_node2", small_config));
+
+    // Receiver's capacity applies: ~130 frames of 2008 bytes fit in 256KB (vs ~261 in 512KB)
+    std::vector<uint8_t> data(2000, 0);
+    int sent = 0;
+    for (int i = 0; i < 300; ++i) {
+        if (t1.send("cap_node2", data.data(), data.size())) {
+            sent++;
+        }
+    }
+    ASSERT_GT(sent, 110);
+    ASSERT_LT(sent, 150);
+}
+
+TEST(TransportStress, NonBlockingQueueFull) {
+    SharedMemoryTransportV3 t1, t2;
+    SharedMemoryTransportV3::Config config;
+    config.queue_capacity = SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES;
+    config.non_blocking = true;
+
+    ASSERT_TRUE(t1.initialize("nb_node1", config));
+    ASSERT_TRUE(t2.initialize("nb_node2", config));
+
+    std::vector<uint8_t> data(2000, 0);
+    ASSERT_FALSE(t1.isQueueFull("nb_node2", data.size()));  // Not connected yet
+
+    // Fill the receiver's queue (not receiving yet)
+    int sent = 0;
+    while (t1.send("nb_node2", data.data(), data.size())) {
+        sent++;
+    }
+    ASSERT_GT(sent, 20);
+    ASSERT_TRUE(t1.isQueueFull("nb_node2", data.size()));
+
+    // Same answer when addressed by handle
+    auto handle = t1.resolveNode("nb_node2");
+    ASSERT_NE(handle, SharedMemoryTransportV3::INVALID_NODE_HANDLE);
+    ASSERT_TRUE(t1.isQueueFull(handle, data.size()));
+    ASSERT_FALSE(t1.sendInPlace(handle, data.size(), [](uint8_t*, size_t) {}));
+
+    // Out of credit: every further send fails immediately instead of backing off
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_FALSE(t1.send("nb_node2", data.data(), data.size()));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 50);
+
+    // Draining restores credit
+    std::atomic<int> received{0};
+    t2.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    t2.startReceiving();
+    for (int i = 0; i < 100 && received.load() < sent; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), sent);
+    ASSERT_FALSE(t1.isQueueFull("nb_node2", data.size()));
+    ASSERT_FALSE(t1.isQueueFull(handle, data.size()));
+    ASSERT_TRUE(t1.send("nb_node2", data.data(), data.size()));
+    ASSERT_TRUE(t1.sendInPlace(handle, data.size(), [&](uint8_t* frame, size_t size) {
+        std::memcpy(frame, data.data(), size);
+    }));
+}
+
+TEST(TransportStress, PriorityLanes) {
+    SharedMemoryTransportV3 t1, t2;
+    SharedMemoryTransportV3::Config config;
+    config.queue_capacity = SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES;
+
+    ASSERT_TRUE(t1.initialize("lane_node1", config));
+    ASSERT_TRUE(t2.initialize("lane_node2", config));
+
+    const uint32_t high = 0;
+    const uint32_t bulk = SharedMemoryTransportV3::DATA_LANES - 1;
+    auto handle = t1.resolveNode("lane_node2");
+    ASSERT_NE(handle, SharedMemoryTransportV3::INVALID_NODE_HANDLE);
+
+    // Fill the bulk lane: its DROP policy fails immediately once out of credit
+    std::vector<uint8_t> data(2000, 'B');
+    auto fill = [&](uint8_t* frame, size_t size) { std::memcpy(frame, data.data(), size); };
+    int bulk_sent = 0;
+    while (t1.sendInPlace(handle, data.size(), fill, bulk)) {
+        bulk_sent++;
+    }
+    ASSERT_GT(bulk_sent, 20);
+    ASSERT_TRUE(t1.isQueueFull(handle, data.size(), bulk));
+    ASSERT_FALSE(t1.isQueueFull(handle, data.size(), high));  // Lanes have separate credit
+
+    // A command queued behind the burst still has room in its own lane
+    data.assign(16, 'H');
+    ASSERT_TRUE(t1.sendInPlace(handle, data.size(), fill, high));
+
+    auto sender_stats = t1.getStats();
+    ASSERT_EQ(sender_stats.lanes[high].messages_sent, 1u);
+    ASSERT_EQ(sender_stats.lanes[bulk].messages_sent, static_cast<uint64_t>(bulk_sent));
+    ASSERT_EQ(sender_stats.lanes[bulk].messages_dropped, 1u);
+
+    auto receiver_stats = t2.getStats();
+    ASSERT_EQ(receiver_stats.lanes[high].depth, 1u);
+    ASSERT_EQ(receiver_stats.lanes[bulk].depth, static_cast<uint64_t>(bulk_sent));
+
+    // Strict priority: the command is delivered before the earlier bulk frames
+    std::mutex mutex;
+    std::vector<uint8_t> order;
+    t2.setReceiveCallback([&](const uint8_t* frame, size_t, const std::string&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(frame[0]);
+    });
+    t2.startReceiving();
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (order.size() == static_cast<size_t>(bulk_sent) + 1) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(order.size(), static_cast<size_t>(bulk_sent) + 1);
+    ASSERT_EQ(order.front(), 'H');
+}
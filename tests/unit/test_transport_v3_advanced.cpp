@@ -6,8 +6,12 @@
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <signal.h>
@@ -230,3 +234,83 @@ TEST(TransportV3AdvancedTest, DisconnectNonExistent) {
     // Should not crash
     transport.disconnectFromNode("non_existent");
 }
+
+TEST(TransportV3AdvancedTest, DisconnectDoesNotWaitForSnapshotReaders) {
+    TransportV3ModeCleanup cleanup;
+    SharedMemoryTransportV3::Config config;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("retire_recv", config));
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("retire_send", config));
+    std::vector<uint8_t> data = {1};
+    ASSERT_TRUE(sender.send("retire_recv", data.data(), data.size()));
+
+    // A sender blocked in a credit wait holds its reader; the disconnect must not wait for it
+    std::unique_ptr<SharedMemoryTransportV3::SnapshotReader> reader(
+        new SharedMemoryTransportV3::SnapshotReader(sender));
+    const SharedMemoryTransportV3::ConnectionSnapshot::Entry* entry = reader->get()->find("retire_recv");
+    ASSERT_TRUE(entry != nullptr);
+
+    std::atomic<bool> disconnected{false};
+    std::thread disconnector([&]() {
+        sender.disconnectFromNode("retire_recv");
+        disconnected = true;
+    });
+    for (int i = 0; i < 100 && !disconnected.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(disconnected.load());
+    disconnector.join();
+
+    // The old snapshot and the peer's mapping stay usable until the reader leaves
+    ASSERT_EQ(entry->shm->header.magic.load(), SharedMemoryTransportV3::MAGIC);
+    {
+        std::lock_guard<std::mutex> lock(sender.connections_mutex_);
+        sender.reclaimRetiredSnapshots();
+        ASSERT_FALSE(sender.retired_snapshots_.empty());
+    }
+
+    reader.reset();
+    {
+        std::lock_guard<std::mutex> lock(sender.connections_mutex_);
+        sender.reclaimRetiredSnapshots();
+        ASSERT_TRUE(sender.retired_snapshots_.empty());
+    }
+}
+
+TEST(TransportV3AdvancedTest, SharedInboxSkipsAbandonedClaim) {
+    TransportV3ModeCleanup cleanup;
+    SharedMemoryTransportV3::Config config;
+    config.shared_inbox = true;
+    config.inbox_promote_rate = 1000000;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("abandon_recv", config));
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    receiver.startReceiving();
+
+    // A sender that crashed between claiming a slot and publishing it
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(0);
+    }
+    ASSERT_TRUE(child > 0);
+    waitpid(child, nullptr, 0);
+    SharedMemoryTransportV3::SharedInbox& inbox = receiver.my_shm_->inbox;
+    uint64_t pos = inbox.enqueue_pos.fetch_add(1);
+    inbox.slots[pos % SharedMemoryTransportV3::SHARED_INBOX_SLOTS].claimer_pid.store(child);
+
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("abandon_send", config));
+    std::vector<uint8_t> data(32, 0);
+    ASSERT_TRUE(sender.send("abandon_recv", data.data(), data.size()));
+
+    for (int i = 0; i < 200 && received.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), 1);
+    ASSERT_EQ(inbox.dequeue_pos.load(), pos + 2);
+    ASSERT_EQ(receiver.getStats().inbox_depth, 0u);
+}
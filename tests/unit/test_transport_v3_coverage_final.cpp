@@ -51,18 +51,18 @@ TEST(TransportV3CoverageFinal, WarmupConnections) {
     // Create dummy shared memory for target node
     int fd = shm_open("/librpc_node_dummy_target", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    // Increase to 50MB to cover NodeSharedMemory size (approx 45MB)
-    int ret = ftruncate(fd, 50 * 1024 * 1024); 
+    // 64MB to cover NodeSharedMemory size (approx 50MB with 32 queues of three data lanes)
+    int ret = ftruncate(fd, 64 * 1024 * 1024); 
     ASSERT_TRUE(ret == 0);
 
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
 
     // Initialize header
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader(); 
     header->magic.store(0x4C524E33);
-    header->version.store(1);
+    header->version.store(4);
     header->max_queues.store(32); // Set max queues!
     header->ready.store(true); 
     header->owner_pid.store(getpid()); 
@@ -79,7 +79,7 @@ TEST(TransportV3CoverageFinal, WarmupConnections) {
     pthread_cond_init(&header->global_cond, &cattr);
     pthread_condattr_destroy(&cattr);
 
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
 
     // Register dummy node
@@ -139,15 +139,15 @@ TEST(TransportV3CoverageFinal, AccessorListFull) {
     
     int fd = shm_open("/librpc_node_accessor_test", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
+    ftruncate(fd, 64 * 1024 * 1024);
     
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0x4C524E33);
-    header->version.store(1);
+    header->version.store(4);
     header->ready.store(true);
     header->owner_pid.store(getpid());
     header->num_accessors.store(64); 
@@ -167,7 +167,7 @@ TEST(TransportV3CoverageFinal, AccessorListFull) {
     pthread_cond_init(&header->global_cond, &cattr);
     pthread_condattr_destroy(&cattr);
 
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryRegistry registry;
@@ -187,19 +187,19 @@ TEST(TransportV3CoverageFinal, DeadAccessorCleanup) {
     
     int fd = shm_open("/librpc_node_dummy_dead", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
+    ftruncate(fd, 64 * 1024 * 1024);
     
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0x4C524E33);
-    header->version.store(1);
+    header->version.store(4);
     header->ready.store(true);
     header->owner_pid.store(999999); 
     
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryTransportV3::cleanupOrphanedMemory();
@@ -217,16 +217,16 @@ TEST(TransportV3CoverageFinal, InvalidMagicCleanup) {
     
     int fd = shm_open("/librpc_node_dummy_invalid", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
+    ftruncate(fd, 64 * 1024 * 1024);
     
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0xDEADBEEF); 
     
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryTransportV3::cleanupOrphanedMemory();
@@ -240,18 +240,18 @@ TEST(TransportV3CoverageFinal, ConnectToDeadNode) {
     // Create dummy shared memory
     int fd = shm_open("/librpc_node_dummy_dead_target", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ftruncate(fd, 64 * 1024 * 1024);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0x4C524E33);
-    header->version.store(1);
+    header->version.store(4);
     header->ready.store(true);
     header->owner_pid.store(999999); // Dead PID
     
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryRegistry registry;
@@ -277,18 +277,18 @@ TEST(TransportV3CoverageFinal, ConnectToInvalidMagicNode) {
     // Create dummy shared memory
     int fd = shm_open("/librpc_node_dummy_bad_magic", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ftruncate(fd, 64 * 1024 * 1024);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0xDEADBEEF); // Bad magic
-    header->version.store(1);
+    header->version.store(4);
     header->ready.store(true);
     header->owner_pid.store(getpid());
     
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryRegistry registry;
@@ -314,18 +314,18 @@ TEST(TransportV3CoverageFinal, ConnectToNotReadyNode) {
     // Create dummy shared memory
     int fd = shm_open("/librpc_node_dummy_not_ready", O_CREAT | O_RDWR, 0666);
     ASSERT_TRUE(fd != -1);
-    ftruncate(fd, 50 * 1024 * 1024);
-    void* ptr = mmap(nullptr, 50 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ftruncate(fd, 64 * 1024 * 1024);
+    void* ptr = mmap(nullptr, 64 * 1024 * 1024, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     ASSERT_TRUE(ptr != MAP_FAILED);
     
     MockNodeHeader* header = (MockNodeHeader*)ptr;
     new (header) MockNodeHeader();
     header->magic.store(0x4C524E33);
-    header->version.store(1);
+    header->version.store(4);
     header->ready.store(false); // Not ready
     header->owner_pid.store(getpid());
     
-    munmap(ptr, 50 * 1024 * 1024);
+    munmap(ptr, 64 * 1024 * 1024);
     close(fd);
     
     SharedMemoryRegistry registry;
@@ -1,10 +1,16 @@
 #include "simple_test.h"
 #include "nexus/transport/SharedMemoryTransportV3.h"
 #include "nexus/registry/GlobalRegistry.h"
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
 
 using namespace Nexus::rpc;
 
@@ -85,6 +91,173 @@ TEST(TransportV3Modes, SmartPollingMode) {
     ASSERT_EQ(stats.messages_received, 1);
 }
 
+TEST(TransportV3Modes, SmartPollingSpinThenBlock) {
+    TransportV3ModeCleanup cleanup;
+
+    SharedMemoryTransportV3::Config config;
+    config.notify_mechanism = SharedMemoryTransportV3::NotifyMechanism::SMART_POLLING;
+    config.spin_budget_us = 1000;
+    config.receive_cpu = 0;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("spin_recv", config));
+
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    receiver.startReceiving();
+
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("spin_send", config));
+
+    // Gaps longer than the spin budget force the receiver through the blocking
+    // fallback between messages; every message must still be delivered.
+    std::vector<uint8_t> data(32, 0);
+    const int count = 20;
+    for (int i = 0; i < count; ++i) {
+        data[0] = static_cast<uint8_t>(i);
+        ASSERT_TRUE(sender.send("spin_recv", data.data(), data.size()));
+        std::this_thread::sleep_for(std::chrono::milliseconds(i % 2 == 0 ? 0 : 5));
+    }
+
+    for (int i = 0; i < 100 && received.load() < count; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), count);
+}
+
+TEST(TransportV3Modes, DoorbellWakesIdleReceiver) {
+    TransportV3ModeCleanup cleanup;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("bell_recv"));
+
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    receiver.startReceiving();
+
+    SharedMemoryTransportV3 senders[4];
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(senders[i].initialize("bell_send_" + std::to_string(i)));
+    }
+
+    // Connect every sender up front so the timed rounds only measure the wakeup
+    std::vector<uint8_t> data(16, 0);
+    for (auto& sender : senders) {
+        ASSERT_TRUE(sender.send("bell_recv", data.data(), data.size()));
+    }
+    int expected = 4;
+    for (int i = 0; i < 100 && received.load() < expected; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), expected);
+
+    int fast_wakeups = 0;
+    for (int round = 0; round < 5; ++round) {
+        // Let the receiver go idle (long timeouts) so only the doorbell can wake it promptly
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(senders[round % 4].send("bell_recv", data.data(), data.size()));
+        expected++;
+        while (received.load() < expected &&
+               std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        ASSERT_EQ(received.load(), expected);
+        if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+            fast_wakeups++;
+        }
+    }
+    ASSERT_TRUE(fast_wakeups >= 4);
+
+    // All senders at once: every queue is announced through its own ready bit
+    for (int i = 0; i < 50; ++i) {
+        for (auto& sender : senders) {
+            ASSERT_TRUE(sender.send("bell_recv", data.data(), data.size()));
+        }
+    }
+    expected += 200;
+    for (int i = 0; i < 100 && received.load() < expected; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), expected);
+}
+
+static void runShardedReceive(SharedMemoryTransportV3::NotifyMechanism mechanism, const std::string& prefix) {
+    SharedMemoryTransportV3::Config config;
+    config.notify_mechanism = mechanism;
+    config.receive_threads = 3;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize(prefix + "_recv", config));
+
+    std::mutex mutex;
+    std::map<std::string, int> next_seq;
+    std::map<std::string, std::thread::id> owner;
+    std::atomic<int> received{0};
+    std::atomic<int> out_of_order{0};
+    std::atomic<int> thread_switches{0};
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string& from) {
+        int seq = 0;
+        memcpy(&seq, data + 8, sizeof(seq));
+        std::lock_guard<std::mutex> lock(mutex);
+        if (seq != next_seq[from]) {
+            out_of_order++;
+        }
+        next_seq[from] = seq + 1;
+        auto it = owner.find(from);
+        if (it == owner.end()) {
+            owner[from] = std::this_thread::get_id();
+        } else if (it->second != std::this_thread::get_id()) {
+            thread_switches++;
+        }
+        received++;
+        (void)size;
+    });
+    receiver.startReceiving();
+
+    const int kSenders = 4;
+    const int kMessages = 200;
+    SharedMemoryTransportV3 senders[kSenders];
+    for (int i = 0; i < kSenders; ++i) {
+        ASSERT_TRUE(senders[i].initialize(prefix + "_send_" + std::to_string(i), config));
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kSenders; ++i) {
+        threads.emplace_back([&, i]() {
+            std::vector<uint8_t> data(32, 0);
+            for (int seq = 0; seq < kMessages; ++seq) {
+                memcpy(data.data() + 8, &seq, sizeof(seq));
+                while (!senders[i].send(prefix + "_recv", data.data(), data.size())) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (int i = 0; i < 200 && received.load() < kSenders * kMessages; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), kSenders * kMessages);
+    ASSERT_EQ(out_of_order.load(), 0);
+    ASSERT_EQ(thread_switches.load(), 0);
+    ASSERT_EQ(owner.size(), static_cast<size_t>(kSenders));
+}
+
+TEST(TransportV3Modes, ShardedReceiveThreads) {
+    TransportV3ModeCleanup cleanup;
+    runShardedReceive(SharedMemoryTransportV3::NotifyMechanism::CONDITION_VARIABLE, "shard_cv");
+}
+
+TEST(TransportV3Modes, ShardedReceiveThreadsSemaphore) {
+    TransportV3ModeCleanup cleanup;
+    runShardedReceive(SharedMemoryTransportV3::NotifyMechanism::SEMAPHORE, "shard_sem");
+}
+
 TEST(TransportV3Modes, ModeSwitching) {
     TransportV3ModeCleanup cleanup;
     
@@ -105,3 +278,201 @@ TEST(TransportV3Modes, ModeSwitching) {
         ASSERT_TRUE(transport.initialize("switch_node", config));
     }
 }
+
+static void runSharedInbox(SharedMemoryTransportV3::NotifyMechanism mechanism, const std::string& prefix,
+                           uint32_t promote_rate, int senders_count, int messages, int expected_queues) {
+    SharedMemoryTransportV3::Config config;
+    config.notify_mechanism = mechanism;
+    config.max_inbound_queues = 2;
+    config.shared_inbox = true;
+    config.inbox_promote_rate = promote_rate;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize(prefix + "_recv", config));
+
+    std::mutex mutex;
+    std::map<std::string, int> next_seq;
+    std::atomic<int> received{0};
+    std::atomic<int> out_of_order{0};
+    receiver.setReceiveCallback([&](const uint8_t* data, size_t size, const std::string& from) {
+        int seq = 0;
+        memcpy(&seq, data + 8, sizeof(seq));
+        std::lock_guard<std::mutex> lock(mutex);
+        if (seq != next_seq[from]) {
+            out_of_order++;
+        }
+        next_seq[from] = seq + 1;
+        received++;
+        (void)size;
+    });
+    receiver.startReceiving();
+
+    std::vector<std::unique_ptr<SharedMemoryTransportV3>> senders;
+    for (int i = 0; i < senders_count; ++i) {
+        senders.emplace_back(new SharedMemoryTransportV3());
+        ASSERT_TRUE(senders.back()->initialize(prefix + "_send_" + std::to_string(i), config));
+    }
+
+    std::vector<uint8_t> data(32, 0);
+    for (int seq = 0; seq < messages; ++seq) {
+        memcpy(data.data() + 8, &seq, sizeof(seq));
+        for (auto& sender : senders) {
+            while (!sender->send(prefix + "_recv", data.data(), data.size())) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    for (int i = 0; i < 200 && received.load() < senders_count * messages; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), senders_count * messages);
+    ASSERT_EQ(out_of_order.load(), 0);
+    ASSERT_EQ(receiver.getStats().inbox_depth, 0u);
+    ASSERT_EQ(receiver.getStats().inbound_queues, expected_queues);
+}
+
+TEST(TransportV3Modes, SharedInboxLiftsSenderLimit) {
+    TransportV3ModeCleanup cleanup;
+    // 6 senders against a receiver with only 2 queues: everyone stays on the inbox
+    runSharedInbox(SharedMemoryTransportV3::NotifyMechanism::CONDITION_VARIABLE, "inbox_cv", 1000000, 6, 100, 0);
+}
+
+TEST(TransportV3Modes, SharedInboxSemaphore) {
+    TransportV3ModeCleanup cleanup;
+    runSharedInbox(SharedMemoryTransportV3::NotifyMechanism::SEMAPHORE, "inbox_sem", 1000000, 6, 100, 0);
+}
+
+TEST(TransportV3Modes, SharedInboxPromotesHotSender) {
+    TransportV3ModeCleanup cleanup;
+    // Low promotion threshold: senders move to dedicated queues mid-stream without reordering,
+    // and senders beyond max_inbound_queues keep using the inbox
+    runSharedInbox(SharedMemoryTransportV3::NotifyMechanism::CONDITION_VARIABLE, "inbox_promote", 10, 3, 500, 2);
+}
+
+TEST(TransportV3Modes, NumaBoundSegment) {
+    TransportV3ModeCleanup cleanup;
+    SharedMemoryTransportV3::Config config;
+    config.numa_node = 0;  // Best effort: mbind / affinity may be refused in containers
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("numa_recv", config));
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    receiver.startReceiving();
+
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("numa_send", SharedMemoryTransportV3::Config()));
+    std::vector<uint8_t> data = {7, 8, 9};
+    ASSERT_TRUE(sender.send("numa_recv", data.data(), data.size()));
+    for (int i = 0; i < 50 && received.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), 1);
+
+    int node = receiver.getStats().numa_node;
+    ASSERT_TRUE(node == 0 || node == -1);
+}
+
+TEST(TransportV3Modes, SegmentSizedByMaxQueues) {
+    SharedMemoryTransportV3::Config small_config;
+    small_config.max_inbound_queues = 2;
+
+    SharedMemoryTransportV3 small;
+    ASSERT_TRUE(small.initialize("sized_small", small_config));
+    std::atomic<int> received{0};
+    small.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+    small.startReceiving();
+
+    SharedMemoryTransportV3 full;
+    ASSERT_TRUE(full.initialize("sized_full", SharedMemoryTransportV3::Config()));
+
+    // Only the configured queues are mapped
+    size_t small_mapped = small.getSegmentUsage().usage.mapped;
+    size_t full_mapped = full.getSegmentUsage().usage.mapped;
+    ASSERT_GT(small_mapped, 0u);
+    ASSERT_LT(small_mapped * 4, full_mapped);
+
+    // A sender maps the receiver's actual size and still gets a queue
+    std::vector<uint8_t> data = {1, 2, 3};
+    ASSERT_TRUE(full.send("sized_small", data.data(), data.size()));
+    for (int i = 0; i < 50 && received.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(received.load(), 1);
+
+    auto peers = full.getPeerSegmentUsage();
+    ASSERT_EQ(peers.size(), 1u);
+    ASSERT_EQ(peers[0].usage.mapped, small_mapped);
+}
+
+TEST(TransportV3Modes, BulkLaneRunsAtHalfCapacity) {
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("bulk_cap_recv", SharedMemoryTransportV3::Config()));
+    receiver.setReceiveCallback([](const uint8_t*, size_t, const std::string&) {});
+    receiver.startReceiving();
+
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("bulk_cap_send", SharedMemoryTransportV3::Config()));
+    std::vector<uint8_t> data = {4, 5, 6};
+    ASSERT_TRUE(sender.send("bulk_cap_recv", data.data(), data.size()));
+
+    auto fill = sender.getOutboundFill();
+    ASSERT_EQ(fill.size(), static_cast<size_t>(SharedMemoryTransportV3::DATA_LANES));
+    size_t full_capacity = SharedMemoryTransportV3::DATA_QUEUE_SIZE_BYTES;
+    size_t bulk_capacity = std::max(full_capacity / SharedMemoryTransportV3::BULK_LANE_CAPACITY_DIVISOR,
+                                    SharedMemoryTransportV3::MIN_DATA_QUEUE_SIZE_BYTES);
+    for (const auto& lane : fill) {
+        size_t expected = lane.lane == SharedMemoryTransportV3::BULK_DATA_LANE ? bulk_capacity : full_capacity;
+        ASSERT_EQ(lane.capacity, expected);
+    }
+    ASSERT_LT(bulk_capacity, full_capacity);
+}
+
+TEST(TransportV3Modes, SharedInboxFullBlocksSender) {
+    TransportV3ModeCleanup cleanup;
+    SharedMemoryTransportV3::Config config;
+    config.shared_inbox = true;
+    config.inbox_promote_rate = 1000000;
+    config.send_timeout_ms = 2000;
+
+    SharedMemoryTransportV3 receiver;
+    ASSERT_TRUE(receiver.initialize("inbox_full_recv", config));
+    std::atomic<int> received{0};
+    receiver.setReceiveCallback([&](const uint8_t*, size_t, const std::string&) { received++; });
+
+    SharedMemoryTransportV3 sender;
+    ASSERT_TRUE(sender.initialize("inbox_full_send", config));
+    std::vector<uint8_t> data(32, 0);
+    const int slots = static_cast<int>(SharedMemoryTransportV3::SHARED_INBOX_SLOTS);
+    for (int i = 0; i < slots; ++i) {
+        ASSERT_TRUE(sender.send("inbox_full_recv", data.data(), data.size()));
+    }
+    ASSERT_TRUE(sender.getOutboundFill().empty());
+
+    // BLOCK lane: the next frame waits for the receiver instead of being dropped
+    std::thread starter([&receiver]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        receiver.startReceiving();
+    });
+    ASSERT_TRUE(sender.send("inbox_full_recv", data.data(), data.size()));
+    starter.join();
+    for (int i = 0; i < 100 && received.load() < slots + 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(received.load(), slots + 1);
+    ASSERT_EQ(receiver.getStats().inbound_queues, 0);
+
+    // DROP lane: a full inbox fails at once
+    SharedMemoryTransportV3::Config drop_config = config;
+    drop_config.lane_overflow[SharedMemoryTransportV3::DEFAULT_DATA_LANE] =
+        SharedMemoryTransportV3::LaneOverflow::DROP;
+    SharedMemoryTransportV3 dropper;
+    ASSERT_TRUE(dropper.initialize("inbox_full_drop", drop_config));
+    receiver.stopReceiving();
+    int sent = 0;
+    while (sent <= slots && dropper.send("inbox_full_recv", data.data(), data.size())) {
+        sent++;
+    }
+    ASSERT_EQ(sent, slots);
+}
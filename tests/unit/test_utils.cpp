@@ -1,5 +1,29 @@
 #include "simple_test.h"
+#include "nexus/core/Message.h"
+#include "nexus/utils/Crc32c.h"
+#include "nexus/utils/EpochSnapshot.h"
 #include "nexus/utils/Logger.h"
+#include "nexus/utils/Lz4.h"
+#include "nexus/utils/MaintenanceScheduler.h"
+#include "nexus/utils/MessagePool.h"
+#include "nexus/utils/MetricsSegment.h"
+#include "nexus/utils/RecordLog.h"
+#include "nexus/utils/StringView.h"
+#include "nexus/utils/ThreadPlacement.h"
+#include "nexus/utils/TopicTrie.h"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace Nexus;
 using namespace Nexus::rpc;
@@ -20,3 +44,551 @@ TEST(LoggerTest, Logging) {
     NEXUS_LOG_INFO("Test", "Test info message");
     NEXUS_LOG_ERROR("Test", "Test error message");
 }
+
+TEST(MessagePoolTest, SlotsAreReused) {
+    MessagePool pool(128);
+    ASSERT_EQ(0u, pool.allocatedSlots());
+
+    auto a = pool.acquire(100);
+    ASSERT_TRUE(a.slot);
+    ASSERT_EQ(2048u, a.capacity);
+    ASSERT_EQ(64u, pool.allocatedSlots());  // One chunk
+
+    // Released slot comes back from the free list; no further chunks
+    std::set<uint8_t*> seen;
+    pool.release(a);
+    for (int i = 0; i < 1000; ++i) {
+        auto b = pool.acquire(2048);
+        ASSERT_TRUE(b.slot);
+        seen.insert(b.data);
+        pool.release(b);
+    }
+    ASSERT_EQ(64u, pool.allocatedSlots());
+    ASSERT_LT(seen.size(), 65u);
+}
+
+TEST(MessagePoolTest, OverflowAndExhaustion) {
+    MessagePool pool(64);
+
+    // Large payloads: power-of-two overflow buffers, reused once released
+    auto big = pool.acquire(5000);
+    ASSERT_FALSE(big.slot);
+    ASSERT_EQ(8192u, big.capacity);
+    uint8_t* big_data = big.data;
+    pool.release(big);
+    auto again = pool.acquire(6000);
+    ASSERT_TRUE(again.data == big_data);
+    pool.release(again);
+
+    // Exhaust the fixed slots: further small payloads fall back to the heap
+    std::vector<MessagePool::Buffer> held;
+    for (int i = 0; i < 64; ++i) {
+        held.push_back(pool.acquire(10));
+        ASSERT_TRUE(held.back().slot);
+    }
+    auto spill = pool.acquire(10);
+    ASSERT_FALSE(spill.slot);
+    ASSERT_TRUE(spill.capacity >= 10u);
+    held.push_back(spill);
+
+    for (const auto& buffer : held) {
+        pool.release(buffer);
+    }
+    ASSERT_EQ(64u, pool.allocatedSlots());
+}
+
+TEST(MessagePoolTest, SharedPayloadReferences) {
+    MessagePool pool(64);
+    std::vector<uint8_t> bytes(1500, 0x3c);
+
+    // One copy, shared: the buffer goes back to the pool with the last reference only
+    SharedPayload payload = SharedPayload::create(pool, bytes.data(), bytes.size());
+    ASSERT_EQ(bytes.size(), payload.size());
+    ASSERT_EQ(0, std::memcmp(bytes.data(), payload.data(), bytes.size()));
+    ASSERT_EQ(64u, pool.allocatedSlots());  // Header and bytes fit a fixed slot
+
+    std::vector<SharedPayload> deliveries;
+    for (int i = 0; i < 8; ++i) {
+        payload.retain();
+        deliveries.push_back(payload);
+    }
+    ASSERT_EQ(9u, payload.references());
+    payload.release();
+    ASSERT_FALSE(payload);
+    const uint8_t* data = deliveries[0].data();
+    for (size_t i = 0; i + 1 < deliveries.size(); ++i) {
+        deliveries[i].release();
+    }
+    ASSERT_EQ(1u, deliveries.back().references());
+    ASSERT_TRUE(deliveries.back().data() == data);
+    deliveries.back().release();
+    ASSERT_FALSE(deliveries.back());
+
+    // Past a slot (header included): overflow buffer
+    SharedPayload large = SharedPayload::create(pool, bytes.data(), MessagePool::SLOT_SIZE);
+    ASSERT_EQ(size_t(MessagePool::SLOT_SIZE), large.size());
+    large.release();
+    ASSERT_EQ(64u, pool.allocatedSlots());
+}
+
+namespace {
+struct CountedPair {
+    explicit CountedPair(int v) : a(v), b(v) { live++; }
+    ~CountedPair() { live--; }
+    int a;
+    int b;
+    static std::atomic<int> live;
+};
+std::atomic<int> CountedPair::live{0};
+}  // namespace
+
+TEST(EpochSnapshotTest, ReadersSeeWholeSnapshots) {
+    {
+        EpochSnapshot<CountedPair> cell;
+        {
+            EpochSnapshot<CountedPair>::Reader reader(cell);
+            ASSERT_TRUE(reader.get() == nullptr);
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> torn{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                while (!stop) {
+                    EpochSnapshot<CountedPair>::Reader reader(cell);
+                    const CountedPair* pair = reader.get();
+                    if (pair && pair->a != pair->b) {
+                        torn++;
+                    }
+                }
+            });
+        }
+
+        // Each publish frees the previous snapshot once no reader can see it
+        for (int i = 0; i < 2000; ++i) {
+            cell.publish(std::unique_ptr<const CountedPair>(new CountedPair(i)));
+            ASSERT_EQ(1, CountedPair::live.load());
+        }
+        stop = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+        ASSERT_EQ(0, torn.load());
+
+        EpochSnapshot<CountedPair>::Reader reader(cell);
+        ASSERT_EQ(1999, reader.get()->a);
+    }
+    ASSERT_EQ(0, CountedPair::live.load());
+}
+
+TEST(StringViewTest, CompareAndLookup) {
+    const char field[8] = {'n', 'o', 'd', 'e', 'A', 'B', 'C', 'D'};  // No terminator
+    ASSERT_EQ(8u, StringView::fromField(field, sizeof(field)).size());
+    ASSERT_TRUE(StringView::fromField("node\0junk", 9) == "node");
+
+    StringView view("topic_x", 5);
+    ASSERT_TRUE(view == std::string("topic"));
+    ASSERT_TRUE(view != "topics");
+    ASSERT_TRUE(StringView("abc") < StringView("abd"));
+    ASSERT_TRUE(StringView("ab") < StringView("abc"));
+    ASSERT_EQ(std::string("topic"), view.str());
+
+    // Transparent comparator: find by view without building a std::string
+    std::map<std::string, int, std::less<>> table = {{"imu", 1}, {"topic", 2}};
+    ASSERT_TRUE(table.find(view) != table.end());
+    ASSERT_EQ(2, table.find(view)->second);
+    ASSERT_TRUE(table.find(StringView("lidar")) == table.end());
+}
+
+TEST(TopicTrieTest, WildcardMatching) {
+    TopicTrie<int> trie;
+    ASSERT_TRUE(trie.insert("sensors/*", 1));
+    ASSERT_TRUE(trie.insert("sensors/imu", 2));
+    ASSERT_TRUE(trie.insert("camera/front/#", 3));
+    ASSERT_TRUE(trie.insert("*/status/*", 4));
+    ASSERT_FALSE(trie.insert("camera/#/raw", 5));  // '#' must be last
+
+    ASSERT_EQ(1, *trie.match("sensors/lidar"));
+    ASSERT_EQ(2, *trie.match("sensors/imu"));  // Literal wins over '*'
+    ASSERT_TRUE(trie.match("sensors") == nullptr);
+    ASSERT_TRUE(trie.match("sensors/lidar/raw") == nullptr);
+    ASSERT_EQ(3, *trie.match("camera/front"));  // '#' matches zero segments
+    ASSERT_EQ(3, *trie.match("camera/front/left/raw"));
+    ASSERT_TRUE(trie.match("camera/rear/raw") == nullptr);
+    ASSERT_EQ(4, *trie.match("arm/status/joint"));
+    ASSERT_TRUE(trie.match(StringView("sensors/imu_x", 11)) != nullptr);  // Views need no terminator
+
+    ASSERT_TRUE(isTopicPattern("a/*/b"));
+    ASSERT_TRUE(isTopicPattern("#"));
+    ASSERT_FALSE(isTopicPattern("a*/b#"));
+    ASSERT_TRUE(topicMatches("a/*/c", "a/b/c"));
+    ASSERT_TRUE(topicMatches("a/#", "a/b/c"));
+    ASSERT_TRUE(topicMatches("a/b", "a/b"));
+    ASSERT_FALSE(topicMatches("a/*", "a/b/c"));
+    ASSERT_FALSE(topicMatches("a/b", "a/b/c"));
+}
+
+TEST(Crc32cTest, KnownValues) {
+    const char check[] = "123456789";
+    ASSERT_EQ(0xE3069283u, crc32c(0, check, 9));
+    ASSERT_EQ(0u, crc32c(0, nullptr, 0));
+
+    // Incremental == one shot, across unaligned splits
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    const uint32_t whole = crc32c(0, data.data(), data.size());
+    ASSERT_EQ(whole, crc32c(crc32c(0, data.data(), 13), data.data() + 13, data.size() - 13));
+
+    // Fused copy gives the same CRC (across chunk boundaries)
+    std::vector<uint8_t> large(10000);
+    for (size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<uint8_t>(i * 131 + 17);
+    }
+    std::vector<uint8_t> copy(large.size());
+    ASSERT_EQ(crc32c(0, large.data(), large.size()), crc32cCopy(0, copy.data(), large.data(), large.size()));
+    ASSERT_TRUE(copy == large);
+
+    // IEEE CRC32 (zlib), slicing-by-8 and the byte tail
+    ASSERT_EQ(0xCBF43926u, crc32(0, check, 9));
+    ASSERT_EQ(crc32(0, data.data(), data.size()), crc32(crc32(0, data.data(), 13), data.data() + 13, data.size() - 13));
+}
+
+TEST(Lz4Test, RoundTrip) {
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += "{\"sensor\":\"imu\",\"seq\":" + std::to_string(i) + ",\"status\":\"ok\"}";
+    }
+    std::vector<uint8_t> block(text.size());
+    const size_t block_size = lz4Compress(text.data(), text.size(), block.data(), block.size());
+    ASSERT_TRUE(block_size > 0 && block_size < text.size() / 4);
+
+    std::vector<uint8_t> out(text.size());
+    ASSERT_EQ(text.size(), lz4Decompress(block.data(), block_size, out.data(), out.size()));
+    ASSERT_EQ(0, std::memcmp(text.data(), out.data(), text.size()));
+
+    // Overlapping match (offset 1) and inputs too short to hold a match
+    const std::string run(1000, 'a');
+    ASSERT_TRUE(lz4Compress(run.data(), run.size(), block.data(), block.size()) < 20);
+    for (size_t size = 0; size < 16; ++size) {
+        const size_t short_size = lz4Compress(run.data(), size, block.data(), block.size());
+        ASSERT_EQ(size, lz4Decompress(block.data(), short_size, out.data(), out.size()));
+    }
+
+    // Incompressible data does not fit in less than its own size
+    std::vector<uint8_t> noise(4096);
+    uint32_t state = 12345;
+    for (auto& byte : noise) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    ASSERT_EQ(0u, lz4Compress(noise.data(), noise.size(), block.data(), noise.size() - 1));
+
+    // Truncated or corrupted blocks are rejected, never overrun the output
+    ASSERT_EQ(SIZE_MAX, lz4Decompress(block.data(), block_size - 1, out.data(), out.size()));
+    ASSERT_EQ(SIZE_MAX, lz4Decompress(block.data(), block_size, out.data(), text.size() - 1));
+    const uint8_t bad_offset[] = {0x10, 'x', 0x05, 0x00};  // Offset 5 with 1 byte of history
+    ASSERT_EQ(SIZE_MAX, lz4Decompress(bad_offset, sizeof(bad_offset), out.data(), out.size()));
+}
+
+TEST(MessagePacketTest, ChecksumModes) {
+    const std::string payload = "payload";
+
+    // SUM keeps the legacy version 1 header
+    auto legacy = MessageBuilder::build("node", "g", "t", payload);
+    auto* packet = reinterpret_cast<MessagePacket*>(legacy.data());
+    ASSERT_EQ(MessagePacket::VERSION, packet->version);
+    ASSERT_EQ(0, packet->checksum_type);
+    ASSERT_TRUE(packet->isValid());
+
+    // CRC32C: version 2, detects payload corruption
+    auto crc = MessageBuilder::build("node", "g", "t", payload, 0, MessageType::DATA, ChecksumType::CRC32C);
+    packet = reinterpret_cast<MessagePacket*>(crc.data());
+    ASSERT_EQ(MessagePacket::VERSION_CHECKSUM, packet->version);
+    ASSERT_TRUE(packet->isValid());
+    packet->getPayload()[0] ^= 0x01;
+    ASSERT_FALSE(packet->isValid());
+
+    // NONE: only accepted where the caller trusts the link
+    auto unchecked = MessageBuilder::build("node", "g", "t", payload, 0, MessageType::DATA, ChecksumType::NONE);
+    packet = reinterpret_cast<MessagePacket*>(unchecked.data());
+    ASSERT_FALSE(packet->isValid());
+    ASSERT_TRUE(packet->isValid(true));
+
+    // Unknown mode, or a mode in a version 1 header
+    packet->checksum_type = 9;
+    ASSERT_FALSE(packet->isValid(true));
+    packet = reinterpret_cast<MessagePacket*>(legacy.data());
+    packet->checksum_type = static_cast<uint8_t>(ChecksumType::CRC32C);
+    packet->checksum = packet->calculateChecksum();
+    ASSERT_FALSE(packet->isValid());
+}
+
+TEST(MessagePacketTest, BuildView) {
+    auto owned = MessageBuilder::build("node", "group", "topic", "payload", 1234, MessageType::DATA);
+    PacketView view = MessageBuilder::buildView("node", "group", "topic", "payload", 1234, MessageType::DATA);
+    ASSERT_EQ(owned.size(), view.size());
+    ASSERT_EQ(0, std::memcmp(owned.data(), view.data(), view.size()));
+    ASSERT_TRUE(reinterpret_cast<const MessagePacket*>(view.data())->isValid());
+
+    // Same thread: the buffer is reused, not reallocated, for packets that fit
+    PacketView heartbeat = MessageBuilder::buildView("node", "", "", nullptr, 0, 0, MessageType::HEARTBEAT);
+    ASSERT_TRUE(heartbeat.data() == view.data());
+    ASSERT_EQ(MessagePacket::packetSize(0, 0, 0), heartbeat.size());
+}
+
+TEST(MessagePacketTest, CompactHeader) {
+    const std::string payload = "sample";
+    std::vector<uint8_t> frame(CompactPacket::packetSize(payload.size()));
+    ASSERT_EQ(24u, sizeof(CompactPacket));
+
+    const uint32_t hash = CompactPacket::topicHash("g", "t");
+    ASSERT_NE(hash, CompactPacket::topicHash("gt", ""));  // Separator keeps the pair unambiguous
+
+    CompactPacket* packet =
+        MessageBuilder::buildCompactHeader(frame.data(), 7, hash, payload.size(), ChecksumType::CRC32C);
+    std::memcpy(packet->getPayload(), payload.data(), payload.size());
+    packet->checksum = packet->calculateChecksum();
+    ASSERT_TRUE(CompactPacket::isCompact(frame.data()));
+    ASSERT_TRUE(packet->isValid(frame.size()));
+    ASSERT_EQ(7u, packet->topic_id);
+
+    // Truncated frame or corrupted payload
+    ASSERT_FALSE(packet->isValid(frame.size() - 1));
+    packet->getPayload()[0] ^= 0x01;
+    ASSERT_FALSE(packet->isValid(frame.size()));
+
+    // NONE: trusted links only
+    packet->checksum_type = static_cast<uint8_t>(ChecksumType::NONE);
+    packet->checksum = packet->calculateChecksum();
+    ASSERT_FALSE(packet->isValid(frame.size()));
+    ASSERT_TRUE(packet->isValid(frame.size(), true));
+
+    // Full headers are not mistaken for compact ones
+    auto full = MessageBuilder::build("node", "g", "t", payload);
+    ASSERT_FALSE(CompactPacket::isCompact(full.data()));
+}
+
+TEST(MaintenanceSchedulerTest, ScheduleRunSoonCancel) {
+    auto& scheduler = MaintenanceScheduler::instance();
+    const size_t tasks_before = scheduler.taskCount();
+    auto waitFor = [](const std::atomic<int>& counter, int target) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (counter.load() < target && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return counter.load() >= target;
+    };
+
+    // Periodic task, first run right away
+    std::atomic<int> fast{0};
+    auto fast_id =
+        scheduler.schedule(std::chrono::milliseconds(5), [&fast]() { fast++; }, std::chrono::milliseconds(0));
+    ASSERT_NE(MaintenanceScheduler::NO_TASK, fast_id);
+
+    // Long interval: only runs when brought forward
+    std::atomic<int> slow{0};
+    auto slow_id = scheduler.schedule(std::chrono::hours(1), [&slow]() { slow++; });
+    ASSERT_EQ(tasks_before + 2, scheduler.taskCount());
+    ASSERT_TRUE(waitFor(fast, 3));
+    ASSERT_EQ(0, slow.load());
+    scheduler.runSoon(slow_id);
+    ASSERT_TRUE(waitFor(slow, 1));
+
+    // A throwing task is logged and stays scheduled
+    std::atomic<int> throwing{0};
+    auto throwing_id = scheduler.schedule(
+        std::chrono::milliseconds(5), [&throwing]() {
+            throwing++;
+            throw std::runtime_error("maintenance failure");
+        },
+        std::chrono::milliseconds(0));
+    ASSERT_TRUE(waitFor(throwing, 2));
+
+    // Cancelled tasks never run again
+    scheduler.cancel(fast_id);
+    scheduler.cancel(slow_id);
+    scheduler.cancel(throwing_id);
+    scheduler.cancel(MaintenanceScheduler::NO_TASK);
+    ASSERT_EQ(tasks_before, scheduler.taskCount());
+    const int fast_after_cancel = fast.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ASSERT_EQ(fast_after_cancel, fast.load());
+    ASSERT_EQ(1, slow.load());
+}
+
+TEST(MetricsSegmentTest, CreateReadRemove) {
+    const std::string name = MetricsSegment::segmentName("metrics/unit");
+    ASSERT_EQ(std::string("/librpc_metrics_metrics_unit"), name);
+
+    MetricsSnapshot snapshot;
+    {
+        MetricsSegment segment;
+        ASSERT_TRUE(segment.create("metrics/unit", 250));
+        MetricsLayout& layout = *segment.layout();
+        segment.beginUpdate();
+        layout.node[MetricsLayout::SHM_SENT].store(42);
+        std::strcpy(layout.topics[0].name, "group/topic");
+        layout.topics[0].values[MetricsLayout::TOPIC_DELIVERED].store(7);
+        layout.topic_count.store(1);
+        segment.endUpdate();
+
+        std::vector<std::string> names = MetricsSegment::list();
+        ASSERT_TRUE(std::find(names.begin(), names.end(), name) != names.end());
+
+        ASSERT_TRUE(MetricsSegment::read(name, snapshot));
+        ASSERT_EQ(std::string("metrics/unit"), snapshot.node_id);
+        ASSERT_EQ(getpid(), snapshot.pid);
+        ASSERT_TRUE(snapshot.alive);
+        ASSERT_EQ(250u, snapshot.interval_ms);
+        ASSERT_EQ(42u, snapshot.node[MetricsLayout::SHM_SENT]);
+        ASSERT_EQ(1u, snapshot.topics.size());
+        ASSERT_EQ(std::string("group/topic"), snapshot.topics[0].name);
+        ASSERT_EQ(7u, snapshot.topics[0].values[MetricsLayout::TOPIC_DELIVERED]);
+
+        // Segments of live processes are kept
+        MetricsSegment::removeOrphaned();
+        ASSERT_TRUE(MetricsSegment::read(name, snapshot));
+    }
+    // Unlinked with its owner
+    ASSERT_FALSE(MetricsSegment::read(name, snapshot));
+}
+
+TEST(ThreadPlacementTest, PinAndSchedule) {
+    ThreadPlacement placement;
+    ASSERT_TRUE(parseThreadPlacement("other@1-2", placement));
+    ASSERT_TRUE(placement.policy == SchedPolicy::OTHER);
+    ASSERT_EQ(placement.cpu_mask, 0x6u);
+    ASSERT_FALSE(parseThreadPlacement("deadline:1", placement));
+    ASSERT_EQ(placement.cpu_mask, 0x6u);  // Unchanged
+
+    // Pin a thread to the first CPU this process may use
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int first_cpu = 0;
+    while (first_cpu < 63 && !CPU_ISSET(first_cpu, &allowed)) {
+        ++first_cpu;
+    }
+    placement.cpu_mask = uint64_t(1) << first_cpu;
+
+    bool applied = false;
+    int cpus = 0;
+    bool on_first_cpu = false;
+    int policy = -1;
+    std::thread thread([&]() {
+        applied = applyThreadPlacement(placement, "test");
+        cpu_set_t now;
+        CPU_ZERO(&now);
+        sched_getaffinity(0, sizeof(now), &now);
+        cpus = CPU_COUNT(&now);
+        on_first_cpu = CPU_ISSET(first_cpu, &now);
+        policy = sched_getscheduler(0);
+    });
+    thread.join();
+    ASSERT_TRUE(applied);
+    ASSERT_EQ(cpus, 1);
+    ASSERT_TRUE(on_first_cpu);
+    ASSERT_EQ(policy, SCHED_OTHER);
+}
+
+TEST(RecordLogTest, WriteRollSeekAndRecover) {
+    const std::string base = "/tmp/nexus_record_test_" + std::to_string(getpid());
+    RecordWriter::Options options;
+    options.segment_size = 64 * 1024;
+    options.index_interval_ns = 0;  // Index every frame
+
+    RecordWriter writer;
+    ASSERT_TRUE(writer.open(base, options));
+    RecordStream pose;
+    pose.name = "robot";
+    pose.topic = "pose";
+    RecordStream camera;
+    camera.kind = RecordLayout::STREAM_LARGE_DATA;
+    camera.name = "camera_channel";
+    camera.topic = "frame";
+    const uint32_t pose_id = writer.addStream(pose);
+    const uint32_t camera_id = writer.addStream(camera);
+    ASSERT_EQ(pose_id, writer.addStream(pose));  // Interned once
+    ASSERT_NE(pose_id, camera_id);
+
+    // 40 frames of 4KB: several 64KB segments
+    std::vector<uint8_t> block(4096);
+    for (uint32_t i = 0; i < 40; ++i) {
+        std::memcpy(block.data(), &i, sizeof(i));
+        ASSERT_TRUE(writer.append(i % 2 == 0 ? pose_id : camera_id, block.data(), block.size()));
+    }
+    std::vector<uint8_t> too_big(options.segment_size);
+    ASSERT_FALSE(writer.append(pose_id, too_big.data(), too_big.size()));
+    writer.close();
+    RecordWriter::Stats stats = writer.getStats();
+    ASSERT_EQ(40u, stats.frames);
+    ASSERT_EQ(1u, stats.dropped);
+    ASSERT_GT(stats.segments, 2u);
+
+    // Every segment knows both streams; frames come back in order with their payload
+    const std::vector<std::string> segments = RecordReader::segments(base);
+    ASSERT_EQ(stats.segments, segments.size());
+    RecordReader reader;
+    uint32_t expected = 0;
+    uint64_t seek_time = 0;
+    uint64_t last_time = 0;
+    bool in_order = true;
+    for (const auto& path : segments) {
+        ASSERT_TRUE(reader.open(path));
+        ASSERT_TRUE(reader.closedCleanly());
+        ASSERT_EQ(2u, reader.streams().size());
+        ASSERT_TRUE(reader.streams()[camera_id].kind == RecordLayout::STREAM_LARGE_DATA);
+        ASSERT_EQ(std::string("camera_channel"), reader.streams()[camera_id].name);
+        RecordReader::Frame frame;
+        while (reader.next(frame)) {
+            uint32_t value = 0;
+            std::memcpy(&value, frame.data, sizeof(value));
+            in_order = in_order && value == expected && frame.size == block.size() && frame.time_ns >= last_time &&
+                       frame.stream == (value % 2 == 0 ? pose_id : camera_id);
+            last_time = frame.time_ns;
+            if (expected == 5) {
+                seek_time = frame.time_ns;
+            }
+            ++expected;
+        }
+    }
+    ASSERT_TRUE(in_order);
+    ASSERT_EQ(40u, expected);
+
+    // Seek (in the first segment, which holds frame 5) starts at the first frame at that time
+    ASSERT_TRUE(reader.open(segments[0]));
+    reader.seek(seek_time);
+    RecordReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_TRUE(frame.time_ns >= seek_time);
+    uint32_t value = 0;
+    std::memcpy(&value, frame.data, sizeof(value));
+    ASSERT_LT(value, 6u);
+    reader.close();
+
+    // A segment still being written (as after a crash) is read by scanning it
+    ASSERT_TRUE(writer.open(base + "_open", options));
+    const uint32_t id = writer.addStream(pose);
+    ASSERT_TRUE(writer.append(id, block.data(), 100));
+    ASSERT_TRUE(writer.append(id, block.data(), 200));
+    RecordReader live;
+    ASSERT_TRUE(live.open(RecordLayout::segmentPath(base + "_open", 0)));
+    ASSERT_FALSE(live.closedCleanly());
+    ASSERT_EQ(1u, live.streams().size());
+    ASSERT_EQ(2u, live.index().size());
+    ASSERT_TRUE(live.next(frame));
+    ASSERT_EQ(100u, frame.size);
+    ASSERT_TRUE(live.next(frame));
+    ASSERT_EQ(200u, frame.size);
+    ASSERT_FALSE(live.next(frame));
+    live.close();
+    writer.close();
+
+    for (const auto& path : segments) {
+        unlink(path.c_str());
+    }
+    unlink(RecordLayout::segmentPath(base + "_open", 0).c_str());
+}
@@ -0,0 +1,254 @@
+/**
+ * @file nexus_record.cpp
+ * @brief Record topics and large data channels to disk, replay them, or list a recording
+ *
+ * Recording subscribes a dedicated node to the given topics (inline, straight
+ * from the receive rings) and large data channels, and appends every message
+ * and block to memory-mapped segment files "<base>.<index>.nxrec" (see
+ * RecordLog.h). Replay republishes them through a node with the original
+ * timing, scaled by --speed, or as fast as possible with --fast.
+ *
+ * Usage:
+ *   nexus_record record BASE [--topics GROUP:TOPIC[,TOPIC...]]... [--large CHANNEL]...
+ *                            [--duration SEC] [--segment-mb MB]
+ *   nexus_record replay BASE [--speed FACTOR | --fast] [--start SEC]
+ *   nexus_record info BASE
+ */
+
+#include <signal.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexus/core/Node.h"
+#include "nexus/core/Recorder.h"
+#include "nexus/utils/RecordLog.h"
+
+using namespace Nexus::rpc;
+
+namespace {
+
+std::atomic<bool> g_interrupted{false};
+
+void onSignal(int) {
+    g_interrupted.store(true);
+}
+
+struct RecordOptions {
+    std::map<std::string, std::vector<std::string>> topics;  // Group -> topics
+    std::vector<std::string> channels;
+    double duration_s = 0;  // 0: until interrupted
+    size_t segment_mb = 1024;
+    double speed = 1.0;  // Replay; 0: as fast as possible
+    double start_s = 0;
+};
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " record BASE [options]   Record until Ctrl-C (or --duration)\n"
+              << "       " << program << " replay BASE [options]   Republish a recording\n"
+              << "       " << program << " info BASE               Streams, frames and duration of a recording\n"
+              << "Record options:\n"
+              << "  --topics GROUP:TOPIC[,TOPIC...]   Topics to record (wildcards allowed; repeatable)\n"
+              << "  --large CHANNEL                   Large data channel to record (repeatable)\n"
+              << "  --duration SEC                    Stop after SEC seconds\n"
+              << "  --segment-mb MB                   Size of each segment file (default: 1024)\n"
+              << "Replay options:\n"
+              << "  --speed FACTOR                    Relative to the recorded timing (default: 1)\n"
+              << "  --fast                            No waits between frames\n"
+              << "  --start SEC                       Skip the first SEC seconds\n";
+}
+
+bool parseOptions(int argc, char* argv[], RecordOptions& options) {
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--fast") {
+            options.speed = 0;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--topics") {
+            const size_t colon = value.find(':');
+            if (colon == std::string::npos || colon == 0) {
+                return false;
+            }
+            std::istringstream topics(value.substr(colon + 1));
+            std::string topic;
+            while (std::getline(topics, topic, ',')) {
+                if (!topic.empty()) {
+                    options.topics[value.substr(0, colon)].push_back(topic);
+                }
+            }
+        } else if (arg == "--large") {
+            options.channels.push_back(value);
+        } else if (arg == "--duration" && std::atof(value.c_str()) > 0) {
+            options.duration_s = std::atof(value.c_str());
+        } else if (arg == "--segment-mb" && std::atoi(value.c_str()) > 0) {
+            options.segment_mb = static_cast<size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--speed" && std::atof(value.c_str()) > 0) {
+            options.speed = std::atof(value.c_str());
+        } else if (arg == "--start" && std::atof(value.c_str()) >= 0) {
+            options.start_s = std::atof(value.c_str());
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int record(const std::string& base, const RecordOptions& options) {
+    if (options.topics.empty() && options.channels.empty()) {
+        std::cerr << "Nothing to record: give --topics or --large\n";
+        return 1;
+    }
+    auto node = createNode("nexus_record");
+    Recorder recorder(node);
+    RecordWriter::Options writer_options;
+    writer_options.segment_size = options.segment_mb << 20;
+    if (!recorder.start(base, writer_options)) {
+        std::cerr << "Cannot create " << RecordLayout::segmentPath(base, 0) << "\n";
+        return 1;
+    }
+    for (const auto& group : options.topics) {
+        if (recorder.recordTopics(group.first, group.second) != Node::NO_ERROR) {
+            std::cerr << "Cannot subscribe to group " << group.first << "\n";
+            return 1;
+        }
+    }
+    for (const auto& channel : options.channels) {
+        if (recorder.recordLargeData(channel) != Node::NO_ERROR) {
+            std::cerr << "Cannot read large data channel " << channel << "\n";
+            return 1;
+        }
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    RecordWriter::Stats last = recorder.getStats();
+    while (!g_interrupted.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const RecordWriter::Stats stats = recorder.getStats();
+        std::printf("%llu frames, %.1f MB/s, %llu dropped, %u segments\n",
+                    static_cast<unsigned long long>(stats.frames), (stats.bytes - last.bytes) / 1e6,
+                    static_cast<unsigned long long>(stats.dropped), stats.segments);
+        std::fflush(stdout);
+        last = stats;
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+        if (options.duration_s > 0 && elapsed.count() >= options.duration_s) {
+            break;
+        }
+    }
+    recorder.stop();
+    return 0;
+}
+
+int replay(const std::string& base, const RecordOptions& options) {
+    auto node = createNode("nexus_replay");
+    Replayer replayer(node);
+    Replayer::Options replay_options;
+    replay_options.speed = options.speed;
+    replay_options.start_ns = static_cast<uint64_t>(options.start_s * 1e9);
+
+    std::thread watcher([&]() {
+        while (!g_interrupted.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        replayer.stop();
+    });
+    const bool ok = replayer.run(base, replay_options);
+    g_interrupted.store(true);
+    watcher.join();
+    if (!ok) {
+        std::cerr << "No recording at " << base << "\n";
+        return 1;
+    }
+
+    const Replayer::Stats stats = replayer.getStats();
+    std::printf("%llu messages, %llu large data blocks, %.1f MB, %llu failed\n",
+                static_cast<unsigned long long>(stats.messages), static_cast<unsigned long long>(stats.large_blocks),
+                stats.bytes / 1e6, static_cast<unsigned long long>(stats.failed));
+    return 0;
+}
+
+int info(const std::string& base) {
+    struct Totals {
+        std::string kind;
+        std::string name;
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+    };
+    std::map<uint32_t, Totals> streams;  // By stream id (the same in every segment of a recording)
+    uint64_t last_ns = 0;
+    const std::vector<std::string> segments = RecordReader::segments(base);
+    if (segments.empty()) {
+        std::cerr << "No recording at " << base << "\n";
+        return 1;
+    }
+
+    RecordReader reader;
+    for (const auto& path : segments) {
+        if (!reader.open(path)) {
+            std::printf("%s: unreadable\n", path.c_str());
+            continue;
+        }
+        std::printf("%s: %zu streams, %zu index entries%s\n", path.c_str(), reader.streams().size(),
+                    reader.index().size(), reader.closedCleanly() ? "" : " (not closed)");
+        RecordReader::Frame frame;
+        while (reader.next(frame)) {
+            if (frame.stream >= reader.streams().size()) {
+                continue;
+            }
+            const RecordStream& stream = reader.streams()[frame.stream];
+            Totals& totals = streams[frame.stream];
+            totals.kind = stream.kind == RecordLayout::STREAM_LARGE_DATA ? "large" : "message";
+            totals.name = stream.name + " " + stream.topic;
+            totals.frames++;
+            totals.bytes += frame.size;
+            last_ns = frame.time_ns;
+        }
+    }
+
+    std::printf("\n%-8s %-48s %12s %14s\n", "KIND", "GROUP/CHANNEL TOPIC", "FRAMES", "BYTES");
+    for (const auto& entry : streams) {
+        std::printf("%-8s %-48s %12llu %14llu\n", entry.second.kind.c_str(), entry.second.name.c_str(),
+                    static_cast<unsigned long long>(entry.second.frames),
+                    static_cast<unsigned long long>(entry.second.bytes));
+    }
+    std::printf("\nDuration: %.3f s\n", last_ns / 1e9);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    RecordOptions options;
+    if (argc < 3 || !parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    const std::string command = argv[1];
+    const std::string base = argv[2];
+    if (command == "record") {
+        return record(base, options);
+    }
+    if (command == "replay") {
+        return replay(base, options);
+    }
+    if (command == "info") {
+        return info(base);
+    }
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file nexus_top.cpp
+ * @brief Live view of every node's metrics segment on this host
+ *
+ * Nodes started with Config::node.metrics_interval_ms (NEXUS_METRICS_INTERVAL_MS)
+ * keep their counters in a shared memory segment (MetricsSegment). This tool
+ * maps those segments read-only: it neither attaches to the processes nor
+ * sends any traffic. Rates come from the difference of two snapshots, using
+ * the refresh timestamps the nodes wrote.
+ *
+ * The prometheus format prints the raw counters in the text exposition format,
+ * for a sidecar (e.g. the node_exporter textfile collector, with --once).
+ *
+ * Usage: nexus_top [--interval MS] [--once] [--node SUBSTRING] [--format text|prometheus]
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexus/utils/MetricsSegment.h"
+
+using namespace Nexus::rpc;
+
+namespace {
+
+struct TopOptions {
+    uint32_t interval_ms = 1000;
+    bool once = false;
+    std::string node;  // Substring of the node ids to show (empty = all)
+    std::string format = "text";
+};
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --interval MS       Time between screens (default: 1000)\n"
+              << "  --once              Print one screen (rates over one interval) and exit\n"
+              << "  --node SUBSTRING    Only nodes whose id contains SUBSTRING\n"
+              << "  --format FORMAT     text or prometheus (default: text)\n";
+}
+
+bool parseOptions(int argc, char* argv[], TopOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--once") {
+            options.once = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--interval" && std::atoi(value.c_str()) > 0) {
+            options.interval_ms = static_cast<uint32_t>(std::atoi(value.c_str()));
+        } else if (arg == "--node") {
+            options.node = value;
+        } else if (arg == "--format" && (value == "text" || value == "prometheus")) {
+            options.format = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::map<std::string, MetricsSnapshot> readAll(const TopOptions& options) {
+    std::map<std::string, MetricsSnapshot> snapshots;
+    for (const auto& name : MetricsSegment::list()) {
+        MetricsSnapshot snapshot;
+        if (MetricsSegment::read(name, snapshot) &&
+            (options.node.empty() || snapshot.node_id.find(options.node) != std::string::npos)) {
+            snapshots[name] = std::move(snapshot);
+        }
+    }
+    return snapshots;
+}
+
+const MetricsSnapshot::Row* findRow(const std::vector<MetricsSnapshot::Row>& rows, const std::string& name) {
+    for (const auto& row : rows) {
+        if (row.name == name) {
+            return &row;
+        }
+    }
+    return nullptr;
+}
+
+// Per-second rate of a "total" counter between two snapshots; negative when unknown
+double rate(uint64_t current, uint64_t previous, double seconds) {
+    return (seconds > 0 && current >= previous) ? static_cast<double>(current - previous) / seconds : -1.0;
+}
+
+std::string formatRate(double value, double scale = 1.0) {
+    char buf[32];
+    if (value < 0) {
+        return "-";
+    }
+    std::snprintf(buf, sizeof(buf), "%.1f", value / scale);
+    return buf;
+}
+
+void printText(const std::map<std::string, MetricsSnapshot>& current,
+               const std::map<std::string, MetricsSnapshot>& previous) {
+    const uint64_t now_ms = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    std::printf("nexus_top: %zu node(s)\n", current.size());
+    for (const auto& entry : current) {
+        const MetricsSnapshot& cur = entry.second;
+        const auto prev_it = previous.find(entry.first);
+        const MetricsSnapshot* prev = prev_it != previous.end() ? &prev_it->second : nullptr;
+        const double seconds = prev && cur.update_ms > prev->update_ms ? (cur.update_ms - prev->update_ms) / 1000.0 : 0;
+        auto nodeRate = [&](MetricsLayout::NodeMetric m, double scale) {
+            return formatRate(prev ? rate(cur.node[m], prev->node[m], seconds) : -1.0, scale);
+        };
+
+        std::printf("\nNODE %s  pid %d  %s  updated %.1fs ago  refresh %ums\n", cur.node_id.c_str(),
+                    static_cast<int>(cur.pid), cur.alive ? "alive" : "DEAD",
+                    now_ms > cur.update_ms ? (now_ms - cur.update_ms) / 1000.0 : 0.0, cur.interval_ms);
+        std::printf("  workers: queued %llu  dropped/s %s\n",
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::WORKER_QUEUE_DEPTH]),
+                    nodeRate(MetricsLayout::WORKER_DROPPED, 1.0).c_str());
+        std::printf("  shm: sent/s %s  recv/s %s  dropped/s %s  out MB/s %s  in MB/s %s\n",
+                    nodeRate(MetricsLayout::SHM_SENT, 1.0).c_str(), nodeRate(MetricsLayout::SHM_RECEIVED, 1.0).c_str(),
+                    nodeRate(MetricsLayout::SHM_DROPPED, 1.0).c_str(),
+                    nodeRate(MetricsLayout::SHM_BYTES_SENT, 1e6).c_str(),
+                    nodeRate(MetricsLayout::SHM_BYTES_RECEIVED, 1e6).c_str());
+        std::printf("  shm: queues %llu  inbox %llu  depth high/normal/bulk %llu/%llu/%llu  congestion %llu\n",
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_INBOUND_QUEUES]),
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_INBOX_DEPTH]),
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_DEPTH_HIGH]),
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_DEPTH_NORMAL]),
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_DEPTH_BULK]),
+                    static_cast<unsigned long long>(cur.node[MetricsLayout::SHM_MAX_CONGESTION]));
+
+        if (!cur.topics.empty()) {
+            std::printf("  %-40s %10s %10s %8s %10s %10s %8s\n", "TOPIC", "PUB/S", "DELIV/S", "DROP/S", "IN MB/S",
+                        "CB AVG US", "QUEUED");
+        }
+        for (const auto& row : cur.topics) {
+            const MetricsSnapshot::Row* old = prev ? findRow(prev->topics, row.name) : nullptr;
+            auto topicRate = [&](MetricsLayout::TopicMetric m, double scale) {
+                return formatRate(old ? rate(row.values[m], old->values[m], seconds) : -1.0, scale);
+            };
+            // Average callback time over the interval (over the whole run without a previous snapshot)
+            const uint64_t delivered =
+                row.values[MetricsLayout::TOPIC_DELIVERED] - (old ? old->values[MetricsLayout::TOPIC_DELIVERED] : 0);
+            const uint64_t callback_ns = row.values[MetricsLayout::TOPIC_CALLBACK_NS] -
+                                         (old ? old->values[MetricsLayout::TOPIC_CALLBACK_NS] : 0);
+            std::printf("  %-40s %10s %10s %8s %10s %10s %8llu\n", row.name.c_str(),
+                        topicRate(MetricsLayout::TOPIC_PUBLISHED, 1.0).c_str(),
+                        topicRate(MetricsLayout::TOPIC_DELIVERED, 1.0).c_str(),
+                        topicRate(MetricsLayout::TOPIC_DROPPED, 1.0).c_str(),
+                        topicRate(MetricsLayout::TOPIC_DELIVERED_BYTES, 1e6).c_str(),
+                        delivered > 0 ? formatRate(callback_ns / 1000.0 / delivered).c_str() : "-",
+                        static_cast<unsigned long long>(row.values[MetricsLayout::TOPIC_QUEUE_DEPTH]));
+        }
+
+        if (!cur.large_readers.empty()) {
+            std::printf("  %-40s %12s %12s %10s\n", "LARGE DATA READER", "LAG BYTES", "CAPACITY", "READ MB/S");
+        }
+        for (const auto& row : cur.large_readers) {
+            const MetricsSnapshot::Row* old = prev ? findRow(prev->large_readers, row.name) : nullptr;
+            const double read_rate = old ? rate(row.values[MetricsLayout::READER_BYTES_READ],
+                                                old->values[MetricsLayout::READER_BYTES_READ], seconds)
+                                         : -1.0;
+            std::printf("  %-40s %12llu %12llu %10s\n", row.name.c_str(),
+                        static_cast<unsigned long long>(row.values[MetricsLayout::READER_LAG_BYTES]),
+                        static_cast<unsigned long long>(row.values[MetricsLayout::READER_CAPACITY]),
+                        formatRate(read_rate, 1e6).c_str());
+        }
+    }
+    std::fflush(stdout);
+}
+
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+        }
+        escaped += c == '\n' ? 'n' : c;
+    }
+    return escaped;
+}
+
+void printPrometheus(const std::map<std::string, MetricsSnapshot>& snapshots) {
+    for (const auto& entry : snapshots) {
+        const MetricsSnapshot& snapshot = entry.second;
+        const std::string node = escapeLabel(snapshot.node_id);
+        std::printf("nexus_up{node=\"%s\"} %d\n", node.c_str(), snapshot.alive ? 1 : 0);
+        std::printf("nexus_last_update_ms{node=\"%s\"} %llu\n", node.c_str(),
+                    static_cast<unsigned long long>(snapshot.update_ms));
+        for (size_t m = 0; m < MetricsLayout::NODE_METRICS; ++m) {
+            std::printf("nexus_%s{node=\"%s\"} %llu\n", MetricsLayout::NODE_NAMES[m], node.c_str(),
+                        static_cast<unsigned long long>(snapshot.node[m]));
+        }
+        for (const auto& row : snapshot.topics) {
+            const std::string topic = escapeLabel(row.name);
+            for (size_t m = 0; m < MetricsLayout::TOPIC_METRICS; ++m) {
+                std::printf("nexus_topic_%s{node=\"%s\",topic=\"%s\"} %llu\n", MetricsLayout::TOPIC_NAMES[m],
+                            node.c_str(), topic.c_str(), static_cast<unsigned long long>(row.values[m]));
+            }
+        }
+        for (const auto& row : snapshot.large_readers) {
+            const std::string channel = escapeLabel(row.name);
+            for (size_t m = 0; m < MetricsLayout::LARGE_READER_METRICS; ++m) {
+                std::printf("nexus_large_reader_%s{node=\"%s\",channel=\"%s\"} %llu\n",
+                            MetricsLayout::LARGE_READER_NAMES[m], node.c_str(), channel.c_str(),
+                            static_cast<unsigned long long>(row.values[m]));
+            }
+        }
+    }
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    TopOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (options.format == "prometheus") {
+        // Raw counters: the scraper computes the rates
+        while (true) {
+            printPrometheus(readAll(options));
+            if (options.once) {
+                return 0;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.interval_ms));
+        }
+    }
+
+    const bool tty = isatty(STDOUT_FILENO);
+    std::map<std::string, MetricsSnapshot> previous = readAll(options);
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.interval_ms));
+        std::map<std::string, MetricsSnapshot> current = readAll(options);
+        if (tty && !options.once) {
+            std::printf("\033[H\033[2J");  // Redraw in place
+        }
+        printText(current, previous);
+        if (options.once) {
+            return 0;
+        }
+        previous.swap(current);
+    }
+}